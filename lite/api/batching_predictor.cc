@@ -0,0 +1,463 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string.h>
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <mutex>  // NOLINT
+#include <stdexcept>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "lite/api/paddle_api.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite_api {
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// The size of an element, 0 for the unsupported precisions.
+size_t ElementSize(PrecisionType precision) {
+  switch (precision) {
+    case PrecisionType::kFloat:
+    case PrecisionType::kInt32:
+      return 4;
+    case PrecisionType::kFP64:
+    case PrecisionType::kInt64:
+      return 8;
+    case PrecisionType::kFP16:
+    case PrecisionType::kInt16:
+      return 2;
+    case PrecisionType::kInt8:
+    case PrecisionType::kUInt8:
+    case PrecisionType::kBool:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+int64_t Product(const shape_t& shape, size_t begin) {
+  int64_t res = 1;
+  for (size_t i = begin; i < shape.size(); ++i) {
+    res *= shape[i];
+  }
+  return res;
+}
+
+// The samples in a tensor, the sequences of its LoD level 0 if any.
+int64_t SampleNum(const shape_t& shape, const lod_t& lod) {
+  if (!lod.empty()) return static_cast<int64_t>(lod[0].size()) - 1;
+  CHECK(!shape.empty()) << "A batched tensor must have dim 0";
+  return shape[0];
+}
+
+// Return why `input` can not be batched, or an empty string.
+std::string CheckInput(const BatchingPredictor::Input& input) {
+  // The fp16 outputs can be split, but MutableData() can't feed fp16.
+  if (ElementSize(input.precision) == 0 ||
+      input.precision == PrecisionType::kFP16) {
+    return "unsupported precision " + PrecisionToStr(input.precision);
+  }
+  if (input.shape.empty()) {
+    return "no dim 0 to batch along";
+  }
+  for (auto dim : input.shape) {
+    if (dim < 0) return "negative dim " + std::to_string(dim);
+  }
+  if (Product(input.shape, 0) > 0 && !input.data) {
+    return "data not set";
+  }
+  // Every level covers the sequences of the next one, the last level covers
+  // the rows.
+  for (size_t l = 0; l < input.lod.size(); ++l) {
+    auto& level = input.lod[l];
+    if (level.empty()) return "empty LoD level " + std::to_string(l);
+    for (size_t k = 1; k < level.size(); ++k) {
+      if (level[k] < level[k - 1]) {
+        return "decreasing LoD level " + std::to_string(l);
+      }
+    }
+    uint64_t covered = level.back() - level.front();
+    uint64_t expected = l + 1 < input.lod.size()
+                            ? input.lod[l + 1].size() - 1
+                            : static_cast<uint64_t>(input.shape[0]);
+    if (covered != expected) {
+      return "LoD level " + std::to_string(l) + " covers " +
+             std::to_string(covered) + " items instead of " +
+             std::to_string(expected);
+    }
+  }
+  return "";
+}
+
+// Allocate the data of a predictor input of the given precision.
+char* MutableData(Tensor* tensor, PrecisionType precision) {
+  switch (precision) {
+    case PrecisionType::kFloat:
+      return reinterpret_cast<char*>(tensor->mutable_data<float>());
+    case PrecisionType::kFP64:
+      return reinterpret_cast<char*>(tensor->mutable_data<double>());
+    case PrecisionType::kInt64:
+      return reinterpret_cast<char*>(tensor->mutable_data<int64_t>());
+    case PrecisionType::kInt32:
+      return reinterpret_cast<char*>(tensor->mutable_data<int>());
+    case PrecisionType::kInt16:
+      return reinterpret_cast<char*>(tensor->mutable_data<int16_t>());
+    case PrecisionType::kInt8:
+      return reinterpret_cast<char*>(tensor->mutable_data<int8_t>());
+    case PrecisionType::kUInt8:
+      return reinterpret_cast<char*>(tensor->mutable_data<uint8_t>());
+    case PrecisionType::kBool:
+      return reinterpret_cast<char*>(tensor->mutable_data<bool>());
+    default:
+      LOG(FATAL) << "Unsupported input precision "
+                 << PrecisionToStr(precision);
+  }
+  return nullptr;
+}
+
+// Cut the sequences [begin, end) of level 0 out of `lod`, rebased to zero,
+// and return the rows they cover, or false if `lod` is too short.
+bool SliceLoD(const lod_t& lod,
+              uint64_t begin,
+              uint64_t end,
+              lod_t* sliced,
+              uint64_t* row_begin,
+              uint64_t* row_end) {
+  sliced->clear();
+  for (auto& level : lod) {
+    if (end >= level.size()) return false;
+    std::vector<uint64_t> offsets(level.begin() + begin,
+                                  level.begin() + end + 1);
+    for (auto& offset : offsets) {
+      offset -= level[begin];
+    }
+    sliced->push_back(std::move(offsets));
+    uint64_t next_begin = level[begin];
+    end = level[end];
+    begin = next_begin;
+  }
+  *row_begin = begin;
+  *row_end = end;
+  return true;
+}
+
+}  // namespace
+
+struct BatchingRequest {
+  std::vector<BatchingPredictor::Input> inputs;
+  int64_t sample_num{0};
+  Clock::time_point arrival;
+  std::promise<std::vector<BatchingPredictor::Output>> promise;
+};
+
+class BatchingPredictorImpl {
+ public:
+  BatchingPredictorImpl(const std::shared_ptr<PaddlePredictor>& predictor,
+                        int max_batch_size,
+                        int max_delay_us)
+      : predictor_(predictor),
+        max_batch_size_(max_batch_size),
+        max_delay_(std::chrono::microseconds(max_delay_us)) {
+    input_num_ = predictor_->GetInputNames().size();
+    output_num_ = predictor_->GetOutputNames().size();
+    worker_ = std::thread([this]() { Loop(); });
+  }
+
+  ~BatchingPredictorImpl() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    worker_.join();
+  }
+
+  std::future<std::vector<BatchingPredictor::Output>> Submit(
+      const std::vector<BatchingPredictor::Input>& inputs);
+
+  std::atomic<int64_t> batch_num_{0};
+  std::atomic<int64_t> request_num_{0};
+
+ private:
+  void Loop();
+  // Whether `request` may join a batch led by `first`.
+  bool Compatible(const BatchingRequest& first,
+                  const BatchingRequest& request) const;
+  void RunBatch(const std::vector<std::unique_ptr<BatchingRequest>>& batch);
+  // Fail all the requests of `batch`.
+  void FailBatch(const std::vector<std::unique_ptr<BatchingRequest>>& batch,
+                 const std::string& reason);
+
+  std::shared_ptr<PaddlePredictor> predictor_;
+  size_t input_num_{0};
+  size_t output_num_{0};
+  const int64_t max_batch_size_;
+  const Clock::duration max_delay_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::unique_ptr<BatchingRequest>> queue_;
+  int64_t queued_samples_{0};
+  bool stop_{false};
+  std::thread worker_;
+};
+
+std::future<std::vector<BatchingPredictor::Output>>
+BatchingPredictorImpl::Submit(
+    const std::vector<BatchingPredictor::Input>& inputs) {
+  std::unique_ptr<BatchingRequest> request(new BatchingRequest);
+  auto future = request->promise.get_future();
+  // A bad request fails alone, it never reaches a batch.
+  std::string error;
+  if (inputs.size() != input_num_) {
+    error = "A request must hold the " + std::to_string(input_num_) +
+            " inputs of the predictor, got " + std::to_string(inputs.size());
+  }
+  for (size_t i = 0; error.empty() && i < inputs.size(); ++i) {
+    std::string reason = CheckInput(inputs[i]);
+    if (!reason.empty()) {
+      error = "Input " + std::to_string(i) + " of the request: " + reason;
+    }
+  }
+  if (error.empty() && SampleNum(inputs[0].shape, inputs[0].lod) <= 0) {
+    error = "A request must hold one sample at least";
+  }
+  if (!error.empty()) {
+    request->promise.set_exception(
+        std::make_exception_ptr(std::invalid_argument(error)));
+    return future;
+  }
+  request->inputs = inputs;
+  request->sample_num = SampleNum(inputs[0].shape, inputs[0].lod);
+  request->arrival = Clock::now();
+  bool notify;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    queued_samples_ += request->sample_num;
+    queue_.push_back(std::move(request));
+    // The worker only needs to know about the first request of a batch and
+    // about a full batch.
+    notify = queue_.size() == 1 || queued_samples_ >= max_batch_size_;
+  }
+  if (notify) cv_.notify_one();
+  return future;
+}
+
+bool BatchingPredictorImpl::Compatible(const BatchingRequest& first,
+                                       const BatchingRequest& request) const {
+  for (size_t i = 0; i < input_num_; ++i) {
+    auto& a = first.inputs[i];
+    auto& b = request.inputs[i];
+    if (a.precision != b.precision || a.lod.size() != b.lod.size() ||
+        a.shape.size() != b.shape.size()) {
+      return false;
+    }
+    for (size_t d = 1; d < a.shape.size(); ++d) {
+      if (a.shape[d] != b.shape[d]) return false;
+    }
+  }
+  return true;
+}
+
+void BatchingPredictorImpl::Loop() {
+  std::vector<std::unique_ptr<BatchingRequest>> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+    if (queue_.empty()) break;
+    // Wait for more requests until the batch is full or the first request
+    // has waited long enough. The queued requests are run at once on stop.
+    auto deadline = queue_.front()->arrival + max_delay_;
+    while (!stop_ && queued_samples_ < max_batch_size_ &&
+           Clock::now() < deadline) {
+      cv_.wait_until(lock, deadline);
+    }
+    batch.clear();
+    int64_t sample_num = 0;
+    while (!queue_.empty()) {
+      auto& next = queue_.front();
+      if (!batch.empty() &&
+          (sample_num + next->sample_num > max_batch_size_ ||
+           !Compatible(*batch[0], *next))) {
+        break;
+      }
+      sample_num += next->sample_num;
+      queued_samples_ -= next->sample_num;
+      batch.push_back(std::move(next));
+      queue_.pop_front();
+    }
+    lock.unlock();
+    RunBatch(batch);
+    lock.lock();
+  }
+}
+
+void BatchingPredictorImpl::RunBatch(
+    const std::vector<std::unique_ptr<BatchingRequest>>& batch) {
+  // Concatenate the inputs right into the input tensors.
+  for (size_t i = 0; i < input_num_; ++i) {
+    auto& first = batch[0]->inputs[i];
+    shape_t shape = first.shape;
+    shape[0] = 0;
+    lod_t lod(first.lod.size(), std::vector<uint64_t>(1, 0));
+    for (auto& request : batch) {
+      auto& input = request->inputs[i];
+      shape[0] += input.shape[0];
+      for (size_t l = 0; l < input.lod.size(); ++l) {
+        uint64_t base = lod[l].back();
+        for (size_t k = 1; k < input.lod[l].size(); ++k) {
+          lod[l].push_back(base + input.lod[l][k] - input.lod[l][0]);
+        }
+      }
+    }
+    auto tensor = predictor_->GetInput(i);
+    tensor->Resize(shape);
+    tensor->SetLoD(lod);
+    char* dst = MutableData(tensor.get(), first.precision);
+    const size_t element_size = ElementSize(first.precision);
+    for (auto& request : batch) {
+      auto& input = request->inputs[i];
+      size_t size = Product(input.shape, 0) * element_size;
+      if (size > 0) {
+        memcpy(dst, input.data, size);
+      }
+      dst += size;
+    }
+  }
+
+  predictor_->Run();
+
+  // Split the outputs into the results of the requests.
+  int64_t total_samples = 0;
+  for (auto& request : batch) {
+    total_samples += request->sample_num;
+  }
+  std::vector<std::vector<BatchingPredictor::Output>> results(
+      batch.size(), std::vector<BatchingPredictor::Output>(output_num_));
+  for (size_t j = 0; j < output_num_; ++j) {
+    auto tensor = predictor_->GetOutput(j);
+    shape_t shape = tensor->shape();
+    lod_t lod = tensor->lod();
+    PrecisionType precision = tensor->precision();
+    if (ElementSize(precision) == 0) {
+      FailBatch(batch,
+                "Output " + std::to_string(j) + " has the unsupported " +
+                    "precision " + PrecisionToStr(precision));
+      return;
+    }
+    const char* src = static_cast<const char*>(tensor->data<void>());
+    const size_t row_size =
+        (shape.empty() ? 1 : Product(shape, 1)) * ElementSize(precision);
+    int64_t rows_per_sample = 0;
+    if (batch.size() > 1 && lod.empty()) {
+      if (shape.empty() || shape[0] % total_samples != 0) {
+        FailBatch(batch,
+                  "Output " + std::to_string(j) + " of shape[0] " +
+                      std::to_string(shape.empty() ? 0 : shape[0]) +
+                      " can not be split into " +
+                      std::to_string(total_samples) + " samples");
+        return;
+      }
+      rows_per_sample = shape[0] / total_samples;
+    }
+    uint64_t sample_begin = 0;
+    for (size_t r = 0; r < batch.size(); ++r) {
+      auto& output = results[r][j];
+      output.precision = precision;
+      output.shape = shape;
+      uint64_t row_begin = 0;
+      uint64_t row_end = shape.empty() ? 1 : shape[0];
+      uint64_t sample_end = sample_begin + batch[r]->sample_num;
+      if (batch.size() > 1) {
+        if (!lod.empty()) {
+          if (!SliceLoD(lod,
+                        sample_begin,
+                        sample_end,
+                        &output.lod,
+                        &row_begin,
+                        &row_end)) {
+            FailBatch(batch,
+                      "The LoD of output " + std::to_string(j) +
+                          " is too short for the samples of the batch");
+            return;
+          }
+        } else {
+          row_begin = sample_begin * rows_per_sample;
+          row_end = sample_end * rows_per_sample;
+        }
+        output.shape[0] = row_end - row_begin;
+      } else {
+        output.lod = lod;
+      }
+      output.data.assign(src + row_begin * row_size, src + row_end * row_size);
+      sample_begin = sample_end;
+    }
+  }
+  // Count the batch before any client can see its result.
+  batch_num_.fetch_add(1, std::memory_order_relaxed);
+  request_num_.fetch_add(batch.size(), std::memory_order_relaxed);
+  for (size_t r = 0; r < batch.size(); ++r) {
+    batch[r]->promise.set_value(std::move(results[r]));
+  }
+}
+
+void BatchingPredictorImpl::FailBatch(
+    const std::vector<std::unique_ptr<BatchingRequest>>& batch,
+    const std::string& reason) {
+  LOG(ERROR) << reason;
+  batch_num_.fetch_add(1, std::memory_order_relaxed);
+  request_num_.fetch_add(batch.size(), std::memory_order_relaxed);
+  for (auto& request : batch) {
+    request->promise.set_exception(
+        std::make_exception_ptr(std::runtime_error(reason)));
+  }
+}
+
+BatchingPredictor::BatchingPredictor(
+    const std::shared_ptr<PaddlePredictor>& predictor,
+    int max_batch_size,
+    int max_delay_us) {
+  CHECK(predictor) << "The predictor can not be nullptr";
+  CHECK_GT(max_batch_size, 0) << "max_batch_size must be positive";
+  CHECK_GE(max_delay_us, 0) << "max_delay_us can not be negative";
+  impl_.reset(
+      new BatchingPredictorImpl(predictor, max_batch_size, max_delay_us));
+}
+
+BatchingPredictor::~BatchingPredictor() = default;
+
+std::future<std::vector<BatchingPredictor::Output>> BatchingPredictor::Submit(
+    const std::vector<Input>& inputs) {
+  return impl_->Submit(inputs);
+}
+
+int64_t BatchingPredictor::batch_num() const {
+  return impl_->batch_num_.load();
+}
+
+int64_t BatchingPredictor::request_num() const {
+  return impl_->request_num_.load();
+}
+
+}  // namespace lite_api
+}  // namespace paddle
@@ -23,6 +23,9 @@
 
 #include "lite/api/paddle_use_passes.h"
 #include "lite/utils/io.h"
+#ifdef LITE_WITH_X86
+#include "lite/backends/x86/math/gemm_bf16.h"
+#endif
 
 namespace paddle {
 namespace lite {
@@ -376,6 +379,20 @@ void Predictor::Build(const std::shared_ptr<cpp::ProgramDesc> &program_desc,
     }
   }
 
+#ifdef LITE_WITH_X86
+  // Without AVX-512 the bf16 kernels run a fp32 loop, slower than the fp32
+  // kernels and less precise, so the bf16 places fall back to fp32 and
+  // neither those kernels nor bf16_attribute_pass are picked.
+  if (lite::x86::math::gemm_bf16_isa() ==
+      lite::x86::math::GemmBf16Isa::kFp32) {
+    for (auto &place : inner_places) {
+      if (place.precision == PRECISION(kBF16)) {
+        place.precision = PRECISION(kFloat);
+      }
+    }
+  }
+#endif
+
   Program program(program_desc_, scope_, inner_places);
   valid_places_ = inner_places;
 
@@ -23,6 +23,7 @@
 #include "lite/core/op_lite.h"
 #include "lite/core/optimizer/optimizer.h"
 #include "lite/core/program.h"
+#include "lite/core/thread_pool.h"
 #include "lite/core/types.h"
 #include "lite/model_parser/model_parser.h"
 
@@ -65,16 +66,22 @@ class LITE_API Predictor {
   Predictor(const std::shared_ptr<cpp::ProgramDesc>& program_desc,
             const std::shared_ptr<Scope>& root,
             const std::vector<Place>& valid_places,
-            const std::vector<std::string>& var_names = {})
+            const std::vector<std::string>& var_names = {},
+            const RuntimeProgram* program_template = nullptr)
       : program_desc_(program_desc), scope_(root) {
-    // step1. Create a Program to construct the exec_scope and ops
-    Program program(program_desc_, scope_, valid_places, var_names);
+    // step1. Create a Program to construct the exec_scope
+    Program program(scope_);
+    program.PrepareWorkspace(program_desc_, var_names);
     exec_scope_ = program.exec_scope();
     valid_places_ = valid_places;
 
-    // step3. Create the RuntimeProgram.
-    program_.reset(
-        new RuntimeProgram(program_desc_, exec_scope_, kRootBlockIdx));
+    // step2. Create the RuntimeProgram, from the template if any.
+    if (program_template) {
+      program_ = program_template->Clone(program_desc_, exec_scope_);
+    } else {
+      program_.reset(
+          new RuntimeProgram(program_desc_, exec_scope_, kRootBlockIdx));
+    }
     program_generated_ = true;
   }
 
@@ -110,14 +117,14 @@ class LITE_API Predictor {
   std::shared_ptr<Predictor> Clone() {
     // step 1. Generate runtime_program, update op_info and var_info in
     // program_desc_
-    if (!program_generated_) {
-      GenRuntimeProgram();
-    }
-    program_->SaveRuntimProgramIntoProgramDesc(program_desc_);
+    SyncProgramDesc();
     // step 2. Create a predictor friom current program_desc_ and
     // runtime_program.
-    auto predictor =
-        std::make_shared<Predictor>(program_desc_, scope_, valid_places_);
+    auto predictor = std::make_shared<Predictor>(program_desc_,
+                                                 scope_,
+                                                 valid_places_,
+                                                 std::vector<std::string>(),
+                                                 program_.get());
     // step3. Return the result
     return predictor;
   }
@@ -135,14 +142,11 @@ class LITE_API Predictor {
                      "not be nullptr in Clone mode.";
     // step 1. Generate runtime_program, update op_info and var_info in
     // program_desc_
-    if (!program_generated_) {
-      GenRuntimeProgram();
-    }
-    program_->SaveRuntimProgramIntoProgramDesc(program_desc_);
+    SyncProgramDesc();
     // step 2. Create a predictor friom current program_desc_ and
     // runtime_program.
     auto predictor = std::make_shared<Predictor>(
-        program_desc_, scope_, valid_places_, var_names);
+        program_desc_, scope_, valid_places_, var_names, program_.get());
     // step3. Copy some persistable variables into private scope.
     for (auto var_name : var_names) {
       predictor->exec_scope_->LocalVar(var_name);
@@ -182,6 +186,19 @@ class LITE_API Predictor {
     ClearTensorArray(program_desc_);
   }
 
+  // Run the independent instructions at the same time, see
+  // RuntimeProgram::set_inter_op_parallel().
+  void set_inter_op_parallel(bool inter_op_parallel) {
+    CHECK(program_) << "The RuntimeProgram is not built yet.";
+    program_->set_inter_op_parallel(inter_op_parallel);
+  }
+
+  // See RuntimeProgram::set_shape_cache_enabled().
+  void set_shape_cache_enabled(bool enabled) {
+    CHECK(program_) << "The RuntimeProgram is not built yet.";
+    program_->set_shape_cache_enabled(enabled);
+  }
+
 #ifdef LITE_WITH_METAL
   void ConfigMetalContext(const lite_api::CxxConfig& config) {
     program_->ConfigMetalContext(config.metal_lib_path(),
@@ -257,12 +274,26 @@ class LITE_API Predictor {
   void ClearTensorArray(
       const std::shared_ptr<const cpp::ProgramDesc>& program_desc);
 
+  // Write the runtime program back into program_desc_ before the first
+  // clone, the later clones reuse it. The clones copy the instructions of
+  // program_, which serves as the template.
+  void SyncProgramDesc() {
+    if (!program_generated_) {
+      GenRuntimeProgram();
+    }
+    if (!program_desc_synced_) {
+      program_->SaveRuntimProgramIntoProgramDesc(program_desc_);
+      program_desc_synced_ = true;
+    }
+  }
+
  private:
   std::shared_ptr<cpp::ProgramDesc> program_desc_;
   std::shared_ptr<Scope> scope_;
   Scope* exec_scope_;
   std::shared_ptr<RuntimeProgram> program_;
   bool program_generated_{false};
+  bool program_desc_synced_{false};
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
   std::vector<Place> valid_places_;
@@ -330,6 +361,9 @@ class CxxPaddleApiImpl : public lite_api::PaddlePredictor {
   lite_api::CxxConfig config_;
   std::mutex mutex_;
   bool status_is_cloned_;
+#ifdef LITE_USE_THREAD_POOL
+  std::shared_ptr<ThreadPool> thread_pool_;
+#endif
 };
 
 /*
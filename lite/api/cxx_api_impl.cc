@@ -45,7 +45,8 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
   mode_ = config.power_mode();
   threads_ = config.threads();
 #ifdef LITE_USE_THREAD_POOL
-  int thread_num = ThreadPool::Init(threads_);
+  // Each predictor, cloned ones included, owns its thread pool.
+  thread_pool_ = ThreadPool::Create(threads_, config.cpu_affinity());
 #endif
   if (!status_is_cloned_) {
     auto places = config.valid_places();
@@ -144,6 +145,8 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
     raw_predictor_->PrepareFeedFetch();
     CHECK(raw_predictor_) << "The Predictor can not be nullptr in Clone mode.";
   }
+  raw_predictor_->set_inter_op_parallel(config.inter_op_parallel());
+  raw_predictor_->set_shape_cache_enabled(config.shape_cache());
 
 #ifdef LITE_WITH_METAL
   raw_predictor_->ConfigMetalContext(config);
@@ -221,11 +224,7 @@ void CxxPaddleApiImpl::Init(const lite_api::CxxConfig &config) {
 #endif
 }
 
-CxxPaddleApiImpl::~CxxPaddleApiImpl() {
-#ifdef LITE_USE_THREAD_POOL
-  ThreadPool::Destroy();
-#endif
-}
+CxxPaddleApiImpl::~CxxPaddleApiImpl() {}
 
 std::unique_ptr<lite_api::Tensor> CxxPaddleApiImpl::GetInputByName(
     const std::string &name) {
@@ -265,6 +264,9 @@ std::vector<std::string> CxxPaddleApiImpl::GetOutputNames() {
 void CxxPaddleApiImpl::Run() {
 #ifdef LITE_WITH_ARM
   lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
+#endif
+#ifdef LITE_USE_THREAD_POOL
+  ThreadPool::ScopedBind bind_thread_pool(thread_pool_.get());
 #endif
   raw_predictor_->Run();
 }
@@ -18,27 +18,46 @@
 #ifdef ENABLE_ARM_FP16
 #include "lite/backends/arm/math/fp16/funcs_fp16.h"
 #endif
+#ifdef LITE_WITH_X86
+#include "lite/backends/x86/math/gemm_bf16.h"
+#endif
 
 namespace paddle {
 namespace lite {
 
 void LightPredictor::Build(const std::string& lite_model_file,
-                           bool model_from_memory) {
+                           bool model_from_memory,
+                           bool use_mmap,
+                           bool lazy_load_params) {
   if (model_from_memory) {
     LoadModelNaiveFromMemory(
         lite_model_file, scope_.get(), program_desc_.get());
   } else {
-    LoadModelNaiveFromFile(lite_model_file, scope_.get(), program_desc_.get());
+    if (lazy_load_params) {
+      lazy_params_ = std::make_shared<LazyParams>();
+    }
+    LoadModelNaiveFromFile(lite_model_file,
+                           scope_.get(),
+                           program_desc_.get(),
+                           use_mmap,
+                           lazy_params_.get());
   }
 
-  // For weight quantization of post training, load the int8/16 weights
+  // For weight quantization of post training, load the int8/16/4 weights
   // for optimized model, and dequant it to fp32.
   DequantizeWeight();
 #ifdef ENABLE_ARM_FP16
   // fp16 Weight convert
   WeightFP32ToFP16();
+#endif
+#ifdef LITE_WITH_X86
+  // bf16 Weight convert
+  WeightFP32ToBF16();
 #endif
   BuildRuntimeProgram(program_desc_);
+  if (lazy_params_) {
+    PrepareLazyParams();
+  }
   PrepareFeedFetch();
 }
 
@@ -71,6 +90,10 @@ void LightPredictor::Build(const std::string& model_dir,
 #ifdef ENABLE_ARM_FP16
   // fp16 Weight convert
   WeightFP32ToFP16();
+#endif
+#ifdef LITE_WITH_X86
+  // bf16 Weight convert
+  WeightFP32ToBF16();
 #endif
   BuildRuntimeProgram(program_desc_);
   PrepareFeedFetch();
@@ -193,7 +216,7 @@ void LightPredictor::PrepareFeedFetch() {
   }
 }
 
-void LightPredictor::BuildRuntimeProgram(
+Scope* LightPredictor::PrepareExecScope(
     const std::shared_ptr<const cpp::ProgramDesc>& program_desc) {
   auto* exe_scope = &scope_->NewScope();
   // Prepare workspace
@@ -226,14 +249,56 @@ void LightPredictor::BuildRuntimeProgram(
       if (op_desc->Type() == "lod_array_length") bool_clear_tensor_ = true;
     }
   }
+  return exe_scope;
+}
+
+void LightPredictor::BuildRuntimeProgram(
+    const std::shared_ptr<const cpp::ProgramDesc>& program_desc) {
+  auto* exe_scope = PrepareExecScope(program_desc);
   // Only extracting the ops and generate the runtime program from the main
   // block desc
   program_.reset(new RuntimeProgram(program_desc, exe_scope, kRootBlockIdx));
 }
 
-void LightPredictor::DequantizeWeight() {
-  std::shared_ptr<const cpp::ProgramDesc> program_desc = program_desc_;
-  CHECK(program_desc != nullptr);
+std::unique_ptr<LightPredictor> LightPredictor::Clone(
+    const std::vector<std::string>& var_names) {
+  std::unique_ptr<LightPredictor> predictor(new LightPredictor());
+  predictor->scope_ = scope_;
+  predictor->program_desc_ = program_desc_;
+  predictor->lazy_params_ = lazy_params_;
+  auto* exe_scope = predictor->PrepareExecScope(program_desc_);
+  // Copy some persistable variables into the private scope.
+  for (auto& var_name : var_names) {
+    auto* var = scope_->FindVar(var_name);
+    if (!var || !var->IsType<lite::Tensor>()) {
+      LOG(ERROR) << "Failed to clone the predictor, no persistable tensor "
+                 << var_name;
+      return nullptr;
+    }
+    if (lazy_params_) lazy_params_->Load({var_name});
+    exe_scope->LocalVar(var_name)->GetMutable<lite::Tensor>()->CopyDataFrom(
+        var->Get<lite::Tensor>());
+  }
+  // The instructions are copied from the ones of this predictor, the op descs
+  // are not parsed and the kernels are not picked again.
+  predictor->program_ = program_->Clone(program_desc_, exe_scope);
+  if (lazy_params_) {
+    for (auto& inst : *predictor->program_->mutable_instructions()) {
+      inst.set_lazy_params(lazy_params_.get());
+    }
+  }
+  predictor->input_names_ = input_names_;
+  predictor->output_names_ = output_names_;
+  predictor->input_precisions_ = input_precisions_;
+  return predictor;
+}
+
+namespace {
+
+// Dequantize the int8/16/4 weight `input_tensor` of a quantized op to fp32.
+void DequantizeTensor(const cpp::OpDesc* op_desc,
+                      const std::string& input_scale_name,
+                      Tensor* input_tensor) {
 #define PROCESS_CONV2D_DATA()                                             \
   for (int64_t i = 0; i < ch; ++i) {                                      \
     for (int64_t j = 0; j < offset; ++j) {                                \
@@ -248,19 +313,122 @@ void LightPredictor::DequantizeWeight() {
     }                                                                   \
   }
 
+  Tensor tmp_tensor;
+  tmp_tensor.CopyDataFrom(*input_tensor);
+  auto scale_list = op_desc->GetAttr<std::vector<float>>(input_scale_name);
+
+  int quantize_weight_bits = op_desc->GetAttr<int>("quantize_weight_bits");
+  CHECK(quantize_weight_bits == 8 || quantize_weight_bits == 16 ||
+        quantize_weight_bits == 4);
+  if (quantize_weight_bits == 4) {
+    // The K x N weight of mul packs two columns in a byte, each holding q + 8,
+    // and its scales are [group][column].
+    int64_t chin = input_tensor->dims()[0];
+    int64_t ld = input_tensor->dims()[1];
+    int64_t group_size = op_desc->GetAttr<int>("quantize_weight_group_size");
+    int64_t groups = (chin + group_size - 1) / group_size;
+    int64_t chout = scale_list.size() / groups;
+    CHECK_EQ(ld, (chout + 1) / 2);
+    input_tensor->Resize({chin, chout});
+    float* fp_data = input_tensor->mutable_data<float>();
+    const uint8_t* int_data =
+        reinterpret_cast<const uint8_t*>(tmp_tensor.data<int8_t>());
+    for (int64_t i = 0; i < chin; i++) {
+      const float* scales = scale_list.data() + i / group_size * chout;
+      for (int64_t j = 0; j < chout; j++) {
+        uint8_t byte = int_data[i * ld + j / 2];
+        int q = ((j % 2) ? byte >> 4 : byte & 0x0F) - 8;
+        fp_data[i * chout + j] = scales[j] * q;
+      }
+    }
+    return;
+  }
+  float* fp_data = input_tensor->mutable_data<float>();
+  CHECK(fp_data != nullptr);
+
+  std::string op_type = op_desc->Type();
+  if (op_type == "conv2d" || op_type == "depthwise_conv2d") {
+    int64_t ch = input_tensor->dims()[0];
+    int64_t offset = input_tensor->numel() / ch;
+    CHECK_EQ(scale_list.size(), ch);
+    if (quantize_weight_bits == 8) {
+      const int8_t* int_data = tmp_tensor.data<int8_t>();
+      CHECK(int_data != nullptr);
+      PROCESS_CONV2D_DATA()
+    } else {
+      const int16_t* int_data = tmp_tensor.data<int16_t>();
+      CHECK(int_data != nullptr);
+      PROCESS_CONV2D_DATA()
+    }
+  } else if (op_type == "fc" || op_type == "mul" ||
+             op_type == "lookup_table") {
+    int64_t chin = input_tensor->dims()[0];
+    int64_t chout = input_tensor->dims()[1];
+    CHECK_EQ(scale_list.size(), chout);
+    if (quantize_weight_bits == 8) {
+      const int8_t* int_data = tmp_tensor.data<int8_t>();
+      CHECK(int_data != nullptr);
+      PROCESS_FC_DATA()
+    } else {
+      const int16_t* int_data = tmp_tensor.data<int16_t>();
+      CHECK(int_data != nullptr);
+      PROCESS_FC_DATA()
+    }
+  }
+
+#undef PROCESS_CONV2D_DATA
+#undef PROCESS_FC_DATA
+}
+
+#ifdef LITE_WITH_X86
+// The x86 fc and mul compute on their 8/4 bits 2-D weights, which are left
+// quantized, see lite/backends/x86/math/gemm_weight_only.h.
+bool IsWeightOnlyQuantizedKernel(const cpp::OpDesc* op_desc,
+                                 const Tensor& weight) {
+  if (op_desc->Type() != "fc" && op_desc->Type() != "mul") return false;
+  int quantize_weight_bits = op_desc->GetAttr<int>("quantize_weight_bits");
+  if (quantize_weight_bits != 8 && quantize_weight_bits != 4) return false;
+  if (weight.dims().size() != 2 || !op_desc->HasAttr(kKernelTypeAttr)) {
+    return false;
+  }
+  std::string op_type, alias;
+  Place place;
+  KernelBase::ParseKernelType(
+      op_desc->GetAttr<std::string>(kKernelTypeAttr), &op_type, &alias, &place);
+  return place.target == TARGET(kX86) && place.precision == PRECISION(kFloat);
+}
+#endif
+
+}  // namespace
+
+void LightPredictor::PrepareLazyParams() {
+  for (size_t i = 1; i < program_desc_->BlocksSize(); ++i) {
+    auto* block = program_desc_->GetBlock<cpp::BlockDesc>(i);
+    for (size_t k = 0; k < block->OpsSize(); ++k) {
+      lazy_params_->Load(block->GetOp<cpp::OpDesc>(k)->input_vars());
+    }
+  }
+  for (auto& inst : *program_->mutable_instructions()) {
+    inst.set_lazy_params(lazy_params_.get());
+  }
+}
+
+void LightPredictor::DequantizeWeight() {
+  std::shared_ptr<const cpp::ProgramDesc> program_desc = program_desc_;
+  CHECK(program_desc != nullptr);
   auto is_weight_quantized_op = [](const cpp::OpDesc* op_desc) {
     CHECK(op_desc != nullptr);
     bool result = false;
     if (op_desc->HasAttr("quantization_type")) {
       std::string type = op_desc->GetAttr<std::string>("quantization_type");
       result = (type == "post_weight_abs_max") ||
-               (type == "post_weight_channel_wise_abs_max");
+               (type == "post_weight_channel_wise_abs_max") ||
+               (type == "post_weight_group_wise_abs_max");
     } else {
       result = op_desc->HasAttr("quantize_weight_bits");
     }
     return result;
   };
-  Tensor tmp_tensor;
   for (size_t i = 0; i < program_desc->BlocksSize(); i++) {
     auto* block = program_desc->GetBlock<cpp::BlockDesc>(i);
     CHECK(block != nullptr);
@@ -289,57 +457,47 @@ void LightPredictor::DequantizeWeight() {
             CHECK(scope_var != nullptr);
             auto input_tensor = scope_var->GetMutable<lite::Tensor>();
             CHECK(input_tensor != nullptr);
-            tmp_tensor.CopyDataFrom(*input_tensor);
-            auto scale_list =
-                op_desc->GetAttr<std::vector<float>>(input_scale_name);
-
-            int quantize_weight_bits =
-                op_desc->GetAttr<int>("quantize_weight_bits");
-            CHECK(quantize_weight_bits == 8 || quantize_weight_bits == 16);
-            float* fp_data = input_tensor->mutable_data<float>();
-            CHECK(fp_data != nullptr);
-
-            std::string op_type = op_desc->Type();
-            if (op_type == "conv2d" || op_type == "depthwise_conv2d") {
-              int64_t ch = input_tensor->dims()[0];
-              int64_t offset = input_tensor->numel() / ch;
-              CHECK_EQ(scale_list.size(), ch);
-              if (quantize_weight_bits == 8) {
-                const int8_t* int_data = tmp_tensor.data<int8_t>();
-                CHECK(int_data != nullptr);
-                PROCESS_CONV2D_DATA()
-              } else {
-                const int16_t* int_data = tmp_tensor.data<int16_t>();
-                CHECK(int_data != nullptr);
-                PROCESS_CONV2D_DATA()
-              }
-            } else if (op_type == "fc" || op_type == "mul" ||
-                       op_type == "lookup_table") {
-              int64_t chin = input_tensor->dims()[0];
-              int64_t chout = input_tensor->dims()[1];
-              CHECK_EQ(scale_list.size(), chout);
-              if (quantize_weight_bits == 8) {
-                const int8_t* int_data = tmp_tensor.data<int8_t>();
-                CHECK(int_data != nullptr);
-                PROCESS_FC_DATA()
-              } else {
-                const int16_t* int_data = tmp_tensor.data<int16_t>();
-                CHECK(int_data != nullptr);
-                PROCESS_FC_DATA()
-              }
+#ifdef LITE_WITH_X86
+            if (IsWeightOnlyQuantizedKernel(op_desc, *input_tensor)) {
+              continue;
+            }
+#endif
+            if (lazy_params_ && lazy_params_->Has(input_name)) {
+              // Dequantize the weight once it is loaded.
+              lazy_params_->AddTransform(
+                  input_name,
+                  [program_desc, op_desc, input_scale_name](Tensor* tensor) {
+                    DequantizeTensor(op_desc, input_scale_name, tensor);
+                  });
+            } else {
+              DequantizeTensor(op_desc, input_scale_name, input_tensor);
             }
           }
         }
       }
     }
   }
-
-#undef PROCESS_CONV2D_DATA
-#undef PROCESS_FC_DATA
 }
 
 #ifdef ENABLE_ARM_FP16
 typedef __fp16 float16_t;
+namespace {
+
+void TensorFP32ToFP16(Tensor* input_tensor) {
+  if (input_tensor->precision() != PRECISION(kFloat)) return;
+
+  Tensor tmp_tensor;
+  tmp_tensor.CopyDataFrom(*input_tensor);
+  input_tensor->clear();
+  input_tensor->set_precision(PRECISION(kFP16));
+
+  float16_t* fp_data = input_tensor->mutable_data<float16_t>();
+  const float* in_data = tmp_tensor.data<float>();
+  lite::arm::math::fp16::fp32_to_fp16(in_data, fp_data, input_tensor->numel());
+}
+
+}  // namespace
+
 void LightPredictor::WeightFP32ToFP16() {
   std::shared_ptr<const cpp::ProgramDesc> program_desc = program_desc_;
   std::vector<std::string> fp16_ops{"conv2d",
@@ -364,21 +522,56 @@ void LightPredictor::WeightFP32ToFP16() {
         for (auto& input_name : input_names) {
           std::string input_weight_name = input_name + "_fp16";
           if (op_desc->HasAttr(input_weight_name)) {  // the input is fp16
-            Tensor tmp_tensor;
             auto input_tensor =
                 scope_->FindVar(input_name)->GetMutable<lite::Tensor>();
+            if (lazy_params_ && lazy_params_->Has(input_name)) {
+              // Convert the weight once it is loaded and dequantized.
+              lazy_params_->AddTransform(input_name, TensorFP32ToFP16);
+            } else {
+              TensorFP32ToFP16(input_tensor);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+#endif
 
-            if (input_tensor->precision() != PRECISION(kFloat)) continue;
+#ifdef LITE_WITH_X86
+namespace {
 
-            tmp_tensor.CopyDataFrom(*input_tensor);
-            input_tensor->clear();
-            input_tensor->set_precision(PRECISION(kFP16));
+void TensorFP32ToBF16(Tensor* input_tensor) {
+  if (input_tensor->precision() != PRECISION(kFloat)) return;
 
-            float16_t* fp_data = input_tensor->mutable_data<float16_t>();
-            const float* in_data = tmp_tensor.data<float>();
-            lite::arm::math::fp16::fp32_to_fp16(
-                in_data, fp_data, input_tensor->numel());
-          }
+  Tensor tmp_tensor;
+  tmp_tensor.CopyDataFrom(*input_tensor);
+  input_tensor->clear();
+  input_tensor->set_precision(PRECISION(kBF16));
+
+  bfloat16* bf_data = input_tensor->mutable_data<bfloat16>();
+  const float* in_data = tmp_tensor.data<float>();
+  lite::x86::math::fp32_to_bf16(in_data, bf_data, input_tensor->numel());
+}
+
+}  // namespace
+
+// The weights marked by bf16_attribute_pass are read by the bf16 kernels
+// only, which pack them once.
+void LightPredictor::WeightFP32ToBF16() {
+  std::shared_ptr<const cpp::ProgramDesc> program_desc = program_desc_;
+  for (size_t i = 0; i < program_desc->BlocksSize(); i++) {
+    auto* block = program_desc->GetBlock<cpp::BlockDesc>(i);
+    for (size_t k = 0; k < block->OpsSize(); ++k) {
+      auto* op_desc = block->GetOp<cpp::OpDesc>(k);
+      for (auto& input_name : op_desc->input_vars()) {
+        if (!op_desc->HasAttr(input_name + "_bf16")) continue;
+        if (lazy_params_ && lazy_params_->Has(input_name)) {
+          // Convert the weight once it is loaded and dequantized.
+          lazy_params_->AddTransform(input_name, TensorFP32ToBF16);
+        } else {
+          TensorFP32ToBF16(
+              scope_->FindVar(input_name)->GetMutable<lite::Tensor>());
         }
       }
     }
@@ -21,6 +21,7 @@
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <utility>
 #include <vector>
@@ -28,6 +29,7 @@
 #include "lite/core/context.h"
 #include "lite/core/program.h"
 #include "lite/core/tensor.h"
+#include "lite/core/thread_pool.h"
 #include "lite/core/types.h"
 #include "lite/model_parser/model_parser.h"
 
@@ -42,12 +44,16 @@ class LITE_API LightPredictor {
  public:
   // constructor function of LightPredictor, `lite_model_file` refers to data in
   // model file or buffer,`model_from_memory` refers to whther to load model
-  // from memory.
+  // from memory, `use_mmap` refers to whether to map the model file and share
+  // the params with it, `lazy_load_params` refers to whether to read every
+  // param on its first use.
   LightPredictor(const std::string& lite_model_file,
-                 bool model_from_memory = false) {
+                 bool model_from_memory = false,
+                 bool use_mmap = false,
+                 bool lazy_load_params = false) {
     scope_ = std::make_shared<Scope>();
     program_desc_ = std::make_shared<cpp::ProgramDesc>();
-    Build(lite_model_file, model_from_memory);
+    Build(lite_model_file, model_from_memory, use_mmap, lazy_load_params);
   }
 
   // NOTE: This is a deprecated API and will be removed in latter release.
@@ -62,12 +68,24 @@ class LITE_API LightPredictor {
     Build(model_dir, model_buffer, param_buffer, model_type, model_from_memory);
   }
 
+  // Create a predictor sharing the params and the program desc with this one,
+  // it runs a copy of the instructions on a private exec scope. The variables
+  // of `var_names` are copied into that scope instead of being shared. Return
+  // nullptr if one of them is not a persistable tensor.
+  std::unique_ptr<LightPredictor> Clone(
+      const std::vector<std::string>& var_names = {});
+
   void Run() {
     CheckInputValid();
     program_->Run();
     if (bool_clear_tensor_) ClearTensorArray(program_desc_);
   }
 
+  // See RuntimeProgram::set_shape_cache_enabled().
+  void set_shape_cache_enabled(bool enabled) {
+    program_->set_shape_cache_enabled(enabled);
+  }
+
   /// \brief Release all tmp tensor to compress the size of the memory pool.
   /// The memory pool is considered to be composed of a list of chunks, if
   /// the chunk is not occupied, it can be released.
@@ -87,9 +105,13 @@ class LITE_API LightPredictor {
   const lite::Tensor* GetTensor(const std::string& name) const {
     auto* var = program_->exec_scope()->FindVar(name);
     CHECK(var) << "no fatch variable " << name << " in exec_scope";
+    if (lazy_params_) lazy_params_->Load({name});
     return &var->Get<lite::Tensor>();
   }
 
+  // The params read on first use, nullptr if they are all loaded at build.
+  const LazyParams* lazy_params() const { return lazy_params_.get(); }
+
   // get inputnames and get outputnames.
   std::vector<std::string> GetInputNames();
   std::vector<std::string> GetOutputNames();
@@ -109,12 +131,16 @@ class LITE_API LightPredictor {
 #endif
 
  private:
+  LightPredictor() = default;
+
   // check if the input tensor precision type is correct.
   // would be called in Run().
   void CheckInputValid();
 
   void Build(const std::string& lite_model_file,
-             bool model_from_memory = false);
+             bool model_from_memory = false,
+             bool use_mmap = false,
+             bool lazy_load_params = false);
 
   // NOTE: This is a deprecated API and will be removed in latter release.
   void Build(
@@ -124,15 +150,26 @@ class LITE_API LightPredictor {
       lite_api::LiteModelType model_type = lite_api::LiteModelType::kProtobuf,
       bool model_from_memory = false);
 
+  // Create the exec scope holding the temporary variables of the program.
+  Scope* PrepareExecScope(
+      const std::shared_ptr<const cpp::ProgramDesc>& program_desc);
   void BuildRuntimeProgram(
       const std::shared_ptr<const cpp::ProgramDesc>& program_desc);
 
+  // Let the instructions of the main block load their lazy params, the ones
+  // of the sub-blocks are loaded right away.
+  void PrepareLazyParams();
+
   void DequantizeWeight();
 
 #ifdef ENABLE_ARM_FP16
   void WeightFP32ToFP16();
 #endif
 
+#ifdef LITE_WITH_X86
+  void WeightFP32ToBF16();
+#endif
+
   void ClearTensorArray(
       const std::shared_ptr<const cpp::ProgramDesc>& program_desc);
 
@@ -140,6 +177,7 @@ class LITE_API LightPredictor {
   std::shared_ptr<Scope> scope_;
   std::unique_ptr<RuntimeProgram> program_;
   std::shared_ptr<cpp::ProgramDesc> program_desc_;
+  std::shared_ptr<LazyParams> lazy_params_;
   std::vector<std::string> input_names_;
   std::vector<std::string> output_names_;
   std::vector<PrecisionType> input_precisions_;
@@ -149,6 +187,8 @@ class LITE_API LightPredictor {
 class LightPredictorImpl : public lite_api::PaddlePredictor {
  public:
   LightPredictorImpl() = default;
+  explicit LightPredictorImpl(std::unique_ptr<LightPredictor>&& raw_predictor)
+      : raw_predictor_(std::move(raw_predictor)) {}
   virtual ~LightPredictorImpl();
   std::unique_ptr<lite_api::Tensor> GetInput(int i) override;
   std::unique_ptr<const lite_api::Tensor> GetOutput(int i) const override;
@@ -178,6 +218,11 @@ class LightPredictorImpl : public lite_api::PaddlePredictor {
 
  private:
   std::unique_ptr<lite::LightPredictor> raw_predictor_;
+  lite_api::MobileConfig config_;
+  std::mutex mutex_;
+#ifdef LITE_USE_THREAD_POOL
+  std::shared_ptr<ThreadPool> thread_pool_;
+#endif
 };
 
 }  // namespace lite
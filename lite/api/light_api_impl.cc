@@ -14,6 +14,8 @@
 
 #include "lite/api/light_api.h"
 #include <string>
+#include <utility>
+#include <vector>
 #include "lite/api/paddle_api.h"
 #include "lite/core/version.h"
 #include "lite/model_parser/model_parser.h"
@@ -33,22 +35,34 @@ namespace paddle {
 namespace lite {
 
 void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
-  // LightPredictor Only support NaiveBuffer backend in publish lib
-  if (config.lite_model_file().empty()) {
-    raw_predictor_.reset(
-        new LightPredictor(config.model_dir(),
-                           config.model_buffer(),
-                           config.param_buffer(),
-                           config.is_model_from_memory(),
-                           lite_api::LiteModelType::kNaiveBuffer));
-  } else {
-    raw_predictor_.reset(new LightPredictor(config.lite_model_file(),
-                                            config.is_model_from_memory()));
+  config_ = config;
+  if (config.is_model_from_memory()) {
+    // The clones don't load the model, drop the copy of its buffer.
+    config_.set_model_from_buffer("");
   }
+  // A cloned predictor comes with its raw predictor.
+  if (!raw_predictor_) {
+    // LightPredictor Only support NaiveBuffer backend in publish lib
+    if (config.lite_model_file().empty()) {
+      raw_predictor_.reset(
+          new LightPredictor(config.model_dir(),
+                             config.model_buffer(),
+                             config.param_buffer(),
+                             config.is_model_from_memory(),
+                             lite_api::LiteModelType::kNaiveBuffer));
+    } else {
+      raw_predictor_.reset(new LightPredictor(config.lite_model_file(),
+                                              config.is_model_from_memory(),
+                                              config.use_mmap(),
+                                              config.lazy_load_params()));
+    }
+  }
+  raw_predictor_->set_shape_cache_enabled(config.shape_cache());
   mode_ = config.power_mode();
   threads_ = config.threads();
 #ifdef LITE_USE_THREAD_POOL
-  int thread_num = ThreadPool::Init(threads_);
+  // Each predictor, cloned ones included, owns its thread pool.
+  thread_pool_ = ThreadPool::Create(threads_, config.cpu_affinity());
 #endif
 
 #ifdef LITE_WITH_METAL
@@ -92,11 +106,7 @@ void LightPredictorImpl::Init(const lite_api::MobileConfig& config) {
 #endif
 }
 
-LightPredictorImpl::~LightPredictorImpl() {
-#ifdef LITE_USE_THREAD_POOL
-  ThreadPool::Destroy();
-#endif
-}
+LightPredictorImpl::~LightPredictorImpl() {}
 
 std::unique_ptr<lite_api::Tensor> LightPredictorImpl::GetInputByName(
     const std::string& name) {
@@ -124,19 +134,26 @@ std::unique_ptr<const lite_api::Tensor> LightPredictorImpl::GetOutput(
 void LightPredictorImpl::Run() {
 #ifdef LITE_WITH_ARM
   lite::DeviceInfo::Global().SetRunMode(mode_, threads_);
+#endif
+#ifdef LITE_USE_THREAD_POOL
+  ThreadPool::ScopedBind bind_thread_pool(thread_pool_.get());
 #endif
   raw_predictor_->Run();
 }
 
 std::shared_ptr<lite_api::PaddlePredictor> LightPredictorImpl::Clone() {
-  LOG(FATAL) << "The Clone API is not supported in LigthPredictor";
-  return nullptr;
+  return Clone(std::vector<std::string>());
 }
 
 std::shared_ptr<lite_api::PaddlePredictor> LightPredictorImpl::Clone(
     const std::vector<std::string>& var_names) {
-  LOG(FATAL) << "The Clone API is not supported in LigthPredictor";
-  return nullptr;
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto raw_predictor = raw_predictor_->Clone(var_names);
+  if (!raw_predictor) return nullptr;
+  auto predictor =
+      std::make_shared<LightPredictorImpl>(std::move(raw_predictor));
+  predictor->Init(config_);
+  return predictor;
 }
 
 std::string LightPredictorImpl::GetVersion() const { return lite::version(); }
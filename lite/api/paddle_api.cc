@@ -309,6 +309,8 @@ ConfigBase::ConfigBase(PowerMode mode, int threads) {
   lite::DeviceInfo::Global().SetRunMode(mode, threads);
   mode_ = lite::DeviceInfo::Global().mode();
   threads_ = lite::DeviceInfo::Global().threads();
+#else
+  threads_ = threads > 1 ? threads : 1;
 #endif
 }
 
@@ -374,9 +376,17 @@ void ConfigBase::set_threads(int threads) {
   lite::DeviceInfo::Global().SetRunMode(mode_, threads);
   mode_ = lite::DeviceInfo::Global().mode();
   threads_ = lite::DeviceInfo::Global().threads();
+#else
+  threads_ = threads > 1 ? threads : 1;
 #endif
 }
 
+void ConfigBase::set_threads(int threads,
+                             const std::vector<int> &cpu_affinity) {
+  set_threads(threads);
+  cpu_affinity_ = cpu_affinity;
+}
+
 void ConfigBase::set_metal_device(void *device) {
 #ifdef LITE_WITH_METAL
   metal_device_ = device;
@@ -19,6 +19,8 @@
 
 #ifndef PADDLE_LITE_API_H_  // NOLINT
 #define PADDLE_LITE_API_H_
+#include <cstdint>
+#include <future>  // NOLINT
 #include <map>
 #include <memory>
 #include <string>
@@ -149,6 +151,7 @@ class LITE_API PaddlePredictor {
 class LITE_API ConfigBase {
   std::string model_dir_;
   int threads_{1};
+  std::vector<int> cpu_affinity_{};
   PowerMode mode_{LITE_POWER_NO_BIND};
   // gpu opencl
   CLTuneMode opencl_tune_mode_{CL_TUNE_NONE};
@@ -174,6 +177,7 @@ class LITE_API ConfigBase {
   std::map<std::string, std::vector<char>> nnadapter_model_cache_buffers_{};
   int device_id_{0};
   int x86_math_num_threads_ = 1;
+  bool shape_cache_{true};
 
   std::string metal_path_;
   bool metal_use_mps_{false};
@@ -190,7 +194,12 @@ class LITE_API ConfigBase {
   const std::string& model_dir() const { return model_dir_; }
   // set Thread
   void set_threads(int threads);
+  // set Thread, and pin the worker threads of the predictor's thread pool to
+  // `cpu_affinity`. The calling thread is not pinned, the i-th of the
+  // `threads - 1` workers, from 0, is bound to cpu_affinity[i % size].
+  void set_threads(int threads, const std::vector<int>& cpu_affinity);
   int threads() const { return threads_; }
+  const std::vector<int>& cpu_affinity() const { return cpu_affinity_; }
   // set Power_mode
   void set_power_mode(PowerMode mode);
   PowerMode power_mode() const { return mode_; }
@@ -306,6 +315,11 @@ class LITE_API ConfigBase {
   // set x86_math_num_threads
   void set_x86_math_num_threads(int threads);
   int x86_math_num_threads() const;
+  // Skip the InferShape of the ops while the inputs keep the shapes of one of
+  // the last runs, on by default. Turn it off if the model is fed with a new
+  // shape on almost every run.
+  void set_shape_cache(bool shape_cache) { shape_cache_ = shape_cache; }
+  bool shape_cache() const { return shape_cache_; }
 
   void set_metal_lib_path(const std::string& path);
   void set_metal_use_mps(bool flag);
@@ -355,6 +369,7 @@ class LITE_API CxxConfig : public ConfigBase {
   QuantType quant_type_{QuantType::QUANT_INT16};
   bool sparse_model_{false};  // Enable sparse_conv_detect_pass in opt
   float sparse_threshold_{0.6f};
+  bool inter_op_parallel_{false};
   std::map<int, std::vector<std::shared_ptr<void>>>
       preferred_inputs_for_warmup_;
 #ifdef LITE_WITH_CUDA
@@ -491,6 +506,15 @@ class LITE_API CxxConfig : public ConfigBase {
   }
   float sparse_threshold() const { return sparse_threshold_; }
 
+  // Run the independent ops of the model at the same time on the threads set
+  // by `set_threads`, which are shared with the parallel loops inside the
+  // kernels. It takes effect in the builds with LITE_THREAD_POOL=ON, and for
+  // the models whose kernels all run on the host.
+  void set_inter_op_parallel(bool inter_op_parallel) {
+    inter_op_parallel_ = inter_op_parallel;
+  }
+  bool inter_op_parallel() const { return inter_op_parallel_; }
+
   // Enable the custom subgraph partition for NNAdapter by providing the
   // configuration file or buffer
   void set_nnadapter_subgraph_partition_config_path(
@@ -536,6 +560,10 @@ class LITE_API MobileConfig : public ConfigBase {
   // whether to load data from memory. Model data will be loaded from memory
   // buffer if model_from_memory_ is true.
   bool model_from_memory_{false};
+  // whether to map the model file into memory and share the params with it.
+  bool use_mmap_{false};
+  // whether to read every param on its first use.
+  bool lazy_load_params_{false};
 
   // model data readed from file or memory buffer in combined format.
   std::string lite_model_file_;
@@ -561,6 +589,24 @@ class LITE_API MobileConfig : public ConfigBase {
   // abandoned in v3.0.
   bool model_from_memory() const { return model_from_memory_; }
 
+  // map the model file set by `set_model_from_file` into memory. The params
+  // of a model saved by this version are read in place from the mapping,
+  // which skips copying them and lets the processes serving the same model
+  // share one copy in the page cache. The params written by the kernels
+  // become private copies of their pages.
+  void set_use_mmap(bool use_mmap) { use_mmap_ = use_mmap; }
+  bool use_mmap() const { return use_mmap_; }
+
+  // read every param of the model file set by `set_model_from_file` right
+  // before the first run of an op using it, which also dequantizes it if
+  // needed, instead of all of them at creation. The model file is mapped
+  // into memory as with `set_use_mmap`. It shortens the creation of the
+  // predictor, and the params of the ops that never run are never read.
+  void set_lazy_load_params(bool lazy_load_params) {
+    lazy_load_params_ = lazy_load_params;
+  }
+  bool lazy_load_params() const { return lazy_load_params_; }
+
   // NOTE: This is a deprecated API and will be removed in latter release.
   void set_model_buffer(const char* model_buffer,
                         size_t model_buffer_size,
@@ -582,6 +628,142 @@ class LITE_API MobileConfig : public ConfigBase {
 template <typename ConfigT>
 LITE_API std::shared_ptr<PaddlePredictor> CreatePaddlePredictor(const ConfigT&);
 
+/// The statistics of a PredictorPool.
+struct LITE_API PredictorPoolStats {
+  // The clones created so far and the ones leased out now.
+  int size{0};
+  int in_use{0};
+  // The leases handed out, and the ones that waited for a returned clone
+  // because all of them were in use at the cap.
+  int64_t acquired{0};
+  int64_t waited{0};
+  double total_wait_ms{0.};
+  double max_wait_ms{0.};
+  // The share of the clone time spent in the returned leases since the pool
+  // was created, in [0, 1].
+  double utilization{0.};
+};
+
+class PredictorPoolImpl;
+
+/// PredictorPool hands out the clones of one predictor to the serving
+/// threads. The clones share the persistable variables of the source one,
+/// `init_size` of them are created up front, and more are cloned on demand
+/// up to `max_size` once all of them are leased, after which `Acquire()`
+/// waits for a lease to be returned. The free clones are kept in a lock-free
+/// list, leasing one takes a single compare-and-swap.
+///
+///   PredictorPool pool(CreatePaddlePredictor(config), 4, 16);
+///   // On any thread:
+///   auto predictor = pool.Acquire();
+///   predictor->GetInput(0)->CopyFromCpu(data);
+///   predictor->Run();
+///   // The clone returns to the pool when `predictor` goes out of scope.
+class LITE_API PredictorPool {
+ public:
+  /// A clone leased from the pool, returned to it on destruction.
+  class LITE_API Lease {
+   public:
+    Lease() = default;
+    Lease(Lease&& other) noexcept;
+    Lease& operator=(Lease&& other) noexcept;
+    Lease(const Lease&) = delete;
+    Lease& operator=(const Lease&) = delete;
+    ~Lease() { Release(); }
+
+    PaddlePredictor* get() const { return predictor_; }
+    PaddlePredictor* operator->() const { return predictor_; }
+    PaddlePredictor& operator*() const { return *predictor_; }
+    explicit operator bool() const { return predictor_ != nullptr; }
+
+    /// Return the clone to the pool before the lease goes out of scope.
+    void Release();
+
+   private:
+    friend class PredictorPool;
+    friend class PredictorPoolImpl;
+    std::shared_ptr<PredictorPoolImpl> pool_;
+    PaddlePredictor* predictor_{nullptr};
+    int slot_{-1};
+    int64_t start_ns_{0};
+  };
+
+  PredictorPool(const std::shared_ptr<PaddlePredictor>& source,
+                int init_size,
+                int max_size);
+
+  /// Lease a free clone, clone a new one below the cap, or wait for one.
+  Lease Acquire();
+  /// Lease a clone without waiting, return false if none is available.
+  bool TryAcquire(Lease* lease);
+
+  PredictorPoolStats stats() const;
+  int max_size() const;
+
+ private:
+  std::shared_ptr<PredictorPoolImpl> impl_;
+};
+
+class BatchingPredictorImpl;
+
+/// BatchingPredictor coalesces the requests submitted from many threads into
+/// batches run by one predictor. A batch is closed when it holds
+/// `max_batch_size` samples or when its first request has waited
+/// `max_delay_us`. The inputs of the requests are concatenated along dim 0
+/// right into the input tensors of the predictor, and the outputs are split
+/// from its output tensors into the results of the requests.
+///
+/// The samples of a request are counted by its first input: the number of
+/// sequences of the LoD level 0 if it has a LoD, dim 0 otherwise. The LoDs of
+/// the requests are merged level by level, and an output is split by the
+/// sequences of its LoD level 0, or along dim 0 evenly per sample. The
+/// requests whose inputs differ beyond dim 0 go to different batches.
+///
+///   BatchingPredictor batching(CreatePaddlePredictor(config), 16, 2000);
+///   // On any thread:
+///   BatchingPredictor::Input input;
+///   input.shape = {1, 3, 224, 224};
+///   input.data = image;
+///   auto outputs = batching.Submit({input}).get();
+class LITE_API BatchingPredictor {
+ public:
+  /// An input of a request, `data` is read in place and must stay valid until
+  /// the result of the request is ready.
+  struct LITE_API Input {
+    shape_t shape;
+    lod_t lod;
+    PrecisionType precision{PrecisionType::kFloat};
+    const void* data{nullptr};
+  };
+  /// An output of a request.
+  struct LITE_API Output {
+    shape_t shape;
+    lod_t lod;
+    PrecisionType precision{PrecisionType::kUnk};
+    std::vector<char> data;
+  };
+
+  BatchingPredictor(const std::shared_ptr<PaddlePredictor>& predictor,
+                    int max_batch_size,
+                    int max_delay_us);
+  /// Run the queued requests and stop.
+  ~BatchingPredictor();
+
+  /// Queue a request holding one input per input of the predictor, in the
+  /// order of GetInputNames(). The future receives the outputs in the order
+  /// of GetOutputNames(). It holds a std::invalid_argument if the inputs
+  /// can't be batched, and a std::runtime_error if the outputs of the batch
+  /// can't be split into the requests.
+  std::future<std::vector<Output>> Submit(const std::vector<Input>& inputs);
+
+  /// The batches run and the requests served so far.
+  int64_t batch_num() const;
+  int64_t request_num() const;
+
+ private:
+  std::unique_ptr<BatchingPredictorImpl> impl_;
+};
+
 }  // namespace lite_api
 }  // namespace paddle
 
@@ -104,7 +104,8 @@ const std::string& PrecisionToStr(PrecisionType precision) {
                                                  "int64_t",
                                                  "int16_t",
                                                  "uint8_t",
-                                                 "double"};
+                                                 "double",
+                                                 "bfloat16"};
   auto x = static_cast<int>(precision);
   CHECK_LT(x, static_cast<int>(PRECISION(NUM)));
   return precision2string[x];
@@ -119,7 +120,8 @@ const std::string& DataLayoutToStr(DataLayoutType layout) {
                                                   "ImageFolder",
                                                   "ImageNW",
                                                   "MetalTexture2DArray",
-                                                  "MetalTexture2D"};
+                                                  "MetalTexture2D",
+                                                  "NCHW8c"};
   auto x = static_cast<int>(layout);
   CHECK_LT(x, static_cast<int>(DATALAYOUT(NUM)));
   return datalayout2string[x];
@@ -159,7 +161,10 @@ const std::string& PrecisionRepr(PrecisionType precision) {
                                                  "kFP16",
                                                  "kBool",
                                                  "kInt64",
-                                                 "kInt16"};
+                                                 "kInt16",
+                                                 "kUInt8",
+                                                 "kFP64",
+                                                 "kBF16"};
   auto x = static_cast<int>(precision);
   CHECK_LT(x, static_cast<int>(PRECISION(NUM)));
   return precision2string[x];
@@ -174,7 +179,8 @@ const std::string& DataLayoutRepr(DataLayoutType layout) {
                                                   "kImageFolder",
                                                   "kImageNW",
                                                   "kMetalTexture2DArray",
-                                                  "kMetalTexture2D"};
+                                                  "kMetalTexture2D",
+                                                  "kNCHW8c"};
   auto x = static_cast<int>(layout);
   CHECK_LT(x, static_cast<int>(DATALAYOUT(NUM)));
   return datalayout2string[x];
@@ -220,7 +226,11 @@ std::set<TargetType> ExpandValidTargets(TargetType target) {
 
 std::set<PrecisionType> ExpandValidPrecisions(PrecisionType precision) {
   static const std::set<PrecisionType> valid_set(
-      {PRECISION(kFloat), PRECISION(kInt8), PRECISION(kFP16), PRECISION(kAny)});
+      {PRECISION(kFloat),
+       PRECISION(kInt8),
+       PRECISION(kFP16),
+       PRECISION(kBF16),
+       PRECISION(kAny)});
   if (precision == PRECISION(kAny)) {
     return valid_set;
   }
@@ -236,7 +246,8 @@ std::set<DataLayoutType> ExpandValidLayouts(DataLayoutType layout) {
        DATALAYOUT(kImageFolder),
        DATALAYOUT(kImageNW),
        DATALAYOUT(kMetalTexture2DArray),
-       DATALAYOUT(kMetalTexture2D)});
+       DATALAYOUT(kMetalTexture2D),
+       DATALAYOUT(kNCHW8c)});
   if (layout == DATALAYOUT(kAny)) {
     return valid_set;
   }
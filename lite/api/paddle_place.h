@@ -76,7 +76,8 @@ enum class PrecisionType : int {
   kInt16 = 8,
   kUInt8 = 9,
   kFP64 = 10,
-  NUM = 11,  // number of fields.
+  kBF16 = 11,
+  NUM = 12,  // number of fields.
 };
 enum class DataLayoutType : int {
   kUnk = 0,
@@ -88,7 +89,8 @@ enum class DataLayoutType : int {
   kAny = 2,           // any data layout
   kMetalTexture2DArray = 7,
   kMetalTexture2D = 8,
-  NUM = 9,  // number of fields.
+  kNCHW8c = 9,  // for x86, channels blocked by 8
+  NUM = 10,     // number of fields.
 };
 
 typedef enum {
@@ -158,6 +160,8 @@ static size_t PrecisionTypeLength(PrecisionType type) {
       return 8;
     case PrecisionType::kFP16:
       return 2;
+    case PrecisionType::kBF16:
+      return 2;
     case PrecisionType::kInt16:
       return 2;
     default:
@@ -168,6 +172,8 @@ static size_t PrecisionTypeLength(PrecisionType type) {
 enum class QuantType : int {
   QUANT_INT8,
   QUANT_INT16,
+  // int4 by groups of rows of the 2-D weights of mul, the others are int8.
+  QUANT_INT4,
 };
 
 template <typename T>
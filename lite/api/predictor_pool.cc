@@ -0,0 +1,268 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <mutex>               // NOLINT
+#include <utility>
+#include <vector>
+
+#include "lite/api/paddle_api.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite_api {
+
+namespace {
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void AtomicMax(std::atomic<int64_t>* target, int64_t value) {
+  int64_t prev = target->load(std::memory_order_relaxed);
+  while (prev < value && !target->compare_exchange_weak(prev, value)) {
+  }
+}
+
+}  // namespace
+
+/*
+ * The free clones form a Treiber stack threaded through `next_`. The head
+ * packs the slot of the top clone plus one, zero for an empty stack, in its
+ * low 32 bits, and a tag bumped by every update in its high 32 bits, so that
+ * a clone popped and pushed back between the load and the compare-and-swap
+ * of another thread doesn't corrupt the stack.
+ *
+ * An Acquire() finding the pool exhausted at the cap sleeps on a condition
+ * variable, the mutex is only taken by the waiters and by the Release() that
+ * finds one of them registered.
+ */
+class PredictorPoolImpl {
+ public:
+  PredictorPoolImpl(const std::shared_ptr<PaddlePredictor>& source,
+                    int max_size)
+      : source_(source),
+        predictors_(max_size),
+        next_(new std::atomic<uint32_t>[max_size]),
+        max_size_(max_size),
+        created_ns_(NowNs()) {
+    for (int i = 0; i < max_size; ++i) {
+      next_[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  int Pop() {
+    uint64_t head = head_.load(std::memory_order_acquire);
+    while (true) {
+      uint32_t top = static_cast<uint32_t>(head & kSlotMask);
+      if (top == 0) return -1;
+      uint64_t next = next_[top - 1].load(std::memory_order_relaxed);
+      uint64_t new_head = (((head >> 32) + 1) << 32) | next;
+      if (head_.compare_exchange_weak(head,
+                                      new_head,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_acquire)) {
+        return static_cast<int>(top - 1);
+      }
+    }
+  }
+
+  void Push(int slot) {
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    uint64_t new_head;
+    do {
+      next_[slot].store(static_cast<uint32_t>(head & kSlotMask),
+                        std::memory_order_relaxed);
+      new_head = (((head >> 32) + 1) << 32) | static_cast<uint32_t>(slot + 1);
+    } while (!head_.compare_exchange_weak(head,
+                                          new_head,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed));
+  }
+
+  // Clone a new predictor into the next slot, return -1 at the cap.
+  int Grow() {
+    int size = size_.load();
+    while (size < max_size_) {
+      if (size_.compare_exchange_weak(size, size + 1)) {
+        predictors_[size] = source_->Clone();
+        CHECK(predictors_[size]) << "Failed to clone the predictor";
+        return size;
+      }
+    }
+    return -1;
+  }
+
+  // Lease a free clone or a new one, return -1 if neither is available.
+  int Take() {
+    int slot = Pop();
+    return slot >= 0 ? slot : Grow();
+  }
+
+  // Wait for a clone to be returned.
+  int Wait() {
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    waiters_.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int slot;
+    wait_cv_.wait(lock, [&]() { return (slot = Pop()) >= 0; });
+    waiters_.fetch_sub(1);
+    return slot;
+  }
+
+  // Return a clone and wake up a waiter, if any.
+  void Return(int slot) {
+    Push(slot);
+    // Either the waiter registered before this load, or its Pop() after the
+    // registration sees the pushed clone.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load() > 0) {
+      std::lock_guard<std::mutex> lock(wait_mutex_);
+      wait_cv_.notify_one();
+    }
+  }
+
+  void Lend(int slot, int64_t wait_ns, PredictorPool::Lease* lease);
+
+  static constexpr uint64_t kSlotMask = 0xffffffffu;
+
+  std::shared_ptr<PaddlePredictor> source_;
+  // The clones, slot i is written once by the thread that reserved it and
+  // published to the others by the Push() after its first lease.
+  std::vector<std::shared_ptr<PaddlePredictor>> predictors_;
+  std::unique_ptr<std::atomic<uint32_t>[]> next_;
+  std::atomic<uint64_t> head_{0};
+  std::atomic<int> size_{0};
+  const int max_size_;
+  std::atomic<int> waiters_{0};
+  std::mutex wait_mutex_;
+  std::condition_variable wait_cv_;
+
+  const int64_t created_ns_;
+  std::atomic<int> in_use_{0};
+  std::atomic<int64_t> acquired_{0};
+  std::atomic<int64_t> waited_{0};
+  std::atomic<int64_t> wait_ns_{0};
+  std::atomic<int64_t> max_wait_ns_{0};
+  // The time spent in the returned leases.
+  std::atomic<int64_t> busy_ns_{0};
+};
+
+constexpr uint64_t PredictorPoolImpl::kSlotMask;
+
+PredictorPool::Lease::Lease(Lease&& other) noexcept {
+  *this = std::move(other);
+}
+
+PredictorPool::Lease& PredictorPool::Lease::operator=(Lease&& other) noexcept {
+  if (this != &other) {
+    Release();
+    pool_ = std::move(other.pool_);
+    predictor_ = other.predictor_;
+    slot_ = other.slot_;
+    start_ns_ = other.start_ns_;
+    other.predictor_ = nullptr;
+    other.slot_ = -1;
+  }
+  return *this;
+}
+
+void PredictorPool::Lease::Release() {
+  if (!pool_) return;
+  pool_->busy_ns_.fetch_add(NowNs() - start_ns_, std::memory_order_relaxed);
+  pool_->in_use_.fetch_sub(1, std::memory_order_relaxed);
+  pool_->Return(slot_);
+  pool_.reset();
+  predictor_ = nullptr;
+  slot_ = -1;
+}
+
+PredictorPool::PredictorPool(const std::shared_ptr<PaddlePredictor>& source,
+                             int init_size,
+                             int max_size) {
+  CHECK(source) << "The source predictor can not be nullptr";
+  CHECK_GT(max_size, 0) << "The pool must hold one predictor at least";
+  CHECK_LE(init_size, max_size) << "init_size exceeds max_size";
+  impl_ = std::make_shared<PredictorPoolImpl>(source, max_size);
+  for (int i = 0; i < init_size; ++i) {
+    impl_->Push(impl_->Grow());
+  }
+}
+
+void PredictorPoolImpl::Lend(int slot,
+                             int64_t wait_ns,
+                             PredictorPool::Lease* lease) {
+  in_use_.fetch_add(1, std::memory_order_relaxed);
+  acquired_.fetch_add(1, std::memory_order_relaxed);
+  if (wait_ns > 0) {
+    waited_.fetch_add(1, std::memory_order_relaxed);
+    wait_ns_.fetch_add(wait_ns, std::memory_order_relaxed);
+    AtomicMax(&max_wait_ns_, wait_ns);
+  }
+  lease->predictor_ = predictors_[slot].get();
+  lease->slot_ = slot;
+  lease->start_ns_ = NowNs();
+}
+
+PredictorPool::Lease PredictorPool::Acquire() {
+  Lease lease;
+  int slot = impl_->Take();
+  int64_t wait_ns = 0;
+  if (slot < 0) {
+    // All the clones are leased at the cap, wait for one to be returned.
+    const int64_t start = NowNs();
+    slot = impl_->Wait();
+    wait_ns = std::max<int64_t>(NowNs() - start, 1);
+  }
+  impl_->Lend(slot, wait_ns, &lease);
+  lease.pool_ = impl_;
+  return lease;
+}
+
+bool PredictorPool::TryAcquire(Lease* lease) {
+  CHECK(lease);
+  int slot = impl_->Take();
+  if (slot < 0) return false;
+  lease->Release();
+  impl_->Lend(slot, 0, lease);
+  lease->pool_ = impl_;
+  return true;
+}
+
+PredictorPoolStats PredictorPool::stats() const {
+  PredictorPoolStats stats;
+  stats.size = impl_->size_.load();
+  stats.in_use = impl_->in_use_.load();
+  stats.acquired = impl_->acquired_.load();
+  stats.waited = impl_->waited_.load();
+  stats.total_wait_ms = impl_->wait_ns_.load() / 1e6;
+  stats.max_wait_ms = impl_->max_wait_ns_.load() / 1e6;
+  int64_t elapsed_ns = NowNs() - impl_->created_ns_;
+  if (elapsed_ns > 0 && stats.size > 0) {
+    stats.utilization = std::min(
+        1.0,
+        static_cast<double>(impl_->busy_ns_.load()) / elapsed_ns / stats.size);
+  }
+  return stats;
+}
+
+int PredictorPool::max_size() const { return impl_->max_size_; }
+
+}  // namespace lite_api
+}  // namespace paddle
@@ -294,7 +294,8 @@ void BindLitePlace(py::module *m) {
       .value("INT64", PrecisionType::kInt64)
       .value("INT16", PrecisionType::kInt16)
       .value("UINT8", PrecisionType::kUInt8)
-      .value("FP64", PrecisionType::kFP64);
+      .value("FP64", PrecisionType::kFP64)
+      .value("BF16", PrecisionType::kBF16);
 
   // DataLayoutType
   py::enum_<DataLayoutType>(*m, "DataLayoutType")
@@ -306,7 +307,8 @@ void BindLitePlace(py::module *m) {
       .value("ImageFolder", DataLayoutType::kImageFolder)
       .value("ImageNW", DataLayoutType::kImageNW)
       .value("MetalTexture2DArray", DataLayoutType::kMetalTexture2DArray)
-      .value("MetalTexture2D", DataLayoutType::kMetalTexture2D);
+      .value("MetalTexture2D", DataLayoutType::kMetalTexture2D)
+      .value("NCHW8c", DataLayoutType::kNCHW8c);
 
   // Place
   py::class_<Place>(*m, "Place")
@@ -0,0 +1,107 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// A closed-loop load generator for BatchingPredictor: every client submits a
+// request of one sample and waits for its result before the next one. It
+// reports the throughput and the latency percentiles without batching,
+// max_batch_size 1, and with the given max_batch_size and max_delay_us.
+//
+// ./batching_benchmark --model_dir=mobilenet_v1_opt --input_shape=1,3,224,224
+//     --clients=16 --max_batch_size=8 --max_delay_us=2000 --duration_s=10
+
+#include <gflags/gflags.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <functional>
+#include <numeric>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/api/paddle_api.h"
+#include "lite/api/test/test_helper.h"
+#include "lite/utils/log/cp_logging.h"
+#include "lite/utils/string.h"
+
+DEFINE_string(input_shape,
+              "1,3,224,224",
+              "the shape of a request of one sample, separated by comma");
+DEFINE_int32(clients, 16, "concurrent clients");
+DEFINE_int32(max_batch_size, 8, "max samples in a batch");
+DEFINE_int32(max_delay_us, 2000, "max delay of a request in a batch");
+DEFINE_int32(duration_s, 10, "seconds to run each setting");
+
+namespace paddle {
+namespace lite_api {
+
+void RunLoad(int max_batch_size) {
+  MobileConfig config;
+  config.set_model_from_file(FLAGS_model_dir + ".nb");
+  config.set_threads(FLAGS_threads);
+  auto predictor = CreatePaddlePredictor<MobileConfig>(config);
+
+  shape_t shape = lite::Split<int64_t>(FLAGS_input_shape, ",");
+  std::vector<float> data(
+      std::accumulate(
+          shape.begin(), shape.end(), 1, std::multiplies<int64_t>()),
+      1.f);
+  BatchingPredictor::Input input;
+  input.shape = shape;
+  input.data = data.data();
+
+  BatchingPredictor batching(predictor, max_batch_size, FLAGS_max_delay_us);
+  for (int i = 0; i < FLAGS_warmup; ++i) {
+    batching.Submit({input}).get();
+  }
+
+  std::atomic<bool> stop{false};
+  std::vector<std::vector<double>> latencies(FLAGS_clients);
+  std::vector<std::thread> clients;
+  const double start = lite::GetCurrentUS();
+  for (int c = 0; c < FLAGS_clients; ++c) {
+    clients.emplace_back([&, c]() {
+      while (!stop) {
+        double begin = lite::GetCurrentUS();
+        batching.Submit({input}).get();
+        latencies[c].push_back((lite::GetCurrentUS() - begin) / 1000.);
+      }
+    });
+  }
+  std::this_thread::sleep_for(std::chrono::seconds(FLAGS_duration_s));
+  stop = true;
+  for (auto& client : clients) client.join();
+  const double elapsed_s = (lite::GetCurrentUS() - start) / 1e6;
+
+  std::vector<double> all;
+  for (auto& l : latencies) all.insert(all.end(), l.begin(), l.end());
+  CHECK(!all.empty()) << "No request finished in " << FLAGS_duration_s << "s";
+  std::sort(all.begin(), all.end());
+  LOG(INFO) << "max_batch_size: " << max_batch_size
+            << ", requests: " << all.size() << ", batches: "
+            << batching.batch_num() - FLAGS_warmup
+            << ", throughput: " << all.size() / elapsed_s << " req/s"
+            << ", p50: " << all[all.size() / 2] << " ms"
+            << ", p99: " << all[all.size() * 99 / 100] << " ms";
+}
+
+}  // namespace lite_api
+}  // namespace paddle
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  CHECK(!FLAGS_model_dir.empty()) << "--model_dir is required";
+  paddle::lite_api::RunLoad(1);
+  paddle::lite_api::RunLoad(FLAGS_max_batch_size);
+  return 0;
+}
@@ -0,0 +1,220 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/api/paddle_api.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite_api {
+
+// A predictor with one input and one output, out = 2 * x, keeping the LoD.
+class DoublePredictor : public PaddlePredictor {
+ public:
+  std::unique_ptr<Tensor> GetInput(int i) override {
+    return std::unique_ptr<Tensor>(new Tensor(&x_));
+  }
+  std::unique_ptr<const Tensor> GetOutput(int i) const override {
+    return std::unique_ptr<const Tensor>(new Tensor(&out_));
+  }
+  void Run() override {
+    out_.Resize(x_.dims());
+    out_.set_lod(keep_lod_ ? x_.lod() : lite::LoD());
+    const float* x = x_.data<float>();
+    float* out = out_.mutable_data<float>();
+    for (int64_t i = 0; i < x_.numel(); ++i) {
+      out[i] = 2.f * x[i];
+    }
+    batch_sizes_.push_back(x_.dims()[0]);
+  }
+  std::shared_ptr<PaddlePredictor> Clone() override { return nullptr; }
+  std::shared_ptr<PaddlePredictor> Clone(
+      const std::vector<std::string>& var_names) override {
+    return nullptr;
+  }
+  std::string GetVersion() const override { return "fake"; }
+  std::vector<std::string> GetInputNames() override { return {"x"}; }
+  std::vector<std::string> GetOutputNames() override { return {"out"}; }
+  bool TryShrinkMemory() override { return true; }
+  std::unique_ptr<Tensor> GetInputByName(const std::string& name) override {
+    return GetInput(0);
+  }
+  std::unique_ptr<const Tensor> GetTensor(
+      const std::string& name) const override {
+    return GetOutput(0);
+  }
+
+  std::vector<int64_t> batch_sizes_;
+  bool keep_lod_{true};
+
+ private:
+  lite::Tensor x_;
+  lite::Tensor out_;
+};
+
+BatchingPredictor::Input MakeInput(const std::vector<float>& data,
+                                   const shape_t& shape,
+                                   const lod_t& lod = {}) {
+  BatchingPredictor::Input input;
+  input.shape = shape;
+  input.lod = lod;
+  input.data = data.data();
+  return input;
+}
+
+const float* OutputData(const BatchingPredictor::Output& output) {
+  return reinterpret_cast<const float*>(output.data.data());
+}
+
+TEST(BatchingPredictor, coalesce_dense) {
+  auto predictor = std::make_shared<DoublePredictor>();
+  const int request_num = 6;
+  std::vector<std::vector<float>> data(request_num);
+  std::vector<std::future<std::vector<BatchingPredictor::Output>>> results;
+  {
+    // The batches are packed in order up to 4 samples: {0, 1, 2}, {3, 4}
+    // and {5}, the last one closed by its delay.
+    BatchingPredictor batching(predictor, 4, 100000);
+    for (int r = 0; r < request_num; ++r) {
+      // One sample of 3 floats in the even requests, two in the odd ones.
+      int64_t samples = r % 2 + 1;
+      for (int k = 0; k < samples * 3; ++k) data[r].push_back(r * 10 + k);
+      results.push_back(batching.Submit({MakeInput(data[r], {samples, 3})}));
+    }
+    for (int r = 0; r < request_num; ++r) {
+      auto outputs = results[r].get();
+      ASSERT_EQ(outputs.size(), 1u);
+      int64_t samples = r % 2 + 1;
+      EXPECT_EQ(outputs[0].shape, shape_t({samples, 3}));
+      EXPECT_EQ(outputs[0].precision, PrecisionType::kFloat);
+      ASSERT_EQ(outputs[0].data.size(), samples * 3 * sizeof(float));
+      for (int k = 0; k < samples * 3; ++k) {
+        EXPECT_EQ(OutputData(outputs[0])[k], 2.f * data[r][k]);
+      }
+    }
+    EXPECT_EQ(batching.request_num(), request_num);
+    EXPECT_EQ(batching.batch_num(), 3);
+  }
+  EXPECT_EQ(predictor->batch_sizes_, std::vector<int64_t>({4, 3, 2}));
+}
+
+TEST(BatchingPredictor, split_by_lod) {
+  auto predictor = std::make_shared<DoublePredictor>();
+  std::vector<float> a = {1, 2, 3};
+  std::vector<float> b = {4, 5, 6, 7};
+  std::future<std::vector<BatchingPredictor::Output>> ra, rb;
+  {
+    BatchingPredictor batching(predictor, 8, 1000000);
+    ra = batching.Submit({MakeInput(a, {3, 1}, {{0, 1, 3}})});
+    rb = batching.Submit({MakeInput(b, {4, 1}, {{0, 4}})});
+  }
+  // Queued requests are run when the front-end is destroyed.
+  auto oa = ra.get();
+  auto ob = rb.get();
+  EXPECT_EQ(predictor->batch_sizes_, std::vector<int64_t>({7}));
+  EXPECT_EQ(oa[0].lod, lod_t({{0, 1, 3}}));
+  EXPECT_EQ(oa[0].shape, shape_t({3, 1}));
+  EXPECT_EQ(ob[0].lod, lod_t({{0, 4}}));
+  EXPECT_EQ(ob[0].shape, shape_t({4, 1}));
+  for (int k = 0; k < 4; ++k) {
+    EXPECT_EQ(OutputData(ob[0])[k], 2.f * b[k]);
+  }
+}
+
+TEST(BatchingPredictor, incompatible_shapes) {
+  auto predictor = std::make_shared<DoublePredictor>();
+  std::vector<float> a(2, 1.f), b(3, 1.f);
+  std::future<std::vector<BatchingPredictor::Output>> ra, rb;
+  {
+    BatchingPredictor batching(predictor, 8, 1000000);
+    ra = batching.Submit({MakeInput(a, {1, 2})});
+    rb = batching.Submit({MakeInput(b, {1, 3})});
+  }
+  EXPECT_EQ(ra.get()[0].shape, shape_t({1, 2}));
+  EXPECT_EQ(rb.get()[0].shape, shape_t({1, 3}));
+  EXPECT_EQ(predictor->batch_sizes_, std::vector<int64_t>({1, 1}));
+}
+
+TEST(BatchingPredictor, bad_requests) {
+  auto predictor = std::make_shared<DoublePredictor>();
+  std::vector<float> a(4, 1.f);
+  BatchingPredictor batching(predictor, 8, 100);
+  auto expect_rejected = [&](const std::vector<BatchingPredictor::Input>& in) {
+    auto result = batching.Submit(in);
+    EXPECT_THROW(result.get(), std::invalid_argument);
+  };
+  expect_rejected({});
+  expect_rejected({MakeInput(a, {})});
+  expect_rejected({MakeInput(a, {2, -2})});
+  expect_rejected({MakeInput(a, {0, 4})});
+  expect_rejected({MakeInput(a, {4, 1}, {{0, 1, 3}})});
+  expect_rejected({MakeInput(a, {4, 1}, {{0, 3, 1, 4}})});
+  auto fp16 = MakeInput(a, {2, 1});
+  fp16.precision = PrecisionType::kFP16;
+  expect_rejected({fp16});
+  auto unset = MakeInput(a, {2, 2});
+  unset.data = nullptr;
+  expect_rejected({unset});
+  // The rejected requests never reached the predictor.
+  EXPECT_TRUE(predictor->batch_sizes_.empty());
+  auto outputs = batching.Submit({MakeInput(a, {2, 2})}).get();
+  EXPECT_EQ(outputs[0].shape, shape_t({2, 2}));
+  EXPECT_EQ(batching.request_num(), 1);
+}
+
+TEST(BatchingPredictor, unsplittable_output) {
+  auto predictor = std::make_shared<DoublePredictor>();
+  // The output loses the LoD, its 7 rows can't be split into 3 samples.
+  predictor->keep_lod_ = false;
+  std::vector<float> a = {1, 2, 3};
+  std::vector<float> b = {4, 5, 6, 7};
+  std::future<std::vector<BatchingPredictor::Output>> ra, rb;
+  {
+    BatchingPredictor batching(predictor, 8, 1000000);
+    ra = batching.Submit({MakeInput(a, {3, 1}, {{0, 1, 3}})});
+    rb = batching.Submit({MakeInput(b, {4, 1}, {{0, 4}})});
+  }
+  EXPECT_THROW(ra.get(), std::runtime_error);
+  EXPECT_THROW(rb.get(), std::runtime_error);
+}
+
+TEST(BatchingPredictor, concurrent_clients) {
+  auto predictor = std::make_shared<DoublePredictor>();
+  BatchingPredictor batching(predictor, 8, 200);
+  const int thread_num = 4, repeat = 50;
+  std::atomic<int> wrong{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = 0; i < repeat; ++i) {
+        std::vector<float> data = {static_cast<float>(t * 1000 + i)};
+        auto outputs = batching.Submit({MakeInput(data, {1, 1})}).get();
+        if (OutputData(outputs[0])[0] != 2.f * data[0]) ++wrong;
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  EXPECT_EQ(wrong, 0);
+  EXPECT_EQ(batching.request_num(), thread_num * repeat);
+  EXPECT_LE(batching.batch_num(), thread_num * repeat);
+}
+
+}  // namespace lite_api
+}  // namespace paddle
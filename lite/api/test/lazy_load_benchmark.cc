@@ -0,0 +1,89 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Measures the startup of a MobileConfig predictor: the time to create it,
+// the time to the end of the first run and the resident memory after it.
+// Run it once per loading mode, the page cache being warm, e.g.
+//
+// ./lazy_load_benchmark --model_dir=mobilenet_v1_opt --load_mode=eager
+// ./lazy_load_benchmark --model_dir=mobilenet_v1_opt --load_mode=mmap
+// ./lazy_load_benchmark --model_dir=mobilenet_v1_opt --load_mode=lazy
+
+#include <gflags/gflags.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "lite/api/paddle_api.h"
+#include "lite/api/test/test_helper.h"
+#include "lite/utils/log/cp_logging.h"
+#include "lite/utils/string.h"
+
+DEFINE_string(input_shape,
+              "1,3,224,224",
+              "the shape of the first input, separated by comma");
+DEFINE_string(load_mode, "lazy", "eager, mmap or lazy");
+
+namespace paddle {
+namespace lite_api {
+
+// The resident memory of the process in KB, 0 if unknown.
+int64_t ResidentKB() {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmRSS:") == 0) {
+      return std::stoll(line.substr(6));
+    }
+  }
+  return 0;
+}
+
+void RunStartup() {
+  MobileConfig config;
+  config.set_model_from_file(FLAGS_model_dir + ".nb");
+  config.set_threads(FLAGS_threads);
+  config.set_use_mmap(FLAGS_load_mode == "mmap");
+  config.set_lazy_load_params(FLAGS_load_mode == "lazy");
+
+  const double start = lite::GetCurrentUS();
+  auto predictor = CreatePaddlePredictor<MobileConfig>(config);
+  const double created = lite::GetCurrentUS();
+  const int64_t created_kb = ResidentKB();
+
+  shape_t shape = lite::Split<int64_t>(FLAGS_input_shape, ",");
+  auto input = predictor->GetInput(0);
+  input->Resize(shape);
+  float* data = input->mutable_data<float>();
+  int64_t size = 1;
+  for (auto dim : shape) size *= dim;
+  for (int64_t i = 0; i < size; ++i) data[i] = 1.f;
+  predictor->Run();
+  const double first_run = lite::GetCurrentUS();
+
+  LOG(INFO) << "load_mode: " << FLAGS_load_mode
+            << ", create: " << (created - start) / 1000. << " ms"
+            << ", time to first inference: " << (first_run - start) / 1000.
+            << " ms, RSS after create: " << created_kb
+            << " KB, RSS after first inference: " << ResidentKB() << " KB";
+}
+
+}  // namespace lite_api
+}  // namespace paddle
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+  CHECK(!FLAGS_model_dir.empty()) << "--model_dir is required";
+  paddle::lite_api::RunStartup();
+  return 0;
+}
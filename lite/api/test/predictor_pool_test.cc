@@ -0,0 +1,162 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+#include "lite/api/paddle_api.h"
+
+namespace paddle {
+namespace lite_api {
+
+// A predictor that only checks it is never run by two threads at once.
+class FakePredictor : public PaddlePredictor {
+ public:
+  explicit FakePredictor(std::atomic<int>* clone_num)
+      : clone_num_(clone_num) {}
+
+  std::unique_ptr<Tensor> GetInput(int i) override { return nullptr; }
+  std::unique_ptr<const Tensor> GetOutput(int i) const override {
+    return nullptr;
+  }
+  void Run() override {
+    if (running_.exchange(true)) overlapped_ = true;
+    std::this_thread::yield();
+    ++run_num_;
+    running_ = false;
+  }
+  std::shared_ptr<PaddlePredictor> Clone() override {
+    ++*clone_num_;
+    return std::make_shared<FakePredictor>(clone_num_);
+  }
+  std::shared_ptr<PaddlePredictor> Clone(
+      const std::vector<std::string>& var_names) override {
+    return Clone();
+  }
+  std::string GetVersion() const override { return "fake"; }
+  std::vector<std::string> GetInputNames() override { return {}; }
+  std::vector<std::string> GetOutputNames() override { return {}; }
+  bool TryShrinkMemory() override { return true; }
+  std::unique_ptr<Tensor> GetInputByName(const std::string& name) override {
+    return nullptr;
+  }
+  std::unique_ptr<const Tensor> GetTensor(
+      const std::string& name) const override {
+    return nullptr;
+  }
+
+  static bool overlapped_;
+
+ private:
+  std::atomic<int>* clone_num_;
+  std::atomic<bool> running_{false};
+  int run_num_{0};
+};
+
+bool FakePredictor::overlapped_ = false;
+
+TEST(PredictorPool, grow_to_cap) {
+  std::atomic<int> clone_num{0};
+  PredictorPool pool(std::make_shared<FakePredictor>(&clone_num), 2, 3);
+  EXPECT_EQ(clone_num, 2);
+  EXPECT_EQ(pool.stats().size, 2);
+
+  auto a = pool.Acquire();
+  auto b = pool.Acquire();
+  EXPECT_EQ(clone_num, 2);
+  PredictorPool::Lease c;
+  EXPECT_TRUE(pool.TryAcquire(&c));
+  EXPECT_EQ(clone_num, 3);
+  PredictorPool::Lease d;
+  EXPECT_FALSE(pool.TryAcquire(&d));
+  EXPECT_FALSE(d);
+  EXPECT_EQ(pool.stats().in_use, 3);
+
+  PaddlePredictor* returned = b.get();
+  b.Release();
+  EXPECT_FALSE(b);
+  EXPECT_TRUE(pool.TryAcquire(&d));
+  EXPECT_EQ(d.get(), returned);
+
+  PredictorPool::Lease moved(std::move(d));
+  EXPECT_EQ(moved.get(), returned);
+  EXPECT_FALSE(d);
+  moved.Release();
+  a.Release();
+  c.Release();
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.size, 3);
+  EXPECT_EQ(stats.in_use, 0);
+  EXPECT_EQ(stats.acquired, 4);
+  EXPECT_EQ(stats.waited, 0);
+}
+
+TEST(PredictorPool, concurrent_leases) {
+  std::atomic<int> clone_num{0};
+  PredictorPool pool(std::make_shared<FakePredictor>(&clone_num), 1, 3);
+  const int thread_num = 8, repeat = 500;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&]() {
+      for (int i = 0; i < repeat; ++i) {
+        auto predictor = pool.Acquire();
+        ASSERT_TRUE(predictor);
+        predictor->Run();
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  EXPECT_FALSE(FakePredictor::overlapped_);
+  auto stats = pool.stats();
+  EXPECT_LE(stats.size, 3);
+  EXPECT_EQ(stats.size, clone_num);
+  EXPECT_EQ(stats.in_use, 0);
+  EXPECT_EQ(stats.acquired, thread_num * repeat);
+  EXPECT_GE(stats.total_wait_ms, stats.max_wait_ms);
+  EXPECT_GE(stats.utilization, 0.);
+  EXPECT_LE(stats.utilization, 1.);
+}
+
+TEST(PredictorPool, acquire_sleeps_at_cap) {
+  std::atomic<int> clone_num{0};
+  PredictorPool pool(std::make_shared<FakePredictor>(&clone_num), 1, 1);
+  auto held = pool.Acquire();
+  PaddlePredictor* returned = held.get();
+  std::atomic<bool> acquired{false};
+  std::clock_t cpu_begin = std::clock();
+  std::thread waiter([&]() {
+    auto predictor = pool.Acquire();
+    EXPECT_EQ(predictor.get(), returned);
+    acquired = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  EXPECT_FALSE(acquired);
+  held.Release();
+  waiter.join();
+  EXPECT_TRUE(acquired);
+  // The waiter slept instead of polling the pool.
+  double cpu = static_cast<double>(std::clock() - cpu_begin) / CLOCKS_PER_SEC;
+  EXPECT_LT(cpu, 0.1);
+  auto stats = pool.stats();
+  EXPECT_EQ(stats.waited, 1);
+  EXPECT_GE(stats.max_wait_ms, 100.);
+}
+
+}  // namespace lite_api
+}  // namespace paddle
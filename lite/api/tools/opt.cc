@@ -45,8 +45,8 @@ DEFINE_bool(quant_model,
             "Use post_quant_dynamic method to quantize the model weights.");
 DEFINE_string(quant_type,
               "QUANT_INT16",
-              "Set the quant_type for post_quant_dynamic, "
-              "and it should be QUANT_INT8 or QUANT_INT16 for now.");
+              "Set the quant_type for post_quant_dynamic, and it should be "
+              "QUANT_INT8, QUANT_INT16 or QUANT_INT4 for now.");
 DEFINE_bool(enable_fp16, false, "Set kernel_type run in FP16.");
 DEFINE_bool(record_tailoring_info,
             false,
@@ -70,7 +70,8 @@ DEFINE_bool(print_all_ops_in_md_format,
 DEFINE_bool(print_model_ops, false, "Print operators in the input model");
 DEFINE_bool(sparse_model,
             false,
-            "Use sparse_conv_detect_pass to sparsify the 1x1conv weights.");
+            "Use sparse_conv_detect_pass to sparsify the 1x1conv weights, "
+            "and the fc and mul weights on x86.");
 DEFINE_double(sparse_threshold,
               0.6,
               "Set 0.6 as the lower bound for the sparse conv pass.");
@@ -0,0 +1,340 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/host/math/nms.h"
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include "lite/backends/host/math/topk.h"
+#include "lite/core/workspace.h"
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+namespace {
+
+// The columns of the candidate boxes, rounded up to 4 by empty boxes.
+struct NmsBoxes {
+  float* x1;
+  float* y1;
+  float* x2;
+  float* y2;
+  float* area;
+};
+
+int round_up4(int n) { return (n + 3) & ~3; }
+
+NmsBoxes alloc_boxes(WorkSpace* workspace, int n) {
+  const int n4 = round_up4(n);
+  NmsBoxes b;
+  b.x1 = workspace->Alloc<float>(n4);
+  b.y1 = workspace->Alloc<float>(n4);
+  b.x2 = workspace->Alloc<float>(n4);
+  b.y2 = workspace->Alloc<float>(n4);
+  b.area = workspace->Alloc<float>(n4);
+  std::memset(b.x1 + n, 0, (n4 - n) * sizeof(float));
+  std::memset(b.y1 + n, 0, (n4 - n) * sizeof(float));
+  std::memset(b.x2 + n, 0, (n4 - n) * sizeof(float));
+  std::memset(b.y2 + n, 0, (n4 - n) * sizeof(float));
+  std::memset(b.area + n, 0, (n4 - n) * sizeof(float));
+  return b;
+}
+
+// Put box, with its area as BBoxArea, at i.
+void set_box(const NmsBoxes& b, int i, const float* box, float norm) {
+  b.x1[i] = box[0];
+  b.y1[i] = box[1];
+  b.x2[i] = box[2];
+  b.y2[i] = box[3];
+  b.area[i] = box[2] < box[0] || box[3] < box[1]
+                  ? 0.f
+                  : (box[2] - box[0] + norm) * (box[3] - box[1] + norm);
+}
+
+void copy_box(const NmsBoxes& src, int i, const NmsBoxes& dst, int j) {
+  dst.x1[j] = src.x1[i];
+  dst.y1[j] = src.y1[i];
+  dst.x2[j] = src.x2[i];
+  dst.y2[j] = src.y2[i];
+  dst.area[j] = src.area[i];
+}
+
+#if defined(__SSE__) || defined(_M_X64)
+// The IoU of the box i of a and the boxes [j, j + 4) of b.
+inline __m128 iou4(
+    const NmsBoxes& a, int i, const NmsBoxes& b, int j, float norm) {
+  __m128 ax1 = _mm_set1_ps(a.x1[i]);
+  __m128 ay1 = _mm_set1_ps(a.y1[i]);
+  __m128 ax2 = _mm_set1_ps(a.x2[i]);
+  __m128 ay2 = _mm_set1_ps(a.y2[i]);
+  __m128 bx1 = _mm_loadu_ps(b.x1 + j);
+  __m128 by1 = _mm_loadu_ps(b.y1 + j);
+  __m128 bx2 = _mm_loadu_ps(b.x2 + j);
+  __m128 by2 = _mm_loadu_ps(b.y2 + j);
+  __m128 disjoint = _mm_or_ps(
+      _mm_or_ps(_mm_cmpgt_ps(bx1, ax2), _mm_cmplt_ps(bx2, ax1)),
+      _mm_or_ps(_mm_cmpgt_ps(by1, ay2), _mm_cmplt_ps(by2, ay1)));
+  __m128 vnorm = _mm_set1_ps(norm);
+  __m128 inter_w = _mm_add_ps(
+      _mm_sub_ps(_mm_min_ps(ax2, bx2), _mm_max_ps(ax1, bx1)), vnorm);
+  __m128 inter_h = _mm_add_ps(
+      _mm_sub_ps(_mm_min_ps(ay2, by2), _mm_max_ps(ay1, by1)), vnorm);
+  __m128 inter_area = _mm_mul_ps(inter_w, inter_h);
+  __m128 area_sum =
+      _mm_add_ps(_mm_set1_ps(a.area[i]), _mm_loadu_ps(b.area + j));
+  __m128 iou = _mm_div_ps(inter_area, _mm_sub_ps(area_sum, inter_area));
+  return _mm_andnot_ps(disjoint, iou);
+}
+
+// The bits of the boxes [j, j + 4) of b whose IoU with the box i of a is not
+// at most threshold.
+inline int over4(const NmsBoxes& a,
+                 int i,
+                 const NmsBoxes& b,
+                 int j,
+                 float threshold,
+                 float norm) {
+  return _mm_movemask_ps(
+      _mm_cmpnle_ps(iou4(a, i, b, j, norm), _mm_set1_ps(threshold)));
+}
+
+inline void store_iou4(const NmsBoxes& a,
+                       int i,
+                       const NmsBoxes& b,
+                       int j,
+                       float norm,
+                       float* iou) {
+  _mm_storeu_ps(iou, iou4(a, i, b, j, norm));
+}
+#elif defined(__aarch64__)
+inline float32x4_t iou4(
+    const NmsBoxes& a, int i, const NmsBoxes& b, int j, float norm) {
+  float32x4_t ax1 = vdupq_n_f32(a.x1[i]);
+  float32x4_t ay1 = vdupq_n_f32(a.y1[i]);
+  float32x4_t ax2 = vdupq_n_f32(a.x2[i]);
+  float32x4_t ay2 = vdupq_n_f32(a.y2[i]);
+  float32x4_t bx1 = vld1q_f32(b.x1 + j);
+  float32x4_t by1 = vld1q_f32(b.y1 + j);
+  float32x4_t bx2 = vld1q_f32(b.x2 + j);
+  float32x4_t by2 = vld1q_f32(b.y2 + j);
+  uint32x4_t disjoint =
+      vorrq_u32(vorrq_u32(vcgtq_f32(bx1, ax2), vcltq_f32(bx2, ax1)),
+                vorrq_u32(vcgtq_f32(by1, ay2), vcltq_f32(by2, ay1)));
+  float32x4_t vnorm = vdupq_n_f32(norm);
+  float32x4_t inter_w =
+      vaddq_f32(vsubq_f32(vminq_f32(ax2, bx2), vmaxq_f32(ax1, bx1)), vnorm);
+  float32x4_t inter_h =
+      vaddq_f32(vsubq_f32(vminq_f32(ay2, by2), vmaxq_f32(ay1, by1)), vnorm);
+  float32x4_t inter_area = vmulq_f32(inter_w, inter_h);
+  float32x4_t area_sum =
+      vaddq_f32(vdupq_n_f32(a.area[i]), vld1q_f32(b.area + j));
+  float32x4_t iou = vdivq_f32(inter_area, vsubq_f32(area_sum, inter_area));
+  return vreinterpretq_f32_u32(
+      vbicq_u32(vreinterpretq_u32_f32(iou), disjoint));
+}
+
+inline int over4(const NmsBoxes& a,
+                 int i,
+                 const NmsBoxes& b,
+                 int j,
+                 float threshold,
+                 float norm) {
+  uint32x4_t over = vmvnq_u32(
+      vcleq_f32(iou4(a, i, b, j, norm), vdupq_n_f32(threshold)));
+  uint32x4_t bits = vshrq_n_u32(over, 31);
+  return vgetq_lane_u32(bits, 0) | (vgetq_lane_u32(bits, 1) << 1) |
+         (vgetq_lane_u32(bits, 2) << 2) | (vgetq_lane_u32(bits, 3) << 3);
+}
+
+inline void store_iou4(const NmsBoxes& a,
+                       int i,
+                       const NmsBoxes& b,
+                       int j,
+                       float norm,
+                       float* iou) {
+  vst1q_f32(iou, iou4(a, i, b, j, norm));
+}
+#else
+// JaccardOverlap of the box i of a and the box j of b.
+float iou_ref(const NmsBoxes& a, int i, const NmsBoxes& b, int j, float norm) {
+  if (b.x1[j] > a.x2[i] || b.x2[j] < a.x1[i] || b.y1[j] > a.y2[i] ||
+      b.y2[j] < a.y1[i]) {
+    return 0.f;
+  }
+  const float inter_w =
+      (std::min)(a.x2[i], b.x2[j]) - (std::max)(a.x1[i], b.x1[j]) + norm;
+  const float inter_h =
+      (std::min)(a.y2[i], b.y2[j]) - (std::max)(a.y1[i], b.y1[j]) + norm;
+  const float inter_area = inter_w * inter_h;
+  return inter_area / (a.area[i] + b.area[j] - inter_area);
+}
+
+inline int over4(const NmsBoxes& a,
+                 int i,
+                 const NmsBoxes& b,
+                 int j,
+                 float threshold,
+                 float norm) {
+  int bits = 0;
+  for (int t = 0; t < 4; ++t) {
+    if (!(iou_ref(a, i, b, j + t, norm) <= threshold)) bits |= 1 << t;
+  }
+  return bits;
+}
+
+inline void store_iou4(const NmsBoxes& a,
+                       int i,
+                       const NmsBoxes& b,
+                       int j,
+                       float norm,
+                       float* iou) {
+  for (int t = 0; t < 4; ++t) iou[t] = iou_ref(a, i, b, j + t, norm);
+}
+#endif
+
+}  // namespace
+
+int nms_candidates(const float* scores,
+                   int n,
+                   float score_threshold,
+                   int top_k,
+                   int* order) {
+  auto& workspace = WorkSpace::Global_Host();
+  size_t workspace_mark = workspace.cursor();
+  auto* pairs = workspace.Alloc<std::pair<float, int>>(n);
+  int num = 0;
+  int i = 0;
+#if defined(__SSE__) || defined(_M_X64)
+  // Most scores of a detector are below the threshold, skip them 4 at a time.
+  __m128 vthreshold = _mm_set1_ps(score_threshold);
+  for (; i + 4 <= n; i += 4) {
+    int bits =
+        _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(scores + i), vthreshold));
+    for (int t = 0; bits != 0; ++t, bits >>= 1) {
+      if (bits & 1) pairs[num++] = std::make_pair(scores[i + t], i + t);
+    }
+  }
+#endif
+  for (; i < n; ++i) {
+    if (scores[i] > score_threshold) {
+      pairs[num++] = std::make_pair(scores[i], i);
+    }
+  }
+  int k = top_k > -1 && top_k < num ? top_k : num;
+  sort_topk_pairs(pairs, num, k, true);
+  for (int j = 0; j < k; ++j) order[j] = pairs[j].second;
+  workspace.Rewind(workspace_mark);
+  return k;
+}
+
+int nms_boxes(const float* boxes,
+              int box_stride,
+              const int* order,
+              int n,
+              float nms_threshold,
+              float eta,
+              bool normalized,
+              int* keep) {
+  if (n <= 0) return 0;
+  const float norm = normalized ? 0.f : 1.f;
+  auto& workspace = WorkSpace::Global_Host();
+  size_t workspace_mark = workspace.cursor();
+  NmsBoxes b = alloc_boxes(&workspace, n);
+  for (int i = 0; i < n; ++i) {
+    set_box(b, i, boxes + static_cast<int64_t>(order[i]) * box_stride, norm);
+  }
+  auto* candidates = workspace.Alloc<int>(n);
+  std::memcpy(candidates, order, n * sizeof(int));
+
+  int count = 0;
+  if (!(eta < 1.f)) {
+    const int words = (round_up4(n) + 63) / 64;
+    auto* removed = workspace.Alloc<uint64_t>(words);
+    std::memset(removed, 0, words * sizeof(uint64_t));
+    for (int i = 0; i < n; ++i) {
+      if ((removed[i >> 6] >> (i & 63)) & 1) continue;
+      keep[count++] = candidates[i];
+      // The bits of the boxes up to i and after n are set too, but never read.
+      for (int j = (i + 1) & ~3; j < n; j += 4) {
+        uint64_t& word = removed[j >> 6];
+        const int shift = j & 63;
+        if (((word >> shift) & 0xf) == 0xf) continue;
+        word |= static_cast<uint64_t>(over4(b, i, b, j, nms_threshold, norm))
+                << shift;
+      }
+    }
+  } else {
+    NmsBoxes kept = alloc_boxes(&workspace, n);
+    float threshold = nms_threshold;
+    for (int i = 0; i < n; ++i) {
+      bool suppressed = false;
+      for (int j = 0; j < count && !suppressed; j += 4) {
+        // The kept boxes after count are stale, mask them out.
+        const int valid = (1 << (std::min)(4, count - j)) - 1;
+        suppressed = (over4(b, i, kept, j, threshold, norm) & valid) != 0;
+      }
+      if (suppressed) continue;
+      copy_box(b, i, kept, count);
+      keep[count++] = candidates[i];
+      if (threshold > 0.5f) threshold *= eta;
+    }
+  }
+  workspace.Rewind(workspace_mark);
+  return count;
+}
+
+void nms_iou_matrix(const float* boxes,
+                    int box_stride,
+                    const int* order,
+                    int n,
+                    bool normalized,
+                    float* iou,
+                    float* iou_max) {
+  if (n <= 0) return;
+  const float norm = normalized ? 0.f : 1.f;
+  auto& workspace = WorkSpace::Global_Host();
+  size_t workspace_mark = workspace.cursor();
+  NmsBoxes b = alloc_boxes(&workspace, n);
+  for (int i = 0; i < n; ++i) {
+    set_box(b, i, boxes + static_cast<int64_t>(order[i]) * box_stride, norm);
+  }
+  iou_max[0] = 0.f;
+  for (int i = 1; i < n; ++i) {
+    float* row = iou + static_cast<int64_t>(i) * (i - 1) / 2;
+    int j = 0;
+    for (; j + 4 <= i; j += 4) store_iou4(b, i, b, j, norm, row + j);
+    if (j < i) {
+      float tail[4];
+      store_iou4(b, i, b, j, norm, tail);
+      std::memcpy(row + j, tail, (i - j) * sizeof(float));
+    }
+    float max_iou = 0.f;
+    for (j = 0; j < i; ++j) max_iou = (std::max)(max_iou, row[j]);
+    iou_max[i] = max_iou;
+  }
+  workspace.Rewind(workspace_mark);
+}
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
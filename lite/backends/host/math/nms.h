@@ -0,0 +1,75 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+namespace paddle {
+namespace lite {
+namespace host {
+namespace math {
+
+/*
+ * The nms of axis-aligned boxes, [xmin ymin xmax ymax] each, shared by
+ * multiclass_nms, matrix_nms, the retinanet detection output and the
+ * generate_proposals.
+ *
+ * The candidates are gathered into columns of coordinates and areas in the
+ * workspace, so that the IoU of one box with 4 others is computed at once by
+ * SIMD, with the rounding of JaccardOverlap in nms_util.h.
+ */
+
+// The indices of the n scores above score_threshold by decreasing score, the
+// ties by index, at most top_k of them if top_k > -1. Returns their count.
+int nms_candidates(const float* scores,
+                   int n,
+                   float score_threshold,
+                   int top_k,
+                   int* order);
+
+/*
+ * The greedy nms of the n candidate boxes order[i], boxes + order[i] *
+ * box_stride, sorted by decreasing score: a candidate is kept unless its IoU
+ * with a kept one is above nms_threshold, which is multiplied by eta after a
+ * box is kept while it is above 0.5. The kept candidates are written to keep,
+ * which may be order, and their count is returned.
+ *
+ * Without a decay every kept box sets the bits of the candidates after it it
+ * suppresses in a bitmask, 4 at a time, so the IoU of a pair is never computed
+ * twice and the suppressed candidates are skipped. With a decay a candidate is
+ * compared to the kept boxes 4 at a time.
+ */
+int nms_boxes(const float* boxes,
+              int box_stride,
+              const int* order,
+              int n,
+              float nms_threshold,
+              float eta,
+              bool normalized,
+              int* keep);
+
+// The IoU of the boxes order[i] and order[j], j < i, of the n candidates in
+// iou[i * (i - 1) / 2 + j], and the largest of row i in iou_max[i], 0 if i is
+// 0, for the matrix nms.
+void nms_iou_matrix(const float* boxes,
+                    int box_stride,
+                    const int* order,
+                    int n,
+                    bool normalized,
+                    float* iou,
+                    float* iou_max);
+
+}  // namespace math
+}  // namespace host
+}  // namespace lite
+}  // namespace paddle
@@ -16,7 +16,9 @@
 #include <algorithm>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms.h"
 #include "lite/backends/host/math/poly_util.h"
+#include "lite/backends/host/math/topk.h"
 #include "lite/core/tensor.h"
 namespace paddle {
 namespace lite {
@@ -39,14 +41,12 @@ static void GetMaxScoreIndex(const std::vector<T>& scores,
       sorted_indices->push_back(std::make_pair(scores[i], i));
     }
   }
-  // Sort the score pair according to the scores in descending order
-  std::stable_sort(sorted_indices->begin(),
-                   sorted_indices->end(),
-                   SortScorePairDescend<int>);
-  // Keep top_k scores if needed.
-  if (top_k > -1 && top_k < static_cast<int>(sorted_indices->size())) {
-    sorted_indices->resize(top_k);
-  }
+  // Keep top_k scores if needed, sorted in descending order and the ties by
+  // index, the rest is only partitioned away.
+  int size = static_cast<int>(sorted_indices->size());
+  int k = top_k > -1 && top_k < size ? top_k : size;
+  sort_topk_pairs(sorted_indices->data(), size, k, true);
+  sorted_indices->resize(k);
 }
 
 template <typename T>
@@ -148,32 +148,19 @@ static Tensor NMS(Tensor* bbox,
   std::vector<std::pair<T, int>> sorted_indices =
       GetSortedScoreIndex<T>(scores_data);
 
-  std::vector<int> selected_indices;
-  int selected_num = 0;
-  T adaptive_threshold = nms_threshold;
-  const T* bbox_data = bbox->data<T>();
-  while (sorted_indices.size() != 0) {
-    int idx = sorted_indices.back().second;
-    bool flag = true;
-    for (int kept_idx : selected_indices) {
-      if (flag) {
-        T overlap = JaccardOverlap<T>(bbox_data + idx * box_size,
-                                      bbox_data + kept_idx * box_size,
-                                      !pixel_offset);
-        flag = (overlap <= adaptive_threshold);
-      } else {
-        break;
-      }
-    }
-    if (flag) {
-      selected_indices.push_back(idx);
-      ++selected_num;
-    }
-    sorted_indices.erase(sorted_indices.end() - 1);
-    if (flag && eta < 1 && adaptive_threshold > 0.5) {
-      adaptive_threshold *= eta;
-    }
+  // The candidates by decreasing score, the ties by decreasing index.
+  std::vector<int> selected_indices(num_boxes);
+  for (int64_t i = 0; i < num_boxes; ++i) {
+    selected_indices[i] = sorted_indices[num_boxes - 1 - i].second;
   }
+  int selected_num = nms_boxes(bbox->data<T>(),
+                               box_size,
+                               selected_indices.data(),
+                               num_boxes,
+                               nms_threshold,
+                               eta,
+                               !pixel_offset,
+                               selected_indices.data());
   return VectorToTensor(selected_indices, selected_num);
 }
 
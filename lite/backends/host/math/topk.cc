@@ -13,14 +13,187 @@
 // limitations under the License.
 
 #include "lite/backends/host/math/topk.h"
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+#include "lite/core/parallel_defines.h"
+#include "lite/core/workspace.h"
 
 namespace paddle {
 namespace lite {
 namespace host {
 namespace math {
 
-bool comp_func(std::pair<float, int> a, std::pair<float, int> b) {
-  return (a.first > b.first);
+namespace {
+
+// The least values of a task.
+const int64_t kTaskSize = 1 << 14;
+// A k of at most 1 / kHeapRatio of the row is selected by a heap.
+const int kHeapRatio = 8;
+
+int topk_threads() {
+#if defined(ARM_WITH_OMP) && !defined(LITE_USE_THREAD_POOL)
+  return omp_get_max_threads();
+#else
+  return ThreadPool::CurrentThreadNum();
+#endif
+}
+
+// Whether a ranks before b.
+template <typename T>
+struct RankBefore {
+  bool largest;
+  bool operator()(const std::pair<T, int>& a,
+                  const std::pair<T, int>& b) const {
+    if (a.first > b.first) return largest;
+    if (a.first < b.first) return !largest;
+    if (a.first == b.first) return a.second < b.second;
+    // NaN is the largest value.
+    bool a_nan = a.first != a.first;
+    bool b_nan = b.first != b.first;
+    if (a_nan != b_nan) return a_nan == largest;
+    return a.second < b.second;
+  }
+};
+
+// False if none of x[0, 8) ranks before the value t of a smaller index.
+template <typename T>
+inline bool any_before8(const T* x, T t, bool largest) {
+  return true;
+}
+
+inline bool any_before8(const float* x, float t, bool largest) {
+#if defined(__SSE__) || defined(_M_X64)
+  // The comparisons are true when either value is NaN.
+  __m128 vt = _mm_set1_ps(t);
+  __m128 x0 = _mm_loadu_ps(x);
+  __m128 x1 = _mm_loadu_ps(x + 4);
+  __m128 m = largest ? _mm_or_ps(_mm_cmpnle_ps(x0, vt), _mm_cmpnle_ps(x1, vt))
+                     : _mm_or_ps(_mm_cmpnge_ps(x0, vt), _mm_cmpnge_ps(x1, vt));
+  return _mm_movemask_ps(m) != 0;
+#elif defined(__ARM_NEON)
+  float32x4_t vt = vdupq_n_f32(t);
+  float32x4_t x0 = vld1q_f32(x);
+  float32x4_t x1 = vld1q_f32(x + 4);
+  uint32x4_t m = largest ? vandq_u32(vcleq_f32(x0, vt), vcleq_f32(x1, vt))
+                         : vandq_u32(vcgeq_f32(x0, vt), vcgeq_f32(x1, vt));
+  uint32x2_t m2 = vand_u32(vget_low_u32(m), vget_high_u32(m));
+  // m2 is all ones if no value ranks before t and neither is NaN.
+  return (vget_lane_u32(m2, 0) & vget_lane_u32(m2, 1)) != 0xffffffffu;
+#else
+  return true;
+#endif
+}
+
+// Replace the worst pair of the heap of k pairs, at its front, by p.
+template <typename T>
+void heap_replace_top(std::pair<T, int>* heap,
+                      int k,
+                      const std::pair<T, int>& p,
+                      const RankBefore<T>& before) {
+  int i = 0;
+  for (int c = 1; c < k; c = 2 * i + 1) {
+    if (c + 1 < k && before(heap[c], heap[c + 1])) ++c;
+    if (!before(p, heap[c])) break;
+    heap[i] = heap[c];
+    i = c;
+  }
+  heap[i] = p;
+}
+
+// The k best of x in pairs, best first. pairs holds k pairs.
+template <typename T>
+void select_heap(const T* x,
+                 int n,
+                 int k,
+                 const RankBefore<T>& before,
+                 std::pair<T, int>* pairs) {
+  for (int j = 0; j < k; ++j) pairs[j] = std::make_pair(x[j], j);
+  // The worst of the k is at the front.
+  std::make_heap(pairs, pairs + k, before);
+  int j = k;
+  while (j < n) {
+    if (j + 8 <= n && !any_before8(x + j, pairs[0].first, before.largest)) {
+      j += 8;
+      continue;
+    }
+    for (int end = std::min(n, j + 8); j < end; ++j) {
+      std::pair<T, int> p(x[j], j);
+      if (before(p, pairs[0])) heap_replace_top(pairs, k, p, before);
+    }
+  }
+  std::sort_heap(pairs, pairs + k, before);
+}
+
+// The k best of x in pairs, best first. pairs holds n pairs.
+template <typename T>
+void select_sort(const T* x,
+                 int n,
+                 int k,
+                 const RankBefore<T>& before,
+                 std::pair<T, int>* pairs) {
+  for (int j = 0; j < n; ++j) pairs[j] = std::make_pair(x[j], j);
+  if (k < n) std::nth_element(pairs, pairs + k - 1, pairs + n, before);
+  std::sort(pairs, pairs + k, before);
+}
+
+}  // namespace
+
+template <typename T>
+void topk_axis(const T* x,
+               int outer,
+               int n,
+               int inner,
+               int k,
+               bool largest,
+               T* out_val,
+               int64_t* out_ind) {
+  const int64_t rows = static_cast<int64_t>(outer) * inner;
+  if (rows == 0 || k <= 0) return;
+  const RankBefore<T> before{largest};
+  const bool use_heap = static_cast<int64_t>(k) * kHeapRatio <= n;
+  const int tasks = static_cast<int>(std::max<int64_t>(
+      1, std::min<int64_t>(std::min<int64_t>(topk_threads(), rows),
+                           rows * n / kTaskSize)));
+  LITE_PARALLEL_BEGIN(t, tid, tasks) {
+    auto& workspace = WorkSpace::Global_Host();
+    size_t workspace_mark = workspace.cursor();
+    T* column = inner > 1 ? workspace.Alloc<T>(n) : nullptr;
+    auto* pairs = workspace.Alloc<std::pair<T, int>>(use_heap ? k : n);
+    for (int64_t r = rows * t / tasks; r < rows * (t + 1) / tasks; ++r) {
+      const int64_t o = r / inner;
+      const int i = static_cast<int>(r % inner);
+      const T* row = x + o * n * inner + i;
+      if (inner > 1) {
+        for (int j = 0; j < n; ++j) column[j] = row[j * inner];
+        row = column;
+      }
+      if (use_heap) {
+        select_heap(row, n, k, before, pairs);
+      } else {
+        select_sort(row, n, k, before, pairs);
+      }
+      T* val = out_val + o * k * inner + i;
+      int64_t* ind = out_ind + o * k * inner + i;
+      for (int j = 0; j < k; ++j) {
+        val[j * inner] = pairs[j].first;
+        ind[j * inner] = pairs[j].second;
+      }
+    }
+    workspace.Rewind(workspace_mark);
+  }
+  LITE_PARALLEL_END();
+}
+
+template <typename T>
+void sort_topk_pairs(std::pair<T, int>* pairs, int n, int k, bool largest) {
+  k = std::min(k, n);
+  if (k <= 0) return;
+  const RankBefore<T> before{largest};
+  if (k < n) std::nth_element(pairs, pairs + k - 1, pairs + n, before);
+  std::sort(pairs, pairs + k, before);
 }
 
 void topk(const float* in_data,
@@ -29,22 +202,25 @@ void topk(const float* in_data,
           int m,
           int n,
           int k) {
-  for (int i = 0; i < m; i++) {
-    const float* in_tmp = in_data + i * n;
-    float* out_val_tmp = out_val + i * k;
-    int64_t* out_ind_tmp = out_ind + i * k;
-    std::vector<std::pair<float, int>> vec;
-    for (int j = 0; j < n; j++) {
-      vec.push_back(std::make_pair(in_tmp[j], j));
-    }
-    std::partial_sort(vec.begin(), vec.begin() + k, vec.end(), comp_func);
-    for (int q = 0; q < k; q++) {
-      out_val_tmp[q] = vec[q].first;
-      out_ind_tmp[q] = vec[q].second;
-    }
-  }
+  topk_axis(in_data, m, n, 1, k, true, out_val, out_ind);
 }
 
+#define INSTANTIATE_TOPK(T)             \
+  template void topk_axis<T>(const T*,  \
+                             int,       \
+                             int,       \
+                             int,       \
+                             int,       \
+                             bool,      \
+                             T*,        \
+                             int64_t*); \
+  template void sort_topk_pairs<T>(std::pair<T, int>*, int, int, bool)
+
+INSTANTIATE_TOPK(float);
+INSTANTIATE_TOPK(int32_t);
+INSTANTIATE_TOPK(int64_t);
+#undef INSTANTIATE_TOPK
+
 }  // namespace math
 }  // namespace host
 }  // namespace lite
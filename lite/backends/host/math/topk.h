@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #pragma once
+#include <stdint.h>
 #include <algorithm>
 #include <utility>
 #include <vector>
@@ -22,6 +23,36 @@ namespace lite {
 namespace host {
 namespace math {
 
+/*
+ * The selection of the k largest, or smallest, values of rows, shared by
+ * topk, argsort and the nms.
+ *
+ * The values are ranked by value, NaN above everything, and the ties by the
+ * smaller index, so the results do not depend on the algorithm. A small k is
+ * selected by a heap of k values, the rest of the row being compared to its
+ * worst value 8 at a time by SIMD and skipped when none of them ranks before
+ * it, a large k by nth_element, and the k selected are then sorted.
+ */
+
+// x is outer x n x inner and out_val and out_ind outer x k x inner: the k
+// best of the n values of every (outer, inner) row, best first. The rows are
+// split across the threads, the strided ones being gathered into the
+// workspace of the thread.
+template <typename T>
+void topk_axis(const T* x,
+               int outer,
+               int n,
+               int inner,
+               int k,
+               bool largest,
+               T* out_val,
+               int64_t* out_ind);
+
+// Move the k best of the n pairs of (value, index) to the front, best first.
+template <typename T>
+void sort_topk_pairs(std::pair<T, int>* pairs, int n, int k, bool largest);
+
+// The k largest of the m rows of n floats.
 void topk(
     const float* din, float* out_val, int64_t* out_ind, int m, int n, int k);
 
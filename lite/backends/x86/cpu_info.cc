@@ -25,6 +25,10 @@
 #include <unistd.h>
 #endif  // _WIN32
 
+#if defined(__linux__) && defined(__x86_64__)
+#include <sys/syscall.h>
+#endif
+
 #include <algorithm>
 #include "lite/utils/log/cp_logging.h"
 
@@ -126,6 +130,16 @@ size_t CUDAPinnedMaxChunkSize() {
   return CUDAPinnedMaxAllocSize() / 256;
 }
 
+bool RequestAmxTileData() {
+#if defined(__linux__) && defined(__x86_64__)
+  // ARCH_REQ_XCOMP_PERM for XFEATURE_XTILEDATA, Linux 5.16 and later.
+  static const bool granted = syscall(SYS_arch_prctl, 0x1023, 18) == 0;
+  return granted;
+#else
+  return false;
+#endif
+}
+
 #ifdef PADDLE_WITH_XBYAK
 static Xbyak::util::Cpu cpu;
 bool MayIUse(const cpu_isa_t cpu_isa) {
@@ -146,6 +160,11 @@ bool MayIUse(const cpu_isa_t cpu_isa) {
       return true && cpu.has(Cpu::tAVX512F) && cpu.has(Cpu::tAVX512BW) &&
              cpu.has(Cpu::tAVX512VL) && cpu.has(Cpu::tAVX512DQ) &&
              cpu.has(Cpu::tAVX512_VNNI);
+    case avx512_core_bf16:
+      return true && MayIUse(avx512_core) && cpu.has(Cpu::tAVX512_BF16);
+    case amx_bf16:
+      return true && MayIUse(avx512_core_bf16) && cpu.has(Cpu::tAMX_TILE) &&
+             cpu.has(Cpu::tAMX_BF16) && RequestAmxTileData();
     case avx512_mic:
       return true && cpu.has(Cpu::tAVX512F) && cpu.has(Cpu::tAVX512CD) &&
              cpu.has(Cpu::tAVX512ER) && cpu.has(Cpu::tAVX512PF);
@@ -68,6 +68,8 @@ typedef enum {
   avx512f,
   avx512_core,
   avx512_core_vnni,
+  avx512_core_bf16,
+  amx_bf16,
   avx512_mic,
   avx512_mic_4ops,
 } cpu_isa_t;  // Instruction set architecture
@@ -75,6 +77,10 @@ typedef enum {
 // May I use some instruction
 bool MayIUse(const cpu_isa_t cpu_isa);
 
+// Ask the OS for the AMX tile data state, which Linux grants per process.
+// MayIUse(amx_bf16) asks for it, false if it is refused.
+bool RequestAmxTileData();
+
 }  // namespace x86
 }  // namespace lite
 }  // namespace paddle
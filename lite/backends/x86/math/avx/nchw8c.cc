@@ -0,0 +1,694 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/avx/nchw8c.h"
+#include <immintrin.h>
+#include <algorithm>
+#include <cfloat>
+#include <cstring>
+#include "lite/backends/x86/math/avx/conv_utils.h"
+#include "lite/core/parallel_defines.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+const int kBlock = 8;
+
+// The output pixels of a row computed together by conv_nchw8c, the 2 x 6
+// sums, the 2 weights and the broadcast input take 15 of the 16 registers.
+const int kConvPixels = 6;
+
+// The same for the depthwise convolution.
+const int kDepthwisePixels = 4;
+
+// The activation, taken out of the params once for the inner loops.
+class ActivationM256 {
+ public:
+  explicit ActivationM256(const operators::ActivationParam& act_param) {
+    type_ = act_param.has_active ? act_param.active_type
+                                 : lite_api::ActivationType::kIndentity;
+    switch (type_) {
+      case lite_api::ActivationType::kRelu6:
+        a_ = _mm256_set1_ps(act_param.Relu_clipped_coef);
+        break;
+      case lite_api::ActivationType::kLeakyRelu:
+        a_ = _mm256_set1_ps(act_param.Leaky_relu_alpha);
+        break;
+      case lite_api::ActivationType::kHardSwish:
+        a_ = _mm256_set1_ps(act_param.hard_swish_offset);
+        b_ = _mm256_set1_ps(act_param.hard_swish_threshold);
+        c_ = _mm256_set1_ps(1.f / act_param.hard_swish_scale);
+        break;
+      default:
+        CHECK(nchw8c_activation_supported(type_))
+            << "unsupported activation on nChw8c: " << static_cast<int>(type_);
+        break;
+    }
+  }
+
+  inline __m256 operator()(__m256 x) const {
+    switch (type_) {
+      case lite_api::ActivationType::kRelu:
+        return _mm256_max_ps(x, _mm256_setzero_ps());
+      case lite_api::ActivationType::kRelu6:
+        return _mm256_min_ps(_mm256_max_ps(x, _mm256_setzero_ps()), a_);
+      case lite_api::ActivationType::kLeakyRelu:
+        return _mm256_blendv_ps(
+            _mm256_mul_ps(x, a_),
+            x,
+            _mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_GT_OS));
+      case lite_api::ActivationType::kHardSwish:
+        return _mm256_mul_ps(
+            _mm256_mul_ps(_mm256_min_ps(b_,
+                                        _mm256_max_ps(_mm256_add_ps(x, a_),
+                                                      _mm256_setzero_ps())),
+                          c_),
+            x);
+      default:
+        return x;
+    }
+  }
+
+ private:
+  lite_api::ActivationType type_;
+  __m256 a_;
+  __m256 b_;
+  __m256 c_;
+};
+
+// kOcb x kPixels output vectors of the output row, the kPixels pixels from
+// ix0, the input column of the first one, on. kCheck is for the pixels whose
+// window crosses the left or the right padding.
+template <int kOcb, int kPixels, bool kCheck>
+inline void conv_block(const float* in,
+                       int icb,
+                       int ih,
+                       int iw,
+                       int kh,
+                       int kw,
+                       int stride_w,
+                       int dilation_h,
+                       int dilation_w,
+                       int iy0,
+                       int ix0,
+                       const float* weights,
+                       int64_t weights_stride,
+                       const float* bias,
+                       const ActivationM256& act,
+                       float* out,
+                       int64_t out_stride) {
+  __m256 sum[kOcb][kPixels];
+  for (int o = 0; o < kOcb; ++o) {
+    __m256 b =
+        bias ? _mm256_loadu_ps(bias + o * kBlock) : _mm256_setzero_ps();
+    for (int p = 0; p < kPixels; ++p) {
+      sum[o][p] = b;
+    }
+  }
+  const int64_t in_stride = static_cast<int64_t>(ih) * iw * kBlock;
+  for (int cb = 0; cb < icb; ++cb) {
+    for (int ky = 0; ky < kh; ++ky) {
+      const int iy = iy0 + ky * dilation_h;
+      if (iy < 0 || iy >= ih) continue;
+      const float* row = in + cb * in_stride + iy * iw * kBlock;
+      const float* w =
+          weights + (static_cast<int64_t>(cb) * kh + ky) * kw * kBlock * kBlock;
+      for (int kx = 0; kx < kw; ++kx, w += kBlock * kBlock) {
+        const int ix = ix0 + kx * dilation_w;
+        if (kCheck && (ix < 0 || ix >= iw)) continue;
+        const float* x = row + ix * kBlock;
+        for (int l = 0; l < kBlock; ++l) {
+          __m256 w0 = _mm256_loadu_ps(w + l * kBlock);
+          __m256 w1 =
+              kOcb > 1 ? _mm256_loadu_ps(w + weights_stride + l * kBlock) : w0;
+          for (int p = 0; p < kPixels; ++p) {
+            __m256 v = _mm256_broadcast_ss(x + p * stride_w * kBlock + l);
+            sum[0][p] = _mm256_fmadd_ps(w0, v, sum[0][p]);
+            if (kOcb > 1) sum[1][p] = _mm256_fmadd_ps(w1, v, sum[1][p]);
+          }
+        }
+      }
+    }
+  }
+  for (int o = 0; o < kOcb; ++o) {
+    for (int p = 0; p < kPixels; ++p) {
+      _mm256_storeu_ps(out + o * out_stride + p * kBlock, act(sum[o][p]));
+    }
+  }
+}
+
+// The output columns [ox_begin, ox_end) whose windows are in the input.
+void inner_columns(int iw,
+                   int ow,
+                   int kw,
+                   int stride_w,
+                   int pad_left,
+                   int dilation_w,
+                   int* ox_begin,
+                   int* ox_end) {
+  *ox_begin = std::min(ow, (pad_left + stride_w - 1) / stride_w);
+  const int last = iw - 1 - (kw - 1) * dilation_w + pad_left;
+  *ox_end = last < 0 ? 0 : std::min(ow, last / stride_w + 1);
+  *ox_end = std::max(*ox_end, *ox_begin);
+}
+
+template <int kOcb>
+void conv_row(const float* in,
+              int icb,
+              int ih,
+              int iw,
+              int ow,
+              int kh,
+              int kw,
+              int stride_w,
+              int pad_left,
+              int dilation_h,
+              int dilation_w,
+              int iy0,
+              int ox_begin,
+              int ox_end,
+              const float* weights,
+              int64_t weights_stride,
+              const float* bias,
+              const ActivationM256& act,
+              float* out,
+              int64_t out_stride) {
+#define CONV_BLOCK(pixels, check)                           \
+  conv_block<kOcb, pixels, check>(in,                       \
+                                  icb,                      \
+                                  ih,                       \
+                                  iw,                       \
+                                  kh,                       \
+                                  kw,                       \
+                                  stride_w,                 \
+                                  dilation_h,               \
+                                  dilation_w,               \
+                                  iy0,                      \
+                                  ox * stride_w - pad_left, \
+                                  weights,                  \
+                                  weights_stride,           \
+                                  bias,                     \
+                                  act,                      \
+                                  out + ox * kBlock,        \
+                                  out_stride)
+  int ox = 0;
+  for (; ox < ox_begin; ++ox) {
+    CONV_BLOCK(1, true);
+  }
+  for (; ox + kConvPixels <= ox_end; ox += kConvPixels) {
+    CONV_BLOCK(kConvPixels, false);
+  }
+  for (; ox < ox_end; ++ox) {
+    CONV_BLOCK(1, false);
+  }
+  for (; ox < ow; ++ox) {
+    CONV_BLOCK(1, true);
+  }
+#undef CONV_BLOCK
+}
+
+template <int kPixels, bool kCheck>
+inline void conv_depthwise_block(const float* in,
+                                 int ih,
+                                 int iw,
+                                 int kh,
+                                 int kw,
+                                 int stride_w,
+                                 int dilation_h,
+                                 int dilation_w,
+                                 int iy0,
+                                 int ix0,
+                                 const float* weights,
+                                 __m256 bias,
+                                 const ActivationM256& act,
+                                 float* out) {
+  __m256 sum[kPixels];
+  for (int p = 0; p < kPixels; ++p) {
+    sum[p] = bias;
+  }
+  for (int ky = 0; ky < kh; ++ky) {
+    const int iy = iy0 + ky * dilation_h;
+    if (iy < 0 || iy >= ih) continue;
+    const float* row = in + iy * iw * kBlock;
+    for (int kx = 0; kx < kw; ++kx) {
+      const int ix = ix0 + kx * dilation_w;
+      if (kCheck && (ix < 0 || ix >= iw)) continue;
+      __m256 w = _mm256_loadu_ps(weights + (ky * kw + kx) * kBlock);
+      for (int p = 0; p < kPixels; ++p) {
+        sum[p] = _mm256_fmadd_ps(
+            _mm256_loadu_ps(row + (ix + p * stride_w) * kBlock), w, sum[p]);
+      }
+    }
+  }
+  for (int p = 0; p < kPixels; ++p) {
+    _mm256_storeu_ps(out + p * kBlock, act(sum[p]));
+  }
+}
+
+inline __m256 elementwise_m256(__m256 x, __m256 y, ElementwiseNchw8cType type) {
+  switch (type) {
+    case ElementwiseNchw8cType::kAdd:
+      return _mm256_add_ps(x, y);
+    case ElementwiseNchw8cType::kSub:
+      return _mm256_sub_ps(x, y);
+    default:
+      return _mm256_mul_ps(x, y);
+  }
+}
+
+}  // namespace
+
+void nchw_to_nchw8c(const float* din, float* dout, int num, int c, int hw) {
+  const int cb_num = nchw8c_channels(c) / kBlock;
+  LITE_PARALLEL_BEGIN(i, tid, num * cb_num) {
+    const int n = i / cb_num;
+    const int cb = i % cb_num;
+    const int lanes = std::min(kBlock, c - cb * kBlock);
+    const float* src = din + (static_cast<int64_t>(n) * c + cb * kBlock) * hw;
+    float* dst = dout + static_cast<int64_t>(i) * hw * kBlock;
+    int j = 0;
+    if (lanes == kBlock) {
+      for (; j + kBlock <= hw; j += kBlock) {
+        __m256 r0 = _mm256_loadu_ps(src + j);
+        __m256 r1 = _mm256_loadu_ps(src + hw + j);
+        __m256 r2 = _mm256_loadu_ps(src + 2 * hw + j);
+        __m256 r3 = _mm256_loadu_ps(src + 3 * hw + j);
+        __m256 r4 = _mm256_loadu_ps(src + 4 * hw + j);
+        __m256 r5 = _mm256_loadu_ps(src + 5 * hw + j);
+        __m256 r6 = _mm256_loadu_ps(src + 6 * hw + j);
+        __m256 r7 = _mm256_loadu_ps(src + 7 * hw + j);
+        transpose8_ps(r0, r1, r2, r3, r4, r5, r6, r7);
+        float* p = dst + j * kBlock;
+        _mm256_storeu_ps(p, r0);
+        _mm256_storeu_ps(p + 8, r1);
+        _mm256_storeu_ps(p + 16, r2);
+        _mm256_storeu_ps(p + 24, r3);
+        _mm256_storeu_ps(p + 32, r4);
+        _mm256_storeu_ps(p + 40, r5);
+        _mm256_storeu_ps(p + 48, r6);
+        _mm256_storeu_ps(p + 56, r7);
+      }
+    }
+    for (; j < hw; ++j) {
+      for (int l = 0; l < kBlock; ++l) {
+        dst[j * kBlock + l] = l < lanes ? src[l * hw + j] : 0.f;
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void nchw8c_to_nchw(const float* din, float* dout, int num, int c, int hw) {
+  const int cb_num = nchw8c_channels(c) / kBlock;
+  LITE_PARALLEL_BEGIN(i, tid, num * cb_num) {
+    const int n = i / cb_num;
+    const int cb = i % cb_num;
+    const int lanes = std::min(kBlock, c - cb * kBlock);
+    const float* src = din + static_cast<int64_t>(i) * hw * kBlock;
+    float* dst = dout + (static_cast<int64_t>(n) * c + cb * kBlock) * hw;
+    int j = 0;
+    if (lanes == kBlock) {
+      for (; j + kBlock <= hw; j += kBlock) {
+        const float* p = src + j * kBlock;
+        __m256 r0 = _mm256_loadu_ps(p);
+        __m256 r1 = _mm256_loadu_ps(p + 8);
+        __m256 r2 = _mm256_loadu_ps(p + 16);
+        __m256 r3 = _mm256_loadu_ps(p + 24);
+        __m256 r4 = _mm256_loadu_ps(p + 32);
+        __m256 r5 = _mm256_loadu_ps(p + 40);
+        __m256 r6 = _mm256_loadu_ps(p + 48);
+        __m256 r7 = _mm256_loadu_ps(p + 56);
+        transpose8_ps(r0, r1, r2, r3, r4, r5, r6, r7);
+        _mm256_storeu_ps(dst + j, r0);
+        _mm256_storeu_ps(dst + hw + j, r1);
+        _mm256_storeu_ps(dst + 2 * hw + j, r2);
+        _mm256_storeu_ps(dst + 3 * hw + j, r3);
+        _mm256_storeu_ps(dst + 4 * hw + j, r4);
+        _mm256_storeu_ps(dst + 5 * hw + j, r5);
+        _mm256_storeu_ps(dst + 6 * hw + j, r6);
+        _mm256_storeu_ps(dst + 7 * hw + j, r7);
+      }
+    }
+    for (; j < hw; ++j) {
+      for (int l = 0; l < lanes; ++l) {
+        dst[l * hw + j] = src[j * kBlock + l];
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+bool nchw8c_activation_supported(lite_api::ActivationType act_type) {
+  return act_type == lite_api::ActivationType::kIndentity ||
+         act_type == lite_api::ActivationType::kRelu ||
+         act_type == lite_api::ActivationType::kRelu6 ||
+         act_type == lite_api::ActivationType::kLeakyRelu ||
+         act_type == lite_api::ActivationType::kHardSwish;
+}
+
+int64_t conv_nchw8c_weights_size(int oc, int ic, int kh, int kw) {
+  return static_cast<int64_t>(nchw8c_channels(oc)) * nchw8c_channels(ic) *
+         kh * kw;
+}
+
+void conv_nchw8c_trans_weights(
+    const float* weights, int oc, int ic, int kh, int kw, float* dout) {
+  const int icb = nchw8c_channels(ic) / kBlock;
+  const int ks = kh * kw;
+  memset(dout, 0, sizeof(float) * conv_nchw8c_weights_size(oc, ic, kh, kw));
+  for (int o = 0; o < oc; ++o) {
+    for (int i = 0; i < ic; ++i) {
+      for (int k = 0; k < ks; ++k) {
+        const int64_t block =
+            (static_cast<int64_t>(o / kBlock) * icb + i / kBlock) * ks + k;
+        dout[(block * kBlock + i % kBlock) * kBlock + o % kBlock] =
+            weights[(static_cast<int64_t>(o) * ic + i) * ks + k];
+      }
+    }
+  }
+}
+
+void conv_depthwise_nchw8c_trans_weights(
+    const float* weights, int c, int kh, int kw, float* dout) {
+  const int ks = kh * kw;
+  memset(dout, 0, sizeof(float) * nchw8c_channels(c) * ks);
+  for (int i = 0; i < c; ++i) {
+    for (int k = 0; k < ks; ++k) {
+      dout[((i / kBlock) * ks + k) * kBlock + i % kBlock] = weights[i * ks + k];
+    }
+  }
+}
+
+void conv_nchw8c(const float* din,
+                 float* dout,
+                 int num,
+                 int ic,
+                 int ih,
+                 int iw,
+                 int oc,
+                 int oh,
+                 int ow,
+                 int kh,
+                 int kw,
+                 int stride_h,
+                 int stride_w,
+                 int pad_top,
+                 int pad_left,
+                 int dilation_h,
+                 int dilation_w,
+                 const float* trans_weights,
+                 const float* bias,
+                 const operators::ActivationParam& act_param) {
+  const ActivationM256 act(act_param);
+  const int icb = nchw8c_channels(ic) / kBlock;
+  const int ocb = nchw8c_channels(oc) / kBlock;
+  // The output channel blocks go in pairs, every input vector feeding two
+  // fmas.
+  const int pairs = (ocb + 1) / 2;
+  const int64_t in_size = static_cast<int64_t>(icb) * ih * iw * kBlock;
+  const int64_t out_stride = static_cast<int64_t>(oh) * ow * kBlock;
+  const int64_t weights_stride =
+      static_cast<int64_t>(icb) * kh * kw * kBlock * kBlock;
+  int ox_begin = 0;
+  int ox_end = 0;
+  inner_columns(
+      iw, ow, kw, stride_w, pad_left, dilation_w, &ox_begin, &ox_end);
+
+  LITE_PARALLEL_BEGIN(i, tid, num * pairs * oh) {
+    const int n = i / (pairs * oh);
+    const int cb = (i / oh) % pairs * 2;
+    const int oy = i % oh;
+    const float* in = din + n * in_size;
+    float* out = dout + (static_cast<int64_t>(n) * ocb + cb) * out_stride +
+                 oy * ow * kBlock;
+    const float* weights = trans_weights + cb * weights_stride;
+    const float* b = bias ? bias + cb * kBlock : nullptr;
+    const int iy0 = oy * stride_h - pad_top;
+    if (cb + 1 < ocb) {
+      conv_row<2>(in,
+                  icb,
+                  ih,
+                  iw,
+                  ow,
+                  kh,
+                  kw,
+                  stride_w,
+                  pad_left,
+                  dilation_h,
+                  dilation_w,
+                  iy0,
+                  ox_begin,
+                  ox_end,
+                  weights,
+                  weights_stride,
+                  b,
+                  act,
+                  out,
+                  out_stride);
+    } else {
+      conv_row<1>(in,
+                  icb,
+                  ih,
+                  iw,
+                  ow,
+                  kh,
+                  kw,
+                  stride_w,
+                  pad_left,
+                  dilation_h,
+                  dilation_w,
+                  iy0,
+                  ox_begin,
+                  ox_end,
+                  weights,
+                  weights_stride,
+                  b,
+                  act,
+                  out,
+                  out_stride);
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void conv_depthwise_nchw8c(const float* din,
+                           float* dout,
+                           int num,
+                           int c,
+                           int ih,
+                           int iw,
+                           int oh,
+                           int ow,
+                           int kh,
+                           int kw,
+                           int stride_h,
+                           int stride_w,
+                           int pad_top,
+                           int pad_left,
+                           int dilation_h,
+                           int dilation_w,
+                           const float* trans_weights,
+                           const float* bias,
+                           const operators::ActivationParam& act_param) {
+  const ActivationM256 act(act_param);
+  const int cb_num = nchw8c_channels(c) / kBlock;
+  const int64_t in_stride = static_cast<int64_t>(ih) * iw * kBlock;
+  const int64_t out_stride = static_cast<int64_t>(oh) * ow * kBlock;
+  int ox_begin = 0;
+  int ox_end = 0;
+  inner_columns(
+      iw, ow, kw, stride_w, pad_left, dilation_w, &ox_begin, &ox_end);
+
+  LITE_PARALLEL_BEGIN(i, tid, num * cb_num * oh) {
+    const int plane = i / oh;
+    const int cb = plane % cb_num;
+    const int oy = i % oh;
+    const float* in = din + plane * in_stride;
+    float* out = dout + plane * out_stride + oy * ow * kBlock;
+    const float* weights = trans_weights + cb * kh * kw * kBlock;
+    __m256 b = bias ? _mm256_loadu_ps(bias + cb * kBlock) : _mm256_setzero_ps();
+    const int iy0 = oy * stride_h - pad_top;
+#define CONV_DEPTHWISE_BLOCK(pixels, check)                     \
+  conv_depthwise_block<pixels, check>(in,                       \
+                                      ih,                       \
+                                      iw,                       \
+                                      kh,                       \
+                                      kw,                       \
+                                      stride_w,                 \
+                                      dilation_h,               \
+                                      dilation_w,               \
+                                      iy0,                      \
+                                      ox * stride_w - pad_left, \
+                                      weights,                  \
+                                      b,                        \
+                                      act,                      \
+                                      out + ox * kBlock)
+    int ox = 0;
+    for (; ox < ox_begin; ++ox) {
+      CONV_DEPTHWISE_BLOCK(1, true);
+    }
+    for (; ox + kDepthwisePixels <= ox_end; ox += kDepthwisePixels) {
+      CONV_DEPTHWISE_BLOCK(kDepthwisePixels, false);
+    }
+    for (; ox < ox_end; ++ox) {
+      CONV_DEPTHWISE_BLOCK(1, false);
+    }
+    for (; ox < ow; ++ox) {
+      CONV_DEPTHWISE_BLOCK(1, true);
+    }
+#undef CONV_DEPTHWISE_BLOCK
+  }
+  LITE_PARALLEL_END();
+}
+
+void pool_nchw8c(const float* din,
+                 float* dout,
+                 int num,
+                 int c,
+                 int ih,
+                 int iw,
+                 int oh,
+                 int ow,
+                 int kh,
+                 int kw,
+                 int stride_h,
+                 int stride_w,
+                 int pad_top,
+                 int pad_left,
+                 bool is_max,
+                 bool exclusive) {
+  const int cb_num = nchw8c_channels(c) / kBlock;
+  const int64_t in_stride = static_cast<int64_t>(ih) * iw * kBlock;
+  const int64_t out_stride = static_cast<int64_t>(oh) * ow * kBlock;
+
+  LITE_PARALLEL_BEGIN(i, tid, num * cb_num * oh) {
+    const int plane = i / oh;
+    const int oy = i % oh;
+    const float* in = din + plane * in_stride;
+    float* out = dout + plane * out_stride + oy * ow * kBlock;
+    int y0 = oy * stride_h - pad_top;
+    int y1 = std::min(y0 + kh, ih + pad_top);
+    const int h_size = y1 - y0;
+    y0 = std::max(y0, 0);
+    y1 = std::min(y1, ih);
+    for (int ox = 0; ox < ow; ++ox) {
+      int x0 = ox * stride_w - pad_left;
+      int x1 = std::min(x0 + kw, iw + pad_left);
+      const int w_size = x1 - x0;
+      x0 = std::max(x0, 0);
+      x1 = std::min(x1, iw);
+      __m256 v = is_max ? _mm256_set1_ps(-FLT_MAX) : _mm256_setzero_ps();
+      for (int y = y0; y < y1; ++y) {
+        const float* row = in + y * iw * kBlock;
+        for (int x = x0; x < x1; ++x) {
+          __m256 r = _mm256_loadu_ps(row + x * kBlock);
+          v = is_max ? _mm256_max_ps(v, r) : _mm256_add_ps(v, r);
+        }
+      }
+      if (!is_max) {
+        const int size = exclusive ? (y1 - y0) * (x1 - x0) : h_size * w_size;
+        v = _mm256_mul_ps(v, _mm256_set1_ps(1.f / size));
+      }
+      _mm256_storeu_ps(out + ox * kBlock, v);
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void scale_bias_nchw8c(const float* din,
+                       float* dout,
+                       int num,
+                       int c,
+                       int hw,
+                       const float* scale,
+                       const float* bias,
+                       const operators::ActivationParam& act_param) {
+  const ActivationM256 act(act_param);
+  const int cb_num = nchw8c_channels(c) / kBlock;
+  LITE_PARALLEL_BEGIN(i, tid, num * cb_num) {
+    const int cb = i % cb_num;
+    const float* in = din + static_cast<int64_t>(i) * hw * kBlock;
+    float* out = dout + static_cast<int64_t>(i) * hw * kBlock;
+    __m256 s = _mm256_loadu_ps(scale + cb * kBlock);
+    __m256 b = _mm256_loadu_ps(bias + cb * kBlock);
+    for (int j = 0; j < hw; ++j) {
+      _mm256_storeu_ps(
+          out + j * kBlock,
+          act(_mm256_fmadd_ps(_mm256_loadu_ps(in + j * kBlock), s, b)));
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void elementwise_nchw8c(const float* x,
+                        const float* y,
+                        float* dout,
+                        int num,
+                        int c,
+                        int hw,
+                        bool y_broadcast,
+                        ElementwiseNchw8cType type,
+                        const operators::ActivationParam& act_param) {
+  const ActivationM256 act(act_param);
+  const int cb_num = nchw8c_channels(c) / kBlock;
+  LITE_PARALLEL_BEGIN(i, tid, num * cb_num) {
+    const int64_t offset = static_cast<int64_t>(i) * hw * kBlock;
+    const float* in = x + offset;
+    float* out = dout + offset;
+    if (y_broadcast) {
+      __m256 v = _mm256_loadu_ps(y + i * kBlock);
+      for (int j = 0; j < hw; ++j) {
+        _mm256_storeu_ps(
+            out + j * kBlock,
+            act(elementwise_m256(_mm256_loadu_ps(in + j * kBlock), v, type)));
+      }
+    } else {
+      const float* in_y = y + offset;
+      for (int j = 0; j < hw; ++j) {
+        __m256 v = elementwise_m256(_mm256_loadu_ps(in + j * kBlock),
+                                    _mm256_loadu_ps(in_y + j * kBlock),
+                                    type);
+        _mm256_storeu_ps(out + j * kBlock, act(v));
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void activation_nchw8c(const float* din,
+                       float* dout,
+                       int64_t size,
+                       const operators::ActivationParam& act_param) {
+  const ActivationM256 act(act_param);
+  // Chunks of 16 KB.
+  const int64_t chunk = 4096;
+  const int chunks = static_cast<int>((size + chunk - 1) / chunk);
+  LITE_PARALLEL_BEGIN(i, tid, chunks) {
+    const int64_t begin = i * chunk;
+    const int64_t end = std::min(size, begin + chunk);
+    for (int64_t j = begin; j < end; j += kBlock) {
+      _mm256_storeu_ps(dout + j, act(_mm256_loadu_ps(din + j)));
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,164 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * The kernels on the images blocked by 8 channels, nChw8c.
+ *
+ * A num x c x h x w image is stored as num x (c / 8) x h x w x 8 floats, the
+ * channels being padded to a multiple of 8 by zeros, so that the 8 channels
+ * of a pixel are one __m256. The padding channels stay finite through all
+ * the kernels: the convolutions and the batch norm keep them zeros, and the
+ * activations supported, relu, relu6, leaky_relu and hard_swish, map zeros
+ * to zeros.
+ */
+
+// The channels of c once padded to a multiple of 8.
+inline int nchw8c_channels(int c) { return (c + 7) / 8 * 8; }
+
+// The floats of the nChw8c image of the NCHW dims.
+inline int64_t nchw8c_size(const DDim& dims) {
+  CHECK_EQ(dims.size(), 4u) << "nChw8c is only for 4-D tensors";
+  return dims[0] * nchw8c_channels(dims[1]) * dims[2] * dims[3];
+}
+
+// din is num x c x hw, dout is num x (c / 8) x hw x 8.
+void nchw_to_nchw8c(const float* din, float* dout, int num, int c, int hw);
+
+// din is num x (c / 8) x hw x 8, dout is num x c x hw.
+void nchw8c_to_nchw(const float* din, float* dout, int num, int c, int hw);
+
+// Whether the activation of the convolutions, the elementwise and the
+// activation kernels is supported on nChw8c.
+bool nchw8c_activation_supported(lite_api::ActivationType act_type);
+
+// The number of floats of the weights of conv_nchw8c.
+int64_t conv_nchw8c_weights_size(int oc, int ic, int kh, int kw);
+
+// Transform the oc x ic x kh x kw weights into (oc / 8) x (ic / 8) x kh x kw
+// x 8 x 8, the input channel first.
+void conv_nchw8c_trans_weights(
+    const float* weights, int oc, int ic, int kh, int kw, float* dout);
+
+// The same for the c x 1 x kh x kw weights of the depthwise convolution,
+// into (c / 8) x kh x kw x 8.
+void conv_depthwise_nchw8c_trans_weights(
+    const float* weights, int c, int kh, int kw, float* dout);
+
+// dout = act(conv(din, weights) + bias), bias is null or of nchw8c_channels
+// (oc) floats, zeros past oc.
+void conv_nchw8c(const float* din,
+                 float* dout,
+                 int num,
+                 int ic,
+                 int ih,
+                 int iw,
+                 int oc,
+                 int oh,
+                 int ow,
+                 int kh,
+                 int kw,
+                 int stride_h,
+                 int stride_w,
+                 int pad_top,
+                 int pad_left,
+                 int dilation_h,
+                 int dilation_w,
+                 const float* trans_weights,
+                 const float* bias,
+                 const operators::ActivationParam& act_param);
+
+// The same for the depthwise convolution of c channels.
+void conv_depthwise_nchw8c(const float* din,
+                           float* dout,
+                           int num,
+                           int c,
+                           int ih,
+                           int iw,
+                           int oh,
+                           int ow,
+                           int kh,
+                           int kw,
+                           int stride_h,
+                           int stride_w,
+                           int pad_top,
+                           int pad_left,
+                           int dilation_h,
+                           int dilation_w,
+                           const float* trans_weights,
+                           const float* bias,
+                           const operators::ActivationParam& act_param);
+
+// The max or the average pooling, the windows being cut as the NCHW
+// Pool2dFunctor does.
+void pool_nchw8c(const float* din,
+                 float* dout,
+                 int num,
+                 int c,
+                 int ih,
+                 int iw,
+                 int oh,
+                 int ow,
+                 int kh,
+                 int kw,
+                 int stride_h,
+                 int stride_w,
+                 int pad_top,
+                 int pad_left,
+                 bool is_max,
+                 bool exclusive);
+
+// dout = act(din * scale + bias) of the per channel scale and bias, both of
+// nchw8c_channels(c) floats, zeros past c.
+void scale_bias_nchw8c(const float* din,
+                       float* dout,
+                       int num,
+                       int c,
+                       int hw,
+                       const float* scale,
+                       const float* bias,
+                       const operators::ActivationParam& act_param);
+
+enum class ElementwiseNchw8cType { kAdd, kSub, kMul };
+
+// dout = act(x op y), y is of the same dims as x or of num x c x 1 x 1.
+void elementwise_nchw8c(const float* x,
+                        const float* y,
+                        float* dout,
+                        int num,
+                        int c,
+                        int hw,
+                        bool y_broadcast,
+                        ElementwiseNchw8cType type,
+                        const operators::ActivationParam& act_param);
+
+// dout = act(din) on the size floats.
+void activation_nchw8c(const float* din,
+                       float* dout,
+                       int64_t size,
+                       const operators::ActivationParam& act_param);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -15,7 +15,9 @@
 #include <cmath>
 #include <limits>
 #include <vector>
+#include "lite/backends/x86/math/gemm_fp32_compute.h"
 #include "lite/backends/x86/math/math_function.h"
+#include "lite/core/workspace.h"
 
 namespace paddle {
 namespace lite {
@@ -245,9 +247,94 @@ struct CBlas<double> {
 
 template <>
 struct CBlas<float> {
-  template <typename... ARGS>
-  static void GEMM(ARGS... args) {
-    cblas_sgemm(args...);
+  // The native sgemm runs the row major gemms on the cpus with AVX2.
+  static void GEMM(CBLAS_ORDER order,
+                   CBLAS_TRANSPOSE transA,
+                   CBLAS_TRANSPOSE transB,
+                   int M,
+                   int N,
+                   int K,
+                   float alpha,
+                   const float *A,
+                   int lda,
+                   const float *B,
+                   int ldb,
+                   float beta,
+                   float *C,
+                   int ldc) {
+    if (order == CblasRowMajor && gemm_fp32_available()) {
+      gemm_fp32(transA != CblasNoTrans,
+                transB != CblasNoTrans,
+                M,
+                N,
+                K,
+                alpha,
+                A,
+                lda,
+                B,
+                ldb,
+                beta,
+                C,
+                ldc);
+      return;
+    }
+    cblas_sgemm(
+        order, transA, transB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+  }
+
+  static void GEMM_STRIDED_BATCH(CBLAS_TRANSPOSE transA,
+                                 CBLAS_TRANSPOSE transB,
+                                 int M,
+                                 int N,
+                                 int K,
+                                 float alpha,
+                                 const float *A,
+                                 int lda,
+                                 int64_t strideA,
+                                 const float *B,
+                                 int ldb,
+                                 int64_t strideB,
+                                 float beta,
+                                 float *C,
+                                 int ldc,
+                                 int64_t strideC,
+                                 int batchCount) {
+    if (gemm_fp32_available()) {
+      gemm_fp32_batch(transA != CblasNoTrans,
+                      transB != CblasNoTrans,
+                      M,
+                      N,
+                      K,
+                      alpha,
+                      A,
+                      lda,
+                      strideA,
+                      B,
+                      ldb,
+                      strideB,
+                      beta,
+                      C,
+                      ldc,
+                      strideC,
+                      batchCount);
+      return;
+    }
+    for (int k = 0; k < batchCount; ++k) {
+      cblas_sgemm(CblasRowMajor,
+                  transA,
+                  transB,
+                  M,
+                  N,
+                  K,
+                  alpha,
+                  A + k * strideA,
+                  lda,
+                  B + k * strideB,
+                  ldb,
+                  beta,
+                  C + k * strideC,
+                  ldc);
+    }
   }
 
   template <typename... ARGS>
@@ -273,6 +360,41 @@ struct CBlas<double> {
     cblas_dgemm(args...);
   }
 
+  static void GEMM_STRIDED_BATCH(CBLAS_TRANSPOSE transA,
+                                 CBLAS_TRANSPOSE transB,
+                                 int M,
+                                 int N,
+                                 int K,
+                                 double alpha,
+                                 const double *A,
+                                 int lda,
+                                 int64_t strideA,
+                                 const double *B,
+                                 int ldb,
+                                 int64_t strideB,
+                                 double beta,
+                                 double *C,
+                                 int ldc,
+                                 int64_t strideC,
+                                 int batchCount) {
+    for (int k = 0; k < batchCount; ++k) {
+      cblas_dgemm(CblasRowMajor,
+                  transA,
+                  transB,
+                  M,
+                  N,
+                  K,
+                  alpha,
+                  A + k * strideA,
+                  lda,
+                  B + k * strideB,
+                  ldb,
+                  beta,
+                  C + k * strideC,
+                  ldc);
+    }
+  }
+
   template <typename... ARGS>
   static void AXPY(ARGS... args) {
     cblas_daxpy(args...);
@@ -309,6 +431,10 @@ struct CBlas<lite::fluid::float16> {
   static void GEMM_BATCH(...) {
     LOG(FATAL) << "float16 GEMM_BATCH not supported on CPU";
   }
+#else
+  static void GEMM_STRIDED_BATCH(...) {
+    LOG(FATAL) << "float16 GEMM_STRIDED_BATCH not supported on CPU";
+  }
 #endif
 };
 
@@ -649,9 +775,11 @@ void Blas<lite::TargetType::kX86>::BatchedGEMM(CBLAS_TRANSPOSE transA,
   int lda = (transA == CblasNoTrans) ? K : M;
   int ldb = (transB == CblasNoTrans) ? N : K;
   int ldc = N;
-  auto a_array = std::vector<const T *>(batchCount);
-  auto b_array = std::vector<const T *>(batchCount);
-  auto c_array = std::vector<T *>(batchCount);
+  auto &workspace = WorkSpace::Global_X86();
+  size_t workspace_mark = workspace.cursor();
+  auto a_array = workspace.Alloc<const T *>(batchCount);
+  auto b_array = workspace.Alloc<const T *>(batchCount);
+  auto c_array = workspace.Alloc<T *>(batchCount);
   for (int k = 0; k < batchCount; ++k) {
     a_array[k] = &A[k * strideA];
     b_array[k] = &B[k * strideB];
@@ -665,22 +793,37 @@ void Blas<lite::TargetType::kX86>::BatchedGEMM(CBLAS_TRANSPOSE transA,
                        &N,
                        &K,
                        &alpha,
-                       a_array.data(),
+                       a_array,
                        &lda,
-                       b_array.data(),
+                       b_array,
                        &ldb,
                        &beta,
-                       c_array.data(),
+                       c_array,
                        &ldc,
                        1 /* group_count */,
                        &batchCount);
+  workspace.Rewind(workspace_mark);
 #else
-  for (int k = 0; k < batchCount; ++k) {
-    auto *Ak = &A[k * strideA];
-    auto *Bk = &B[k * strideB];
-    auto *Ck = &C[k * M * N];
-    this->template GEMM<T>(transA, transB, M, N, K, alpha, Ak, Bk, beta, Ck);
-  }
+  int lda = (transA == CblasNoTrans) ? K : M;
+  int ldb = (transB == CblasNoTrans) ? N : K;
+  int ldc = N;
+  CBlas<T>::GEMM_STRIDED_BATCH(transA,
+                               transB,
+                               M,
+                               N,
+                               K,
+                               alpha,
+                               A,
+                               lda,
+                               strideA,
+                               B,
+                               ldb,
+                               strideB,
+                               beta,
+                               C,
+                               ldc,
+                               static_cast<int64_t>(M) * N,
+                               batchCount);
 #endif
 }
 
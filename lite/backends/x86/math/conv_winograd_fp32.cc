@@ -0,0 +1,600 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "lite/backends/x86/math/conv_winograd_fp32.h"
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "lite/backends/x86/math/gemm_fp32_compute.h"
+#include "lite/core/parallel_defines.h"
+#include "lite/core/workspace.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The channels transformed at a time, an element of the transforms below is
+// kLanes floats, `stride` floats apart from the next one.
+const int kLanes = 8;
+
+// The blocks of tiles are cut so that their V and M fit in this many bytes.
+const int kTileBlockBytes = 1 << 20;
+
+// The floats added to the distance of the matrices of V and M.
+const int kSkew = 16;
+
+inline int div_up(int a, int b) { return (a + b - 1) / b; }
+
+// F(4x4, 3x3), the points are 0, 1, -1, 2, -2 and infinity.
+struct WinogradF4 {
+  static const int kOut = 4;
+  static const int kAlpha = 6;
+  static const float kG[kAlpha][3];
+
+  // r = B^T d
+  static inline void input(const float* d, int ds, float* r, int rs) {
+    for (int c = 0; c < kLanes; ++c) {
+      const float d0 = d[c];
+      const float d1 = d[ds + c];
+      const float d2 = d[2 * ds + c];
+      const float d3 = d[3 * ds + c];
+      const float d4 = d[4 * ds + c];
+      const float d5 = d[5 * ds + c];
+      const float t1 = d4 - 4.f * d2;
+      const float t2 = d3 - 4.f * d1;
+      const float t3 = d4 - d2;
+      const float t4 = 2.f * (d3 - d1);
+      r[c] = 4.f * d0 - 5.f * d2 + d4;
+      r[rs + c] = t1 + t2;
+      r[2 * rs + c] = t1 - t2;
+      r[3 * rs + c] = t3 + t4;
+      r[4 * rs + c] = t3 - t4;
+      r[5 * rs + c] = 4.f * d1 - 5.f * d3 + d5;
+    }
+  }
+
+  // y = A^T m
+  static inline void output(const float* m, int ms, float* y, int ys) {
+    for (int c = 0; c < kLanes; ++c) {
+      const float t1 = m[ms + c] + m[2 * ms + c];
+      const float t2 = m[ms + c] - m[2 * ms + c];
+      const float t3 = m[3 * ms + c] + m[4 * ms + c];
+      const float t4 = m[3 * ms + c] - m[4 * ms + c];
+      y[c] = m[c] + t1 + t3;
+      y[ys + c] = t2 + 2.f * t4;
+      y[2 * ys + c] = t1 + 4.f * t3;
+      y[3 * ys + c] = t2 + 8.f * t4 + m[5 * ms + c];
+    }
+  }
+};
+
+const float WinogradF4::kG[6][3] = {{1.f / 4, 0.f, 0.f},
+                                    {-1.f / 6, -1.f / 6, -1.f / 6},
+                                    {-1.f / 6, 1.f / 6, -1.f / 6},
+                                    {1.f / 24, 1.f / 12, 1.f / 6},
+                                    {1.f / 24, -1.f / 12, 1.f / 6},
+                                    {0.f, 0.f, 1.f}};
+
+// F(6x6, 3x3), the points are 0, 1, -1, 2, -2, 1/2, -1/2 and infinity.
+struct WinogradF6 {
+  static const int kOut = 6;
+  static const int kAlpha = 8;
+  static const float kG[kAlpha][3];
+
+  static inline void input(const float* d, int ds, float* r, int rs) {
+    for (int c = 0; c < kLanes; ++c) {
+      const float d0 = d[c];
+      const float d1 = d[ds + c];
+      const float d2 = d[2 * ds + c];
+      const float d3 = d[3 * ds + c];
+      const float d4 = d[4 * ds + c];
+      const float d5 = d[5 * ds + c];
+      const float d6 = d[6 * ds + c];
+      const float d7 = d[7 * ds + c];
+      r[c] = d0 - d6 + 5.25f * (d4 - d2);
+      r[7 * rs + c] = d7 - d1 + 5.25f * (d3 - d5);
+      float t1 = d2 + d6 - 4.25f * d4;
+      float t2 = d1 + d5 - 4.25f * d3;
+      r[rs + c] = t1 + t2;
+      r[2 * rs + c] = t1 - t2;
+      t1 = 0.25f * d2 + d6 - 1.25f * d4;
+      t2 = 0.5f * d1 - 2.5f * d3 + 2.f * d5;
+      r[3 * rs + c] = t1 + t2;
+      r[4 * rs + c] = t1 - t2;
+      t1 = 4.f * d2 + d6 - 5.f * d4;
+      t2 = 2.f * d1 - 2.5f * d3 + 0.5f * d5;
+      r[5 * rs + c] = t1 + t2;
+      r[6 * rs + c] = t1 - t2;
+    }
+  }
+
+  static inline void output(const float* m, int ms, float* y, int ys) {
+    for (int c = 0; c < kLanes; ++c) {
+      const float t1 = m[ms + c] + m[2 * ms + c];
+      const float t2 = m[ms + c] - m[2 * ms + c];
+      const float t3 = m[3 * ms + c] + m[4 * ms + c];
+      const float t4 = m[3 * ms + c] - m[4 * ms + c];
+      const float t5 = m[5 * ms + c] + m[6 * ms + c];
+      const float t6 = m[5 * ms + c] - m[6 * ms + c];
+      y[c] = m[c] + t1 + t3 + t5;
+      y[ys + c] = t2 + 2.f * t4 + 0.5f * t6;
+      y[2 * ys + c] = t1 + 4.f * t3 + 0.25f * t5;
+      y[3 * ys + c] = t2 + 8.f * t4 + 0.125f * t6;
+      y[4 * ys + c] = t1 + 16.f * t3 + 0.0625f * t5;
+      y[5 * ys + c] = t2 + 32.f * t4 + 0.03125f * t6 + m[7 * ms + c];
+    }
+  }
+};
+
+const float WinogradF6::kG[8][3] = {{1.f, 0.f, 0.f},
+                                    {-2.f / 9, -2.f / 9, -2.f / 9},
+                                    {-2.f / 9, 2.f / 9, -2.f / 9},
+                                    {1.f / 90, 1.f / 45, 2.f / 45},
+                                    {1.f / 90, -1.f / 45, 2.f / 45},
+                                    {32.f / 45, 16.f / 45, 8.f / 45},
+                                    {32.f / 45, -16.f / 45, 8.f / 45},
+                                    {0.f, 0.f, 1.f}};
+
+// The number of tiles transformed and multiplied at a time.
+int winograd_tile_block(int alpha, int icp, int ocp, int tiles) {
+  const int tile_bytes = alpha * alpha * (icp + ocp) * sizeof(float);
+  // At least a few row panels of the gemm micro-kernels.
+  const int block = std::max(kTileBlockBytes / tile_bytes / 12 * 12, 24);
+  return std::min(block, tiles);
+}
+
+template <typename F>
+void trans_weights_impl(const float* weights,
+                        int ic,
+                        int oc,
+                        float* trans_weights) {
+  const int alpha = F::kAlpha;
+  // U[e] is ic x oc, e being the element of the alpha x alpha tile.
+  std::vector<float> u(static_cast<size_t>(alpha) * alpha * ic * oc);
+  for (int o = 0; o < oc; ++o) {
+    for (int i = 0; i < ic; ++i) {
+      const float* g = weights + (o * ic + i) * 9;
+      float tmp[alpha][3];
+      for (int r = 0; r < alpha; ++r) {
+        for (int c = 0; c < 3; ++c) {
+          tmp[r][c] = F::kG[r][0] * g[c] + F::kG[r][1] * g[3 + c] +
+                      F::kG[r][2] * g[6 + c];
+        }
+      }
+      for (int r = 0; r < alpha; ++r) {
+        for (int c = 0; c < alpha; ++c) {
+          u[(static_cast<size_t>(r * alpha + c) * ic + i) * oc + o] =
+              tmp[r][0] * F::kG[c][0] + tmp[r][1] * F::kG[c][1] +
+              tmp[r][2] * F::kG[c][2];
+        }
+      }
+    }
+  }
+  const int64_t packed_size = gemm_fp32_packed_B_size(oc, ic);
+  for (int e = 0; e < alpha * alpha; ++e) {
+    gemm_fp32_prepack_B(false,
+                        oc,
+                        ic,
+                        u.data() + static_cast<size_t>(e) * ic * oc,
+                        oc,
+                        trans_weights + e * packed_size);
+  }
+}
+
+// Copy the channels [c0, c0 + kLanes) of the image into a block of hp x wp
+// x kLanes floats, shifted by the padding and surrounded by zeros.
+void pack_input(const float* din,
+                int ic,
+                int ih,
+                int iw,
+                int c0,
+                int pad_top,
+                int pad_left,
+                int hp,
+                int wp,
+                float* dst) {
+  memset(dst, 0, sizeof(float) * hp * wp * kLanes);
+  const int lanes = std::min(kLanes, ic - c0);
+  const int y0 = std::max(0, -pad_top);
+  const int y1 = std::min(ih, hp - pad_top);
+  const int x0 = std::max(0, -pad_left);
+  const int x1 = std::min(iw, wp - pad_left);
+  for (int y = y0; y < y1; ++y) {
+    float* row = dst + ((y + pad_top) * wp + pad_left) * kLanes;
+    for (int c = 0; c < lanes; ++c) {
+      const float* src = din + ((c0 + c) * ih + y) * iw;
+      for (int x = x0; x < x1; ++x) {
+        row[x * kLanes + c] = src[x];
+      }
+    }
+  }
+}
+
+// The same for the image blocked by kLanes channels.
+void pack_input_nchw8c(const float* din,
+                       int ih,
+                       int iw,
+                       int cb,
+                       int pad_top,
+                       int pad_left,
+                       int hp,
+                       int wp,
+                       float* dst) {
+  memset(dst, 0, sizeof(float) * hp * wp * kLanes);
+  const int y0 = std::max(0, -pad_top);
+  const int y1 = std::min(ih, hp - pad_top);
+  const int x0 = std::max(0, -pad_left);
+  const int x1 = std::min(iw, wp - pad_left);
+  if (x1 <= x0) return;
+  for (int y = y0; y < y1; ++y) {
+    const float* src =
+        din + ((static_cast<int64_t>(cb) * ih + y) * iw + x0) * kLanes;
+    memcpy(dst + ((y + pad_top) * wp + pad_left + x0) * kLanes,
+           src,
+           sizeof(float) * (x1 - x0) * kLanes);
+  }
+}
+
+// Store the rows x cols corner of the m x m tile y of the channels [cb *
+// kLanes, cb * kLanes + lanes) at (y0, x0) of the image, plus the bias.
+void store_tile(const float* y,
+                int m,
+                int rows,
+                int cols,
+                int lanes,
+                int oh,
+                int ow,
+                int cb,
+                int y0,
+                int x0,
+                const float* bias,
+                float* dout) {
+  for (int c = 0; c < lanes; ++c) {
+    const int o = cb * kLanes + c;
+    const float b = bias ? bias[o] : 0.f;
+    float* dst = dout + (static_cast<int64_t>(o) * oh + y0) * ow + x0;
+    for (int r = 0; r < rows; ++r) {
+      for (int s = 0; s < cols; ++s) {
+        dst[r * ow + s] = y[(r * m + s) * kLanes + c] + b;
+      }
+    }
+  }
+}
+
+// The same for the image blocked by kLanes channels, whose padding channels
+// are kept zeros.
+void store_tile_nchw8c(const float* y,
+                       int m,
+                       int rows,
+                       int cols,
+                       int lanes,
+                       int oh,
+                       int ow,
+                       int cb,
+                       int y0,
+                       int x0,
+                       const float* bias,
+                       float* dout) {
+  float b[kLanes] = {0.f};
+  for (int c = 0; c < lanes && bias; ++c) {
+    b[c] = bias[cb * kLanes + c];
+  }
+  for (int r = 0; r < rows; ++r) {
+    float* dst =
+        dout + ((static_cast<int64_t>(cb) * oh + y0 + r) * ow + x0) * kLanes;
+    for (int s = 0; s < cols; ++s) {
+      for (int c = 0; c < kLanes; ++c) {
+        dst[s * kLanes + c] =
+            c < lanes ? y[(r * m + s) * kLanes + c] + b[c] : 0.f;
+      }
+    }
+  }
+}
+
+template <typename F>
+void conv_winograd_impl(bool nchw8c,
+                        const float* din,
+                        float* dout,
+                        int num,
+                        int ic,
+                        int ih,
+                        int iw,
+                        int oc,
+                        int oh,
+                        int ow,
+                        int pad_top,
+                        int pad_left,
+                        const float* trans_weights,
+                        const float* bias) {
+  const int m = F::kOut;
+  const int alpha = F::kAlpha;
+  const int tiles_h = div_up(oh, m);
+  const int tiles_w = div_up(ow, m);
+  const int tiles = tiles_h * tiles_w;
+  const int hp = tiles_h * m + 2;
+  const int wp = tiles_w * m + 2;
+  const int icb = div_up(ic, kLanes);
+  const int ocb = div_up(oc, kLanes);
+  const int icp = icb * kLanes;
+  const int ocp = ocb * kLanes;
+  const int block = winograd_tile_block(alpha, icp, ocp, tiles);
+  const int64_t packed_size = gemm_fp32_packed_B_size(oc, ic);
+  // The elements of a tile are written and read together, their matrices
+  // are kept off the multiples of 4 KB apart which share the cache sets.
+  const int64_t stride_V = static_cast<int64_t>(block) * icp + kSkew;
+  const int64_t stride_M = static_cast<int64_t>(block) * ocp + kSkew;
+
+  auto& workspace = WorkSpace::Global_X86();
+  size_t workspace_mark = workspace.cursor();
+  float* pad = workspace.Alloc<float>(static_cast<size_t>(icp) * hp * wp);
+  // V is alpha^2 x block x icp and M is alpha^2 x block x ocp.
+  float* V = workspace.Alloc<float>(alpha * alpha * stride_V);
+  float* M = workspace.Alloc<float>(alpha * alpha * stride_M);
+
+  const int64_t in_size = static_cast<int64_t>(nchw8c ? icp : ic) * ih * iw;
+  const int64_t out_size = static_cast<int64_t>(nchw8c ? ocp : oc) * oh * ow;
+  for (int n = 0; n < num; ++n) {
+    const float* in = din + n * in_size;
+    float* out = dout + n * out_size;
+    LITE_PARALLEL_BEGIN(cb, tid, icb) {
+      float* dst = pad + static_cast<int64_t>(cb) * hp * wp * kLanes;
+      if (nchw8c) {
+        pack_input_nchw8c(in, ih, iw, cb, pad_top, pad_left, hp, wp, dst);
+      } else {
+        pack_input(
+            in, ic, ih, iw, cb * kLanes, pad_top, pad_left, hp, wp, dst);
+      }
+    }
+    LITE_PARALLEL_END();
+
+    for (int t0 = 0; t0 < tiles; t0 += block) {
+      const int nt = std::min(block, tiles - t0);
+      // V = B^T d B, the neighbouring tiles of a channel block go together.
+      LITE_PARALLEL_BEGIN(i, tid, nt * icb) {
+        const int cb = i / nt;
+        const int t = i % nt;
+        const int ty = (t0 + t) / tiles_w;
+        const int tx = (t0 + t) % tiles_w;
+        const float* d =
+            pad + ((static_cast<int64_t>(cb) * hp + ty * m) * wp + tx * m) *
+                      kLanes;
+        float tmp[alpha * alpha * kLanes];
+        for (int j = 0; j < alpha; ++j) {
+          F::input(
+              d + j * kLanes, wp * kLanes, tmp + j * kLanes, alpha * kLanes);
+        }
+        for (int r = 0; r < alpha; ++r) {
+          F::input(tmp + r * alpha * kLanes,
+                   kLanes,
+                   V + r * alpha * stride_V + t * icp + cb * kLanes,
+                   stride_V);
+        }
+      }
+      LITE_PARALLEL_END();
+
+      gemm_fp32_prepacked_batch(false,
+                                nt,
+                                oc,
+                                ic,
+                                1.f,
+                                V,
+                                icp,
+                                stride_V,
+                                trans_weights,
+                                packed_size,
+                                0.f,
+                                M,
+                                ocp,
+                                stride_M,
+                                alpha * alpha);
+
+      // Y = A^T M A, plus the bias.
+      LITE_PARALLEL_BEGIN(i, tid, nt * ocb) {
+        const int cb = i / nt;
+        const int t = i % nt;
+        const int ty = (t0 + t) / tiles_w;
+        const int tx = (t0 + t) % tiles_w;
+        const float* src = M + t * ocp + cb * kLanes;
+        float tmp[m * alpha * kLanes];
+        float y[m * m * kLanes];
+        for (int j = 0; j < alpha; ++j) {
+          F::output(src + j * stride_M,
+                    alpha * stride_M,
+                    tmp + j * kLanes,
+                    alpha * kLanes);
+        }
+        for (int r = 0; r < m; ++r) {
+          F::output(
+              tmp + r * alpha * kLanes, kLanes, y + r * m * kLanes, kLanes);
+        }
+        const int rows = std::min(m, oh - ty * m);
+        const int cols = std::min(m, ow - tx * m);
+        const int lanes = std::min(kLanes, oc - cb * kLanes);
+        if (nchw8c) {
+          store_tile_nchw8c(
+              y, m, rows, cols, lanes, oh, ow, cb, ty * m, tx * m, bias, out);
+        } else {
+          store_tile(
+              y, m, rows, cols, lanes, oh, ow, cb, ty * m, tx * m, bias, out);
+        }
+      }
+      LITE_PARALLEL_END();
+    }
+  }
+  workspace.Rewind(workspace_mark);
+}
+
+void conv_winograd(bool nchw8c,
+                   const float* din,
+                   float* dout,
+                   int num,
+                   int ic,
+                   int ih,
+                   int iw,
+                   int oc,
+                   int oh,
+                   int ow,
+                   int pad_top,
+                   int pad_left,
+                   int out_tile,
+                   const float* trans_weights,
+                   const float* bias) {
+  if (out_tile == 4) {
+    conv_winograd_impl<WinogradF4>(nchw8c,
+                                   din,
+                                   dout,
+                                   num,
+                                   ic,
+                                   ih,
+                                   iw,
+                                   oc,
+                                   oh,
+                                   ow,
+                                   pad_top,
+                                   pad_left,
+                                   trans_weights,
+                                   bias);
+  } else {
+    CHECK_EQ(out_tile, 6) << "unsupported winograd output tile " << out_tile;
+    conv_winograd_impl<WinogradF6>(nchw8c,
+                                   din,
+                                   dout,
+                                   num,
+                                   ic,
+                                   ih,
+                                   iw,
+                                   oc,
+                                   oh,
+                                   ow,
+                                   pad_top,
+                                   pad_left,
+                                   trans_weights,
+                                   bias);
+  }
+}
+
+}  // namespace
+
+int conv_winograd_fp32_out_tile(int ic, int oc, int oh, int ow) {
+  // The transforms do not pay off on few channels.
+  if (!gemm_fp32_available() || ic < 16 || oc < 16) return 0;
+  // Every tile reads all the transformed weights, which are 64 / 9 times the
+  // weights for F(6x6) and 36 / 9 times for F(4x4), so the larger tiles need
+  // more of them.
+  if (div_up(oh, 6) * div_up(ow, 6) >= 64) return 6;
+  return div_up(oh, 4) * div_up(ow, 4) >= 4 ? 4 : 0;
+}
+
+int64_t conv_winograd_fp32_weights_size(int out_tile, int ic, int oc) {
+  const int alpha = out_tile + 2;
+  return alpha * alpha * gemm_fp32_packed_B_size(oc, ic);
+}
+
+void conv_winograd_fp32_trans_weights(
+    const float* weights, int ic, int oc, int out_tile, float* trans_weights) {
+  if (out_tile == 4) {
+    trans_weights_impl<WinogradF4>(weights, ic, oc, trans_weights);
+  } else {
+    CHECK_EQ(out_tile, 6) << "unsupported winograd output tile " << out_tile;
+    trans_weights_impl<WinogradF6>(weights, ic, oc, trans_weights);
+  }
+}
+
+int64_t conv_winograd_fp32_workspace_size(
+    int out_tile, int ic, int oc, int oh, int ow) {
+  const int alpha = out_tile + 2;
+  const int tiles_h = div_up(oh, out_tile);
+  const int tiles_w = div_up(ow, out_tile);
+  const int icp = div_up(ic, kLanes) * kLanes;
+  const int ocp = div_up(oc, kLanes) * kLanes;
+  const int block =
+      winograd_tile_block(alpha, icp, ocp, tiles_h * tiles_w);
+  const int64_t pad = static_cast<int64_t>(icp) * (tiles_h * out_tile + 2) *
+                      (tiles_w * out_tile + 2);
+  // and the packed rows of V in gemm_fp32
+  const int64_t gemm = static_cast<int64_t>(div_up(block, 12) * 12) * ic;
+  const int64_t vm = static_cast<int64_t>(block) * (icp + ocp) + 2 * kSkew;
+  return (pad + alpha * alpha * vm + gemm) * sizeof(float);
+}
+
+void conv_winograd_fp32(const float* din,
+                        float* dout,
+                        int num,
+                        int ic,
+                        int ih,
+                        int iw,
+                        int oc,
+                        int oh,
+                        int ow,
+                        int pad_top,
+                        int pad_left,
+                        int out_tile,
+                        const float* trans_weights,
+                        const float* bias) {
+  conv_winograd(false,
+                din,
+                dout,
+                num,
+                ic,
+                ih,
+                iw,
+                oc,
+                oh,
+                ow,
+                pad_top,
+                pad_left,
+                out_tile,
+                trans_weights,
+                bias);
+}
+
+void conv_winograd_fp32_nchw8c(const float* din,
+                               float* dout,
+                               int num,
+                               int ic,
+                               int ih,
+                               int iw,
+                               int oc,
+                               int oh,
+                               int ow,
+                               int pad_top,
+                               int pad_left,
+                               int out_tile,
+                               const float* trans_weights,
+                               const float* bias) {
+  conv_winograd(true,
+                din,
+                dout,
+                num,
+                ic,
+                ih,
+                iw,
+                oc,
+                oh,
+                ow,
+                pad_top,
+                pad_left,
+                out_tile,
+                trans_weights,
+                bias);
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
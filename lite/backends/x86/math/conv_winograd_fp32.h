@@ -0,0 +1,89 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * The 3x3 stride 1 convolution by Winograd F(m x m, 3 x 3), m = 4 or 6.
+ *
+ * The filter is transformed once into alpha x alpha matrices U = G g G^T,
+ * alpha = m + 2, and kept as alpha^2 ic x oc matrices prepacked for
+ * gemm_fp32. The output is cut into m x m tiles and, for every block of
+ * tiles, the input tiles are transformed into V = B^T d B, the alpha^2 gemms
+ * M = V * U, one for every element of the tiles, run as one batch, and M is
+ * transformed back into the output Y = A^T M A. The transforms run on 8
+ * channels at a time, the input being repacked into blocks of 8 channels.
+ */
+
+// The output tile, 4 or 6, of the fastest Winograd convolution for the
+// shape, 0 if im2col and gemm are faster or the cpu has no gemm_fp32.
+int conv_winograd_fp32_out_tile(int ic, int oc, int oh, int ow);
+
+// The number of floats of the transformed weights.
+int64_t conv_winograd_fp32_weights_size(int out_tile, int ic, int oc);
+
+// Transform the oc x ic x 3 x 3 weights.
+void conv_winograd_fp32_trans_weights(
+    const float* weights, int ic, int oc, int out_tile, float* trans_weights);
+
+// The bytes of the workspace conv_winograd_fp32 takes.
+int64_t conv_winograd_fp32_workspace_size(
+    int out_tile, int ic, int oc, int oh, int ow);
+
+// dout = conv(din, weights) + bias, din is num x ic x ih x iw padded by
+// pad_top rows and pad_left columns, the rows and the columns past its end
+// are zeros up to the oh x ow output. bias may be null.
+void conv_winograd_fp32(const float* din,
+                        float* dout,
+                        int num,
+                        int ic,
+                        int ih,
+                        int iw,
+                        int oc,
+                        int oh,
+                        int ow,
+                        int pad_top,
+                        int pad_left,
+                        int out_tile,
+                        const float* trans_weights,
+                        const float* bias);
+
+// The same on the images blocked by 8 channels, nChw8c, whose padding
+// channels are left zeros in dout.
+void conv_winograd_fp32_nchw8c(const float* din,
+                               float* dout,
+                               int num,
+                               int ic,
+                               int ih,
+                               int iw,
+                               int oc,
+                               int oh,
+                               int ow,
+                               int pad_top,
+                               int pad_left,
+                               int out_tile,
+                               const float* trans_weights,
+                               const float* bias);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
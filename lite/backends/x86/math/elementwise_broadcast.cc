@@ -0,0 +1,95 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/elementwise_broadcast.h"
+#include <cstdlib>
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+BroadcastPlan elementwise_broadcast_plan(const lite::DDim& x_dims,
+                                         const lite::DDim& y_dims,
+                                         int axis) {
+  // Pad the smaller of x and y by 1 to the rank of the other.
+  const int x_rank = x_dims.size();
+  const int y_rank = y_dims.size();
+  const int rank = std::max(x_rank, y_rank);
+  if (axis == -1) axis = std::abs(x_rank - y_rank);
+  std::vector<int64_t> x_full(rank, 1);
+  std::vector<int64_t> y_full(rank, 1);
+  const int x_axis = x_rank < y_rank ? axis : 0;
+  const int y_axis = x_rank < y_rank ? 0 : axis;
+  CHECK(x_axis + x_rank <= rank && y_axis + y_rank <= rank)
+      << "The axis " << axis << " of elementwise ops is out of the dims "
+      << x_dims << " and " << y_dims;
+  for (int i = 0; i < x_rank; ++i) x_full[x_axis + i] = x_dims[i];
+  for (int i = 0; i < y_rank; ++i) y_full[y_axis + i] = y_dims[i];
+
+  // The dims of out, those of size 1 dropped and the neighbours broadcast
+  // alike merged.
+  std::vector<int64_t> dims;
+  std::vector<bool> x_bcast, y_bcast;
+  for (int i = 0; i < rank; ++i) {
+    CHECK(x_full[i] == y_full[i] || x_full[i] == 1 || y_full[i] == 1)
+        << "The dims " << x_dims << " and " << y_dims
+        << " of elementwise ops do not broadcast with the axis " << axis;
+    // A dimension of 0 broadcasts to 0, out is empty.
+    if (x_full[i] == 0 || y_full[i] == 0) {
+      BroadcastPlan plan;
+      plan.dims.assign(1, 0);
+      plan.x_strides.assign(1, 1);
+      plan.y_strides.assign(1, 1);
+      return plan;
+    }
+    const int64_t dim = std::max(x_full[i], y_full[i]);
+    if (dim == 1) continue;
+    const bool xb = x_full[i] == 1;
+    const bool yb = y_full[i] == 1;
+    if (!dims.empty() && x_bcast.back() == xb && y_bcast.back() == yb) {
+      dims.back() *= dim;
+    } else {
+      dims.push_back(dim);
+      x_bcast.push_back(xb);
+      y_bcast.push_back(yb);
+    }
+  }
+  BroadcastPlan plan;
+  if (dims.empty()) {
+    plan.dims.assign(1, 1);
+    plan.x_strides.assign(1, 1);
+    plan.y_strides.assign(1, 1);
+    return plan;
+  }
+  const int plan_rank = dims.size();
+  plan.dims = dims;
+  plan.x_strides.resize(plan_rank);
+  plan.y_strides.resize(plan_rank);
+  int64_t x_stride = 1;
+  int64_t y_stride = 1;
+  for (int i = plan_rank - 1; i >= 0; --i) {
+    plan.x_strides[i] = x_bcast[i] ? 0 : x_stride;
+    plan.y_strides[i] = y_bcast[i] ? 0 : y_stride;
+    if (!x_bcast[i]) x_stride *= dims[i];
+    if (!y_bcast[i]) y_stride *= dims[i];
+  }
+  return plan;
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
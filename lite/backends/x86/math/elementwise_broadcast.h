@@ -0,0 +1,119 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "lite/backends/x86/math/elementwise_common_broadcast_config.h"
+#include "lite/core/dim.h"
+#include "lite/core/parallel_defines.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * The loops of out = op(x, y) of x and y broadcast to out.
+ *
+ * The dimensions of out of size 1 are dropped and the neighbours broadcast
+ * alike, i.e. x and y both whole, x broadcast or y broadcast, are merged,
+ * so that the usual broadcasts come to at most 3 loops: a scalar, a row
+ * [n] or a column [n, 1] of y come to [size], [pre, n] and [n, post]. A
+ * stride of 0 is a dimension x or y is broadcast along. An empty out, of a
+ * dimension of 0 in x or y, is the single loop [0].
+ */
+struct BroadcastPlan {
+  std::vector<int64_t> dims;
+  std::vector<int64_t> x_strides;
+  std::vector<int64_t> y_strides;
+};
+
+// The plan of the elementwise ops, the smaller of x and y being aligned to
+// the dimension axis of the other one, or to its last dimensions if axis is
+// -1.
+BroadcastPlan elementwise_broadcast_plan(const lite::DDim& x_dims,
+                                         const lite::DDim& y_dims,
+                                         int axis);
+
+/*
+ * out = op(x, y) of the plan, the innermost loop running the vector loops of
+ * Config over a whole row, a row and a scalar of y or a scalar of x and a
+ * row. The rows are split across the threads, and the rows themselves when
+ * they are fewer than the threads.
+ */
+template <class Config>
+void elementwise_broadcast(const typename Config::T* x,
+                           const typename Config::T* y,
+                           typename Config::T* out,
+                           const BroadcastPlan& plan) {
+  using T = typename Config::T;
+  const int64_t kTaskSize = 16384;
+  const int64_t kMinChunk = 4096;
+  const int rank = plan.dims.size();
+  const int64_t inner = plan.dims[rank - 1];
+  int64_t rows = 1;
+  for (int i = 0; i < rank - 1; ++i) {
+    rows *= plan.dims[i];
+  }
+  if (rows * inner == 0) return;
+  const bool x_single = plan.x_strides[rank - 1] == 0;
+  const bool y_single = plan.y_strides[rank - 1] == 0;
+
+  const int threads =
+      rows * inner >= kTaskSize ? ThreadPool::CurrentThreadNum() : 1;
+  int64_t chunks = 1;
+  if (rows < threads) {
+    chunks = std::min<int64_t>((threads + rows - 1) / rows,
+                               std::max<int64_t>(1, inner / kMinChunk));
+  }
+  const int64_t items = rows * chunks;
+  const int tasks = static_cast<int>(std::min<int64_t>(threads, items));
+  LITE_PARALLEL_BEGIN(t, tid, tasks) {
+    for (int64_t item = items * t / tasks; item < items * (t + 1) / tasks;
+         ++item) {
+      const int64_t row = item / chunks;
+      const int64_t chunk = item % chunks;
+      const int64_t begin = inner * chunk / chunks;
+      const int num = static_cast<int>(inner * (chunk + 1) / chunks - begin);
+      int64_t x_offset = x_single ? 0 : begin;
+      int64_t y_offset = y_single ? 0 : begin;
+      int64_t rest = row;
+      for (int i = rank - 2; i >= 0; --i) {
+        const int64_t index = rest % plan.dims[i];
+        rest /= plan.dims[i];
+        x_offset += index * plan.x_strides[i];
+        y_offset += index * plan.y_strides[i];
+      }
+      const T* x_ptr = x + x_offset;
+      const T* y_ptr = y + y_offset;
+      T* out_ptr = out + row * inner + begin;
+      if (x_single) {
+        elementwise_one_to_range<Config>(x_ptr, y_ptr, out_ptr, num);
+      } else if (y_single) {
+        elementwise_range_to_one<Config>(x_ptr, y_ptr, out_ptr, num);
+      } else {
+        elementwise_range_to_range<Config>(x_ptr, y_ptr, out_ptr, num);
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,243 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/elementwise_chain.h"
+#include <algorithm>
+#include <cmath>
+#include "lite/backends/x86/math/vector_math_avx2.h"
+#include "lite/core/parallel_defines.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The floats of a tile, and the least elements of a task.
+const int kTile = 512;
+const int64_t kTaskSize = 16384;
+
+// The operand y of the elements [i0, i0 + len) of a binary op, read in place
+// when it is contiguous, or gathered into buf.
+const float* chain_operand(const ChainOp& op, int64_t i0, int len, float* buf) {
+  if (op.post == 1) {
+    const int64_t j0 = i0 % op.n;
+    if (j0 + len <= op.n) return op.y + j0;
+  }
+  int i = 0;
+  while (i < len) {
+    const int64_t q = (i0 + i) / op.post;
+    const int run = static_cast<int>(
+        std::min<int64_t>(len - i, (q + 1) * op.post - (i0 + i)));
+    if (op.post == 1) {
+      const int64_t j0 = (i0 + i) % op.n;
+      const int count = static_cast<int>(std::min<int64_t>(len - i, op.n - j0));
+      std::copy(op.y + j0, op.y + j0 + count, buf + i);
+      i += count;
+    } else {
+      std::fill(buf + i, buf + i + run, op.y[q % op.n]);
+      i += run;
+    }
+  }
+  return buf;
+}
+
+//****************************** reference ***********************************
+inline float sigmoid_ref(float v) { return 1.f / (1.f + std::exp(-v)); }
+
+void chain_op_ref(
+    const ChainOp& op, const float* src, const float* y, float* dst, int len) {
+  for (int i = 0; i < len; ++i) {
+    const float v = src[i];
+    float r = v;
+    switch (op.type) {
+      case ChainOpType::kAdd:
+        r = v + y[i];
+        break;
+      case ChainOpType::kSub:
+        r = v - y[i];
+        break;
+      case ChainOpType::kMul:
+        r = v * y[i];
+        break;
+      case ChainOpType::kDiv:
+        r = v / y[i];
+        break;
+      case ChainOpType::kMax:
+        r = std::max(v, y[i]);
+        break;
+      case ChainOpType::kMin:
+        r = std::min(v, y[i]);
+        break;
+      case ChainOpType::kScale:
+        r = v * op.a + op.b;
+        break;
+      case ChainOpType::kRelu:
+        r = std::max(v, 0.f);
+        break;
+      case ChainOpType::kRelu6:
+        r = std::min(std::max(v, 0.f), op.a);
+        break;
+      case ChainOpType::kLeakyRelu:
+        r = v > 0.f ? v : v * op.a;
+        break;
+      case ChainOpType::kSigmoid:
+        r = sigmoid_ref(v);
+        break;
+      case ChainOpType::kTanh:
+        r = std::tanh(v);
+        break;
+      case ChainOpType::kSwish:
+        r = v * sigmoid_ref(op.a * v);
+        break;
+      case ChainOpType::kHardSwish:
+        r = v * std::min(std::max(v + op.c, 0.f), op.a) / op.b;
+        break;
+    }
+    dst[i] = r;
+  }
+}
+
+//******************************** AVX2 **************************************
+X86_TARGET_AVX2 inline __m256 sigmoid_avx2(__m256 v) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  __m256 e = exp_avx2(_mm256_sub_ps(_mm256_setzero_ps(), v));
+  return _mm256_div_ps(one, _mm256_add_ps(one, e));
+}
+
+// The loops of 8 elements, the tail is left to the reference.
+#define CHAIN_UNARY_LOOP(EXPR)           \
+  for (; i + 8 <= len; i += 8) {         \
+    __m256 v = _mm256_loadu_ps(src + i); \
+    _mm256_storeu_ps(dst + i, EXPR);     \
+  }
+
+#define CHAIN_BINARY_LOOP(EXPR)          \
+  for (; i + 8 <= len; i += 8) {         \
+    __m256 v = _mm256_loadu_ps(src + i); \
+    __m256 w = _mm256_loadu_ps(y + i);   \
+    _mm256_storeu_ps(dst + i, EXPR);     \
+  }
+
+X86_TARGET_AVX2 void chain_op_avx2(
+    const ChainOp& op, const float* src, const float* y, float* dst, int len) {
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.f);
+  const __m256 va = _mm256_set1_ps(op.a);
+  const __m256 vb = _mm256_set1_ps(op.b);
+  const __m256 vc = _mm256_set1_ps(op.c);
+  int i = 0;
+  switch (op.type) {
+    case ChainOpType::kAdd:
+      CHAIN_BINARY_LOOP(_mm256_add_ps(v, w))
+      break;
+    case ChainOpType::kSub:
+      CHAIN_BINARY_LOOP(_mm256_sub_ps(v, w))
+      break;
+    case ChainOpType::kMul:
+      CHAIN_BINARY_LOOP(_mm256_mul_ps(v, w))
+      break;
+    case ChainOpType::kDiv:
+      CHAIN_BINARY_LOOP(_mm256_div_ps(v, w))
+      break;
+    case ChainOpType::kMax:
+      CHAIN_BINARY_LOOP(_mm256_max_ps(v, w))
+      break;
+    case ChainOpType::kMin:
+      CHAIN_BINARY_LOOP(_mm256_min_ps(v, w))
+      break;
+    case ChainOpType::kScale:
+      CHAIN_UNARY_LOOP(_mm256_fmadd_ps(v, va, vb))
+      break;
+    case ChainOpType::kRelu:
+      CHAIN_UNARY_LOOP(_mm256_max_ps(v, zero))
+      break;
+    case ChainOpType::kRelu6:
+      CHAIN_UNARY_LOOP(_mm256_min_ps(_mm256_max_ps(v, zero), va))
+      break;
+    case ChainOpType::kLeakyRelu:
+      CHAIN_UNARY_LOOP(_mm256_blendv_ps(
+          _mm256_mul_ps(v, va), v, _mm256_cmp_ps(v, zero, _CMP_GT_OQ)))
+      break;
+    case ChainOpType::kSigmoid:
+      CHAIN_UNARY_LOOP(sigmoid_avx2(v))
+      break;
+    case ChainOpType::kTanh:
+      // tanh(v) = 1 - 2 / (exp(2 * v) + 1).
+      CHAIN_UNARY_LOOP(_mm256_sub_ps(
+          one,
+          _mm256_div_ps(_mm256_set1_ps(2.f),
+                        _mm256_add_ps(exp_avx2(_mm256_add_ps(v, v)), one))))
+      break;
+    case ChainOpType::kSwish:
+      CHAIN_UNARY_LOOP(_mm256_mul_ps(v, sigmoid_avx2(_mm256_mul_ps(v, va))))
+      break;
+    case ChainOpType::kHardSwish:
+      CHAIN_UNARY_LOOP(_mm256_div_ps(
+          _mm256_mul_ps(
+              v, _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(v, vc), zero), va)),
+          vb))
+      break;
+  }
+  chain_op_ref(op, src + i, y ? y + i : nullptr, dst + i, len - i);
+}
+
+#undef CHAIN_UNARY_LOOP
+#undef CHAIN_BINARY_LOOP
+
+}  // namespace
+
+bool is_binary_chain_op(ChainOpType type) {
+  return type <= ChainOpType::kMin;
+}
+
+void elementwise_chain_fp32(const float* x,
+                            const std::vector<ChainOp>& ops,
+                            int64_t size,
+                            float* out) {
+  const bool use_avx2 = avx2_available();
+  const int64_t tiles = (size + kTile - 1) / kTile;
+  const int tasks = static_cast<int>(std::max<int64_t>(
+      1, std::min<int64_t>(ThreadPool::CurrentThreadNum(), size / kTaskSize)));
+  LITE_PARALLEL_BEGIN(t, tid, tasks) {
+    float buf[kTile];
+    for (int64_t tile = tiles * t / tasks; tile < tiles * (t + 1) / tasks;
+         ++tile) {
+      const int64_t i0 = tile * kTile;
+      const int len = static_cast<int>(std::min<int64_t>(kTile, size - i0));
+      // The first op reads x, the others run in place on the tile of out.
+      const float* src = x + i0;
+      float* dst = out + i0;
+      for (auto& op : ops) {
+        const float* y = is_binary_chain_op(op.type)
+                             ? chain_operand(op, i0, len, buf)
+                             : nullptr;
+        if (use_avx2) {
+          chain_op_avx2(op, src, y, dst, len);
+        } else {
+          chain_op_ref(op, src, y, dst, len);
+        }
+        src = dst;
+      }
+      if (ops.empty()) std::copy(src, src + len, dst);
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
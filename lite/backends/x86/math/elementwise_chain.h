@@ -0,0 +1,75 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+enum class ChainOpType {
+  kAdd = 0,
+  kSub,
+  kMul,
+  kDiv,
+  kMax,
+  kMin,
+  kScale,
+  kRelu,
+  kRelu6,
+  kLeakyRelu,
+  kSigmoid,
+  kTanh,
+  kSwish,
+  kHardSwish,
+};
+
+// An op of a chain, v = op(v, y) of a binary op, v = op(v) of a unary one.
+struct ChainOp {
+  ChainOpType type;
+  // y of the binary ops, broadcast to the pre x n x post v along pre and
+  // post.
+  const float* y{nullptr};
+  int64_t n{1};
+  int64_t post{1};
+  // scale: v * a + b, relu6: min(max(v, 0), a), leaky_relu: v or v * a,
+  // swish: v * sigmoid(a * v), hard_swish: v * min(max(v + c, 0), a) / b.
+  float a{1.f};
+  float b{0.f};
+  float c{0.f};
+};
+
+bool is_binary_chain_op(ChainOpType type);
+
+/*
+ * out = ops[k](... ops[0](x) ...) of the size elements of x.
+ *
+ * The elements are taken by tiles which stay in the L1 cache while the
+ * whole chain runs over them, so x and the operands are read and out is
+ * written once whatever the length of the chain. The tiles are split
+ * across the threads.
+ */
+void elementwise_chain_fp32(const float* x,
+                            const std::vector<ChainOp>& ops,
+                            int64_t size,
+                            float* out);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -99,76 +99,76 @@ T min_epi32_inline(T a, T b);
 // compiler can't recognize intrinsics function name
 #ifdef __AVX__
 template <>
-__m256 loadu_ps_inline<__m256, float>(const float* a) {
+inline __m256 loadu_ps_inline<__m256, float>(const float* a) {
   return _mm256_loadu_ps(a);
 }
 template <>
-void storeu_ps_inline<__m256, float>(float* b, __m256 a) {
+inline void storeu_ps_inline<__m256, float>(float* b, __m256 a) {
   _mm256_storeu_ps(b, a);
 }
 template <>
-__m256 set1_ps_inline<__m256, float>(float a) {
+inline __m256 set1_ps_inline<__m256, float>(float a) {
   return _mm256_set1_ps(a);
 }
 template <>
-__m256 add_ps_inline<__m256>(__m256 a, __m256 b) {
+inline __m256 add_ps_inline<__m256>(__m256 a, __m256 b) {
   return _mm256_add_ps(a, b);
 }
 template <>
-__m256 sub_ps_inline<__m256>(__m256 a, __m256 b) {
+inline __m256 sub_ps_inline<__m256>(__m256 a, __m256 b) {
   return _mm256_sub_ps(a, b);
 }
 template <>
-__m256 max_ps_inline<__m256>(__m256 a, __m256 b) {
+inline __m256 max_ps_inline<__m256>(__m256 a, __m256 b) {
   return _mm256_max_ps(a, b);
 }
 template <>
-__m256 min_ps_inline<__m256>(__m256 a, __m256 b) {
+inline __m256 min_ps_inline<__m256>(__m256 a, __m256 b) {
   return _mm256_min_ps(a, b);
 }
 template <>
-__m256 div_ps_inline<__m256>(__m256 a, __m256 b) {
+inline __m256 div_ps_inline<__m256>(__m256 a, __m256 b) {
   return _mm256_div_ps(a, b);
 }
 template <>
-__m256 mul_ps_inline<__m256>(__m256 a, __m256 b) {
+inline __m256 mul_ps_inline<__m256>(__m256 a, __m256 b) {
   return _mm256_mul_ps(a, b);
 }
 #elif defined(__SSE4_2__)
 template <>
-__m128 loadu_ps_inline<__m128, float>(const float* a) {
+inline __m128 loadu_ps_inline<__m128, float>(const float* a) {
   return _mm_loadu_ps(a);
 }
 template <>
-void storeu_ps_inline<__m128, float>(float* b, __m128 a) {
+inline void storeu_ps_inline<__m128, float>(float* b, __m128 a) {
   _mm_storeu_ps(b, a);
 }
 template <>
-__m128 set1_ps_inline<__m128, float>(float a) {
+inline __m128 set1_ps_inline<__m128, float>(float a) {
   return _mm_set1_ps(a);
 }
 template <>
-__m128 add_ps_inline<__m128>(__m128 a, __m128 b) {
+inline __m128 add_ps_inline<__m128>(__m128 a, __m128 b) {
   return _mm_add_ps(a, b);
 }
 template <>
-__m128 sub_ps_inline<__m128>(__m128 a, __m128 b) {
+inline __m128 sub_ps_inline<__m128>(__m128 a, __m128 b) {
   return _mm_sub_ps(a, b);
 }
 template <>
-__m128 max_ps_inline<__m128>(__m128 a, __m128 b) {
+inline __m128 max_ps_inline<__m128>(__m128 a, __m128 b) {
   return _mm_max_ps(a, b);
 }
 template <>
-__m128 min_ps_inline<__m128>(__m128 a, __m128 b) {
+inline __m128 min_ps_inline<__m128>(__m128 a, __m128 b) {
   return _mm_min_ps(a, b);
 }
 template <>
-__m128 div_ps_inline<__m128>(__m128 a, __m128 b) {
+inline __m128 div_ps_inline<__m128>(__m128 a, __m128 b) {
   return _mm_div_ps(a, b);
 }
 template <>
-__m128 mul_ps_inline<__m128>(__m128 a, __m128 b) {
+inline __m128 mul_ps_inline<__m128>(__m128 a, __m128 b) {
   return _mm_mul_ps(a, b);
 }
 
@@ -180,92 +180,92 @@ __m128 _mm_relu_ps(const __m128& a) {
 
 #if defined(__AVX2__)
 template <>
-__m256i loadu_si_inline<__m256i, __m256i>(const __m256i* a) {
+inline __m256i loadu_si_inline<__m256i, __m256i>(const __m256i* a) {
   return _mm256_loadu_si256(a);
 }
 template <>
-void storeu_si_inline<__m256i, __m256i>(__m256i* b, __m256i a) {
+inline void storeu_si_inline<__m256i, __m256i>(__m256i* b, __m256i a) {
   _mm256_storeu_si256(b, a);
 }
 template <>
-__m256i set1_epi32_inline<__m256i, int>(int a) {
+inline __m256i set1_epi32_inline<__m256i, int>(int a) {
   return _mm256_set1_epi32(a);
 }
 template <>
-__m256i set1_epi64x_inline<__m256i, int64_t>(int64_t a) {
+inline __m256i set1_epi64x_inline<__m256i, int64_t>(int64_t a) {
   return _mm256_set1_epi64x(a);
 }
 template <>
-__m256i add_epi32_inline<__m256i>(__m256i a, __m256i b) {
+inline __m256i add_epi32_inline<__m256i>(__m256i a, __m256i b) {
   return _mm256_add_epi32(a, b);
 }
 template <>
-__m256i add_epi64_inline<__m256i>(__m256i a, __m256i b) {
+inline __m256i add_epi64_inline<__m256i>(__m256i a, __m256i b) {
   return _mm256_add_epi64(a, b);
 }
 template <>
-__m256i sub_epi32_inline<__m256i>(__m256i a, __m256i b) {
+inline __m256i sub_epi32_inline<__m256i>(__m256i a, __m256i b) {
   return _mm256_sub_epi32(a, b);
 }
 template <>
-__m256i sub_epi64_inline<__m256i>(__m256i a, __m256i b) {
+inline __m256i sub_epi64_inline<__m256i>(__m256i a, __m256i b) {
   return _mm256_sub_epi64(a, b);
 }
 template <>
-__m256i mul_epi32_inline<__m256i>(__m256i a, __m256i b) {
+inline __m256i mul_epi32_inline<__m256i>(__m256i a, __m256i b) {
   return _mm256_mullo_epi32(a, b);
 }
 template <>
-__m256i max_epi32_inline<__m256i>(__m256i a, __m256i b) {
+inline __m256i max_epi32_inline<__m256i>(__m256i a, __m256i b) {
   return _mm256_max_epi32(a, b);
 }
 template <>
-__m256i min_epi32_inline<__m256i>(__m256i a, __m256i b) {
+inline __m256i min_epi32_inline<__m256i>(__m256i a, __m256i b) {
   return _mm256_min_epi32(a, b);
 }
 #elif defined(__SSE4_2__)
 template <>
-__m128i loadu_si_inline<__m128i, __m128i>(const __m128i* a) {
+inline __m128i loadu_si_inline<__m128i, __m128i>(const __m128i* a) {
   return _mm_loadu_si128(a);
 }
 template <>
-void storeu_si_inline<__m128i, __m128i>(__m128i* b, __m128i a) {
+inline void storeu_si_inline<__m128i, __m128i>(__m128i* b, __m128i a) {
   _mm_storeu_si128(b, a);
 }
 template <>
-__m128i set1_epi32_inline<__m128i, int>(int a) {
+inline __m128i set1_epi32_inline<__m128i, int>(int a) {
   return _mm_set1_epi32(a);
 }
 template <>
-__m128i set1_epi64x_inline<__m128i, int64_t>(int64_t a) {
+inline __m128i set1_epi64x_inline<__m128i, int64_t>(int64_t a) {
   return _mm_set1_epi64x(a);
 }
 template <>
-__m128i add_epi32_inline<__m128i>(__m128i a, __m128i b) {
+inline __m128i add_epi32_inline<__m128i>(__m128i a, __m128i b) {
   return _mm_add_epi32(a, b);
 }
 template <>
-__m128i add_epi64_inline<__m128i>(__m128i a, __m128i b) {
+inline __m128i add_epi64_inline<__m128i>(__m128i a, __m128i b) {
   return _mm_add_epi64(a, b);
 }
 template <>
-__m128i sub_epi32_inline<__m128i>(__m128i a, __m128i b) {
+inline __m128i sub_epi32_inline<__m128i>(__m128i a, __m128i b) {
   return _mm_sub_epi32(a, b);
 }
 template <>
-__m128i sub_epi64_inline<__m128i>(__m128i a, __m128i b) {
+inline __m128i sub_epi64_inline<__m128i>(__m128i a, __m128i b) {
   return _mm_sub_epi64(a, b);
 }
 template <>
-__m128i mul_epi32_inline<__m128i>(__m128i a, __m128i b) {
+inline __m128i mul_epi32_inline<__m128i>(__m128i a, __m128i b) {
   return _mm_mullo_epi32(a, b);
 }
 template <>
-__m128i max_epi32_inline<__m128i>(__m128i a, __m128i b) {
+inline __m128i max_epi32_inline<__m128i>(__m128i a, __m128i b) {
   return _mm_max_epi32(a, b);
 }
 template <>
-__m128i min_epi32_inline<__m128i>(__m128i a, __m128i b) {
+inline __m128i min_epi32_inline<__m128i>(__m128i a, __m128i b) {
   return _mm_min_epi32(a, b);
 }
 #endif
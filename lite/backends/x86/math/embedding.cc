@@ -0,0 +1,185 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/embedding.h"
+#include <xmmintrin.h>
+#include <algorithm>
+#include <cstring>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/legacy_place.h"
+#include "lite/core/parallel_defines.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The ids the rows are prefetched ahead, and the least floats of a task.
+const int64_t kPrefetchDistance = 8;
+const int64_t kTaskSize = 1 << 14;
+
+int embedding_tasks(int64_t units, int64_t size) {
+  const int64_t threads = ThreadPool::CurrentThreadNum();
+  return static_cast<int>(std::max<int64_t>(
+      1, std::min<int64_t>(std::min(threads, units), size / kTaskSize)));
+}
+
+inline bool is_padding(int64_t id, int64_t padding_idx) {
+  return padding_idx != -1 && id == padding_idx;
+}
+
+// Every cache line of a row of the table.
+inline void prefetch_row(const float* row, int64_t width) {
+  for (int64_t j = 0; j < width; j += 16) {
+    _mm_prefetch(reinterpret_cast<const char*>(row + j), _MM_HINT_T0);
+  }
+}
+
+// All the ids but the padding ones must index a row of the table. They are
+// checked in one branchless pass and only a bad id is looked for.
+void check_ids(const int64_t* ids,
+               int64_t n,
+               int64_t rows,
+               int64_t padding_idx) {
+  uint64_t bad = 0;
+  for (int64_t i = 0; i < n; ++i) {
+    bad |= static_cast<uint64_t>(static_cast<uint64_t>(ids[i]) >=
+                                 static_cast<uint64_t>(rows)) &
+           static_cast<uint64_t>(!is_padding(ids[i], padding_idx));
+  }
+  if (!bad) return;
+  for (int64_t i = 0; i < n; ++i) {
+    if (!is_padding(ids[i], padding_idx)) {
+      CHECK_GE(ids[i], 0) << "id: " << i;
+      CHECK_LT(ids[i], rows) << "id: " << i;
+    }
+  }
+}
+
+}  // namespace
+
+void embedding_lookup_fp32(const float* table,
+                           int64_t rows,
+                           int64_t width,
+                           const int64_t* ids,
+                           int64_t n,
+                           int64_t padding_idx,
+                           float* out) {
+  if (n <= 0 || width <= 0) return;
+  check_ids(ids, n, rows, padding_idx);
+  const size_t row_bytes = width * sizeof(float);
+  const int tasks = embedding_tasks(n, n * width);
+  LITE_PARALLEL_BEGIN(t, tid, tasks) {
+    const int64_t end = n * (t + 1) / tasks;
+    for (int64_t i = n * t / tasks; i < end; ++i) {
+      if (i + kPrefetchDistance < end) {
+        const int64_t next = ids[i + kPrefetchDistance];
+        if (!is_padding(next, padding_idx)) {
+          prefetch_row(table + next * width, width);
+        }
+      }
+      if (is_padding(ids[i], padding_idx)) {
+        memset(out + i * width, 0, row_bytes);
+      } else {
+        memcpy(out + i * width, table + ids[i] * width, row_bytes);
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+void embedding_seq_pool_fp32(const float* table,
+                             int64_t rows,
+                             int64_t width,
+                             const int64_t* ids,
+                             int64_t ids_width,
+                             const uint64_t* offsets,
+                             int64_t num_seq,
+                             int64_t padding_idx,
+                             bool mean,
+                             float pad_value,
+                             float* out) {
+  if (num_seq <= 0 || width <= 0 || ids_width <= 0) return;
+  const int64_t n = static_cast<int64_t>(offsets[num_seq] - offsets[0]);
+  check_ids(ids + offsets[0] * ids_width, n * ids_width, rows, padding_idx);
+  const int64_t out_width = ids_width * width;
+  // The jit kernel sums the rows of a sequence in registers, it needs the
+  // rows in blocks of 8 floats and no padding id to skip.
+  jit::emb_seq_pool_attr_t attr(
+      rows, width, 0, ids_width, out_width, jit::SeqPoolType::kSum);
+  const bool use_jit = width % 8 == 0 && MayIUse(avx);
+  auto emb_seq_pool =
+      use_jit ? jit::KernelFuncs<jit::EmbSeqPoolTuple<float>,
+                                 fluid::CPUPlace>::Cache()
+                    .At(attr)
+              : nullptr;
+  auto vadd =
+      jit::KernelFuncs<jit::VAddTuple<float>, fluid::CPUPlace>::Cache().At(
+          width);
+  const int tasks = embedding_tasks(num_seq, n * out_width);
+  LITE_PARALLEL_BEGIN(t, tid, tasks) {
+    jit::emb_seq_pool_attr_t seq_attr = attr;
+    for (int64_t s = num_seq * t / tasks; s < num_seq * (t + 1) / tasks;
+         ++s) {
+      const int64_t h = static_cast<int64_t>(offsets[s + 1] - offsets[s]);
+      const int64_t* idx = ids + offsets[s] * ids_width;
+      const int64_t size = h * ids_width;
+      float* dst = out + s * out_width;
+      if (h == 0) {
+        std::fill(dst, dst + out_width, pad_value);
+      } else {
+        bool padded = false;
+        if (padding_idx != -1) {
+          for (int64_t i = 0; i < size; ++i) {
+            padded |= idx[i] == padding_idx;
+          }
+        }
+        if (use_jit && !padded) {
+          seq_attr.index_height = h;
+          emb_seq_pool(table, idx, dst, &seq_attr);
+        } else {
+          memset(dst, 0, out_width * sizeof(float));
+          for (int64_t i = 0; i < size; ++i) {
+            if (i + kPrefetchDistance < size) {
+              const int64_t next = idx[i + kPrefetchDistance];
+              if (!is_padding(next, padding_idx)) {
+                prefetch_row(table + next * width, width);
+              }
+            }
+            if (!is_padding(idx[i], padding_idx)) {
+              float* sum = dst + (i % ids_width) * width;
+              vadd(table + idx[i] * width, sum, sum, width);
+            }
+          }
+        }
+        if (mean) {
+          const float scale = 1.f / static_cast<float>(h);
+          for (int64_t j = 0; j < out_width; ++j) {
+            dst[j] *= scale;
+          }
+        }
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,68 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * The embedding lookups of lookup_table and fused_embedding_seq_pool.
+ *
+ * The ids are checked against the table once, up front, and the rows are
+ * split across the threads. The rows a few ids ahead are prefetched, as the
+ * ids of a CTR model hit the table at random.
+ */
+
+// Row i of out, n x width, is the row ids[i] of table, rows x width, or
+// zeros if ids[i] is padding_idx, -1 being no padding.
+void embedding_lookup_fp32(const float* table,
+                           int64_t rows,
+                           int64_t width,
+                           const int64_t* ids,
+                           int64_t n,
+                           int64_t padding_idx,
+                           float* out);
+
+/*
+ * The lookup followed by a sum or mean sequence pool, without the looked up
+ * rows in between.
+ *
+ * ids is n x ids_width, split in sequences by offsets, num_seq + 1 of them.
+ * Row s of out, num_seq x (ids_width * width), is the sum over the rows of
+ * sequence s of the ids_width rows of table they index, divided by the
+ * length of the sequence if mean. The rows of padding_idx add nothing, and
+ * an empty sequence is pad_value. The sums without padding run on the
+ * EmbSeqPool jit kernel.
+ */
+void embedding_seq_pool_fp32(const float* table,
+                             int64_t rows,
+                             int64_t width,
+                             const int64_t* ids,
+                             int64_t ids_width,
+                             const uint64_t* offsets,
+                             int64_t num_seq,
+                             int64_t padding_idx,
+                             bool mean,
+                             float pad_value,
+                             float* out);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,403 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/flash_attention.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "lite/backends/x86/math/vector_math_avx2.h"
+#include "lite/core/parallel_defines.h"
+#include "lite/core/workspace.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The query rows of a task, the keys of a block and the rows of the
+// micro-kernels.
+const int kQc = 64;
+const int kBc = 64;
+const int kBr = 4;
+
+inline int div_up(int a, int b) { return (a + b - 1) / b; }
+
+// The rows [i0, i0 + rows) of an attention of the batch.
+struct AttentionRows {
+  int S;
+  int Sk;
+  int D;
+  int Dv;
+  const float* Q;
+  const float* K;
+  bool trans_K;
+  const float* V;
+  // The mask of row i0, null if there is none.
+  const float* mask;
+  int64_t mask_row_stride;
+  int64_t mask_col_stride;
+  float alpha;
+  float out_scale;
+  float* out;
+};
+
+// The floats of the scratch of a task.
+int64_t attention_scratch_size(int D, int Dv) {
+  return static_cast<int64_t>(D) * kBc + kQc * kBc + kQc * Dv + 2 * kQc;
+}
+
+// Copy the keys [j0, j0 + bc) of K as the columns of kt, D x ldkt, padded by
+// zeros to ldkt.
+void pack_keys(const AttentionRows& p, int j0, int bc, int ldkt, float* kt) {
+  for (int d = 0; d < p.D; ++d) {
+    float* dst = kt + d * ldkt;
+    if (p.trans_K) {
+      const float* src = p.K + static_cast<int64_t>(j0) * p.D + d;
+      for (int j = 0; j < bc; ++j) dst[j] = src[j * p.D];
+    } else {
+      const float* src = p.K + static_cast<int64_t>(d) * p.Sk + j0;
+      std::copy(src, src + bc, dst);
+    }
+    std::fill(dst + bc, dst + ldkt, 0.f);
+  }
+}
+
+// s = alpha * s + mask of the bc scores of a row.
+void scale_mask_row(const AttentionRows& p, int r, int j0, int bc, float* s) {
+  const float* m = p.mask ? p.mask + r * p.mask_row_stride +
+                                j0 * p.mask_col_stride
+                          : nullptr;
+  for (int j = 0; j < bc; ++j) {
+    s[j] = p.alpha * s[j] + (m ? m[j * p.mask_col_stride] : 0.f);
+  }
+}
+
+//****************************** reference ***********************************
+void scores_ref(const float* q,
+                int rows,
+                int D,
+                const float* kt,
+                int ldkt,
+                float* s,
+                int lds) {
+  for (int r = 0; r < rows; ++r) {
+    float* sr = s + r * lds;
+    std::fill(sr, sr + ldkt, 0.f);
+    for (int d = 0; d < D; ++d) {
+      const float qd = q[r * D + d];
+      const float* k = kt + d * ldkt;
+      for (int j = 0; j < ldkt; ++j) sr[j] += qd * k[j];
+    }
+  }
+}
+
+// Turn the scores of a row into exp(s - max), and rescale the sum and the
+// partial output of the row by the growth of its maximum.
+void softmax_update_ref(
+    float* s, int bc, float* row_max, float* row_sum, float* acc, int Dv) {
+  float new_max = *row_max;
+  for (int j = 0; j < bc; ++j) new_max = std::max(new_max, s[j]);
+  if (new_max == -std::numeric_limits<float>::infinity()) {
+    std::fill(s, s + bc, 0.f);
+    return;
+  }
+  float sum = 0.f;
+  for (int j = 0; j < bc; ++j) {
+    s[j] = std::exp(s[j] - new_max);
+    sum += s[j];
+  }
+  const float corr = std::exp(*row_max - new_max);
+  if (corr != 1.f) {
+    for (int c = 0; c < Dv; ++c) acc[c] *= corr;
+  }
+  *row_sum = *row_sum * corr + sum;
+  *row_max = new_max;
+}
+
+// acc += P * V of the rows x bc probabilities, for the columns [c0, Dv).
+void pv_ref(const float* P,
+            int ldp,
+            int rows,
+            int bc,
+            const float* V,
+            int Dv,
+            int c0,
+            float* acc) {
+  for (int r = 0; r < rows; ++r) {
+    float* a = acc + r * Dv;
+    for (int j = 0; j < bc; ++j) {
+      const float pj = P[r * ldp + j];
+      const float* v = V + static_cast<int64_t>(j) * Dv;
+      for (int c = c0; c < Dv; ++c) a[c] += pj * v[c];
+    }
+  }
+}
+
+//******************************** AVX2 **************************************
+#define ATT_ROWS(OP) OP(0) OP(1) OP(2) OP(3)
+
+#define SCORES_INIT_ROW(i)              \
+  __m256 c##i##0 = _mm256_setzero_ps(); \
+  __m256 c##i##1 = _mm256_setzero_ps();
+
+#define SCORES_FMA_ROW(i)                      \
+  if (R > i) {                                 \
+    a = _mm256_broadcast_ss(q + i * D + d);    \
+    c##i##0 = _mm256_fmadd_ps(a, k0, c##i##0); \
+    c##i##1 = _mm256_fmadd_ps(a, k1, c##i##1); \
+  }
+
+#define SCORES_STORE_ROW(i)                         \
+  if (R > i) {                                      \
+    _mm256_storeu_ps(s + i * lds + j, c##i##0);     \
+    _mm256_storeu_ps(s + i * lds + j + 8, c##i##1); \
+  }
+
+// The scores of R rows of q and the ldkt columns of kt, ldkt being a
+// multiple of 16.
+template <int R>
+X86_TARGET_AVX2 void scores_avx2(
+    const float* q, int D, const float* kt, int ldkt, float* s, int lds) {
+  for (int j = 0; j < ldkt; j += 16) {
+    ATT_ROWS(SCORES_INIT_ROW)
+    const float* k = kt + j;
+    for (int d = 0; d < D; ++d) {
+      __m256 k0 = _mm256_loadu_ps(k);
+      __m256 k1 = _mm256_loadu_ps(k + 8);
+      __m256 a;
+      ATT_ROWS(SCORES_FMA_ROW)
+      k += ldkt;
+    }
+    ATT_ROWS(SCORES_STORE_ROW)
+  }
+}
+
+X86_TARGET_AVX2 void softmax_update_avx2(
+    float* s, int bc, float* row_max, float* row_sum, float* acc, int Dv) {
+  const float neg_inf = -std::numeric_limits<float>::infinity();
+  int j = 0;
+  __m256 vmax = _mm256_set1_ps(*row_max);
+  for (; j + 8 <= bc; j += 8) {
+    vmax = _mm256_max_ps(vmax, _mm256_loadu_ps(s + j));
+  }
+  float new_max = hmax_avx2(vmax);
+  for (; j < bc; ++j) new_max = std::max(new_max, s[j]);
+  if (new_max == neg_inf) {
+    std::fill(s, s + bc, 0.f);
+    return;
+  }
+  vmax = _mm256_set1_ps(new_max);
+  __m256 vsum = _mm256_setzero_ps();
+  for (j = 0; j + 8 <= bc; j += 8) {
+    __m256 e = exp_avx2(_mm256_sub_ps(_mm256_loadu_ps(s + j), vmax));
+    _mm256_storeu_ps(s + j, e);
+    vsum = _mm256_add_ps(vsum, e);
+  }
+  float sum = hsum_avx2(vsum);
+  for (; j < bc; ++j) {
+    s[j] = std::exp(s[j] - new_max);
+    sum += s[j];
+  }
+  const float corr = std::exp(*row_max - new_max);
+  if (corr != 1.f) {
+    __m256 vcorr = _mm256_set1_ps(corr);
+    int c = 0;
+    for (; c + 8 <= Dv; c += 8) {
+      _mm256_storeu_ps(acc + c,
+                       _mm256_mul_ps(_mm256_loadu_ps(acc + c), vcorr));
+    }
+    for (; c < Dv; ++c) acc[c] *= corr;
+  }
+  *row_sum = *row_sum * corr + sum;
+  *row_max = new_max;
+}
+
+#define PV_LOAD_ROW(i)                               \
+  __m256 c##i##0, c##i##1;                           \
+  if (R > i) {                                       \
+    c##i##0 = _mm256_loadu_ps(acc + i * Dv + c);     \
+    c##i##1 = _mm256_loadu_ps(acc + i * Dv + c + 8); \
+  }
+
+#define PV_FMA_ROW(i)                          \
+  if (R > i) {                                 \
+    a = _mm256_broadcast_ss(P + i * ldp + j);  \
+    c##i##0 = _mm256_fmadd_ps(a, v0, c##i##0); \
+    c##i##1 = _mm256_fmadd_ps(a, v1, c##i##1); \
+  }
+
+#define PV_STORE_ROW(i)                              \
+  if (R > i) {                                       \
+    _mm256_storeu_ps(acc + i * Dv + c, c##i##0);     \
+    _mm256_storeu_ps(acc + i * Dv + c + 8, c##i##1); \
+  }
+
+// acc += P * V of R rows, the columns after the last 16 are left to pv_ref.
+template <int R>
+X86_TARGET_AVX2 void pv_avx2(
+    const float* P, int ldp, int bc, const float* V, int Dv, float* acc) {
+  for (int c = 0; c + 16 <= Dv; c += 16) {
+    ATT_ROWS(PV_LOAD_ROW)
+    const float* v = V + c;
+    for (int j = 0; j < bc; ++j) {
+      __m256 v0 = _mm256_loadu_ps(v);
+      __m256 v1 = _mm256_loadu_ps(v + 8);
+      __m256 a;
+      ATT_ROWS(PV_FMA_ROW)
+      v += Dv;
+    }
+    ATT_ROWS(PV_STORE_ROW)
+  }
+}
+
+#undef ATT_ROWS
+#undef SCORES_INIT_ROW
+#undef SCORES_FMA_ROW
+#undef SCORES_STORE_ROW
+#undef PV_LOAD_ROW
+#undef PV_FMA_ROW
+#undef PV_STORE_ROW
+
+typedef void (*ScoresAvx2)(const float*, int, const float*, int, float*, int);
+typedef void (*PvAvx2)(const float*, int, int, const float*, int, float*);
+
+const ScoresAvx2 kScoresAvx2[kBr] = {
+    scores_avx2<1>, scores_avx2<2>, scores_avx2<3>, scores_avx2<4>};
+const PvAvx2 kPvAvx2[kBr] = {pv_avx2<1>, pv_avx2<2>, pv_avx2<3>, pv_avx2<4>};
+
+//******************************** driver ************************************
+// Out of the rows of p, at most kQc, streaming the keys by blocks of kBc.
+void attention_rows(const AttentionRows& p,
+                    int rows,
+                    bool use_avx2,
+                    float* scratch) {
+  float* kt = scratch;
+  float* scores = kt + static_cast<int64_t>(p.D) * kBc;
+  float* acc = scores + kQc * kBc;
+  float* row_max = acc + kQc * p.Dv;
+  float* row_sum = row_max + kQc;
+  std::fill(acc, acc + rows * p.Dv, 0.f);
+  std::fill(row_max, row_max + rows, -std::numeric_limits<float>::infinity());
+  std::fill(row_sum, row_sum + rows, 0.f);
+  // The columns of V after the last 16 are left to pv_ref.
+  const int dv_avx2 = use_avx2 ? p.Dv / 16 * 16 : 0;
+
+  for (int j0 = 0; j0 < p.Sk; j0 += kBc) {
+    const int bc = std::min(kBc, p.Sk - j0);
+    const int ldk = use_avx2 ? div_up(bc, 16) * 16 : bc;
+    pack_keys(p, j0, bc, ldk, kt);
+    const float* V = p.V + static_cast<int64_t>(j0) * p.Dv;
+    for (int r0 = 0; r0 < rows; r0 += kBr) {
+      const int br = std::min(kBr, rows - r0);
+      const float* q = p.Q + static_cast<int64_t>(r0) * p.D;
+      float* s = scores + r0 * kBc;
+      if (use_avx2) {
+        kScoresAvx2[br - 1](q, p.D, kt, ldk, s, kBc);
+      } else {
+        scores_ref(q, br, p.D, kt, ldk, s, kBc);
+      }
+      for (int r = r0; r < r0 + br; ++r) {
+        float* sr = scores + r * kBc;
+        scale_mask_row(p, r, j0, bc, sr);
+        if (use_avx2) {
+          softmax_update_avx2(
+              sr, bc, row_max + r, row_sum + r, acc + r * p.Dv, p.Dv);
+        } else {
+          softmax_update_ref(
+              sr, bc, row_max + r, row_sum + r, acc + r * p.Dv, p.Dv);
+        }
+      }
+      float* acc_r = acc + r0 * p.Dv;
+      if (use_avx2) kPvAvx2[br - 1](s, kBc, bc, V, p.Dv, acc_r);
+      pv_ref(s, kBc, br, bc, V, p.Dv, dv_avx2, acc_r);
+    }
+  }
+
+  for (int r = 0; r < rows; ++r) {
+    const float scale = p.out_scale / row_sum[r];
+    const float* a = acc + r * p.Dv;
+    float* o = p.out + static_cast<int64_t>(r) * p.Dv;
+    for (int c = 0; c < p.Dv; ++c) o[c] = a[c] * scale;
+  }
+}
+
+}  // namespace
+
+int64_t attention_fp32_workspace_size(int batch, int S, int D, int Dv) {
+  const int work_size = batch * div_up(S, kQc);
+  const int tasks =
+      std::max(1, std::min(ThreadPool::CurrentThreadNum(), work_size));
+  return attention_scratch_size(D, Dv) * tasks * sizeof(float);
+}
+
+void attention_fp32(int batch,
+                    int S,
+                    int Sk,
+                    int D,
+                    int Dv,
+                    const float* Q,
+                    int64_t q_stride,
+                    const float* K,
+                    int64_t k_stride,
+                    bool trans_K,
+                    const float* V,
+                    int64_t v_stride,
+                    const AttentionMask& mask,
+                    float alpha,
+                    float out_scale,
+                    float* out) {
+  const bool use_avx2 = avx2_available();
+  const int row_blocks = div_up(S, kQc);
+  const int work_size = batch * row_blocks;
+  const int tasks =
+      std::max(1, std::min(ThreadPool::CurrentThreadNum(), work_size));
+  const int64_t scratch_size = attention_scratch_size(D, Dv);
+
+  auto& workspace = WorkSpace::Global_X86();
+  size_t workspace_mark = workspace.cursor();
+  float* scratch = workspace.Alloc<float>(scratch_size * tasks);
+  LITE_PARALLEL_BEGIN(t, tid, tasks) {
+    float* task_scratch = scratch + t * scratch_size;
+    for (int w = t; w < work_size; w += tasks) {
+      const int b = w / row_blocks;
+      const int i0 = (w % row_blocks) * kQc;
+      AttentionRows p;
+      p.S = S;
+      p.Sk = Sk;
+      p.D = D;
+      p.Dv = Dv;
+      p.Q = Q + b * q_stride + static_cast<int64_t>(i0) * D;
+      p.K = K + b * k_stride;
+      p.trans_K = trans_K;
+      p.V = V + b * v_stride;
+      p.mask = mask.data ? mask.data + mask.offsets[b] + i0 * mask.row_stride
+                         : nullptr;
+      p.mask_row_stride = mask.row_stride;
+      p.mask_col_stride = mask.col_stride;
+      p.alpha = alpha;
+      p.out_scale = out_scale;
+      p.out = out + (static_cast<int64_t>(b) * S + i0) * Dv;
+      attention_rows(p, std::min(kQc, S - i0), use_avx2, task_scratch);
+    }
+  }
+  LITE_PARALLEL_END();
+  workspace.Rewind(workspace_mark);
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
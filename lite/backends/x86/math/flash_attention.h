@@ -0,0 +1,70 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Where the mask of a batch of attention_fp32 is read: the scores of row i
+// and column j of batch b add mask[offsets[b] + i * row_stride + j *
+// col_stride], a stride being 0 along a broadcast dimension.
+struct AttentionMask {
+  const float* data{nullptr};
+  const int64_t* offsets{nullptr};
+  int64_t row_stride{0};
+  int64_t col_stride{0};
+};
+
+// The bytes of the workspace taken by attention_fp32.
+int64_t attention_fp32_workspace_size(int batch, int S, int D, int Dv);
+
+/*
+ * out = softmax(alpha * Q * K^T + mask) * V * out_scale of `batch`
+ * attentions, the softmax taken along the rows.
+ *
+ * Q is S x D, K is Sk x D, or D x Sk if !trans_K, V is Sk x Dv and out is
+ * S x Dv, all row major, and the i-th attention reads Q + i * q_stride, etc,
+ * a stride of 0 broadcasting the matrix. mask.data may be null.
+ *
+ * The keys are streamed by blocks and the softmax is computed online: every
+ * row keeps its running maximum and sum, and its partial output is rescaled
+ * when the maximum grows, so the S x Sk scores are never stored. The work is
+ * split across the threads by blocks of query rows.
+ */
+void attention_fp32(int batch,
+                    int S,
+                    int Sk,
+                    int D,
+                    int Dv,
+                    const float* Q,
+                    int64_t q_stride,
+                    const float* K,
+                    int64_t k_stride,
+                    bool trans_K,
+                    const float* V,
+                    int64_t v_stride,
+                    const AttentionMask& mask,
+                    float alpha,
+                    float out_scale,
+                    float* out);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,117 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/gelu_fp32.h"
+#include <algorithm>
+#include <cmath>
+#include "lite/backends/x86/math/vector_math_avx2.h"
+#include "lite/core/parallel_defines.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The elements of a task.
+const int64_t kTaskSize = 16384;
+
+//****************************** reference ***********************************
+void gelu_ref(const float* x, float* y, int64_t size, bool approximate) {
+  for (int64_t i = 0; i < size; ++i) {
+    const float v = x[i];
+    if (approximate) {
+      const float u = 0.7978845608028654f * (v + 0.044715f * v * v * v);
+      y[i] = 0.5f * v * (1.f + std::tanh(u));
+    } else {
+      y[i] = 0.5f * v * (1.f + std::erf(v * 0.7071067811865476f));
+    }
+  }
+}
+
+//******************************** AVX2 **************************************
+// erf(x) = 1 - t * (a1 + t * (a2 + ... + t * a5)) * exp(-x^2) of x >= 0,
+// t = 1 / (1 + p * x), and erf(-x) = -erf(x).
+X86_TARGET_AVX2 inline __m256 erf_avx2(__m256 x) {
+  const __m256 sign_mask = _mm256_set1_ps(-0.f);
+  __m256 sign = _mm256_and_ps(x, sign_mask);
+  __m256 ax = _mm256_andnot_ps(sign_mask, x);
+  __m256 one = _mm256_set1_ps(1.f);
+  __m256 t = _mm256_div_ps(
+      one, _mm256_fmadd_ps(_mm256_set1_ps(0.3275911f), ax, one));
+  __m256 p = _mm256_set1_ps(1.061405429f);
+  p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(-1.453152027f));
+  p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(1.421413741f));
+  p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(-0.284496736f));
+  p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(0.254829592f));
+  p = _mm256_mul_ps(p, t);
+  __m256 e = exp_avx2(_mm256_mul_ps(_mm256_xor_ps(ax, sign_mask), ax));
+  return _mm256_or_ps(_mm256_fnmadd_ps(p, e, one), sign);
+}
+
+X86_TARGET_AVX2 inline __m256 gelu_vec_avx2(__m256 x, bool approximate) {
+  if (approximate) {
+    // 0.5 * x * (1 + tanh(u)) = x - x / (exp(2 * u) + 1).
+    __m256 x3 = _mm256_mul_ps(_mm256_mul_ps(x, x), x);
+    __m256 u2 = _mm256_mul_ps(
+        _mm256_fmadd_ps(_mm256_set1_ps(0.044715f), x3, x),
+        _mm256_set1_ps(1.5957691216057308f));
+    __m256 d = _mm256_add_ps(exp_avx2(u2), _mm256_set1_ps(1.f));
+    return _mm256_sub_ps(x, _mm256_div_ps(x, d));
+  }
+  __m256 half_x = _mm256_mul_ps(x, _mm256_set1_ps(0.5f));
+  __m256 erf = erf_avx2(_mm256_mul_ps(x, _mm256_set1_ps(0.7071067811865476f)));
+  return _mm256_fmadd_ps(half_x, erf, half_x);
+}
+
+X86_TARGET_AVX2 void gelu_avx2(const float* x,
+                               float* y,
+                               int64_t size,
+                               bool approximate) {
+  int64_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    _mm256_storeu_ps(y + i, gelu_vec_avx2(_mm256_loadu_ps(x + i), approximate));
+  }
+  if (i < size) {
+    __m256i mask = tail_mask_avx2(static_cast<int>(size - i));
+    __m256 v = _mm256_maskload_ps(x + i, mask);
+    _mm256_maskstore_ps(y + i, mask, gelu_vec_avx2(v, approximate));
+  }
+}
+
+}  // namespace
+
+void gelu_fp32(const float* x, float* y, int64_t size, bool approximate) {
+  const bool use_avx2 = avx2_available();
+  const int tasks = static_cast<int>(std::max<int64_t>(
+      1, std::min<int64_t>(ThreadPool::CurrentThreadNum(), size / kTaskSize)));
+  LITE_PARALLEL_BEGIN(t, tid, tasks) {
+    // Every task but the last takes a multiple of 8 elements.
+    const int64_t chunk = (size / tasks + 7) / 8 * 8;
+    const int64_t begin = std::min(size, chunk * t);
+    const int64_t end = t == tasks - 1 ? size : std::min(size, begin + chunk);
+    if (use_avx2) {
+      gelu_avx2(x + begin, y + begin, end - begin, approximate);
+    } else {
+      gelu_ref(x + begin, y + begin, end - begin, approximate);
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,37 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * y = 0.5 * x * (1 + erf(x / sqrt(2))), or its tanh approximation,
+ * 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))), if approximate.
+ *
+ * erf is the polynomial of Abramowitz and Stegun 7.1.26, within 1.5e-7 of
+ * erf, and tanh is taken from exp, both on 8 floats at a time. The elements
+ * are split across the threads.
+ */
+void gelu_fp32(const float* x, float* y, int64_t size, bool approximate);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,639 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "lite/backends/x86/math/gemm_bf16.h"
+#include <immintrin.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/math/packed_weight.h"
+#include "lite/core/parallel_defines.h"
+#include "lite/core/workspace.h"
+#include "lite/utils/log/cp_logging.h"
+
+// The kernels are built for their instruction sets whatever the flags of the
+// library are, and picked at runtime. AVX512-BF16 needs gcc 10 or clang 9,
+// AMX gcc 11 or clang 12.
+#if defined(_MSC_VER)
+#define GEMM_TARGET_AVX512
+#define GEMM_BF16_NATIVE 0
+#define GEMM_BF16_AMX 0
+#else
+#define GEMM_TARGET_AVX512 __attribute__((target("avx512f")))
+#define GEMM_TARGET_BF16 __attribute__((target("avx512f,avx512bf16")))
+#define GEMM_TARGET_AMX \
+  __attribute__((target("avx512f,avx512bf16,amx-tile,amx-bf16")))
+#if defined(__clang__)
+#define GEMM_BF16_NATIVE (__clang_major__ >= 9)
+#define GEMM_BF16_AMX (__clang_major__ >= 12)
+#else
+#define GEMM_BF16_NATIVE (__GNUC__ >= 10)
+#define GEMM_BF16_AMX (__GNUC__ >= 11)
+#endif
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The rows of C and the panels of B of the register tile of the kernels.
+const int kMr = 12;
+const int kNp = 2;
+// A task of the threads computes kMc rows and at most kNc columns of C.
+const int kMc = 96;
+const int kNc = 256;
+
+inline int div_up(int a, int b) { return (a + b - 1) / b; }
+
+inline int padded_K(int K) { return div_up(K, 32) * 32; }
+
+inline uint32_t load_pair(const bfloat16* p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline bfloat16 to_bf16(float v) { return bfloat16(v); }
+inline bfloat16 to_bf16(bfloat16 v) { return v; }
+
+bool avx512_available() {
+#ifdef __AVX512F__
+  return true;
+#else
+  static const bool available = MayIUse(avx512f);
+  return available;
+#endif
+}
+
+bool avx512_bf16_available() {
+#if !GEMM_BF16_NATIVE
+  return false;
+#elif defined(__AVX512BF16__)
+  return true;
+#else
+  static const bool available = MayIUse(avx512_core_bf16);
+  return available;
+#endif
+}
+
+bool amx_available() {
+#if !GEMM_BF16_AMX
+  return false;
+#elif defined(__AMX_BF16__)
+  static const bool available = avx512_bf16_available() && RequestAmxTileData();
+  return available;
+#else
+  static const bool available = MayIUse(amx_bf16);
+  return available;
+#endif
+}
+
+GemmBf16Isa gemm_bf16_select_isa() {
+  if (amx_available()) return GemmBf16Isa::kAmx;
+  if (avx512_bf16_available()) return GemmBf16Isa::kAvx512Bf16;
+  if (avx512_available()) return GemmBf16Isa::kAvx512;
+  return GemmBf16Isa::kFp32;
+}
+
+// The fp32 bits of v rounded to the nearest bf16, in their upper 16 bits.
+GEMM_TARGET_AVX512 inline __m512i round_bf16(__m512 v) {
+  const __m512i bits = _mm512_castps_si512(v);
+  const __m512i lsb =
+      _mm512_and_si512(_mm512_srli_epi32(bits, 16), _mm512_set1_epi32(1));
+  const __m512i r =
+      _mm512_add_epi32(bits, _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7fff)));
+  const __mmask16 nan = _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+  return _mm512_mask_mov_epi32(
+      r, nan, _mm512_or_si512(bits, _mm512_set1_epi32(0x400000)));
+}
+
+GEMM_TARGET_AVX512 int64_t fp32_to_bf16_avx512(const float* din,
+                                               bfloat16* dout,
+                                               int64_t size) {
+  int64_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m512i r = _mm512_srli_epi32(round_bf16(_mm512_loadu_ps(din + i)), 16);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dout + i),
+                        _mm512_cvtepi32_epi16(r));
+  }
+  return i;
+}
+
+GEMM_TARGET_AVX512 int64_t bf16_to_fp32_avx512(const bfloat16* din,
+                                               float* dout,
+                                               int64_t size) {
+  int64_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(din + i));
+    __m512i r = _mm512_slli_epi32(_mm512_cvtepu16_epi32(v), 16);
+    _mm512_storeu_ps(dout + i, _mm512_castsi512_ps(r));
+  }
+  return i;
+}
+
+inline void convert_row(const float* din, bfloat16* dout, int size) {
+  fp32_to_bf16(din, dout, size);
+}
+
+inline void convert_row(const bfloat16* din, bfloat16* dout, int size) {
+  memcpy(dout, din, size * sizeof(bfloat16));
+}
+
+// A panel of 16 columns of a row major float B, cols of them valid.
+GEMM_TARGET_AVX512 void pack_B_panel_avx512(
+    const float* B, int ldb, int K, int Kp, int cols, bfloat16* dout) {
+  const __mmask16 mask = cols >= 16 ? 0xffff : (1u << cols) - 1;
+  const __m512i lo_mask = _mm512_set1_epi32(0xffff);
+  const __m512 vzero = _mm512_setzero_ps();
+  for (int k = 0; k < Kp; k += 2) {
+    __m512 v0 = k < K ? _mm512_maskz_loadu_ps(mask, B + k * ldb) : vzero;
+    __m512 v1 =
+        k + 1 < K ? _mm512_maskz_loadu_ps(mask, B + (k + 1) * ldb) : vzero;
+    __m512i r = _mm512_or_si512(_mm512_srli_epi32(round_bf16(v0), 16),
+                                _mm512_andnot_si512(lo_mask, round_bf16(v1)));
+    _mm512_storeu_si512(dout + k * 16, r);
+  }
+}
+
+bool pack_B_panel_fast(
+    const float* B, int ldb, int K, int Kp, int cols, bfloat16* dout) {
+  if (!avx512_available()) return false;
+  pack_B_panel_avx512(B, ldb, K, Kp, cols, dout);
+  return true;
+}
+
+bool pack_B_panel_fast(
+    const bfloat16* B, int ldb, int K, int Kp, int cols, bfloat16* dout) {
+  return false;
+}
+
+// The kernels compute MR rows and NP panels of C, cols of the columns being
+// valid. A is read from MR rows of Kp bf16 and B from NP panels panel_size
+// bf16 apart.
+typedef void (*GemmBf16Kernel)(int Kp,
+                               const bfloat16* A,
+                               const bfloat16* B,
+                               int64_t panel_size,
+                               float* C,
+                               int ldc,
+                               int cols);
+
+#define GEMM_BF16_KERNELS(kernel)                                       \
+  {                                                                     \
+    {kernel<1, 1>, kernel<1, 2>}, {kernel<2, 1>, kernel<2, 2>},         \
+        {kernel<3, 1>, kernel<3, 2>}, {kernel<4, 1>, kernel<4, 2>},     \
+        {kernel<5, 1>, kernel<5, 2>}, {kernel<6, 1>, kernel<6, 2>},     \
+        {kernel<7, 1>, kernel<7, 2>}, {kernel<8, 1>, kernel<8, 2>},     \
+        {kernel<9, 1>, kernel<9, 2>}, {kernel<10, 1>, kernel<10, 2>},   \
+        {kernel<11, 1>, kernel<11, 2>}, {kernel<12, 1>, kernel<12, 2>}, \
+  }
+
+template <int MR, int NP>
+void kernel_fp32(int Kp,
+                 const bfloat16* A,
+                 const bfloat16* B,
+                 int64_t panel_size,
+                 float* C,
+                 int ldc,
+                 int cols) {
+  float acc[MR][NP * 16];
+  memset(acc, 0, sizeof(acc));
+  for (int k = 0; k < Kp; k += 2) {
+    for (int i = 0; i < MR; ++i) {
+      const float a0 = static_cast<float>(A[i * Kp + k]);
+      const float a1 = static_cast<float>(A[i * Kp + k + 1]);
+      for (int p = 0; p < NP; ++p) {
+        const bfloat16* b = B + p * panel_size + k * 16;
+        for (int j = 0; j < 16; ++j) {
+          acc[i][p * 16 + j] += a0 * static_cast<float>(b[2 * j]) +
+                                a1 * static_cast<float>(b[2 * j + 1]);
+        }
+      }
+    }
+  }
+  for (int i = 0; i < MR; ++i) {
+    memcpy(C + i * ldc, acc[i], cols * sizeof(float));
+  }
+}
+
+// The rows of the AVX-512 kernels are unrolled, those past MR and the second
+// panel if NP is 1 are cut at compile time.
+#define BF16_ROWS(OP) \
+  OP(0) OP(1) OP(2) OP(3) OP(4) OP(5) OP(6) OP(7) OP(8) OP(9) OP(10) OP(11)
+
+#define BF16_INIT_ROW(i)                \
+  __m512 c##i##0 = _mm512_setzero_ps(); \
+  __m512 c##i##1 = _mm512_setzero_ps();
+
+#define BF16_STORE_ROW(i)                                     \
+  if (MR > i) {                                               \
+    if (NP > 1) {                                             \
+      _mm512_storeu_ps(C + i * ldc, c##i##0);                 \
+      _mm512_mask_storeu_ps(C + i * ldc + 16, mask, c##i##1); \
+    } else {                                                  \
+      _mm512_mask_storeu_ps(C + i * ldc, mask, c##i##0);      \
+    }                                                         \
+  }
+
+// The mask of the valid columns of the last panel.
+#define BF16_STORE_MASK                  \
+  const int last = cols - (NP - 1) * 16; \
+  const __mmask16 mask = last >= 16 ? 0xffff : (1u << last) - 1;
+
+// AVX-512F: the bf16 of the even and the odd rows of B are shifted into
+// fp32 and multiplied by fma.
+#define AVX512_FMA_ROW(i)                                            \
+  if (MR > i) {                                                      \
+    pair = load_pair(A + i * Kp + k);                                \
+    a0 = _mm512_castsi512_ps(_mm512_set1_epi32(pair << 16));         \
+    a1 = _mm512_castsi512_ps(_mm512_set1_epi32(pair & 0xffff0000u)); \
+    c##i##0 = _mm512_fmadd_ps(a0, b00, c##i##0);                     \
+    c##i##0 = _mm512_fmadd_ps(a1, b01, c##i##0);                     \
+    if (NP > 1) {                                                    \
+      c##i##1 = _mm512_fmadd_ps(a0, b10, c##i##1);                   \
+      c##i##1 = _mm512_fmadd_ps(a1, b11, c##i##1);                   \
+    }                                                                \
+  }
+
+template <int MR, int NP>
+GEMM_TARGET_AVX512 void kernel_avx512(int Kp,
+                                      const bfloat16* A,
+                                      const bfloat16* B,
+                                      int64_t panel_size,
+                                      float* C,
+                                      int ldc,
+                                      int cols) {
+  BF16_ROWS(BF16_INIT_ROW)
+  const __m512i hi_mask = _mm512_set1_epi32(0xffff0000);
+  __m512 a0, a1, b00, b01, b10, b11;
+  uint32_t pair;
+  for (int k = 0; k < Kp; k += 2) {
+    __m512i b = _mm512_loadu_si512(B + k * 16);
+    b00 = _mm512_castsi512_ps(_mm512_slli_epi32(b, 16));
+    b01 = _mm512_castsi512_ps(_mm512_and_si512(b, hi_mask));
+    if (NP > 1) {
+      b = _mm512_loadu_si512(B + panel_size + k * 16);
+      b10 = _mm512_castsi512_ps(_mm512_slli_epi32(b, 16));
+      b11 = _mm512_castsi512_ps(_mm512_and_si512(b, hi_mask));
+    }
+    BF16_ROWS(AVX512_FMA_ROW)
+  }
+  BF16_STORE_MASK
+  BF16_ROWS(BF16_STORE_ROW)
+}
+
+const GemmBf16Kernel kKernelsFp32[kMr][kNp] = GEMM_BF16_KERNELS(kernel_fp32);
+const GemmBf16Kernel kKernelsAvx512[kMr][kNp] =
+    GEMM_BF16_KERNELS(kernel_avx512);
+
+#if GEMM_BF16_NATIVE
+// AVX512-BF16: vdpbf16ps adds the products of a pair of rows at once.
+#define AVX512_BF16_DP_ROW(i)                                   \
+  if (MR > i) {                                                 \
+    a = (__m512bh)_mm512_set1_epi32(load_pair(A + i * Kp + k)); \
+    c##i##0 = _mm512_dpbf16_ps(c##i##0, a, b0);                 \
+    if (NP > 1) c##i##1 = _mm512_dpbf16_ps(c##i##1, a, b1);     \
+  }
+
+template <int MR, int NP>
+GEMM_TARGET_BF16 void kernel_avx512_bf16(int Kp,
+                                         const bfloat16* A,
+                                         const bfloat16* B,
+                                         int64_t panel_size,
+                                         float* C,
+                                         int ldc,
+                                         int cols) {
+  BF16_ROWS(BF16_INIT_ROW)
+  __m512bh a, b0, b1;
+  for (int k = 0; k < Kp; k += 2) {
+    b0 = (__m512bh)_mm512_loadu_si512(B + k * 16);
+    if (NP > 1) {
+      b1 = (__m512bh)_mm512_loadu_si512(B + panel_size + k * 16);
+    }
+    BF16_ROWS(AVX512_BF16_DP_ROW)
+  }
+  BF16_STORE_MASK
+  BF16_ROWS(BF16_STORE_ROW)
+}
+
+const GemmBf16Kernel kKernelsAvx512Bf16[kMr][kNp] =
+    GEMM_BF16_KERNELS(kernel_avx512_bf16);
+#endif  // GEMM_BF16_NATIVE
+
+#if GEMM_BF16_AMX
+struct AmxTileConfig {
+  uint8_t palette_id;
+  uint8_t start_row;
+  uint8_t reserved[14];
+  uint16_t colsb[16];
+  uint8_t rows[16];
+};
+
+// tmm0 and tmm1 hold 16 x 16 floats of C, tmm2 16 rows x 32 bf16 of A,
+// tmm3 and tmm4 16 pairs of rows of two panels of B, 64 bytes a row each.
+GEMM_TARGET_AMX void amx_configure() {
+  alignas(64) AmxTileConfig config;
+  memset(&config, 0, sizeof(config));
+  config.palette_id = 1;
+  for (int t = 0; t < 5; ++t) {
+    config.rows[t] = 16;
+    config.colsb[t] = 64;
+  }
+  // _tile_loadconfig of gcc 11 and 12 declares only 8 bytes of the config as
+  // read, so the stores above may be dropped. Pass all 64 of them.
+  asm volatile("ldtilecfg %0" : : "m"(config));
+}
+
+GEMM_TARGET_AMX void amx_release() { _tile_release(); }
+
+// 16 rows of C and one or two panels of B.
+GEMM_TARGET_AMX void kernel_amx(int Kp,
+                                const bfloat16* A,
+                                const bfloat16* B,
+                                int64_t panel_size,
+                                int panels,
+                                float* C,
+                                int ldc,
+                                int cols) {
+  alignas(64) float tile[16 * 32];
+  const bool direct = cols == panels * 16;
+  float* c = direct ? C : tile;
+  const int ldc_c = direct ? ldc : 32;
+  _tile_zero(0);
+  _tile_zero(1);
+  for (int k = 0; k < Kp; k += 32) {
+    _tile_loadd(2, A + k, Kp * sizeof(bfloat16));
+    _tile_loadd(3, B + k * 16, 64);
+    _tile_dpbf16ps(0, 2, 3);
+    if (panels == 2) {
+      _tile_loadd(4, B + panel_size + k * 16, 64);
+      _tile_dpbf16ps(1, 2, 4);
+    }
+  }
+  _tile_stored(0, c, ldc_c * sizeof(float));
+  if (panels == 2) {
+    _tile_stored(1, c + 16, ldc_c * sizeof(float));
+  }
+  if (!direct) {
+    for (int i = 0; i < 16; ++i) {
+      memcpy(C + i * ldc, tile + i * 32, cols * sizeof(float));
+    }
+  }
+}
+#endif  // GEMM_BF16_AMX
+
+// The rows [m0, m_end) and the columns [n0, n_end) of C, n0 is a multiple of
+// 16 * kNp.
+void gemm_bf16_block(GemmBf16Isa isa,
+                     int Kp,
+                     const bfloat16* packed_A,
+                     const bfloat16* packed_B,
+                     float* C,
+                     int ldc,
+                     int m0,
+                     int m_end,
+                     int n0,
+                     int n_end) {
+  const int64_t panel_size = static_cast<int64_t>(Kp) * 16;
+  int m_tail = m0;
+#if GEMM_BF16_AMX
+  // The blocks of 16 rows on the tiles, the rows left on AVX512-BF16.
+  if (isa == GemmBf16Isa::kAmx) {
+    m_tail = m0 + (m_end - m0) / 16 * 16;
+    if (m_tail > m0) {
+      amx_configure();
+      for (int n = n0; n < n_end; n += 32) {
+        const int cols = std::min(32, n_end - n);
+        for (int m = m0; m < m_tail; m += 16) {
+          kernel_amx(Kp,
+                     packed_A + static_cast<int64_t>(m) * Kp,
+                     packed_B + (n / 16) * panel_size,
+                     panel_size,
+                     div_up(cols, 16),
+                     C + static_cast<int64_t>(m) * ldc + n,
+                     ldc,
+                     cols);
+        }
+      }
+      amx_release();
+    }
+    isa = GemmBf16Isa::kAvx512Bf16;
+  }
+#endif
+  const GemmBf16Kernel(*kernels)[kNp] = kKernelsFp32;
+  if (isa == GemmBf16Isa::kAvx512) {
+    kernels = kKernelsAvx512;
+  }
+#if GEMM_BF16_NATIVE
+  if (isa == GemmBf16Isa::kAvx512Bf16) {
+    kernels = kKernelsAvx512Bf16;
+  }
+#endif
+  for (int n = n0; n < n_end; n += 16 * kNp) {
+    const int cols = std::min(16 * kNp, n_end - n);
+    // A panel pair of B is reused by all the rows of the block in L2.
+    for (int m = m_tail; m < m_end; m += kMr) {
+      const int rows = std::min(kMr, m_end - m);
+      kernels[rows - 1][div_up(cols, 16) - 1](
+          Kp,
+          packed_A + static_cast<int64_t>(m) * Kp,
+          packed_B + (n / 16) * panel_size,
+          panel_size,
+          C + static_cast<int64_t>(m) * ldc + n,
+          ldc,
+          cols);
+    }
+  }
+}
+
+}  // namespace
+
+GemmBf16Isa gemm_bf16_isa() {
+  static const GemmBf16Isa isa = gemm_bf16_select_isa();
+  return isa;
+}
+
+void fp32_to_bf16(const float* din, bfloat16* dout, int64_t size) {
+  int64_t i = avx512_available() ? fp32_to_bf16_avx512(din, dout, size) : 0;
+  for (; i < size; ++i) dout[i] = bfloat16(din[i]);
+}
+
+void bf16_to_fp32(const bfloat16* din, float* dout, int64_t size) {
+  int64_t i = avx512_available() ? bf16_to_fp32_avx512(din, dout, size) : 0;
+  for (; i < size; ++i) dout[i] = static_cast<float>(din[i]);
+}
+
+int64_t gemm_bf16_packed_A_size(int M, int K) {
+  return static_cast<int64_t>(M) * padded_K(K);
+}
+
+int64_t gemm_bf16_packed_B_size(int K, int N) {
+  return static_cast<int64_t>(div_up(N, 16)) * 16 * padded_K(K);
+}
+
+template <typename T>
+void gemm_bf16_pack_A(
+    bool is_trans_A, int M, int K, const T* A, int lda, bfloat16* packed_A) {
+  const int Kp = padded_K(K);
+  LITE_PARALLEL_BEGIN(m, tid, M) {
+    bfloat16* dout = packed_A + static_cast<int64_t>(m) * Kp;
+    if (is_trans_A) {
+      for (int k = 0; k < K; ++k) dout[k] = to_bf16(A[k * lda + m]);
+    } else {
+      convert_row(A + static_cast<int64_t>(m) * lda, dout, K);
+    }
+    memset(dout + K, 0, (Kp - K) * sizeof(bfloat16));
+  }
+  LITE_PARALLEL_END();
+}
+
+template <typename T>
+void gemm_bf16_pack_B(
+    bool is_trans_B, int K, int N, const T* B, int ldb, bfloat16* packed_B) {
+  const int Kp = padded_K(K);
+  LITE_PARALLEL_BEGIN(p, tid, div_up(N, 16)) {
+    const int n0 = p * 16;
+    const int cols = std::min(16, N - n0);
+    bfloat16* dout = packed_B + static_cast<int64_t>(p) * 16 * Kp;
+    if (is_trans_B || !pack_B_panel_fast(B + n0, ldb, K, Kp, cols, dout)) {
+      memset(dout, 0, 16 * Kp * sizeof(bfloat16));
+      for (int k = 0; k < K; ++k) {
+        for (int j = 0; j < cols; ++j) {
+          const T v = is_trans_B ? B[(n0 + j) * ldb + k] : B[k * ldb + n0 + j];
+          dout[(k / 2) * 32 + j * 2 + k % 2] = to_bf16(v);
+        }
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+template void gemm_bf16_pack_A<float>(
+    bool, int, int, const float*, int, bfloat16*);
+template void gemm_bf16_pack_A<bfloat16>(
+    bool, int, int, const bfloat16*, int, bfloat16*);
+template void gemm_bf16_pack_B<float>(
+    bool, int, int, const float*, int, bfloat16*);
+template void gemm_bf16_pack_B<bfloat16>(
+    bool, int, int, const bfloat16*, int, bfloat16*);
+
+void gemm_bf16_pack_B(const lite::Tensor& W,
+                      bool is_trans_W,
+                      int K,
+                      int N,
+                      int ldw,
+                      bfloat16* packed_W) {
+  if (W.precision() == PRECISION(kBF16)) {
+    gemm_bf16_pack_B(is_trans_W, K, N, W.data<bfloat16>(), ldw, packed_W);
+  } else {
+    CHECK(W.precision() == PRECISION(kFloat))
+        << "the bf16 gemm takes a float or bf16 weight, not "
+        << PrecisionToStr(W.precision());
+    gemm_bf16_pack_B(is_trans_W, K, N, W.data<float>(), ldw, packed_W);
+  }
+}
+
+std::shared_ptr<const lite::Tensor> gemm_bf16_pack_persistable_B(
+    const lite::Tensor& W, bool is_trans_W, int K, int N, int ldw) {
+  if (!W.persistable()) return nullptr;
+  std::string layout = "bf16_B," + std::to_string(is_trans_W) + "," +
+                       std::to_string(K) + "," + std::to_string(N) + "," +
+                       std::to_string(ldw);
+  return SharePackedWeight(W.raw_data(), layout, [&](lite::Tensor* packed) {
+    packed->Resize({gemm_bf16_packed_B_size(K, N)});
+    gemm_bf16_pack_B(
+        W, is_trans_W, K, N, ldw, packed->mutable_data<bfloat16>());
+  });
+}
+
+void gemm_bf16_packed(int M,
+                      int N,
+                      int K,
+                      const bfloat16* packed_A,
+                      const bfloat16* packed_B,
+                      float* C,
+                      int ldc,
+                      GemmBf16Isa isa) {
+  if (M <= 0 || N <= 0) return;
+  CHECK(isa <= gemm_bf16_isa()) << "the bf16 kernels are not supported";
+  const int Kp = padded_K(K);
+  const int m_blocks = div_up(M, kMc);
+  // Cut the columns finer if there are fewer blocks than threads.
+  int nc = kNc;
+  const int threads = ThreadPool::CurrentThreadNum();
+  if (m_blocks * div_up(N, nc) < threads) {
+    nc = div_up(div_up(N, div_up(threads, m_blocks)), 16 * kNp) * 16 * kNp;
+  }
+  const int n_blocks = div_up(N, nc);
+  LITE_PARALLEL_BEGIN(t, tid, m_blocks * n_blocks) {
+    const int m0 = (t % m_blocks) * kMc;
+    const int n0 = (t / m_blocks) * nc;
+    gemm_bf16_block(isa,
+                    Kp,
+                    packed_A,
+                    packed_B,
+                    C,
+                    ldc,
+                    m0,
+                    std::min(m0 + kMc, M),
+                    n0,
+                    std::min(n0 + nc, N));
+  }
+  LITE_PARALLEL_END();
+}
+
+void gemm_bf16(bool is_trans_A,
+               int M,
+               int N,
+               int K,
+               const float* A,
+               int lda,
+               const bfloat16* packed_B,
+               float* C,
+               int ldc) {
+  auto& workspace = WorkSpace::Global_X86();
+  size_t workspace_mark = workspace.cursor();
+  bfloat16* packed_A =
+      workspace.Alloc<bfloat16>(gemm_bf16_packed_A_size(M, K));
+  gemm_bf16_pack_A(is_trans_A, M, K, A, lda, packed_A);
+  gemm_bf16_packed(M, N, K, packed_A, packed_B, C, ldc);
+  workspace.Rewind(workspace_mark);
+}
+
+void gemm_bf16_prepacked_A(int M,
+                           int N,
+                           int K,
+                           const bfloat16* packed_A,
+                           bool is_trans_B,
+                           const float* B,
+                           int ldb,
+                           float* C,
+                           int ldc) {
+  auto& workspace = WorkSpace::Global_X86();
+  size_t workspace_mark = workspace.cursor();
+  bfloat16* packed_B =
+      workspace.Alloc<bfloat16>(gemm_bf16_packed_B_size(K, N));
+  gemm_bf16_pack_B(is_trans_B, K, N, B, ldb, packed_B);
+  gemm_bf16_packed(M, N, K, packed_A, packed_B, C, ldc);
+  workspace.Rewind(workspace_mark);
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
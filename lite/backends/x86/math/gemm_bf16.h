@@ -0,0 +1,116 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include "lite/core/tensor.h"
+#include "lite/utils/bfloat16.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * The bf16 gemm, C = A * B with the products of bf16 A and B accumulated in
+ * fp32 into a fp32 C.
+ *
+ * A is packed into M rows of Kp bf16, Kp being K rounded up to 32 by zeros,
+ * and B into panels of 16 columns, [N / 16][Kp / 2][16][2], the two bf16 of
+ * a pair of rows of B being next to each other. The constant operand, the
+ * weight, is packed once and the other one into the workspace on every call.
+ *
+ * The kernels are picked at runtime: the AMX tiles, the dot products of
+ * AVX512-BF16, the AVX-512F emulation which shifts the bf16 into fp32 and
+ * runs fma, and a fp32 loop for the cpus without AVX-512. All of them read
+ * the same packs and differ only by the rounding of the fp32 sums.
+ */
+
+// The kernels of gemm_bf16, each cpu runs those up to the one it supports.
+enum class GemmBf16Isa { kFp32, kAvx512, kAvx512Bf16, kAmx };
+
+// The fastest kernels of the cpu.
+GemmBf16Isa gemm_bf16_isa();
+
+void fp32_to_bf16(const float* din, bfloat16* dout, int64_t size);
+
+void bf16_to_fp32(const bfloat16* din, float* dout, int64_t size);
+
+// The number of bf16 of the packed op(A), M x K, and op(B), K x N.
+int64_t gemm_bf16_packed_A_size(int M, int K);
+int64_t gemm_bf16_packed_B_size(int K, int N);
+
+// Pack op(A) or op(B), rounded to bf16 if T is float. T is float or
+// bfloat16, the matrices are row major.
+template <typename T>
+void gemm_bf16_pack_A(
+    bool is_trans_A, int M, int K, const T* A, int lda, bfloat16* packed_A);
+
+template <typename T>
+void gemm_bf16_pack_B(
+    bool is_trans_B, int K, int N, const T* B, int ldb, bfloat16* packed_B);
+
+// Pack op(W) of a float or bf16 tensor, e.g. a weight converted to bf16 when
+// the model is loaded.
+void gemm_bf16_pack_B(const lite::Tensor& W,
+                      bool is_trans_W,
+                      int K,
+                      int N,
+                      int ldw,
+                      bfloat16* packed_W);
+
+// The persistable weight op(W) packed once as above, nullptr if W is not
+// persistable. The kernels of the cloned predictors share it.
+std::shared_ptr<const lite::Tensor> gemm_bf16_pack_persistable_B(
+    const lite::Tensor& W, bool is_trans_W, int K, int N, int ldw);
+
+// C = A * B of the packed A and B on the kernels of isa, which must not be
+// faster than gemm_bf16_isa().
+void gemm_bf16_packed(int M,
+                      int N,
+                      int K,
+                      const bfloat16* packed_A,
+                      const bfloat16* packed_B,
+                      float* C,
+                      int ldc,
+                      GemmBf16Isa isa = gemm_bf16_isa());
+
+// C = op(A) * B of the prepacked B, e.g. the weight of fc.
+void gemm_bf16(bool is_trans_A,
+               int M,
+               int N,
+               int K,
+               const float* A,
+               int lda,
+               const bfloat16* packed_B,
+               float* C,
+               int ldc);
+
+// C = A * op(B) of the prepacked A, e.g. the weight of conv2d.
+void gemm_bf16_prepacked_A(int M,
+                           int N,
+                           int K,
+                           const bfloat16* packed_A,
+                           bool is_trans_B,
+                           const float* B,
+                           int ldb,
+                           float* C,
+                           int ldc);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
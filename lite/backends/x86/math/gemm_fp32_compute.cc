@@ -0,0 +1,439 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "lite/backends/x86/math/gemm_fp32_compute.h"
+#include <algorithm>
+#include "lite/backends/x86/math/gemm_fp32_kernel.h"
+#include "lite/backends/x86/math/gemm_fp32_pack.h"
+#include "lite/core/parallel_defines.h"
+#include "lite/core/workspace.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The largest mr x nr of the micro-kernels.
+const int kMaxTileSize = 12 * 32;
+
+inline int div_up(int a, int b) { return (a + b - 1) / b; }
+
+// A template rather than a std::function, which would take the captures of
+// the callers from the heap on every call.
+template <typename Func>
+void gemm_for(int work_size, bool parallel, const Func& func) {
+  if (!parallel) {
+    for (int i = 0; i < work_size; ++i) func(i);
+    return;
+  }
+  LITE_PARALLEL_BEGIN(i, tid, work_size) { func(i); }
+  LITE_PARALLEL_END();
+}
+
+void gemm_scale_c(int M, int N, float beta, float* C, int ldc) {
+  for (int i = 0; i < M; ++i) {
+    float* c = C + i * ldc;
+    if (beta == 0.f) {
+      std::fill(c, c + N, 0.f);
+    } else {
+      for (int j = 0; j < N; ++j) c[j] *= beta;
+    }
+  }
+}
+
+// Compute the rows [m0, m_end) and the columns [n0, n_end) of C from the
+// packed panels of a block of kc columns of op(A), m0 and n0 are multiples of
+// mr and nr.
+void gemm_fp32_tile(const GemmFp32Kernel& kern,
+                    int M,
+                    int N,
+                    int kc,
+                    const float* pack_A,
+                    const float* pack_B,
+                    int m0,
+                    int m_end,
+                    int n0,
+                    int n_end,
+                    float beta,
+                    float* C,
+                    int ldc) {
+  const int mr = kern.mr;
+  const int nr = kern.nr;
+  alignas(64) float tile[kMaxTileSize];
+  // A panel of B is reused by all the panels of the A block in L2.
+  for (int n = n0; n < n_end; n += nr) {
+    const float* b = pack_B + (n / nr) * nr * kc;
+    const int cols = std::min(nr, N - n);
+    for (int m = m0; m < m_end; m += mr) {
+      const float* a = pack_A + (m / mr) * mr * kc;
+      const int rows = std::min(mr, M - m);
+      float* c = C + m * ldc + n;
+      if (rows == mr && cols == nr) {
+        kern.run(kc, a, b, c, ldc, beta);
+        continue;
+      }
+      kern.run(kc, a, b, tile, nr, 0.f);
+      for (int i = 0; i < rows; ++i) {
+        const float* t = tile + i * nr;
+        float* out = c + i * ldc;
+        if (beta == 0.f) {
+          for (int j = 0; j < cols; ++j) out[j] = t[j];
+        } else {
+          for (int j = 0; j < cols; ++j) out[j] = t[j] + beta * out[j];
+        }
+      }
+    }
+  }
+}
+
+// The blocks of K of a prepacked B are laid one after the other, the panels
+// of the block at k0 start at k0 * n_panels * nr.
+inline const float* packed_B_block(const GemmFp32Kernel& kern,
+                                   const float* packed_B,
+                                   int N,
+                                   int k0) {
+  return packed_B + static_cast<int64_t>(k0) * div_up(N, kern.nr) * kern.nr;
+}
+
+// C = alpha * op(A) * op(B) + beta * C, op(B) is read from `packed_B` if it is
+// not null.
+void gemm_fp32_impl(const GemmFp32Kernel& kern,
+                    bool is_trans_A,
+                    bool is_trans_B,
+                    int M,
+                    int N,
+                    int K,
+                    float alpha,
+                    const float* A,
+                    int lda,
+                    const float* B,
+                    int ldb,
+                    const float* packed_B,
+                    float beta,
+                    float* C,
+                    int ldc,
+                    bool parallel) {
+  if (M <= 0 || N <= 0) return;
+  if (K <= 0 || alpha == 0.f) {
+    gemm_scale_c(M, N, beta, C, ldc);
+    return;
+  }
+  const int mr = kern.mr;
+  const int nr = kern.nr;
+  const int m_panels = div_up(M, mr);
+  const int n_panels = div_up(N, nr);
+  if (M == 1 && (!is_trans_A || lda == 1)) {
+    // No reuse of B to pack it for, split the columns across the threads.
+    if (packed_B) {
+      gemm_for(n_panels, parallel, [&](int q) {
+        for (int k0 = 0; k0 < K; k0 += kern.kc) {
+          const int kc = std::min(kern.kc, K - k0);
+          kern.run_row(false,
+                       std::min(nr, N - q * nr),
+                       kc,
+                       alpha,
+                       A + k0,
+                       packed_B_block(kern, packed_B, N, k0) + q * nr * kc,
+                       nr,
+                       k0 == 0 ? beta : 1.f,
+                       C + q * nr);
+        }
+      });
+      return;
+    }
+    const int threads = ThreadPool::CurrentThreadNum();
+    const int cols = parallel ? div_up(div_up(N, threads), 64) * 64 : N;
+    gemm_for(div_up(N, cols), parallel, [&](int t) {
+      const int n = t * cols;
+      kern.run_row(is_trans_B,
+                   std::min(cols, N - n),
+                   K,
+                   alpha,
+                   A,
+                   is_trans_B ? B + n * ldb : B + n,
+                   ldb,
+                   beta,
+                   C + n);
+    });
+    return;
+  }
+
+  // Cut C into smaller tiles if there are fewer tiles than threads.
+  int mc = kern.mc;
+  int nc = kern.nc;
+  const int threads = parallel ? ThreadPool::CurrentThreadNum() : 1;
+  if (div_up(M, mc) * div_up(N, nc) < threads) {
+    nc = div_up(div_up(N, div_up(threads, div_up(M, mc))), nr) * nr;
+    if (div_up(M, mc) * div_up(N, nc) < threads) {
+      mc = div_up(div_up(M, div_up(threads, div_up(N, nc))), mr) * mr;
+    }
+  }
+  const int m_blocks = div_up(M, mc);
+  const int n_blocks = div_up(N, nc);
+
+  auto& workspace = WorkSpace::Global_X86();
+  size_t workspace_mark = workspace.cursor();
+  const int kc_max = std::min(K, kern.kc);
+  float* pack_A = workspace.Alloc<float>(m_panels * mr * kc_max);
+  float* pack_B =
+      packed_B ? nullptr : workspace.Alloc<float>(n_panels * nr * kc_max);
+  const int pack_num = packed_B ? m_panels : m_panels + n_panels;
+  for (int k0 = 0; k0 < K; k0 += kern.kc) {
+    const int kc = std::min(kern.kc, K - k0);
+    const float* A_k = is_trans_A ? A + k0 * lda : A + k0;
+    const float* B_k = is_trans_B ? B + k0 : B + k0 * ldb;
+    gemm_for(pack_num, parallel, [&](int p) {
+      if (p < m_panels) {
+        const int m = p * mr;
+        gemm_fp32_packA(is_trans_A,
+                        std::min(mr, M - m),
+                        kc,
+                        alpha,
+                        is_trans_A ? A_k + m : A_k + m * lda,
+                        lda,
+                        mr,
+                        pack_A + p * mr * kc);
+      } else {
+        const int n = (p - m_panels) * nr;
+        gemm_fp32_packB(is_trans_B,
+                        std::min(nr, N - n),
+                        kc,
+                        is_trans_B ? B_k + n * ldb : B_k + n,
+                        ldb,
+                        nr,
+                        pack_B + (p - m_panels) * nr * kc);
+      }
+    });
+    const float* pack_B_k =
+        packed_B ? packed_B_block(kern, packed_B, N, k0) : pack_B;
+    // The later blocks of K accumulate into C.
+    const float block_beta = k0 == 0 ? beta : 1.f;
+    gemm_for(m_blocks * n_blocks, parallel, [&](int t) {
+      const int m0 = (t % m_blocks) * mc;
+      const int n0 = (t / m_blocks) * nc;
+      gemm_fp32_tile(kern,
+                     M,
+                     N,
+                     kc,
+                     pack_A,
+                     pack_B_k,
+                     m0,
+                     std::min(m0 + mc, M),
+                     n0,
+                     std::min(n0 + nc, N),
+                     block_beta,
+                     C,
+                     ldc);
+    });
+  }
+  workspace.Rewind(workspace_mark);
+}
+
+}  // namespace
+
+bool gemm_fp32_available() { return gemm_fp32_select_kernel() != nullptr; }
+
+void gemm_fp32(bool is_trans_A,
+               bool is_trans_B,
+               int M,
+               int N,
+               int K,
+               float alpha,
+               const float* A,
+               int lda,
+               const float* B,
+               int ldb,
+               float beta,
+               float* C,
+               int ldc) {
+  const GemmFp32Kernel* kern = gemm_fp32_select_kernel();
+  CHECK(kern) << "gemm_fp32 needs AVX2 and FMA";
+  gemm_fp32_impl(*kern,
+                 is_trans_A,
+                 is_trans_B,
+                 M,
+                 N,
+                 K,
+                 alpha,
+                 A,
+                 lda,
+                 B,
+                 ldb,
+                 nullptr,
+                 beta,
+                 C,
+                 ldc,
+                 true);
+}
+
+void gemm_fp32_batch(bool is_trans_A,
+                     bool is_trans_B,
+                     int M,
+                     int N,
+                     int K,
+                     float alpha,
+                     const float* A,
+                     int lda,
+                     int64_t stride_A,
+                     const float* B,
+                     int ldb,
+                     int64_t stride_B,
+                     float beta,
+                     float* C,
+                     int ldc,
+                     int64_t stride_C,
+                     int batch) {
+  const GemmFp32Kernel* kern = gemm_fp32_select_kernel();
+  CHECK(kern) << "gemm_fp32 needs AVX2 and FMA";
+  // Small gemms of attention are many, run them side by side.
+  const bool split_batch = batch >= ThreadPool::CurrentThreadNum();
+  gemm_for(batch, split_batch, [&](int i) {
+    gemm_fp32_impl(*kern,
+                   is_trans_A,
+                   is_trans_B,
+                   M,
+                   N,
+                   K,
+                   alpha,
+                   A + i * stride_A,
+                   lda,
+                   B + i * stride_B,
+                   ldb,
+                   nullptr,
+                   beta,
+                   C + i * stride_C,
+                   ldc,
+                   !split_batch);
+  });
+}
+
+int64_t gemm_fp32_workspace_size(int M, int N, int K) {
+  const GemmFp32Kernel* kern = gemm_fp32_select_kernel();
+  if (!kern || M <= 0 || N <= 0 || K <= 0) return 0;
+  const int64_t kc = std::min(K, kern->kc);
+  const int64_t pack_A = div_up(M, kern->mr) * kern->mr * kc * sizeof(float);
+  const int64_t pack_B = div_up(N, kern->nr) * kern->nr * kc * sizeof(float);
+  // Each of them is aligned by the workspace.
+  return pack_A + pack_B + 2 * WorkSpace::kAlignment;
+}
+
+int64_t gemm_fp32_packed_B_size(int N, int K) {
+  const GemmFp32Kernel* kern = gemm_fp32_select_kernel();
+  CHECK(kern) << "gemm_fp32 needs AVX2 and FMA";
+  return static_cast<int64_t>(div_up(N, kern->nr)) * kern->nr * K;
+}
+
+void gemm_fp32_prepack_B(bool is_trans_B,
+                         int N,
+                         int K,
+                         const float* B,
+                         int ldb,
+                         float* packed_B) {
+  const GemmFp32Kernel* kern = gemm_fp32_select_kernel();
+  CHECK(kern) << "gemm_fp32 needs AVX2 and FMA";
+  const int nr = kern->nr;
+  const int n_panels = div_up(N, nr);
+  for (int k0 = 0; k0 < K; k0 += kern->kc) {
+    const int kc = std::min(kern->kc, K - k0);
+    const float* B_k = is_trans_B ? B + k0 : B + k0 * ldb;
+    float* block = packed_B + static_cast<int64_t>(k0) * n_panels * nr;
+    for (int q = 0; q < n_panels; ++q) {
+      const int n = q * nr;
+      gemm_fp32_packB(is_trans_B,
+                      std::min(nr, N - n),
+                      kc,
+                      is_trans_B ? B_k + n * ldb : B_k + n,
+                      ldb,
+                      nr,
+                      block + q * nr * kc);
+    }
+  }
+}
+
+void gemm_fp32_prepacked(bool is_trans_A,
+                         int M,
+                         int N,
+                         int K,
+                         float alpha,
+                         const float* A,
+                         int lda,
+                         const float* packed_B,
+                         float beta,
+                         float* C,
+                         int ldc) {
+  const GemmFp32Kernel* kern = gemm_fp32_select_kernel();
+  CHECK(kern) << "gemm_fp32 needs AVX2 and FMA";
+  gemm_fp32_impl(*kern,
+                 is_trans_A,
+                 false,
+                 M,
+                 N,
+                 K,
+                 alpha,
+                 A,
+                 lda,
+                 nullptr,
+                 0,
+                 packed_B,
+                 beta,
+                 C,
+                 ldc,
+                 true);
+}
+
+void gemm_fp32_prepacked_batch(bool is_trans_A,
+                               int M,
+                               int N,
+                               int K,
+                               float alpha,
+                               const float* A,
+                               int lda,
+                               int64_t stride_A,
+                               const float* packed_B,
+                               int64_t stride_packed_B,
+                               float beta,
+                               float* C,
+                               int ldc,
+                               int64_t stride_C,
+                               int batch) {
+  const GemmFp32Kernel* kern = gemm_fp32_select_kernel();
+  CHECK(kern) << "gemm_fp32 needs AVX2 and FMA";
+  const bool split_batch = batch >= ThreadPool::CurrentThreadNum();
+  gemm_for(batch, split_batch, [&](int i) {
+    gemm_fp32_impl(*kern,
+                   is_trans_A,
+                   false,
+                   M,
+                   N,
+                   K,
+                   alpha,
+                   A + i * stride_A,
+                   lda,
+                   nullptr,
+                   0,
+                   packed_B + i * stride_packed_B,
+                   beta,
+                   C + i * stride_C,
+                   ldc,
+                   !split_batch);
+  });
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
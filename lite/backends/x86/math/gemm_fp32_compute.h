@@ -0,0 +1,123 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * The native sgemm of the builds without MKL.
+ *
+ * For every block of kc columns of op(A), the rows of op(A) are packed into
+ * panels of mr rows and the columns of op(B) into panels of nr columns, then
+ * C is cut into mc x nc tiles which are computed in parallel by the register
+ * tiled micro-kernel picked at runtime, see gemm_fp32_kernel.h. The packed
+ * panels live in the workspace of the calling thread.
+ */
+
+// Whether the cpu runs gemm_fp32, it needs AVX2 and FMA.
+bool gemm_fp32_available();
+
+// C = alpha * op(A) * op(B) + beta * C, all the matrices are row major.
+void gemm_fp32(bool is_trans_A,
+               bool is_trans_B,
+               int M,
+               int N,
+               int K,
+               float alpha,
+               const float* A,
+               int lda,
+               const float* B,
+               int ldb,
+               float beta,
+               float* C,
+               int ldc);
+
+// The most bytes of the workspace gemm_fp32 takes for a M x N x K gemm, to be
+// reserved by the kernels in PrepareForRun().
+int64_t gemm_fp32_workspace_size(int M, int N, int K);
+
+// `batch` gemms of the same shape, the i-th one reads A + i * stride_A and
+// B + i * stride_B and writes C + i * stride_C. A batch at least as large as
+// the thread number is split across the threads, one gemm per thread.
+void gemm_fp32_batch(bool is_trans_A,
+                     bool is_trans_B,
+                     int M,
+                     int N,
+                     int K,
+                     float alpha,
+                     const float* A,
+                     int lda,
+                     int64_t stride_A,
+                     const float* B,
+                     int ldb,
+                     int64_t stride_B,
+                     float beta,
+                     float* C,
+                     int ldc,
+                     int64_t stride_C,
+                     int batch);
+
+// A constant op(B), K x N, e.g. the weight of fc, can be packed once by
+// gemm_fp32_prepack_B into gemm_fp32_packed_B_size(N, K) floats and read by
+// gemm_fp32_prepacked, which only packs A.
+int64_t gemm_fp32_packed_B_size(int N, int K);
+
+void gemm_fp32_prepack_B(bool is_trans_B,
+                         int N,
+                         int K,
+                         const float* B,
+                         int ldb,
+                         float* packed_B);
+
+void gemm_fp32_prepacked(bool is_trans_A,
+                         int M,
+                         int N,
+                         int K,
+                         float alpha,
+                         const float* A,
+                         int lda,
+                         const float* packed_B,
+                         float beta,
+                         float* C,
+                         int ldc);
+
+// `batch` gemms of the same shape on prepacked B, the i-th one reads
+// A + i * stride_A and packed_B + i * stride_packed_B and writes
+// C + i * stride_C. They are split across the threads as in gemm_fp32_batch.
+void gemm_fp32_prepacked_batch(bool is_trans_A,
+                               int M,
+                               int N,
+                               int K,
+                               float alpha,
+                               const float* A,
+                               int lda,
+                               int64_t stride_A,
+                               const float* packed_B,
+                               int64_t stride_packed_B,
+                               float beta,
+                               float* C,
+                               int ldc,
+                               int64_t stride_C,
+                               int batch);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
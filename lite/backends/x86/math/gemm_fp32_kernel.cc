@@ -0,0 +1,254 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "lite/backends/x86/math/gemm_fp32_kernel.h"
+#include <immintrin.h>
+#include "lite/backends/x86/cpu_info.h"
+
+// The kernels are built for their instruction set whatever the flags of the
+// library are, and picked at runtime.
+#if defined(_MSC_VER)
+#define GEMM_TARGET_AVX2
+#define GEMM_TARGET_AVX512
+#else
+#define GEMM_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define GEMM_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+//*************************** AVX2 6x16 kernel *******************************
+#define AVX2_INIT_ROW(i)                 \
+  __m256 c##i##0 = _mm256_setzero_ps(); \
+  __m256 c##i##1 = _mm256_setzero_ps();
+
+#define AVX2_FMA_ROW(i)                      \
+  a = _mm256_broadcast_ss(A + i);            \
+  c##i##0 = _mm256_fmadd_ps(a, b0, c##i##0); \
+  c##i##1 = _mm256_fmadd_ps(a, b1, c##i##1);
+
+#define AVX2_BETA_ROW(i)                                                   \
+  c##i##0 = _mm256_fmadd_ps(vbeta, _mm256_loadu_ps(C + i * ldc), c##i##0); \
+  c##i##1 = _mm256_fmadd_ps(vbeta, _mm256_loadu_ps(C + i * ldc + 8), c##i##1);
+
+#define AVX2_STORE_ROW(i)                 \
+  _mm256_storeu_ps(C + i * ldc, c##i##0); \
+  _mm256_storeu_ps(C + i * ldc + 8, c##i##1);
+
+#define AVX2_ROWS(OP) OP(0) OP(1) OP(2) OP(3) OP(4) OP(5)
+
+GEMM_TARGET_AVX2 void gemm_fp32_kernel_6x16_avx2(
+    int K, const float* A, const float* B, float* C, int ldc, float beta) {
+  AVX2_ROWS(AVX2_INIT_ROW)
+  __m256 a, b0, b1;
+  for (int k = 0; k < K; ++k) {
+    b0 = _mm256_loadu_ps(B);
+    b1 = _mm256_loadu_ps(B + 8);
+    AVX2_ROWS(AVX2_FMA_ROW)
+    A += 6;
+    B += 16;
+  }
+  if (beta != 0.f) {
+    __m256 vbeta = _mm256_set1_ps(beta);
+    AVX2_ROWS(AVX2_BETA_ROW)
+  }
+  AVX2_ROWS(AVX2_STORE_ROW)
+}
+
+//************************* AVX-512 12x32 kernel *****************************
+#define AVX512_INIT_ROW(i)               \
+  __m512 c##i##0 = _mm512_setzero_ps(); \
+  __m512 c##i##1 = _mm512_setzero_ps();
+
+#define AVX512_FMA_ROW(i)                    \
+  a = _mm512_set1_ps(A[i]);                  \
+  c##i##0 = _mm512_fmadd_ps(a, b0, c##i##0); \
+  c##i##1 = _mm512_fmadd_ps(a, b1, c##i##1);
+
+#define AVX512_BETA_ROW(i)                                                 \
+  c##i##0 = _mm512_fmadd_ps(vbeta, _mm512_loadu_ps(C + i * ldc), c##i##0); \
+  c##i##1 =                                                                \
+      _mm512_fmadd_ps(vbeta, _mm512_loadu_ps(C + i * ldc + 16), c##i##1);
+
+#define AVX512_STORE_ROW(i)               \
+  _mm512_storeu_ps(C + i * ldc, c##i##0); \
+  _mm512_storeu_ps(C + i * ldc + 16, c##i##1);
+
+#define AVX512_ROWS(OP) \
+  OP(0) OP(1) OP(2) OP(3) OP(4) OP(5) OP(6) OP(7) OP(8) OP(9) OP(10) OP(11)
+
+GEMM_TARGET_AVX512 void gemm_fp32_kernel_12x32_avx512(
+    int K, const float* A, const float* B, float* C, int ldc, float beta) {
+  AVX512_ROWS(AVX512_INIT_ROW)
+  __m512 a, b0, b1;
+  for (int k = 0; k < K; ++k) {
+    b0 = _mm512_loadu_ps(B);
+    b1 = _mm512_loadu_ps(B + 16);
+    AVX512_ROWS(AVX512_FMA_ROW)
+    A += 12;
+    B += 32;
+  }
+  if (beta != 0.f) {
+    __m512 vbeta = _mm512_set1_ps(beta);
+    AVX512_ROWS(AVX512_BETA_ROW)
+  }
+  AVX512_ROWS(AVX512_STORE_ROW)
+}
+
+//************************* AVX2 one row kernel ******************************
+static GEMM_TARGET_AVX2 float gemm_fp32_dot_avx2(int K,
+                                                 const float* a,
+                                                 const float* b) {
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  int k = 0;
+  for (; k + 16 <= K; k += 16) {
+    sum0 =
+        _mm256_fmadd_ps(_mm256_loadu_ps(a + k), _mm256_loadu_ps(b + k), sum0);
+    sum1 = _mm256_fmadd_ps(
+        _mm256_loadu_ps(a + k + 8), _mm256_loadu_ps(b + k + 8), sum1);
+  }
+  for (; k + 8 <= K; k += 8) {
+    sum0 =
+        _mm256_fmadd_ps(_mm256_loadu_ps(a + k), _mm256_loadu_ps(b + k), sum0);
+  }
+  sum0 = _mm256_add_ps(sum0, sum1);
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(sum0),
+                          _mm256_extractf128_ps(sum0, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_movehdup_ps(sum));
+  float result = _mm_cvtss_f32(sum);
+  for (; k < K; ++k) result += a[k] * b[k];
+  return result;
+}
+
+GEMM_TARGET_AVX2 void gemm_fp32_row_avx2(bool is_trans_B,
+                                         int N,
+                                         int K,
+                                         float alpha,
+                                         const float* A,
+                                         const float* B,
+                                         int ldb,
+                                         float beta,
+                                         float* C) {
+  if (is_trans_B) {
+    for (int j = 0; j < N; ++j) {
+      float sum = alpha * gemm_fp32_dot_avx2(K, A, B + j * ldb);
+      C[j] = beta == 0.f ? sum : sum + beta * C[j];
+    }
+    return;
+  }
+  const __m256 valpha = _mm256_set1_ps(alpha);
+  const __m256 vbeta = _mm256_set1_ps(beta);
+  int j = 0;
+  // 32 columns at a time, B is read row by row.
+  for (; j + 32 <= N; j += 32) {
+    __m256 c0 = _mm256_setzero_ps();
+    __m256 c1 = _mm256_setzero_ps();
+    __m256 c2 = _mm256_setzero_ps();
+    __m256 c3 = _mm256_setzero_ps();
+    const float* b = B + j;
+    for (int k = 0; k < K; ++k, b += ldb) {
+      __m256 a = _mm256_broadcast_ss(A + k);
+      c0 = _mm256_fmadd_ps(a, _mm256_loadu_ps(b), c0);
+      c1 = _mm256_fmadd_ps(a, _mm256_loadu_ps(b + 8), c1);
+      c2 = _mm256_fmadd_ps(a, _mm256_loadu_ps(b + 16), c2);
+      c3 = _mm256_fmadd_ps(a, _mm256_loadu_ps(b + 24), c3);
+    }
+    __m256 out[4] = {c0, c1, c2, c3};
+    for (int i = 0; i < 4; ++i) {
+      out[i] = _mm256_mul_ps(valpha, out[i]);
+      if (beta != 0.f) {
+        out[i] =
+            _mm256_fmadd_ps(vbeta, _mm256_loadu_ps(C + j + i * 8), out[i]);
+      }
+      _mm256_storeu_ps(C + j + i * 8, out[i]);
+    }
+  }
+  for (; j + 8 <= N; j += 8) {
+    __m256 c0 = _mm256_setzero_ps();
+    const float* b = B + j;
+    for (int k = 0; k < K; ++k, b += ldb) {
+      c0 =
+          _mm256_fmadd_ps(_mm256_broadcast_ss(A + k), _mm256_loadu_ps(b), c0);
+    }
+    c0 = _mm256_mul_ps(valpha, c0);
+    if (beta != 0.f) {
+      c0 = _mm256_fmadd_ps(vbeta, _mm256_loadu_ps(C + j), c0);
+    }
+    _mm256_storeu_ps(C + j, c0);
+  }
+  for (; j < N; ++j) {
+    float sum = 0.f;
+    for (int k = 0; k < K; ++k) sum += A[k] * B[k * ldb + j];
+    sum *= alpha;
+    C[j] = beta == 0.f ? sum : sum + beta * C[j];
+  }
+}
+
+#undef AVX2_INIT_ROW
+#undef AVX2_FMA_ROW
+#undef AVX2_BETA_ROW
+#undef AVX2_STORE_ROW
+#undef AVX2_ROWS
+#undef AVX512_INIT_ROW
+#undef AVX512_FMA_ROW
+#undef AVX512_BETA_ROW
+#undef AVX512_STORE_ROW
+#undef AVX512_ROWS
+
+// The row kernel is bound by memory, the AVX2 one serves AVX-512 too.
+static const GemmFp32Kernel kGemmFp32Avx2 = {"avx2_6x16",
+                                             gemm_fp32_kernel_6x16_avx2,
+                                             gemm_fp32_row_avx2,
+                                             6,
+                                             16,
+                                             256,
+                                             144,
+                                             256};
+static const GemmFp32Kernel kGemmFp32Avx512 = {"avx512_12x32",
+                                               gemm_fp32_kernel_12x32_avx512,
+                                               gemm_fp32_row_avx2,
+                                               12,
+                                               32,
+                                               256,
+                                               144,
+                                               384};
+
+const GemmFp32Kernel* gemm_fp32_select_kernel() {
+  static const GemmFp32Kernel* kernel = []() -> const GemmFp32Kernel* {
+#ifdef __AVX512F__
+    return &kGemmFp32Avx512;
+#else
+    if (MayIUse(avx512f)) {
+      return &kGemmFp32Avx512;
+    }
+#if defined(__AVX2__) && defined(__FMA__)
+    return &kGemmFp32Avx2;
+#else
+    // Every cpu with AVX2 has FMA too.
+    return MayIUse(avx2) ? &kGemmFp32Avx2 : nullptr;
+#endif
+#endif
+  }();
+  return kernel;
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
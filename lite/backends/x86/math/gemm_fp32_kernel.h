@@ -0,0 +1,63 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// A micro-kernel computes a tile of mr x nr floats of C from a panel of
+// packed A, K x mr, and a panel of packed B, K x nr:
+//   C = A^T * B + beta * C
+// C is not read if beta is 0.
+typedef void (*gemm_fp32_micro_kernel)(
+    int K, const float* A, const float* B, float* C, int ldc, float beta);
+
+// A gemm of one row, which reads every element of B once and is bound by
+// memory, B is not packed:
+//   C = alpha * A * op(B) + beta * C, A is 1 x K and C is 1 x N.
+typedef void (*gemm_fp32_row_kernel)(bool is_trans_B,
+                                     int N,
+                                     int K,
+                                     float alpha,
+                                     const float* A,
+                                     const float* B,
+                                     int ldb,
+                                     float beta,
+                                     float* C);
+
+struct GemmFp32Kernel {
+  const char* name;
+  gemm_fp32_micro_kernel run;
+  gemm_fp32_row_kernel run_row;
+  // register tile
+  int mr;
+  int nr;
+  // cache blocks: a kc x nr panel of B stays in L1, a mc x kc block of A
+  // stays in L2, a tile of the threads is mc x nc.
+  int kc;
+  int mc;
+  int nc;
+};
+
+// The fastest micro-kernel the cpu runs, AVX-512F 12x32 or AVX2/FMA 6x16,
+// nullptr if the cpu has none of them.
+const GemmFp32Kernel* gemm_fp32_select_kernel();
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,80 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#include "lite/backends/x86/math/gemm_fp32_pack.h"
+#include <string.h>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+void gemm_fp32_packA(bool is_trans,
+                     int rows,
+                     int K,
+                     float alpha,
+                     const float* A,
+                     int lda,
+                     int mr,
+                     float* pack_A) {
+  if (is_trans) {
+    // op(A) is A^T, a column of the panel is a row of A.
+    for (int k = 0; k < K; ++k) {
+      const float* a = A + k * lda;
+      float* out = pack_A + k * mr;
+      for (int r = 0; r < rows; ++r) out[r] = alpha * a[r];
+      for (int r = rows; r < mr; ++r) out[r] = 0.f;
+    }
+    return;
+  }
+  for (int r = 0; r < rows; ++r) {
+    const float* a = A + r * lda;
+    float* out = pack_A + r;
+    for (int k = 0; k < K; ++k) out[k * mr] = alpha * a[k];
+  }
+  for (int r = rows; r < mr; ++r) {
+    for (int k = 0; k < K; ++k) pack_A[k * mr + r] = 0.f;
+  }
+}
+
+void gemm_fp32_packB(bool is_trans,
+                     int cols,
+                     int K,
+                     const float* B,
+                     int ldb,
+                     int nr,
+                     float* pack_B) {
+  if (is_trans) {
+    // op(B) is B^T, a column of the panel is a row of B.
+    for (int c = 0; c < cols; ++c) {
+      const float* b = B + c * ldb;
+      float* out = pack_B + c;
+      for (int k = 0; k < K; ++k) out[k * nr] = b[k];
+    }
+    for (int c = cols; c < nr; ++c) {
+      for (int k = 0; k < K; ++k) pack_B[k * nr + c] = 0.f;
+    }
+    return;
+  }
+  for (int k = 0; k < K; ++k) {
+    float* out = pack_B + k * nr;
+    memcpy(out, B + k * ldb, cols * sizeof(float));
+    if (cols < nr) memset(out + cols, 0, (nr - cols) * sizeof(float));
+  }
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
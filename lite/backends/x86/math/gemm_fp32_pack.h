@@ -0,0 +1,46 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#pragma once
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+// Pack `rows` rows and K columns of alpha * op(A) into a K x mr panel, the
+// rows from `rows` to mr are zero. A points to op(A)(0, 0) of the panel.
+void gemm_fp32_packA(bool is_trans,
+                     int rows,
+                     int K,
+                     float alpha,
+                     const float* A,
+                     int lda,
+                     int mr,
+                     float* pack_A);
+
+// Pack K rows and `cols` columns of op(B) into a K x nr panel, the columns
+// from `cols` to nr are zero. B points to op(B)(0, 0) of the panel.
+void gemm_fp32_packB(bool is_trans,
+                     int cols,
+                     int K,
+                     const float* B,
+                     int ldb,
+                     int nr,
+                     float* pack_B);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -17,8 +17,13 @@ limitations under the License. */
 #include <string.h>
 #include <algorithm>
 #include <cmath>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
 #include "lite/backends/x86/math/gemm_s8u8_kernel.h"
 #include "lite/backends/x86/math/gemm_s8u8_pack.h"
+#include "lite/backends/x86/math/packed_weight.h"
 #include "lite/core/memory.h"
 
 namespace paddle {
@@ -38,8 +43,15 @@ namespace math {
   _Sb = Sb;                      \
   _Sc = Sc;                      \
   _relu_type = relu_type;        \
-  _relu_alpha = relu_alpha;
+  _relu_alpha = relu_alpha;      \
+  _Sb_n = Sb_n;                  \
+  _packed_B = packed_B;
 
+// C = A * B requantized: Sa is the scale of a row of A, Sb the scale of B and
+// Sc the scale of an int8 C. The scale of the column j of B is Sb * Sb_n[j]
+// if Sb_n is given, e.g. the per-channel scales of the weights of fc. bias is
+// added to the rows of C and bias_n to its columns. packed_B is op(B) packed
+// by gemm_s8u8_pack_B, B is then not packed again.
 template <typename TYPE_C>
 class generate_gemm_s8u8_x86_kern {
  public:
@@ -55,9 +67,12 @@ class generate_gemm_s8u8_x86_kern {
                                        const float Sc,
                                        const float *bias,
                                        int relu_type,
-                                       float relu_alpha) {
+                                       float relu_alpha,
+                                       const float *Sb_n = nullptr,
+                                       const float *bias_n = nullptr,
+                                       const uint8_t *packed_B = nullptr) {
     PARAM_INIT
-    gemm_int8_init(M, N, K, bias);
+    gemm_int8_init(M, N, K, bias, bias_n);
   }
 
   ~generate_gemm_s8u8_x86_kern() { gemm_int8_deinit(); }
@@ -80,9 +95,15 @@ class generate_gemm_s8u8_x86_kern {
     calc_block(_M, _N, _K, &block_m, &block_n);
     for (loop_n = 0; loop_n < _N; loop_n += block_n) {
       min_n = ((_N - loop_n) >= block_n) ? block_n : (_N - loop_n);
-      cur_b = _is_trans_B ? (_B + loop_n * _K) : (_B + loop_n);
-      int step = _is_trans_B ? _K : _N;
-      packB_i82u8(min_n, _K, step, cur_b, _pack_B, _is_trans_B);
+      // The blocks start at a panel of 32 columns, so the pack of the block
+      // is a part of the pack of the whole B.
+      const uint8_t *cur_pack_b = _packed_B + loop_n * _k_align4;
+      if (!_packed_B) {
+        cur_b = _is_trans_B ? (_B + loop_n * _K) : (_B + loop_n);
+        int step = _is_trans_B ? _K : _N;
+        packB_i82u8(min_n, _K, step, cur_b, _pack_B, _is_trans_B);
+        cur_pack_b = _pack_B;
+      }
 
       for (loop_m = 0; loop_m < _M; loop_m += block_m) {
         min_m = ((_M - loop_m) >= block_m) ? block_m : (_M - loop_m);
@@ -90,17 +111,43 @@ class generate_gemm_s8u8_x86_kern {
         cur_c = _C + loop_m * _ldc + loop_n;
 
         // kernel
-        gemm_kernel_loop_int8(min_m,
-                              min_n,
-                              _K,
-                              cur_a,
-                              _pack_B,
-                              cur_c,
-                              _ldc,
-                              _scale + loop_m,
-                              _re_bias + loop_m,
-                              _relu_type,
-                              _relu_alpha);
+        if (_vnni) {
+          GemmS8u8Epilogue epilogue = {_comp + loop_m,
+                                       _scale + loop_m,
+                                       _bias_m + loop_m,
+                                       _Sb_n ? _Sb_n + loop_n : nullptr,
+                                       _bias_n ? _bias_n + loop_n : nullptr,
+                                       _relu_type,
+                                       _relu_alpha};
+          gemm_kernel_loop_int8_vnni(
+              min_m, min_n, _K, cur_a, cur_pack_b, cur_c, _ldc, epilogue);
+        } else if (_tmp_C) {
+          // The columns are requantized out of the kernel.
+          gemm_kernel_loop_int8(min_m,
+                                min_n,
+                                _K,
+                                cur_a,
+                                cur_pack_b,
+                                _tmp_C,
+                                min_n,
+                                _scale + loop_m,
+                                _comp_bias + loop_m,
+                                0,
+                                0.f);
+          column_epilogue(loop_m, loop_n, min_m, min_n, cur_c);
+        } else {
+          gemm_kernel_loop_int8(min_m,
+                                min_n,
+                                _K,
+                                cur_a,
+                                cur_pack_b,
+                                cur_c,
+                                _ldc,
+                                _scale + loop_m,
+                                _re_bias + loop_m,
+                                _relu_type,
+                                _relu_alpha);
+        }
       }
     }
   }
@@ -115,6 +162,7 @@ class generate_gemm_s8u8_x86_kern {
   bool _C_is_int8;
   bool _is_trans_A;
   bool _is_trans_B;
+  bool _vnni{false};
   // divide block param
   const int _unroll_n = 32;
   const int _unroll_m = 2;
@@ -129,6 +177,14 @@ class generate_gemm_s8u8_x86_kern {
   uint8_t *_pack_B{nullptr};
   const int8_t *_A{nullptr};
   const int8_t *_B{nullptr};
+  const uint8_t *_packed_B{nullptr};
+  // epilogue of the VNNI kernels and of the columns
+  int *_comp{nullptr};
+  float *_bias_m{nullptr};
+  float *_bias_n{nullptr};
+  float *_comp_bias{nullptr};
+  float *_tmp_C{nullptr};
+  const float *_Sb_n{nullptr};
 
   // prepare input data
   void repack_bias(bool is_trans,
@@ -160,7 +216,56 @@ class generate_gemm_s8u8_x86_kern {
     gemm_s8u8s8_runpackB(N, K, stride, B, pack_B, is_trans);
   }
 
-  void gemm_int8_init(int M, int N, int K, const float *bias) {
+  // The row sums of A times 128, the offset of B, and the biases in the unit
+  // of C.
+  void calc_epilogue(
+      int M, int N, int K, const float *bias, const float *bias_n) {
+    const float out_scale = std::is_same<TYPE_C, int8_t>::value ? _Sc : 1.f;
+    for (int i = 0; i < M; i++) {
+      int sum = 0;
+      for (int j = 0; j < K; j++) {
+        sum += _is_trans_A ? _A[i + j * M] : _A[i * K + j];
+      }
+      _comp[i] = sum * TRANS_INT8_UINT8_OFFT;
+      _bias_m[i] = bias ? bias[i] / out_scale : 0.f;
+      if (_comp_bias) _comp_bias[i] = -_comp[i] * _scale[i];
+    }
+    if (_bias_n) {
+      for (int j = 0; j < N; j++) _bias_n[j] = bias_n[j] / out_scale;
+    }
+  }
+
+  // C = act(tmp_C * Sb_n + bias + bias_n) of a block of rows x cols from
+  // (m, n), tmp_C being the output of the kernels with the rows requantized.
+  void column_epilogue(int m, int n, int rows, int cols, TYPE_C *C) {
+    for (int i = 0; i < rows; i++) {
+      for (int j = 0; j < cols; j++) {
+        float v = _tmp_C[i * cols + j];
+        if (_Sb_n) v *= _Sb_n[n + j];
+        v += _bias_m[m + i];
+        if (_bias_n) v += _bias_n[n + j];
+        if (_relu_type == 1) {
+          v = std::max(v, 0.f);
+        } else if (_relu_type == 2) {
+          v = std::min(std::max(v, 0.f), _relu_alpha);
+        } else if (_relu_type == 3) {
+          v = v > 0.f ? v : v * _relu_alpha;
+        }
+        store_c(v, C + i * _ldc + j);
+      }
+    }
+  }
+
+  static void store_c(float v, float *c) { *c = v; }
+
+  // Rounds half to even as the kernels do.
+  static void store_c(float v, int8_t *c) {
+    int q = static_cast<int>(std::nearbyint(v));
+    *c = static_cast<int8_t>(std::min(std::max(q, -127), 127));
+  }
+
+  void gemm_int8_init(
+      int M, int N, int K, const float *bias, const float *bias_n) {
     int K_align4 = (K + 3) >> 2;
     int block_n = 0;
     int block_m = 0;
@@ -171,8 +276,10 @@ class generate_gemm_s8u8_x86_kern {
     // malloc work_buf
     _pack_A = reinterpret_cast<int8_t *>(
         TargetMalloc(TARGET(kX86), block_m * K_align4));
-    _pack_B = reinterpret_cast<uint8_t *>(
-        TargetMalloc(TARGET(kX86), block_n * K_align4));
+    if (!_packed_B) {
+      _pack_B = reinterpret_cast<uint8_t *>(
+          TargetMalloc(TARGET(kX86), block_n * K_align4));
+    }
     _re_bias = reinterpret_cast<float *>(
         TargetMalloc(TARGET(kX86), M * sizeof(float)));
     _scale = reinterpret_cast<float *>(
@@ -188,6 +295,23 @@ class generate_gemm_s8u8_x86_kern {
     }
     calc_scale(M, _Sa, _Sb, _Sc, _scale);
     prepackA_i8(M, K, _A, _pack_A, _is_trans_A);
+
+    _vnni = gemm_s8u8_vnni_available();
+    _comp =
+        reinterpret_cast<int *>(TargetMalloc(TARGET(kX86), M * sizeof(int)));
+    _bias_m = reinterpret_cast<float *>(
+        TargetMalloc(TARGET(kX86), M * sizeof(float)));
+    if (bias_n) {
+      _bias_n = reinterpret_cast<float *>(
+          TargetMalloc(TARGET(kX86), N * sizeof(float)));
+    }
+    if (!_vnni && (_Sb_n || bias_n)) {
+      _comp_bias = reinterpret_cast<float *>(
+          TargetMalloc(TARGET(kX86), M * sizeof(float)));
+      _tmp_C = reinterpret_cast<float *>(
+          TargetMalloc(TARGET(kX86), block_m * block_n * sizeof(float)));
+    }
+    calc_epilogue(M, N, K, bias, bias_n);
   }
 
   void gemm_int8_deinit() {
@@ -206,6 +330,21 @@ class generate_gemm_s8u8_x86_kern {
     if (_in_bias != nullptr) {
       TargetFree(TARGET(kX86), _in_bias);
     }
+    if (_comp != nullptr) {
+      TargetFree(TARGET(kX86), _comp);
+    }
+    if (_bias_m != nullptr) {
+      TargetFree(TARGET(kX86), _bias_m);
+    }
+    if (_bias_n != nullptr) {
+      TargetFree(TARGET(kX86), _bias_n);
+    }
+    if (_comp_bias != nullptr) {
+      TargetFree(TARGET(kX86), _comp_bias);
+    }
+    if (_tmp_C != nullptr) {
+      TargetFree(TARGET(kX86), _tmp_C);
+    }
   }
 
   void calc_block(int M, int N, int K, int *blk_m, int *blk_n);
@@ -213,6 +352,84 @@ class generate_gemm_s8u8_x86_kern {
 
 #undef PARAM_INIT
 
+// The bytes of op(B), K x N, packed by gemm_s8u8_pack_B.
+inline int64_t gemm_s8u8_packed_B_size(int N, int K) {
+  return static_cast<int64_t>(N) * ((K + 3) / 4 * 4);
+}
+
+// Packs op(B), K x N, for all the gemms with B, e.g. a constant weight.
+inline void gemm_s8u8_pack_B(
+    bool is_trans_B, int N, int K, const int8_t *B, uint8_t *packed_B) {
+  gemm_s8u8s8_runpackB(N, K, is_trans_B ? K : N, B, packed_B, is_trans_B);
+}
+
+// The persistable int8 weight op(B), K x N, packed once, nullptr if B is not
+// persistable. The kernels of the cloned predictors share it.
+inline std::shared_ptr<const lite::Tensor> gemm_s8u8_pack_persistable_B(
+    const lite::Tensor &B, bool is_trans_B, int K, int N) {
+  if (!B.persistable() || B.numel() != static_cast<int64_t>(K) * N) {
+    return nullptr;
+  }
+  const int8_t *data = B.data<int8_t>();
+  std::string layout = "s8u8," + std::to_string(is_trans_B) + "," +
+                       std::to_string(K) + "," + std::to_string(N);
+  return SharePackedWeight(data, layout, [&](lite::Tensor *packed) {
+    packed->Resize({gemm_s8u8_packed_B_size(N, K)});
+    gemm_s8u8_pack_B(is_trans_B, N, K, data, packed->mutable_data<uint8_t>());
+  });
+}
+
+// C = alpha * op(A) * op(B) of the quantized activations A, M x K with the
+// scale Sa, and B, K x N, quantized per tensor or per column with Sb, e.g. the
+// weights of fc, mul and matmul. Sc is the scale of an int8 C, bias_n the
+// bias of the columns of C. relu_alpha is the float threshold of relu6 or the
+// slope of leaky relu. packed_B is B packed by gemm_s8u8_pack_B, if given.
+template <typename TYPE_C>
+void gemm_s8u8_quantized(bool is_trans_A,
+                         bool is_trans_B,
+                         int M,
+                         int N,
+                         int K,
+                         float alpha,
+                         const int8_t *A,
+                         float Sa,
+                         const int8_t *B,
+                         const std::vector<float> &Sb,
+                         float Sc,
+                         const float *bias_n,
+                         int relu_type,
+                         float relu_alpha,
+                         TYPE_C *C,
+                         int ldc,
+                         const uint8_t *packed_B = nullptr) {
+  if (Sb.size() != 1 && Sb.size() != static_cast<size_t>(N)) {
+    LOG(FATAL) << "weight scale size is not 1 or N, not support yet.";
+  }
+  std::vector<float> scale_m(M, Sa * alpha);
+  // The kernels clip relu6 in the unit of C.
+  if (relu_type == 2 && std::is_same<TYPE_C, int8_t>::value) {
+    relu_alpha /= Sc;
+  }
+  generate_gemm_s8u8_x86_kern<TYPE_C> gemm(
+      is_trans_A,
+      is_trans_B,
+      M,
+      N,
+      K,
+      A,
+      ldc,
+      scale_m.data(),
+      Sb.size() == 1 ? Sb[0] : 1.f,
+      Sc,
+      nullptr,
+      relu_type,
+      relu_alpha,
+      Sb.size() == 1 ? nullptr : Sb.data(),
+      bias_n,
+      packed_B);
+  gemm.compute(A, B, C);
+}
+
 }  // namespace math
 }  // namespace x86
 }  // namespace lite
@@ -21,6 +21,7 @@ limitations under the License. */
 #include <stdint.h>
 #include <tmmintrin.h>
 #include <algorithm>
+#include <cmath>
 
 namespace paddle {
 namespace lite {
@@ -115,8 +116,8 @@ void gemm_fuse_relu_bias_f32(float* data,
   static_cast<int8_t>( \
       std::min(std::max(a, CLIP_BORDER_LEFT), CLIP_BORDER_RIGHT))
 
-#define FLOAT2INT(a) \
-  a > 0 ? static_cast<int>(a + 0.5f) : static_cast<int>(a - 0.5f)
+// Rounds half to even as _mm256_cvtps_epi32 does.
+#define FLOAT2INT(a) static_cast<int>(std::nearbyint(a))
 
 // extra 2 regs
 #define _MM256_DOT_U8S8(dst, src1, src2, vec_tmp_marco)          \
@@ -354,7 +355,7 @@ void gemm_kernel_loop_int8(int M,
                            int N,
                            int K,
                            int8_t* A,
-                           uint8_t* B,
+                           const uint8_t* B,
                            int8_t* C,
                            int ldc,
                            const float* scale,
@@ -363,7 +364,7 @@ void gemm_kernel_loop_int8(int M,
                            float relu_alpha) {
   int8_t* a_ptr = A;
   int8_t* c_ptr = C;
-  uint8_t* b_ptr = B;
+  const uint8_t* b_ptr = B;
   const float* scale_ptr = scale;
   const float* bias_ptr = bias;
   int k_loop = (K + 3) >> 2;
@@ -669,7 +670,7 @@ void gemm_kernel_loop_int8(int M,
                            int N,
                            int K,
                            int8_t* A,
-                           uint8_t* B,
+                           const uint8_t* B,
                            float* C,
                            int ldc,
                            const float* scale,
@@ -678,7 +679,7 @@ void gemm_kernel_loop_int8(int M,
                            float relu_alpha) {
   int8_t* a_ptr = A;
   float* c_ptr = C;
-  uint8_t* b_ptr = B;
+  const uint8_t* b_ptr = B;
   const float* scale_ptr = scale;
   const float* bias_ptr = bias;
   int k_loop = (K + 3) >> 2;
@@ -25,7 +25,7 @@ void gemm_kernel_loop_int8(int M,
                            int N,
                            int K,
                            int8_t* A,
-                           uint8_t* B,
+                           const uint8_t* B,
                            int8_t* C,
                            int ldc,
                            const float* scale,
@@ -37,7 +37,7 @@ void gemm_kernel_loop_int8(int M,
                            int N,
                            int K,
                            int8_t* A,
-                           uint8_t* B,
+                           const uint8_t* B,
                            float* C,
                            int ldc,
                            const float* scale,
@@ -45,6 +45,46 @@ void gemm_kernel_loop_int8(int M,
                            int relu_type,
                            float relu_alpha);
 
+// The requantization fused into the int8 gemm. For the row i and the column j
+// of C, s being the int32 sum of the row of A times the column of B + 128:
+//   C = act((s - comp[i]) * scale[i] * scale_n[j] + bias[i] + bias_n[j])
+// rounded and clipped to [-127, 127] for an int8 C. scale_n and bias_n may be
+// null. relu_type is 0 for none, 1 relu, 2 relu6 and 3 leaky relu, relu_alpha
+// being the clip of relu6 and the slope of leaky relu.
+struct GemmS8u8Epilogue {
+  const int* comp;
+  const float* scale;
+  const float* bias;
+  const float* scale_n;
+  const float* bias_n;
+  int relu_type;
+  float relu_alpha;
+};
+
+// Whether the cpu has AVX512-VNNI for gemm_kernel_loop_int8_vnni.
+bool gemm_s8u8_vnni_available();
+
+// The AVX512-VNNI counterparts of gemm_kernel_loop_int8 on the same packed A
+// and B. vpdpbusd sums the products in int32, without the int16 saturation of
+// maddubs. The epilogue starts at the first row and column of C.
+void gemm_kernel_loop_int8_vnni(int M,
+                                int N,
+                                int K,
+                                const int8_t* A,
+                                const uint8_t* B,
+                                int8_t* C,
+                                int ldc,
+                                const GemmS8u8Epilogue& epilogue);
+
+void gemm_kernel_loop_int8_vnni(int M,
+                                int N,
+                                int K,
+                                const int8_t* A,
+                                const uint8_t* B,
+                                float* C,
+                                int ldc,
+                                const GemmS8u8Epilogue& epilogue);
+
 }  // namespace math
 }  // namespace x86
 }  // namespace lite
@@ -0,0 +1,234 @@
+/* Copyright (c) 2021 paddlepaddle Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License. */
+
+#ifdef __AVX2__
+
+#include <immintrin.h>
+#include <stdint.h>
+#include "lite/backends/x86/cpu_info.h"
+#include "lite/backends/x86/math/gemm_s8u8_kernel.h"
+
+// The kernels are built for AVX512-VNNI whatever the flags of the library
+// are, and picked at runtime.
+#if defined(_MSC_VER)
+#define GEMM_TARGET_VNNI
+#else
+#define GEMM_TARGET_VNNI __attribute__((target("avx512f,avx512vnni")))
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+bool gemm_s8u8_vnni_available() {
+#ifdef __AVX512VNNI__
+  return true;
+#else
+  static const bool available = MayIUse(avx512_core_vnni);
+  return available;
+#endif
+}
+
+GEMM_TARGET_VNNI inline void vnni_store(float* C, __mmask16 mask, __m512 v) {
+  _mm512_mask_storeu_ps(C, mask, v);
+}
+
+GEMM_TARGET_VNNI inline void vnni_store(int8_t* C, __mmask16 mask, __m512 v) {
+  // -128 is left out as in gemm_kernel_loop_int8.
+  __m512i vi =
+      _mm512_max_epi32(_mm512_cvtps_epi32(v), _mm512_set1_epi32(-127));
+  _mm512_mask_cvtsepi32_storeu_epi8(C, mask, vi);
+}
+
+// The epilogue of 16 columns of the row i from the column j, C being the row.
+template <typename TYPE_C>
+GEMM_TARGET_VNNI inline void vnni_epilogue(__m512i acc,
+                                           int i,
+                                           int j,
+                                           __mmask16 mask,
+                                           const GemmS8u8Epilogue& ep,
+                                           TYPE_C* C) {
+  const __m512 vzero = _mm512_setzero_ps();
+  __m512 v = _mm512_cvtepi32_ps(
+      _mm512_sub_epi32(acc, _mm512_set1_epi32(ep.comp[i])));
+  v = _mm512_mul_ps(v, _mm512_set1_ps(ep.scale[i]));
+  if (ep.scale_n) {
+    v = _mm512_mul_ps(v, _mm512_maskz_loadu_ps(mask, ep.scale_n + j));
+  }
+  if (ep.bias) {
+    v = _mm512_add_ps(v, _mm512_set1_ps(ep.bias[i]));
+  }
+  if (ep.bias_n) {
+    v = _mm512_add_ps(v, _mm512_maskz_loadu_ps(mask, ep.bias_n + j));
+  }
+  switch (ep.relu_type) {
+    case 1:
+      v = _mm512_max_ps(v, vzero);
+      break;
+    case 2:
+      v = _mm512_min_ps(_mm512_max_ps(v, vzero),
+                        _mm512_set1_ps(ep.relu_alpha));
+      break;
+    case 3: {
+      __mmask16 neg = _mm512_cmp_ps_mask(v, vzero, _CMP_LE_OS);
+      v = _mm512_mask_mul_ps(v, neg, v, _mm512_set1_ps(ep.relu_alpha));
+      break;
+    }
+    default:
+      break;
+  }
+  vnni_store(C + j, mask, v);
+}
+
+#define VNNI_ROWS(OP) OP(0) OP(1) OP(2) OP(3) OP(4) OP(5) OP(6) OP(7)
+
+#define VNNI_INIT(r)                        \
+  __m512i c##r##0 = _mm512_setzero_si512(); \
+  __m512i c##r##1 = _mm512_setzero_si512(); \
+  const int8_t* a##r =                      \
+      ROWS == 1 ? A : A + (r / 2) * 2 * pack_k + (r % 2) * 4;
+
+#define VNNI_DOT(r)                                                   \
+  if (ROWS > r) {                                                     \
+    va = _mm512_set1_epi32(*reinterpret_cast<const int*>(a##r + k)); \
+    c##r##0 = _mm512_dpbusd_epi32(c##r##0, b0, va);                  \
+    if (VECS > 1) c##r##1 = _mm512_dpbusd_epi32(c##r##1, b1, va);    \
+  }
+
+#define VNNI_STORE(r)                                                     \
+  if (ROWS > r) {                                                         \
+    vnni_epilogue(c##r##0, m + r, n, mask0, ep, C + (m + r) * ldc);       \
+    if (VECS > 1) {                                                       \
+      vnni_epilogue(c##r##1, m + r, n + 16, mask1, ep, C + (m + r) * ldc); \
+    }                                                                     \
+  }
+
+// ROWS rows of C, up to 8, by `width` columns, VECS zmm of 16 columns a row.
+// A is packed by pairs of rows, 8 bytes a step of 4 k, or as one row, 4 bytes
+// a step. A block of B holds the 4 k of a column in an int32 lane.
+template <int ROWS, int VECS, typename TYPE_C>
+GEMM_TARGET_VNNI void vnni_block(int k_loop,
+                                 int pack_k,
+                                 const int8_t* A,
+                                 const uint8_t* B,
+                                 int width,
+                                 TYPE_C* C,
+                                 int ldc,
+                                 int m,
+                                 int n,
+                                 const GemmS8u8Epilogue& ep) {
+  const __mmask16 mask0 = static_cast<__mmask16>(
+      width >= 16 ? 0xffff : (1u << width) - 1);
+  const __mmask16 mask1 = static_cast<__mmask16>(
+      width >= 32 ? 0xffff : (1u << (width & 15)) - 1);
+  const int a_step = ROWS == 1 ? 4 : 8;
+  const int k_end = k_loop * a_step;
+  VNNI_ROWS(VNNI_INIT)
+  __m512i b0, b1, va;
+  for (int k = 0; k < k_end; k += a_step) {
+    b0 = _mm512_maskz_loadu_epi32(mask0, B);
+    if (VECS > 1) b1 = _mm512_maskz_loadu_epi32(mask1, B + 64);
+    VNNI_ROWS(VNNI_DOT)
+    B += width * 4;
+  }
+  VNNI_ROWS(VNNI_STORE)
+}
+
+#undef VNNI_ROWS
+#undef VNNI_INIT
+#undef VNNI_DOT
+#undef VNNI_STORE
+
+// ROWS rows of C by the blocks of B, walked as gemm_kernel_loop_int8 does:
+// blocks of 32 columns, then at most one of 24, 16, 8, 4 and 2, then single
+// columns.
+template <int ROWS, typename TYPE_C>
+GEMM_TARGET_VNNI void vnni_rows(int N,
+                                int k_loop,
+                                const int8_t* A,
+                                const uint8_t* B,
+                                TYPE_C* C,
+                                int ldc,
+                                int m,
+                                const GemmS8u8Epilogue& ep) {
+  static const int widths[] = {32, 24, 16, 8, 4, 2, 1};
+  const int pack_k = k_loop * 4;
+  int n = 0;
+  for (int w : widths) {
+    for (; n + w <= N; n += w) {
+      if (w > 16) {
+        vnni_block<ROWS, 2>(k_loop, pack_k, A, B, w, C, ldc, m, n, ep);
+      } else {
+        vnni_block<ROWS, 1>(k_loop, pack_k, A, B, w, C, ldc, m, n, ep);
+      }
+      B += w * pack_k;
+    }
+  }
+}
+
+template <typename TYPE_C>
+GEMM_TARGET_VNNI void vnni_loop(int M,
+                                int N,
+                                int K,
+                                const int8_t* A,
+                                const uint8_t* B,
+                                TYPE_C* C,
+                                int ldc,
+                                const GemmS8u8Epilogue& ep) {
+  const int k_loop = (K + 3) >> 2;
+  const int pack_k = k_loop << 2;
+  int m = 0;
+  for (; m + 7 < M; m += 8) {
+    vnni_rows<8>(N, k_loop, A + m * pack_k, B, C, ldc, m, ep);
+  }
+  for (; m + 3 < M; m += 4) {
+    vnni_rows<4>(N, k_loop, A + m * pack_k, B, C, ldc, m, ep);
+  }
+  for (; m + 1 < M; m += 2) {
+    vnni_rows<2>(N, k_loop, A + m * pack_k, B, C, ldc, m, ep);
+  }
+  if (m < M) {
+    vnni_rows<1>(N, k_loop, A + m * pack_k, B, C, ldc, m, ep);
+  }
+}
+
+void gemm_kernel_loop_int8_vnni(int M,
+                                int N,
+                                int K,
+                                const int8_t* A,
+                                const uint8_t* B,
+                                int8_t* C,
+                                int ldc,
+                                const GemmS8u8Epilogue& epilogue) {
+  vnni_loop(M, N, K, A, B, C, ldc, epilogue);
+}
+
+void gemm_kernel_loop_int8_vnni(int M,
+                                int N,
+                                int K,
+                                const int8_t* A,
+                                const uint8_t* B,
+                                float* C,
+                                int ldc,
+                                const GemmS8u8Epilogue& epilogue) {
+  vnni_loop(M, N, K, A, B, C, ldc, epilogue);
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
+
+#endif  // __AVX2__
@@ -0,0 +1,288 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/backends/x86/math/gemm_weight_only.h"
+#include <algorithm>
+#include "lite/backends/x86/math/vector_math_avx2.h"
+#include "lite/core/parallel_defines.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The columns of a panel, the rows of B dequantized at once and the rows of
+// A of a micro kernel.
+const int kNR = 16;
+const int kKC = 256;
+const int kMR = 4;
+// The least multiply-adds of a task.
+const int64_t kTaskSize = 1 << 18;
+
+inline int quantized_value(const QuantizedGemmWeight& B, int k, int j) {
+  const int8_t* row = B.data + k * B.ldb;
+  if (B.bits == 8) return row[j];
+  const uint8_t byte = static_cast<uint8_t>(row[j >> 1]);
+  return ((j & 1) ? byte >> 4 : byte & 0x0F) - 8;
+}
+
+// buf[k][j] = B(k0 + k, j0 + j) of kb rows and nb columns, the columns from
+// nb to kNR are zeros.
+void dequantize_panel_ref(const QuantizedGemmWeight& B,
+                          int N,
+                          int k0,
+                          int kb,
+                          int j0,
+                          int nb,
+                          float* buf) {
+  for (int k = 0; k < kb; ++k) {
+    const float* scales = B.scales + (k0 + k) / B.group_size * N + j0;
+    float* dst = buf + k * kNR;
+    for (int j = 0; j < nb; ++j) {
+      dst[j] = quantized_value(B, k0 + k, j0 + j) * scales[j];
+    }
+    std::fill(dst + nb, dst + kNR, 0.f);
+  }
+}
+
+// C[i][j] (+)= sum_k A[i][k] * buf[k][j] of mr rows and nb columns.
+void micro_kernel_ref(int mr,
+                      int nb,
+                      int kb,
+                      const float* A,
+                      int lda,
+                      const float* buf,
+                      bool accumulate,
+                      float* C,
+                      int ldc) {
+  for (int i = 0; i < mr; ++i) {
+    float acc[kNR] = {0.f};
+    for (int k = 0; k < kb; ++k) {
+      const float a = A[i * lda + k];
+      for (int j = 0; j < kNR; ++j) acc[j] += a * buf[k * kNR + j];
+    }
+    for (int j = 0; j < nb; ++j) {
+      C[i * ldc + j] = accumulate ? C[i * ldc + j] + acc[j] : acc[j];
+    }
+  }
+}
+
+//******************************* avx2 ***************************************
+// The full panels are converted 16 columns at a time, the last one by
+// dequantize_panel_ref.
+X86_TARGET_AVX2 void dequantize_panel_avx2(const QuantizedGemmWeight& B,
+                                           int N,
+                                           int k0,
+                                           int kb,
+                                           int j0,
+                                           int nb,
+                                           float* buf) {
+  if (nb < kNR) {
+    dequantize_panel_ref(B, N, k0, kb, j0, nb, buf);
+    return;
+  }
+  const __m128i low_bits = _mm_set1_epi8(0x0F);
+  const __m128i offset = _mm_set1_epi8(8);
+  for (int k = 0; k < kb; ++k) {
+    const int8_t* row = B.data + (k0 + k) * B.ldb;
+    __m128i q;
+    if (B.bits == 8) {
+      q = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + j0));
+    } else {
+      // The even columns are in the low nibbles, the odd ones in the high.
+      __m128i packed =
+          _mm_loadl_epi64(reinterpret_cast<const __m128i*>(row + j0 / 2));
+      __m128i even = _mm_and_si128(packed, low_bits);
+      __m128i odd = _mm_and_si128(_mm_srli_epi16(packed, 4), low_bits);
+      q = _mm_sub_epi8(_mm_unpacklo_epi8(even, odd), offset);
+    }
+    const float* scales = B.scales + (k0 + k) / B.group_size * N + j0;
+    __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(q));
+    __m256 hi =
+        _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(q, 8)));
+    _mm256_storeu_ps(buf + k * kNR,
+                     _mm256_mul_ps(lo, _mm256_loadu_ps(scales)));
+    _mm256_storeu_ps(buf + k * kNR + 8,
+                     _mm256_mul_ps(hi, _mm256_loadu_ps(scales + 8)));
+  }
+}
+
+X86_TARGET_AVX2 inline __m256i panel_mask_avx2(int n) {
+  return n >= 8 ? _mm256_set1_epi32(-1) : tail_mask_avx2(std::max(n, 0));
+}
+
+template <int MR>
+X86_TARGET_AVX2 void micro_kernel_avx2(int nb,
+                                       int kb,
+                                       const float* A,
+                                       int lda,
+                                       const float* buf,
+                                       bool accumulate,
+                                       float* C,
+                                       int ldc) {
+  __m256 acc[MR][2];
+  for (int i = 0; i < MR; ++i) {
+    acc[i][0] = _mm256_setzero_ps();
+    acc[i][1] = _mm256_setzero_ps();
+  }
+  for (int k = 0; k < kb; ++k) {
+    __m256 b0 = _mm256_loadu_ps(buf + k * kNR);
+    __m256 b1 = _mm256_loadu_ps(buf + k * kNR + 8);
+    for (int i = 0; i < MR; ++i) {
+      __m256 a = _mm256_broadcast_ss(A + i * lda + k);
+      acc[i][0] = _mm256_fmadd_ps(a, b0, acc[i][0]);
+      acc[i][1] = _mm256_fmadd_ps(a, b1, acc[i][1]);
+    }
+  }
+  if (nb == kNR) {
+    for (int i = 0; i < MR; ++i) {
+      float* c = C + i * ldc;
+      if (accumulate) {
+        acc[i][0] = _mm256_add_ps(acc[i][0], _mm256_loadu_ps(c));
+        acc[i][1] = _mm256_add_ps(acc[i][1], _mm256_loadu_ps(c + 8));
+      }
+      _mm256_storeu_ps(c, acc[i][0]);
+      _mm256_storeu_ps(c + 8, acc[i][1]);
+    }
+    return;
+  }
+  const __m256i mask0 = panel_mask_avx2(nb);
+  const __m256i mask1 = panel_mask_avx2(nb - 8);
+  for (int i = 0; i < MR; ++i) {
+    float* c = C + i * ldc;
+    if (accumulate) {
+      acc[i][0] = _mm256_add_ps(acc[i][0], _mm256_maskload_ps(c, mask0));
+      acc[i][1] = _mm256_add_ps(acc[i][1], _mm256_maskload_ps(c + 8, mask1));
+    }
+    _mm256_maskstore_ps(c, mask0, acc[i][0]);
+    _mm256_maskstore_ps(c + 8, mask1, acc[i][1]);
+  }
+}
+
+void micro_kernel_avx2(int mr,
+                       int nb,
+                       int kb,
+                       const float* A,
+                       int lda,
+                       const float* buf,
+                       bool accumulate,
+                       float* C,
+                       int ldc) {
+  switch (mr) {
+    case 4:
+      micro_kernel_avx2<4>(nb, kb, A, lda, buf, accumulate, C, ldc);
+      break;
+    case 3:
+      micro_kernel_avx2<3>(nb, kb, A, lda, buf, accumulate, C, ldc);
+      break;
+    case 2:
+      micro_kernel_avx2<2>(nb, kb, A, lda, buf, accumulate, C, ldc);
+      break;
+    default:
+      micro_kernel_avx2<1>(nb, kb, A, lda, buf, accumulate, C, ldc);
+      break;
+  }
+}
+
+}  // namespace
+
+QuantizedGemmWeight quantized_gemm_weight(const lite::Tensor& w,
+                                          int bits,
+                                          int group_size,
+                                          const std::vector<float>& scales) {
+  QuantizedGemmWeight B;
+  if (w.precision() != PRECISION(kInt8) || (bits != 8 && bits != 4)) {
+    return B;
+  }
+  const auto& dims = w.dims();
+  CHECK_EQ(dims.size(), 2UL);
+  CHECK_GT(group_size, 0);
+  const int64_t groups = (dims[0] + group_size - 1) / group_size;
+  const int64_t N = static_cast<int64_t>(scales.size()) / groups;
+  CHECK_EQ(N * groups, static_cast<int64_t>(scales.size()));
+  const int64_t ldb = bits == 8 ? N : (N + 1) / 2;
+  CHECK_EQ(dims[1], ldb);
+  B.data = w.data<int8_t>();
+  B.ldb = ldb;
+  B.bits = bits;
+  B.group_size = group_size;
+  B.scales = scales.data();
+  return B;
+}
+
+void gemm_weight_only(int M,
+                      int N,
+                      int K,
+                      const float* A,
+                      int lda,
+                      const QuantizedGemmWeight& B,
+                      float* C,
+                      int ldc) {
+  if (M <= 0 || N <= 0) return;
+  if (K <= 0) {
+    for (int i = 0; i < M; ++i) std::fill(C + i * ldc, C + i * ldc + N, 0.f);
+    return;
+  }
+  const bool use_avx2 = avx2_available();
+  const int panels = (N + kNR - 1) / kNR;
+  const int threads = ThreadPool::CurrentThreadNum();
+  // The rows are split too when the panels can not keep the threads busy.
+  int row_blocks = 1;
+  if (panels < threads) {
+    row_blocks = std::min((M + kMR - 1) / kMR,
+                          (threads + panels - 1) / panels);
+  }
+  const int64_t work = static_cast<int64_t>(panels) * row_blocks;
+  const int64_t size = static_cast<int64_t>(M) * N * K;
+  const int tasks = static_cast<int>(std::max<int64_t>(
+      1,
+      std::min<int64_t>(std::min<int64_t>(threads, work), size / kTaskSize)));
+  LITE_PARALLEL_BEGIN(t, tid, tasks) {
+    float buf[kKC * kNR];
+    for (int64_t w = work * t / tasks; w < work * (t + 1) / tasks; ++w) {
+      const int j0 = static_cast<int>(w / row_blocks) * kNR;
+      const int rb = static_cast<int>(w % row_blocks);
+      const int nb = std::min(kNR, N - j0);
+      const int i0 = static_cast<int>(static_cast<int64_t>(M) * rb /
+                                      row_blocks);
+      const int i1 = static_cast<int>(static_cast<int64_t>(M) * (rb + 1) /
+                                      row_blocks);
+      for (int k0 = 0; k0 < K; k0 += kKC) {
+        const int kb = std::min(kKC, K - k0);
+        if (use_avx2) {
+          dequantize_panel_avx2(B, N, k0, kb, j0, nb, buf);
+        } else {
+          dequantize_panel_ref(B, N, k0, kb, j0, nb, buf);
+        }
+        for (int i = i0; i < i1; i += kMR) {
+          const int mr = std::min(kMR, i1 - i);
+          const float* a = A + static_cast<int64_t>(i) * lda + k0;
+          float* c = C + static_cast<int64_t>(i) * ldc + j0;
+          if (use_avx2) {
+            micro_kernel_avx2(mr, nb, kb, a, lda, buf, k0 > 0, c, ldc);
+          } else {
+            micro_kernel_ref(mr, nb, kb, a, lda, buf, k0 > 0, c, ldc);
+          }
+        }
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
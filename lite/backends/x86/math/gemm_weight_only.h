@@ -0,0 +1,72 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * A K x N weight quantized by post_quant_dynamic_pass, read as is by the
+ * gemm. Element (k, j) is q * scales[k / group_size * N + j]: the scales are
+ * per column, group_size being K, or per column and per group of group_size
+ * rows.
+ *
+ * The 8 bits weights keep an int8 q per element. The 4 bits ones pack two
+ * columns in a byte, column 2c in the low nibble and 2c + 1 in the high one,
+ * each holding q + 8 with q in [-8, 7]. The rows are ldb bytes apart.
+ */
+struct QuantizedGemmWeight {
+  const int8_t* data{nullptr};
+  int64_t ldb{0};
+  int bits{8};
+  int group_size{0};
+  const float* scales{nullptr};
+};
+
+// The weight w of the quantized kernels, K x N, as QuantizedGemmWeight. The
+// data is null if w is not an int8 tensor or bits is neither 8 nor 4.
+QuantizedGemmWeight quantized_gemm_weight(const lite::Tensor& w,
+                                          int bits,
+                                          int group_size,
+                                          const std::vector<float>& scales);
+
+/*
+ * C = A * B of a float A, M x K with lda floats per row, and the weight-only
+ * quantized B.
+ *
+ * B stays quantized in memory, which makes it 4x or 8x lighter to stream
+ * than a float B in the memory bound gemm of few rows. Every panel of 16
+ * columns of B is dequantized by blocks of rows into a buffer of the L1
+ * cache, where the micro kernel reads it for all the rows of A. The work is
+ * split across the threads by panels, and by rows when the panels are few.
+ */
+void gemm_weight_only(int M,
+                      int N,
+                      int K,
+                      const float* A,
+                      int lda,
+                      const QuantizedGemmWeight& B,
+                      float* C,
+                      int ldc);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
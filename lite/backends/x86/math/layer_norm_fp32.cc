@@ -0,0 +1,163 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/layer_norm_fp32.h"
+#include <algorithm>
+#include <cmath>
+#include "lite/backends/x86/math/vector_math_avx2.h"
+#include "lite/core/parallel_defines.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The least elements of a task.
+const int64_t kTaskSize = 16384;
+
+//****************************** reference ***********************************
+// The sum and the sum of squares of x - shift.
+void moments_ref(const float* x, int n, float shift, float* s1, float* s2) {
+  float sum = 0.f;
+  float sum_sq = 0.f;
+  for (int i = 0; i < n; ++i) {
+    const float d = x[i] - shift;
+    sum += d;
+    sum_sq += d * d;
+  }
+  *s1 = sum;
+  *s2 = sum_sq;
+}
+
+void normalize_ref(const float* x,
+                   const float* scale,
+                   const float* bias,
+                   int n,
+                   float mean,
+                   float rstd,
+                   float* y) {
+  for (int i = 0; i < n; ++i) {
+    const float a = scale ? scale[i] * rstd : rstd;
+    y[i] = (x[i] - mean) * a + (bias ? bias[i] : 0.f);
+  }
+}
+
+//******************************** AVX2 **************************************
+X86_TARGET_AVX2 void moments_avx2(
+    const float* x, int n, float shift, float* s1, float* s2) {
+  const __m256 vshift = _mm256_set1_ps(shift);
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  __m256 sq0 = _mm256_setzero_ps();
+  __m256 sq1 = _mm256_setzero_ps();
+  int i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(x + i), vshift);
+    __m256 d1 = _mm256_sub_ps(_mm256_loadu_ps(x + i + 8), vshift);
+    sum0 = _mm256_add_ps(sum0, d0);
+    sum1 = _mm256_add_ps(sum1, d1);
+    sq0 = _mm256_fmadd_ps(d0, d0, sq0);
+    sq1 = _mm256_fmadd_ps(d1, d1, sq1);
+  }
+  if (i + 8 <= n) {
+    __m256 d0 = _mm256_sub_ps(_mm256_loadu_ps(x + i), vshift);
+    sum0 = _mm256_add_ps(sum0, d0);
+    sq0 = _mm256_fmadd_ps(d0, d0, sq0);
+    i += 8;
+  }
+  float tail_sum = 0.f;
+  float tail_sq = 0.f;
+  moments_ref(x + i, n - i, shift, &tail_sum, &tail_sq);
+  *s1 = hsum_avx2(_mm256_add_ps(sum0, sum1)) + tail_sum;
+  *s2 = hsum_avx2(_mm256_add_ps(sq0, sq1)) + tail_sq;
+}
+
+X86_TARGET_AVX2 void normalize_avx2(const float* x,
+                                    const float* scale,
+                                    const float* bias,
+                                    int n,
+                                    float mean,
+                                    float rstd,
+                                    float* y) {
+  const __m256 vmean = _mm256_set1_ps(mean);
+  const __m256 vrstd = _mm256_set1_ps(rstd);
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 a = scale ? _mm256_mul_ps(_mm256_loadu_ps(scale + i), vrstd)
+                     : vrstd;
+    __m256 b = bias ? _mm256_loadu_ps(bias + i) : _mm256_setzero_ps();
+    __m256 d = _mm256_sub_ps(_mm256_loadu_ps(x + i), vmean);
+    _mm256_storeu_ps(y + i, _mm256_fmadd_ps(d, a, b));
+  }
+  normalize_ref(x + i,
+                scale ? scale + i : nullptr,
+                bias ? bias + i : nullptr,
+                n - i,
+                mean,
+                rstd,
+                y + i);
+}
+
+}  // namespace
+
+void layer_norm_fp32(const float* x,
+                     const float* scale,
+                     const float* bias,
+                     int rows,
+                     int cols,
+                     float epsilon,
+                     float* y,
+                     float* mean,
+                     float* var) {
+  const bool use_avx2 = avx2_available();
+  const int tasks = static_cast<int>(std::max<int64_t>(
+      1,
+      std::min<int64_t>(std::min(ThreadPool::CurrentThreadNum(), rows),
+                        static_cast<int64_t>(rows) * cols / kTaskSize)));
+  LITE_PARALLEL_BEGIN(t, tid, tasks) {
+    const int begin = static_cast<int64_t>(rows) * t / tasks;
+    const int end = static_cast<int64_t>(rows) * (t + 1) / tasks;
+    for (int r = begin; r < end; ++r) {
+      const int64_t offset = static_cast<int64_t>(r) * cols;
+      const float* xr = x + offset;
+      float s1 = 0.f;
+      float s2 = 0.f;
+      if (use_avx2) {
+        moments_avx2(xr, cols, xr[0], &s1, &s2);
+      } else {
+        moments_ref(xr, cols, xr[0], &s1, &s2);
+      }
+      const float shifted_mean = s1 / cols;
+      const float row_mean = xr[0] + shifted_mean;
+      const float row_var =
+          std::max(s2 / cols - shifted_mean * shifted_mean, 0.f);
+      const float rstd = 1.f / std::sqrt(row_var + epsilon);
+      if (use_avx2) {
+        normalize_avx2(xr, scale, bias, cols, row_mean, rstd, y + offset);
+      } else {
+        normalize_ref(xr, scale, bias, cols, row_mean, rstd, y + offset);
+      }
+      if (mean) mean[r] = row_mean;
+      if (var) var[r] = row_var;
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,45 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * y = (x - mean) / sqrt(var + epsilon) * scale + bias of the rows x cols x,
+ * the mean and the variance taken along the rows and written to mean and
+ * var unless they are null. scale and bias may be null too.
+ *
+ * A row is read twice: once for its sum and its sum of squares, both taken
+ * about its first element so that the variance does not cancel out, and
+ * once for the normalization, a single fma per element. The rows are split
+ * across the threads.
+ */
+void layer_norm_fp32(const float* x,
+                     const float* scale,
+                     const float* bias,
+                     int rows,
+                     int cols,
+                     float epsilon,
+                     float* y,
+                     float* mean,
+                     float* var);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
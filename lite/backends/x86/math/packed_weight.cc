@@ -0,0 +1,179 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/packed_weight.h"
+#include <algorithm>
+#include <map>
+#include <mutex>  // NOLINT
+#include <string>
+#include <tuple>
+#include <utility>
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/gemm_fp32_compute.h"
+#include "lite/core/memory.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The weight data, is_trans_W, K, N, ldw and alpha.
+typedef std::tuple<const float*, bool, int, int, int, float> PackedWeightKey;
+
+// A weight stays at the same address while a kernel holding its packed data
+// runs, so an entry that is not expired is never stale.
+std::mutex packed_weights_mutex;
+std::map<PackedWeightKey, std::weak_ptr<const PackedGemmWeight>>
+    packed_weights;
+
+// The weight data and the layout of its pack, see SharePackedWeight.
+typedef std::pair<const void*, std::string> PackedTensorKey;
+
+std::map<PackedTensorKey, std::weak_ptr<const lite::Tensor>> packed_tensors;
+
+}  // namespace
+
+bool PackedGemmWeight::Available() {
+#ifdef PADDLE_WITH_MKLML
+  return true;
+#else
+  return gemm_fp32_available();
+#endif
+}
+
+std::shared_ptr<const PackedGemmWeight> PackedGemmWeight::Get(const float* W,
+                                                              bool is_trans_W,
+                                                              int K,
+                                                              int N,
+                                                              int ldw,
+                                                              float alpha,
+                                                              int M) {
+  CHECK(Available()) << "Packed weights need MKL or AVX2";
+  PackedWeightKey key(W, is_trans_W, K, N, ldw, alpha);
+  std::lock_guard<std::mutex> lock(packed_weights_mutex);
+  auto it = packed_weights.find(key);
+  if (it != packed_weights.end()) {
+    auto packed = it->second.lock();
+    if (packed) return packed;
+  }
+  for (auto iter = packed_weights.begin(); iter != packed_weights.end();) {
+    iter = iter->second.expired() ? packed_weights.erase(iter) : ++iter;
+  }
+
+  std::shared_ptr<PackedGemmWeight> packed(new PackedGemmWeight(K, N, alpha));
+#ifdef PADDLE_WITH_MKLML
+  const int m_hint = (std::max)(M, 1);
+  packed->data_ = CBlas<float>::GEMM_ALLOC(CblasBMatrix, m_hint, N, K);
+  CHECK(packed->data_);
+  CBlas<float>::GEMM_PACK(CblasRowMajor,
+                          CblasBMatrix,
+                          is_trans_W ? CblasTrans : CblasNoTrans,
+                          m_hint,
+                          N,
+                          K,
+                          alpha,
+                          W,
+                          ldw,
+                          packed->data_);
+#else
+  packed->data_ = static_cast<float*>(TargetMalloc(
+      TARGET(kX86), gemm_fp32_packed_B_size(N, K) * sizeof(float)));
+  gemm_fp32_prepack_B(is_trans_W, N, K, W, ldw, packed->data_);
+#endif
+  packed_weights[key] = packed;
+  return packed;
+}
+
+PackedGemmWeight::~PackedGemmWeight() {
+  if (!data_) return;
+#ifdef PADDLE_WITH_MKLML
+  CBlas<float>::GEMM_FREE(data_);
+#else
+  TargetFree(TARGET(kX86), data_);
+#endif
+}
+
+void PackedGemmWeight::Compute(bool is_trans_A,
+                               int M,
+                               const float* A,
+                               int lda,
+                               float beta,
+                               float* C,
+                               int ldc) const {
+  if (M <= 0) return;
+#ifdef PADDLE_WITH_MKLML
+  // alpha is packed with W.
+  CBlas<float>::GEMM_COMPUTE(CblasRowMajor,
+                             is_trans_A ? CblasTrans : CblasNoTrans,
+                             CblasPacked,
+                             M,
+                             N_,
+                             K_,
+                             A,
+                             lda,
+                             data_,
+                             N_,
+                             beta,
+                             C,
+                             ldc);
+#else
+  gemm_fp32_prepacked(
+      is_trans_A, M, N_, K_, alpha_, A, lda, data_, beta, C, ldc);
+#endif
+}
+
+std::shared_ptr<const PackedGemmWeight> PackPersistableWeight(
+    const lite::Tensor& W,
+    bool is_trans_W,
+    int K,
+    int N,
+    int ldw,
+    float alpha,
+    int M) {
+  const int64_t rows = is_trans_W ? N : K;
+  if (!W.persistable() || W.precision() != PRECISION(kFloat) ||
+      W.numel() < rows * ldw || !PackedGemmWeight::Available()) {
+    return nullptr;
+  }
+  return PackedGemmWeight::Get(
+      W.data<float>(), is_trans_W, K, N, ldw, alpha, M);
+}
+
+std::shared_ptr<const lite::Tensor> SharePackedWeight(
+    const void* W,
+    const std::string& layout,
+    const std::function<void(lite::Tensor*)>& pack) {
+  PackedTensorKey key(W, layout);
+  std::lock_guard<std::mutex> lock(packed_weights_mutex);
+  auto it = packed_tensors.find(key);
+  if (it != packed_tensors.end()) {
+    auto packed = it->second.lock();
+    if (packed) return packed;
+  }
+  for (auto iter = packed_tensors.begin(); iter != packed_tensors.end();) {
+    iter = iter->second.expired() ? packed_tensors.erase(iter) : ++iter;
+  }
+
+  std::shared_ptr<lite::Tensor> packed(new lite::Tensor);
+  pack(packed.get());
+  packed_tensors[key] = packed;
+  return packed;
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
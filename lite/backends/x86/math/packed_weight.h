@@ -0,0 +1,98 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * PackedGemmWeight holds a constant op(W), K x N, e.g. the persistable weight
+ * of fc, mul or matmul, packed once in the layout of the sgemm library: the
+ * MKL packed format with MKL, the panels of gemm_fp32 without it. The kernels
+ * get it in PrepareForRun and skip the packing of W in every Run.
+ *
+ * The packed weights are shared by all the kernels reading the same weight
+ * data, so the predictors cloned from one another pack every weight once.
+ * The packed data is released with the last kernel holding it.
+ */
+class PackedGemmWeight {
+ public:
+  // Whether the weights can be packed, it needs MKL or AVX2.
+  static bool Available();
+
+  // The packed alpha * op(W), W is row major with `ldw` floats per row. M is
+  // the expected number of rows of A, a hint for MKL.
+  static std::shared_ptr<const PackedGemmWeight> Get(const float* W,
+                                                     bool is_trans_W,
+                                                     int K,
+                                                     int N,
+                                                     int ldw,
+                                                     float alpha,
+                                                     int M = 1);
+
+  ~PackedGemmWeight();
+
+  // C = op(A) * alpha * op(W) + beta * C, op(A) is M x K.
+  void Compute(bool is_trans_A,
+               int M,
+               const float* A,
+               int lda,
+               float beta,
+               float* C,
+               int ldc) const;
+
+  int K() const { return K_; }
+  int N() const { return N_; }
+
+ private:
+  PackedGemmWeight(int K, int N, float alpha) : K_(K), N_(N), alpha_(alpha) {}
+
+  int K_;
+  int N_;
+  float alpha_;
+  float* data_{nullptr};
+};
+
+// The packed alpha * op(W) of a persistable float weight, nullptr if W is not
+// one or the weights can not be packed. op(W) is K x N, the rows of W are ldw
+// apart.
+std::shared_ptr<const PackedGemmWeight> PackPersistableWeight(
+    const lite::Tensor& W,
+    bool is_trans_W,
+    int K,
+    int N,
+    int ldw,
+    float alpha,
+    int M);
+
+// The constant weight W packed by `pack` into a tensor, e.g. for the int8 or
+// the bf16 gemm. The kernels packing the same W with the same `layout` share
+// one tensor, as they share a PackedGemmWeight.
+std::shared_ptr<const lite::Tensor> SharePackedWeight(
+    const void* W,
+    const std::string& layout,
+    const std::function<void(lite::Tensor*)>& pack);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
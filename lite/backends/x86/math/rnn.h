@@ -18,6 +18,7 @@
 #include "lite/backends/x86/math/activation_functions.h"
 #include "lite/backends/x86/math/blas.h"
 #include "lite/core/tensor.h"
+#include "lite/core/workspace.h"
 #include "lite/utils/log/logging.h"
 
 #ifdef __AVX__
@@ -288,8 +289,10 @@ struct RnnLstmUnitFunctor {
                       lite_api::ActivationType cand_act,
                       int threads) {
     const int temp_len = frame_size;
-    auto zero_ptr = static_cast<float*>(
-        TargetMalloc(TARGET(kX86), temp_len * sizeof(float)));
+    // called for every time step, so take the buffer from the workspace
+    auto& workspace = WorkSpace::Global_X86();
+    size_t workspace_mark = workspace.cursor();
+    auto zero_ptr = workspace.Alloc<float>(temp_len);
     memset(zero_ptr, 0, sizeof(float) * temp_len);
 
     for (int b = 0; b < batch_size; ++b) {
@@ -339,7 +342,7 @@ struct RnnLstmUnitFunctor {
       }
     }
 
-    TargetFree(TARGET(kX86), zero_ptr);
+    workspace.Rewind(workspace_mark);
   }
 };
 
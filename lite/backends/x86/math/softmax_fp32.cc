@@ -0,0 +1,249 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/backends/x86/math/softmax_fp32.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "lite/backends/x86/math/vector_math_avx2.h"
+#include "lite/core/parallel_defines.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The longest rows which are swept three times, x and y staying in L1.
+const int kCachedRow = 2048;
+// The inner columns of a block of a softmax along an outer axis.
+const int kColumns = 64;
+// The least elements of a task.
+const int64_t kTaskSize = 16384;
+
+// The tasks of work_size items of item_size elements.
+int softmax_tasks(int work_size, int64_t item_size) {
+  int64_t tasks = work_size * item_size / kTaskSize;
+  const int threads = ThreadPool::CurrentThreadNum();
+  return static_cast<int>(std::max<int64_t>(
+      1, std::min<int64_t>(std::min(threads, work_size), tasks)));
+}
+
+//****************************** reference ***********************************
+void softmax_row_ref(const float* x, float* y, int n) {
+  float max = std::numeric_limits<float>::lowest();
+  for (int i = 0; i < n; ++i) max = std::max(max, x[i]);
+  float sum = 0.f;
+  for (int i = 0; i < n; ++i) {
+    y[i] = std::exp(x[i] - max);
+    sum += y[i];
+  }
+  const float inv_sum = 1.f / sum;
+  for (int i = 0; i < n; ++i) y[i] *= inv_sum;
+}
+
+// The softmax of the columns [0, cols) of a block, the rows of the axis
+// being inner apart.
+void softmax_columns_ref(
+    const float* x, float* y, int axis_size, int inner, int cols) {
+  float max[kColumns];
+  float sum[kColumns];
+  std::fill(max, max + cols, std::numeric_limits<float>::lowest());
+  std::fill(sum, sum + cols, 0.f);
+  for (int k = 0; k < axis_size; ++k) {
+    const float* xk = x + static_cast<int64_t>(k) * inner;
+    for (int c = 0; c < cols; ++c) max[c] = std::max(max[c], xk[c]);
+  }
+  for (int k = 0; k < axis_size; ++k) {
+    const float* xk = x + static_cast<int64_t>(k) * inner;
+    float* yk = y + static_cast<int64_t>(k) * inner;
+    for (int c = 0; c < cols; ++c) {
+      yk[c] = std::exp(xk[c] - max[c]);
+      sum[c] += yk[c];
+    }
+  }
+  for (int c = 0; c < cols; ++c) sum[c] = 1.f / sum[c];
+  for (int k = 0; k < axis_size; ++k) {
+    float* yk = y + static_cast<int64_t>(k) * inner;
+    for (int c = 0; c < cols; ++c) yk[c] *= sum[c];
+  }
+}
+
+//******************************** AVX2 **************************************
+// The lanes past n of the tail are read as the lowest float, whose exp is 0.
+X86_TARGET_AVX2 inline __m256 load_tail_avx2(const float* x, __m256i mask) {
+  return _mm256_blendv_ps(_mm256_set1_ps(std::numeric_limits<float>::lowest()),
+                          _mm256_maskload_ps(x, mask),
+                          _mm256_castsi256_ps(mask));
+}
+
+// y = exp(x - max) * scale, returns the sum of exp(x - max).
+X86_TARGET_AVX2 float exp_row_avx2(
+    const float* x, float* y, int n, float max, float scale) {
+  const __m256 vmax = _mm256_set1_ps(max);
+  const __m256 vscale = _mm256_set1_ps(scale);
+  __m256 vsum = _mm256_setzero_ps();
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 e = exp_avx2(_mm256_sub_ps(_mm256_loadu_ps(x + i), vmax));
+    vsum = _mm256_add_ps(vsum, e);
+    _mm256_storeu_ps(y + i, _mm256_mul_ps(e, vscale));
+  }
+  if (i < n) {
+    __m256i mask = tail_mask_avx2(n - i);
+    __m256 e = exp_avx2(_mm256_sub_ps(load_tail_avx2(x + i, mask), vmax));
+    e = _mm256_and_ps(e, _mm256_castsi256_ps(mask));
+    vsum = _mm256_add_ps(vsum, e);
+    _mm256_maskstore_ps(y + i, mask, _mm256_mul_ps(e, vscale));
+  }
+  return hsum_avx2(vsum);
+}
+
+X86_TARGET_AVX2 void scale_row_avx2(float* y, int n, float scale) {
+  const __m256 vscale = _mm256_set1_ps(scale);
+  int i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(y + i, _mm256_mul_ps(_mm256_loadu_ps(y + i), vscale));
+  }
+  for (; i < n; ++i) y[i] *= scale;
+}
+
+X86_TARGET_AVX2 inline void online_update_avx2(__m256 v,
+                                               __m256* vmax,
+                                               __m256* vsum) {
+  __m256 new_max = _mm256_max_ps(*vmax, v);
+  *vsum = _mm256_fmadd_ps(*vsum,
+                          exp_avx2(_mm256_sub_ps(*vmax, new_max)),
+                          exp_avx2(_mm256_sub_ps(v, new_max)));
+  *vmax = new_max;
+}
+
+X86_TARGET_AVX2 void softmax_row_avx2(const float* x, float* y, int n) {
+  const __m256 lowest = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+  const __m256i mask = tail_mask_avx2(n & 7);
+  const int n8 = n & ~7;
+  if (n <= kCachedRow) {
+    __m256 vmax = lowest;
+    for (int i = 0; i < n8; i += 8) {
+      vmax = _mm256_max_ps(vmax, _mm256_loadu_ps(x + i));
+    }
+    if (n8 < n) vmax = _mm256_max_ps(vmax, load_tail_avx2(x + n8, mask));
+    const float max = hmax_avx2(vmax);
+    const float sum = exp_row_avx2(x, y, n, max, 1.f);
+    scale_row_avx2(y, n, 1.f / sum);
+    return;
+  }
+  // The online softmax, the sum of a lane is rescaled by exp(old - new) when
+  // its maximum grows.
+  __m256 vmax = lowest;
+  __m256 vsum = _mm256_setzero_ps();
+  for (int i = 0; i < n8; i += 8) {
+    online_update_avx2(_mm256_loadu_ps(x + i), &vmax, &vsum);
+  }
+  if (n8 < n) online_update_avx2(load_tail_avx2(x + n8, mask), &vmax, &vsum);
+  const float max = hmax_avx2(vmax);
+  vsum = _mm256_mul_ps(
+      vsum, exp_avx2(_mm256_sub_ps(vmax, _mm256_set1_ps(max))));
+  exp_row_avx2(x, y, n, max, 1.f / hsum_avx2(vsum));
+}
+
+X86_TARGET_AVX2 void softmax_columns_avx2(
+    const float* x, float* y, int axis_size, int inner, int cols) {
+  // Up to 8 vectors of 8 columns, the tail columns are left to the
+  // reference.
+  const int vecs = cols / 8;
+  __m256 vmax[kColumns / 8];
+  __m256 vsum[kColumns / 8];
+  for (int v = 0; v < vecs; ++v) {
+    vmax[v] = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+    vsum[v] = _mm256_setzero_ps();
+  }
+  for (int k = 0; k < axis_size; ++k) {
+    const float* xk = x + static_cast<int64_t>(k) * inner;
+    for (int v = 0; v < vecs; ++v) {
+      vmax[v] = _mm256_max_ps(vmax[v], _mm256_loadu_ps(xk + v * 8));
+    }
+  }
+  for (int k = 0; k < axis_size; ++k) {
+    const float* xk = x + static_cast<int64_t>(k) * inner;
+    float* yk = y + static_cast<int64_t>(k) * inner;
+    for (int v = 0; v < vecs; ++v) {
+      __m256 e = exp_avx2(_mm256_sub_ps(_mm256_loadu_ps(xk + v * 8), vmax[v]));
+      vsum[v] = _mm256_add_ps(vsum[v], e);
+      _mm256_storeu_ps(yk + v * 8, e);
+    }
+  }
+  for (int v = 0; v < vecs; ++v) {
+    vsum[v] = _mm256_div_ps(_mm256_set1_ps(1.f), vsum[v]);
+  }
+  for (int k = 0; k < axis_size; ++k) {
+    float* yk = y + static_cast<int64_t>(k) * inner;
+    for (int v = 0; v < vecs; ++v) {
+      _mm256_storeu_ps(yk + v * 8,
+                       _mm256_mul_ps(_mm256_loadu_ps(yk + v * 8), vsum[v]));
+    }
+  }
+  if (vecs * 8 < cols) {
+    softmax_columns_ref(
+        x + vecs * 8, y + vecs * 8, axis_size, inner, cols - vecs * 8);
+  }
+}
+
+}  // namespace
+
+void softmax_fp32(
+    const float* x, float* y, int outer, int axis_size, int inner) {
+  const bool use_avx2 = avx2_available();
+  if (inner == 1) {
+    const int tasks = softmax_tasks(outer, axis_size);
+    LITE_PARALLEL_BEGIN(t, tid, tasks) {
+      const int begin = static_cast<int64_t>(outer) * t / tasks;
+      const int end = static_cast<int64_t>(outer) * (t + 1) / tasks;
+      for (int i = begin; i < end; ++i) {
+        const int64_t offset = static_cast<int64_t>(i) * axis_size;
+        if (use_avx2) {
+          softmax_row_avx2(x + offset, y + offset, axis_size);
+        } else {
+          softmax_row_ref(x + offset, y + offset, axis_size);
+        }
+      }
+    }
+    LITE_PARALLEL_END();
+    return;
+  }
+  const int blocks = (inner + kColumns - 1) / kColumns;
+  const int work_size = outer * blocks;
+  const int tasks =
+      softmax_tasks(work_size, static_cast<int64_t>(axis_size) * kColumns);
+  LITE_PARALLEL_BEGIN(t, tid, tasks) {
+    for (int w = t; w < work_size; w += tasks) {
+      const int c0 = (w % blocks) * kColumns;
+      const int cols = std::min(kColumns, inner - c0);
+      const int64_t offset =
+          static_cast<int64_t>(w / blocks) * axis_size * inner + c0;
+      if (use_avx2) {
+        softmax_columns_avx2(x + offset, y + offset, axis_size, inner, cols);
+      } else {
+        softmax_columns_ref(x + offset, y + offset, axis_size, inner, cols);
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
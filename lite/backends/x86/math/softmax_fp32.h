@@ -0,0 +1,39 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * y = softmax(x) along the axis of x, viewed as outer x axis_size x inner.
+ *
+ * The rows along the last axis, inner == 1, are summed in one sweep: every
+ * lane keeps a running maximum and rescales its sum when the maximum grows,
+ * and a second sweep writes exp(x - max) / sum. Rows short enough to stay in
+ * the L1 cache take one more sweep instead, the max before the sums, to run
+ * a single exp per element. Along the other axes the inner columns are
+ * vectorized, so no transpose is needed. The rows, or the blocks of columns,
+ * are split across the threads.
+ */
+void softmax_fp32(
+    const float* x, float* y, int outer, int axis_size, int inner);
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
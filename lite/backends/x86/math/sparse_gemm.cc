@@ -0,0 +1,390 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/backends/x86/math/sparse_gemm.h"
+#include <algorithm>
+#include "lite/backends/x86/math/vector_math_avx2.h"
+#include "lite/core/parallel_defines.h"
+#include "lite/core/workspace.h"
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+namespace {
+
+// The columns of a task and its least multiply-adds.
+const int kNChunk = 256;
+const int64_t kTaskSize = 1 << 16;
+
+bool block_column_nonzero(
+    const float* a, int M, int lda, int block_rows, int row, int col) {
+  for (int r = row; r < std::min(M, row + block_rows); ++r) {
+    if (a[static_cast<int64_t>(r) * lda + col] != 0.f) return true;
+  }
+  return false;
+}
+
+// The columns [n0, n1) of the rows of C of block row br.
+void sparse_block_row_ref(const BcsrMatrix& A,
+                          int br,
+                          int n0,
+                          int n1,
+                          const float* B,
+                          int ldb,
+                          const float* bias,
+                          float* C,
+                          int ldc) {
+  const int R = A.block_rows;
+  const int rows = std::min(R, A.rows - br * R);
+  for (int r = 0; r < rows; ++r) {
+    float* c = C + static_cast<int64_t>(br * R + r) * ldc;
+    std::fill(c + n0, c + n1, bias ? bias[br * R + r] : 0.f);
+    for (int32_t b = A.row_ptr[br]; b < A.row_ptr[br + 1]; ++b) {
+      const float v = A.values[b * R + r];
+      const float* row = B + static_cast<int64_t>(A.col_idx[b]) * ldb;
+      for (int n = n0; n < n1; ++n) c[n] += v * row[n];
+    }
+  }
+}
+
+// dst = src^T of the rows x cols src, by blocks of 8 x 8.
+void transpose_fp32(
+    int rows, int cols, const float* src, int lds, float* dst, int ldd) {
+  const int kBlock = 8;
+  for (int i0 = 0; i0 < rows; i0 += kBlock) {
+    for (int j0 = 0; j0 < cols; j0 += kBlock) {
+      for (int i = i0; i < std::min(rows, i0 + kBlock); ++i) {
+        for (int j = j0; j < std::min(cols, j0 + kBlock); ++j) {
+          dst[static_cast<int64_t>(j) * ldd + i] =
+              src[static_cast<int64_t>(i) * lds + j];
+        }
+      }
+    }
+  }
+}
+
+// The rows of C of block row br when N is 1, a sparse matrix-vector
+// product, the blocks of 4 rows in a sse vector.
+void sparse_block_row_gemv(const BcsrMatrix& A,
+                           int br,
+                           const float* B,
+                           int ldb,
+                           const float* bias,
+                           float* C,
+                           int ldc) {
+  const int R = A.block_rows;
+  const int rows = std::min(R, A.rows - br * R);
+  const int32_t b1 = A.row_ptr[br + 1];
+  int32_t b = A.row_ptr[br];
+  float sum[4] = {0.f, 0.f, 0.f, 0.f};
+  if (R == 4) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; b + 2 <= b1; b += 2) {
+      __m128 x0 = _mm_set1_ps(B[static_cast<int64_t>(A.col_idx[b]) * ldb]);
+      __m128 x1 =
+          _mm_set1_ps(B[static_cast<int64_t>(A.col_idx[b + 1]) * ldb]);
+      acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(A.values + b * 4), x0));
+      acc1 = _mm_add_ps(acc1,
+                        _mm_mul_ps(_mm_loadu_ps(A.values + b * 4 + 4), x1));
+    }
+    if (b < b1) {
+      __m128 x0 = _mm_set1_ps(B[static_cast<int64_t>(A.col_idx[b]) * ldb]);
+      acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(A.values + b * 4), x0));
+    }
+    _mm_storeu_ps(sum, _mm_add_ps(acc0, acc1));
+  } else {
+    for (; b + 4 <= b1; b += 4) {
+      for (int i = 0; i < 4; ++i) {
+        sum[i] += A.values[b + i] *
+                  B[static_cast<int64_t>(A.col_idx[b + i]) * ldb];
+      }
+    }
+    for (; b < b1; ++b) {
+      sum[0] += A.values[b] * B[static_cast<int64_t>(A.col_idx[b]) * ldb];
+    }
+    sum[0] += sum[1] + sum[2] + sum[3];
+  }
+  for (int r = 0; r < rows; ++r) {
+    const int row = br * R + r;
+    C[static_cast<int64_t>(row) * ldc] = sum[r] + (bias ? bias[row] : 0.f);
+  }
+}
+
+//******************************* avx2 ***************************************
+X86_TARGET_AVX2 inline __m256i block_mask_avx2(int n) {
+  return n >= 8 ? _mm256_set1_epi32(-1) : tail_mask_avx2(n);
+}
+
+// The rows of C of block row br, the accumulators spelled out so that they
+// stay in registers without the loops being unrolled by the compiler.
+X86_TARGET_AVX2 void sparse_row_avx2(const BcsrMatrix& A,
+                                     int br,
+                                     int n0,
+                                     int n1,
+                                     const float* B,
+                                     int ldb,
+                                     const float* bias,
+                                     float* C,
+                                     int ldc) {
+  const int32_t b0 = A.row_ptr[br];
+  const int32_t b1 = A.row_ptr[br + 1];
+  const __m256 vbias = _mm256_set1_ps(bias ? bias[br] : 0.f);
+  float* c = C + static_cast<int64_t>(br) * ldc;
+  int n = n0;
+  // 32 columns, 4 chains of fma in flight.
+  for (; n + 32 <= n1; n += 32) {
+    __m256 acc0 = vbias;
+    __m256 acc1 = vbias;
+    __m256 acc2 = vbias;
+    __m256 acc3 = vbias;
+    for (int32_t b = b0; b < b1; ++b) {
+      const float* row = B + static_cast<int64_t>(A.col_idx[b]) * ldb + n;
+      __m256 w = _mm256_broadcast_ss(A.values + b);
+      acc0 = _mm256_fmadd_ps(w, _mm256_loadu_ps(row), acc0);
+      acc1 = _mm256_fmadd_ps(w, _mm256_loadu_ps(row + 8), acc1);
+      acc2 = _mm256_fmadd_ps(w, _mm256_loadu_ps(row + 16), acc2);
+      acc3 = _mm256_fmadd_ps(w, _mm256_loadu_ps(row + 24), acc3);
+    }
+    _mm256_storeu_ps(c + n, acc0);
+    _mm256_storeu_ps(c + n + 8, acc1);
+    _mm256_storeu_ps(c + n + 16, acc2);
+    _mm256_storeu_ps(c + n + 24, acc3);
+  }
+  for (; n < n1; n += 8) {
+    const __m256i mask = block_mask_avx2(n1 - n);
+    __m256 acc = vbias;
+    for (int32_t b = b0; b < b1; ++b) {
+      __m256 x = _mm256_maskload_ps(
+          B + static_cast<int64_t>(A.col_idx[b]) * ldb + n, mask);
+      acc = _mm256_fmadd_ps(_mm256_broadcast_ss(A.values + b), x, acc);
+    }
+    _mm256_maskstore_ps(c + n, mask, acc);
+  }
+}
+
+// The 4 rows of C of block row br, every load of B being shared by the 4
+// rows. The rows past M of the last block row are computed from the zeros
+// of the padding and dropped.
+X86_TARGET_AVX2 void sparse_block4_avx2(const BcsrMatrix& A,
+                                        int br,
+                                        int n0,
+                                        int n1,
+                                        const float* B,
+                                        int ldb,
+                                        const float* bias,
+                                        float* C,
+                                        int ldc) {
+  const int rows = std::min(4, A.rows - br * 4);
+  const int32_t b0 = A.row_ptr[br];
+  const int32_t b1 = A.row_ptr[br + 1];
+  float bias4[4] = {0.f, 0.f, 0.f, 0.f};
+  float* c[4];
+  for (int r = 0; r < 4; ++r) {
+    const int row = br * 4 + std::min(r, rows - 1);
+    if (bias && r < rows) bias4[r] = bias[row];
+    c[r] = C + static_cast<int64_t>(row) * ldc;
+  }
+  const __m256 vbias0 = _mm256_set1_ps(bias4[0]);
+  const __m256 vbias1 = _mm256_set1_ps(bias4[1]);
+  const __m256 vbias2 = _mm256_set1_ps(bias4[2]);
+  const __m256 vbias3 = _mm256_set1_ps(bias4[3]);
+  int n = n0;
+  // 16 columns of 4 rows.
+  for (; n + 16 <= n1; n += 16) {
+    __m256 acc00 = vbias0, acc01 = vbias0;
+    __m256 acc10 = vbias1, acc11 = vbias1;
+    __m256 acc20 = vbias2, acc21 = vbias2;
+    __m256 acc30 = vbias3, acc31 = vbias3;
+    for (int32_t b = b0; b < b1; ++b) {
+      const float* row = B + static_cast<int64_t>(A.col_idx[b]) * ldb + n;
+      const float* v = A.values + b * 4;
+      __m256 x0 = _mm256_loadu_ps(row);
+      __m256 x1 = _mm256_loadu_ps(row + 8);
+      __m256 w = _mm256_broadcast_ss(v);
+      acc00 = _mm256_fmadd_ps(w, x0, acc00);
+      acc01 = _mm256_fmadd_ps(w, x1, acc01);
+      w = _mm256_broadcast_ss(v + 1);
+      acc10 = _mm256_fmadd_ps(w, x0, acc10);
+      acc11 = _mm256_fmadd_ps(w, x1, acc11);
+      w = _mm256_broadcast_ss(v + 2);
+      acc20 = _mm256_fmadd_ps(w, x0, acc20);
+      acc21 = _mm256_fmadd_ps(w, x1, acc21);
+      w = _mm256_broadcast_ss(v + 3);
+      acc30 = _mm256_fmadd_ps(w, x0, acc30);
+      acc31 = _mm256_fmadd_ps(w, x1, acc31);
+    }
+    // The rows past M store to the last row, which is written last.
+    _mm256_storeu_ps(c[3] + n, acc30);
+    _mm256_storeu_ps(c[3] + n + 8, acc31);
+    _mm256_storeu_ps(c[2] + n, acc20);
+    _mm256_storeu_ps(c[2] + n + 8, acc21);
+    _mm256_storeu_ps(c[1] + n, acc10);
+    _mm256_storeu_ps(c[1] + n + 8, acc11);
+    _mm256_storeu_ps(c[0] + n, acc00);
+    _mm256_storeu_ps(c[0] + n + 8, acc01);
+  }
+  for (; n < n1; n += 8) {
+    const __m256i mask = block_mask_avx2(n1 - n);
+    __m256 acc0 = vbias0;
+    __m256 acc1 = vbias1;
+    __m256 acc2 = vbias2;
+    __m256 acc3 = vbias3;
+    for (int32_t b = b0; b < b1; ++b) {
+      __m256 x = _mm256_maskload_ps(
+          B + static_cast<int64_t>(A.col_idx[b]) * ldb + n, mask);
+      const float* v = A.values + b * 4;
+      acc0 = _mm256_fmadd_ps(_mm256_broadcast_ss(v), x, acc0);
+      acc1 = _mm256_fmadd_ps(_mm256_broadcast_ss(v + 1), x, acc1);
+      acc2 = _mm256_fmadd_ps(_mm256_broadcast_ss(v + 2), x, acc2);
+      acc3 = _mm256_fmadd_ps(_mm256_broadcast_ss(v + 3), x, acc3);
+    }
+    _mm256_maskstore_ps(c[3] + n, mask, acc3);
+    _mm256_maskstore_ps(c[2] + n, mask, acc2);
+    _mm256_maskstore_ps(c[1] + n, mask, acc1);
+    _mm256_maskstore_ps(c[0] + n, mask, acc0);
+  }
+}
+
+}  // namespace
+
+int64_t bcsr_blocks(const float* a, int M, int K, int lda, int block_rows) {
+  int64_t blocks = 0;
+  for (int i = 0; i < M; i += block_rows) {
+    for (int k = 0; k < K; ++k) {
+      blocks += block_column_nonzero(a, M, lda, block_rows, i, k);
+    }
+  }
+  return blocks;
+}
+
+void bcsr_pack(const float* a,
+               int M,
+               int K,
+               int lda,
+               int block_rows,
+               float* values,
+               int32_t* row_ptr,
+               int32_t* col_idx) {
+  int32_t blocks = 0;
+  row_ptr[0] = 0;
+  for (int i = 0; i < M; i += block_rows) {
+    for (int k = 0; k < K; ++k) {
+      if (!block_column_nonzero(a, M, lda, block_rows, i, k)) continue;
+      for (int r = 0; r < block_rows; ++r) {
+        values[blocks * block_rows + r] =
+            i + r < M ? a[static_cast<int64_t>(i + r) * lda + k] : 0.f;
+      }
+      col_idx[blocks++] = k;
+    }
+    row_ptr[i / block_rows + 1] = blocks;
+  }
+}
+
+void sparse_gemm_fp32(const BcsrMatrix& A,
+                      int N,
+                      const float* B,
+                      int ldb,
+                      const float* bias,
+                      float* C,
+                      int ldc) {
+  if (A.rows <= 0 || N <= 0) return;
+  const bool use_avx2 = avx2_available();
+  const int R = A.block_rows;
+  const int row_blocks = (A.rows + R - 1) / R;
+  const int chunks = (N + kNChunk - 1) / kNChunk;
+  const int64_t work = static_cast<int64_t>(row_blocks) * chunks;
+  const int64_t size = static_cast<int64_t>(A.row_ptr[row_blocks]) * R * N;
+  const int tasks = static_cast<int>(std::max<int64_t>(
+      1,
+      std::min<int64_t>(std::min<int64_t>(ThreadPool::CurrentThreadNum(), work),
+                        size / kTaskSize)));
+  LITE_PARALLEL_BEGIN(t, tid, tasks) {
+    for (int64_t w = work * t / tasks; w < work * (t + 1) / tasks; ++w) {
+      const int br = static_cast<int>(w / chunks);
+      const int n0 = static_cast<int>(w % chunks) * kNChunk;
+      const int n1 = std::min(N, n0 + kNChunk);
+      if (N == 1) {
+        sparse_block_row_gemv(A, br, B, ldb, bias, C, ldc);
+      } else if (!use_avx2) {
+        sparse_block_row_ref(A, br, n0, n1, B, ldb, bias, C, ldc);
+      } else if (R == 4) {
+        sparse_block4_avx2(A, br, n0, n1, B, ldb, bias, C, ldc);
+      } else {
+        sparse_row_avx2(A, br, n0, n1, B, ldb, bias, C, ldc);
+      }
+    }
+  }
+  LITE_PARALLEL_END();
+}
+
+std::shared_ptr<const SparseGemmWeight> SparseGemmWeight::Create(
+    const float* W, int K, int N, int ldw) {
+  std::vector<float> w_trans(static_cast<int64_t>(N) * K);
+  transpose_fp32(K, N, W, ldw, w_trans.data(), K);
+  const int64_t blocks1 = bcsr_blocks(w_trans.data(), N, K, K, 1);
+  const int64_t blocks4 = bcsr_blocks(w_trans.data(), N, K, K, 4);
+  const int R = blocks1 * 2 >= blocks4 * 4 ? 4 : 1;
+  const int64_t blocks = R == 4 ? blocks4 : blocks1;
+
+  std::shared_ptr<SparseGemmWeight> weight(new SparseGemmWeight());
+  weight->values_.resize(blocks * R);
+  weight->row_ptr_.resize((N + R - 1) / R + 1);
+  weight->col_idx_.resize(blocks);
+  bcsr_pack(w_trans.data(),
+            N,
+            K,
+            K,
+            R,
+            weight->values_.data(),
+            weight->row_ptr_.data(),
+            weight->col_idx_.data());
+  BcsrMatrix& matrix = weight->matrix_;
+  matrix.rows = N;
+  matrix.cols = K;
+  matrix.block_rows = R;
+  matrix.values = weight->values_.data();
+  matrix.row_ptr = weight->row_ptr_.data();
+  matrix.col_idx = weight->col_idx_.data();
+  return weight;
+}
+
+void SparseGemmWeight::Compute(int M,
+                               const float* A,
+                               int lda,
+                               const float* bias,
+                               float* C,
+                               int ldc) const {
+  const int K = matrix_.cols;
+  const int N = matrix_.rows;
+  if (M == 1) {
+    // A^T and C^T are columns, the rows of A and C as they are.
+    sparse_gemm_fp32(matrix_, 1, A, 1, bias, C, 1);
+    return;
+  }
+  auto& workspace = WorkSpace::Global_X86();
+  size_t workspace_mark = workspace.cursor();
+  float* a_trans = workspace.Alloc<float>(static_cast<int64_t>(K) * M);
+  float* c_trans = workspace.Alloc<float>(static_cast<int64_t>(N) * M);
+  transpose_fp32(M, K, A, lda, a_trans, M);
+  sparse_gemm_fp32(matrix_, M, a_trans, M, bias, c_trans, M);
+  transpose_fp32(N, M, c_trans, M, C, ldc);
+  workspace.Rewind(workspace_mark);
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,115 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+/*
+ * A sparse M x K matrix in the blocked CSR format. The rows are taken by
+ * blocks of block_rows, 1 or 4, and a block row keeps the columns where one
+ * of its rows is not zero: col_idx[b] is the column of the b-th block and
+ * values[b * block_rows + r] the element of its row r, zero if only the
+ * other rows are not. The blocks of block row i are [row_ptr[i],
+ * row_ptr[i + 1]).
+ */
+struct BcsrMatrix {
+  int rows{0};
+  int cols{0};
+  int block_rows{1};
+  const float* values{nullptr};
+  const int32_t* row_ptr{nullptr};
+  const int32_t* col_idx{nullptr};
+};
+
+// The blocks of the BCSR of the dense M x K a, lda floats per row, which
+// the values take block_rows floats each and col_idx one int.
+int64_t bcsr_blocks(const float* a, int M, int K, int lda, int block_rows);
+
+// Pack the dense a into values, row_ptr, ceil(M / block_rows) + 1 ints, and
+// col_idx.
+void bcsr_pack(const float* a,
+               int M,
+               int K,
+               int lda,
+               int block_rows,
+               float* values,
+               int32_t* row_ptr,
+               int32_t* col_idx);
+
+/*
+ * C = A * B + bias of the sparse M x K A, e.g. the pruned weight of a 1x1
+ * conv2d, and the dense K x N B, ldb floats per row. bias, of M floats, may
+ * be null.
+ *
+ * The columns of B and C are taken by blocks of 32, or of 16 for the block
+ * rows of 4: every non-zero of A broadcast is multiplied with a row of a
+ * block of B, which is read as is, so the loops need no gather. The block
+ * rows of 4 share the loads of B across 4 rows of C. A single column, a
+ * matrix-vector product, is summed along the rows of A instead. The rows and
+ * the column blocks are split across the threads.
+ */
+void sparse_gemm_fp32(const BcsrMatrix& A,
+                      int N,
+                      const float* B,
+                      int ldb,
+                      const float* bias,
+                      float* C,
+                      int ldc);
+
+/*
+ * SparseGemmWeight holds a constant pruned K x N weight W, e.g. the weight
+ * of fc or mul, as the BCSR of W^T. C = A * W + bias is run as
+ * C^T = W^T * A^T + bias so that the columns of sparse_gemm_fp32 are the M
+ * rows of A, A and C being transposed through the workspace when M > 1.
+ */
+class SparseGemmWeight {
+ public:
+  // The BCSR of W, row major with `ldw` floats per row. The rows of W^T are
+  // taken by 4 when its blocks of 4 rows are at least half full.
+  static std::shared_ptr<const SparseGemmWeight> Create(const float* W,
+                                                        int K,
+                                                        int N,
+                                                        int ldw);
+
+  // C = A * W + bias of the M x K A, bias may be null.
+  void Compute(int M,
+               const float* A,
+               int lda,
+               const float* bias,
+               float* C,
+               int ldc) const;
+
+  int K() const { return matrix_.cols; }
+  int N() const { return matrix_.rows; }
+
+ private:
+  SparseGemmWeight() = default;
+
+  std::vector<float> values_;
+  std::vector<int32_t> row_ptr_;
+  std::vector<int32_t> col_idx_;
+  BcsrMatrix matrix_;
+};
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,92 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <immintrin.h>
+#include "lite/backends/x86/cpu_info.h"
+
+// The AVX2 kernels are built for their instruction set whatever the flags of
+// the library are, and picked at runtime by avx2_available().
+#if defined(_MSC_VER)
+#define X86_TARGET_AVX2
+#else
+#define X86_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+
+namespace paddle {
+namespace lite {
+namespace x86 {
+namespace math {
+
+inline bool avx2_available() {
+#if defined(__AVX2__) && defined(__FMA__)
+  return true;
+#else
+  // Every cpu with AVX2 has FMA too.
+  static const bool available = MayIUse(avx2);
+  return available;
+#endif
+}
+
+X86_TARGET_AVX2 inline __m256 exp_avx2(__m256 x) {
+  // exp(x) = 2^n * exp(g), g = x - n * ln2 in [-ln2 / 2, ln2 / 2]. The
+  // results under exp(-87) are not flushed to zero, which a softmax ignores.
+  x = _mm256_min_ps(x, _mm256_set1_ps(88.3762626647949f));
+  x = _mm256_max_ps(x, _mm256_set1_ps(-87.3365447504f));
+  __m256 n = _mm256_round_ps(
+      _mm256_mul_ps(x, _mm256_set1_ps(1.44269504088896341f)),
+      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  __m256 g = _mm256_fnmadd_ps(n, _mm256_set1_ps(0.693359375f), x);
+  g = _mm256_fnmadd_ps(n, _mm256_set1_ps(-2.12194440e-4f), g);
+  __m256 y = _mm256_set1_ps(1.9875691500E-4f);
+  y = _mm256_fmadd_ps(y, g, _mm256_set1_ps(1.3981999507E-3f));
+  y = _mm256_fmadd_ps(y, g, _mm256_set1_ps(8.3334519073E-3f));
+  y = _mm256_fmadd_ps(y, g, _mm256_set1_ps(4.1665795894E-2f));
+  y = _mm256_fmadd_ps(y, g, _mm256_set1_ps(1.6666665459E-1f));
+  y = _mm256_fmadd_ps(y, g, _mm256_set1_ps(5.0000001201E-1f));
+  y = _mm256_fmadd_ps(y, _mm256_mul_ps(g, g), g);
+  y = _mm256_add_ps(y, _mm256_set1_ps(1.f));
+  __m256i e = _mm256_slli_epi32(
+      _mm256_add_epi32(_mm256_cvtps_epi32(n), _mm256_set1_epi32(127)), 23);
+  return _mm256_mul_ps(y, _mm256_castsi256_ps(e));
+}
+
+X86_TARGET_AVX2 inline float hmax_avx2(__m256 x) {
+  __m128 m =
+      _mm_max_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+  m = _mm_max_ps(m, _mm_movehl_ps(m, m));
+  m = _mm_max_ss(m, _mm_movehdup_ps(m));
+  return _mm_cvtss_f32(m);
+}
+
+X86_TARGET_AVX2 inline float hsum_avx2(__m256 x) {
+  __m128 s =
+      _mm_add_ps(_mm256_castps256_ps128(x), _mm256_extractf128_ps(x, 1));
+  s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+  s = _mm_add_ss(s, _mm_movehdup_ps(s));
+  return _mm_cvtss_f32(s);
+}
+
+// The mask of the first n < 8 lanes for _mm256_maskload_ps and
+// _mm256_maskstore_ps.
+X86_TARGET_AVX2 inline __m256i tail_mask_avx2(int n) {
+  return _mm256_cmpgt_epi32(_mm256_set1_epi32(n),
+                            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+}  // namespace math
+}  // namespace x86
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,204 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/inter_op_scheduler.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>  //NOLINT
+
+namespace paddle {
+namespace lite {
+
+namespace {
+
+// The ops reading or writing variables that are not in their inputs or
+// outputs.
+const std::set<std::string> kBarrierOps = {
+    "while", "conditional_block", "subgraph", "feed", "fetch"};
+
+// Number of idle polls before a lane parks until some work shows up.
+const int kSpinCount = 1024;
+
+}  // namespace
+
+void InterOpScheduler::AddEdge(int from, int to) {
+  // The edges towards `to` are all added while `to` is visited, a duplicate
+  // is always the last successor.
+  if (!successors_[from].empty() && successors_[from].back() == to) return;
+  successors_[from].push_back(to);
+  ++dependency_num_[to];
+}
+
+void InterOpScheduler::Init(const std::vector<const OpLite*>& ops) {
+  const int op_num = static_cast<int>(ops.size());
+  active_.assign(op_num, false);
+  successors_.assign(op_num, std::vector<int>());
+  dependency_num_.assign(op_num, 0);
+  active_num_ = 0;
+
+  std::map<std::string, int> last_writer;
+  // The readers of each variable since its last writer.
+  std::map<std::string, std::vector<int>> readers;
+  int last_barrier = -1;
+  std::vector<int> since_barrier;
+  for (int i = 0; i < op_num; ++i) {
+    if (!ops[i]) continue;
+    active_[i] = true;
+    ++active_num_;
+    auto* op_info = ops[i]->op_info();
+    if (kBarrierOps.count(op_info->Type())) {
+      for (int j : since_barrier) {
+        AddEdge(j, i);
+      }
+      if (since_barrier.empty() && last_barrier >= 0) {
+        AddEdge(last_barrier, i);
+      }
+      // The later ops depend on the barrier, which depends on all the
+      // earlier ones.
+      since_barrier.clear();
+      last_writer.clear();
+      readers.clear();
+      last_barrier = i;
+      continue;
+    }
+    if (last_barrier >= 0) {
+      AddEdge(last_barrier, i);
+    }
+    since_barrier.push_back(i);
+    for (auto& name : op_info->input_names()) {
+      auto it = last_writer.find(name);
+      if (it != last_writer.end()) {
+        AddEdge(it->second, i);
+      }
+      readers[name].push_back(i);
+    }
+    for (auto& name : op_info->output_names()) {
+      auto it = last_writer.find(name);
+      if (it != last_writer.end() && it->second != i) {
+        AddEdge(it->second, i);
+      }
+      for (int reader : readers[name]) {
+        if (reader != i) AddEdge(reader, i);
+      }
+      readers[name].clear();
+      last_writer[name] = i;
+    }
+  }
+
+  // The edges always go forward, one pass in the execution order finds the
+  // longest chain.
+  std::vector<int> depth(op_num, 1);
+  critical_path_ = 0;
+  for (int i = 0; i < op_num; ++i) {
+    if (!active_[i]) continue;
+    critical_path_ = std::max(critical_path_, depth[i]);
+    for (int succ : successors_[i]) {
+      depth[succ] = std::max(depth[succ], depth[i] + 1);
+    }
+  }
+  pending_.reset(new std::atomic<int>[op_num]);
+  ready_.reserve(op_num);
+}
+
+bool InterOpScheduler::PopReady(int* idx) {
+  if (ready_num_.load(std::memory_order_relaxed) == 0) return false;
+  std::lock_guard<std::mutex> lock(ready_mutex_);
+  if (ready_.empty()) return false;
+  *idx = ready_.back();
+  ready_.pop_back();
+  ready_num_.store(static_cast<int>(ready_.size()));
+  return true;
+}
+
+void InterOpScheduler::PushReady(ThreadPool* pool, int idx) {
+  {
+    std::lock_guard<std::mutex> lock(ready_mutex_);
+    ready_.push_back(idx);
+    ready_num_.store(static_cast<int>(ready_.size()));
+  }
+  pool->Notify();
+}
+
+void InterOpScheduler::RunLane(ThreadPool* pool,
+                               const std::function<void(int)>& run_op) {
+  int next = -1;
+  int idle = 0;
+  while (true) {
+    if (next < 0 && !PopReady(&next)) {
+      if (remaining_.load(std::memory_order_acquire) == 0) break;
+      if (pool->RunPendingChunk()) {
+        idle = 0;
+      } else if (++idle > kSpinCount) {
+        // A ready op, the end of the run or a chunk published after the
+        // epoch is read all bump it, so none of them is missed.
+        int epoch = pool->epoch();
+        if (ready_num_.load() == 0 && remaining_.load() > 0) {
+          pool->WaitForWork(epoch);
+        }
+        idle = 0;
+      } else {
+        std::this_thread::yield();
+      }
+      continue;
+    }
+    idle = 0;
+    run_op(next);
+    int done = next;
+    next = -1;
+    // Go on with the first successor made ready, it likely reads the data
+    // still in the cache of this core.
+    for (int succ : successors_[done]) {
+      if (pending_[succ].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (next < 0) {
+          next = succ;
+        } else {
+          PushReady(pool, succ);
+        }
+      }
+    }
+    if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      pool->Notify();
+    }
+  }
+}
+
+void InterOpScheduler::Run(ThreadPool* pool,
+                           const std::function<void(int)>& run_op) {
+  const int op_num = static_cast<int>(successors_.size());
+  if (!pool || pool->thread_num() <= 1 || critical_path_ >= active_num_) {
+    for (int i = 0; i < op_num; ++i) {
+      if (active_[i]) run_op(i);
+    }
+    return;
+  }
+  ready_.clear();
+  // The ready list is a stack, the earliest ops are pushed last.
+  for (int i = op_num - 1; i >= 0; --i) {
+    pending_[i].store(dependency_num_[i], std::memory_order_relaxed);
+    if (active_[i] && dependency_num_[i] == 0) {
+      ready_.push_back(i);
+    }
+  }
+  ready_num_.store(static_cast<int>(ready_.size()));
+  remaining_.store(active_num_);
+  pool->ParallelFor([&](int, int) { RunLane(pool, run_op); },
+                    pool->thread_num(),
+                    0,
+                    1);
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,87 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>  //NOLINT
+#include <vector>
+#include "lite/core/op_lite.h"
+#include "lite/core/thread_pool.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * InterOpScheduler runs the ops of a program that don't depend on each other
+ * at the same time.
+ *
+ * The dependencies are built once from the variable names the ops read and
+ * write: an op runs after the last writer of each of its inputs, and after
+ * the last writer and the readers since then of each of its outputs, so that
+ * every variable sees its reads and writes in the sequential order. The
+ * variables merged by the memory_optimize_pass share a name and are ordered
+ * the same way. The ops running sub-blocks or subgraphs touch variables they
+ * don't declare, they are barriers ordered against all the other ops.
+ *
+ * One lane per worker of the thread pool takes the ready ops. A lane finishing
+ * an op goes on with one of the successors it made ready, and a lane with no
+ * ready op helps with the parallel loops of the kernels running on the other
+ * lanes, so the inter-op and the intra-op parallelism share the same threads
+ * and never oversubscribe the cores. A lane that stays idle parks on the
+ * epoch of the pool, which is bumped by new ready ops, new chunks and the end
+ * of the run.
+ */
+class InterOpScheduler {
+ public:
+  // Build the dependencies of `ops` in the execution order, the null ones are
+  // not run.
+  void Init(const std::vector<const OpLite*>& ops);
+
+  // Call `run_op(i)` for every op, each one after the ops it depends on, on
+  // the lanes of `pool`. The ops run in the sequential order without a pool.
+  void Run(ThreadPool* pool, const std::function<void(int)>& run_op);
+
+  size_t size() const { return successors_.size(); }
+  // The ops that wait for op `idx`.
+  const std::vector<int>& successors(int idx) const {
+    return successors_[idx];
+  }
+  // The number of ops on the longest chain of dependent ops.
+  int critical_path() const { return critical_path_; }
+
+ private:
+  void AddEdge(int from, int to);
+  bool PopReady(int* idx);
+  void PushReady(ThreadPool* pool, int idx);
+  void RunLane(ThreadPool* pool, const std::function<void(int)>& run_op);
+
+  std::vector<bool> active_;
+  std::vector<std::vector<int>> successors_;
+  std::vector<int> dependency_num_;
+  int active_num_{0};
+  int critical_path_{0};
+
+  // The state of the current run.
+  std::unique_ptr<std::atomic<int>[]> pending_;
+  std::atomic<int> remaining_{0};
+  std::mutex ready_mutex_;
+  std::vector<int> ready_;
+  // The size of ready_, read by the idle lanes without the lock.
+  std::atomic<int> ready_num_{0};
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,182 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/inter_op_scheduler.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>  //NOLINT
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>  //NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+class FakeOp : public OpLite {
+ public:
+  explicit FakeOp(const std::string& type) : OpLite(type) {}
+  bool AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) override {
+    return true;
+  }
+  void AttachKernel(KernelBase* kernel) override {}
+  std::string DebugString() const override { return op_type_; }
+};
+
+class InterOpSchedulerTest : public ::testing::Test {
+ protected:
+  void AddOp(const std::string& type,
+             const std::vector<std::string>& inputs,
+             const std::vector<std::string>& outputs) {
+    cpp::OpDesc desc;
+    desc.SetType(type);
+    desc.SetInput("X", inputs);
+    desc.SetOutput("Out", outputs);
+    std::unique_ptr<FakeOp> op(new FakeOp(type));
+    op->Attach(desc, &scope_);
+    ops_.push_back(std::move(op));
+  }
+
+  std::vector<const OpLite*> ops() const {
+    std::vector<const OpLite*> res;
+    for (auto& op : ops_) res.push_back(op.get());
+    return res;
+  }
+
+  Scope scope_;
+  std::vector<std::unique_ptr<OpLite>> ops_;
+};
+
+TEST_F(InterOpSchedulerTest, dependencies) {
+  AddOp("relu", {"x"}, {"a"});                 // 0
+  AddOp("relu", {"a"}, {"b"});                 // 1
+  AddOp("sigmoid", {"a"}, {"c"});              // 2
+  AddOp("elementwise_add", {"b", "c"}, {"d"});  // 3
+  AddOp("scale", {"d"}, {"a"});                // 4, overwrites a
+  InterOpScheduler scheduler;
+  scheduler.Init(ops());
+  ASSERT_EQ(scheduler.size(), 5u);
+  EXPECT_EQ(scheduler.successors(0), std::vector<int>({1, 2, 4}));
+  EXPECT_EQ(scheduler.successors(1), std::vector<int>({3, 4}));
+  EXPECT_EQ(scheduler.successors(2), std::vector<int>({3, 4}));
+  EXPECT_EQ(scheduler.successors(3), std::vector<int>({4}));
+  EXPECT_TRUE(scheduler.successors(4).empty());
+  EXPECT_EQ(scheduler.critical_path(), 4);
+}
+
+TEST_F(InterOpSchedulerTest, barrier) {
+  AddOp("relu", {"x"}, {"a"});
+  AddOp("relu", {"y"}, {"b"});
+  AddOp("while", {"c"}, {"d"});
+  AddOp("relu", {"z"}, {"e"});
+  InterOpScheduler scheduler;
+  scheduler.Init(ops());
+  EXPECT_EQ(scheduler.successors(0), std::vector<int>({2}));
+  EXPECT_EQ(scheduler.successors(1), std::vector<int>({2}));
+  EXPECT_EQ(scheduler.successors(2), std::vector<int>({3}));
+  EXPECT_EQ(scheduler.critical_path(), 3);
+}
+
+TEST_F(InterOpSchedulerTest, parallel_run) {
+  // Eight branches of four ops each, joined by a concat.
+  const int branch_num = 8, depth = 4;
+  std::vector<std::string> tails;
+  for (int b = 0; b < branch_num; ++b) {
+    std::string in = "x";
+    for (int d = 0; d < depth; ++d) {
+      std::string out = "b" + std::to_string(b) + "_" + std::to_string(d);
+      AddOp("relu", {in}, {out});
+      in = out;
+    }
+    tails.push_back(in);
+  }
+  AddOp("concat", tails, {"out"});
+  InterOpScheduler scheduler;
+  auto op_list = ops();
+  // A skipped op, like a feed.
+  op_list.insert(op_list.begin(), nullptr);
+  scheduler.Init(op_list);
+  EXPECT_EQ(scheduler.critical_path(), depth + 1);
+
+  auto pool = ThreadPool::Create(4);
+  const int op_num = static_cast<int>(op_list.size());
+  std::vector<std::atomic<int>> done(op_num);
+  std::atomic<int> running{0}, max_running{0};
+  std::atomic<bool> order_ok{true};
+  for (int repeat = 0; repeat < 10; ++repeat) {
+    for (auto& d : done) d = 0;
+    scheduler.Run(pool.get(), [&](int i) {
+      EXPECT_NE(op_list[i], nullptr);
+      for (int j = 0; j < op_num; ++j) {
+        for (int succ : scheduler.successors(j)) {
+          if (succ == i && done[j] == 0) order_ok = false;
+        }
+      }
+      int now = ++running;
+      int prev = max_running.load();
+      while (now > prev && !max_running.compare_exchange_weak(prev, now)) {
+      }
+      // The parallel loops of the kernels are helped by the idle lanes.
+      std::vector<int> hits(64, 0);
+      ThreadPool::Enqueue(std::make_pair(
+          std::function<void(int, int)>([&](int k, int) { hits[k]++; }),
+          64));
+      for (int h : hits) EXPECT_EQ(h, 1);
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+      --running;
+      done[i]++;
+    });
+    EXPECT_EQ(done[0], 0);
+    for (int i = 1; i < op_num; ++i) {
+      EXPECT_EQ(done[i], 1) << "op " << i;
+    }
+  }
+  EXPECT_TRUE(order_ok);
+  EXPECT_GT(max_running, 1);
+}
+
+TEST_F(InterOpSchedulerTest, idle_lanes_park) {
+  AddOp("relu", {"x"}, {"a"});
+  AddOp("relu", {"y"}, {"b"});
+  InterOpScheduler scheduler;
+  scheduler.Init(ops());
+  auto pool = ThreadPool::Create(4);
+  // Three lanes wait for one slow op, they must not burn their cores.
+  std::clock_t cpu_begin = std::clock();
+  auto begin = std::chrono::steady_clock::now();
+  scheduler.Run(pool.get(), [&](int i) {
+    if (i == 0) std::this_thread::sleep_for(std::chrono::milliseconds(200));
+  });
+  double wall = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - begin)
+                    .count();
+  double cpu = static_cast<double>(std::clock() - cpu_begin) / CLOCKS_PER_SEC;
+  EXPECT_GE(wall, 0.2);
+  EXPECT_LT(cpu, 0.5 * wall);
+}
+
+TEST_F(InterOpSchedulerTest, sequential_without_pool) {
+  AddOp("relu", {"x"}, {"a"});
+  AddOp("relu", {"y"}, {"b"});
+  InterOpScheduler scheduler;
+  scheduler.Init(ops());
+  std::vector<int> order;
+  scheduler.Run(nullptr, [&](int i) { order.push_back(i); });
+  EXPECT_EQ(order, std::vector<int>({0, 1}));
+}
+
+}  // namespace lite
+}  // namespace paddle
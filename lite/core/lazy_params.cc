@@ -0,0 +1,73 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/lazy_params.h"
+#include <utility>
+
+namespace paddle {
+namespace lite {
+
+void LazyParams::Add(const std::string& name, Tensor* tensor, Loader loader) {
+  CHECK(tensor);
+  CHECK(loader);
+  std::unique_ptr<Param> param(new Param);
+  param->tensor = tensor;
+  param->loader = std::move(loader);
+  params_[name] = std::move(param);
+}
+
+void LazyParams::AddTransform(const std::string& name, Loader transform) {
+  auto it = params_.find(name);
+  CHECK(it != params_.end()) << "Param " << name << " is not lazy";
+  std::lock_guard<std::mutex> lock(it->second->mutex);
+  if (it->second->loaded) {
+    transform(it->second->tensor);
+  } else {
+    it->second->transforms.push_back(std::move(transform));
+  }
+}
+
+void LazyParams::LoadParam(Param* param) {
+  if (param->loaded.load(std::memory_order_acquire)) return;
+  std::lock_guard<std::mutex> lock(param->mutex);
+  if (param->loaded.load(std::memory_order_relaxed)) return;
+  param->loader(param->tensor);
+  for (auto& transform : param->transforms) {
+    transform(param->tensor);
+  }
+  // Release the mapped file or the buffers held by the functions.
+  param->loader = nullptr;
+  param->transforms.clear();
+  loaded_num_++;
+  loaded_bytes_ += param->tensor->memory_size();
+  param->loaded.store(true, std::memory_order_release);
+}
+
+void LazyParams::Load(const std::vector<std::string>& names) {
+  for (auto& name : names) {
+    auto it = params_.find(name);
+    if (it != params_.end()) {
+      LoadParam(it->second.get());
+    }
+  }
+}
+
+void LazyParams::LoadAll() {
+  for (auto& param : params_) {
+    LoadParam(param.second.get());
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
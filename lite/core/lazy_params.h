@@ -0,0 +1,79 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * LazyParams holds the params whose data is loaded on first use. The loader
+ * of a model sets the dims and the precision of such a param and registers
+ * a function reading its data, typically from a mapped model file. The
+ * transforms registered later on, e.g. the dequantization of the weights,
+ * run right after the data is read.
+ *
+ * An instruction loads the params among its inputs before its first run,
+ * i.e. before the PrepareForRun of its kernel, so the params of the ops that
+ * never run are never read. Load may be called from different threads, every
+ * param is loaded once. Each param has a lock of its own, so the threads
+ * loading different params, e.g. the clones of a predictor sharing the
+ * params, don't wait for each other.
+ */
+class LazyParams {
+ public:
+  typedef std::function<void(Tensor*)> Loader;
+
+  void Add(const std::string& name, Tensor* tensor, Loader loader);
+  // Run `transform` on the param once it is loaded, right away if it is.
+  void AddTransform(const std::string& name, Loader transform);
+  bool Has(const std::string& name) const { return params_.count(name) > 0; }
+
+  // Load the params among `names`, the other names are skipped.
+  void Load(const std::vector<std::string>& names);
+  void LoadAll();
+
+  size_t size() const { return params_.size(); }
+  size_t loaded_num() const { return loaded_num_; }
+  // The bytes of the loaded params, after their transforms.
+  int64_t loaded_bytes() const { return loaded_bytes_; }
+
+ private:
+  struct Param {
+    Tensor* tensor{nullptr};
+    Loader loader;
+    std::vector<Loader> transforms;
+    std::atomic<bool> loaded{false};
+    // Guards `loader` and `transforms` until the param is loaded.
+    std::mutex mutex;
+  };
+  void LoadParam(Param* param);
+
+  // Fixed once the predictor is built, only `loaded` changes later.
+  std::map<std::string, std::unique_ptr<Param>> params_;
+  std::atomic<size_t> loaded_num_{0};
+  std::atomic<int64_t> loaded_bytes_{0};
+};
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,128 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/lazy_params.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>  //NOLINT
+#include <thread>  //NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(LazyParams, load_on_demand) {
+  Tensor w, b;
+  w.Resize({2, 3});
+  b.Resize({3});
+  int w_loads = 0, b_loads = 0;
+  LazyParams params;
+  params.Add("w", &w, [&](Tensor* tensor) {
+    ++w_loads;
+    float* data = tensor->mutable_data<float>();
+    for (int i = 0; i < 6; ++i) data[i] = i;
+  });
+  params.Add("b", &b, [&](Tensor* tensor) {
+    ++b_loads;
+    tensor->mutable_data<float>()[0] = 1.f;
+  });
+  // Transforms run in order once the data is read.
+  params.AddTransform("w", [](Tensor* tensor) {
+    float* data = tensor->mutable_data<float>();
+    for (int i = 0; i < 6; ++i) data[i] *= 2.f;
+  });
+  params.AddTransform("w", [](Tensor* tensor) {
+    tensor->mutable_data<float>()[0] = -1.f;
+  });
+  EXPECT_TRUE(params.Has("w"));
+  EXPECT_FALSE(params.Has("x"));
+  EXPECT_EQ(params.size(), 2u);
+  EXPECT_EQ(params.loaded_num(), 0u);
+
+  params.Load({"x", "w"});
+  params.Load({"w"});
+  EXPECT_EQ(w_loads, 1);
+  EXPECT_EQ(b_loads, 0);
+  EXPECT_EQ(w.data<float>()[0], -1.f);
+  EXPECT_EQ(w.data<float>()[5], 10.f);
+  EXPECT_EQ(params.loaded_num(), 1u);
+  EXPECT_EQ(params.loaded_bytes(), 6 * sizeof(float));
+
+  // A transform of a loaded param runs right away.
+  params.AddTransform("w", [](Tensor* tensor) {
+    tensor->mutable_data<float>()[1] = 7.f;
+  });
+  EXPECT_EQ(w.data<float>()[1], 7.f);
+
+  params.LoadAll();
+  EXPECT_EQ(w_loads, 1);
+  EXPECT_EQ(b_loads, 1);
+  EXPECT_EQ(params.loaded_num(), 2u);
+}
+
+TEST(LazyParams, concurrent_load) {
+  const int param_num = 16, thread_num = 4;
+  std::vector<Tensor> tensors(param_num);
+  std::vector<std::string> names;
+  std::atomic<int> loads{0};
+  LazyParams params;
+  for (int i = 0; i < param_num; ++i) {
+    names.push_back("w" + std::to_string(i));
+    tensors[i].Resize({64});
+    params.Add(names.back(), &tensors[i], [&, i](Tensor* tensor) {
+      ++loads;
+      float* data = tensor->mutable_data<float>();
+      for (int k = 0; k < 64; ++k) data[k] = i;
+    });
+  }
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&]() { params.Load(names); });
+  }
+  for (auto& t : threads) t.join();
+  EXPECT_EQ(loads, param_num);
+  for (int i = 0; i < param_num; ++i) {
+    EXPECT_EQ(tensors[i].data<float>()[63], i);
+  }
+}
+
+TEST(LazyParams, parallel_loads_of_different_params) {
+  Tensor a, b;
+  a.Resize({1});
+  b.Resize({1});
+  std::atomic<int> started{0};
+  // Each loader waits for the other one to start, which only happens if
+  // the two params are loaded at the same time.
+  auto loader = [&](Tensor* tensor) {
+    ++started;
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (started < 2 && std::chrono::steady_clock::now() < deadline) {
+      std::this_thread::yield();
+    }
+    tensor->mutable_data<float>()[0] = started;
+  };
+  LazyParams params;
+  params.Add("a", &a, loader);
+  params.Add("b", &b, loader);
+  std::thread ta([&]() { params.Load({"a"}); });
+  std::thread tb([&]() { params.Load({"b"}); });
+  ta.join();
+  tb.join();
+  EXPECT_EQ(a.data<float>()[0], 2.f);
+  EXPECT_EQ(b.data<float>()[0], 2.f);
+}
+
+}  // namespace lite
+}  // namespace paddle
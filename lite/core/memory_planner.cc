@@ -0,0 +1,167 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/memory_planner.h"
+#include <algorithm>
+#include <limits>
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+constexpr size_t MemoryPlanner::kAlignment;
+
+int MemoryPlanner::AddTensor(size_t size, int first_use, int last_use) {
+  CHECK_LE(first_use, last_use);
+  Block block;
+  block.size = (size + kAlignment - 1) / kAlignment * kAlignment;
+  block.first_use = first_use;
+  block.last_use = last_use;
+  block.offset = 0;
+  blocks_.push_back(block);
+  return static_cast<int>(blocks_.size()) - 1;
+}
+
+size_t MemoryPlanner::Plan() {
+  std::vector<int> order(blocks_.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = static_cast<int>(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return blocks_[a].size > blocks_[b].size;
+  });
+
+  arena_size_ = 0;
+  std::vector<int> placed;
+  std::vector<int> alive;
+  for (int id : order) {
+    auto& block = blocks_[id];
+    alive.clear();
+    for (int other : placed) {
+      if (blocks_[other].first_use <= block.last_use &&
+          block.first_use <= blocks_[other].last_use) {
+        alive.push_back(other);
+      }
+    }
+    std::sort(alive.begin(), alive.end(), [&](int a, int b) {
+      return blocks_[a].offset < blocks_[b].offset;
+    });
+    // Look for the smallest gap that fits, the space above the highest
+    // tensor is the gap of last resort.
+    size_t best_offset = 0;
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    size_t cursor = 0;
+    for (int other : alive) {
+      if (blocks_[other].offset >= cursor) {
+        size_t gap = blocks_[other].offset - cursor;
+        if (gap >= block.size && gap < best_gap) {
+          best_gap = gap;
+          best_offset = cursor;
+        }
+      }
+      cursor = std::max(cursor, blocks_[other].offset + blocks_[other].size);
+    }
+    block.offset =
+        best_gap == std::numeric_limits<size_t>::max() ? cursor : best_offset;
+    arena_size_ = std::max(arena_size_, block.offset + block.size);
+    placed.push_back(id);
+  }
+  return arena_size_;
+}
+
+size_t MemoryPlanner::naive_size() const {
+  size_t size = 0;
+  for (auto& block : blocks_) {
+    size += block.size;
+  }
+  return size;
+}
+
+void ArenaBuffer::ResetLazy(TargetType target, size_t size) {
+  bool host = target == TARGET(kHost) || target == TARGET(kX86) ||
+              target == TARGET(kARM);
+  if (arena_ && host && size <= space_) {
+    target_ = target;
+    return;
+  }
+  if (arena_) {
+    // Let the base class allocate a buffer of its own.
+    arena_.reset();
+    data_ = nullptr;
+    space_ = 0;
+    own_data_ = true;
+  }
+  Buffer::ResetLazy(target, size);
+}
+
+std::shared_ptr<Buffer> PlanScopeTensors(
+    Scope* scope,
+    const std::map<std::string, std::pair<int, int>>& lifetimes,
+    MemoryPlanner* planner) {
+  // The number of tensors holding every buffer, whatever their offsets.
+  std::map<const void*, int> data_refs;
+  auto add_ref = [&](const Tensor& tensor) {
+    if (tensor.IsInitialized()) {
+      data_refs[static_cast<const char*>(tensor.raw_data()) -
+                tensor.offset()]++;
+    }
+  };
+  for (const Scope* s = scope; s; s = s->parent()) {
+    for (auto& name : s->LocalVarNames()) {
+      auto* var = s->FindLocalVar(name);
+      if (var->IsType<Tensor>()) {
+        add_ref(var->Get<Tensor>());
+      } else if (var->IsType<std::vector<Tensor>>()) {
+        for (auto& tensor : var->Get<std::vector<Tensor>>()) {
+          add_ref(tensor);
+        }
+      }
+    }
+  }
+
+  auto is_host = [](TargetType x) -> bool {
+    return x == TARGET(kHost) || x == TARGET(kX86) || x == TARGET(kARM);
+  };
+  std::vector<std::pair<Tensor*, int>> planned_tensors;
+  for (auto& item : lifetimes) {
+    auto* var = scope->FindLocalVar(item.first);
+    if (!var || !var->IsType<Tensor>()) continue;
+    auto* tensor = var->GetMutable<Tensor>();
+    if (!tensor->IsInitialized() || tensor->memory_size() == 0 ||
+        tensor->offset() != 0 || tensor->persistable() ||
+        !is_host(tensor->target()) || data_refs[tensor->raw_data()] > 1) {
+      continue;
+    }
+    int id = planner->AddTensor(
+        tensor->memory_size(), item.second.first, item.second.second);
+    planned_tensors.emplace_back(tensor, id);
+  }
+  if (planned_tensors.empty()) return nullptr;
+
+  size_t arena_size = planner->Plan();
+  auto arena = std::make_shared<Buffer>();
+  arena->ResetLazy(TARGET(kHost), arena_size);
+  for (auto& item : planned_tensors) {
+    auto* tensor = item.first;
+    auto buffer = std::make_shared<ArenaBuffer>(arena,
+                                                planner->offset(item.second),
+                                                tensor->memory_size(),
+                                                tensor->target());
+    tensor->ResetBuffer(buffer, tensor->memory_size());
+  }
+  return arena;
+}
+
+}  // namespace lite
+}  // namespace paddle
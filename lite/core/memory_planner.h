@@ -0,0 +1,102 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/core/memory.h"
+#include "lite/core/scope.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * MemoryPlanner assigns every tensor a fixed offset inside one arena, tensors
+ * whose lifetimes overlap never share a byte.
+ *
+ * The tensors are placed from the largest to the smallest, each one goes into
+ * the smallest gap left between the already placed tensors that are alive at
+ * the same time, or on top of them if no gap is large enough.
+ */
+class MemoryPlanner {
+ public:
+  static constexpr size_t kAlignment = 64;
+
+  // Register a tensor of `size` bytes that is alive from step `first_use` to
+  // step `last_use`, both inclusive, and return its id.
+  int AddTensor(size_t size, int first_use, int last_use);
+
+  // Assign the offsets and return the size of the arena.
+  size_t Plan();
+
+  size_t offset(int id) const { return blocks_[id].offset; }
+  int num_tensors() const { return static_cast<int>(blocks_.size()); }
+  size_t arena_size() const { return arena_size_; }
+  // The memory needed if every tensor had a buffer of its own.
+  size_t naive_size() const;
+
+ private:
+  struct Block {
+    size_t size;
+    int first_use;
+    int last_use;
+    size_t offset;
+  };
+
+  std::vector<Block> blocks_;
+  size_t arena_size_{0};
+};
+
+/*
+ * A buffer that lives inside an arena made by MemoryPlanner. It is used as is
+ * as long as the tensor fits into its slice, and leaves the arena for a buffer
+ * of its own once the tensor grows beyond it, i.e. when the shapes changed
+ * since the plan was made.
+ */
+class ArenaBuffer : public Buffer {
+ public:
+  ArenaBuffer(const std::shared_ptr<Buffer>& arena,
+              size_t offset,
+              size_t size,
+              TargetType target)
+      : Buffer(static_cast<char*>(arena->data()) + offset, target, size),
+        arena_(arena) {}
+
+  void ResetLazy(TargetType target, size_t size) override;
+
+  bool in_arena() const { return arena_ != nullptr; }
+
+ private:
+  std::shared_ptr<Buffer> arena_;
+};
+
+/*
+ * Place the host tensors of `scope` named in `lifetimes` into one arena, a
+ * lifetime being the first and the last step using the tensor.
+ *
+ * A tensor sharing its buffer with any other tensor of the scope or of its
+ * parents, e.g. by ShareDataWith() in a kernel or in the feed and fetch
+ * lists, is left alone, as the other tensor may outlive it. Returns the arena
+ * or null if no tensor is planned, the sizes are kept by `planner`.
+ */
+std::shared_ptr<Buffer> PlanScopeTensors(
+    Scope* scope,
+    const std::map<std::string, std::pair<int, int>>& lifetimes,
+    MemoryPlanner* planner);
+
+}  // namespace lite
+}  // namespace paddle
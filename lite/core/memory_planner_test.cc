@@ -0,0 +1,131 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/memory_planner.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/core/scope.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+TEST(memory_planner, chain) {
+  // a -> b -> c -> d, every tensor is only alive with its neighbours.
+  MemoryPlanner planner;
+  int a = planner.AddTensor(1000, 0, 1);
+  int b = planner.AddTensor(4000, 1, 2);
+  int c = planner.AddTensor(1000, 2, 3);
+  int d = planner.AddTensor(2000, 3, 4);
+  size_t arena_size = planner.Plan();
+  EXPECT_EQ(planner.naive_size(), 1024u + 4032u + 1024u + 2048u);
+  // b is the peak, a and c fit beside it and d reuses the slot of b.
+  EXPECT_EQ(arena_size, 4032u + 1024u);
+  EXPECT_EQ(planner.offset(a) % MemoryPlanner::kAlignment, 0u);
+  EXPECT_EQ(planner.offset(a), planner.offset(c));
+  EXPECT_EQ(planner.offset(b), planner.offset(d));
+}
+
+TEST(memory_planner, no_overlap) {
+  MemoryPlanner planner;
+  std::vector<std::vector<int>> tensors;
+  for (int i = 0; i < 64; ++i) {
+    int size = 64 * (1 + (i * 37) % 11);
+    int first_use = (i * 13) % 40;
+    int last_use = first_use + (i * 7) % 9;
+    tensors.push_back({planner.AddTensor(size, first_use, last_use),
+                       size,
+                       first_use,
+                       last_use});
+  }
+  size_t arena_size = planner.Plan();
+  EXPECT_LE(arena_size, planner.naive_size());
+  for (auto& x : tensors) {
+    EXPECT_LE(planner.offset(x[0]) + x[1], arena_size);
+    for (auto& y : tensors) {
+      if (x[0] == y[0] || x[3] < y[2] || y[3] < x[2]) continue;
+      bool disjoint = planner.offset(x[0]) + x[1] <= planner.offset(y[0]) ||
+                      planner.offset(y[0]) + y[1] <= planner.offset(x[0]);
+      EXPECT_TRUE(disjoint) << "tensor " << x[0] << " and " << y[0];
+    }
+  }
+}
+
+TEST(memory_planner, arena_buffer) {
+  auto arena = std::make_shared<Buffer>();
+  arena->ResetLazy(TARGET(kHost), 1024);
+  Tensor tensor;
+  tensor.Resize({64});
+  tensor.ResetBuffer(
+      std::make_shared<ArenaBuffer>(arena, 512, 512, TARGET(kX86)), 0);
+  // Fits into the slice, whatever host target it is asked for.
+  EXPECT_EQ(tensor.mutable_data<float>(TARGET(kHost)),
+            reinterpret_cast<float*>(static_cast<char*>(arena->data()) + 512));
+  EXPECT_EQ(tensor.mutable_data<float>(),
+            reinterpret_cast<float*>(static_cast<char*>(arena->data()) + 512));
+  // Outgrows the slice and gets a buffer of its own.
+  tensor.Resize({1024});
+  auto* data = tensor.mutable_data<float>();
+  EXPECT_NE(data,
+            reinterpret_cast<float*>(static_cast<char*>(arena->data()) + 512));
+  data[1023] = 1.f;
+}
+
+TEST(memory_planner, plan_scope_tensors) {
+  // a -> b -> c -> d -> e of 1024 floats each, c is shared by the output of a
+  // concat of one input and e by the fetch list of the parent scope.
+  Scope scope;
+  auto& exec_scope = scope.NewScope();
+  std::map<std::string, std::pair<int, int>> lifetimes;
+  const std::vector<std::string> names{"a", "b", "c", "d", "e"};
+  for (size_t i = 0; i < names.size(); ++i) {
+    auto* tensor = exec_scope.NewTensor(names[i]);
+    tensor->Resize({1024});
+    tensor->mutable_data<float>();
+    lifetimes[names[i]] = std::make_pair(static_cast<int>(i),
+                                         static_cast<int>(i) + 1);
+  }
+  exec_scope.NewTensor("concat_out")
+      ->ShareDataWith(*exec_scope.FindTensor("c"));
+  auto* fetch_list = scope.NewTensorList("fetch");
+  fetch_list->resize(1);
+  fetch_list->at(0).ShareDataWith(*exec_scope.FindTensor("e"));
+  const void* c_data = exec_scope.FindTensor("c")->raw_data();
+  const void* e_data = exec_scope.FindTensor("e")->raw_data();
+
+  MemoryPlanner planner;
+  auto arena = PlanScopeTensors(&exec_scope, lifetimes, &planner);
+  ASSERT_TRUE(arena);
+  EXPECT_EQ(planner.num_tensors(), 3);
+  EXPECT_EQ(planner.naive_size(), 3 * 4096u);
+  // b is alive with a, d reuses the slice of one of them.
+  EXPECT_EQ(planner.arena_size(), 2 * 4096u);
+  EXPECT_LT(planner.arena_size(), planner.naive_size());
+  auto* arena_begin = static_cast<char*>(arena->data());
+  for (auto& name : {"a", "b", "d"}) {
+    auto* data =
+        static_cast<const char*>(exec_scope.FindTensor(name)->raw_data());
+    EXPECT_GE(data, arena_begin) << name;
+    EXPECT_LT(data, arena_begin + planner.arena_size()) << name;
+  }
+  EXPECT_EQ(exec_scope.FindTensor("c")->raw_data(), c_data);
+  EXPECT_EQ(exec_scope.FindTensor("e")->raw_data(), e_data);
+}
+
+}  // namespace lite
+}  // namespace paddle
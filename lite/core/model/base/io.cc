@@ -13,6 +13,12 @@
 // limitations under the License.
 
 #include "lite/core/model/base/io.h"
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace paddle {
 namespace lite {
@@ -63,6 +69,44 @@ void BinaryFileWriter::Write(const void* src, size_t size) const {
   cur_ += size;
 }
 
+#if !defined(_WIN32)
+MappedFile::MappedFile(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY);
+  CHECK_GE(fd, 0) << "Unable to open file: " << path;
+  struct stat st;
+  CHECK_EQ(fstat(fd, &st), 0) << "Unable to stat file: " << path;
+  length_ = static_cast<size_t>(st.st_size);
+  if (length_ > 0) {
+    void* data = mmap(
+        nullptr, length_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    CHECK(data != MAP_FAILED) << "Unable to map file: " << path;
+    data_ = static_cast<char*>(data);
+  }
+  // The mapping stays valid after the descriptor is closed.
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    munmap(data_, length_);
+  }
+}
+
+void MappedFileReader::Read(void* dst, size_t size) const {
+  CHECK(dst);
+  CHECK_LE(cur_ + size, file_->length()) << "Failed to read " << size
+                                         << " bytes.";
+  lite::TargetCopy(TargetType::kHost, dst, file_->data() + cur_, size);
+  cur_ += size;
+}
+
+void MappedFileReader::Skip(size_t size) const {
+  CHECK_LE(cur_ + size, file_->length()) << "Failed to skip " << size
+                                         << " bytes.";
+  cur_ += size;
+}
+#endif
+
 void StringBufferReader::Read(void* dst, size_t size) const {
   CHECK(dst);
   lite::TargetCopy(TargetType::kHost, dst, buf_ + cur_, size);
@@ -75,6 +75,56 @@ class Buffer {
   size_t size_{0};
 };
 
+#if !defined(_WIN32)
+// A whole file mapped into memory. The pages are mapped copy-on-write, so
+// the tensors aliasing them may be written in place without touching the
+// file, and the unwritten pages stay shared by all the processes mapping it.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+  const char* data() const { return data_; }
+  size_t length() const { return length_; }
+
+ private:
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  char* data_{nullptr};
+  size_t length_{0};
+};
+
+// A non-owning host buffer over a region of a mapped file, which keeps the
+// file mapped. Like an unowned buffer it keeps the region as long as it
+// fits, and switches to memory of its own once it has to grow.
+class MappedBuffer : public lite::Buffer {
+ public:
+  MappedBuffer(const void* data,
+               size_t size,
+               const std::shared_ptr<MappedFile>& file)
+      : lite::Buffer(const_cast<void*>(data), TargetType::kHost, size),
+        file_(file) {}
+
+  void ResetLazy(TargetType target, size_t size) override {
+    if (!own_data_ && (target != target_ || space_ < size)) {
+      Free();
+      own_data_ = true;
+    }
+    lite::Buffer::ResetLazy(target, size);
+  }
+
+  void Free() override {
+    lite::Buffer::Free();
+    file_.reset();
+  }
+
+ private:
+  std::shared_ptr<MappedFile> file_;
+};
+#else
+class MappedFile;
+#endif
+
 class ByteReader {
  public:
   ByteReader() = default;
@@ -83,6 +133,10 @@ class ByteReader {
   virtual size_t length() const = 0;
   virtual size_t current() const = 0;
   virtual bool ReachEnd() const = 0;
+  virtual void Skip(size_t size) const { ReadToString(size); }
+  // The file the reader reads from if it is mapped into memory, in which
+  // case current() is an offset into it.
+  virtual std::shared_ptr<MappedFile> mapped_file() const { return nullptr; }
 
   template <typename T,
             typename = typename std::enable_if<
@@ -119,6 +173,8 @@ class ByteWriter {
 
   virtual size_t Align(size_t bytes_size) const = 0;
 
+  virtual size_t current() const = 0;
+
   virtual ~ByteWriter() = default;
 
  private:
@@ -157,6 +213,7 @@ class BinaryFileWriter : public ByteWriter {
     }
   }
   void Write(const void* src, size_t size) const override;
+  size_t current() const override { return cur_; }
 
   // Fill a number of zero characters to align the number
   // of written bytes to a certain position.
@@ -179,6 +236,25 @@ class BinaryFileWriter : public ByteWriter {
   }
 };
 
+#if !defined(_WIN32)
+// Reads a file through a read-only mapping of it, see MappedFile.
+class MappedFileReader : public ByteReader {
+ public:
+  explicit MappedFileReader(const std::string& path)
+      : file_(std::make_shared<MappedFile>(path)) {}
+  void Read(void* dst, size_t size) const override;
+  void Skip(size_t size) const override;
+  bool ReachEnd() const override { return cur_ >= file_->length(); }
+  size_t length() const override { return file_->length(); }
+  size_t current() const override { return cur_; }
+  std::shared_ptr<MappedFile> mapped_file() const override { return file_; }
+
+ private:
+  std::shared_ptr<MappedFile> file_;
+  mutable size_t cur_{0};
+};
+#endif
+
 class StringBufferReader : public ByteReader {
  public:
   explicit StringBufferReader(const std::string& buffer)
@@ -0,0 +1,78 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/bf16_attribute_pass.h"
+#include <set>
+#include <string>
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Whether the picked kernel of node reads the input in_node as bf16.
+static bool IsBF16Weight(Node* node, Node* in_node) {
+  auto& kernel = node->AsStmt().picked_kernel();
+  if (kernel.precision() != PRECISION(kBF16)) return false;
+  std::string arg_name;
+  if (!node->AsStmt().op_info()->GetInputArgname(in_node->arg()->name,
+                                                 &arg_name)) {
+    return false;
+  }
+  auto precision = kernel.GetInputDeclType(arg_name)->precision();
+  return precision == PRECISION(kBF16) || precision == PRECISION(kAny);
+}
+
+void BF16AttributePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // The weights read as fp32 by some kernel stay fp32.
+  std::set<std::string> fp32_weights;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    for (auto* in_node : node->inlinks) {
+      if (in_node->IsArg() && in_node->arg()->is_weight &&
+          !IsBF16Weight(node, in_node)) {
+        fp32_weights.insert(in_node->arg()->name);
+      }
+    }
+  }
+
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    OpInfo* op_info = node->stmt()->mutable_op_info();
+    auto* scope = node->stmt()->op()->scope();
+    for (auto* in_node : node->inlinks) {
+      CHECK(in_node->IsArg()) << "The input node should be variable.";
+      const std::string& weight_name = in_node->arg()->name;
+      if (!in_node->arg()->is_weight || fp32_weights.count(weight_name) ||
+          !IsBF16Weight(node, in_node)) {
+        continue;
+      }
+      Tensor* weight = scope->FindVar(weight_name)->GetMutable<Tensor>();
+      CHECK(weight) << "Can not find the weight in scope.";
+      if (weight->precision() != PrecisionType::kFloat) {
+        LOG(INFO) << "The dtype of weight is not fp32, "
+                  << "so skip converting the weight of " << weight_name;
+        continue;
+      }
+      op_info->SetAttr<std::string>(weight_name + "_bf16", "bf16");
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(bf16_attribute_pass, paddle::lite::mir::BF16AttributePass)
+    .BindTargets({TARGET(kX86)});
@@ -0,0 +1,38 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <memory>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+/*
+ * Use bf16_attribute_pass to mark the weights of the x86 bf16 kernels.
+ * If the picked kernel of an op is kBF16, its fp32 weights declared kBF16 or
+ * kAny get a weight_name_bf16 attribute, unless another kernel reads them
+ * too. When the model is loaded, the light predictor converts the marked
+ * weights to bf16. The kernels keep a packed bf16 copy besides, so a weight
+ * and its pack take the memory of the fp32 weight alone, a third less than
+ * the fp32 weight and the pack.
+ */
+class BF16AttributePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,147 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/bf16_attribute_pass.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+using VarType = VarDescAPI::Type;
+
+void AddVar(cpp::BlockDesc* block_desc,
+            const std::string& name,
+            bool persistable) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(VarType::LOD_TENSOR);
+  var_desc->SetDataType(VarType::FP32);
+  var_desc->SetPersistable(persistable);
+}
+
+void AddOp(cpp::BlockDesc* block_desc,
+           const std::string& type,
+           const std::string& x,
+           const std::string& w,
+           const std::string& out) {
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType(type);
+  if (type == "fc") {
+    op_desc->SetInput("Input", {x});
+    op_desc->SetInput("W", {w});
+    op_desc->SetOutput("Out", {out});
+    op_desc->SetAttr("in_num_col_dims", 1);
+  } else {
+    op_desc->SetInput("X", {x});
+    op_desc->SetInput("Y", {w});
+    op_desc->SetOutput("Out", {out});
+    op_desc->SetAttr("x_num_col_dims", 1);
+    op_desc->SetAttr("y_num_col_dims", 1);
+  }
+}
+
+// fc1(x, w1, b1) -> out1, fc2(out1, w2) -> out2, mul3(out1, w2) -> out3 and
+// mul4(out1, w4) -> out4, w4 being int8.
+std::shared_ptr<cpp::ProgramDesc> BuildBF16Program(
+    const std::shared_ptr<Scope>& scope) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  block_desc->ClearOps();
+  block_desc->ClearVars();
+  for (auto name : {"x", "out1", "out2", "out3", "out4"}) {
+    AddVar(block_desc, name, false);
+  }
+  const std::map<std::string, std::vector<int64_t>> weights{
+      {"w1", {8, 4}}, {"b1", {4}}, {"w2", {4, 3}}, {"w4", {4, 3}}};
+  for (auto& weight : weights) {
+    AddVar(block_desc, weight.first, true);
+    auto* tensor = scope->Var(weight.first)->GetMutable<Tensor>();
+    tensor->Resize(weight.second);
+    if (weight.first == "w4") {
+      tensor->mutable_data<int8_t>();
+    } else {
+      tensor->mutable_data<float>();
+    }
+  }
+
+  AddOp(block_desc, "fc", "x", "w1", "out1");
+  block_desc->GetOp<cpp::OpDesc>(0)->SetInput("Bias", {"b1"});
+  AddOp(block_desc, "fc", "out1", "w2", "out2");
+  AddOp(block_desc, "mul", "out1", "w2", "out3");
+  AddOp(block_desc, "mul", "out1", "w4", "out4");
+  return program_desc;
+}
+
+TEST(bf16_attribute_pass, mark_bf16_weights) {
+  std::vector<Place> valid_places{{TARGET(kX86), PRECISION(kBF16)},
+                                  {TARGET(kX86), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  auto program_desc = BuildBF16Program(scope);
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, valid_places);
+
+  // The precision of the kernel picked for the op writing each output.
+  const std::map<std::string, PrecisionType> picked{
+      {"out1", PRECISION(kBF16)},
+      {"out2", PRECISION(kFloat)},
+      {"out3", PRECISION(kBF16)},
+      {"out4", PRECISION(kBF16)}};
+  std::map<std::string, OpInfo*> op_infos;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto& stmt = node->AsStmt();
+    const std::string out = stmt.op_info()->Output("Out").front();
+    auto& kernels = stmt.kernels();
+    auto it = std::find_if(kernels.begin(),
+                           kernels.end(),
+                           [&](const std::unique_ptr<KernelBase>& kernel) {
+                             return kernel->precision() == picked.at(out);
+                           });
+    ASSERT_TRUE(it != kernels.end()) << out;
+    std::iter_swap(kernels.begin(), it);
+    op_infos[out] = stmt.mutable_op_info();
+  }
+
+  BF16AttributePass pass;
+  pass.Apply(graph);
+
+  EXPECT_TRUE(op_infos["out1"]->HasAttr("w1_bf16"));
+  // The bias is read as float.
+  EXPECT_FALSE(op_infos["out1"]->HasAttr("b1_bf16"));
+  // w2 is read as float by the fp32 fc too.
+  EXPECT_FALSE(op_infos["out2"]->HasAttr("w2_bf16"));
+  EXPECT_FALSE(op_infos["out3"]->HasAttr("w2_bf16"));
+  // Only the float weights are converted.
+  EXPECT_FALSE(op_infos["out4"]->HasAttr("w4_bf16"));
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(fc);
+USE_LITE_OP(mul);
+USE_LITE_KERNEL(fc, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(fc, kX86, kBF16, kNCHW, def);
+USE_LITE_KERNEL(mul, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(mul, kX86, kBF16, kNCHW, def);
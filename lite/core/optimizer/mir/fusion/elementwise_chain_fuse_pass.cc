@@ -0,0 +1,261 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/elementwise_chain_fuse_pass.h"
+#include <list>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/optimizer/mir/pattern_matcher.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+bool IsElementwise(const std::string& op_type) {
+  return op_type == "elementwise_add" || op_type == "elementwise_sub" ||
+         op_type == "elementwise_mul" || op_type == "elementwise_div" ||
+         op_type == "elementwise_max" || op_type == "elementwise_min";
+}
+
+// The input or output argument node of an op by its name.
+Node* FindArg(const std::list<Node*>& links, const std::string& name) {
+  for (auto* link : links) {
+    if (link->IsArg() && link->AsArg().name == name) return link;
+  }
+  return nullptr;
+}
+
+// The tensors of the scope are of the shapes and the precisions of the var
+// descs, see Program::PrepareWorkspace(), the shapes being -1 in the unknown
+// dimensions.
+const Tensor* ScopeTensor(Node* node, const std::string& name) {
+  auto* var = node->stmt()->op()->scope()->FindVar(name);
+  return var && var->IsType<Tensor>() ? &var->Get<Tensor>() : nullptr;
+}
+
+bool IsFloatTensor(const Tensor* tensor) {
+  return tensor && tensor->precision() == PRECISION(kFloat);
+}
+
+// Whether the chain kernel reads y of the elementwise op as it is: y of
+// leading and trailing 1 broadcast to x, the dimensions left being those of
+// x and known. x broadcast to y, or y broadcast in the middle like a
+// [B, 1, 1, S] mask of [B, H, S, S] scores, are left to the unfused ops.
+bool IsChainBroadcast(const DDim& x_dims, const DDim& y_dims, int axis) {
+  const int x_rank = x_dims.size();
+  const int y_rank = y_dims.size();
+  if (x_rank == 0 || y_rank == 0 || y_rank > x_rank) return false;
+  if (axis == -1) axis = x_rank - y_rank;
+  if (axis < 0 || axis + y_rank > x_rank) return false;
+  int begin = 0;
+  int end = y_rank;
+  while (begin < end && y_dims[begin] == 1) ++begin;
+  while (end > begin && y_dims[end - 1] == 1) --end;
+  for (int j = begin; j < end; ++j) {
+    if (y_dims[j] <= 0 || y_dims[j] != x_dims[axis + j]) return false;
+  }
+  return true;
+}
+
+// The three attributes of an op of the chain, see FusionElementwiseChainOp.
+std::vector<float> ChainParams(const OpInfo* op_info) {
+  const std::string op_type = op_info->Type();
+  std::vector<float> params(3, 0.f);
+  if (op_type == "scale") {
+    float scale = op_info->GetAttr<float>("scale");
+    float bias = op_info->GetAttr<float>("bias");
+    params[0] = scale;
+    bool bias_after_scale = op_info->GetAttr<bool>("bias_after_scale");
+    params[1] = bias_after_scale ? bias : bias * scale;
+  } else if (op_type == "relu6" || op_type == "leaky_relu" ||
+             op_type == "swish") {
+    params[0] = op_info->GetAttr<float>(
+        op_type == "relu6" ? "threshold"
+                           : (op_type == "swish" ? "beta" : "alpha"));
+  } else if (op_type == "hard_swish") {
+    params[0] = op_info->GetAttr<float>("threshold");
+    params[1] = op_info->GetAttr<float>("scale");
+    params[2] = op_info->GetAttr<float>("offset");
+  }
+  return params;
+}
+
+}  // namespace
+
+bool ElementwiseChainFusePass::IsChainable(Node* node) {
+  if (!node->IsStmt()) return false;
+  const auto* op_info = node->stmt()->op_info();
+  const std::string op_type = op_info->Type();
+  if (op_info->HasAttr("enable_int8") &&
+      op_info->GetAttr<bool>("enable_int8")) {
+    return false;
+  }
+  if (!op_info->HasInput("X") || op_info->Input("X").size() != 1 ||
+      !op_info->HasOutput("Out") || op_info->Output("Out").size() != 1) {
+    return false;
+  }
+  // The kernel is of float only.
+  const auto* x = ScopeTensor(node, op_info->Input("X").front());
+  if (!IsFloatTensor(x) ||
+      !IsFloatTensor(ScopeTensor(node, op_info->Output("Out").front()))) {
+    return false;
+  }
+  if (IsElementwise(op_type)) {
+    if (!op_info->HasInput("Y") || op_info->Input("Y").size() != 1 ||
+        op_info->Input("Y").front() == op_info->Input("X").front()) {
+      return false;
+    }
+    const auto* y = ScopeTensor(node, op_info->Input("Y").front());
+    const int axis =
+        op_info->HasAttr("axis") ? op_info->GetAttr<int>("axis") : -1;
+    return IsFloatTensor(y) && IsChainBroadcast(x->dims(), y->dims(), axis);
+  }
+  if (op_type == "scale") {
+    // The scale of a tensor and the fused activations are left as they are.
+    if (op_info->HasInput("ScaleTensor") &&
+        !op_info->Input("ScaleTensor").empty()) {
+      return false;
+    }
+    return !op_info->HasAttr("activation_type") ||
+           op_info->GetAttr<std::string>("activation_type").empty();
+  }
+  return op_type == "relu" || op_type == "relu6" || op_type == "leaky_relu" ||
+         op_type == "sigmoid" || op_type == "tanh" || op_type == "swish" ||
+         op_type == "hard_swish";
+}
+
+Node* ElementwiseChainFusePass::NextOfChain(Node* node) {
+  const auto* op_info = node->stmt()->op_info();
+  auto* out = FindArg(node->outlinks, op_info->Output("Out").front());
+  if (!out || out->AsArg().is_weight || out->AsArg().is_persist ||
+      out->outlinks.size() != 1) {
+    return nullptr;
+  }
+  // The output must be the X of the next op, which is the only one reading
+  // it.
+  auto* next = out->outlinks.front();
+  if (!IsChainable(next)) return nullptr;
+  const auto* next_info = next->stmt()->op_info();
+  if (next_info->Input("X").front() != out->AsArg().name) return nullptr;
+  return next;
+}
+
+void ElementwiseChainFusePass::InsertNewNode(SSAGraph* graph,
+                                             const Chain& chain) {
+  cpp::OpDesc op_desc;
+  op_desc.SetType("fusion_elementwise_chain");
+  std::vector<std::string> y_names;
+  std::vector<Node*> y_nodes;
+  std::vector<std::string> ops;
+  std::vector<int> axes;
+  std::vector<float> params;
+  for (auto* node : chain.ops) {
+    const auto* op_info = node->stmt()->op_info();
+    const std::string op_type = op_info->Type();
+    int axis = -1;
+    if (IsElementwise(op_type)) {
+      const std::string y_name = op_info->Input("Y").front();
+      y_names.push_back(y_name);
+      y_nodes.push_back(FindArg(node->inlinks, y_name));
+      axis = op_info->GetAttr<int>("axis");
+    }
+    auto op_params = ChainParams(op_info);
+    ops.push_back(op_type);
+    axes.push_back(axis);
+    params.insert(params.end(), op_params.begin(), op_params.end());
+  }
+  op_desc.SetInput("X", {chain.in->AsArg().name});
+  op_desc.SetInput("Y", y_names);
+  op_desc.SetOutput("Out", {chain.out->AsArg().name});
+  op_desc.SetAttr("chain_ops", ops);
+  op_desc.SetAttr("chain_axes", axes);
+  op_desc.SetAttr("chain_params", params);
+
+  auto& first_op = chain.ops.front()->stmt()->op();
+  auto* scope = first_op->scope();
+  auto valid_places = first_op->valid_places();
+  auto chain_op = LiteOpRegistry::Global().Create("fusion_elementwise_chain");
+  chain_op->Attach(op_desc, scope);
+
+  // The ops and the vars between them.
+  std::set<const Node*> nodes2rm;
+  for (auto* node : chain.ops) {
+    nodes2rm.insert(node);
+    if (node != chain.ops.back()) {
+      nodes2rm.insert(node->outlinks.begin(), node->outlinks.end());
+    }
+  }
+  GraphSafeRemoveNodes(graph, nodes2rm);
+
+  auto* new_op_node = graph->GraphCreateInstructNode(chain_op, valid_places);
+  std::set<Node*> inputs;
+  inputs.insert(chain.in);
+  IR_NODE_LINK_TO(chain.in, new_op_node);
+  for (auto* y : y_nodes) {
+    if (inputs.insert(y).second) {
+      IR_NODE_LINK_TO(y, new_op_node);
+    }
+  }
+  IR_NODE_LINK_TO(new_op_node, chain.out);
+}
+
+void ElementwiseChainFusePass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // The blocked layout keeps its own elementwise ops and activations.
+  for (auto& place : graph->valid_places()) {
+    if (place.precision == PRECISION(kInt8) ||
+        place.layout == DATALAYOUT(kNCHW8c)) {
+      return;
+    }
+  }
+
+  // Grow the chains greedily from their first op, in the order of the
+  // program, and then replace those of at least two ops.
+  std::vector<Chain> chains;
+  std::set<Node*> chained;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (chained.count(node) || !IsChainable(node)) continue;
+    Chain chain;
+    chain.ops.push_back(node);
+    while (Node* next = NextOfChain(chain.ops.back())) {
+      chain.ops.push_back(next);
+    }
+    chained.insert(chain.ops.begin(), chain.ops.end());
+    if (chain.ops.size() < 2) continue;
+    const auto* first_info = node->stmt()->op_info();
+    const auto* last_info = chain.ops.back()->stmt()->op_info();
+    chain.in = FindArg(node->inlinks, first_info->Input("X").front());
+    chain.out =
+        FindArg(chain.ops.back()->outlinks, last_info->Output("Out").front());
+    if (!chain.in || !chain.out) continue;
+    chains.push_back(chain);
+  }
+  for (auto& chain : chains) {
+    VLOG(4) << "fuse a chain of " << chain.ops.size() << " elementwise ops";
+    InsertNewNode(graph.get(), chain);
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(lite_elementwise_chain_fuse_pass,
+                  paddle::lite::mir::ElementwiseChainFusePass)
+    .BindTargets({TARGET(kX86)})
+    .BindKernel("fusion_elementwise_chain");
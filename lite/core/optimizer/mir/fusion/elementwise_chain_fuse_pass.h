@@ -0,0 +1,51 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+// Fuse the chains of elementwise binary ops, scale and activations, each op
+// of which feeds only the next one, into a fusion_elementwise_chain that runs
+// the whole chain over every tile of its input in the cache.
+class ElementwiseChainFusePass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  // The ops of a chain, and its input and output.
+  struct Chain {
+    std::vector<Node*> ops;
+    Node* in{nullptr};
+    Node* out{nullptr};
+  };
+
+  bool IsChainable(Node* node);
+
+  // The next op of the chain ending by node, or null.
+  Node* NextOfChain(Node* node);
+
+  void InsertNewNode(SSAGraph* graph, const Chain& chain);
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,142 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/elementwise_chain_fuse_pass.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+using VarType = VarDescAPI::Type;
+
+// elementwise_add(x, y) -> scale -> relu of x of x_shape and y of
+// y_shape, y being a weight.
+std::shared_ptr<cpp::ProgramDesc> BuildChainProgram(
+    const std::shared_ptr<Scope>& scope,
+    const std::vector<int64_t>& x_shape,
+    const std::vector<int64_t>& y_shape,
+    VarType data_type) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  block_desc->ClearOps();
+  block_desc->ClearVars();
+  for (auto name : {"x", "add_out", "scale_out", "relu_out"}) {
+    auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+    var_desc->SetName(name);
+    var_desc->SetType(VarType::LOD_TENSOR);
+    var_desc->SetDataType(data_type);
+    var_desc->SetShape(x_shape);
+    var_desc->SetPersistable(false);
+  }
+  auto* y_desc = block_desc->AddVar<cpp::VarDesc>();
+  y_desc->SetName("y");
+  y_desc->SetType(VarType::LOD_TENSOR);
+  y_desc->SetDataType(data_type);
+  y_desc->SetShape(y_shape);
+  y_desc->SetPersistable(true);
+  auto* y = scope->Var("y")->GetMutable<Tensor>();
+  y->Resize(y_shape);
+  if (data_type == VarType::FP32) {
+    y->mutable_data<float>();
+  } else {
+    y->mutable_data<int32_t>();
+  }
+
+  auto* add = block_desc->AddOp<cpp::OpDesc>();
+  add->SetType("elementwise_add");
+  add->SetInput("X", {"x"});
+  add->SetInput("Y", {"y"});
+  add->SetOutput("Out", {"add_out"});
+  add->SetAttr("axis", -1);
+  auto* scale = block_desc->AddOp<cpp::OpDesc>();
+  scale->SetType("scale");
+  scale->SetInput("X", {"add_out"});
+  scale->SetOutput("Out", {"scale_out"});
+  scale->SetAttr("scale", 0.5f);
+  scale->SetAttr("bias", 0.1f);
+  scale->SetAttr("bias_after_scale", true);
+  auto* relu = block_desc->AddOp<cpp::OpDesc>();
+  relu->SetType("relu");
+  relu->SetInput("X", {"scale_out"});
+  relu->SetOutput("Out", {"relu_out"});
+  return program_desc;
+}
+
+// The op types of the program after the pass, and the number of each.
+std::map<std::string, int> FuseChains(const std::vector<int64_t>& x_shape,
+                                      const std::vector<int64_t>& y_shape,
+                                      VarType data_type = VarType::FP32) {
+  std::vector<Place> valid_places{{TARGET(kX86), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  auto program_desc = BuildChainProgram(scope, x_shape, y_shape, data_type);
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, valid_places);
+  ElementwiseChainFusePass pass;
+  pass.Apply(graph);
+  std::map<std::string, int> op_types;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    op_types[node->AsStmt().op_type()]++;
+  }
+  return op_types;
+}
+
+TEST(elementwise_chain_fuse_pass, fuse_trailing_broadcast) {
+  auto op_types = FuseChains({2, 4, 6, 6}, {6});
+  EXPECT_EQ(op_types.size(), 1u);
+  EXPECT_EQ(op_types["fusion_elementwise_chain"], 1);
+  op_types = FuseChains({-1, 4, 6, 6}, {1, 4, 1, 1});
+  EXPECT_EQ(op_types.size(), 1u);
+  EXPECT_EQ(op_types["fusion_elementwise_chain"], 1);
+}
+
+TEST(elementwise_chain_fuse_pass, keep_middle_broadcast) {
+  // The [B, 1, 1, S] mask is left to elementwise_add, scale and relu are
+  // still chained.
+  auto op_types = FuseChains({2, 4, 6, 6}, {2, 1, 1, 6});
+  EXPECT_EQ(op_types.size(), 2u);
+  EXPECT_EQ(op_types["elementwise_add"], 1);
+  EXPECT_EQ(op_types["fusion_elementwise_chain"], 1);
+}
+
+TEST(elementwise_chain_fuse_pass, keep_x_broadcast) {
+  auto op_types = FuseChains({2, 1, 6, 6}, {2, 4, 6, 6});
+  EXPECT_EQ(op_types["elementwise_add"], 1);
+  // The dims of y unknown in x.
+  op_types = FuseChains({2, -1, 6, 6}, {4, 6, 6});
+  EXPECT_EQ(op_types["elementwise_add"], 1);
+}
+
+TEST(elementwise_chain_fuse_pass, keep_int32) {
+  auto op_types = FuseChains({2, 4, 6, 6}, {6}, VarType::INT32);
+  EXPECT_EQ(op_types.size(), 3u);
+  EXPECT_EQ(op_types.count("fusion_elementwise_chain"), 0u);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(scale);
+USE_LITE_OP(relu);
+USE_LITE_OP(fusion_elementwise_chain);
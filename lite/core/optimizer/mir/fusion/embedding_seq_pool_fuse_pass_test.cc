@@ -0,0 +1,124 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/embedding_seq_pool_fuse_pass.h"
+#include <gtest/gtest.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+using VarType = VarDescAPI::Type;
+
+// lookup_table(ids, w) -> sequence_pool, the table being quantized to int8
+// by post_quant_dynamic_pass if quantized.
+std::shared_ptr<cpp::ProgramDesc> BuildEmbeddingProgram(
+    const std::shared_ptr<Scope>& scope, bool quantized) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  block_desc->ClearOps();
+  block_desc->ClearVars();
+  const std::vector<std::pair<std::string, VarType>> vars{
+      {"ids", VarType::INT64},
+      {"lookup_table_out", VarType::FP32},
+      {"out", VarType::FP32},
+      {"max_index", VarType::INT32}};
+  for (auto& var : vars) {
+    auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+    var_desc->SetName(var.first);
+    var_desc->SetType(VarType::LOD_TENSOR);
+    var_desc->SetDataType(var.second);
+    var_desc->SetPersistable(false);
+  }
+  auto* w_desc = block_desc->AddVar<cpp::VarDesc>();
+  w_desc->SetName("w");
+  w_desc->SetType(VarType::LOD_TENSOR);
+  w_desc->SetDataType(quantized ? VarType::INT8 : VarType::FP32);
+  w_desc->SetShape({100, 16});
+  w_desc->SetPersistable(true);
+  auto* w = scope->Var("w")->GetMutable<Tensor>();
+  w->Resize({100, 16});
+  if (quantized) {
+    w->mutable_data<int8_t>();
+  } else {
+    w->mutable_data<float>();
+  }
+
+  auto* lookup_table = block_desc->AddOp<cpp::OpDesc>();
+  lookup_table->SetType("lookup_table");
+  lookup_table->SetInput("Ids", {"ids"});
+  lookup_table->SetInput("W", {"w"});
+  lookup_table->SetOutput("Out", {"lookup_table_out"});
+  lookup_table->SetAttr<int64_t>("padding_idx", -1);
+  if (quantized) {
+    lookup_table->SetAttr<std::string>("quantization_type",
+                                       "post_weight_channel_wise_abs_max");
+    lookup_table->SetAttr("quantize_weight_bits", 8);
+    lookup_table->SetAttr("w_quant_scale", std::vector<float>(16, 0.01f));
+  }
+  auto* sequence_pool = block_desc->AddOp<cpp::OpDesc>();
+  sequence_pool->SetType("sequence_pool");
+  sequence_pool->SetInput("X", {"lookup_table_out"});
+  sequence_pool->SetOutput("Out", {"out"});
+  sequence_pool->SetOutput("MaxIndex", {"max_index"});
+  sequence_pool->SetAttr<std::string>("pooltype", "SUM");
+  return program_desc;
+}
+
+// The op types of the program after the pass, and the number of each.
+std::map<std::string, int> FuseEmbedding(bool quantized) {
+  std::vector<Place> valid_places{{TARGET(kX86), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  auto program_desc = BuildEmbeddingProgram(scope, quantized);
+  Program program(program_desc, scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, valid_places);
+  EmbeddingSeqPoolFusePass pass;
+  pass.Apply(graph);
+  std::map<std::string, int> op_types;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    op_types[node->AsStmt().op_type()]++;
+  }
+  return op_types;
+}
+
+TEST(embedding_seq_pool_fuse_pass, fuse_float_table) {
+  auto op_types = FuseEmbedding(false);
+  EXPECT_EQ(op_types.size(), 1u);
+  EXPECT_EQ(op_types["fused_embedding_seq_pool"], 1);
+}
+
+TEST(embedding_seq_pool_fuse_pass, keep_quantized_table) {
+  // The fused kernel would read the int8 table as float.
+  auto op_types = FuseEmbedding(true);
+  EXPECT_EQ(op_types.size(), 2u);
+  EXPECT_EQ(op_types["lookup_table"], 1);
+  EXPECT_EQ(op_types["sequence_pool"], 1);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(lookup_table);
+USE_LITE_OP(sequence_pool);
+USE_LITE_OP(fused_embedding_seq_pool);
@@ -0,0 +1,200 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/fusion/scaled_dot_product_attention_fuser.h"
+#include <memory>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+static DDim VarDims(const Node* op_node,
+                    const std::string& argument,
+                    bool is_input = true) {
+  auto* stmt = const_cast<Node*>(op_node)->stmt();
+  auto* op_info = stmt->op_info();
+  auto name = is_input ? op_info->Input(argument).front()
+                       : op_info->Output(argument).front();
+  return stmt->op()->scope()->FindVar(name)->Get<lite::Tensor>().dims();
+}
+
+static float MatmulAlpha(const OpInfo* op_info) {
+  return op_info->HasAttr("alpha") ? op_info->GetAttr<float>("alpha") : 1.f;
+}
+
+// y of matmul is batched as x or a single matrix, i.e. the matmul is a
+// batch of matrix products the attention kernel runs.
+static bool IsBatchedMatmul(const DDim& x_dims, const DDim& y_dims) {
+  if (x_dims.size() < 2) return false;
+  if (y_dims.size() == 2) return true;
+  if (y_dims.size() != x_dims.size()) return false;
+  for (size_t i = 0; i + 2 < x_dims.size(); ++i) {
+    if (x_dims[i] != y_dims[i]) return false;
+  }
+  return true;
+}
+
+void ScaledDotProductAttentionFuser::BuildPattern() {
+  const bool is_v2 = matmul_type_ == "matmul_v2";
+  const std::string trans_x = is_v2 ? "trans_x" : "transpose_X";
+  const std::string trans_y = is_v2 ? "trans_y" : "transpose_Y";
+
+  auto matmul_teller = [](const Node* node) -> bool {
+    auto* op_info = const_cast<Node*>(node)->stmt()->op_info();
+    if (op_info->HasAttr("enable_int8") &&
+        op_info->GetAttr<bool>("enable_int8")) {
+      return false;
+    }
+    return IsBatchedMatmul(VarDims(node, "X"), VarDims(node, "Y"));
+  };
+  // The mask broadcasts to the scores, and not the other way round.
+  auto add_teller = [](const Node* node) -> bool {
+    auto x_dims = VarDims(node, "X");
+    auto y_dims = VarDims(node, "Y");
+    int axis = const_cast<Node*>(node)->stmt()->op_info()->GetAttr<int>(
+        "axis");
+    int x_rank = x_dims.size();
+    int y_rank = y_dims.size();
+    if (axis == -1) axis = x_rank - y_rank;
+    if (axis < 0 || axis + y_rank > x_rank) return false;
+    for (int i = 0; i < y_rank; ++i) {
+      if (y_dims[i] != 1 && y_dims[i] != x_dims[axis + i]) return false;
+    }
+    return true;
+  };
+  auto softmax_teller = [](const Node* node) -> bool {
+    int axis =
+        const_cast<Node*>(node)->stmt()->op_info()->GetAttr<int>("axis");
+    return axis == -1 ||
+           axis == static_cast<int>(VarDims(node, "X").size()) - 1;
+  };
+
+  // create nodes.
+  auto* q = VarNode("q")->assert_is_op_input(matmul_type_, "X");
+  auto* k = VarNode("k")->assert_is_op_input(matmul_type_, "Y");
+  auto* qk_matmul = OpNode("qk_matmul", matmul_type_)
+                        ->assert_op_attr<bool>(trans_x, false)
+                        ->assert_node_satisfied(matmul_teller)
+                        ->AsIntermediate();
+  auto* qk_out = VarNode("qk_out")
+                     ->assert_is_op_output(matmul_type_, "Out")
+                     ->AsIntermediate();
+  auto* softmax = OpNode("softmax", "softmax")
+                      ->assert_node_satisfied(softmax_teller)
+                      ->AsIntermediate();
+  auto* softmax_out = VarNode("softmax_out")
+                          ->assert_is_op_output("softmax", "Out")
+                          ->assert_is_op_input(matmul_type_, "X")
+                          ->AsIntermediate();
+  auto* v = VarNode("v")->assert_is_op_input(matmul_type_, "Y");
+  auto* qkv_matmul = OpNode("qkv_matmul", matmul_type_)
+                         ->assert_op_attr<bool>(trans_x, false)
+                         ->assert_op_attr<bool>(trans_y, false)
+                         ->assert_node_satisfied(matmul_teller)
+                         ->AsIntermediate();
+  auto* out = VarNode("out")->assert_is_op_output(matmul_type_, "Out");
+
+  // create topology.
+  std::vector<PMNode*> qk_matmul_inputs{q, k};
+  qk_matmul_inputs >> *qk_matmul >> *qk_out;
+  PMNode* scores = qk_out;
+  if (with_scale_) {
+    qk_out->assert_is_op_input("scale", "X");
+    auto* scale = OpNode("scale", "scale")
+                      ->assert_op_attr_satisfied<float>(
+                          "bias", [](float attr) { return attr == 0.f; })
+                      ->AsIntermediate();
+    auto* scale_out = VarNode("scale_out")
+                          ->assert_is_op_output("scale", "Out")
+                          ->AsIntermediate();
+    *scores >> *scale >> *scale_out;
+    scores = scale_out;
+  }
+  if (with_mask_) {
+    scores->assert_is_op_input("elementwise_add", "X");
+    auto* mask = VarNode("mask")->assert_is_op_input("elementwise_add", "Y");
+    auto* add = OpNode("add", "elementwise_add")
+                    ->assert_node_satisfied(add_teller)
+                    ->AsIntermediate();
+    auto* add_out = VarNode("add_out")
+                        ->assert_is_op_output("elementwise_add", "Out")
+                        ->AsIntermediate();
+    std::vector<PMNode*> add_inputs{scores, mask};
+    add_inputs >> *add >> *add_out;
+    scores = add_out;
+  }
+  scores->assert_is_op_input("softmax", "X");
+  *scores >> *softmax >> *softmax_out;
+  std::vector<PMNode*> qkv_matmul_inputs{softmax_out, v};
+  qkv_matmul_inputs >> *qkv_matmul >> *out;
+}
+
+void ScaledDotProductAttentionFuser::InsertNewNode(
+    SSAGraph* graph, const key2nodes_t& matched) {
+  auto op_desc = GenOpDesc(matched);
+  auto attention_op =
+      LiteOpRegistry::Global().Create("scaled_dot_product_attention");
+  auto qk_matmul = matched.at("qk_matmul")->stmt()->op();
+  auto* scope = qk_matmul->scope();
+  auto& valid_places = qk_matmul->valid_places();
+  attention_op->Attach(op_desc, scope);
+
+  auto* new_op_node =
+      graph->GraphCreateInstructNode(attention_op, valid_places);
+
+  IR_NODE_LINK_TO(matched.at("q"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("k"), new_op_node);
+  IR_NODE_LINK_TO(matched.at("v"), new_op_node);
+  if (with_mask_) {
+    IR_NODE_LINK_TO(matched.at("mask"), new_op_node);
+  }
+  IR_NODE_LINK_TO(new_op_node, matched.at("out"));
+}
+
+cpp::OpDesc ScaledDotProductAttentionFuser::GenOpDesc(
+    const key2nodes_t& matched) {
+  auto* qk_info = matched.at("qk_matmul")->stmt()->op_info();
+  auto* qkv_info = matched.at("qkv_matmul")->stmt()->op_info();
+  const bool is_v2 = matmul_type_ == "matmul_v2";
+  float alpha = MatmulAlpha(qk_info);
+  if (with_scale_) {
+    alpha *= matched.at("scale")->stmt()->op_info()->GetAttr<float>("scale");
+  }
+
+  cpp::OpDesc op_desc;
+  op_desc.SetType("scaled_dot_product_attention");
+  op_desc.SetInput("Q", {matched.at("q")->arg()->name});
+  op_desc.SetInput("K", {matched.at("k")->arg()->name});
+  op_desc.SetInput("V", {matched.at("v")->arg()->name});
+  if (with_mask_) {
+    op_desc.SetInput("Mask", {matched.at("mask")->arg()->name});
+    op_desc.SetAttr<int>(
+        "mask_axis",
+        matched.at("add")->stmt()->op_info()->GetAttr<int>("axis"));
+  }
+  op_desc.SetOutput("Out", {matched.at("out")->arg()->name});
+  op_desc.SetAttr<bool>(
+      "transpose_K",
+      qk_info->GetAttr<bool>(is_v2 ? "trans_y" : "transpose_Y"));
+  op_desc.SetAttr<float>("alpha", alpha);
+  op_desc.SetAttr<float>("out_scale", MatmulAlpha(qkv_info));
+  return op_desc;
+}
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
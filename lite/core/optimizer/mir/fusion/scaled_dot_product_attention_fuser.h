@@ -0,0 +1,67 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include "lite/core/optimizer/mir/pattern_matcher_high_api.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+namespace fusion {
+
+/* Fuse the attention of the transformers,
+ *
+ *   q  k
+ *    \/
+ *  matmul
+ *    |
+ *  scale (optional)
+ *    |
+ *  elementwise_add (optional) -- mask
+ *    |
+ *  softmax  v
+ *     \    /
+ *     matmul
+ *       |
+ *      out
+ *
+ * into a scaled_dot_product_attention, whose kernel never stores the scores.
+ * matmul_type is matmul or matmul_v2.
+ */
+class ScaledDotProductAttentionFuser : public FuseBase {
+ public:
+  ScaledDotProductAttentionFuser(const std::string& matmul_type,
+                                 bool with_scale,
+                                 bool with_mask)
+      : matmul_type_(matmul_type),
+        with_scale_(with_scale),
+        with_mask_(with_mask) {}
+
+  void BuildPattern() override;
+  void InsertNewNode(SSAGraph* graph, const key2nodes_t& matched) override;
+
+ private:
+  cpp::OpDesc GenOpDesc(const key2nodes_t& matched) override;
+  std::string matmul_type_;
+  bool with_scale_;
+  bool with_mask_;
+};
+
+}  // namespace fusion
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -19,6 +19,7 @@
 #include <vector>
 #include "lite/core/optimizer/mir/graph_visualize_pass.h"
 #include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/program.h"
 #include "lite/core/type_system.h"
 
 namespace paddle {
@@ -154,6 +155,18 @@ void MemoryOptimizePass::CollectLifeCycleByDevice(
     }
   }
 
+  // The variables planned into the memory arena by static_memory_plan_pass
+  // share the memory by their offsets, renaming them would merge their
+  // lifetimes.
+  for (auto& op_node : graph->StmtTopologicalOrder()) {
+    if (!op_node->IsStmt()) continue;
+    auto op_info = op_node->AsStmt().op_info();
+    if (op_info->HasAttr(kMemoryPlanAttr)) {
+      auto names = op_info->GetAttr<std::vector<std::string>>(kMemoryPlanAttr);
+      invalid_var_names.insert(names.begin(), names.end());
+    }
+  }
+
   // non-tensor(like tensor_array) variables will not be reused
   for (auto& node : graph->nodes()) {
     if (node.IsArg() && (node.arg()->type != nullptr) &&
@@ -40,9 +40,11 @@ class MemoryOptimizePass : public ProgramPass {
   using lifecycle_map_t = std::map<std::string, lifecycle_t>;
   void Apply(const std::unique_ptr<SSAGraph>& graph) override;
 
- private:
+ protected:
   void CollectLifeCycleByDevice(
       std::map<std::string, lifecycle_map_t>* lifecycles, SSAGraph*);
+
+ private:
   void MakeReusePlan(const lifecycle_map_t& lifecycles,
                      std::map<std::string, std::string>* node2cluster);
   void PerformReusePlan(SSAGraph* graph,
@@ -31,6 +31,8 @@ const std::vector<std::string> PostQuantDynamicPass::quant_axis1_ops = {
 std::vector<std::string> PostQuantDynamicPass::quant_ops = {
     "conv2d", "mul", "lookup_table"};
 
+int PostQuantDynamicPass::int4_group_size = 128;
+
 static bool abs_compare(float a, float b) {
   return std::fabs(a) < std::fabs(b);
 }
@@ -154,12 +156,74 @@ void PostQuantDynamicPerChannel(OpInfo* op_info,
   op_info->SetAttr(weight_name + "_quant_scale", scales);
 }
 
+// Quantize the K x N weight to int4 by groups of group_size rows of a
+// column, with the scales [ceil(K / group_size)][N]. Two columns are packed
+// in a byte, column 2c in the low nibble and 2c + 1 in the high one, each
+// holding q + 8, so the weight is stored as K x ceil(N / 2) int8.
+void PostQuantDynamicGroupWiseInt4(OpInfo* op_info,
+                                   Tensor* weight,
+                                   const std::string weight_name,
+                                   int group_size) {
+  const DDim weight_dims = weight->dims();
+  CHECK_EQ(weight_dims.size(), 2UL);
+  CHECK_GT(group_size, 0);
+  const int64_t K = weight_dims[0];
+  const int64_t N = weight_dims[1];
+  const int64_t groups = (K + group_size - 1) / group_size;
+  const float range = 7.f;
+
+  // get scales
+  const float* src_data = weight->data<float>();
+  std::vector<float> scales(groups * N, 0.f);
+  for (int64_t i = 0; i < K; i++) {
+    float* group_scales = scales.data() + i / group_size * N;
+    for (int64_t j = 0; j < N; j++) {
+      group_scales[j] =
+          std::max(group_scales[j], std::fabs(src_data[i * N + j]));
+    }
+  }
+  std::transform(scales.begin(), scales.end(), scales.begin(), [&](float x) {
+    return x / range;
+  });
+
+  // quantize weights
+  Tensor tmp_tensor;
+  tmp_tensor.CopyDataFrom(*weight);
+  weight->clear();
+  const int64_t ldw = (N + 1) / 2;
+  weight->Resize({K, ldw});
+  weight->set_precision(PRECISION(kInt8));
+  uint8_t* weight_data =
+      reinterpret_cast<uint8_t*>(weight->mutable_data<int8_t>());
+  std::fill(weight_data, weight_data + K * ldw, 0x88);
+  src_data = tmp_tensor.data<float>();
+  for (int64_t i = 0; i < K; i++) {
+    const float* group_scales = scales.data() + i / group_size * N;
+    for (int64_t j = 0; j < N; j++) {
+      float scale = group_scales[j];
+      int q = scale > 0.f
+                  ? static_cast<int>(std::round(src_data[i * N + j] / scale))
+                  : 0;
+      q = std::min(std::max(q, -7), 7) + 8;
+      uint8_t* dest = weight_data + i * ldw + j / 2;
+      *dest = (j % 2) ? ((*dest & 0x0F) | (q << 4)) : ((*dest & 0xF0) | q);
+    }
+  }
+  op_info->SetAttr<std::string>("quantization_type",
+                                "post_weight_group_wise_abs_max");
+  op_info->SetAttr("quantize_weight_bits", 4);
+  op_info->SetAttr("quantize_weight_group_size", group_size);
+  op_info->SetAttr(weight_name + "_quant_scale", scales);
+}
+
 void PostQuantDynamicPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
   int quant_bits = 16;
   if (quant_type_ == lite_api::QuantType::QUANT_INT8) {
     quant_bits = 8;
   } else if (quant_type_ == lite_api::QuantType::QUANT_INT16) {
     quant_bits = 16;
+  } else if (quant_type_ == lite_api::QuantType::QUANT_INT4) {
+    quant_bits = 4;
   } else {
     LOG(FATAL) << "Not support quant type:" << static_cast<int>(quant_type_);
   }
@@ -193,8 +257,18 @@ void PostQuantDynamicPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
         auto iter =
             std::find(quant_axis1_ops.begin(), quant_axis1_ops.end(), op_type);
         int quant_axis = iter != quant_axis1_ops.end() ? 1 : 0;
-        PostQuantDynamicPerChannel(
-            op_info, weight, weight_name, quant_axis, quant_bits);
+        // int4 applies to the K x N weights of mul, the others are int8.
+        if (quant_bits == 4 && op_type == "mul" &&
+            weight->dims().size() == 2) {
+          PostQuantDynamicGroupWiseInt4(
+              op_info, weight, weight_name, int4_group_size);
+          continue;
+        }
+        PostQuantDynamicPerChannel(op_info,
+                                   weight,
+                                   weight_name,
+                                   quant_axis,
+                                   quant_bits == 4 ? 8 : quant_bits);
       }
     }
   }
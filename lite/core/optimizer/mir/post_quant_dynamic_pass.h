@@ -27,9 +27,11 @@ namespace mir {
 /*
  * Use post_quant_dynamic method to quantize the model.
  * In optimization stage, if the data type of weights is fp32, quantize the
- * weights to int8/16. So the size of the quantized weights is reduced 4x/2x.
+ * weights to int8/16, or to int4 by groups of rows for the 2-D weights of
+ * mul. So the size of the quantized weights is reduced 4x/2x/8x.
  * In inference stage, the quantized weights are dequantized to fp32 and run
- * all ops to get output.
+ * all ops to get output, except the weights of the x86 fc and mul, which
+ * stay int8/int4 and are dequantized inside the gemm.
  */
 class PostQuantDynamicPass : public ProgramPass {
  public:
@@ -39,6 +41,9 @@ class PostQuantDynamicPass : public ProgramPass {
   // For the ops in quant_axis1_ops, the quantized axis is 1.
   // Default, quant_axis1_ops = {"mul", "lookup_table"}
   static const std::vector<std::string> quant_axis1_ops;
+  // For QUANT_INT4, the rows of a group sharing the scales of a column.
+  // Default, int4_group_size = 128
+  static int int4_group_size;
 
  public:
   void Apply(const std::unique_ptr<SSAGraph>& graph) override;
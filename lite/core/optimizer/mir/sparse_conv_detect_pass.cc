@@ -16,9 +16,12 @@
 // operations with the kernel size of 1x1. In practice, the pass requires the
 // convolutional weights to be sparse. And, the sparser the weights
 // are, the more latency improvement we would potentially obtain.
+// On x86 the weights are stored in BCSR, and the pruned weights of fc and
+// mul are marked too.
 
 #include "lite/core/optimizer/mir/sparse_conv_detect_pass.h"
 #include <math.h>
+#include <algorithm>
 #include <list>
 #include <memory>
 #include <string>
@@ -549,6 +552,82 @@ template int SparseConvDetectPass::ComputeSemiSparseZeros<float>(
     const int height,
     const int width);
 
+int SparseConvDetectPass::ComputeBlockSparseWeight(
+    const lite::Tensor* w_tensor,
+    const int M,
+    const int K,
+    lite::Tensor* nonzero_output_tensor,
+    lite::Tensor* oc_nonzeros_tensor,
+    lite::Tensor* diffs_tensor) {
+  const float* weights = w_tensor->data<float>();
+  auto block_nonzero = [&](int oc, int R, int ic) {
+    for (int r = oc; r < std::min(M, oc + R); r++) {
+      if (weights[r * K + ic] != 0.f) return true;
+    }
+    return false;
+  };
+  int num_blocks1 = 0;
+  int num_blocks4 = 0;
+  for (int oc = 0; oc < M; oc++) {
+    for (int ic = 0; ic < K; ic++) {
+      num_blocks1 += block_nonzero(oc, 1, ic);
+      num_blocks4 += (oc % 4 == 0) && block_nonzero(oc, 4, ic);
+    }
+  }
+  const int R = num_blocks1 * 2 >= num_blocks4 * 4 ? 4 : 1;
+  const int num_blocks = R == 4 ? num_blocks4 : num_blocks1;
+  nonzero_output_tensor->Resize({std::max(num_blocks, 1) * R});
+  oc_nonzeros_tensor->Resize({M});
+  diffs_tensor->Resize({std::max(num_blocks, 1)});
+  float* nonzero_output = nonzero_output_tensor->mutable_data<float>();
+  auto* oc_nonzeros = oc_nonzeros_tensor->mutable_data<int32_t>();
+  auto* diffs = diffs_tensor->mutable_data<int32_t>();
+  int block_index = 0;
+  for (int oc = 0; oc < M; oc += R) {
+    for (int ic = 0; ic < K; ic++) {
+      if (!block_nonzero(oc, R, ic)) continue;
+      for (int r = 0; r < R; r++) {
+        nonzero_output[block_index * R + r] =
+            oc + r < M ? weights[(oc + r) * K + ic] : 0.f;
+      }
+      diffs[block_index++] = ic;
+    }
+    for (int r = oc; r < std::min(M, oc + R); r++) {
+      oc_nonzeros[r] = block_index;
+    }
+  }
+  return R;
+}
+
+void SparseConvDetectPass::DetectSparseWeights(
+    const std::unique_ptr<SSAGraph>& graph) {
+  for (auto& node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    const std::string op_type = node->AsStmt().op_type();
+    if (op_type != "fc" && op_type != "mul") continue;
+    auto op_desc = *node->stmt()->mutable_op_info();
+    auto w = op_desc.Input(op_type == "fc" ? "W" : "Y").front();
+    auto* w_var = node->stmt()->op()->scope()->FindVar(w);
+    if (w_var == nullptr) continue;
+    const auto& w_tensor = w_var->Get<lite::Tensor>();
+    if (!w_tensor.persistable() ||
+        w_tensor.precision() != PrecisionType::kFloat ||
+        w_tensor.dims().size() != 2 || w_tensor.numel() == 0) {
+      VLOG(4) << "The sparse weight of " << op_type
+              << " must be a 2-D persistable fp32 tensor";
+      continue;
+    }
+    int weight_num = w_tensor.numel();
+    int zero_num = ComputeSparseZeros<float>(&w_tensor, weight_num);
+    float sparse_zero_percent =
+        static_cast<float>(zero_num) / static_cast<float>(weight_num);
+    VLOG(4) << op_type << " sparse zero num percent: " << sparse_zero_percent;
+    if (sparse_zero_percent < sparse_threshold_) continue;
+    op_desc.SetAttr<bool>("sparse_weight", true);
+    node->stmt()->ResetOp(op_desc, graph->valid_places());
+  }
+}
+
 void SparseConvDetectPass::CopyAttrFromOpInfo(cpp::OpDesc* op_desc,
                                               OpInfo* op_info,
                                               const std::string& attr_name) {
@@ -603,6 +682,17 @@ void SparseConvDetectPass::CopyOutputScaleFromOpInfo(cpp::OpDesc* op_desc,
 }
 
 void SparseConvDetectPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // The x86 kernels take the BCSR weights, the arm ones their own format.
+  bool has_x86 = false;
+  bool has_arm = false;
+  for (auto& place : graph->valid_places()) {
+    has_x86 |= place.target == TARGET(kX86);
+    has_arm |= place.target == TARGET(kARM);
+  }
+  const bool use_bcsr = has_x86 && !has_arm;
+  if (use_bcsr) {
+    DetectSparseWeights(graph);
+  }
   for (auto& node : graph->StmtTopologicalOrder()) {
     if (node->IsStmt() && node->AsStmt().op_type() == "conv2d") {
       auto* scope = node->stmt()->op()->scope();
@@ -649,13 +739,28 @@ void SparseConvDetectPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
         VLOG(4) << "The input and output channels must be larger than 0";
         continue;
       }
+      if (use_bcsr && !use_fp32) {
+        VLOG(4) << "The sparse conv of x86 only supports fp32";
+        continue;
+      }
+      if (use_bcsr && conv_op_desc->HasAttr("with_act") &&
+          conv_op_desc->GetAttr<bool>("with_act")) {
+        auto act_type = conv_op_desc->GetAttr<std::string>("act_type");
+        if (act_type != "relu" && act_type != "relu6" &&
+            act_type != "leaky_relu" && act_type != "hard_swish") {
+          VLOG(4) << "The sparse conv of x86 does not support " << act_type;
+          continue;
+        }
+      }
       int zero_num;
       int num_build_nonzeroes = 0;
       int count_nonzeroes = 0;
       int count_channels = 0;
       int count_blocks = 0;
       int flag_semi = 0;
-      if (use_fp32) {
+      if (use_bcsr) {
+        zero_num = ComputeSparseZeros<float>(&w_tensor, weight_num);
+      } else if (use_fp32) {
         zero_num = ComputeSemiSparseZeros<float>(&w_tensor,
                                                  &count_nonzeroes,
                                                  &count_channels,
@@ -705,7 +810,9 @@ void SparseConvDetectPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
           scope->Var(nonzeros_output_name)->GetMutable<Tensor>();
       auto* oc_nonzeros_t = scope->Var(oc_nonzeros_name)->GetMutable<Tensor>();
       auto* ic_diffs_t = scope->Var(ic_diffs_name)->GetMutable<Tensor>();
-      if (use_fp32) {
+      if (use_bcsr) {
+        // Resized by ComputeBlockSparseWeight.
+      } else if (use_fp32) {
         if (flag_semi == 1) {
           nonzeros_output_t->Resize({count_nonzeroes});
           oc_nonzeros_t->Resize({ch_out});
@@ -726,8 +833,16 @@ void SparseConvDetectPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
           ic_diffs_t->Resize({count_nonzeroes});
         }
       }
-      int first_ic;
-      if (use_fp32) {
+      int first_ic = 0;
+      int block_rows = 0;
+      if (use_bcsr) {
+        block_rows = ComputeBlockSparseWeight(&w_tensor,
+                                              ch_out,
+                                              ch_in,
+                                              nonzeros_output_t,
+                                              oc_nonzeros_t,
+                                              ic_diffs_t);
+      } else if (use_fp32) {
         if (flag_semi == 1) {
           first_ic = ComputeSemiSparseWeight<float>(&w_tensor,
                                                     ch_out,
@@ -820,6 +935,9 @@ void SparseConvDetectPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
 
       op_desc.SetAttr<int>("first_ic", first_ic);
       op_desc.SetAttr<int>("flag_semi", flag_semi);
+      if (use_bcsr) {
+        op_desc.SetAttr<int>("sparse_block_rows", block_rows);
+      }
       sparse_conv2d_op->Attach(op_desc, node->stmt()->op()->scope());
       auto* sparse_op_node = graph->GraphCreateInstructNode(
           sparse_conv2d_op, graph->valid_places());
@@ -860,9 +978,8 @@ void SparseConvDetectPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
 
 REGISTER_MIR_PASS(sparse_conv_detect_pass,
                   paddle::lite::mir::SparseConvDetectPass)
-    .BindTargets({TARGET(kARM)})
+    .BindTargets({TARGET(kARM), TARGET(kX86)})
     .ExcludeTargets({TARGET(kXPU)})
     .ExcludeTargets({TARGET(kBM)})
     .ExcludeTargets({TARGET(kOpenCL)})
-    .ExcludeTargets({TARGET(kNPU)})
-    .ExcludeTargets({TARGET(kX86)});
+    .ExcludeTargets({TARGET(kNPU)});
@@ -77,6 +77,20 @@ class SparseConvDetectPass : public ProgramPass {
                           lite::Tensor* nonzero_output_tensor,
                           lite::Tensor* oc_nonzeros_tensor,
                           lite::Tensor* diffs_tensor);
+  // The BCSR of the M x K fp32 weight of the x86 kernels, see
+  // SparseConvParam::block_rows. Returns the rows of its blocks, 4 when the
+  // blocks of 4 output channels are at least half full, else 1.
+  int ComputeBlockSparseWeight(const lite::Tensor* w_tensor,
+                               const int M,
+                               const int K,
+                               lite::Tensor* nonzero_output_tensor,
+                               lite::Tensor* oc_nonzeros_tensor,
+                               lite::Tensor* diffs_tensor);
+
+  // Mark the pruned weights of fc and mul with the attr "sparse_weight", the
+  // x86 kernels pack them into BCSR.
+  void DetectSparseWeights(const std::unique_ptr<SSAGraph>& graph);
+
   // Add attribute that's named with 'attr_name' from op_info
   void CopyAttrFromOpInfo(cpp::OpDesc* op_desc,
                           OpInfo* op_info,
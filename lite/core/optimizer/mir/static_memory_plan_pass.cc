@@ -0,0 +1,60 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/static_memory_plan_pass.h"
+#include <map>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass_registry.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+void StaticMemoryPlanPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  // The variables of the sub blocks may be read by the ops of the main block
+  // after the sub block finished, only the main block is planned.
+  if (graph->blockIdx() != kRootBlockIdx) return;
+
+  std::map<std::string, lifecycle_map_t> lifecycles;
+  CollectLifeCycleByDevice(&lifecycles, graph.get());
+  auto host_lifecycles = lifecycles.find(TargetToStr(TARGET(kHost)));
+  if (host_lifecycles == lifecycles.end()) return;
+
+  int marked_num = 0;
+  for (auto& op_node : graph->StmtTopologicalOrder()) {
+    if (!op_node->IsStmt()) continue;
+    std::vector<std::string> vars;
+    for (auto* out_node : op_node->outlinks) {
+      CHECK(out_node->IsArg());
+      if (host_lifecycles->second.count(out_node->AsArg().name)) {
+        vars.push_back(out_node->AsArg().name);
+      }
+    }
+    if (vars.empty()) continue;
+    op_node->AsStmt().mutable_op_info()->SetAttr<std::vector<std::string>>(
+        kMemoryPlanAttr, vars);
+    marked_num += vars.size();
+  }
+  VLOG(4) << marked_num << " variables are marked for the memory arena";
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(static_memory_plan_pass,
+                  paddle::lite::mir::StaticMemoryPlanPass)
+    .BindTargets({TARGET(kX86)});
@@ -0,0 +1,45 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include "lite/core/optimizer/mir/memory_optimize_pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * StaticMemoryPlanPass marks the host variables of the main block that may be
+ * placed at a fixed offset of one memory arena, with the same rules that
+ * MemoryOptimizePass uses to pick the reusable variables. The marks are saved
+ * with the ops, so that the models loaded by the light api are planned too.
+ *
+ * The offsets themselves are assigned by RuntimeProgram after the first run,
+ * when the shapes and the data types of all the variables are known, the
+ * variable shapes of the model usually have -1 in them at this point.
+ *
+ * The pass runs before MemoryOptimizePass, which leaves the marked variables
+ * alone: the arena reuses their memory by the offsets instead of by the
+ * names. It is bound to x86 only, the other targets keep the reuse by names.
+ */
+class StaticMemoryPlanPass : public MemoryOptimizePass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
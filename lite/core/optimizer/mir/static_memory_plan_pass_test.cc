@@ -0,0 +1,93 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/static_memory_plan_pass.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+using VarType = VarDescAPI::Type;
+
+// x -> relu -> a -> relu -> b -> relu -> c -> relu -> d, a and c do not live
+// at the same time, nor do b and d.
+std::shared_ptr<cpp::ProgramDesc> BuildReluChain() {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  block_desc->ClearOps();
+  block_desc->ClearVars();
+  const std::vector<std::string> names{"x", "a", "b", "c", "d"};
+  for (auto& name : names) {
+    auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+    var_desc->SetName(name);
+    var_desc->SetType(VarType::LOD_TENSOR);
+    var_desc->SetDataType(VarType::FP32);
+    var_desc->SetPersistable(false);
+  }
+  for (size_t i = 1; i < names.size(); i++) {
+    auto* relu = block_desc->AddOp<cpp::OpDesc>();
+    relu->SetType("relu");
+    relu->SetInput("X", {names[i - 1]});
+    relu->SetOutput("Out", {names[i]});
+  }
+  return program_desc;
+}
+
+TEST(static_memory_plan_pass, keep_planned_vars_from_renaming) {
+  std::vector<Place> valid_places{{TARGET(kX86), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  Program program(BuildReluChain(), scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, valid_places);
+  for (auto& node : graph->mutable_nodes()) {
+    if (node.IsArg()) {
+      node.AsArg().type = LiteType::GetTensorTy(
+          TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHW));
+    }
+  }
+
+  // In the order of the optimizer.
+  StaticMemoryPlanPass plan_pass;
+  plan_pass.Apply(graph);
+  MemoryOptimizePass memory_optimize_pass;
+  memory_optimize_pass.Apply(graph);
+
+  std::set<std::string> planned;
+  std::vector<std::string> outs;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto* op_info = node->AsStmt().op_info();
+    ASSERT_TRUE(op_info->HasAttr(kMemoryPlanAttr));
+    auto names = op_info->GetAttr<std::vector<std::string>>(kMemoryPlanAttr);
+    planned.insert(names.begin(), names.end());
+    outs.push_back(op_info->Output("Out").front());
+  }
+  EXPECT_EQ(planned, std::set<std::string>({"a", "b", "c", "d"}));
+  // The arena reuses the memory of a for c, the names are left as they are.
+  EXPECT_EQ(outs, std::vector<std::string>({"a", "b", "c", "d"}));
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(relu);
+USE_LITE_KERNEL(relu, kX86, kFloat, kNCHW, def);
@@ -116,6 +116,13 @@ void TypeLayoutTransformPass::ComplementInputs(
       return;
     }
 
+    // A kernel of any layout reads the blocked x86 tensor as NCHW.
+    if (a == DATALAYOUT(kNCHW8c) && b == DATALAYOUT(kAny)) {
+      decl_arg_type = LiteType::GetTensorTy(decl_arg_type->target(),
+                                            decl_arg_type->precision(),
+                                            DATALAYOUT(kNCHW));
+    }
+
     AddLayoutInst(*in->AsArg().type,
                   *decl_arg_type,
                   in,
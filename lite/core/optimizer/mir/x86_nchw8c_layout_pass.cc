@@ -0,0 +1,196 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/x86_nchw8c_layout_pass.h"
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/optimizer/mir/pass_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+namespace {
+
+bool GetBoolAttr(const OpInfo* op_info, const std::string& name) {
+  return op_info->HasAttr(name) && op_info->GetAttr<bool>(name);
+}
+
+bool IsNHWC(const OpInfo* op_info) {
+  return op_info->HasAttr("data_format") &&
+         op_info->GetAttr<std::string>("data_format") == "NHWC";
+}
+
+}  // namespace
+
+bool X86Nchw8cLayoutPass::IsConvBlockable(Node* node) {
+  auto& inst = node->AsStmt();
+  const auto* op_info = inst.op_info();
+  if (GetBoolAttr(op_info, "enable_int8") || IsNHWC(op_info) ||
+      op_info->HasAttr("fuse_elementwise_op_type") ||
+      op_info->HasAttr("scale_activation_type") ||
+      (op_info->HasInput("SecondInput") &&
+       !op_info->Input("SecondInput").empty())) {
+    return false;
+  }
+  if (GetBoolAttr(op_info, "with_act")) {
+    const auto act_type = op_info->GetAttr<std::string>("act_type");
+    if (act_type != "relu" && act_type != "relu6" &&
+        act_type != "leaky_relu" && act_type != "hard_swish") {
+      return false;
+    }
+  }
+  auto* filter = inst.op()->scope()->FindVar(op_info->Input("Filter").front());
+  if (!filter) return false;
+  auto w_dims = filter->Get<Tensor>().dims();
+  if (w_dims.size() != 4) return false;
+  const int groups = op_info->GetAttr<int>("groups");
+  // the blocks of fewer channels than 8 are mostly padding
+  if (groups == 1) return w_dims[1] >= 8;
+  return w_dims[1] == 1 && w_dims[0] == groups;
+}
+
+bool X86Nchw8cLayoutPass::IsElementwiseBlockable(Node* node) {
+  auto& inst = node->AsStmt();
+  const auto* op_info = inst.op_info();
+  if (GetBoolAttr(op_info, "fuse_scale")) return false;
+  if (op_info->HasAttr("axis")) {
+    const int axis = op_info->GetAttr<int>("axis");
+    if (axis != -1 && axis != 0) return false;
+  }
+  // The tensors of the exec scope are of the shapes of the var descs, see
+  // Program::PrepareWorkspace(), which may be -1 in the unknown dims.
+  auto* scope = inst.op()->scope();
+  auto* x = scope->FindVar(op_info->Input("X").front());
+  auto* y = scope->FindVar(op_info->Input("Y").front());
+  if (!x || !y) return false;
+  auto x_dims = x->Get<Tensor>().dims();
+  auto y_dims = y->Get<Tensor>().dims();
+  if (x_dims.size() != 4 || y_dims.size() != 4) return false;
+  if (x_dims == y_dims) return true;
+  // the kernel broadcasts only y, of num x c x 1 x 1
+  return y_dims[0] == x_dims[0] && y_dims[1] == x_dims[1] &&
+         y_dims[2] == 1 && y_dims[3] == 1 && x_dims[2] != -1 &&
+         x_dims[3] != -1;
+}
+
+bool X86Nchw8cLayoutPass::IsBlockable(Node* node) {
+  auto& inst = node->AsStmt();
+  const auto* op_info = inst.op_info();
+  const auto op_type = inst.op_type();
+  auto is_blocked = [&](const std::string& arg) {
+    return op_info->HasInput(arg) && !op_info->Input(arg).empty() &&
+           blocked_vars_.count(op_info->Input(arg).front());
+  };
+
+  if (op_type == "conv2d" || op_type == "depthwise_conv2d") {
+    return IsConvBlockable(node);
+  }
+  if (!is_blocked("X")) return false;
+  if (op_type == "pool2d") {
+    return !GetBoolAttr(op_info, "adaptive") && !IsNHWC(op_info);
+  }
+  if (op_type == "batch_norm") {
+    return !op_info->HasAttr("data_layout") ||
+           op_info->GetAttr<std::string>("data_layout") == "NCHW";
+  }
+  if (op_type == "relu" || op_type == "relu6" || op_type == "leaky_relu" ||
+      op_type == "hard_swish") {
+    return true;
+  }
+  if (op_type == "elementwise_add" || op_type == "elementwise_sub" ||
+      op_type == "elementwise_mul") {
+    return is_blocked("Y") && IsElementwiseBlockable(node);
+  }
+  if (op_type == "fusion_elementwise_add_activation" ||
+      op_type == "fusion_elementwise_sub_activation" ||
+      op_type == "fusion_elementwise_mul_activation") {
+    return is_blocked("Y") && IsElementwiseBlockable(node) &&
+           op_info->GetAttr<std::string>("act_type") == "relu";
+  }
+  return false;
+}
+
+void X86Nchw8cLayoutPass::ResetLayout(Node* node, DataLayoutType layout) {
+  auto& inst = node->AsStmt();
+  inst.ResetKernels({Place{TARGET(kX86), PRECISION(kFloat), layout}});
+  // the int32 and int64 kernels of the elementwise ops are of the same place
+  auto& kernels = inst.kernels();
+  kernels.erase(std::remove_if(kernels.begin(),
+                               kernels.end(),
+                               [](const std::unique_ptr<KernelBase>& kernel) {
+                                 return kernel->alias() != "def";
+                               }),
+                kernels.end());
+  CHECK(!kernels.empty()) << "no " << DataLayoutToStr(layout)
+                          << " kernel of " << inst.op_type();
+
+  // the types of the outputs were set by the kernel picked before
+  auto& kernel = inst.picked_kernel();
+  const auto* op_info = inst.op_info();
+  for (auto* out_node : node->outlinks) {
+    auto& var = out_node->AsArg();
+    std::string arg_name;
+    CHECK(op_info->GetOutputArgname(var.name, &arg_name))
+        << "Can not find the output argument for var " << var.name;
+    var.type = kernel.GetOutputDeclType(arg_name);
+  }
+}
+
+void X86Nchw8cLayoutPass::Apply(const std::unique_ptr<SSAGraph>& graph) {
+  const Place nchw8c_place{
+      TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHW8c)};
+  const auto& valid_places = graph->valid_places();
+  if (std::find(valid_places.begin(), valid_places.end(), nchw8c_place) ==
+      valid_places.end()) {
+    return;
+  }
+  blocked_vars_.clear();
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    if (!node->IsStmt()) continue;
+    auto& inst = node->AsStmt();
+    auto& kernel = inst.picked_kernel();
+    if (kernel.target() != TARGET(kX86) ||
+        kernel.precision() != PRECISION(kFloat) || kernel.alias() != "def" ||
+        (kernel.layout() != DATALAYOUT(kNCHW) &&
+         kernel.layout() != DATALAYOUT(kNCHW8c))) {
+      continue;
+    }
+    const bool blocked = IsBlockable(node);
+    const auto layout = blocked ? DATALAYOUT(kNCHW8c) : DATALAYOUT(kNCHW);
+    if (kernel.layout() != layout) {
+      VLOG(4) << "reset " << inst.op_type() << " to "
+              << DataLayoutToStr(layout);
+      ResetLayout(node, layout);
+    }
+    if (blocked) {
+      for (auto* out_node : node->outlinks) {
+        blocked_vars_.insert(out_node->AsArg().name);
+      }
+    }
+  }
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_MIR_PASS(x86_nchw8c_layout_pass,
+                  paddle::lite::mir::X86Nchw8cLayoutPass)
+    .BindTargets({TARGET(kX86)})
+    .BindKernel("conv2d",
+                paddle::lite_api::Place(
+                    TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHW8c)));
@@ -0,0 +1,53 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <memory>
+#include <set>
+#include <string>
+#include "lite/core/optimizer/mir/pass.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+/*
+ * Run the x86 float ops on the images blocked by 8 channels, nChw8c, when
+ * Place{kX86, kFloat, kNCHW8c} is one of the valid places.
+ *
+ * A conv2d of at least 8 input channels or a depthwise_conv2d outputs
+ * nChw8c, and the pool2d, batch_norm, activation and elementwise ops after
+ * it keep it as long as all their inputs are nChw8c, so that only the
+ * chains of such ops run blocked. An elementwise op is blocked only when the
+ * shapes of its var descs show y of the dims of x or of num x c x 1 x 1. The
+ * other ops are reset to their NCHW kernels, and type_layout_cast_pass
+ * inserts the layout ops between the two.
+ */
+class X86Nchw8cLayoutPass : public ProgramPass {
+ public:
+  void Apply(const std::unique_ptr<SSAGraph>& graph) override;
+
+ private:
+  bool IsConvBlockable(Node* node);
+  bool IsElementwiseBlockable(Node* node);
+  bool IsBlockable(Node* node);
+  void ResetLayout(Node* node, DataLayoutType layout);
+
+  // The vars output nChw8c.
+  std::set<std::string> blocked_vars_;
+};
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,192 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/optimizer/mir/x86_nchw8c_layout_pass.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/optimizer/mir/ssa_graph.h"
+#include "lite/core/program.h"
+
+namespace paddle {
+namespace lite {
+namespace mir {
+
+using VarType = VarDescAPI::Type;
+
+void AddVar(cpp::BlockDesc* block_desc,
+            const std::string& name,
+            const std::vector<int64_t>& shape,
+            bool persistable = false) {
+  auto* var_desc = block_desc->AddVar<cpp::VarDesc>();
+  var_desc->SetName(name);
+  var_desc->SetType(VarType::LOD_TENSOR);
+  var_desc->SetDataType(VarType::FP32);
+  var_desc->SetShape(shape);
+  var_desc->SetPersistable(persistable);
+}
+
+void AddConv(cpp::BlockDesc* block_desc,
+             const std::string& input,
+             const std::string& filter,
+             const std::string& output) {
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType("conv2d");
+  op_desc->SetInput("Input", {input});
+  op_desc->SetInput("Filter", {filter});
+  op_desc->SetOutput("Output", {output});
+  op_desc->SetAttr("strides", std::vector<int>({1, 1}));
+  op_desc->SetAttr("paddings", std::vector<int>({1, 1}));
+  op_desc->SetAttr("dilations", std::vector<int>({1, 1}));
+  op_desc->SetAttr("groups", 1);
+}
+
+void AddOp(cpp::BlockDesc* block_desc,
+           const std::string& type,
+           const std::vector<std::string>& inputs,
+           const std::string& out) {
+  auto* op_desc = block_desc->AddOp<cpp::OpDesc>();
+  op_desc->SetType(type);
+  op_desc->SetInput("X", {inputs[0]});
+  if (inputs.size() > 1) {
+    op_desc->SetInput("Y", {inputs[1]});
+    op_desc->SetAttr("axis", -1);
+  }
+  op_desc->SetOutput("Out", {out});
+  if (type == "pool2d") {
+    op_desc->SetAttr<std::string>("pooling_type", "avg");
+    op_desc->SetAttr("ksize", std::vector<int>({6, 6}));
+    op_desc->SetAttr("global_pooling", true);
+    op_desc->SetAttr("strides", std::vector<int>({1, 1}));
+    op_desc->SetAttr("paddings", std::vector<int>({0, 0}));
+  }
+}
+
+// conv2d(x, w8) -> c8 and conv2d(x3, w3) -> c3 of 8 and 3 input channels,
+// the ops after them are named by their outputs.
+std::shared_ptr<cpp::ProgramDesc> BuildNchw8cProgram(
+    const std::shared_ptr<Scope>& scope) {
+  auto program_desc = std::make_shared<cpp::ProgramDesc>();
+  auto* block_desc = program_desc->AddBlock<cpp::BlockDesc>();
+  block_desc->ClearOps();
+  block_desc->ClearVars();
+  const std::map<std::string, std::vector<int64_t>> weights{
+      {"w8", {8, 8, 3, 3}}, {"w3", {8, 3, 3, 3}}};
+  for (auto& weight : weights) {
+    AddVar(block_desc, weight.first, weight.second, true);
+    auto* tensor = scope->Var(weight.first)->GetMutable<Tensor>();
+    tensor->Resize(weight.second);
+    tensor->mutable_data<float>();
+  }
+  AddVar(block_desc, "x", {1, 8, 6, 6});
+  AddVar(block_desc, "x3", {1, 3, 6, 6});
+  for (auto name : {"c8", "c3", "relu8", "relu3", "add8", "add3", "mul8"}) {
+    AddVar(block_desc, name, {1, 8, 6, 6});
+  }
+  AddVar(block_desc, "pool8", {1, 8, 1, 1});
+  AddVar(block_desc, "mul_pool", {1, 8, 6, 6});
+
+  AddConv(block_desc, "x", "w8", "c8");
+  AddConv(block_desc, "x3", "w3", "c3");
+  AddOp(block_desc, "relu", {"c8"}, "relu8");
+  AddOp(block_desc, "relu", {"c3"}, "relu3");
+  AddOp(block_desc, "elementwise_add", {"c8", "relu8"}, "add8");
+  AddOp(block_desc, "elementwise_add", {"relu8", "relu3"}, "add3");
+  AddOp(block_desc, "pool2d", {"add8"}, "pool8");
+  AddOp(block_desc, "elementwise_mul", {"add8", "pool8"}, "mul8");
+  // Only y is broadcast by the nChw8c kernel.
+  AddOp(block_desc, "elementwise_mul", {"pool8", "add8"}, "mul_pool");
+  return program_desc;
+}
+
+TEST(x86_nchw8c_layout_pass, block_supported_shapes) {
+  std::vector<Place> valid_places{
+      {TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHW8c)},
+      {TARGET(kX86), PRECISION(kFloat)}};
+  auto scope = std::make_shared<Scope>();
+  Program program(BuildNchw8cProgram(scope), scope, valid_places);
+  std::unique_ptr<SSAGraph> graph(new SSAGraph);
+  graph->Build(program, valid_places);
+  graph->SetValidPlaces(valid_places);
+  // Pick the NCHW float kernels, like static_kernel_pick_pass.
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto& kernels = node->AsStmt().kernels();
+    auto it = std::find_if(kernels.begin(),
+                           kernels.end(),
+                           [](const std::unique_ptr<KernelBase>& kernel) {
+                             return kernel->alias() == "def" &&
+                                    kernel->precision() == PRECISION(kFloat) &&
+                                    kernel->layout() == DATALAYOUT(kNCHW);
+                           });
+    ASSERT_TRUE(it != kernels.end()) << node->AsStmt().op_type();
+    std::iter_swap(kernels.begin(), it);
+  }
+
+  X86Nchw8cLayoutPass pass;
+  pass.Apply(graph);
+
+  std::map<std::string, DataLayoutType> layouts;
+  for (auto* node : graph->StmtTopologicalOrder()) {
+    auto& inst = node->AsStmt();
+    const auto& outputs = inst.op_info()->output_names();
+    const auto layout = inst.picked_kernel().layout();
+    layouts[outputs.front()] = layout;
+    // The types of the outputs follow the kernel picked by the pass.
+    if (layout == DATALAYOUT(kNCHW8c)) {
+      for (auto* out_node : node->outlinks) {
+        ASSERT_TRUE(out_node->AsArg().type);
+        EXPECT_EQ(out_node->AsArg().type->layout(), layout);
+      }
+    }
+  }
+  const std::map<std::string, DataLayoutType> expected{
+      {"c8", DATALAYOUT(kNCHW8c)},
+      // the blocks of 3 channels are mostly padding
+      {"c3", DATALAYOUT(kNCHW)},
+      {"relu8", DATALAYOUT(kNCHW8c)},
+      {"relu3", DATALAYOUT(kNCHW)},
+      {"add8", DATALAYOUT(kNCHW8c)},
+      // y is not blocked
+      {"add3", DATALAYOUT(kNCHW)},
+      {"pool8", DATALAYOUT(kNCHW8c)},
+      // y of num x c x 1 x 1
+      {"mul8", DATALAYOUT(kNCHW8c)},
+      // x of num x c x 1 x 1
+      {"mul_pool", DATALAYOUT(kNCHW)}};
+  EXPECT_EQ(layouts, expected);
+}
+
+}  // namespace mir
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_OP(conv2d);
+USE_LITE_OP(relu);
+USE_LITE_OP(pool2d);
+USE_LITE_OP(elementwise_add);
+USE_LITE_OP(elementwise_mul);
+USE_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW8c, def);
+USE_LITE_KERNEL(relu, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(relu, kX86, kFloat, kNCHW8c, def);
+USE_LITE_KERNEL(pool2d, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(pool2d, kX86, kFloat, kNCHW8c, def);
+USE_LITE_KERNEL(elementwise_add, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(elementwise_add, kX86, kFloat, kNCHW8c, def);
+USE_LITE_KERNEL(elementwise_mul, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(elementwise_mul, kX86, kFloat, kNCHW8c, def);
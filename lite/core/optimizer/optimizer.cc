@@ -157,6 +157,7 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "lite_conv_activation_fuse_pass",              //
        "lite_var_conv_2d_activation_fuse_pass",       //
        "lite_match_matrix_activation_fuse_pass",      //
+       "lite_scaled_dot_product_attention_fuse_pass",
        "lite_squeeze2_matmul_fuse_pass",              //
        "lite_reshape2_matmul_fuse_pass",              //
        "lite_matmul_element_add_fuse_pass",           //
@@ -169,6 +170,8 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "lite_scales_fuse_pass",                       //
        "lite_sequence_reverse_embedding_fuse_pass",   //
        "elementwise_mul_constant_eliminate_pass",     //
+       "lite_elementwise_chain_fuse_pass",
+       "lite_embedding_seq_pool_fuse_pass",           //
        "lite_sequence_pool_concat_fuse_pass",         //
        "lite_scale_activation_fuse_pass",             //
        "lite_scaleacts_fuse_pass",                    //
@@ -225,6 +228,8 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "remove_tf_redundant_ops_pass",
        "variable_place_inference_pass",  // inference arg/var's
        "control_flow_op_shared_inputs_and_outputs_place_sync_pass",
+       "x86_nchw8c_layout_pass",  // run the chains of x86 conv2d and the
+                                  // ops after it on nChw8c
        "__fpga_kernel_place_correct_pass",
        // "opencl_kernel_place_correct_pass", // uncommit this pass
        "mlu_postprocess_pass",
@@ -265,6 +270,7 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
        "argument_type_display_pass",
        "lite_inplace_fuse_pass",
 #if !(defined(LITE_WITH_FPGA) || defined(LITE_WITH_PRECISION_PROFILE))
+       "static_memory_plan_pass",
        "memory_optimize_pass",
        "xpu_memory_optimize_pass"
 #endif
@@ -309,6 +315,7 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
   const std::string pqd_pass{"post_quant_dynamic_pass"};
   const std::string pqd_depend_pass{"lite_quant_dequant_fuse_pass"};
   const std::string fp16_pass{"fp16_attribute_pass"};
+  const std::string bf16_pass{"bf16_attribute_pass"};
 
   for (const std::string& pass : passes) {
     if (pass == msa_pass) {
@@ -335,6 +342,13 @@ std::unique_ptr<RuntimeProgram> RunDefaultOptimizer(
     }
   }
 
+  for (auto place : valid_places) {
+    if (place.target == TARGET(kX86) && place.precision == PRECISION(kBF16)) {
+      passes_local.push_back(bf16_pass);
+      break;
+    }
+  }
+
   for (auto& pass_name : passes_local) {
     optim.AddPass(pass_name);
   }
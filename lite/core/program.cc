@@ -372,6 +372,47 @@ RuntimeProgram::RuntimeProgram(
   Init();
 }
 
+std::unique_ptr<RuntimeProgram> RuntimeProgram::Clone(
+    const std::shared_ptr<const cpp::ProgramDesc>& program_desc,
+    Scope* exec_scope) const {
+  std::vector<std::vector<Instruction>> insts(kRootBlockIdx + 1);
+  for (auto& origin : instructions_[kRootBlockIdx]) {
+    std::string op_type = origin.op()->Type();
+    auto op = LiteOpRegistry::Global().Create(op_type);
+    CHECK(op) << "no Op found for " << op_type;
+    if (op_type == "while") {
+      static_cast<operators::WhileOp*>(op.get())->SetProgramDesc(program_desc);
+    } else if (op_type == "conditional_block") {
+      static_cast<operators::ConditionalBlockOp*>(op.get())->SetProgramDesc(
+          program_desc);
+    } else if (op_type == "subgraph") {
+      static_cast<operators::SubgraphOp*>(op.get())->SetProgramDesc(
+          program_desc);
+    }
+    op->Attach(*origin.op()->op_info(), exec_scope);
+    std::unique_ptr<KernelBase> kernel;
+    if (origin.kernel()) {
+      // Only the kernels registered for the place of the origin one are
+      // created.
+      auto kernels =
+          op->CreateKernels({}, origin.kernel()->SerializedKernelType());
+      for (auto& it : kernels) {
+        if (it->alias() == origin.kernel()->alias()) {
+          kernel = std::move(it);
+          break;
+        }
+      }
+      CHECK(kernel) << "no kernel found for "
+                    << origin.kernel()->key_with_alias();
+    }
+    insts[kRootBlockIdx].emplace_back(std::move(op), std::move(kernel));
+  }
+  std::unique_ptr<RuntimeProgram> program(new RuntimeProgram(std::move(insts)));
+  program->set_exec_scope(exec_scope);
+  program->set_version(version_);
+  return program;
+}
+
 #ifdef LITE_WITH_METAL
 void RuntimeProgram::ConfigMetalContext(std::string lib_path,
                                         bool use_mps,
@@ -418,48 +459,80 @@ void RuntimeProgram::Run() {
 
   int idx = -1;
 
+  if (!shape_cache_inited_) {
+    shape_cache_inited_ = true;
+    InitShapeCache();
+  }
+  if (shape_cache_) {
+    shape_cache_->BeginRun();
+  }
+  if (!inter_op_inited_) {
+    inter_op_inited_ = true;
+    InitInterOpScheduler();
+  }
+  // The workspace of this thread is grown at once to the scratch the kernels
+  // took on the last run, and follows it down, see WorkSpace::BeginRun().
+  size_t outer_workspace_peak =
+      WorkSpace::Global_Host().BeginRun(workspace_mark_);
+
   auto& insts = instructions_[kRootBlockIdx];
-  for (auto& inst : insts) {
-    ++idx;
+  if (inter_op_scheduler_) {
+    inter_op_scheduler_->Run(ThreadPool::Current(), [&](int i) {
+      if (shape_cache_) {
+        insts[i].Run(!shape_cache_->RestoreShapes(i));
+        shape_cache_->EndOp(i);
+      } else {
+        insts[i].Run();
+      }
+    });
+  } else {
+    for (auto& inst : insts) {
+      ++idx;
 #if !defined(LITE_WITH_FPGA) && !defined(LITE_WITH_METAL)
-    if (inst.is_feed_fetch_op()) continue;
+      if (inst.is_feed_fetch_op()) continue;
 #endif
 #ifdef LITE_WITH_NVTX
-    NVTXRangeAnnotation annotation = annotator.AnnotateBlock();
-    nvtxStringHandle_t registered_name = register_layer_names_[idx];
-    if (annotator.IsEnabled()) {
-      annotation.generate(registered_name, lite::Color::Runner);
-    }
+      NVTXRangeAnnotation annotation = annotator.AnnotateBlock();
+      nvtxStringHandle_t registered_name = register_layer_names_[idx];
+      if (annotator.IsEnabled()) {
+        annotation.generate(registered_name, lite::Color::Runner);
+      }
 #endif
 #ifdef LITE_WITH_CUDA
-    if (inst.need_sync()) {
-      inst.Sync();
-    }
+      if (inst.need_sync()) {
+        inst.Sync();
+      }
 #endif
 
 #ifdef LITE_WITH_FPGA
-    monitor.preRun(inst);
+      monitor.preRun(inst);
 #endif
 
 #ifdef LITE_WITH_OPENCL
-    // delegate flush judgement to specify target , it is too heavy for Inst
-    inst.Flush(idx);
+      // delegate flush judgement to specify target , it is too heavy for Inst
+      inst.Flush(idx);
 #endif
 
-    inst.Run();
+      if (shape_cache_) {
+        inst.Run(!shape_cache_->RestoreShapes(idx));
+        shape_cache_->EndOp(idx);
+      } else {
+        inst.Run();
+      }
 
 #ifdef LITE_WITH_FPGA
-    monitor.postRun(inst);
+      monitor.postRun(inst);
 #endif
 
 #ifdef LITE_WITH_PRECISION_PROFILE
 #ifndef LITE_WITH_FPGA
-    if (inst.op()->Type() != "while") {
-      precision_profiler_summary +=
-          inst_precision_profiler.GetInstPrecision(&inst);
-    }
+      if (inst.op()->Type() != "while") {
+        precision_profiler_summary +=
+            inst_precision_profiler.GetInstPrecision(&inst);
+      }
 #endif
 #endif  // LITE_WITH_PRECISION_PROFILE
+    }
   }
 
 #ifdef LITE_WITH_METAL
@@ -469,6 +542,15 @@ void RuntimeProgram::Run() {
   }
 #endif
 
+  workspace_mark_ = WorkSpace::Global_Host().EndRun(outer_workspace_peak);
+
+  if (!memory_planned_) {
+    memory_planned_ = true;
+    if (!inter_op_scheduler_) {
+      PlanMemory();
+    }
+  }
+
 #ifdef LITE_WITH_PROFILE
   LOG(INFO) << "\n" << profiler_.Summary(profile::Type::kDispatch, false, 1);
 #endif
@@ -479,6 +561,108 @@ void RuntimeProgram::Run() {
 #endif
 }
 
+void RuntimeProgram::InitShapeCache() {
+// The feed ops of FPGA and Metal are run by the program, the shapes of the
+// inputs are unknown before the run.
+#if !defined(LITE_WITH_FPGA) && !defined(LITE_WITH_METAL)
+  if (!shape_cache_enabled_ || !exec_scope_) return;
+  std::vector<const OpLite*> ops;
+  for (auto& inst : instructions_[kRootBlockIdx]) {
+    ops.push_back(inst.op());
+  }
+  std::unique_ptr<ProgramShapeCache> shape_cache(new ProgramShapeCache);
+  if (shape_cache->Init(ops, exec_scope_)) {
+    shape_cache_ = std::move(shape_cache);
+  }
+#endif
+}
+
+void RuntimeProgram::InitInterOpScheduler() {
+// The profilers record the instructions one after another.
+#if defined(LITE_USE_THREAD_POOL) && !defined(LITE_WITH_PROFILE) && \
+    !defined(LITE_WITH_PRECISION_PROFILE)
+  if (!inter_op_parallel_) return;
+  std::vector<const OpLite*> ops;
+  for (auto& inst : instructions_[kRootBlockIdx]) {
+    if (inst.is_feed_fetch_op()) {
+      ops.push_back(nullptr);
+      continue;
+    }
+    // Left to the sequential loop, which reports the missing kernel.
+    if (!inst.kernel()) {
+      LOG(WARNING) << "The inter-op parallelism is disabled, "
+                   << inst.op()->Type() << " has no kernel";
+      return;
+    }
+    auto target = inst.kernel()->target();
+    if (target != TARGET(kHost) && target != TARGET(kX86) &&
+        target != TARGET(kARM)) {
+      LOG(WARNING) << "The inter-op parallelism is disabled, the kernel of "
+                   << inst.op()->Type() << " runs on "
+                   << TargetToStr(target);
+      return;
+    }
+    ops.push_back(inst.op());
+  }
+  inter_op_scheduler_.reset(new InterOpScheduler);
+  inter_op_scheduler_->Init(ops);
+  VLOG(3) << "The inter-op scheduler runs " << ops.size()
+          << " instructions, the longest chain has "
+          << inter_op_scheduler_->critical_path();
+#endif
+}
+
+void RuntimeProgram::PlanMemory() {
+  if (!exec_scope_) return;
+  auto& insts = instructions_[kRootBlockIdx];
+  std::set<std::string> marked_vars;
+  for (auto& inst : insts) {
+    auto* op_info = inst.op()->op_info();
+    if (op_info->HasAttr(kMemoryPlanAttr)) {
+      auto names = op_info->GetAttr<std::vector<std::string>>(kMemoryPlanAttr);
+      marked_vars.insert(names.begin(), names.end());
+    }
+  }
+  if (marked_vars.empty()) return;
+
+  // The lifetime of a variable spans from the instruction writing it first to
+  // the last instruction using it, a variable that is read before it is
+  // written carries data between the runs and is left alone.
+  std::map<std::string, std::pair<int, int>> lifecycles;
+  std::set<std::string> invalid_vars;
+  for (size_t i = 0; i < insts.size(); ++i) {
+    auto* op_info = insts[i].op()->op_info();
+    for (auto& name : op_info->input_names()) {
+      if (!marked_vars.count(name)) continue;
+      if (lifecycles.count(name)) {
+        lifecycles[name].second = static_cast<int>(i);
+      } else {
+        invalid_vars.insert(name);
+      }
+    }
+    for (auto& name : op_info->output_names()) {
+      if (!marked_vars.count(name)) continue;
+      if (lifecycles.count(name)) {
+        lifecycles[name].second = static_cast<int>(i);
+      } else {
+        lifecycles[name] =
+            std::make_pair(static_cast<int>(i), static_cast<int>(i));
+      }
+    }
+  }
+
+  for (auto& name : invalid_vars) {
+    lifecycles.erase(name);
+  }
+  MemoryPlanner planner;
+  memory_arena_ = PlanScopeTensors(exec_scope_, lifecycles, &planner);
+  if (!memory_arena_) return;
+  LOG(INFO) << "Planned " << planner.num_tensors()
+            << " tensors into a memory arena of " << planner.arena_size()
+            << " bytes, the sum of their sizes is " << planner.naive_size()
+            << " bytes.";
+}
+
 void Program::Build(const std::shared_ptr<cpp::ProgramDesc>& program_desc) {
   CHECK(ops_.empty()) << "Executor duplicate Build found";
 
@@ -633,7 +817,7 @@ void Instruction::SaveOutput() {
 }
 #endif
 
-void Instruction::Run() {
+void Instruction::Run(bool infer_shape) {
 #ifdef LITE_WITH_PROFILE
   CHECK(profiler_) << "Profiler pointer of kernel can not be nullptr. "
                       "When LITE_WITH_PROFILE is defined, please set a "
@@ -646,6 +830,9 @@ void Instruction::Run() {
 
   if (first_epoch_) {
     first_epoch_ = false;
+    if (lazy_params_) {
+      lazy_params_->Load(op_->op_info()->input_names());
+    }
     CHECK(op_->CheckShape());
   }
 
@@ -653,7 +840,9 @@ void Instruction::Run() {
     return;
   }
 
-  op_->InferShape();
+  if (infer_shape) {
+    op_->InferShape();
+  }
   kernel_->Launch();
   has_run_ = true;
 
@@ -19,9 +19,13 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "lite/core/inter_op_scheduler.h"
 #include "lite/core/kernel.h"
+#include "lite/core/lazy_params.h"
+#include "lite/core/memory_planner.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/program_shape_cache.h"
 #include "lite/model_parser/cpp_desc.h"
 #ifdef LITE_WITH_PROFILE
 #include "lite/core/profile/profiler.h"
@@ -37,6 +41,9 @@ namespace paddle {
 namespace lite {
 
 static const char kKernelTypeAttr[] = "__@kernel_type_attr@__";
+// The output variables of an op that may be placed in the memory arena of the
+// runtime program, see RuntimeProgram::PlanMemory().
+static const char kMemoryPlanAttr[] = "__@memory_plan_vars@__";
 
 // A program is used to represent a code program, in Paddle, a code program
 // contains:
@@ -87,13 +94,14 @@ struct Program {
     return var_type_map_;
   }
 
- private:
-  // Build from a program and scope.
-  void Build(const std::shared_ptr<cpp::ProgramDesc>& program_desc);
   // Create temporary variables.
   void PrepareWorkspace(const std::shared_ptr<cpp::ProgramDesc>& program_desc,
                         const std::vector<std::string>& vars_to_clone = {});
 
+ private:
+  // Build from a program and scope.
+  void Build(const std::shared_ptr<cpp::ProgramDesc>& program_desc);
+
  private:
   std::map<std::string, const Type*> var_type_map_;
   std::list<std::string> vars_;
@@ -116,8 +124,9 @@ struct Instruction {
     }
   }
 
-  // Run the instruction.
-  void Run();
+  // Run the instruction, `infer_shape` is false if the output shapes have
+  // been restored by the ProgramShapeCache.
+  void Run(bool infer_shape = true);
 #ifdef LITE_WITH_METAL
   void SaveOutput();
 #endif
@@ -130,6 +139,9 @@ struct Instruction {
 
   bool is_feed_fetch_op() const { return is_feed_fetch_op_; }
 
+  // The lazy params among the inputs are loaded before the first run.
+  void set_lazy_params(LazyParams* lazy_params) { lazy_params_ = lazy_params; }
+
 #ifdef LITE_WITH_CUDA
   bool need_sync() const {
     if (kernel_->target() == TargetType::kCUDA) {
@@ -185,6 +197,7 @@ struct Instruction {
   bool is_feed_fetch_op_{false};
   bool first_epoch_{true};
   bool has_run_{false};
+  LazyParams* lazy_params_{nullptr};
 
 #ifdef LITE_WITH_PROFILE
   profile::Profiler* profiler_;
@@ -285,6 +298,13 @@ class LITE_API RuntimeProgram {
   void SaveOutput();
 #endif
 
+  // Create a program running the same ops and kernels on `exec_scope`, it
+  // skips the parsing of the op descs and the kernel picking. The ops of the
+  // sub-blocks are created from `program_desc`.
+  std::unique_ptr<RuntimeProgram> Clone(
+      const std::shared_ptr<const cpp::ProgramDesc>& program_desc,
+      Scope* exec_scope) const;
+
   void set_exec_scope(Scope* x) { exec_scope_ = x; }
   Scope* exec_scope() { return exec_scope_; }
 
@@ -302,6 +322,23 @@ class LITE_API RuntimeProgram {
 
   void set_version(const int64_t version) { version_ = version; }
 
+  // The program-level InferShape cache, nullptr before the first run or if
+  // the program can not be cached.
+  const ProgramShapeCache* shape_cache() const { return shape_cache_.get(); }
+
+  // Run the instructions that don't depend on each other at the same time on
+  // the thread pool bound to the calling thread, see InterOpScheduler. The
+  // memory arena of PlanMemory() is not used then, its plan relies on the
+  // sequential order. It must be set before the first run.
+  void set_inter_op_parallel(bool inter_op_parallel) {
+    inter_op_parallel_ = inter_op_parallel;
+  }
+  bool inter_op_parallel() const { return inter_op_parallel_; }
+
+  // Use the ProgramShapeCache, on by default. It must be set before the
+  // first run.
+  void set_shape_cache_enabled(bool enabled) { shape_cache_enabled_ = enabled; }
+
   const int64_t get_version() const { return version_; }
 
 #ifndef LITE_ON_TINY_PUBLISH
@@ -321,9 +358,27 @@ class LITE_API RuntimeProgram {
 
  private:
   RuntimeProgram(const RuntimeProgram&) = delete;
+  // Place the variables marked by the static_memory_plan_pass in one arena,
+  // sized by the shapes and data types of the first run, so that the later
+  // runs don't allocate them any more. A variable that outgrows its slice
+  // falls back to a buffer of its own.
+  void PlanMemory();
+  void InitShapeCache();
+  void InitInterOpScheduler();
+
   std::vector<std::vector<Instruction>> instructions_;
   Scope* exec_scope_{};
   int64_t version_{0};
+  bool memory_planned_{false};
+  std::shared_ptr<Buffer> memory_arena_;
+  bool shape_cache_enabled_{true};
+  bool shape_cache_inited_{false};
+  std::unique_ptr<ProgramShapeCache> shape_cache_;
+  // The most workspace the kernels took on the last run.
+  size_t workspace_mark_{0};
+  bool inter_op_parallel_{false};
+  bool inter_op_inited_{false};
+  std::unique_ptr<InterOpScheduler> inter_op_scheduler_;
 
 #ifdef LITE_WITH_METAL
   std::unique_ptr<KernelContext> metal_ctx_{nullptr};
@@ -0,0 +1,264 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/program_shape_cache.h"
+#include <cstring>
+#include <iterator>
+#include <set>
+#include <string>
+#include "lite/utils/hash.h"
+
+namespace paddle {
+namespace lite {
+
+constexpr size_t ProgramShapeCache::kDefaultCapacity;
+constexpr int64_t ProgramShapeCache::kMaxDataInputNumel;
+
+namespace {
+
+// The ops whose output shapes depend on the data of their inputs, or whose
+// InferShape keeps some state in the op parameters.
+const std::set<std::string> kInferAlwaysOps = {
+    "while",
+    "conditional_block",
+    "subgraph",
+    "select_input",
+    "lod_reset",
+    "sequence_mask",
+    "sequence_unpad",
+    "ctc_align",
+    "rnn",
+    "unbind",
+    "tile",
+    "fill_constant",
+    "range",
+    "linspace",
+    "uniform_random",
+    "gaussian_random",
+    "affine_grid",
+    "crop_tensor",
+    "where_index",
+    "unique",
+    "unique_with_counts",
+    "masked_select",
+    "write_to_array",
+    "read_from_array",
+    "tensor_array_to_tensor",
+    "lod_array_length",
+    "beam_search",
+    "beam_search_decode",
+};
+
+// The bytes of a tensor small enough to carry shapes, sizes or axes, the
+// others are not compared and yield nothing.
+size_t SmallDataSize(const Tensor* tensor) {
+  if (!tensor->IsInitialized() ||
+      tensor->numel() > ProgramShapeCache::kMaxDataInputNumel) {
+    return 0;
+  }
+  return tensor->numel() * PrecisionTypeLength(tensor->precision());
+}
+
+bool InferAlways(const OpInfo* op_info, Scope* exec_scope) {
+  if (kInferAlwaysOps.count(op_info->Type())) return true;
+  // The paddings of SAME and the kernel size of the global pooling are
+  // computed from the input shape by InferShape.
+  if (op_info->HasAttr("padding_algorithm") &&
+      op_info->GetAttr<std::string>("padding_algorithm") == "SAME") {
+    return true;
+  }
+  if (op_info->HasAttr("global_pooling") &&
+      op_info->GetAttr<bool>("global_pooling")) {
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+bool ProgramShapeCache::Init(const std::vector<const OpLite*>& ops,
+                             Scope* exec_scope) {
+  std::set<std::string> written;
+  std::set<std::string> read;
+  for (auto* op : ops) {
+    auto* op_info = op->op_info();
+    output_begin_.push_back(outputs_.size());
+    op_input_begin_.push_back(op_inputs_.size());
+    if (op_info->Type() == "feed" || op_info->Type() == "fetch") {
+      infer_always_.push_back(true);
+      continue;
+    }
+    infer_always_.push_back(InferAlways(op_info, exec_scope));
+    for (auto& name : op_info->input_names()) {
+      // The weights live in the parent scope, their data never changes.
+      auto* var = exec_scope->FindLocalVar(name);
+      if (var && var->IsType<Tensor>()) {
+        op_inputs_.push_back(&var->Get<Tensor>());
+      }
+      if (written.count(name) || read.count(name)) continue;
+      read.insert(name);
+      if (!var) continue;
+      if (!var->IsType<Tensor>()) return false;
+      inputs_.push_back(&var->Get<Tensor>());
+    }
+    for (auto& name : op_info->output_names()) {
+      written.insert(name);
+      auto* var = exec_scope->FindVar(name);
+      if (!var || !var->IsType<Tensor>()) continue;
+      outputs_.push_back(var->GetMutable<Tensor>());
+    }
+  }
+  output_begin_.push_back(outputs_.size());
+  op_input_begin_.push_back(op_inputs_.size());
+  unstable_.assign(ops.size(), 0);
+  restored_.assign(ops.size(), 0);
+  return !inputs_.empty();
+}
+
+size_t ProgramShapeCache::Signature() const {
+  size_t hash = inputs_.size();
+  for (auto* tensor : inputs_) {
+    const auto& dims = tensor->dims();
+    CombineHash(dims.size(), &hash);
+    for (size_t i = 0; i < dims.size(); ++i) {
+      CombineHash(dims[i], &hash);
+    }
+    for (auto& level : tensor->lod()) {
+      CombineHash(level.size(), &hash);
+      for (auto offset : level) {
+        CombineHash(offset, &hash);
+      }
+    }
+  }
+  return hash;
+}
+
+bool ProgramShapeCache::MatchInputs(const Entry& entry) const {
+  for (size_t i = 0; i < inputs_.size(); ++i) {
+    if (entry.input_dims[i] != inputs_[i]->dims() ||
+        entry.input_lods[i] != inputs_[i]->lod()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ProgramShapeCache::MatchOpInputs(int idx) const {
+  for (size_t i = op_input_begin_[idx]; i < op_input_begin_[idx + 1]; ++i) {
+    const auto* tensor = op_inputs_[i];
+    const auto& recorded = current_->op_input_data[i];
+    if (current_->op_input_dims[i] != tensor->dims() ||
+        current_->op_input_lods[i] != tensor->lod() ||
+        SmallDataSize(tensor) != recorded.size()) {
+      return false;
+    }
+    // The InferShape of the op may read the data of its small inputs.
+    if (!recorded.empty() &&
+        memcmp(tensor->raw_data(), recorded.data(), recorded.size()) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ProgramShapeCache::Drop(std::list<Entry>::iterator entry) {
+  index_.erase(entry->signature);
+  entries_.erase(entry);
+}
+
+bool ProgramShapeCache::BeginRun() {
+  hit_ = false;
+  has_current_ = false;
+  size_t signature = Signature();
+  auto it = index_.find(signature);
+  if (it != index_.end()) {
+    if (MatchInputs(*it->second)) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      current_ = entries_.begin();
+      has_current_ = true;
+      hit_ = true;
+      ++hits_;
+      return true;
+    }
+    // Two signatures collided, the entry is recorded again.
+    Drop(it->second);
+  }
+  ++misses_;
+  if (capacity_ == 0) return false;
+  if (entries_.size() >= capacity_) {
+    Drop(std::prev(entries_.end()));
+  }
+  entries_.emplace_front();
+  current_ = entries_.begin();
+  current_->signature = signature;
+  for (auto* tensor : inputs_) {
+    current_->input_dims.push_back(tensor->dims());
+    current_->input_lods.push_back(tensor->lod());
+  }
+  current_->output_dims.resize(outputs_.size());
+  current_->output_lods.resize(outputs_.size());
+  current_->op_input_dims.resize(op_inputs_.size());
+  current_->op_input_lods.resize(op_inputs_.size());
+  current_->op_input_data.resize(op_inputs_.size());
+  index_[signature] = current_;
+  has_current_ = true;
+  return false;
+}
+
+bool ProgramShapeCache::RestoreShapes(int idx) {
+  restored_[idx] = 0;
+  if (!has_current_) return false;
+  if (hit_ && !infer_always_[idx] && !unstable_[idx] && MatchOpInputs(idx)) {
+    for (size_t i = output_begin_[idx]; i < output_begin_[idx + 1]; ++i) {
+      outputs_[i]->Resize(current_->output_dims[i]);
+      outputs_[i]->set_lod(current_->output_lods[i]);
+    }
+    restored_[idx] = 1;
+    return true;
+  }
+  // The op infers its shapes, its record is updated. The inputs are
+  // recorded before the op runs, it may write them in place.
+  for (size_t i = op_input_begin_[idx]; i < op_input_begin_[idx + 1]; ++i) {
+    const auto* tensor = op_inputs_[i];
+    current_->op_input_dims[i] = tensor->dims();
+    current_->op_input_lods[i] = tensor->lod();
+    const char* data = static_cast<const char*>(tensor->raw_data());
+    current_->op_input_data[i].assign(data, data + SmallDataSize(tensor));
+  }
+  return false;
+}
+
+void ProgramShapeCache::EndOp(int idx) {
+  if (!has_current_) return;
+  if (restored_[idx]) {
+    for (size_t i = output_begin_[idx]; i < output_begin_[idx + 1]; ++i) {
+      if (current_->output_dims[i] != outputs_[i]->dims() ||
+          current_->output_lods[i] != outputs_[i]->lod()) {
+        // The shapes depend on the data, the op infers them from now on.
+        // The ops reading its outputs don't match their records any more
+        // and infer theirs too.
+        unstable_[idx] = 1;
+        return;
+      }
+    }
+    return;
+  }
+  for (size_t i = output_begin_[idx]; i < output_begin_[idx + 1]; ++i) {
+    current_->output_dims[i] = outputs_[i]->dims();
+    current_->output_lods[i] = outputs_[i]->lod();
+  }
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,132 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "lite/core/op_lite.h"
+#include "lite/core/scope.h"
+#include "lite/core/tensor.h"
+
+namespace paddle {
+namespace lite {
+
+/*
+ * ProgramShapeCache skips the InferShape of a whole program when its inputs
+ * have the same shapes and LoDs as in one of the last runs.
+ *
+ * The signature of a run is the hash of the dims and LoDs of the program
+ * inputs, i.e. the variables that are read before being written. On a miss
+ * the output shapes of every instruction are recorded under the signature,
+ * on a hit they are restored and the InferShape of the instruction is not
+ * called, except for the ops whose output shapes depend on the data of their
+ * inputs or whose InferShape updates the op parameters.
+ *
+ * InferShape may also read the data of small inputs carrying shapes, sizes or
+ * axes, e.g. the ExpandTimes of expand or the Paddings of pad2d, whatever
+ * their names. The shapes, LoDs and the data of at most kMaxDataInputNumel
+ * elements of the inputs of every op are recorded too, an op whose inputs
+ * differ from the recorded ones infers its shapes as usual and its record is
+ * updated. After every restored op the outputs are checked against the
+ * recorded shapes, an op whose kernel resized its outputs differently, e.g. a
+ * NMS kernel, is not restored any more, the other ops are kept on the fast
+ * path.
+ *
+ * RestoreShapes and EndOp may be called from different threads for the ops
+ * that don't depend on each other.
+ *
+ * The last `capacity` signatures are kept, the least recently used one is
+ * dropped first, so that alternating batch sizes stay on the fast path.
+ */
+class ProgramShapeCache {
+ public:
+  static constexpr size_t kDefaultCapacity = 8;
+  static constexpr int64_t kMaxDataInputNumel = 64;
+
+  explicit ProgramShapeCache(size_t capacity = kDefaultCapacity)
+      : capacity_(capacity) {}
+
+  // Collect the inputs and outputs of the ops in the execution order, the
+  // feed and fetch ops are left out. Return false if the program can not be
+  // cached, e.g. one of its inputs is not a tensor.
+  bool Init(const std::vector<const OpLite*>& ops, Scope* exec_scope);
+
+  // Look up the signature of the current inputs, return true on a hit.
+  bool BeginRun();
+  // Restore the output shapes of op `idx` if its InferShape may be skipped,
+  // otherwise record its inputs.
+  bool RestoreShapes(int idx);
+  // Record or verify the output shapes of op `idx` after it ran.
+  void EndOp(int idx);
+  // Whether the output shapes of op `idx` changed in a kernel after they
+  // were restored, its InferShape is always called then.
+  bool unstable(int idx) const { return unstable_[idx] != 0; }
+
+  int64_t hits() const { return hits_; }
+  int64_t misses() const { return misses_; }
+  size_t size() const { return entries_.size(); }
+
+ private:
+  struct Entry {
+    size_t signature;
+    std::vector<DDim> input_dims;
+    std::vector<LoD> input_lods;
+    std::vector<DDim> output_dims;
+    std::vector<LoD> output_lods;
+    // The inputs of the ops, the bytes of the small ones, empty for the
+    // others.
+    std::vector<DDim> op_input_dims;
+    std::vector<LoD> op_input_lods;
+    std::vector<std::vector<char>> op_input_data;
+  };
+
+  size_t Signature() const;
+  bool MatchInputs(const Entry& entry) const;
+  bool MatchOpInputs(int idx) const;
+  void Drop(std::list<Entry>::iterator entry);
+
+  size_t capacity_;
+  std::vector<const Tensor*> inputs_;
+  std::vector<Tensor*> outputs_;
+  // The outputs of op i are outputs_[output_begin_[i], output_begin_[i + 1]).
+  std::vector<size_t> output_begin_;
+  // The inputs of op i that are not weights are
+  // op_inputs_[op_input_begin_[i], op_input_begin_[i + 1]).
+  std::vector<const Tensor*> op_inputs_;
+  std::vector<size_t> op_input_begin_;
+  // Whether the InferShape of op i must always be called.
+  std::vector<bool> infer_always_;
+  // Bytes rather than bits, the ops that don't depend on each other set
+  // theirs at the same time.
+  std::vector<char> unstable_;
+  std::vector<char> restored_;
+
+  // The most recently used entry comes first.
+  std::list<Entry> entries_;
+  std::unordered_map<size_t, std::list<Entry>::iterator> index_;
+  // The entry restored from or recorded into by the current run, valid if
+  // has_current_.
+  std::list<Entry>::iterator current_;
+  bool has_current_{false};
+  bool hit_{false};
+
+  int64_t hits_{0};
+  int64_t misses_{0};
+};
+
+}  // namespace lite
+}  // namespace paddle
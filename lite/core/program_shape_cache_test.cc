@@ -0,0 +1,205 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/program_shape_cache.h"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+// An op of one input and one output, its InferShape is done by the test.
+class FakeOp : public OpLite {
+ public:
+  explicit FakeOp(const std::string& type) : OpLite(type) {}
+  bool AttachImpl(const cpp::OpDesc& opdesc, lite::Scope* scope) override {
+    return true;
+  }
+  void AttachKernel(KernelBase* kernel) override {}
+  std::string DebugString() const override { return op_type_; }
+};
+
+class ProgramShapeCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    exec_scope_ = &scope_.NewScope();
+    // x -> relu -> a -> scale -> b
+    AddOp("relu", "x", "a");
+    AddOp("scale", "a", "b");
+    x_ = exec_scope_->Var("x")->GetMutable<Tensor>();
+    a_ = exec_scope_->Var("a")->GetMutable<Tensor>();
+    b_ = exec_scope_->Var("b")->GetMutable<Tensor>();
+  }
+
+  void AddOp(const std::string& type,
+             const std::string& input,
+             const std::string& output) {
+    cpp::OpDesc desc;
+    desc.SetType(type);
+    desc.SetInput("X", {input});
+    desc.SetOutput("Out", {output});
+    std::unique_ptr<FakeOp> op(new FakeOp(type));
+    op->Attach(desc, exec_scope_);
+    ops_.push_back(std::move(op));
+  }
+
+  std::vector<const OpLite*> ops() const {
+    std::vector<const OpLite*> res;
+    for (auto& op : ops_) res.push_back(op.get());
+    return res;
+  }
+
+  // Run the program with the given batch size, return the number of the
+  // InferShape calls.
+  int Run(ProgramShapeCache* cache, int64_t batch) {
+    x_->Resize({batch, 8});
+    cache->BeginRun();
+    int infer_num = 0;
+    Tensor* outs[] = {a_, b_};
+    for (int i = 0; i < 2; ++i) {
+      if (!cache->RestoreShapes(i)) {
+        outs[i]->Resize({batch, 8});
+        infer_num++;
+      }
+      EXPECT_EQ(outs[i]->dims()[0], batch);
+      cache->EndOp(i);
+    }
+    return infer_num;
+  }
+
+  Scope scope_;
+  Scope* exec_scope_;
+  std::vector<std::unique_ptr<FakeOp>> ops_;
+  Tensor* x_;
+  Tensor* a_;
+  Tensor* b_;
+};
+
+TEST_F(ProgramShapeCacheTest, hit_and_miss) {
+  ProgramShapeCache cache;
+  ASSERT_TRUE(cache.Init(ops(), exec_scope_));
+  EXPECT_EQ(Run(&cache, 1), 2);
+  EXPECT_EQ(Run(&cache, 1), 0);
+  EXPECT_EQ(Run(&cache, 4), 2);
+  // Alternating batch sizes stay on the fast path.
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(Run(&cache, 1), 0);
+    EXPECT_EQ(Run(&cache, 4), 0);
+  }
+  EXPECT_EQ(cache.hits(), 9);
+  EXPECT_EQ(cache.misses(), 2);
+}
+
+TEST_F(ProgramShapeCacheTest, lru) {
+  ProgramShapeCache cache(2);
+  ASSERT_TRUE(cache.Init(ops(), exec_scope_));
+  Run(&cache, 1);
+  Run(&cache, 2);
+  Run(&cache, 1);
+  // Drops batch 2, the least recently used one.
+  Run(&cache, 3);
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_EQ(Run(&cache, 1), 0);
+  EXPECT_EQ(Run(&cache, 2), 2);
+}
+
+TEST_F(ProgramShapeCacheTest, shapes_changed_by_kernel) {
+  ProgramShapeCache cache;
+  ASSERT_TRUE(cache.Init(ops(), exec_scope_));
+  Run(&cache, 1);
+  // The first op resizes its output in the kernel, like a NMS.
+  auto run = [&](int64_t rows) {
+    x_->Resize({1, 8});
+    EXPECT_TRUE(cache.BeginRun());
+    int infer_num = 0;
+    if (!cache.RestoreShapes(0)) infer_num++;
+    a_->Resize({rows, 8});
+    cache.EndOp(0);
+    if (!cache.RestoreShapes(1)) {
+      b_->Resize(a_->dims());
+      infer_num++;
+    }
+    EXPECT_EQ(b_->dims(), a_->dims());
+    cache.EndOp(1);
+    return infer_num;
+  };
+  // The restored shapes of the first op are overwritten, its InferShape is
+  // called from now on, the second op infers the shapes of the new input.
+  EXPECT_EQ(run(5), 1);
+  EXPECT_TRUE(cache.unstable(0));
+  EXPECT_FALSE(cache.unstable(1));
+  // The entry is kept, the second op is restored while its input keeps the
+  // shape of the last run.
+  EXPECT_EQ(run(5), 1);
+  EXPECT_EQ(run(3), 2);
+  EXPECT_EQ(run(3), 1);
+  EXPECT_FALSE(cache.unstable(1));
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_EQ(cache.hits(), 4);
+  EXPECT_EQ(cache.misses(), 1);
+}
+
+TEST_F(ProgramShapeCacheTest, shape_tensor) {
+  AddOp("fill_constant", "b", "c");
+  exec_scope_->Var("c")->GetMutable<Tensor>();
+  ProgramShapeCache cache;
+  ASSERT_TRUE(cache.Init(ops(), exec_scope_));
+  Run(&cache, 1);
+  ASSERT_TRUE(cache.BeginRun());
+  EXPECT_TRUE(cache.RestoreShapes(1));
+  EXPECT_FALSE(cache.RestoreShapes(2));
+}
+
+TEST_F(ProgramShapeCacheTest, expand_times) {
+  // b -> expand(ExpandTimes = times) -> c, the times come with the input.
+  cpp::OpDesc desc;
+  desc.SetType("expand");
+  desc.SetInput("X", {"b"});
+  desc.SetInput("ExpandTimes", {"times"});
+  desc.SetOutput("Out", {"c"});
+  std::unique_ptr<FakeOp> op(new FakeOp("expand"));
+  op->Attach(desc, exec_scope_);
+  ops_.push_back(std::move(op));
+  auto* times = exec_scope_->Var("times")->GetMutable<Tensor>();
+  auto* c = exec_scope_->Var("c")->GetMutable<Tensor>();
+  times->Resize({2});
+  ProgramShapeCache cache;
+  ASSERT_TRUE(cache.Init(ops(), exec_scope_));
+
+  // Returns the number of the InferShape calls of expand.
+  auto run = [&](int times_0, int times_1) {
+    auto* times_data = times->mutable_data<int>();
+    times_data[0] = times_0;
+    times_data[1] = times_1;
+    Run(&cache, 1);
+    int infer_num = 0;
+    if (!cache.RestoreShapes(2)) {
+      c->Resize({times_0, 8 * times_1});
+      infer_num++;
+    }
+    cache.EndOp(2);
+    EXPECT_EQ(c->dims(), DDim({times_0, 8 * times_1}));
+    return infer_num;
+  };
+  EXPECT_EQ(run(2, 3), 1);
+  EXPECT_EQ(run(2, 3), 0);
+  // Same input shapes, other times.
+  EXPECT_EQ(run(4, 1), 1);
+  EXPECT_EQ(run(2, 3), 1);
+}
+
+}  // namespace lite
+}  // namespace paddle
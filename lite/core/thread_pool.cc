@@ -13,12 +13,132 @@
 // limitations under the License.
 
 #include "lite/core/thread_pool.h"
+#include <limits.h>
 #include <string.h>
+#include <algorithm>
+#if defined(__linux__) || defined(__ANDROID__)
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#else
+#include <condition_variable>  //NOLINT
+#endif
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
 #include "lite/utils/log/logging.h"
+#include "lite/utils/macros.h"
 
 namespace paddle {
 namespace lite {
 
+namespace {
+
+// Number of polls before a waiting thread goes to sleep.
+const int kSpinCount = 4096;
+// Each worker gets about this many chunks of a loop, which leaves room for
+// stealing when the iterations are skewed.
+const int kChunksPerThread = 4;
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+  _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+#if defined(__linux__) || defined(__ANDROID__)
+// Sleep until `*addr` is woken, returns at once if `*addr != expected`.
+inline void FutexWait(std::atomic<int>* addr, int expected) {
+  syscall(SYS_futex,
+          reinterpret_cast<int*>(addr),
+          FUTEX_WAIT_PRIVATE,
+          expected,
+          nullptr,
+          nullptr,
+          0);
+}
+inline void FutexWakeAll(std::atomic<int>* addr) {
+  syscall(SYS_futex,
+          reinterpret_cast<int*>(addr),
+          FUTEX_WAKE_PRIVATE,
+          INT_MAX,
+          nullptr,
+          nullptr,
+          0);
+}
+#else
+// Portable emulation for the platforms without futex.
+std::mutex gFutexMutex;
+std::condition_variable gFutexCv;
+inline void FutexWait(std::atomic<int>* addr, int expected) {
+  std::unique_lock<std::mutex> lck(gFutexMutex);
+  gFutexCv.wait(lck, [&]() { return addr->load() != expected; });
+}
+inline void FutexWakeAll(std::atomic<int>* addr) {
+  std::lock_guard<std::mutex> lck(gFutexMutex);
+  gFutexCv.notify_all();
+}
+#endif
+
+// Spin, then yield, and report false once the thread should go to sleep.
+inline bool Backoff(int* idle) {
+  ++*idle;
+  if (*idle < kSpinCount / 2) {
+    CpuRelax();
+  } else if (*idle < kSpinCount) {
+    std::this_thread::yield();
+  } else {
+    return false;
+  }
+  return true;
+}
+
+class SpinLockGuard {
+ public:
+  explicit SpinLockGuard(std::atomic_flag* lock) : lock_(lock) {
+    while (lock_->test_and_set(std::memory_order_acquire)) {
+      CpuRelax();
+    }
+  }
+  ~SpinLockGuard() { lock_->clear(std::memory_order_release); }
+
+ private:
+  std::atomic_flag* lock_;
+};
+
+inline void BindCurrentThread(int cpu_id) {
+#if defined(__linux__) || defined(__ANDROID__)
+  cpu_set_t mask;
+  CPU_ZERO(&mask);
+  CPU_SET(cpu_id, &mask);
+  if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+    LOG(WARNING) << "Failed to bind the thread pool worker to CPU " << cpu_id;
+  }
+#endif
+}
+
+// The pool and the slot the current thread is working for.
+LITE_THREAD_LOCAL ThreadPool* tls_pool = nullptr;
+LITE_THREAD_LOCAL int tls_slot = 0;
+// The pool bound by ThreadPool::ScopedBind.
+LITE_THREAD_LOCAL ThreadPool* tls_bound_pool = nullptr;
+
+}  // namespace
+
+struct ThreadPool::Job {
+  const TASK* task{nullptr};
+  int start{0};
+  int step{1};
+  // Number of chunks that are not finished yet.
+  std::atomic<int> pending{0};
+  // Set by the thread that ran the last chunk once it is done waking the
+  // issuing thread, which keeps the job alive until then.
+  std::atomic<bool> released{false};
+};
+
 ThreadPool* ThreadPool::gInstance = nullptr;
 static std::mutex gInitMutex;  // confirm thread-safe when use singleton mode
 int ThreadPool::Init(int number) {
@@ -40,75 +160,232 @@ void ThreadPool::Destroy() {
   }
 }
 
-ThreadPool::ThreadPool(int number) {
-  thread_num_ = number;
+std::shared_ptr<ThreadPool> ThreadPool::Create(
+    int number, const std::vector<int>& cpu_ids) {
+  return std::shared_ptr<ThreadPool>(new ThreadPool(number, cpu_ids));
+}
+
+ThreadPool* ThreadPool::Current() {
+  if (tls_pool) {
+    return tls_pool;
+  }
+  return tls_bound_pool ? tls_bound_pool : gInstance;
+}
+
+ThreadPool::ScopedBind::ScopedBind(ThreadPool* pool) : prev_(tls_bound_pool) {
+  tls_bound_pool = pool;
+}
+
+ThreadPool::ScopedBind::~ScopedBind() { tls_bound_pool = prev_; }
+
+ThreadPool::ThreadPool(int number, const std::vector<int>& cpu_ids) {
+  thread_num_ = std::max(number, 1);
   for (int i = 0; i < thread_num_; ++i) {
-    tasks_.second.emplace_back(new std::atomic<bool>{false});
+    slots_.emplace_back(new Slot);
   }
   for (int thread_index = 1; thread_index < thread_num_; ++thread_index) {
-    workers_.emplace_back([this, thread_index]() {
-      while (!stop_) {
-        std::unique_lock<std::mutex> lck(gInstance->mutex_);
-        cv_.wait(lck, [&]() {
-          return *tasks_.second[thread_index] == true || stop_ == true;
-        });
-        lck.unlock();
-        tasks_.first(thread_index, thread_index);
-        *tasks_.second[thread_index] = false;
+    // Thread 0 is the calling thread, the first worker takes cpu_ids[0].
+    const int worker_index = thread_index - 1;
+    int cpu_id =
+        cpu_ids.empty() ? -1 : cpu_ids[worker_index % cpu_ids.size()];
+    workers_.emplace_back([this, thread_index, cpu_id]() {
+      if (cpu_id >= 0) {
+        BindCurrentThread(cpu_id);
       }
+      WorkerLoop(thread_index);
     });
   }
 }
 
 ThreadPool::~ThreadPool() {
   stop_ = true;
-  cv_.notify_all();
+  epoch_.fetch_add(1);
+  FutexWakeAll(&epoch_);
   for (auto& worker : workers_) {
     worker.join();
   }
-  for (auto c : tasks_.second) {
-    delete c;
+}
+
+void ThreadPool::WorkerLoop(int slot) {
+  tls_pool = this;
+  tls_slot = slot;
+  int idle = 0;
+  while (!stop_.load(std::memory_order_relaxed)) {
+    Chunk chunk;
+    if (PopLocal(slot, nullptr, &chunk) || Steal(slot, &chunk)) {
+      RunChunk(chunk, slot);
+      idle = 0;
+      continue;
+    }
+    if (Backoff(&idle)) {
+      continue;
+    }
+    // Read the epoch before the last look at the deques, a chunk published
+    // after that look bumps the epoch and makes FutexWait return at once.
+    int epoch = epoch_.load();
+    if (Steal(slot, &chunk)) {
+      RunChunk(chunk, slot);
+      idle = 0;
+      continue;
+    }
+    sleepers_.fetch_add(1);
+    if (!stop_.load()) {
+      FutexWait(&epoch_, epoch);
+    }
+    sleepers_.fetch_sub(1);
+    idle = 0;
   }
 }
 
+void ThreadPool::Push(int slot, const Chunk& chunk) {
+  SpinLockGuard guard(&slots_[slot]->lock);
+  slots_[slot]->chunks.push_back(chunk);
+}
+
+bool ThreadPool::PopLocal(int slot, const Job* job, Chunk* chunk) {
+  Slot* s = slots_[slot].get();
+  SpinLockGuard guard(&s->lock);
+  if (s->chunks.empty() || (job && s->chunks.back().job != job)) {
+    return false;
+  }
+  *chunk = s->chunks.back();
+  s->chunks.pop_back();
+  return true;
+}
+
+bool ThreadPool::Steal(int slot, Chunk* chunk) {
+  for (int i = 1; i < thread_num_; ++i) {
+    Slot* s = slots_[(slot + i) % thread_num_].get();
+    SpinLockGuard guard(&s->lock);
+    if (!s->chunks.empty()) {
+      *chunk = s->chunks.front();
+      s->chunks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::RunChunk(const Chunk& chunk, int slot) {
+  Job* job = chunk.job;
+  for (int i = chunk.begin; i < chunk.end; ++i) {
+    (*job->task)(job->start + i * job->step, slot);
+  }
+  // `job` lives on the stack of the issuing thread, which may return as soon
+  // as it sees `released`, so nothing is touched after that store.
+  if (job->pending.fetch_sub(1) == 1) {
+    FutexWakeAll(&job->pending);
+    job->released.store(true, std::memory_order_release);
+  }
+}
+
+void ThreadPool::WakeWorkers() {
+  epoch_.fetch_add(1);
+  if (sleepers_.load() > 0) {
+    FutexWakeAll(&epoch_);
+  }
+}
+
+void ThreadPool::ParallelFor(const TASK& task, int end, int start, int step) {
+  CHECK_GT(step, 0) << "ThreadPool only supports positive step";
+  int work_size = end > start ? (end - start + step - 1) / step : 0;
+  if (work_size <= 1 || thread_num_ <= 1) {
+    for (int v = start; v < end; v += step) {
+      task(v, tls_pool == this ? tls_slot : 0);
+    }
+    return;
+  }
+  const bool nested = (tls_pool == this);
+  std::unique_lock<std::mutex> caller_lock(caller_mutex_, std::defer_lock);
+  ThreadPool* prev_pool = tls_pool;
+  int prev_slot = tls_slot;
+  if (!nested) {
+    caller_lock.lock();
+    tls_pool = this;
+    tls_slot = 0;
+  }
+  const int slot = tls_slot;
+
+  int chunk_num = std::min(work_size, thread_num_ * kChunksPerThread);
+  int chunk_size = (work_size + chunk_num - 1) / chunk_num;
+  chunk_num = (work_size + chunk_size - 1) / chunk_size;
+
+  Job job;
+  job.task = &task;
+  job.start = start;
+  job.step = step;
+  job.pending.store(chunk_num);
+  // A top-level loop is dealt round-robin over all the deques, so that every
+  // worker starts from its own share; a nested loop stays on the current
+  // worker and the idle ones steal from it.
+  for (int c = chunk_num - 1; c >= 0; --c) {
+    Chunk chunk;
+    chunk.job = &job;
+    chunk.begin = c * chunk_size;
+    chunk.end = std::min(work_size, chunk.begin + chunk_size);
+    Push(nested ? slot : c % thread_num_, chunk);
+  }
+  WakeWorkers();
+
+  int idle = 0;
+  while (true) {
+    int left = job.pending.load(std::memory_order_acquire);
+    if (left == 0) {
+      break;
+    }
+    Chunk chunk;
+    // The top-level caller has nothing on its stack and may help with any
+    // chunk, a nested caller only runs the chunks of its own loop.
+    if (PopLocal(slot, &job, &chunk) || (!nested && Steal(slot, &chunk))) {
+      RunChunk(chunk, slot);
+      idle = 0;
+      continue;
+    }
+    if (Backoff(&idle)) {
+      continue;
+    }
+    FutexWait(&job.pending, left);
+  }
+  // The last chunk may still be waking this thread through `job.pending`,
+  // which only takes a syscall.
+  while (!job.released.load(std::memory_order_acquire)) {
+    CpuRelax();
+  }
+
+  if (!nested) {
+    tls_pool = prev_pool;
+    tls_slot = prev_slot;
+  }
+}
+
+bool ThreadPool::RunPendingChunk() {
+  if (tls_pool != this) {
+    return false;
+  }
+  const int slot = tls_slot;
+  Chunk chunk;
+  if (PopLocal(slot, nullptr, &chunk) || Steal(slot, &chunk)) {
+    RunChunk(chunk, slot);
+    return true;
+  }
+  return false;
+}
+
+void ThreadPool::WaitForWork(int epoch) {
+  sleepers_.fetch_add(1);
+  FutexWait(&epoch_, epoch);
+  sleepers_.fetch_sub(1);
+}
+
 void ThreadPool::Enqueue(TASK_BASIC&& task) {
-  if (task.second <= 1 || (nullptr == gInstance)) {
+  ThreadPool* pool = Current();
+  if (task.second <= 1 || (nullptr == pool)) {
     for (int i = 0; i < task.second; ++i) {
       task.first(i, 0);
     }
     return;
   }
-  int work_size = task.second;
-  if (work_size > gInstance->thread_num_) {
-    gInstance->tasks_.first = [work_size, &task](int index, int tId) {
-      for (int v = tId; v < work_size; v += gInstance->thread_num_) {
-        task.first(v, tId);  // nested lambda func
-      }
-    };
-    work_size = gInstance->thread_num_;
-  } else {
-    gInstance->tasks_.first = std::move(task.first);
-  }
-  for (int i = 1; i < work_size; ++i) {
-    std::unique_lock<std::mutex> lck(gInstance->mutex_);
-    *(gInstance->tasks_.second[i]) = true;
-    gInstance->cv_.notify_all();
-  }
-  // invoke tid 0 callback in main thread
-  // other tid task is invoked in child thread
-  gInstance->tasks_.first(0, 0);
-  bool complete = true;
-  // check tid 1 to thread_num - 1 all work completed in child thread
-  do {
-    std::this_thread::yield();
-    complete = true;
-    for (int i = 1; i < work_size; ++i) {
-      if (*gInstance->tasks_.second[i]) {
-        complete = false;
-        break;
-      }
-    }
-  } while (!complete);
+  pool->ParallelFor(task.first, task.second, 0, 1);
 }
 
 void ThreadPool::Enqueue(TASK_COMMON&& task) {
@@ -116,47 +393,14 @@ void ThreadPool::Enqueue(TASK_COMMON&& task) {
   int start = std::get<2>(task);
   int step = std::get<3>(task);
   int work_size = (end - start + step - 1) / step;
-  if (work_size <= 1 || (nullptr == gInstance)) {
+  ThreadPool* pool = Current();
+  if (work_size <= 1 || (nullptr == pool)) {
     for (int v = start; v < end; v += step) {
       std::get<0>(task)(v, 0);
     }
     return;
   }
-  if (work_size > gInstance->thread_num_) {
-    gInstance->tasks_.first = ([=, &task](int index, int tId) {
-      auto start_index = start + tId * step;
-      auto stride = gInstance->thread_num_ * step;
-      for (int v = start_index; v < end; v += stride) {
-        std::get<0>(task)(v, tId);  // nested lambda func
-      }
-    });
-    work_size = gInstance->thread_num_;
-  } else {
-    gInstance->tasks_.first = ([=, &task](int index, int tId) {
-      auto v = start + tId * step;
-      std::get<0>(task)(v, tId);  // nested lambda func
-    });
-  }
-  for (int i = 1; i < work_size; ++i) {
-    std::unique_lock<std::mutex> lck(gInstance->mutex_);
-    *(gInstance->tasks_.second[i]) = true;
-    gInstance->cv_.notify_all();
-  }
-  // invoke tid 0 callback in main thread
-  // other tid task is invoked in new thread
-  gInstance->tasks_.first(0, 0);
-  bool complete = true;
-  // check tid 1 to thread_num - 1 all work completed in new thread
-  do {
-    std::this_thread::yield();
-    complete = true;
-    for (int i = 1; i < work_size; ++i) {
-      if (*gInstance->tasks_.second[i]) {
-        complete = false;
-        break;
-      }
-    }
-  } while (!complete);
+  pool->ParallelFor(std::get<0>(task), end, start, step);
 }
 
 }  // namespace lite
@@ -14,8 +14,9 @@
 
 #pragma once
 #include <atomic>
-#include <condition_variable>  //NOLINT
+#include <deque>
 #include <functional>
+#include <memory>
 #include <mutex>   //NOLINT
 #include <thread>  //NOLINT
 #include <tuple>
@@ -25,6 +26,30 @@
 namespace paddle {
 namespace lite {
 
+/*
+ * ThreadPool executes the parallel-for loops issued by LITE_PARALLEL_BEGIN/END
+ * and LITE_PARALLEL_COMMON_BEGIN/END.
+ *
+ * Every call splits its iteration space into chunks. Each worker owns a deque
+ * of chunks: the owner pops from the back, idle workers steal from the front.
+ * Idle workers spin for a short while and then sleep on a futex, so no
+ * condition variable is involved on the hot path.
+ *
+ * A parallel-for issued from inside a running chunk is really parallel: its
+ * chunks are pushed to the current worker's deque, where they can be stolen by
+ * the others, and the issuing worker only helps with the chunks of its own
+ * loop while waiting, so the `tid` slots used by the outer loop are never
+ * reused underneath it.
+ *
+ * The `tid` passed to the loop body is the index of the executing worker, it
+ * is always in the range [0, thread_num).
+ *
+ * Every predictor owns a pool created by `Create()` and binds it to the
+ * calling thread with `ScopedBind` for the duration of `Run()`, so predictors
+ * running concurrently on different threads never share workers. `Enqueue()`
+ * dispatches to the pool bound to the current thread, and falls back to the
+ * process-wide pool set up by `Init()`.
+ */
 class ThreadPool {
  public:
   typedef std::function<void(int, int)> TASK;
@@ -36,16 +61,94 @@ class ThreadPool {
   static int Init(int number);
   static void Destroy();
 
+  // Create a pool with `number` threads, the calling thread being thread 0
+  // and the workers threads 1 to number - 1. If `cpu_ids` is not empty,
+  // thread k > 0 is pinned to cpu_ids[(k - 1) % cpu_ids.size()], the calling
+  // thread is left as is.
+  static std::shared_ptr<ThreadPool> Create(
+      int number, const std::vector<int>& cpu_ids = std::vector<int>());
+  // The pool the parallel loops of the current thread are dispatched to.
+  static ThreadPool* Current();
+
+  // Bind a pool to the current thread until the guard goes out of scope.
+  class ScopedBind {
+   public:
+    explicit ScopedBind(ThreadPool* pool);
+    ~ScopedBind();
+
+   private:
+    ThreadPool* prev_;
+  };
+
+  ~ThreadPool();
+
+  // Run `task(v, tid)` for v in [start, end) with stride `step`, and return
+  // after all the iterations are done.
+  void ParallelFor(const TASK& task, int end, int start, int step);
+
+  // Run one chunk queued on this pool, if any, and return whether one was
+  // run. It must be called from a loop body of this pool that is waiting for
+  // something else and holds nothing indexed by its `tid`, the chunk runs
+  // with the same `tid`. The instruction lanes of RuntimeProgram use it to
+  // help with the parallel loops of the kernels running on the other lanes.
+  bool RunPendingChunk();
+
+  // Park a waiting loop body until work shows up: read `epoch()` before the
+  // last look for work, then `WaitForWork(epoch)` sleeps until chunks are
+  // published on this pool or `Notify()` is called after that read.
+  int epoch() const { return epoch_.load(); }
+  void WaitForWork(int epoch);
+  void Notify() { WakeWorkers(); }
+
+  int thread_num() const { return thread_num_; }
+
+  // The threads of the pool the parallel loops of the current thread are
+  // dispatched to, 1 without a pool. The kernels size their tasks by it.
+  static int CurrentThreadNum() {
+#ifdef LITE_USE_THREAD_POOL
+    ThreadPool* pool = Current();
+    return pool ? pool->thread_num() : 1;
+#else
+    return 1;
+#endif
+  }
+
  private:
+  struct Job;
+  struct Chunk {
+    Job* job{nullptr};
+    int begin{0};
+    int end{0};
+  };
+  // The per-worker deque, the critical sections are a few instructions long,
+  // so a spin lock is used instead of a mutex.
+  struct Slot {
+    std::atomic_flag lock = ATOMIC_FLAG_INIT;
+    std::deque<Chunk> chunks;
+  };
+
   static ThreadPool* gInstance;
-  explicit ThreadPool(int number = 0);
-  ~ThreadPool();
+  explicit ThreadPool(int number = 0,
+                      const std::vector<int>& cpu_ids = std::vector<int>());
+
+  void WorkerLoop(int slot);
+  void Push(int slot, const Chunk& chunk);
+  // Pop the newest chunk of `slot`, restricted to `job` if it is not null.
+  bool PopLocal(int slot, const Job* job, Chunk* chunk);
+  // Steal the oldest chunk of any other slot.
+  bool Steal(int slot, Chunk* chunk);
+  void RunChunk(const Chunk& chunk, int slot);
+  void WakeWorkers();
 
   std::vector<std::thread> workers_;
+  std::vector<std::unique_ptr<Slot>> slots_;
   std::atomic<bool> stop_{false};
-  std::pair<TASK, std::vector<std::atomic<bool>*>> tasks_;
-  std::condition_variable cv_;
-  std::mutex mutex_;
+  // Bumped whenever chunks are published, sleeping workers wait on it.
+  std::atomic<int> epoch_{0};
+  std::atomic<int> sleepers_{0};
+  // Slot 0 belongs to the external caller, top-level loops from different
+  // external threads take turns on it.
+  std::mutex caller_mutex_;
 
   int thread_num_ = 0;
 };
@@ -0,0 +1,130 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/thread_pool.h"
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>  //NOLINT
+#include <vector>
+
+namespace paddle {
+namespace lite {
+
+TEST(thread_pool, basic) {
+  const int thread_num = ThreadPool::Init(4);
+  for (int work_size : {0, 1, 3, 4, 17, 1000}) {
+    std::vector<std::atomic<int>> hits(work_size);
+    for (auto& h : hits) h = 0;
+    std::atomic<bool> tid_ok{true};
+    ThreadPool::Enqueue(std::make_pair(
+        std::function<void(int, int)>([&](int i, int tid) {
+          hits[i]++;
+          if (tid < 0 || tid >= thread_num) tid_ok = false;
+        }),
+        work_size));
+    for (int i = 0; i < work_size; ++i) {
+      EXPECT_EQ(hits[i], 1) << "work_size " << work_size << " index " << i;
+    }
+    EXPECT_TRUE(tid_ok);
+  }
+  ThreadPool::Destroy();
+}
+
+TEST(thread_pool, common) {
+  ThreadPool::Init(4);
+  const int start = 3, end = 103, step = 7;
+  std::vector<std::atomic<int>> hits(end);
+  for (auto& h : hits) h = 0;
+  ThreadPool::Enqueue(std::make_tuple(
+      std::function<void(int, int)>([&](int i, int tid) { hits[i]++; }),
+      end,
+      start,
+      step));
+  for (int i = 0; i < end; ++i) {
+    bool visited = i >= start && (i - start) % step == 0;
+    EXPECT_EQ(hits[i], visited ? 1 : 0) << "index " << i;
+  }
+  ThreadPool::Destroy();
+}
+
+TEST(thread_pool, nested) {
+  const int thread_num = ThreadPool::Init(4);
+  const int outer = 8, inner = 64;
+  std::vector<std::atomic<int>> hits(outer * inner);
+  for (auto& h : hits) h = 0;
+  std::atomic<bool> tid_ok{true};
+  ThreadPool::Enqueue(std::make_pair(
+      std::function<void(int, int)>([&](int i, int) {
+        ThreadPool::Enqueue(std::make_pair(
+            std::function<void(int, int)>([&, i](int j, int tid) {
+              hits[i * inner + j]++;
+              if (tid < 0 || tid >= thread_num) tid_ok = false;
+            }),
+            inner));
+      }),
+      outer));
+  for (int i = 0; i < outer * inner; ++i) {
+    EXPECT_EQ(hits[i], 1) << "index " << i;
+  }
+  EXPECT_TRUE(tid_ok);
+  ThreadPool::Destroy();
+}
+
+TEST(thread_pool, per_predictor_pools) {
+  // Two predictors running concurrently, each with its own pool.
+  auto pool_a = ThreadPool::Create(3);
+  auto pool_b = ThreadPool::Create(2);
+  const int work_size = 4096;
+  auto run = [&](ThreadPool* pool, std::vector<int>* out, bool* tid_ok) {
+    ThreadPool::ScopedBind bind(pool);
+    EXPECT_EQ(ThreadPool::Current(), pool);
+    for (int repeat = 0; repeat < 50; ++repeat) {
+      ThreadPool::Enqueue(std::make_pair(
+          std::function<void(int, int)>([&](int i, int tid) {
+            (*out)[i] += 1;
+            if (tid < 0 || tid >= pool->thread_num()) *tid_ok = false;
+          }),
+          work_size));
+    }
+  };
+  std::vector<int> out_a(work_size, 0), out_b(work_size, 0);
+  bool tid_ok_a = true, tid_ok_b = true;
+  std::thread ta(run, pool_a.get(), &out_a, &tid_ok_a);
+  std::thread tb(run, pool_b.get(), &out_b, &tid_ok_b);
+  ta.join();
+  tb.join();
+  for (int i = 0; i < work_size; ++i) {
+    EXPECT_EQ(out_a[i], 50);
+    EXPECT_EQ(out_b[i], 50);
+  }
+  EXPECT_TRUE(tid_ok_a);
+  EXPECT_TRUE(tid_ok_b);
+  EXPECT_EQ(ThreadPool::Current(), nullptr);
+}
+
+TEST(thread_pool, short_loops) {
+  // Back to back loops of two chunks reuse the stack of the job of the last
+  // one while its worker may still be finishing it.
+  auto pool = ThreadPool::Create(4);
+  ThreadPool::ScopedBind bind(pool.get());
+  std::atomic<int> sum{0};
+  for (int repeat = 0; repeat < 20000; ++repeat) {
+    ThreadPool::Enqueue(std::make_pair(
+        std::function<void(int, int)>([&](int i, int) { sum += i; }), 2));
+  }
+  EXPECT_EQ(sum, 20000);
+}
+
+}  // namespace lite
+}  // namespace paddle
@@ -185,22 +185,26 @@ static bool TargetCompatibleTo(const Type& a, const Type& b) {
   return true;
 }
 
+// The blocked layouts are only read by the kernels declaring them, kAny
+// means any of the plain ones.
+static bool IsBlockedDataLayout(DataLayoutType layout) {
+  return layout == DATALAYOUT(kImageDefault) ||
+         layout == DATALAYOUT(kImageFolder) || layout == DATALAYOUT(kNCHW8c);
+}
+
 static bool DataLayoutCompatibleTo(const Type& a, const Type& b) {
   return a.IsVoid() ||                 //
          (a.layout() == b.layout() ||  //
           ((b.layout() == DATALAYOUT(kAny)) &&
-           (a.layout() != DATALAYOUT(kImageDefault) &&
-            a.layout() != DATALAYOUT(kImageFolder))));
+           !IsBlockedDataLayout(a.layout())));
 }
 static bool DataLayoutCompatible(const Type& a, const Type& b) {
   return a.IsVoid() || b.IsVoid() ||   //
          (a.layout() == b.layout() ||  //
           ((b.layout() == DATALAYOUT(kAny)) &&
-           (a.layout() != DATALAYOUT(kImageDefault) &&
-            a.layout() != DATALAYOUT(kImageFolder))) ||
+           !IsBlockedDataLayout(a.layout())) ||
           ((a.layout() == DATALAYOUT(kAny)) &&
-           (b.layout() != DATALAYOUT(kImageDefault) &&
-            b.layout() != DATALAYOUT(kImageFolder))));
+           !IsBlockedDataLayout(b.layout())));
 }
 
 static bool PrecisionCompatibleTo(const Type& a, const Type& b) {
@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #pragma once
+#include <algorithm>
 #include <memory>
+#include <vector>
 #include "lite/core/memory.h"
 #include "lite/core/types.h"
 #include "lite/utils/macros.h"
@@ -29,26 +31,127 @@ namespace lite {
  * not suitable here, one need to carefully manage the workspace inside a single
  * kernel.
  *
+ * The workspace is a per-thread bump allocator: `Alloc()` hands out 64-byte
+ * aligned slices of one buffer, and `KernelBase::Launch()` resets it before
+ * every kernel. The pointers handed out stay valid until the next reset. The
+ * largest amount requested between two resets is kept as the high-water mark,
+ * and the buffer is grown to it once, so after the first run no kernel
+ * touches the heap for its scratch memory.
+ *
+ * The high-water mark is kept by every program as well: `BeginRun()` grows
+ * the buffer to the mark of the last run of the program at once, so a
+ * predictor run from another thread does not grow it kernel after kernel,
+ * and the buffer is shrunk to the largest mark of the last `kShrinkRuns`
+ * runs, so it follows the shapes and the programs run on the thread down as
+ * well as up. The threads of the pool never reset their workspace, a task
+ * rewinding it to empty folds the overflow instead.
+ *
  * NOTE
  *
  * For kernel developers, one need to call the workspace as follows:
  *
- * - call `WorkSpace::Global().Alloc()` if needed to allocate some temporary
- * buffer.
+ * - call `WorkSpace::Global_X86().Reserve()` in `PrepareForRun()` with the
+ * largest scratch size the kernel will need, so that the buffer is grown
+ * before the first `Run()`.
+ * - call `WorkSpace::Global_X86().Alloc()` in `Run()` to get the buffer.
+ * - a kernel that needs scratch memory in a loop can save `cursor()` and
+ * `Rewind()` to it at the end of every iteration.
  */
 class WorkSpace {
  public:
-  // Reset the workspace, and treat the workspace as empty.
-  void AllocReset() { cursor_ = 0; }
+  static const size_t kAlignment = 64;
+  // The number of runs after which the buffer is shrunk to their marks.
+  static const int kShrinkRuns = 16;
+
+  // Reset the workspace, and treat the workspace as empty. The blocks that
+  // overflowed the buffer since the last reset are folded into it.
+  void AllocReset() {
+    cursor_ = 0;
+    Fold();
+  }
+
+  // Raise the high-water mark to `size` bytes, the buffer is grown at once if
+  // it is not in use, otherwise at the next reset.
+  void Reserve(size_t size) {
+    size = AlignUp(size);
+    high_water_ = (std::max)(high_water_, size);
+    run_peak_ = (std::max)(run_peak_, size);
+    if (cursor_ == 0) {
+      Fold();
+    }
+  }
+
+  // Start a run of a program whose kernels took at most `mark` bytes on its
+  // last run, see RuntimeProgram::Run(). No kernel holds the workspace
+  // between two kernels, so it is reset. Returns the peak of the enclosing
+  // run, to be passed to EndRun().
+  size_t BeginRun(size_t mark) {
+    size_t outer_peak = run_peak_;
+    cursor_ = 0;
+    run_peak_ = 0;
+    window_mark_ = (std::max)(window_mark_, mark);
+    high_water_ = (std::max)(high_water_, mark);
+    if (++window_runs_ >= kShrinkRuns) {
+      high_water_ = window_mark_;
+      if (buffer_.space() > high_water_) {
+        overflow_.clear();
+        buffer_.Free();
+      }
+      window_mark_ = 0;
+      window_runs_ = 0;
+    }
+    Fold();
+    return outer_peak;
+  }
+
+  // End the run started by BeginRun(), returns the most its kernels took.
+  size_t EndRun(size_t outer_peak) {
+    size_t peak = run_peak_;
+    run_peak_ = (std::max)(outer_peak, peak);
+    return peak;
+  }
 
   // Allocate a memory buffer.
   core::byte_t* Alloc(size_t size) {
-    buffer_.ResetLazy(target_, cursor_ + size);
-    auto* data = static_cast<core::byte_t*>(buffer_.data()) + cursor_;
-    cursor_ += size;
-    return data;
+    size_t offset = AlignUp(cursor_);
+    cursor_ = offset + AlignUp(size);
+    high_water_ = (std::max)(high_water_, cursor_);
+    run_peak_ = (std::max)(run_peak_, cursor_);
+    if (cursor_ <= buffer_.space()) {
+      return static_cast<core::byte_t*>(buffer_.data()) + offset;
+    }
+    if (offset == 0) {
+      Grow(cursor_);
+      return static_cast<core::byte_t*>(buffer_.data());
+    }
+    // The buffer can not be moved under the pointers handed out before, so
+    // serve the request from a separate block that lives until the next reset.
+    std::unique_ptr<Buffer> block(new Buffer);
+    block->ResetLazy(target_, size);
+    ++heap_alloc_count_;
+    overflow_.emplace_back(std::move(block));
+    return static_cast<core::byte_t*>(overflow_.back()->data());
   }
 
+  template <typename T>
+  T* Alloc(size_t count) {
+    return reinterpret_cast<T*>(Alloc(count * sizeof(T)));
+  }
+
+  size_t cursor() const { return cursor_; }
+  // Release everything allocated after `cursor`.
+  void Rewind(size_t cursor) {
+    cursor_ = (std::min)(cursor, cursor_);
+    if (cursor_ == 0) {
+      Fold();
+    }
+  }
+
+  size_t high_water() const { return high_water_; }
+  // Number of times the workspace asked the heap for memory, it stays the same
+  // from the second run of a model with fixed shapes on.
+  int64_t heap_alloc_count() const { return heap_alloc_count_; }
+
   static WorkSpace& Global_Host() {
     static LITE_THREAD_LOCAL std::unique_ptr<WorkSpace> x(
         new WorkSpace(TARGET(kHost)));
@@ -89,9 +192,34 @@ class WorkSpace {
  private:
   explicit WorkSpace(TargetType x) : target_(x) {}
 
+  static size_t AlignUp(size_t size) {
+    return (size + kAlignment - 1) / kAlignment * kAlignment;
+  }
+
+  // Grow the buffer to the high-water mark, dropping the overflow blocks.
+  void Fold() {
+    if (buffer_.space() < high_water_) {
+      overflow_.clear();
+      Grow(high_water_);
+    }
+  }
+
+  void Grow(size_t size) {
+    buffer_.ResetLazy(target_, size);
+    ++heap_alloc_count_;
+  }
+
   TargetType target_;
   Buffer buffer_;
-  size_t cursor_;
+  std::vector<std::unique_ptr<Buffer>> overflow_;
+  size_t cursor_{0};
+  size_t high_water_{0};
+  // The most taken since BeginRun().
+  size_t run_peak_{0};
+  // The largest mark and the number of the runs since the last shrink.
+  size_t window_mark_{0};
+  int window_runs_{0};
+  int64_t heap_alloc_count_{0};
 
   DISALLOW_COPY_AND_ASSIGN(WorkSpace);
 };
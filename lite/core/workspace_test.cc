@@ -0,0 +1,155 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/core/workspace.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <thread>  // NOLINT
+#include "lite/tests/utils/count_new.h"
+
+namespace paddle {
+namespace lite {
+
+TEST(workspace, bump_allocation) {
+  auto& workspace = WorkSpace::Global_Host();
+  workspace.AllocReset();
+  workspace.Reserve(1024);
+  int64_t heap_alloc_count = workspace.heap_alloc_count();
+
+  auto* a = workspace.Alloc(100);
+  auto* b = workspace.Alloc(200);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % WorkSpace::kAlignment, 0u);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % WorkSpace::kAlignment, 0u);
+  EXPECT_GE(b - a, 100);
+  EXPECT_EQ(workspace.heap_alloc_count(), heap_alloc_count);
+
+  // Rewind hands the same memory out again.
+  size_t mark = workspace.cursor();
+  auto* c = workspace.Alloc(64);
+  workspace.Rewind(mark);
+  EXPECT_EQ(workspace.Alloc(64), c);
+}
+
+TEST(workspace, overflow_keeps_pointers_valid) {
+  auto& workspace = WorkSpace::Global_Host();
+  workspace.AllocReset();
+  size_t space = workspace.high_water();
+  auto* a = workspace.Alloc(space);
+  memset(a, 1, space);
+  // Does not fit, must not move `a`.
+  auto* b = workspace.Alloc(space * 2);
+  memset(b, 2, space * 2);
+  EXPECT_EQ(a[0], 1);
+  EXPECT_EQ(a[space - 1], 1);
+
+  // The next round is served from one buffer of the high-water size.
+  workspace.AllocReset();
+  EXPECT_GE(workspace.high_water(), space * 3);
+  int64_t heap_alloc_count = workspace.heap_alloc_count();
+  workspace.Alloc(space);
+  workspace.Alloc(space * 2);
+  EXPECT_EQ(workspace.heap_alloc_count(), heap_alloc_count);
+}
+
+TEST(workspace, begin_run_grows_to_the_mark) {
+  // A program run on this thread keeps the scratch size its kernels took,
+  // another thread running it later grows its buffer once, as the run
+  // begins.
+  const size_t size = 3 << 20;
+  auto& workspace = WorkSpace::Global_Host();
+  size_t outer_peak = workspace.BeginRun(0);
+  workspace.AllocReset();
+  workspace.Alloc(size / 2);
+  workspace.Alloc(size / 2);
+  size_t mark = workspace.EndRun(outer_peak);
+  EXPECT_GE(mark, size);
+  std::thread([&]() {
+    auto& thread_workspace = WorkSpace::Global_Host();
+    EXPECT_EQ(thread_workspace.heap_alloc_count(), 0);
+    size_t thread_outer_peak = thread_workspace.BeginRun(mark);
+    EXPECT_EQ(thread_workspace.heap_alloc_count(), 1);
+    NewCounter counter;
+    for (int run = 0; run < 3; ++run) {
+      thread_workspace.AllocReset();
+      memset(thread_workspace.Alloc(size / 2), 0, size / 2);
+      memset(thread_workspace.Alloc(size / 2), 0, size / 2);
+    }
+    EXPECT_EQ(counter.count(), 0);
+    EXPECT_EQ(thread_workspace.heap_alloc_count(), 1);
+    EXPECT_EQ(thread_workspace.EndRun(thread_outer_peak), mark);
+  }).join();
+}
+
+TEST(workspace, shrink_to_the_marks_of_the_last_runs) {
+  std::thread([]() {
+    auto& workspace = WorkSpace::Global_Host();
+    const size_t big = 4 << 20;
+    const size_t small = 4096;
+    size_t outer_peak = workspace.BeginRun(0);
+    workspace.Alloc(big);
+    size_t mark = workspace.EndRun(outer_peak);
+    EXPECT_EQ(workspace.high_water(), big);
+    // The big run is forgotten once a whole window of runs has gone by
+    // without it.
+    for (int run = 0; run < 2 * WorkSpace::kShrinkRuns; ++run) {
+      outer_peak = workspace.BeginRun(mark);
+      workspace.Alloc(small);
+      mark = workspace.EndRun(outer_peak);
+    }
+    EXPECT_EQ(mark, small);
+    EXPECT_EQ(workspace.high_water(), small);
+    int64_t heap_alloc_count = workspace.heap_alloc_count();
+    NewCounter counter;
+    outer_peak = workspace.BeginRun(mark);
+    workspace.Alloc(small);
+    workspace.EndRun(outer_peak);
+    EXPECT_EQ(counter.count(), 0);
+    EXPECT_EQ(workspace.heap_alloc_count(), heap_alloc_count);
+  }).join();
+}
+
+TEST(workspace, nested_runs_keep_the_outer_peak) {
+  auto& workspace = WorkSpace::Global_Host();
+  size_t outer_peak = workspace.BeginRun(0);
+  workspace.Alloc(8192);
+  // A sub-block run by a kernel of the outer program.
+  size_t inner_outer_peak = workspace.BeginRun(0);
+  workspace.Alloc(1024);
+  EXPECT_EQ(workspace.EndRun(inner_outer_peak), 1024u);
+  EXPECT_EQ(workspace.EndRun(outer_peak), 8192u);
+}
+
+TEST(workspace, rewind_folds_overflow) {
+  // The threads of the pool never reset their workspace, the scratch of a
+  // task is rewound to empty instead.
+  std::thread([]() {
+    auto& workspace = WorkSpace::Global_Host();
+    for (int task = 0; task < 3; ++task) {
+      size_t mark = workspace.cursor();
+      workspace.Alloc(1024);
+      workspace.Alloc(4096);
+      workspace.Rewind(mark);
+    }
+    EXPECT_GE(workspace.high_water(), 1024u + 4096u);
+    int64_t heap_alloc_count = workspace.heap_alloc_count();
+    workspace.Alloc(1024);
+    workspace.Alloc(4096);
+    workspace.Rewind(0);
+    EXPECT_EQ(workspace.heap_alloc_count(), heap_alloc_count);
+  }).join();
+}
+
+}  // namespace lite
+}  // namespace paddle
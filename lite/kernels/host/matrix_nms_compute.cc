@@ -17,50 +17,14 @@
 #include <map>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms.h"
+#include "lite/core/parallel_defines.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace host {
 
-template <class T>
-static T BBoxArea(const T* box, const bool normalized) {
-  if (box[2] < box[0] || box[3] < box[1]) {
-    // If coordinate values are is invalid
-    // (e.g. xmax < xmin or ymax < ymin), return 0.
-    return static_cast<T>(0.);
-  } else {
-    const T w = box[2] - box[0];
-    const T h = box[3] - box[1];
-    if (normalized) {
-      return w * h;
-    } else {
-      // If coordinate values are not within range [0, 1].
-      return (w + 1) * (h + 1);
-    }
-  }
-}
-
-template <class T>
-static T JaccardOverlap(const T* box1, const T* box2, const bool normalized) {
-  if (box2[0] > box1[2] || box2[2] < box1[0] || box2[1] > box1[3] ||
-      box2[3] < box1[1]) {
-    return static_cast<T>(0.);
-  } else {
-    const T inter_xmin = (std::max)(box1[0], box2[0]);
-    const T inter_ymin = (std::max)(box1[1], box2[1]);
-    const T inter_xmax = (std::min)(box1[2], box2[2]);
-    const T inter_ymax = (std::min)(box1[3], box2[3]);
-    T norm = normalized ? static_cast<T>(0.) : static_cast<T>(1.);
-    T inter_w = inter_xmax - inter_xmin + norm;
-    T inter_h = inter_ymax - inter_ymin + norm;
-    const T inter_area = inter_w * inter_h;
-    const T bbox1_area = BBoxArea<T>(box1, normalized);
-    const T bbox2_area = BBoxArea<T>(box2, normalized);
-    return inter_area / (bbox1_area + bbox2_area - inter_area);
-  }
-}
-
 template <class T>
 T PolyIoU(const T* box1,
           const T* box2,
@@ -104,40 +68,21 @@ void NMSMatrix(const Tensor& bbox,
   auto bbox_ptr = bbox.data<T>();
 
   std::vector<int32_t> perm(num_boxes);
-  std::iota(perm.begin(), perm.end(), 0);
-  auto end = std::remove_if(
-      perm.begin(), perm.end(), [&score_ptr, score_threshold](int32_t idx) {
-        return score_ptr[idx] <= score_threshold;
-      });
-  auto sort_fn = [&score_ptr](int32_t lhs, int32_t rhs) {
-    return score_ptr[lhs] > score_ptr[rhs];
-  };
-
-  int64_t num_pre = std::distance(perm.begin(), end);
+  int64_t num_pre = lite::host::math::nms_candidates(
+      score_ptr, num_boxes, score_threshold, top_k, perm.data());
   if (num_pre <= 0) {
     return;
   }
-  if (top_k > -1 && num_pre > top_k) {
-    num_pre = top_k;
-  }
-  std::partial_sort(perm.begin(), perm.begin() + num_pre, end, sort_fn);
 
   std::vector<T> iou_matrix((num_pre * (num_pre - 1)) >> 1);
   std::vector<T> iou_max(num_pre);
-
-  iou_max[0] = 0.;
-  for (int64_t i = 1; i < num_pre; i++) {
-    T max_iou = 0.;
-    auto idx_a = perm[i];
-    for (int64_t j = 0; j < i; j++) {
-      auto idx_b = perm[j];
-      auto iou = JaccardOverlap<T>(
-          bbox_ptr + idx_a * box_size, bbox_ptr + idx_b * box_size, normalized);
-      max_iou = (std::max)(max_iou, iou);
-      iou_matrix[i * (i - 1) / 2 + j] = iou;
-    }
-    iou_max[i] = max_iou;
-  }
+  lite::host::math::nms_iou_matrix(bbox_ptr,
+                                   box_size,
+                                   perm.data(),
+                                   num_pre,
+                                   normalized,
+                                   iou_matrix.data(),
+                                   iou_max.data());
 
   if (score_ptr[perm[0]] > post_threshold) {
     selected_indices->push_back(perm[0]);
@@ -181,38 +126,45 @@ size_t MultiClassMatrixNMS(const Tensor& scores,
   all_scores.reserve(scores.numel());
   all_classes.reserve(scores.numel());
 
-  size_t num_det = 0;
-  auto class_num = scores.dims()[0];
-  Tensor score_slice;
-  for (int64_t c = 0; c < class_num; ++c) {
-    if (c == background_label) continue;
-    score_slice = scores.Slice<float>(c, c + 1);
-    if (use_gaussian) {
-      NMSMatrix<T, true>(bboxes,
-                         score_slice,
-                         score_threshold,
-                         post_threshold,
-                         gaussian_sigma,
-                         nms_top_k,
-                         normalized,
-                         &all_indices,
-                         &all_scores);
-    } else {
-      NMSMatrix<T, false>(bboxes,
-                          score_slice,
-                          score_threshold,
-                          post_threshold,
-                          gaussian_sigma,
-                          nms_top_k,
-                          normalized,
-                          &all_indices,
-                          &all_scores);
+  // The classes are independent, run them on the threads.
+  int class_num = scores.dims()[0];
+  std::vector<std::vector<int>> class_indices(class_num);
+  std::vector<std::vector<T>> class_scores(class_num);
+  LITE_PARALLEL_BEGIN(c, tid, class_num) {
+    if (c != background_label) {
+      Tensor score_slice = scores.Slice<float>(c, c + 1);
+      if (use_gaussian) {
+        NMSMatrix<T, true>(bboxes,
+                           score_slice,
+                           score_threshold,
+                           post_threshold,
+                           gaussian_sigma,
+                           nms_top_k,
+                           normalized,
+                           &class_indices[c],
+                           &class_scores[c]);
+      } else {
+        NMSMatrix<T, false>(bboxes,
+                            score_slice,
+                            score_threshold,
+                            post_threshold,
+                            gaussian_sigma,
+                            nms_top_k,
+                            normalized,
+                            &class_indices[c],
+                            &class_scores[c]);
+      }
     }
-    for (size_t i = 0; i < all_indices.size() - num_det; i++) {
-      all_classes.push_back(static_cast<T>(c));
-    }
-    num_det = all_indices.size();
   }
+  LITE_PARALLEL_END();
+  for (int c = 0; c < class_num; ++c) {
+    all_indices.insert(
+        all_indices.end(), class_indices[c].begin(), class_indices[c].end());
+    all_scores.insert(
+        all_scores.end(), class_scores[c].begin(), class_scores[c].end());
+    all_classes.resize(all_indices.size(), static_cast<T>(c));
+  }
+  size_t num_det = all_indices.size();
 
   if (num_det <= 0) {
     return num_det;
@@ -17,9 +17,11 @@
 #include <map>
 #include <utility>
 #include <vector>
+#include "lite/backends/host/math/nms.h"
 #include "lite/backends/host/math/nms_util.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
+#include "lite/core/parallel_defines.h"
 namespace paddle {
 namespace lite {
 namespace kernels {
@@ -74,52 +76,42 @@ void NMSFast(const Tensor& bbox,
   // 16, 24, or 32: [x1 y1 x2 y2 ...  xn yn], n = 8, 12 or 16
   int64_t box_size = bbox.dims()[1];
 
-  std::vector<T> scores_data(num_boxes);
-  std::copy_n(scores.data<T>(), num_boxes, scores_data.begin());
-  std::vector<std::pair<T, int>> sorted_indices;
-  lite::host::math::GetMaxScoreIndex(
-      scores_data, score_threshold, top_k, &sorted_indices);
-
-  selected_indices->clear();
-  T adaptive_threshold = nms_threshold;
+  // The candidates sorted by score are compacted into the kept ones in place.
+  selected_indices->resize(num_boxes);
+  int* order = selected_indices->data();
+  int num = lite::host::math::nms_candidates(
+      scores.data<T>(), num_boxes, score_threshold, top_k, order);
   const T* bbox_data = bbox.data<T>();
 
-  while (sorted_indices.size() != 0) {
-    const int idx = sorted_indices.front().second;
+  if (box_size == 4) {
+    num = lite::host::math::nms_boxes(
+        bbox_data, 4, order, num, nms_threshold, eta, normalized, order);
+    selected_indices->resize(num);
+    return;
+  }
+  // 8: [x1 y1 x2 y2 x3 y3 x4 y4] or 16, 24, 32
+  const bool is_poly = box_size == 8 || box_size == 16 || box_size == 24 ||
+                       box_size == 32;
+  T adaptive_threshold = nms_threshold;
+  int kept = 0;
+  for (int i = 0; i < num; ++i) {
+    const int idx = order[i];
     bool keep = true;
-    for (size_t k = 0; k < selected_indices->size(); ++k) {
-      if (keep) {
-        const int kept_idx = (*selected_indices)[k];
-        T overlap = T(0.);
-        // 4: [xmin ymin xmax ymax]
-        if (box_size == 4) {
-          overlap = lite::host::math::JaccardOverlap<T>(
-              bbox_data + idx * box_size,
-              bbox_data + kept_idx * box_size,
-              normalized);
-        }
-        // 8: [x1 y1 x2 y2 x3 y3 x4 y4] or 16, 24, 32
-        if (box_size == 8 || box_size == 16 || box_size == 24 ||
-            box_size == 32) {
-          overlap =
-              lite::host::math::PolyIoU<T>(bbox_data + idx * box_size,
-                                           bbox_data + kept_idx * box_size,
-                                           box_size,
-                                           normalized);
-        }
-        keep = overlap <= adaptive_threshold;
-      } else {
-        break;
-      }
+    for (int k = 0; k < kept && keep && is_poly; ++k) {
+      T overlap = lite::host::math::PolyIoU<T>(bbox_data + idx * box_size,
+                                               bbox_data + order[k] * box_size,
+                                               box_size,
+                                               normalized);
+      keep = overlap <= adaptive_threshold;
     }
     if (keep) {
-      selected_indices->push_back(idx);
+      order[kept++] = idx;
     }
-    sorted_indices.erase(sorted_indices.begin());
     if (keep && eta < 1 && adaptive_threshold > 0.5) {
       adaptive_threshold *= eta;
     }
   }
+  selected_indices->resize(kept);
 }
 
 template <typename T>
@@ -139,37 +131,46 @@ void MultiClassNMS(const operators::MulticlassNmsParam& param,
 
   int num_det = 0;
 
-  int64_t class_num = scores_size == 3 ? scores.dims()[0] : scores.dims()[1];
-  Tensor bbox_slice, score_slice;
-  for (int64_t c = 0; c < class_num; ++c) {
-    if (c == background_label) continue;
-    if (scores_size == 3) {
-      score_slice = scores.Slice<T>(c, c + 1);
-      bbox_slice = bboxes;
-    } else {
-      score_slice.Resize({scores.dims()[0], 1});
-      bbox_slice.Resize({scores.dims()[0], 4});
-      SliceOneClass<T>(scores, c, &score_slice);
-      SliceOneClass<T>(bboxes, c, &bbox_slice);
-    }
-    NMSFast(bbox_slice,
-            score_slice,
-            score_threshold,
-            nms_threshold,
-            nms_eta,
-            nms_top_k,
-            &((*indices)[c]),
-            normalized);
-    if (scores_size == 2) {
-      std::stable_sort((*indices)[c].begin(), (*indices)[c].end());
+  // The classes are independent, run them on the threads.
+  int class_num = scores_size == 3 ? scores.dims()[0] : scores.dims()[1];
+  std::vector<std::vector<int>> class_indices(class_num);
+  LITE_PARALLEL_BEGIN(c, tid, class_num) {
+    if (c != background_label) {
+      Tensor bbox_slice, score_slice;
+      if (scores_size == 3) {
+        score_slice = scores.Slice<T>(c, c + 1);
+        bbox_slice = bboxes;
+      } else {
+        score_slice.Resize({scores.dims()[0], 1});
+        bbox_slice.Resize({scores.dims()[0], 4});
+        SliceOneClass<T>(scores, c, &score_slice);
+        SliceOneClass<T>(bboxes, c, &bbox_slice);
+      }
+      NMSFast(bbox_slice,
+              score_slice,
+              score_threshold,
+              nms_threshold,
+              nms_eta,
+              nms_top_k,
+              &class_indices[c],
+              normalized);
+      if (scores_size == 2) {
+        std::sort(class_indices[c].begin(), class_indices[c].end());
+      }
     }
-    num_det += (*indices)[c].size();
+  }
+  LITE_PARALLEL_END();
+  for (int c = 0; c < class_num; ++c) {
+    if (c == background_label) continue;
+    num_det += class_indices[c].size();
+    (*indices)[c].swap(class_indices[c]);
   }
 
   *num_nmsed_out = num_det;
   const T* scores_data = scores.data<T>();
   if (keep_top_k > -1 && num_det > keep_top_k) {
     const T* sdata;
+    Tensor score_slice;
     std::vector<std::pair<T, std::pair<int, int>>> score_index_pairs;
     for (const auto& it : *indices) {
       int label = it.first;
@@ -187,18 +188,19 @@ void MultiClassNMS(const operators::MulticlassNmsParam& param,
             std::make_pair(sdata[idx], std::make_pair(label, idx)));
       }
     }
-    // Keep top k results per image.
-    std::stable_sort(
-        score_index_pairs.begin(),
-        score_index_pairs.end(),
-        lite::host::math::SortScorePairDescend<std::pair<int, int>>);
-    score_index_pairs.resize(keep_top_k);
+    // Keep top k results per image, the ties in the order of the classes.
+    std::vector<std::pair<T, int>> ranks(score_index_pairs.size());
+    for (size_t j = 0; j < ranks.size(); ++j) {
+      ranks[j] = std::make_pair(score_index_pairs[j].first, j);
+    }
+    lite::host::math::sort_topk_pairs(
+        ranks.data(), ranks.size(), keep_top_k, true);
 
     // Store the new indices.
     std::map<int, std::vector<int>> new_indices;
-    for (size_t j = 0; j < score_index_pairs.size(); ++j) {
-      int label = score_index_pairs[j].second.first;
-      int idx = score_index_pairs[j].second.second;
+    for (int64_t j = 0; j < keep_top_k; ++j) {
+      int label = score_index_pairs[ranks[j].second].second.first;
+      int idx = score_index_pairs[ranks[j].second].second.second;
       new_indices[label].push_back(idx);
     }
     if (scores_size == 2) {
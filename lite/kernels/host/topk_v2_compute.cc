@@ -13,16 +13,12 @@
 // limitations under the License.
 
 #include "lite/kernels/host/topk_v2_compute.h"
-#include <utility>
-#include <vector>
+#include "lite/backends/host/math/topk.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace host {
-bool comp_func(std::pair<float, int> a, std::pair<float, int> b) {
-  return (a.first > b.first);
-}
 
 void TopkV2Compute::Run() {
   auto& param = Param<operators::TopkParam>();
@@ -42,33 +38,8 @@ void TopkV2Compute::Run() {
   int outer_size = x_dims.count(0, axis);
   int axis_size = x_dims[axis];
   int inner_size = x_dims.count(axis + 1, dim_size);
-  int sum_size = axis_size * inner_size;
-  int out_sum_size = k * inner_size;
-
-  for (int i = 0; i < outer_size; i++) {
-    for (int tmp_j = 0; tmp_j < inner_size; tmp_j++) {
-      // we need sort outer_size * inner_size times
-      // and every times we need sort `axis_size` float
-
-      // we should start from here and pick
-      // `axis_size` float strided by inner_size
-      int glb_in_off = i * sum_size + tmp_j;
-      std::vector<std::pair<float, int>> vec;
-      for (int j = 0; j < axis_size; j++) {
-        vec.push_back(std::make_pair(x_data[glb_in_off + j * inner_size], j));
-      }
-      std::partial_sort(vec.begin(), vec.begin() + k, vec.end(), comp_func);
-
-      // we should start from here and put
-      // `k` float from here  strided by inner_size
-      int glb_out_off = i * out_sum_size + tmp_j;
-
-      for (int j = 0; j < k; j++) {
-        out_val[glb_out_off + j * inner_size] = vec[j].first;
-        out_ind[glb_out_off + j * inner_size] = vec[j].second;
-      }
-    }
-  }
+  lite::host::math::topk_axis(
+      x_data, outer_size, axis_size, inner_size, k, true, out_val, out_ind);
 }
 
 }  // namespace host
@@ -13,32 +13,39 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/conv_compute.h"
+#include <memory>
+#include <string>
 #include <utility>
+#include "lite/backends/x86/math/conv_winograd_fp32.h"
 #include "lite/backends/x86/math/fill_bias_activate.h"
+#include "lite/backends/x86/math/gemm_bf16.h"
+#include "lite/backends/x86/math/packed_weight.h"
+#include "lite/core/workspace.h"
 #include "lite/kernels/x86/conv_depthwise.h"
 #include "lite/kernels/x86/conv_direct.h"
+#include "lite/kernels/x86/conv_winograd.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace x86 {
-#define INIT_PARAM                      \
-  auto& param = this->Param<param_t>(); \
-  auto x_dims = param.x->dims();        \
-  auto w_dims = param.filter->dims();   \
-  auto o_dims = param.output->dims();   \
-  int win = x_dims[3];                  \
-  int hin = x_dims[2];                  \
-  int chin = x_dims[1];                 \
-  int num = x_dims[0];                  \
-  int wout = o_dims[3];                 \
-  int hout = o_dims[2];                 \
-  int chout = o_dims[1];                \
-  int kw = w_dims[3];                   \
-  int kh = w_dims[2];                   \
-  int group = param.groups;             \
-  int m = chout / group;                \
-  int n = hout * wout;                  \
+#define INIT_PARAM                           \
+  auto& param = this->Param<param_t>();      \
+  const auto& x_dims = param.x->dims();      \
+  const auto& w_dims = param.filter->dims(); \
+  const auto& o_dims = param.output->dims(); \
+  int win = x_dims[3];                       \
+  int hin = x_dims[2];                       \
+  int chin = x_dims[1];                      \
+  int num = x_dims[0];                       \
+  int wout = o_dims[3];                      \
+  int hout = o_dims[2];                      \
+  int chout = o_dims[1];                     \
+  int kw = w_dims[3];                        \
+  int kh = w_dims[2];                        \
+  int group = param.groups;                  \
+  int m = chout / group;                     \
+  int n = hout * wout;                       \
   int k = chin * kw * kh / group;
 
 #define PREPARE_PARAM                                                         \
@@ -107,9 +114,22 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
     VLOG(3) << "invoking conv_depthwise_3x3p0p1 or conv_depthwise_5x5";
   }
 
+  // 3x3s1 of enough channels and pixels by winograd
+  if (!impl_ && groups == 1 && kernel_h == 3 && kernel_w == 3 &&
+      stride_h == 1 && stride_w == 1 && nodilations) {
+    auto o_dims = param.output->dims();
+    int out_tile = lite::x86::math::conv_winograd_fp32_out_tile(
+        input_channel, output_channel, o_dims[2], o_dims[3]);
+    if (out_tile) {
+      impl_ = new WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>(out_tile);
+      VLOG(3) << "invoking conv_winograd_fp32 F(" << out_tile << "x"
+              << out_tile << ", 3x3)";
+    }
+  }
+
   // support 3x3s1p01,5x5s1p01,7x7s1p01
   //  3x3s2p012,5x5s1p012,7x7s1p012
-  if (output_channel % 8 == 0 && groups == 1 &&
+  if (!impl_ && output_channel % 8 == 0 && groups == 1 &&
       (kernel_h == 3 || kernel_h == 5 || kernel_h == 7) &&
       (stride_h == 2 || stride_h == 1) && nodilations && kps_equal &&
       pad_all_equal && flag_p) {
@@ -120,6 +140,23 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
 #endif
   }
 
+  // im2col buffer and the packed panels of the gemm, taken from the
+  // workspace in Run()
+  if (!impl_) {
+    const auto& o_dims = param.output->dims();
+    const int n = o_dims[2] * o_dims[3];
+    const int k = input_channel * kernel_h * kernel_w / groups;
+    size_t workspace_size = 0;
+    if (!flag_1x1gemm_) {
+      workspace_size += k * groups * n * sizeof(float) + WorkSpace::kAlignment;
+    }
+#ifndef PADDLE_WITH_MKLML
+    const int m = output_channel / groups;
+    workspace_size += lite::x86::math::gemm_fp32_workspace_size(m, n, k);
+#endif
+    WorkSpace::Global_X86().Reserve(workspace_size);
+  }
+
   if (impl_) {
     impl_->SetContext(std::move(this->ctx_));
     impl_->SetParam(param);
@@ -141,8 +178,8 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   unsigned int group_size_coldata = n * k;
   unsigned int channel_in_size = chin * hin * win;
   unsigned int channel_out_size = chout * hout * wout;
-  auto paddings = *param.paddings;
-  auto dilations = *param.dilations;
+  const auto& paddings = *param.paddings;
+  const auto& dilations = *param.dilations;
 
   auto din = param.x->data<float>();
   auto dout = param.output->mutable_data<float>();
@@ -154,8 +191,7 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
 
   if (!flag_1x1gemm_) {
     size_t col_size = group_size_coldata * group;
-    size_t col_data_size = static_cast<size_t>(col_size * sizeof(float));
-    col_data = static_cast<float*>(TargetMalloc(TARGET(kX86), col_data_size));
+    col_data = WorkSpace::Global_X86().Alloc<float>(col_size);
   }
   auto act_param = param.activation_param;
   paddle::lite::x86::math::Blas<lite::TargetType::kX86> matmul(ctx);
@@ -209,7 +245,6 @@ void Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
     lite::x86::math::fill_bias_act(
         dout_batch, bias_ptr, chout, wout * hout, flag_bias, &act_param);
   }
-  if (!flag_1x1gemm_) TargetFree(TARGET(kX86), col_data);
 }
 
 template <>
@@ -286,6 +321,9 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kFloat)>::PrepareForRun() {
         relu_alpha);
     gemm_s8_ptr_float_.push_back(gemm);
   }
+  if (!flag_1x1gemm_) {
+    WorkSpace::Global_X86().Reserve(groups * n * k * sizeof(int8_t));
+  }
 }
 
 template <>
@@ -300,13 +338,12 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
   auto din = param.x->data<int8_t>();
   auto dout = param.output->mutable_data<float>();
   auto weights = param.filter->data<int8_t>();
-  auto paddings = *param.paddings;
-  auto dilations = *param.dilations;
+  const auto& paddings = *param.paddings;
+  const auto& dilations = *param.dilations;
 
   if (!flag_1x1gemm_) {
     int col_size = group * group_size_coldata;
-    col_data = static_cast<int8_t*>(
-        TargetMalloc(TARGET(kX86), col_size * sizeof(int8_t)));
+    col_data = WorkSpace::Global_X86().Alloc<int8_t>(col_size);
   }
   for (int b = 0; b < num; ++b) {
     for (int g = 0; g < group; ++g) {
@@ -337,7 +374,6 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
       }
     }
   }
-  if (!flag_1x1gemm_) TargetFree(TARGET(kX86), col_data);
 }
 
 template <>
@@ -417,6 +453,9 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kInt8)>::PrepareForRun() {
         relu_alpha);
     gemm_s8_ptr_int8_.push_back(gemm);
   }
+  if (!flag_1x1gemm_) {
+    WorkSpace::Global_X86().Reserve(groups * n * k * sizeof(int8_t));
+  }
 }
 
 template <>
@@ -431,13 +470,12 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
   auto din = param.x->data<int8_t>();
   auto dout = param.output->mutable_data<int8_t>();
   auto weights = param.filter->data<int8_t>();
-  auto paddings = *param.paddings;
-  auto dilations = *param.dilations;
+  const auto& paddings = *param.paddings;
+  const auto& dilations = *param.dilations;
 
   if (!flag_1x1gemm_) {
     int col_size = group * group_size_coldata;
-    col_data = static_cast<int8_t*>(
-        TargetMalloc(TARGET(kX86), col_size * sizeof(int8_t)));
+    col_data = WorkSpace::Global_X86().Alloc<int8_t>(col_size);
   }
   for (int b = 0; b < num; ++b) {
     for (int g = 0; g < group; ++g) {
@@ -468,7 +506,126 @@ void Conv2dCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
       }
     }
   }
-  if (!flag_1x1gemm_) TargetFree(TARGET(kX86), col_data);
+}
+
+// The filter is rounded to bf16 and packed once, the input and the output
+// stay float.
+template <>
+void Conv2dCompute<PRECISION(kBF16), PRECISION(kFloat)>::PrepareForRun() {
+  INIT_PARAM
+  const auto& paddings = *param.paddings;
+  const auto& dilations = *param.dilations;
+  flag_1x1gemm_ = !IsExpand(w_dims.Vectorize(),
+                            param.strides,
+                            {paddings[0], paddings[2]},
+                            dilations) &&
+                  paddings[1] == 0 && paddings[3] == 0;
+  const int64_t group_size_packed =
+      lite::x86::math::gemm_bf16_packed_A_size(m, k);
+  auto pack = [&](Tensor* packed_filter) {
+    packed_filter->Resize({group_size_packed * group});
+    bfloat16* packed = packed_filter->mutable_data<bfloat16>();
+    for (int g = 0; g < group; g++) {
+      if (param.filter->precision() == PRECISION(kBF16)) {
+        lite::x86::math::gemm_bf16_pack_A(
+            false,
+            m,
+            k,
+            param.filter->data<bfloat16>() + g * m * k,
+            k,
+            packed + g * group_size_packed);
+      } else {
+        lite::x86::math::gemm_bf16_pack_A(
+            false,
+            m,
+            k,
+            param.filter->data<float>() + g * m * k,
+            k,
+            packed + g * group_size_packed);
+      }
+    }
+  };
+  if (param.filter->persistable()) {
+    std::string layout = "bf16_A," + std::to_string(m) + "," +
+                         std::to_string(k) + "," + std::to_string(group);
+    packed_filter_bf16_ = lite::x86::math::SharePackedWeight(
+        param.filter->raw_data(), layout, pack);
+  } else {
+    std::shared_ptr<Tensor> packed_filter(new Tensor);
+    pack(packed_filter.get());
+    packed_filter_bf16_ = packed_filter;
+  }
+  // im2col buffer and the packed input of a group, taken in Run()
+  size_t workspace_size =
+      lite::x86::math::gemm_bf16_packed_B_size(k, n) * sizeof(bfloat16);
+  if (!flag_1x1gemm_) {
+    workspace_size += k * group * n * sizeof(float) + WorkSpace::kAlignment;
+  }
+  WorkSpace::Global_X86().Reserve(workspace_size);
+}
+
+template <>
+void Conv2dCompute<PRECISION(kBF16), PRECISION(kFloat)>::Run() {
+  INIT_PARAM
+  bool flag_bias = (param.bias != nullptr);
+  const int64_t group_size_packed =
+      lite::x86::math::gemm_bf16_packed_A_size(m, k);
+  unsigned int group_size_out = m * n;
+  unsigned int group_size_coldata = n * k;
+  unsigned int channel_in_size = chin * hin * win;
+  unsigned int channel_out_size = chout * hout * wout;
+  const auto& paddings = *param.paddings;
+  const auto& dilations = *param.dilations;
+
+  auto din = param.x->data<float>();
+  auto dout = param.output->mutable_data<float>();
+  const bfloat16* weights = packed_filter_bf16_->data<bfloat16>();
+  const float* bias_ptr = flag_bias ? param.bias->data<float>() : nullptr;
+  auto& workspace = WorkSpace::Global_X86();
+  size_t workspace_mark = workspace.cursor();
+  float* col_data = nullptr;
+  if (!flag_1x1gemm_) {
+    col_data = workspace.Alloc<float>(group_size_coldata * group);
+  }
+  auto act_param = param.activation_param;
+  for (int i = 0; i < num; i++) {
+    const float* din_batch = din + i * channel_in_size;
+    float* dout_batch = dout + i * channel_out_size;
+    const float* din_data = din_batch;
+    if (!flag_1x1gemm_) {
+      lite::x86::math::im2col<float>(din_batch,
+                                     chin,
+                                     hin,
+                                     win,
+                                     w_dims[2],
+                                     w_dims[3],
+                                     paddings[0],
+                                     paddings[1],
+                                     paddings[2],
+                                     paddings[3],
+                                     param.strides[0],
+                                     param.strides[1],
+                                     dilations[0],
+                                     dilations[1],
+                                     col_data);
+      din_data = static_cast<const float*>(col_data);
+    }
+    for (int g = 0; g < group; g++) {
+      lite::x86::math::gemm_bf16_prepacked_A(m,
+                                             n,
+                                             k,
+                                             weights + g * group_size_packed,
+                                             false,
+                                             din_data + g * group_size_coldata,
+                                             n,
+                                             dout_batch + g * group_size_out,
+                                             n);
+    }
+    //! bias and activate
+    lite::x86::math::fill_bias_act(
+        dout_batch, bias_ptr, chout, wout * hout, flag_bias, &act_param);
+  }
+  workspace.Rewind(workspace_mark);
 }
 
 #undef PREPARE_PARAM
@@ -488,6 +645,9 @@ typedef paddle::lite::kernels::x86::Conv2dCompute<PRECISION(kInt8),
 typedef paddle::lite::kernels::x86::Conv2dCompute<PRECISION(kInt8),
                                                   PRECISION(kInt8)>
     ConvInt8_Int8;
+typedef paddle::lite::kernels::x86::Conv2dCompute<PRECISION(kBF16),
+                                                  PRECISION(kFloat)>
+    ConvBf16;
 
 REGISTER_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW, ConvFp32, def)
     .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
@@ -551,3 +711,12 @@ REGISTER_LITE_KERNEL(
                 {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kFloat))})
     .BindPaddleOpVersion("depthwise_conv2d", 1)
     .Finalize();
+
+REGISTER_LITE_KERNEL(conv2d, kX86, kBF16, kNCHW, ConvBf16, def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Filter",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kBF16))})
+    .BindOutput("Output", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindPaddleOpVersion("conv2d", 1)
+    .Finalize();
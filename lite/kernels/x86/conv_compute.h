@@ -84,7 +84,9 @@ class Conv2dCompute : public KernelLite<TARGET(kX86), Ptype> {
   bool flag_1x1gemm_{false};
   bool flag_trans_bias_{true};
   std::vector<float> w_scale_;
-  Tensor weights_;
+  // The filter of every group packed for gemm_bf16 by the bf16 kernel,
+  // shared with the kernels of the cloned predictors.
+  std::shared_ptr<const Tensor> packed_filter_bf16_;
   Tensor bias_;
   std::vector<lite::x86::math::generate_gemm_s8u8_x86_kern<float>*>
       gemm_s8_ptr_float_{};
@@ -14,12 +14,20 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <thread>  // NOLINT
 #include <utility>
 #include <vector>
 
+#include "lite/backends/x86/math/conv_winograd_fp32.h"
 #include "lite/core/op_registry.h"
 #include "lite/kernels/x86/conv_compute.h"
+#include "lite/kernels/x86/conv_winograd.h"
+#include "lite/tests/utils/count_new.h"
+#include "lite/tests/utils/fill_data.h"
+#include "lite/utils/bfloat16.h"
 
 namespace paddle {
 namespace lite {
@@ -92,9 +100,273 @@ TEST(conv2d_x86, run_test) {
   }
 }
 
+TEST(conv2d_x86, run_without_heap_allocation) {
+  lite::Tensor x, filter, out;
+  x.Resize(lite::DDim(std::vector<int64_t>({1, 4, 8, 8})));
+  filter.Resize(lite::DDim(std::vector<int64_t>({2, 4, 3, 3})));
+  out.Resize(lite::DDim(std::vector<int64_t>({1, 2, 8, 8})));
+  auto x_data = x.mutable_data<float>();
+  auto filter_data = filter.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    x_data[i] = 1.f;
+  }
+  for (int64_t i = 0; i < filter.numel(); i++) {
+    filter_data[i] = 1.f;
+  }
+
+  Conv2dCompute<PRECISION(kFloat), PRECISION(kFloat)> conv2d;
+  operators::ConvParam param;
+  param.x = &x;
+  param.filter = &filter;
+  param.output = &out;
+  param.strides = {1, 1};
+  param.groups = 1;
+  param.paddings =
+      std::make_shared<std::vector<int>>(std::vector<int>({1, 1, 1, 1}));
+  param.dilations = std::make_shared<std::vector<int>>(std::vector<int>({1, 1}));
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  conv2d.SetContext(std::move(ctx));
+  conv2d.SetParam(param);
+
+  // The im2col buffer and the packed panels of the gemm are reserved in
+  // PrepareForRun, the steady-state runs must not ask the heap for memory.
+  const size_t im2col_size = 4 * 3 * 3 * 8 * 8 * sizeof(float);
+  auto& workspace = WorkSpace::Global_X86();
+  int64_t heap_alloc_count = workspace.heap_alloc_count();
+  conv2d.Launch();
+  EXPECT_GE(workspace.high_water(), im2col_size);
+  EXPECT_LE(workspace.heap_alloc_count(), heap_alloc_count + 1);
+  heap_alloc_count = workspace.heap_alloc_count();
+  {
+    NewCounter counter;
+    for (int i = 0; i < 3; i++) {
+      conv2d.Launch();
+    }
+    EXPECT_EQ(counter.count(), 0);
+  }
+  EXPECT_EQ(workspace.heap_alloc_count(), heap_alloc_count);
+
+  // Another thread running the kernel in a program grows its workspace once,
+  // to the mark of the last run, and then runs without allocations too.
+  const size_t mark = workspace.high_water();
+  std::thread([&]() {
+    auto& thread_workspace = WorkSpace::Global_X86();
+    size_t outer_peak = thread_workspace.BeginRun(mark);
+    EXPECT_EQ(thread_workspace.heap_alloc_count(), 1);
+    NewCounter counter;
+    for (int i = 0; i < 3; i++) {
+      conv2d.Launch();
+    }
+    EXPECT_EQ(counter.count(), 0);
+    EXPECT_EQ(thread_workspace.heap_alloc_count(), 1);
+    EXPECT_LE(thread_workspace.EndRun(outer_peak), mark);
+  }).join();
+  // the center pixel sees the full 3x3 window of all the 4 channels
+  EXPECT_NEAR(out.data<float>()[3 * 8 + 3], 36.f, 1e-5);
+}
+
+// out = conv3x3s1(x, filter) + bias, then relu if `relu`
+static void conv3x3s1_ref(const lite::Tensor& x,
+                          const lite::Tensor& filter,
+                          const float* bias,
+                          int pad_top,
+                          int pad_left,
+                          bool relu,
+                          lite::Tensor* out) {
+  const int num = x.dims()[0];
+  const int ic = x.dims()[1];
+  const int ih = x.dims()[2];
+  const int iw = x.dims()[3];
+  const int oc = out->dims()[1];
+  const int oh = out->dims()[2];
+  const int ow = out->dims()[3];
+  const float* in = x.data<float>();
+  const float* w = filter.data<float>();
+  float* dout = out->mutable_data<float>();
+  for (int n = 0; n < num; ++n) {
+    for (int o = 0; o < oc; ++o) {
+      for (int y = 0; y < oh; ++y) {
+        for (int z = 0; z < ow; ++z) {
+          float sum = bias ? bias[o] : 0.f;
+          for (int i = 0; i < ic; ++i) {
+            for (int ky = 0; ky < 3; ++ky) {
+              const int iy = y + ky - pad_top;
+              if (iy < 0 || iy >= ih) continue;
+              for (int kx = 0; kx < 3; ++kx) {
+                const int ix = z + kx - pad_left;
+                if (ix < 0 || ix >= iw) continue;
+                sum += in[((n * ic + i) * ih + iy) * iw + ix] *
+                       w[((o * ic + i) * 3 + ky) * 3 + kx];
+              }
+            }
+          }
+          dout[((n * oc + o) * oh + y) * ow + z] =
+              relu ? std::max(sum, 0.f) : sum;
+        }
+      }
+    }
+  }
+}
+
+TEST(conv2d_x86, winograd) {
+  if (!lite::x86::math::conv_winograd_fp32_out_tile(64, 64, 56, 56)) {
+    LOG(INFO) << "winograd is not supported on this cpu, skip";
+    return;
+  }
+  // num, ic, oc, ih, iw, paddings (top, bottom, left, right)
+  const std::vector<std::vector<int>> shapes{{1, 16, 16, 8, 8, 1, 1, 1, 1},
+                                             {2, 19, 21, 13, 11, 1, 1, 1, 1},
+                                             {1, 24, 16, 9, 15, 0, 0, 0, 0},
+                                             {1, 32, 40, 20, 17, 2, 1, 0, 2}};
+  for (auto& shape : shapes) {
+    const int ih = shape[3];
+    const int iw = shape[4];
+    const int oh = ih + shape[5] + shape[6] - 2;
+    const int ow = iw + shape[7] + shape[8] - 2;
+    lite::Tensor x, filter, bias, out, ref;
+    x.Resize({shape[0], shape[1], ih, iw});
+    filter.Resize({shape[2], shape[1], 3, 3});
+    bias.Resize({shape[2]});
+    out.Resize({shape[0], shape[2], oh, ow});
+    ref.Resize({shape[0], shape[2], oh, ow});
+    float* x_data = x.mutable_data<float>();
+    float* filter_data = filter.mutable_data<float>();
+    float* bias_data = bias.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); i++) {
+      x_data[i] = static_cast<float>((i * 7) % 19) / 9.f - 1.f;
+    }
+    for (int64_t i = 0; i < filter.numel(); i++) {
+      filter_data[i] = static_cast<float>((i * 5) % 23) / 11.f - 1.f;
+    }
+    for (int64_t i = 0; i < bias.numel(); i++) {
+      bias_data[i] = static_cast<float>(i % 5) / 5.f;
+    }
+    conv3x3s1_ref(x, filter, bias_data, shape[5], shape[7], true, &ref);
+
+    for (int out_tile : {4, 6}) {
+      WinogradConv<PRECISION(kFloat), PRECISION(kFloat)> conv(out_tile);
+      operators::ConvParam param;
+      param.x = &x;
+      param.filter = &filter;
+      param.bias = &bias;
+      param.output = &out;
+      param.strides = {1, 1};
+      param.groups = 1;
+      param.paddings = std::make_shared<std::vector<int>>(
+          std::vector<int>(shape.begin() + 5, shape.end()));
+      param.dilations =
+          std::make_shared<std::vector<int>>(std::vector<int>({1, 1}));
+      param.activation_param.has_active = true;
+      param.activation_param.active_type = lite_api::ActivationType::kRelu;
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>();
+      conv.SetContext(std::move(ctx));
+      conv.SetParam(param);
+      conv.Launch();
+      // F(6x6) loses some more precision than F(4x4)
+      const float* out_data = out.data<float>();
+      const float* ref_data = ref.data<float>();
+      for (int64_t i = 0; i < out.numel(); i++) {
+        ASSERT_NEAR(out_data[i], ref_data[i], 1e-3 * (1 + fabs(ref_data[i])))
+            << "F(" << out_tile << "x" << out_tile << ") at " << i;
+      }
+    }
+  }
+}
+
+TEST(conv2d_x86, run_bf16) {
+  // A 3x3 conv padded by 1 in groups and a 1x1 conv, the products of the
+  // input and the filter rounded to bf16. The filter is float or converted
+  // to bf16 by the predictor.
+  const int batch = 2, chin = 4, chout = 6, h = 5, w = 6;
+  auto round_bf16 = [](float v) { return static_cast<float>(bfloat16(v)); };
+  for (int ksize : {3, 1}) {
+    for (int groups : {1, 2}) {
+      for (bool bf16_filter : {false, true}) {
+        const int pad = ksize / 2;
+        const int chin_g = chin / groups, chout_g = chout / groups;
+        lite::Tensor x, filter, bias, out;
+        x.Resize({batch, chin, h, w});
+        filter.Resize({chout, chin_g, ksize, ksize});
+        bias.Resize({chout});
+        out.Resize({batch, chout, h, w});
+        std::vector<float> filter_data(filter.numel());
+        fill_data_rand(x.mutable_data<float>(), -1.f, 1.f, x.numel());
+        fill_data_rand(filter_data.data(), -1.f, 1.f, filter.numel());
+        fill_data_rand(bias.mutable_data<float>(), -1.f, 1.f, chout);
+        if (bf16_filter) {
+          bfloat16* filter_bf16 = filter.mutable_data<bfloat16>();
+          for (size_t i = 0; i < filter_data.size(); i++) {
+            filter_bf16[i] = bfloat16(filter_data[i]);
+          }
+        } else {
+          std::copy(filter_data.begin(),
+                    filter_data.end(),
+                    filter.mutable_data<float>());
+        }
+        filter.set_persistable(true);
+
+        Conv2dCompute<PRECISION(kBF16), PRECISION(kFloat)> conv2d;
+        operators::ConvParam param;
+        param.x = &x;
+        param.filter = &filter;
+        param.bias = &bias;
+        param.output = &out;
+        param.strides = {1, 1};
+        param.groups = groups;
+        param.paddings = std::make_shared<std::vector<int>>(
+            std::vector<int>({pad, pad, pad, pad}));
+        param.dilations =
+            std::make_shared<std::vector<int>>(std::vector<int>({1, 1}));
+        std::unique_ptr<KernelContext> ctx(new KernelContext);
+        ctx->As<X86Context>();
+        conv2d.SetContext(std::move(ctx));
+        conv2d.SetParam(param);
+        conv2d.PrepareForRun();
+        conv2d.Run();
+
+        const float* x_data = x.data<float>();
+        const float* bias_data = bias.data<float>();
+        const float* out_data = out.data<float>();
+        for (int b = 0; b < batch; b++) {
+          for (int oc = 0; oc < chout; oc++) {
+            const int g = oc / chout_g;
+            for (int oh = 0; oh < h; oh++) {
+              for (int ow = 0; ow < w; ow++) {
+                float ref = bias_data[oc];
+                for (int ic = 0; ic < chin_g; ic++) {
+                  for (int kh = 0; kh < ksize; kh++) {
+                    for (int kw = 0; kw < ksize; kw++) {
+                      const int ih = oh + kh - pad, iw = ow + kw - pad;
+                      if (ih < 0 || ih >= h || iw < 0 || iw >= w) continue;
+                      const int c = g * chin_g + ic;
+                      const int x_index = ((b * chin + c) * h + ih) * w + iw;
+                      const int filter_index =
+                          ((oc * chin_g + ic) * ksize + kh) * ksize + kw;
+                      ref += round_bf16(x_data[x_index]) *
+                             round_bf16(filter_data[filter_index]);
+                    }
+                  }
+                }
+                EXPECT_NEAR(out_data[((b * chout + oc) * h + oh) * w + ow],
+                            ref,
+                            1e-4 * (std::fabs(ref) + 1))
+                    << "ksize: " << ksize << ", groups: " << groups
+                    << ", bf16 filter: " << bf16_filter;
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
 }  // namespace paddle
 
 USE_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(conv2d, kX86, kBF16, kNCHW, def);
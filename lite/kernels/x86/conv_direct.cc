@@ -47,8 +47,8 @@ void DirectConv<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   int oh = o_dims[2];
   int ow = o_dims[3];
 
-  float* trans_out = static_cast<float*>(
-      TargetMalloc(TARGET(kX86), sizeof(float) * bs * oc_expand_ * oh * ow));
+  float* trans_out =
+      WorkSpace::Global_X86().Alloc<float>(bs * oc_expand_ * oh * ow);
   memset(trans_out, 0, sizeof(float) * oc * oh * ow * bs);
 
   auto act_param = param.activation_param;
@@ -78,7 +78,6 @@ void DirectConv<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
                                              b_data,
                                              act_param.active_type,
                                              act_param);
-  TargetFree(TARGET(kX86), trans_out);
 }
 }  // namespace x86
 }  // namespace kernels
@@ -22,6 +22,7 @@
 #include "lite/core/context.h"
 #include "lite/core/kernel.h"
 #include "lite/core/target_wrapper.h"
+#include "lite/core/workspace.h"
 
 namespace paddle {
 namespace lite {
@@ -75,6 +76,9 @@ class DirectConv : public KernelLite<TARGET(kX86), Ptype> {
     code_->generate_code(
         ic, ih, iw, oc, oc_expand_, oh, ow, ph, pw, wh, ww, param.strides[1]);
     code_->ready();
+    // transposed output, taken from the workspace in Run()
+    WorkSpace::Global_X86().Reserve(sizeof(float) * x_dims[0] * oc_expand_ *
+                                    oh * ow);
   }
 
 #ifdef LITE_WITH_PROFILE
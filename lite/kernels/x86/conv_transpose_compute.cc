@@ -18,6 +18,7 @@
 #include "lite/backends/x86/math/fill_bias_activate.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/type_system.h"
+#include "lite/core/workspace.h"
 
 namespace paddle {
 namespace lite {
@@ -80,6 +81,9 @@ void Conv2DTransposeCompute<PRECISION(kFloat),
   bool no_dilation = (dilations[0] == 1) && (dilations[1] == 1);
   depthwise_ =
       (param.groups == chin && chin == chout && ks_equal && no_dilation);
+  if (!depthwise_) {
+    WorkSpace::Global_X86().Reserve(workspace_size_);
+  }
   is_first_epoch_ = false;
 }
 
@@ -115,10 +119,9 @@ void Conv2DTransposeCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
                 : nullptr;
   float* col_data = nullptr;
 
-  if (!flag_1x1s1p1) {
+  if (!flag_1x1s1p1 && !depthwise_s1 && !depthwise_s2) {
     int col_size = param.groups * group_size_coldata;
-    col_data = static_cast<float*>(
-        TargetMalloc(TARGET(kX86), col_size * sizeof(float)));
+    col_data = WorkSpace::Global_X86().Alloc<float>(col_size);
   }
 
   for (int i = 0; i < num; i++) {
@@ -174,7 +177,6 @@ void Conv2DTransposeCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
     lite::x86::math::fill_bias_act(
         dout_batch, bias_ptr, chout, wout * hout, flag_bias, &act_param);
   }
-  if (!flag_1x1s1p1) TargetFree(TARGET(kX86), col_data);
 }
 
 }  // namespace x86
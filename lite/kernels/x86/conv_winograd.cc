@@ -0,0 +1,90 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/conv_winograd.h"
+#include "lite/backends/x86/math/conv_winograd_fp32.h"
+#include "lite/backends/x86/math/fill_bias_activate.h"
+#include "lite/core/workspace.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <>
+void WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
+  auto& param = this->Param<param_t>();
+  const int oc = param.filter->dims()[0];
+  const int ic = param.filter->dims()[1];
+  weights_.Resize(
+      {lite::x86::math::conv_winograd_fp32_weights_size(out_tile_, ic, oc)});
+  lite::x86::math::conv_winograd_fp32_trans_weights(
+      param.filter->data<float>(),
+      ic,
+      oc,
+      out_tile_,
+      weights_.mutable_data<float>());
+}
+
+template <>
+void WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>::ReInitWhenNeeded() {
+  auto& param = this->Param<param_t>();
+  auto o_dims = param.output->dims();
+  // the transformed tiles, taken from the workspace in Run()
+  WorkSpace::Global_X86().Reserve(
+      lite::x86::math::conv_winograd_fp32_workspace_size(out_tile_,
+                                                         param.x->dims()[1],
+                                                         o_dims[1],
+                                                         o_dims[2],
+                                                         o_dims[3]));
+}
+
+template <>
+void WinogradConv<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
+  auto& param = this->Param<param_t>();
+  auto x_dims = param.x->dims();
+  auto o_dims = param.output->dims();
+  const float* bias = param.bias ? param.bias->data<float>() : nullptr;
+  float* dout = param.output->mutable_data<float>();
+
+  lite::x86::math::conv_winograd_fp32(param.x->data<float>(),
+                                      dout,
+                                      x_dims[0],
+                                      x_dims[1],
+                                      x_dims[2],
+                                      x_dims[3],
+                                      o_dims[1],
+                                      o_dims[2],
+                                      o_dims[3],
+                                      (*param.paddings)[0],
+                                      (*param.paddings)[2],
+                                      out_tile_,
+                                      weights_.data<float>(),
+                                      bias);
+  //! the bias is added by the output transform
+  auto act_param = param.activation_param;
+  if (act_param.has_active) {
+    lite::x86::math::fill_bias_act(dout,
+                                   nullptr,
+                                   o_dims[0] * o_dims[1],
+                                   o_dims[2] * o_dims[3],
+                                   false,
+                                   &act_param);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
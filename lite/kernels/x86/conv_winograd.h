@@ -0,0 +1,55 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include "lite/core/kernel.h"
+#include "lite/operators/conv_op.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// 3x3 stride 1 convolution by Winograd F(4x4, 3x3) or F(6x6, 3x3), the tile
+// being picked by conv_winograd_fp32_out_tile, see conv_winograd_fp32.h.
+template <PrecisionType Ptype, PrecisionType OutType>
+class WinogradConv : public KernelLite<TARGET(kX86), Ptype> {
+ public:
+  explicit WinogradConv(int out_tile) : out_tile_(out_tile) {}
+
+  virtual void PrepareForRun();
+  virtual void ReInitWhenNeeded();
+  virtual void Run();
+
+#ifdef LITE_WITH_PROFILE
+  virtual void SetProfileRuntimeKernelInfo(
+      paddle::lite::profile::OpCharacter* ch) {
+    ch->kernel_func_name = kernel_func_name_;
+  }
+
+  std::string kernel_func_name_{"conv_winograd_fp32"};
+#endif
+
+ private:
+  using param_t = operators::ConvParam;
+  int out_tile_;
+  Tensor weights_;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
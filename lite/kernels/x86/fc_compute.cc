@@ -14,43 +14,13 @@
 
 #include "lite/kernels/x86/fc_compute.h"
 #include "lite/backends/x86/math/gemm_s8u8_compute.h"
-#include "lite/backends/x86/math/saturate.h"
+#include "lite/core/workspace.h"
 
 namespace paddle {
 namespace lite {
 namespace kernels {
 namespace x86 {
 
-#define GEMM_OUT_INT8                                                     \
-  lite::x86::math::generate_gemm_s8u8_x86_kern<int8_t> gemm(false,        \
-                                                            false,        \
-                                                            m,            \
-                                                            n,            \
-                                                            k,            \
-                                                            i_data,       \
-                                                            n,            \
-                                                            w_scale,      \
-                                                            input_scale,  \
-                                                            output_scale, \
-                                                            b_data,       \
-                                                            relu_type,    \
-                                                            1.f);
-
-#define GEMM_OUT_FLOAT                                                   \
-  lite::x86::math::generate_gemm_s8u8_x86_kern<float> gemm(false,        \
-                                                           false,        \
-                                                           m,            \
-                                                           n,            \
-                                                           k,            \
-                                                           i_data,       \
-                                                           n,            \
-                                                           w_scale,      \
-                                                           input_scale,  \
-                                                           output_scale, \
-                                                           b_data,       \
-                                                           relu_type,    \
-                                                           1.f);
-
 template <lite::TargetType Target, typename T>
 class FCFunctor {
  public:
@@ -63,7 +33,8 @@ class FCFunctor {
                   T* Y,
                   const T* B = nullptr,
                   bool relu = false,
-                  bool padding_weights = false) {
+                  bool padding_weights = false,
+                  const lite::x86::math::PackedGemmWeight* packed_W = nullptr) {
     auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
     T* Y1_data = nullptr;
 
@@ -81,6 +52,16 @@ class FCFunctor {
       }
     };
 
+    // The packed weights skip the padding, X and Y are not copied.
+    if (packed_W) {
+      packed_W->Compute(false, M, X, K, static_cast<T>(0.0), Y, N);
+      if (!B) {
+        return;
+      }
+      parallel_compute(0, M);
+      return;
+    }
+
     // Because of the overhead of memcpy, we only do padding for GEMM
     //  when weights is already padded in fc_fuse_pass.
     if (padding_weights) {
@@ -139,6 +120,42 @@ class FCFunctor {
   }
 };
 
+// out = act(out + bias) of the M x N out, act being relu or none.
+void FcAddBiasRelu(const float* bias, bool relu, int M, int N, float* out) {
+  if (!bias && !relu) return;
+  for (int i = 0; i < M; ++i) {
+    float* row = out + i * N;
+    for (int j = 0; j < N; ++j) {
+      float v = bias ? row[j] + bias[j] : row[j];
+      row[j] = relu && v < 0.f ? 0.f : v;
+    }
+  }
+}
+
+template <>
+void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::PrepareForRun() {
+  auto& param = *param_.get_mutable<param_t>();
+  quantized_w_ =
+      lite::x86::math::quantized_gemm_weight(*param.w,
+                                             param.weight_quant_bits,
+                                             param.weight_quant_group_size,
+                                             param.weight_quant_scale);
+  if (quantized_w_.data) return;
+  const auto& w_dims = param.w->dims();
+  if (w_dims.size() != 2) return;
+  const int pad = param.padding_weights ? 4 : 0;
+  const int K = w_dims[0] - pad;
+  const int N = w_dims[1] - pad;
+  const int M = param.output->dims().production() / N;
+  if (param.sparse_weight && param.w->persistable() && pad == 0) {
+    sparse_w_ = lite::x86::math::SparseGemmWeight::Create(
+        param.w->data<float>(), K, N, N);
+    return;
+  }
+  packed_w_ = lite::x86::math::PackPersistableWeight(
+      *param.w, false, K, N, w_dims[1], 1.f, M);
+}
+
 template <>
 void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   auto& param = *param_.get_mutable<param_t>();
@@ -148,6 +165,33 @@ void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
   auto* output = param.output;
   bool with_relu = (param.activation_type == "relu") ? true : false;
 
+  if (quantized_w_.data) {
+    // The unpacked dims of w, see FcOpLite::AttachImpl.
+    const int K = param.w_dims[0];
+    const int N = param.w_dims[1];
+    const int M = output->dims().production() / N;
+    float* output_data = output->mutable_data<float>();
+    lite::x86::math::gemm_weight_only(
+        M, N, K, input->data<float>(), K, quantized_w_, output_data, N);
+    FcAddBiasRelu(
+        bias ? bias->data<float>() : nullptr, with_relu, M, N, output_data);
+    return;
+  }
+  if (sparse_w_) {
+    const int K = sparse_w_->K();
+    const int N = sparse_w_->N();
+    const int M = output->dims().production() / N;
+    float* output_data = output->mutable_data<float>();
+    sparse_w_->Compute(M,
+                       input->data<float>(),
+                       K,
+                       bias ? bias->data<float>() : nullptr,
+                       output_data,
+                       N);
+    FcAddBiasRelu(nullptr, with_relu, M, N, output_data);
+    return;
+  }
+
   bool padding_weights = param.padding_weights;
   const auto& w_dims = w->dims();
   auto w_dims0 = padding_weights ? w_dims[0] - 4 : w_dims[0];
@@ -170,106 +214,139 @@ void FcCompute<PRECISION(kFloat), PRECISION(kFloat)>::Run() {
      output_data,
      bias ? bias->template data<float>() : NULL,
      with_relu,
-     padding_weights);
+     padding_weights,
+     packed_w_.get());
 }
 
-template <>
-void FcCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
-  auto& param = this->Param<operators::FcParam>();
-  auto* i_data = param.input->data<int8_t>();
-  auto* o_data = param.output->mutable_data<int8_t>();
-  auto* w_data = param.w->data<int8_t>();
-  const float* b_data = param.bias ? param.bias->data<float>() : nullptr;
+// The weights are quantized per tensor or per output channel, a column of W.
+// The scales of the channels, the bias and relu or relu6 are fused into the
+// int8 gemm. packed_w is the persistable W packed once.
+template <typename T>
+void FcInt8Compute(const operators::FcParam& param,
+                   const Tensor* packed_w,
+                   T* o_data) {
   auto w_dims = param.w->dims();
   int k = w_dims[0];
   int n = w_dims[1];
   int m = param.output->dims().production() / n;
-  float input_scale = param.input_scale;
-  float output_scale = param.output_scale;
-  int relu_type = (param.activation_type == "relu") ? 1 : 0;
-  float* w_scale =
-      static_cast<float*>(TargetMalloc(TARGET(kX86), m * sizeof(float)));
-
-  if (param.activation_type != "" && param.activation_type != "relu")
-    LOG(FATAL) << "not support fuse activation except relu.";
-
-  if (param.weight_scale.size() == 1) {
-    for (int i = 0; i < m; i++) w_scale[i] = param.weight_scale[0];
-    GEMM_OUT_INT8;
-    gemm.compute(i_data, w_data, o_data);
-  } else if (param.weight_scale.size() == m) {
-    for (int i = 0; i < m; i++) w_scale[i] = param.weight_scale[i];
-    GEMM_OUT_INT8;
-    gemm.compute(i_data, w_data, o_data);
-  } else if (param.weight_scale.size() == n) {
-    for (int i = 0; i < m; i++) w_scale[i] = 1.f;
-    float* tmp_output =
-        static_cast<float*>(TargetMalloc(TARGET(kX86), m * n * sizeof(float)));
-    GEMM_OUT_FLOAT;
-    gemm.compute(i_data, w_data, tmp_output);
-    for (int nn = 0; nn < n; nn++) {
-      float tmp_scale = param.weight_scale[nn] / output_scale;
-      for (int mm = 0; mm < m; mm++) {
-        int offt = mm * n + nn;
-        o_data[offt] = lite::x86::math::saturate_cast<int8_t>(
-            roundf(tmp_output[offt] * tmp_scale));
-        o_data[offt] = o_data[offt] < -127 ? -127 : o_data[offt];
-      }
-    }
-    TargetFree(TARGET(kX86), tmp_output);
-  } else {
-    LOG(FATAL) << "weight scale size is not 1, N or M, not support yet.";
+  int relu_type = 0;
+  if (param.activation_type == "relu") {
+    relu_type = 1;
+  } else if (param.activation_type == "relu6") {
+    relu_type = 2;
+  } else if (param.activation_type != "") {
+    LOG(FATAL) << "not support fuse activation except relu and relu6.";
   }
-  TargetFree(TARGET(kX86), w_scale);
+
+  lite::x86::math::gemm_s8u8_quantized(
+      false,
+      false,
+      m,
+      n,
+      k,
+      1.f,
+      param.input->data<int8_t>(),
+      param.input_scale,
+      param.w->data<int8_t>(),
+      param.weight_scale,
+      param.output_scale,
+      param.bias ? param.bias->data<float>() : nullptr,
+      relu_type,
+      param.alpha,
+      o_data,
+      n,
+      packed_w ? packed_w->data<uint8_t>() : nullptr);
+}
+
+template <>
+void FcCompute<PRECISION(kInt8), PRECISION(kInt8)>::PrepareForRun() {
+  auto& param = this->Param<operators::FcParam>();
+  const auto& w_dims = param.w->dims();
+  packed_w_int8_ = lite::x86::math::gemm_s8u8_pack_persistable_B(
+      *param.w, false, w_dims[0], w_dims[1]);
+}
+
+template <>
+void FcCompute<PRECISION(kInt8), PRECISION(kInt8)>::Run() {
+  auto& param = this->Param<operators::FcParam>();
+  FcInt8Compute(
+      param, packed_w_int8_.get(), param.output->mutable_data<int8_t>());
+}
+
+template <>
+void FcCompute<PRECISION(kInt8), PRECISION(kFloat)>::PrepareForRun() {
+  auto& param = this->Param<operators::FcParam>();
+  const auto& w_dims = param.w->dims();
+  packed_w_int8_ = lite::x86::math::gemm_s8u8_pack_persistable_B(
+      *param.w, false, w_dims[0], w_dims[1]);
 }
 
 template <>
 void FcCompute<PRECISION(kInt8), PRECISION(kFloat)>::Run() {
   auto& param = this->Param<operators::FcParam>();
-  auto* i_data = param.input->data<int8_t>();
-  auto* o_data = param.output->mutable_data<float>();
-  auto* w_data = param.w->data<int8_t>();
-  const float* b_data = param.bias ? param.bias->data<float>() : nullptr;
-  auto w_dims = param.w->dims();
-  int k = w_dims[0];
-  int n = w_dims[1];
-  int m = param.output->dims().production() / n;
-  int relu_type = (param.activation_type == "relu") ? 1 : 0;
-  float input_scale = param.input_scale;
-  float output_scale = param.output_scale;
-  float* w_scale =
-      static_cast<float*>(TargetMalloc(TARGET(kX86), m * sizeof(float)));
-
-  if (param.activation_type != "" && param.activation_type != "relu")
-    LOG(FATAL) << "not support fuse activation except relu.";
-
-  if (param.weight_scale.size() == 1) {
-    for (int i = 0; i < m; i++) w_scale[i] = param.weight_scale[0];
-    GEMM_OUT_FLOAT;
-    gemm.compute(i_data, w_data, o_data);
-  } else if (param.weight_scale.size() == m) {
-    for (int i = 0; i < m; i++) w_scale[i] = param.weight_scale[i];
-    GEMM_OUT_FLOAT;
-    gemm.compute(i_data, w_data, o_data);
-  } else if (param.weight_scale.size() == n) {
-    for (int i = 0; i < m; i++) w_scale[i] = 1.f;
-    GEMM_OUT_FLOAT;
-    gemm.compute(i_data, w_data, o_data);
-    for (int nn = 0; nn < n; nn++) {
-      float tmp_scale = param.weight_scale[nn];
-      for (int mm = 0; mm < m; mm++) {
-        int offt = mm * n + nn;
-        o_data[offt] = o_data[offt] * tmp_scale;
-      }
-    }
-  } else {
-    LOG(FATAL) << "weight scale size is not 1, N or M, not support yet.";
-  }
-  TargetFree(TARGET(kX86), w_scale);
+  FcInt8Compute(
+      param, packed_w_int8_.get(), param.output->mutable_data<float>());
 }
 
-#undef GEMM_OUT_INT8
-#undef GEMM_OUT_FLOAT
+// The weights are rounded to bf16 and multiplied with the rounded input in
+// fp32, the input, the bias and the output stay float.
+template <>
+void FcCompute<PRECISION(kBF16), PRECISION(kFloat)>::PrepareForRun() {
+  auto& param = *param_.get_mutable<param_t>();
+  const auto& w_dims = param.w->dims();
+  const int pad = param.padding_weights ? 4 : 0;
+  const int K = w_dims[0] - pad;
+  const int N = w_dims[1] - pad;
+  const int M = param.output->dims().production() / N;
+  int64_t packed_size = lite::x86::math::gemm_bf16_packed_B_size(K, N);
+  packed_w_bf16_ = lite::x86::math::gemm_bf16_pack_persistable_B(
+      *param.w, false, K, N, w_dims[1]);
+  if (packed_w_bf16_) packed_size = 0;
+  // The packed input, and the w when it is packed on every Run.
+  WorkSpace::Global_X86().Reserve(
+      (lite::x86::math::gemm_bf16_packed_A_size(M, K) + packed_size) *
+          sizeof(bfloat16) +
+      WorkSpace::kAlignment);
+}
+
+template <>
+void FcCompute<PRECISION(kBF16), PRECISION(kFloat)>::Run() {
+  auto& param = *param_.get_mutable<param_t>();
+  const auto& w_dims = param.w->dims();
+  const int pad = param.padding_weights ? 4 : 0;
+  const int K = w_dims[0] - pad;
+  const int N = w_dims[1] - pad;
+  const int M = param.output->dims().production() / N;
+  const bool with_relu = param.activation_type == "relu";
+  float* output_data = param.output->mutable_data<float>();
+
+  auto& workspace = WorkSpace::Global_X86();
+  size_t workspace_mark = workspace.cursor();
+  const bfloat16* packed_w =
+      packed_w_bf16_ ? packed_w_bf16_->data<bfloat16>() : nullptr;
+  if (!packed_w) {
+    bfloat16* packed = workspace.Alloc<bfloat16>(
+        lite::x86::math::gemm_bf16_packed_B_size(K, N));
+    lite::x86::math::gemm_bf16_pack_B(*param.w, false, K, N, w_dims[1], packed);
+    packed_w = packed;
+  }
+  lite::x86::math::gemm_bf16(false,
+                             M,
+                             N,
+                             K,
+                             param.input->data<float>(),
+                             K,
+                             packed_w,
+                             output_data,
+                             N);
+  workspace.Rewind(workspace_mark);
+
+  FcAddBiasRelu(param.bias ? param.bias->data<float>() : nullptr,
+                with_relu,
+                M,
+                N,
+                output_data);
+}
 
 }  // namespace x86
 }  // namespace kernels
@@ -285,6 +362,9 @@ typedef paddle::lite::kernels::x86::FcCompute<PRECISION(kInt8),
 typedef paddle::lite::kernels::x86::FcCompute<PRECISION(kInt8),
                                               PRECISION(kInt8)>
     FcCompute_int8_int8;
+typedef paddle::lite::kernels::x86::FcCompute<PRECISION(kBF16),
+                                              PRECISION(kFloat)>
+    FcCompute_bf16;
 
 REGISTER_LITE_KERNEL(fc, kX86, kFloat, kNCHW, FcCompute_FP32, def)
     .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
@@ -306,3 +386,10 @@ REGISTER_LITE_KERNEL(fc, kX86, kInt8, kNCHW, FcCompute_int8_fp32, fp32_out)
     .BindInput("W", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
     .Finalize();
+
+REGISTER_LITE_KERNEL(fc, kX86, kBF16, kNCHW, FcCompute_bf16, def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("W", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kBF16))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
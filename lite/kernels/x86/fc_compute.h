@@ -14,11 +14,16 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 #include "lite/backends/x86/jit/helper.h"
 #include "lite/backends/x86/jit/kernel_base.h"
 #include "lite/backends/x86/jit/kernels.h"
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/gemm_bf16.h"
+#include "lite/backends/x86/math/gemm_weight_only.h"
+#include "lite/backends/x86/math/packed_weight.h"
+#include "lite/backends/x86/math/sparse_gemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
@@ -35,9 +40,26 @@ class FcCompute : public KernelLite<TARGET(kX86), PType> {
  public:
   using param_t = operators::FcParam;
 
+  void PrepareForRun() override;
+
   virtual void Run();
 
   virtual ~FcCompute() = default;
+
+ private:
+  // The persistable float weight packed for the sgemm, shared with the
+  // kernels of the cloned predictors.
+  std::shared_ptr<const lite::x86::math::PackedGemmWeight> packed_w_;
+  // The persistable weight packed for gemm_bf16 by the bf16 kernel, shared
+  // with the kernels of the cloned predictors.
+  std::shared_ptr<const Tensor> packed_w_bf16_;
+  // The persistable weight packed for the int8 gemm, shared with the kernels
+  // of the cloned predictors.
+  std::shared_ptr<const Tensor> packed_w_int8_;
+  // The weight left int8/int4 by the predictor, read by gemm_weight_only.
+  lite::x86::math::QuantizedGemmWeight quantized_w_;
+  // The pruned weight in BCSR, see sparse_conv_detect_pass.
+  std::shared_ptr<const lite::x86::math::SparseGemmWeight> sparse_w_;
 };
 
 }  // namespace x86
@@ -0,0 +1,108 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fc_compute.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+TEST(fc_x86, retrive_op) {
+  auto fc = KernelRegistry::Global().Create("fc");
+  ASSERT_FALSE(fc.empty());
+  ASSERT_TRUE(fc.front());
+}
+
+TEST(fc_x86, init_bf16) {
+  FcCompute<PRECISION(kBF16), PRECISION(kFloat)> fc;
+  ASSERT_EQ(fc.precision(), PRECISION(kBF16));
+  ASSERT_EQ(fc.target(), TARGET(kX86));
+}
+
+TEST(fc_x86, run_bf16) {
+  // The products of the input and w rounded to bf16 summed in fp32, with
+  // w float or converted to bf16 by the predictor, persistable or not.
+  const int k = 37, n = 20;
+  auto round_bf16 = [](float v) { return static_cast<float>(bfloat16(v)); };
+  for (int m : {1, 5}) {
+    for (bool bf16_w : {false, true}) {
+      for (bool persistable : {false, true}) {
+        Tensor input, w, bias, out;
+        input.Resize({m, k});
+        w.Resize({k, n});
+        bias.Resize({n});
+        out.Resize({m, n});
+        std::vector<float> w_data(k * n);
+        fill_data_rand(input.mutable_data<float>(), -1.f, 1.f, m * k);
+        fill_data_rand(w_data.data(), -1.f, 1.f, k * n);
+        fill_data_rand(bias.mutable_data<float>(), -1.f, 1.f, n);
+        if (bf16_w) {
+          bfloat16* w_bf16 = w.mutable_data<bfloat16>();
+          for (int i = 0; i < k * n; i++) w_bf16[i] = bfloat16(w_data[i]);
+        } else {
+          std::copy(w_data.begin(), w_data.end(), w.mutable_data<float>());
+        }
+        w.set_persistable(persistable);
+
+        FcCompute<PRECISION(kBF16), PRECISION(kFloat)> fc;
+        operators::FcParam param;
+        param.input = &input;
+        param.w = &w;
+        param.bias = &bias;
+        param.output = &out;
+        param.in_num_col_dims = 1;
+        param.activation_type = "relu";
+        std::unique_ptr<KernelContext> ctx(new KernelContext);
+        ctx->As<X86Context>();
+        fc.SetContext(std::move(ctx));
+        fc.SetParam(param);
+        fc.PrepareForRun();
+        fc.Run();
+
+        const float* input_data = input.data<float>();
+        const float* bias_data = bias.data<float>();
+        const float* out_data = out.data<float>();
+        for (int i = 0; i < m; i++) {
+          for (int j = 0; j < n; j++) {
+            float ref = 0.f;
+            for (int l = 0; l < k; l++) {
+              ref += round_bf16(input_data[i * k + l]) *
+                     round_bf16(w_data[l * n + j]);
+            }
+            ref = std::max(ref + bias_data[j], 0.f);
+            EXPECT_NEAR(out_data[i * n + j], ref, 1e-4 * (std::fabs(ref) + 1))
+                << "m: " << m << ", bf16 w: " << bf16_w
+                << ", persistable: " << persistable;
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fc, kX86, kBF16, kNCHW, def);
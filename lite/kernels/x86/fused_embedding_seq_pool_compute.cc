@@ -0,0 +1,81 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_embedding_seq_pool_compute.h"
+#include <vector>
+#include "lite/backends/x86/math/embedding.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void FusedEmbeddingSeqPoolCompute::Run() {
+  auto& param = this->Param<param_t>();
+  auto* out = param.Out;
+  const auto& table_dims = param.W->dims();
+  const auto& ids_dims = param.Ids->dims();
+  const auto& lod = param.Ids->lod();
+  CHECK_LE(lod.size(), 2UL);
+  const auto& offsets = lod[lod.size() - 1];
+  const int64_t num_seq = static_cast<int64_t>(offsets.size()) - 1;
+  CHECK_GE(ids_dims[0], static_cast<int64_t>(offsets.back()));
+
+  auto out_dims = ids_dims;
+  out_dims[0] = num_seq;
+  out_dims[ids_dims.size() - 1] = table_dims[1];
+  out->Resize(out_dims);
+  lite::x86::math::embedding_seq_pool_fp32(
+      param.W->data<float>(),
+      table_dims[0],
+      table_dims[1],
+      param.Ids->data<int64_t>(),
+      param.Ids->numel() / ids_dims[0],
+      offsets.data(),
+      num_seq,
+      param.padding_idx,
+      param.combiner == "mean",
+      param.pad_value,
+      out->mutable_data<float>());
+
+  // The lod of sequence_pool, the outer level if any, else a sequence per
+  // row.
+  std::vector<uint64_t> out_offsets;
+  if (lod.size() == 2) {
+    out_offsets = lod[0];
+  } else {
+    out_offsets.resize(num_seq + 1);
+    for (int64_t i = 0; i <= num_seq; ++i) {
+      out_offsets[i] = i;
+    }
+  }
+  out->mutable_lod()->clear();
+  out->mutable_lod()->push_back(out_offsets);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(fused_embedding_seq_pool,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::FusedEmbeddingSeqPoolCompute,
+                     def)
+    .BindInput("W", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Ids", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt64))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
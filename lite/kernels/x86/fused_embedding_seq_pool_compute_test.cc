@@ -0,0 +1,137 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fused_embedding_seq_pool_compute.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/core/thread_pool.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// lookup_table and then sequence_pool, the rows of a sequence summed.
+std::vector<float> embedding_seq_pool_ref(const std::vector<float>& w,
+                                          int emb_size,
+                                          const std::vector<int64_t>& ids,
+                                          int ids_w,
+                                          const std::vector<uint64_t>& lod,
+                                          int64_t padding_idx,
+                                          bool mean,
+                                          float pad_value) {
+  const int out_w = ids_w * emb_size;
+  std::vector<float> out((lod.size() - 1) * out_w, 0.f);
+  for (size_t s = 0; s + 1 < lod.size(); ++s) {
+    float* dst = out.data() + s * out_w;
+    if (lod[s] == lod[s + 1]) {
+      for (int j = 0; j < out_w; ++j) dst[j] = pad_value;
+      continue;
+    }
+    for (uint64_t r = lod[s]; r < lod[s + 1]; ++r) {
+      for (int k = 0; k < ids_w; ++k) {
+        int64_t id = ids[r * ids_w + k];
+        if (id == padding_idx) continue;
+        for (int j = 0; j < emb_size; ++j) {
+          dst[k * emb_size + j] += w[id * emb_size + j];
+        }
+      }
+    }
+    if (mean) {
+      for (int j = 0; j < out_w; ++j) {
+        dst[j] /= static_cast<float>(lod[s + 1] - lod[s]);
+      }
+    }
+  }
+  return out;
+}
+
+void test_fused_embedding_seq_pool(int emb_size,
+                                   int ids_w,
+                                   const std::vector<uint64_t>& lod,
+                                   int64_t padding_idx,
+                                   const std::string& combiner) {
+  const int vocab_size = 97;
+  const int ids_h = static_cast<int>(lod.back());
+  const int num_seq = static_cast<int>(lod.size()) - 1;
+  lite::Tensor w, ids, out;
+  w.Resize({vocab_size, emb_size});
+  ids.Resize({ids_h, ids_w, 1});
+  ids.set_lod({lod});
+  auto* w_data = w.mutable_data<float>();
+  auto* ids_data = ids.mutable_data<int64_t>();
+  for (int i = 0; i < w.numel(); i++) {
+    w_data[i] = static_cast<float>(i % 23) / 7.f - 1.f;
+  }
+  for (int i = 0; i < ids.numel(); i++) {
+    ids_data[i] = (i * 37 + i / 5) % vocab_size;
+  }
+  std::vector<float> out_ref = embedding_seq_pool_ref(
+      std::vector<float>(w_data, w_data + w.numel()),
+      emb_size,
+      std::vector<int64_t>(ids_data, ids_data + ids.numel()),
+      ids_w,
+      lod,
+      padding_idx,
+      combiner == "mean",
+      0.5f);
+
+  FusedEmbeddingSeqPoolCompute fused_embedding_seq_pool;
+  operators::FusedEmbeddingSeqPoolParam param;
+  param.W = &w;
+  param.Ids = &ids;
+  param.Out = &out;
+  param.padding_idx = padding_idx;
+  param.combiner = combiner;
+  param.pad_value = 0.5f;
+  fused_embedding_seq_pool.SetParam(param);
+  fused_embedding_seq_pool.Run();
+
+  ASSERT_EQ(out.dims(), DDim({num_seq, ids_w, emb_size}));
+  ASSERT_EQ(out.lod().size(), 1UL);
+  ASSERT_EQ(out.lod()[0].size(), static_cast<size_t>(num_seq + 1));
+  const auto* out_data = out.data<float>();
+  for (int i = 0; i < out.numel(); i++) {
+    EXPECT_NEAR(out_data[i], out_ref[i], 1e-4)
+        << "emb_size: " << emb_size << ", ids_w: " << ids_w
+        << ", padding_idx: " << padding_idx << ", " << combiner;
+  }
+}
+
+TEST(fused_embedding_seq_pool_x86, compute) {
+  std::vector<uint64_t> lod{0, 3, 3, 10, 11, 40, 64, 64, 100};
+  for (int threads : {1, 4}) {
+    auto pool = ThreadPool::Create(threads);
+    ThreadPool::ScopedBind bind(pool.get());
+    for (int emb_size : {8, 13, 64}) {
+      for (int ids_w : {1, 3}) {
+        for (int64_t padding_idx : {-1, 5}) {
+          for (std::string combiner : {"sum", "mean"}) {
+            test_fused_embedding_seq_pool(
+                emb_size, ids_w, lod, padding_idx, combiner);
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fused_embedding_seq_pool, kX86, kFloat, kNCHW, def);
@@ -0,0 +1,180 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fusion_elementwise_chain_compute.h"
+#include <map>
+#include <string>
+#include <vector>
+#include "lite/backends/x86/math/elementwise_broadcast.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+using lite::x86::math::ChainOpType;
+
+namespace {
+
+template <template <typename> class OpConfig>
+void broadcast_op(const float* x,
+                  const float* y,
+                  float* out,
+                  const lite::x86::math::BroadcastPlan& plan) {
+  using Config = lite::x86::math::MergeConfig<
+      OpConfig<float>,
+      lite::x86::math::ActiveConfig<lite::x86::math::ActiveType::NO_ACTIVE,
+                                    float>>;
+  lite::x86::math::elementwise_broadcast<Config>(x, y, out, plan);
+}
+
+// out = op(x, y) of a binary op of the chain, by the loops of the unfused
+// elementwise kernels.
+void broadcast_chain_op(ChainOpType type,
+                        const float* x,
+                        const float* y,
+                        float* out,
+                        const lite::x86::math::BroadcastPlan& plan) {
+  switch (type) {
+    case ChainOpType::kAdd:
+      broadcast_op<lite::x86::math::AddConfig>(x, y, out, plan);
+      break;
+    case ChainOpType::kSub:
+      broadcast_op<lite::x86::math::SubConfig>(x, y, out, plan);
+      break;
+    case ChainOpType::kMul:
+      broadcast_op<lite::x86::math::MulConfig>(x, y, out, plan);
+      break;
+    case ChainOpType::kDiv:
+      broadcast_op<lite::x86::math::DivConfig>(x, y, out, plan);
+      break;
+    case ChainOpType::kMax:
+      broadcast_op<lite::x86::math::MaxConfig>(x, y, out, plan);
+      break;
+    case ChainOpType::kMin:
+      broadcast_op<lite::x86::math::MinConfig>(x, y, out, plan);
+      break;
+    default:
+      LOG(FATAL) << "Not a binary op of the elementwise chain: "
+                 << static_cast<int>(type);
+  }
+}
+
+}  // namespace
+
+void FusionElementwiseChainCompute::PrepareForRun() {
+  static const std::map<std::string, ChainOpType> kTypes{
+      {"elementwise_add", ChainOpType::kAdd},
+      {"elementwise_sub", ChainOpType::kSub},
+      {"elementwise_mul", ChainOpType::kMul},
+      {"elementwise_div", ChainOpType::kDiv},
+      {"elementwise_max", ChainOpType::kMax},
+      {"elementwise_min", ChainOpType::kMin},
+      {"scale", ChainOpType::kScale},
+      {"relu", ChainOpType::kRelu},
+      {"relu6", ChainOpType::kRelu6},
+      {"leaky_relu", ChainOpType::kLeakyRelu},
+      {"sigmoid", ChainOpType::kSigmoid},
+      {"tanh", ChainOpType::kTanh},
+      {"swish", ChainOpType::kSwish},
+      {"hard_swish", ChainOpType::kHardSwish}};
+  auto& param = this->Param<param_t>();
+  ops_.resize(param.ops.size());
+  for (size_t i = 0; i < param.ops.size(); ++i) {
+    auto it = kTypes.find(param.ops[i]);
+    CHECK(it != kTypes.end()) << "Unsupported op of the elementwise chain: "
+                              << param.ops[i];
+    ops_[i].type = it->second;
+    ops_[i].a = param.params[3 * i];
+    ops_[i].b = param.params[3 * i + 1];
+    ops_[i].c = param.params[3 * i + 2];
+  }
+}
+
+void FusionElementwiseChainCompute::Run() {
+  auto& param = this->Param<param_t>();
+  const auto& x_dims = param.X->dims();
+  const int64_t size = x_dims.production();
+  const float* in = param.X->data<float>();
+  float* out = param.Out->mutable_data<float>();
+  // The ops from first on are left to run as one chain.
+  size_t first = 0;
+  size_t y_index = 0;
+  for (size_t i = 0; i < ops_.size(); ++i) {
+    auto& op = ops_[i];
+    if (!lite::x86::math::is_binary_chain_op(op.type)) continue;
+    const lite::Tensor* y = param.Y[y_index++];
+    const auto& y_dims = y->dims();
+    const int y_rank = y_dims.size();
+    const int axis = param.axes[i] == -1
+                         ? static_cast<int>(x_dims.size()) - y_rank
+                         : param.axes[i];
+    // The leading and trailing 1 of y are broadcast, the dimensions left
+    // must be those of x: y is read at (i / post) % n.
+    int begin = 0;
+    int end = y_rank;
+    while (begin < end && y_dims[begin] == 1) ++begin;
+    while (end > begin && y_dims[end - 1] == 1) --end;
+    bool chained = true;
+    for (int j = begin; j < end; ++j) {
+      chained = chained && y_dims[j] == x_dims[axis + j];
+    }
+    op.y = y->data<float>();
+    op.n = y_dims.count(begin, end);
+    op.post = begin == end ? 1 : x_dims.count(axis + end, x_dims.size());
+    if (chained) continue;
+    // y broadcasts in the middle, e.g. a [B, 1, 1, S] mask of [B, H, S, S]
+    // scores: run the ops before it as a chain and this one unfused.
+    if (first < i) {
+      std::vector<lite::x86::math::ChainOp> ops(ops_.begin() + first,
+                                                ops_.begin() + i);
+      lite::x86::math::elementwise_chain_fp32(in, ops, size, out);
+      in = out;
+    }
+    broadcast_chain_op(
+        op.type,
+        in,
+        op.y,
+        out,
+        lite::x86::math::elementwise_broadcast_plan(x_dims, y_dims, axis));
+    in = out;
+    first = i + 1;
+  }
+  if (first == 0) {
+    lite::x86::math::elementwise_chain_fp32(in, ops_, size, out);
+  } else if (first < ops_.size()) {
+    std::vector<lite::x86::math::ChainOp> ops(ops_.begin() + first,
+                                              ops_.end());
+    lite::x86::math::elementwise_chain_fp32(in, ops, size, out);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+typedef paddle::lite::kernels::x86::FusionElementwiseChainCompute
+    ElementwiseChainCompute;
+
+REGISTER_LITE_KERNEL(fusion_elementwise_chain,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     ElementwiseChainCompute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -0,0 +1,245 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/fusion_elementwise_chain_compute.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// v = op(v, y) of y broadcast to v from axis, or v = op(v).
+void chain_op_basic(const std::string& op,
+                    const float* params,
+                    const Tensor* y,
+                    int axis,
+                    const DDim& dims,
+                    std::vector<float>* v) {
+  const int rank = dims.size();
+  for (int64_t i = 0; i < dims.production(); ++i) {
+    float a = (*v)[i];
+    float b = 0.f;
+    if (y) {
+      const auto& y_dims = y->dims();
+      const int y_axis =
+          axis == -1 ? rank - static_cast<int>(y_dims.size()) : axis;
+      // The index of y of the element i of v.
+      std::vector<int64_t> index(rank);
+      int64_t rest = i;
+      for (int r = rank - 1; r >= 0; --r) {
+        index[r] = rest % dims[r];
+        rest /= dims[r];
+      }
+      int64_t offset = 0;
+      for (size_t r = 0; r < y_dims.size(); ++r) {
+        int64_t idx = y_dims[r] == 1 ? 0 : index[y_axis + r];
+        offset = offset * y_dims[r] + idx;
+      }
+      b = y->data<float>()[offset];
+    }
+    float r = a;
+    if (op == "elementwise_add") {
+      r = a + b;
+    } else if (op == "elementwise_sub") {
+      r = a - b;
+    } else if (op == "elementwise_mul") {
+      r = a * b;
+    } else if (op == "elementwise_div") {
+      r = a / b;
+    } else if (op == "elementwise_max") {
+      r = std::max(a, b);
+    } else if (op == "elementwise_min") {
+      r = std::min(a, b);
+    } else if (op == "scale") {
+      r = a * params[0] + params[1];
+    } else if (op == "relu") {
+      r = std::max(a, 0.f);
+    } else if (op == "relu6") {
+      r = std::min(std::max(a, 0.f), params[0]);
+    } else if (op == "leaky_relu") {
+      r = a > 0.f ? a : a * params[0];
+    } else if (op == "sigmoid") {
+      r = 1.f / (1.f + std::exp(-a));
+    } else if (op == "tanh") {
+      r = std::tanh(a);
+    } else if (op == "swish") {
+      r = a / (1.f + std::exp(-params[0] * a));
+    } else if (op == "hard_swish") {
+      r = a * std::min(std::max(a + params[2], 0.f), params[0]) / params[1];
+    }
+    (*v)[i] = r;
+  }
+}
+
+TEST(fusion_elementwise_chain_x86, retrive_op) {
+  auto kernel = KernelRegistry::Global().Create("fusion_elementwise_chain");
+  ASSERT_FALSE(kernel.empty());
+  ASSERT_TRUE(kernel.front());
+}
+
+TEST(fusion_elementwise_chain_x86, init) {
+  FusionElementwiseChainCompute kernel;
+  ASSERT_EQ(kernel.precision(), PRECISION(kFloat));
+  ASSERT_EQ(kernel.target(), TARGET(kX86));
+}
+
+TEST(fusion_elementwise_chain_x86, run_test) {
+  struct ChainOpDesc {
+    std::string type;
+    float params[3];
+  };
+  const std::vector<ChainOpDesc> ops{{"elementwise_add", {0.f, 0.f, 0.f}},
+                                     {"scale", {1.5f, 0.2f, 0.f}},
+                                     {"elementwise_mul", {0.f, 0.f, 0.f}},
+                                     {"relu6", {3.f, 0.f, 0.f}},
+                                     {"elementwise_sub", {0.f, 0.f, 0.f}},
+                                     {"leaky_relu", {0.1f, 0.f, 0.f}},
+                                     {"elementwise_div", {0.f, 0.f, 0.f}},
+                                     {"sigmoid", {0.f, 0.f, 0.f}},
+                                     {"elementwise_max", {0.f, 0.f, 0.f}},
+                                     {"tanh", {0.f, 0.f, 0.f}},
+                                     {"swish", {1.3f, 0.f, 0.f}},
+                                     {"hard_swish", {6.f, 6.f, 3.f}},
+                                     {"elementwise_min", {0.f, 0.f, 0.f}},
+                                     {"relu", {0.f, 0.f, 0.f}}};
+  for (auto dims : {DDim({2, 16, 30, 37}), DDim({1, 16, 1, 5})}) {
+    // The Y of the elementwise ops: a channel, the whole tensor, the last
+    // dimension, a channel padded by 1, the batch and the two last
+    // dimensions.
+    const std::vector<DDim> y_dims{DDim({dims[1]}),
+                                   dims,
+                                   DDim({dims[3]}),
+                                   DDim({1, dims[1], 1, 1}),
+                                   DDim({dims[0], 1, 1, 1}),
+                                   DDim({dims[2], dims[3]})};
+    const std::vector<int> y_axes{1, -1, -1, 0, -1, 2};
+    std::vector<Tensor> ys(y_dims.size());
+    for (size_t i = 0; i < ys.size(); ++i) {
+      ys[i].Resize(y_dims[i]);
+      // The divisor is kept away from 0.
+      fill_data_rand(ys[i].mutable_data<float>(),
+                     i == 3 ? 1.f : -1.f,
+                     2.f,
+                     ys[i].numel());
+    }
+    Tensor x, out;
+    x.Resize(dims);
+    out.Resize(dims);
+    fill_data_rand(x.mutable_data<float>(), -4.f, 4.f, x.numel());
+
+    for (size_t length : {ops.size(), size_t(2), size_t(5)}) {
+      operators::FusionElementwiseChainParam param;
+      param.X = &x;
+      param.Out = &out;
+      std::vector<float> ref(x.data<float>(), x.data<float>() + x.numel());
+      size_t y_index = 0;
+      for (size_t i = 0; i < length; ++i) {
+        const auto& op = ops[i];
+        const bool binary = op.type.compare(0, 12, "elementwise_") == 0;
+        const Tensor* y = binary ? &ys[y_index] : nullptr;
+        const int axis = binary ? y_axes[y_index++] : -1;
+        if (y) param.Y.push_back(y);
+        param.ops.push_back(op.type);
+        param.axes.push_back(axis);
+        param.params.insert(param.params.end(), op.params, op.params + 3);
+        chain_op_basic(op.type, op.params, y, axis, dims, &ref);
+      }
+
+      FusionElementwiseChainCompute kernel;
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>();
+      kernel.SetContext(std::move(ctx));
+      kernel.SetParam(param);
+      kernel.PrepareForRun();
+      kernel.Run();
+
+      const float* out_data = out.data<float>();
+      for (int64_t i = 0; i < out.numel(); ++i) {
+        ASSERT_NEAR(out_data[i], ref[i], 1e-4 * (std::fabs(ref[i]) + 1.f))
+            << "dims: " << dims << ", length: " << length << ", i: " << i;
+      }
+    }
+  }
+}
+
+TEST(fusion_elementwise_chain_x86, run_middle_broadcast_test) {
+  // The [B, 1, 1, S] mask of the attention scores and a [B, 1, S, 1] one
+  // are broadcast in the middle, which the ops around them run chained.
+  const DDim dims({2, 4, 6, 6});
+  const std::vector<std::string> ops{"elementwise_add",
+                                     "scale",
+                                     "elementwise_mul",
+                                     "elementwise_sub",
+                                     "relu"};
+  const std::vector<float> params{
+      0.f, 0.f, 0.f, 0.5f, 0.1f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f,
+      0.f};
+  const std::vector<DDim> y_dims{
+      DDim({2, 1, 1, 6}), DDim({1, 4, 1, 1}), DDim({2, 1, 6, 1})};
+  const std::vector<int> axes{-1, -1, 0, -1, -1};
+  std::vector<Tensor> ys(y_dims.size());
+  for (size_t i = 0; i < ys.size(); ++i) {
+    ys[i].Resize(y_dims[i]);
+    fill_data_rand(ys[i].mutable_data<float>(), -1.f, 1.f, ys[i].numel());
+  }
+  Tensor x, out;
+  x.Resize(dims);
+  out.Resize(dims);
+  fill_data_rand(x.mutable_data<float>(), -4.f, 4.f, x.numel());
+
+  operators::FusionElementwiseChainParam param;
+  param.X = &x;
+  param.Out = &out;
+  param.ops = ops;
+  param.axes = axes;
+  param.params = params;
+  std::vector<float> ref(x.data<float>(), x.data<float>() + x.numel());
+  size_t y_index = 0;
+  for (size_t i = 0; i < ops.size(); ++i) {
+    const bool binary = ops[i].compare(0, 12, "elementwise_") == 0;
+    const Tensor* y = binary ? &ys[y_index++] : nullptr;
+    if (y) param.Y.push_back(y);
+    chain_op_basic(ops[i], &params[3 * i], y, axes[i], dims, &ref);
+  }
+
+  FusionElementwiseChainCompute kernel;
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  kernel.SetContext(std::move(ctx));
+  kernel.SetParam(param);
+  kernel.PrepareForRun();
+  kernel.Run();
+
+  const float* out_data = out.data<float>();
+  for (int64_t i = 0; i < out.numel(); ++i) {
+    ASSERT_NEAR(out_data[i], ref[i], 1e-4 * (std::fabs(ref[i]) + 1.f))
+        << "i: " << i;
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(fusion_elementwise_chain, kX86, kFloat, kNCHW, def);
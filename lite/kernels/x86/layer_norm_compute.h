@@ -14,9 +14,7 @@
 
 #pragma once
 
-#include "lite/backends/x86/jit/helper.h"
-#include "lite/backends/x86/jit/kernel_base.h"
-#include "lite/backends/x86/jit/kernels.h"
+#include "lite/backends/x86/math/layer_norm_fp32.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_lite.h"
 #include "lite/core/op_registry.h"
@@ -47,39 +45,29 @@ class LayerNormCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
     auto x_dims = x->dims();
 
-    y->template mutable_data<T>();
-    Mean->template mutable_data<T>();
-    Var->template mutable_data<T>();
-
     auto matrix_dim = x_dims.Flatten2D(begin_norm_axis);
     int left = static_cast<int>(matrix_dim[0]);
     int right = static_cast<int>(matrix_dim[1]);
-    lite::DDim matrix_shape({left, right});
-
-    lite::Tensor in;
-    in.ShareDataWith(*x);
-    in.Resize(matrix_shape);
-    lite::Tensor out;
-    out.ShareDataWith(*y);
-    out.Resize(matrix_shape);
 
     CHECK_EQ(Mean->numel(), left);
     CHECK_EQ(Var->numel(), left);
-    CHECK_EQ(Scale->numel(), right);
-    CHECK_EQ(Bias->numel(), right);
+    if (Scale) {
+      CHECK_EQ(Scale->numel(), right);
+    }
+    if (Bias) {
+      CHECK_EQ(Bias->numel(), right);
+    }
 
-    auto ker = paddle::lite::jit::KernelFuncs<jit::LayerNormTuple<T>,
-                                              lite::fluid::CPUPlace>::Cache()
-                   .At(right);
-    ker(in.mutable_data<T>(),
-        out.mutable_data<T>(),
-        Mean->template mutable_data<T>(),
-        Var->template mutable_data<T>(),
-        Scale->template data<T>(),
-        Bias->template data<T>(),
-        static_cast<int>(left),
+    lite::x86::math::layer_norm_fp32(
+        x->template data<T>(),
+        Scale ? Scale->template data<T>() : nullptr,
+        Bias ? Bias->template data<T>() : nullptr,
+        left,
+        right,
         epsilon,
-        right);
+        y->template mutable_data<T>(),
+        Mean->template mutable_data<T>(),
+        Var->template mutable_data<T>());
   }
 
   virtual ~LayerNormCompute() = default;
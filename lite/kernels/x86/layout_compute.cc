@@ -0,0 +1,99 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/layout_compute.h"
+#include "lite/backends/x86/math/avx/nchw8c.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void NCHWToNCHW8cCompute::Run() {
+  auto& param = this->Param<param_t>();
+  auto dims = param.x->dims();
+  param.y->Resize(dims);
+  auto output = param.y->mutable_data<float>(
+      TARGET(kX86), sizeof(float) * lite::x86::math::nchw8c_size(dims));
+  lite::x86::math::nchw_to_nchw8c(param.x->data<float>(),
+                                  output,
+                                  dims[0],
+                                  dims[1],
+                                  dims[2] * dims[3]);
+}
+
+void NCHW8cToNCHWCompute::Run() {
+  auto& param = this->Param<param_t>();
+  auto dims = param.x->dims();
+  CHECK_EQ(dims.size(), 4u) << "nChw8c is only for 4-D tensors";
+  param.y->Resize(dims);
+  auto output = param.y->mutable_data<float>();
+  lite::x86::math::nchw8c_to_nchw(param.x->data<float>(),
+                                  output,
+                                  dims[0],
+                                  dims[1],
+                                  dims[2] * dims[3]);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+typedef paddle::lite::kernels::x86::NCHWToNCHW8cCompute NCHW_fp32;
+typedef paddle::lite::kernels::x86::NCHW8cToNCHWCompute NCHW8c_fp32;
+
+REGISTER_LITE_KERNEL(layout, kX86, kFloat, kNCHW, NCHW_fp32, nchw2nchw8c)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout, kX86, kFloat, kNCHW, NCHW8c_fp32, nchw8c2nchw)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout_once, kX86, kFloat, kNCHW, NCHW_fp32, nchw2nchw8c)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(layout_once, kX86, kFloat, kNCHW, NCHW8c_fp32, nchw8c2nchw)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW))})
+    .Finalize();
@@ -14,7 +14,7 @@
 #pragma once
 
 #include <vector>
-#include "lite/backends/x86/fluid/eigen.h"
+#include "lite/backends/x86/math/embedding.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 
@@ -42,18 +42,8 @@ class LookupTableCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
     const T *table = table_t->template data<T>();
     T *output = output_t->template mutable_data<T>();
-    memset(output, 0, output_t->dims().production() * sizeof(T));
-    for (int64_t i = 0; i < ids_numel; ++i) {
-      if (padding_idx != -1 && ids[i] == padding_idx) {
-        memset(output + i * row_width, 0, row_width * sizeof(T));
-      } else {
-        CHECK_LT(ids[i], row_number);
-        CHECK_GE(ids[i], 0);
-        memcpy(output + i * row_width,
-               table + ids[i] * row_width,
-               row_width * sizeof(T));
-      }
-    }
+    lite::x86::math::embedding_lookup_fp32(
+        table, row_number, row_width, ids, ids_numel, padding_idx, output);
   }
 
   virtual ~LookupTableCompute() = default;
@@ -13,6 +13,162 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/matmul_compute.h"
+#include "lite/backends/x86/math/gemm_s8u8_compute.h"
+#include "lite/core/workspace.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <typename OutType>
+void MatMulInt8Compute<OutType>::PrepareForRun() {
+  auto& param = *param_.get_mutable<operators::MatMulParam>();
+  const auto& y_dims = param.Y->dims();
+  if (y_dims.size() != 2) return;
+  const int k = param.transpose_Y ? y_dims[1] : y_dims[0];
+  const int n = param.transpose_Y ? y_dims[0] : y_dims[1];
+  packed_y_ = lite::x86::math::gemm_s8u8_pack_persistable_B(
+      *param.Y, param.transpose_Y, k, n);
+}
+
+template <typename OutType>
+void MatMulInt8Compute<OutType>::Run() {
+  auto& param = *param_.get_mutable<operators::MatMulParam>();
+  auto x_dims = RowMatrixFromVector(param.X->dims());
+  auto y_dims = ColumnMatrixFromVector(param.Y->dims());
+  const int x_rank = x_dims.size();
+  const int y_rank = y_dims.size();
+  int m = param.transpose_X ? x_dims[x_rank - 1] : x_dims[x_rank - 2];
+  const int k = param.transpose_X ? x_dims[x_rank - 2] : x_dims[x_rank - 1];
+  const int n = param.transpose_Y ? y_dims[y_rank - 2] : y_dims[y_rank - 1];
+  int batch = param.Out->dims().production() / (m * n);
+  const int64_t x_stride = x_rank > 2 ? m * k : 0;
+  const int64_t y_stride = y_rank > 2 ? k * n : 0;
+  // The rows of all the matrices of x make one gemm with a matrix y.
+  if (!param.transpose_X && y_rank == 2) {
+    m *= batch;
+    batch = 1;
+  }
+  const int8_t* x_data = param.X->template data<int8_t>();
+  const int8_t* y_data = param.Y->template data<int8_t>();
+  OutType* out_data = param.Out->template mutable_data<OutType>();
+  // Only a 2-D Y is packed, the same matrix for all the batches.
+  const uint8_t* packed_y =
+      packed_y_ ? packed_y_->template data<uint8_t>() : nullptr;
+  for (int i = 0; i < batch; i++) {
+    lite::x86::math::gemm_s8u8_quantized(param.transpose_X,
+                                         param.transpose_Y,
+                                         m,
+                                         n,
+                                         k,
+                                         param.alpha,
+                                         x_data + i * x_stride,
+                                         param.input_scale,
+                                         y_data + i * y_stride,
+                                         param.weight_scale,
+                                         param.output_scale,
+                                         nullptr,
+                                         0,
+                                         0.f,
+                                         out_data + i * m * n,
+                                         n,
+                                         packed_y);
+  }
+}
+
+// Pack the matrix at offset of y, which is float or converted to bf16.
+static void PackBf16Y(const Tensor& y,
+                      int64_t offset,
+                      bool transpose_Y,
+                      int k,
+                      int n,
+                      bfloat16* packed_y) {
+  const int ldy = transpose_Y ? k : n;
+  if (y.precision() == PRECISION(kBF16)) {
+    lite::x86::math::gemm_bf16_pack_B(
+        transpose_Y, k, n, y.data<bfloat16>() + offset, ldy, packed_y);
+  } else {
+    lite::x86::math::gemm_bf16_pack_B(
+        transpose_Y, k, n, y.data<float>() + offset, ldy, packed_y);
+  }
+}
+
+void MatMulBf16Compute::PrepareForRun() {
+  auto& param = *param_.get_mutable<operators::MatMulParam>();
+  auto x_dims = RowMatrixFromVector(param.X->dims());
+  auto y_dims = ColumnMatrixFromVector(param.Y->dims());
+  const int x_rank = x_dims.size();
+  const int y_rank = y_dims.size();
+  const int m = param.transpose_X ? x_dims[x_rank - 1] : x_dims[x_rank - 2];
+  const int k = param.transpose_X ? x_dims[x_rank - 2] : x_dims[x_rank - 1];
+  const int n = param.transpose_Y ? y_dims[y_rank - 2] : y_dims[y_rank - 1];
+  const int batch = param.Out->dims().production() / (m * n);
+  int64_t packed_size = lite::x86::math::gemm_bf16_packed_B_size(k, n);
+  if (y_rank == 2) {
+    packed_y_ = lite::x86::math::gemm_bf16_pack_persistable_B(
+        *param.Y, param.transpose_Y, k, n, param.transpose_Y ? k : n);
+  }
+  if (packed_y_) packed_size = 0;
+  // The packed input, and the Y when it is packed on every Run.
+  WorkSpace::Global_X86().Reserve(
+      (lite::x86::math::gemm_bf16_packed_A_size(m * batch, k) + packed_size) *
+          sizeof(bfloat16) +
+      WorkSpace::kAlignment);
+}
+
+void MatMulBf16Compute::Run() {
+  auto& param = *param_.get_mutable<operators::MatMulParam>();
+  auto x_dims = RowMatrixFromVector(param.X->dims());
+  auto y_dims = ColumnMatrixFromVector(param.Y->dims());
+  const int x_rank = x_dims.size();
+  const int y_rank = y_dims.size();
+  int m = param.transpose_X ? x_dims[x_rank - 1] : x_dims[x_rank - 2];
+  const int k = param.transpose_X ? x_dims[x_rank - 2] : x_dims[x_rank - 1];
+  const int n = param.transpose_Y ? y_dims[y_rank - 2] : y_dims[y_rank - 1];
+  int batch = param.Out->dims().production() / (m * n);
+  const int64_t x_stride = x_rank > 2 ? m * k : 0;
+  const int64_t y_stride = y_rank > 2 ? k * n : 0;
+  // The rows of all the matrices of x make one gemm with a matrix y.
+  if (!param.transpose_X && y_rank == 2) {
+    m *= batch;
+    batch = 1;
+  }
+  const int lda = param.transpose_X ? m : k;
+  const float* x_data = param.X->data<float>();
+  float* out_data = param.Out->mutable_data<float>();
+  auto& workspace = WorkSpace::Global_X86();
+  size_t workspace_mark = workspace.cursor();
+  const bool prepacked = packed_y_ != nullptr;
+  bfloat16* packed = prepacked
+                         ? nullptr
+                         : workspace.Alloc<bfloat16>(
+                               lite::x86::math::gemm_bf16_packed_B_size(k, n));
+  for (int i = 0; i < batch; i++) {
+    if (!prepacked && (i == 0 || y_stride != 0)) {
+      PackBf16Y(*param.Y, i * y_stride, param.transpose_Y, k, n, packed);
+    }
+    lite::x86::math::gemm_bf16(param.transpose_X,
+                               m,
+                               n,
+                               k,
+                               x_data + i * x_stride,
+                               lda,
+                               prepacked ? packed_y_->data<bfloat16>() : packed,
+                               out_data + i * m * n,
+                               n);
+  }
+  workspace.Rewind(workspace_mark);
+  if (param.alpha != 1.f) {
+    const int64_t size = param.Out->numel();
+    for (int64_t i = 0; i < size; i++) out_data[i] *= param.alpha;
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
 
 REGISTER_LITE_KERNEL(matmul,
                      kX86,
@@ -24,3 +180,30 @@ REGISTER_LITE_KERNEL(matmul,
     .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
     .Finalize();
+
+typedef paddle::lite::kernels::x86::MatMulInt8Compute<float> MatMul_int8_fp32;
+typedef paddle::lite::kernels::x86::MatMulInt8Compute<int8_t> MatMul_int8_int8;
+
+REGISTER_LITE_KERNEL(matmul, kX86, kInt8, kNCHW, MatMul_int8_fp32, fp32_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(matmul, kX86, kInt8, kNCHW, MatMul_int8_int8, int8_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+// Y is a float activation or a weight converted to bf16 by the predictor.
+REGISTER_LITE_KERNEL(matmul,
+                     kX86,
+                     kBF16,
+                     kNCHW,
+                     paddle::lite::kernels::x86::MatMulBf16Compute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kAny))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
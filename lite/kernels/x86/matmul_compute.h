@@ -13,7 +13,11 @@
 // limitations under the License.
 #pragma once
 
+#include <memory>
+#include <type_traits>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/gemm_bf16.h"
+#include "lite/backends/x86/math/packed_weight.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -49,6 +53,22 @@ class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::MatMulParam;
 
+  void PrepareForRun() override {
+    auto &param = *param_.get_mutable<operators::MatMulParam>();
+    const auto &y_dims = param.Y->dims();
+    if (!std::is_same<T, float>::value || y_dims.size() != 2) return;
+    const int K = param.transpose_Y ? y_dims[1] : y_dims[0];
+    const int N = param.transpose_Y ? y_dims[0] : y_dims[1];
+    packed_y_ = lite::x86::math::PackPersistableWeight(
+        *param.Y,
+        param.transpose_Y,
+        K,
+        N,
+        y_dims[1],
+        param.alpha,
+        param.Out->dims().production() / N);
+  }
+
   void Run() override {
     auto &context = ctx_->As<X86Context>();
     auto &param = *param_.get_mutable<operators::MatMulParam>();
@@ -58,6 +78,23 @@ class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto *out = param.Out;
     out->template mutable_data<T>();
 
+    // All the rows of x make one gemm with the packed y, x is transposed
+    // only as a matrix.
+    const auto &x_dims = x->dims();
+    if (packed_y_ && x_dims.size() >= 2 &&
+        (!param.transpose_X || x_dims.size() == 2)) {
+      const int K = packed_y_->K();
+      const int M = x_dims.production() / K;
+      packed_y_->Compute(param.transpose_X,
+                         M,
+                         x->template data<float>(),
+                         param.transpose_X ? M : K,
+                         0.f,
+                         out->template mutable_data<float>(),
+                         packed_y_->N());
+      return;
+    }
+
     auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
     auto mat_dim_a = lite::x86::math::CreateMatrixDescriptor(
         RowMatrixFromVector(x->dims()), 0, param.transpose_X);
@@ -68,6 +105,47 @@ class MatMulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
   }
 
   virtual ~MatMulCompute() = default;
+
+ private:
+  // The persistable float y packed with alpha for the sgemm.
+  std::shared_ptr<const lite::x86::math::PackedGemmWeight> packed_y_;
+};
+
+// matmul of the quantized X and Y, Y being quantized per tensor or per column.
+// A persistable 2-D Y is packed once.
+template <typename OutType>
+class MatMulInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::MatMulParam;
+
+  void PrepareForRun() override;
+
+  void Run() override;
+
+  virtual ~MatMulInt8Compute() = default;
+
+ private:
+  // The persistable 2-D Y packed for the int8 gemm, shared with the kernels
+  // of the cloned predictors.
+  std::shared_ptr<const Tensor> packed_y_;
+};
+
+// matmul of the float X and Y rounded to bf16, a persistable 2-D Y is packed
+// once.
+class MatMulBf16Compute : public KernelLite<TARGET(kX86), PRECISION(kBF16)> {
+ public:
+  using param_t = operators::MatMulParam;
+
+  void PrepareForRun() override;
+
+  void Run() override;
+
+  virtual ~MatMulBf16Compute() = default;
+
+ private:
+  // The persistable 2-D Y packed for gemm_bf16, shared with the kernels of
+  // the cloned predictors.
+  std::shared_ptr<const Tensor> packed_y_;
 };
 
 }  // namespace x86
@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -21,6 +22,7 @@
 
 #include "lite/core/op_registry.h"
 #include "lite/kernels/x86/matmul_compute.h"
+#include "lite/tests/utils/fill_data.h"
 
 namespace paddle {
 namespace lite {
@@ -80,9 +82,67 @@ TEST(matmul_x86, run_test) {
   }
 }
 
+TEST(matmul_x86, run_bf16) {
+  // 2 x m x k X times a persistable k x n Y, packed once, or a 2 x k x n Y,
+  // with Y transposed or not and alpha. The products are rounded to bf16.
+  const int batch = 2, m = 3, k = 37, n = 20;
+  const float alpha = 0.5f;
+  auto round_bf16 = [](float v) { return static_cast<float>(bfloat16(v)); };
+  for (bool batch_y : {false, true}) {
+    for (bool transpose_Y : {false, true}) {
+      lite::Tensor x, y, out;
+      x.Resize({batch, m, k});
+      if (batch_y) {
+        y.Resize(transpose_Y ? DDim({batch, n, k}) : DDim({batch, k, n}));
+      } else {
+        y.Resize(transpose_Y ? DDim({n, k}) : DDim({k, n}));
+        y.set_persistable(true);
+      }
+      out.Resize({batch, m, n});
+      fill_data_rand(x.mutable_data<float>(), -1.f, 1.f, x.numel());
+      fill_data_rand(y.mutable_data<float>(), -1.f, 1.f, y.numel());
+
+      MatMulBf16Compute matmul;
+      operators::MatMulParam param;
+      param.X = &x;
+      param.Y = &y;
+      param.Out = &out;
+      param.transpose_Y = transpose_Y;
+      param.alpha = alpha;
+      std::unique_ptr<KernelContext> ctx(new KernelContext);
+      ctx->As<X86Context>();
+      matmul.SetContext(std::move(ctx));
+      matmul.SetParam(param);
+      matmul.PrepareForRun();
+      matmul.Run();
+
+      const float* x_data = x.data<float>();
+      const float* out_data = out.data<float>();
+      for (int b = 0; b < batch; b++) {
+        const float* y_data = y.data<float>() + (batch_y ? b * k * n : 0);
+        for (int i = 0; i < m; i++) {
+          for (int j = 0; j < n; j++) {
+            float ref = 0.f;
+            for (int l = 0; l < k; l++) {
+              float y_v = transpose_Y ? y_data[j * k + l] : y_data[l * n + j];
+              ref += round_bf16(x_data[(b * m + i) * k + l]) * round_bf16(y_v);
+            }
+            ref *= alpha;
+            EXPECT_NEAR(out_data[(b * m + i) * n + j],
+                        ref,
+                        1e-4 * (std::fabs(ref) + 1))
+                << "batch y: " << batch_y << ", transpose y: " << transpose_Y;
+          }
+        }
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
 }  // namespace paddle
 
 USE_LITE_KERNEL(matmul, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(matmul, kX86, kBF16, kNCHW, def);
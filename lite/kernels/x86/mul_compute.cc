@@ -13,6 +13,108 @@
 // limitations under the License.
 
 #include "lite/kernels/x86/mul_compute.h"
+#include "lite/backends/x86/math/gemm_s8u8_compute.h"
+#include "lite/core/workspace.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <typename OutType>
+void MulInt8Compute<OutType>::PrepareForRun() {
+  auto& param = *param_.get_mutable<operators::MulParam>();
+  auto y_dims = param.y->dims();
+  if (y_dims.size() > 2) y_dims = y_dims.Flatten2D(param.y_num_col_dims);
+  packed_y_ = lite::x86::math::gemm_s8u8_pack_persistable_B(
+      *param.y, false, y_dims[0], y_dims[1]);
+}
+
+template <typename OutType>
+void MulInt8Compute<OutType>::Run() {
+  auto& param = *param_.get_mutable<operators::MulParam>();
+  auto x_dims = param.x->dims();
+  auto y_dims = param.y->dims();
+  if (x_dims.size() > 2) x_dims = x_dims.Flatten2D(param.x_num_col_dims);
+  if (y_dims.size() > 2) y_dims = y_dims.Flatten2D(param.y_num_col_dims);
+  const int m = x_dims[0];
+  const int k = x_dims[1];
+  const int n = y_dims[1];
+  lite::x86::math::gemm_s8u8_quantized(
+      false,
+      false,
+      m,
+      n,
+      k,
+      1.f,
+      param.x->template data<int8_t>(),
+      param.input_scale,
+      param.y->template data<int8_t>(),
+      param.weight_scale,
+      param.output_scale,
+      nullptr,
+      0,
+      0.f,
+      param.output->template mutable_data<OutType>(),
+      n,
+      packed_y_ ? packed_y_->template data<uint8_t>() : nullptr);
+}
+
+void MulBf16Compute::PrepareForRun() {
+  auto& param = *param_.get_mutable<operators::MulParam>();
+  auto x_dims = param.x->dims();
+  auto y_dims = param.y->dims();
+  if (x_dims.size() > 2) x_dims = x_dims.Flatten2D(param.x_num_col_dims);
+  if (y_dims.size() > 2) y_dims = y_dims.Flatten2D(param.y_num_col_dims);
+  const int m = x_dims[0];
+  const int k = x_dims[1];
+  const int n = y_dims[1];
+  int64_t packed_size = lite::x86::math::gemm_bf16_packed_B_size(k, n);
+  packed_y_ =
+      lite::x86::math::gemm_bf16_pack_persistable_B(*param.y, false, k, n, n);
+  if (packed_y_) packed_size = 0;
+  // The packed input, and the y when it is packed on every Run.
+  WorkSpace::Global_X86().Reserve(
+      (lite::x86::math::gemm_bf16_packed_A_size(m, k) + packed_size) *
+          sizeof(bfloat16) +
+      WorkSpace::kAlignment);
+}
+
+void MulBf16Compute::Run() {
+  auto& param = *param_.get_mutable<operators::MulParam>();
+  auto x_dims = param.x->dims();
+  auto y_dims = param.y->dims();
+  if (x_dims.size() > 2) x_dims = x_dims.Flatten2D(param.x_num_col_dims);
+  if (y_dims.size() > 2) y_dims = y_dims.Flatten2D(param.y_num_col_dims);
+  const int m = x_dims[0];
+  const int k = x_dims[1];
+  const int n = y_dims[1];
+  auto& workspace = WorkSpace::Global_X86();
+  size_t workspace_mark = workspace.cursor();
+  const bfloat16* packed_y =
+      packed_y_ ? packed_y_->data<bfloat16>() : nullptr;
+  if (!packed_y) {
+    bfloat16* packed = workspace.Alloc<bfloat16>(
+        lite::x86::math::gemm_bf16_packed_B_size(k, n));
+    lite::x86::math::gemm_bf16_pack_B(*param.y, false, k, n, n, packed);
+    packed_y = packed;
+  }
+  lite::x86::math::gemm_bf16(false,
+                             m,
+                             n,
+                             k,
+                             param.x->data<float>(),
+                             k,
+                             packed_y,
+                             param.output->mutable_data<float>(),
+                             n);
+  workspace.Rewind(workspace_mark);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
 
 REGISTER_LITE_KERNEL(mul,
                      kX86,
@@ -24,3 +126,30 @@ REGISTER_LITE_KERNEL(mul,
     .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86))})
     .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
     .Finalize();
+
+typedef paddle::lite::kernels::x86::MulInt8Compute<float> Mul_int8_fp32;
+typedef paddle::lite::kernels::x86::MulInt8Compute<int8_t> Mul_int8_int8;
+
+REGISTER_LITE_KERNEL(mul, kX86, kInt8, kNCHW, Mul_int8_fp32, fp32_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(mul, kX86, kInt8, kNCHW, Mul_int8_int8, int8_out)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt8))})
+    .Finalize();
+
+// Y is a float activation or a weight converted to bf16 by the predictor.
+REGISTER_LITE_KERNEL(mul,
+                     kX86,
+                     kBF16,
+                     kNCHW,
+                     paddle::lite::kernels::x86::MulBf16Compute,
+                     def)
+    .BindInput("X", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Y", {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kAny))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -13,7 +13,13 @@
 // limitations under the License.
 #pragma once
 
+#include <memory>
+#include <type_traits>
 #include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/gemm_bf16.h"
+#include "lite/backends/x86/math/gemm_weight_only.h"
+#include "lite/backends/x86/math/packed_weight.h"
+#include "lite/backends/x86/math/sparse_gemm.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 #include "lite/core/types.h"
@@ -39,6 +45,34 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
  public:
   using param_t = operators::MulParam;
 
+  void PrepareForRun() override {
+    auto& param = *param_.get_mutable<operators::MulParam>();
+    if (!std::is_same<T, float>::value) return;
+    quantized_y_ =
+        lite::x86::math::quantized_gemm_weight(*param.y,
+                                               param.weight_quant_bits,
+                                               param.weight_quant_group_size,
+                                               param.weight_quant_scale);
+    if (quantized_y_.data) return;
+    auto x_dims = param.x->dims();
+    auto y_dims = param.y->dims();
+    if (x_dims.size() > 2) x_dims = x_dims.Flatten2D(param.x_num_col_dims);
+    if (y_dims.size() > 2) y_dims = y_dims.Flatten2D(param.y_num_col_dims);
+    if (x_dims.size() != 2 || y_dims.size() != 2) return;
+    if (param.sparse_weight && param.y->persistable()) {
+      sparse_y_ = lite::x86::math::SparseGemmWeight::Create(
+          param.y->template data<float>(), y_dims[0], y_dims[1], y_dims[1]);
+      return;
+    }
+    packed_y_ = lite::x86::math::PackPersistableWeight(*param.y,
+                                                       false,
+                                                       y_dims[0],
+                                                       y_dims[1],
+                                                       y_dims[1],
+                                                       1.f,
+                                                       x_dims[0]);
+  }
+
   void Run() override {
     auto& context = ctx_->As<X86Context>();
     auto& param = *param_.get_mutable<operators::MulParam>();
@@ -49,6 +83,22 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
     auto* x = param.x;
     auto* y = param.y;
 
+    if (quantized_y_.data) {
+      // The int8/int4 y is 2-D, the output dims are set by InferShape.
+      const int K = y->dims()[0];
+      const int N = z->dims()[z->dims().size() - 1];
+      const int M = x->dims().production() / K;
+      lite::x86::math::gemm_weight_only(M,
+                                        N,
+                                        K,
+                                        x->template data<float>(),
+                                        K,
+                                        quantized_y_,
+                                        z->template mutable_data<float>(),
+                                        N);
+      return;
+    }
+
     Tensor x_matrix, y_matrix;
 
     if (x->dims().size() > 2) {
@@ -70,15 +120,77 @@ class MulCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
       z->Resize({x_matrix.dims()[0], y_matrix.dims()[1]});
     }
 
-    auto blas = lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
-
-    blas.MatMul(x_matrix, y_matrix, z);
+    if (sparse_y_) {
+      sparse_y_->Compute(x_matrix.dims()[0],
+                         x_matrix.template data<float>(),
+                         sparse_y_->K(),
+                         nullptr,
+                         z->template mutable_data<float>(),
+                         sparse_y_->N());
+    } else if (packed_y_) {
+      const int K = packed_y_->K();
+      packed_y_->Compute(false,
+                         x_matrix.dims()[0],
+                         x_matrix.template data<float>(),
+                         K,
+                         0.f,
+                         z->template mutable_data<float>(),
+                         packed_y_->N());
+    } else {
+      auto blas =
+          lite::x86::math::GetBlas<lite::TargetType::kX86, T>(context);
+      blas.MatMul(x_matrix, y_matrix, z);
+    }
     if (z_dim.size() != 2) {
       z->Resize(z_dim);
     }
   }
 
   virtual ~MulCompute() = default;
+
+ private:
+  // The persistable float y packed for the sgemm.
+  std::shared_ptr<const lite::x86::math::PackedGemmWeight> packed_y_;
+  // The y left int8/int4 by the predictor, read by gemm_weight_only.
+  lite::x86::math::QuantizedGemmWeight quantized_y_;
+  // The pruned y in BCSR, see sparse_conv_detect_pass.
+  std::shared_ptr<const lite::x86::math::SparseGemmWeight> sparse_y_;
+};
+
+// mul of the quantized x and y, y being quantized per tensor or per column.
+// A persistable y is packed once.
+template <typename OutType>
+class MulInt8Compute : public KernelLite<TARGET(kX86), PRECISION(kInt8)> {
+ public:
+  using param_t = operators::MulParam;
+
+  void PrepareForRun() override;
+
+  void Run() override;
+
+  virtual ~MulInt8Compute() = default;
+
+ private:
+  // The persistable y packed for the int8 gemm, shared with the kernels of
+  // the cloned predictors.
+  std::shared_ptr<const Tensor> packed_y_;
+};
+
+// mul of the float x and y rounded to bf16, a persistable y is packed once.
+class MulBf16Compute : public KernelLite<TARGET(kX86), PRECISION(kBF16)> {
+ public:
+  using param_t = operators::MulParam;
+
+  void PrepareForRun() override;
+
+  void Run() override;
+
+  virtual ~MulBf16Compute() = default;
+
+ private:
+  // The persistable y packed for gemm_bf16, shared with the kernels of the
+  // cloned predictors.
+  std::shared_ptr<const Tensor> packed_y_;
 };
 
 }  // namespace x86
@@ -14,6 +14,8 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <utility>
@@ -21,6 +23,7 @@
 
 #include "lite/core/op_registry.h"
 #include "lite/kernels/x86/mul_compute.h"
+#include "lite/tests/utils/fill_data.h"
 
 namespace paddle {
 namespace lite {
@@ -80,9 +83,175 @@ TEST(mul_x86, run_test) {
   }
 }
 
+TEST(mul_x86, run_weight_only_quantized) {
+  // y is 5 x 6, quantized to int8 per column or to int4 by groups of 2 rows.
+  const int m = 3, k = 5, n = 6, group_size = 2;
+  std::vector<float> x_data(m * k), y_data(k * n);
+  std::vector<int> q(k * n);
+  for (int i = 0; i < m * k; i++) {
+    x_data[i] = static_cast<float>(i % 7) - 3.f;
+  }
+  for (int bits : {8, 4}) {
+    const int groups = bits == 8 ? 1 : (k + group_size - 1) / group_size;
+    std::vector<float> scales(groups * n);
+    for (size_t i = 0; i < scales.size(); i++) {
+      scales[i] = 0.25f * (i % 3 + 1);
+    }
+    lite::Tensor x, y, out;
+    x.Resize({m, k});
+    std::copy(x_data.begin(), x_data.end(), x.mutable_data<float>());
+    y.Resize({k, bits == 8 ? n : (n + 1) / 2});
+    int8_t* y_quant = y.mutable_data<int8_t>();
+    for (int i = 0; i < k; i++) {
+      for (int j = 0; j < n; j++) {
+        q[i * n + j] = (i * n + j) % 15 - 7;
+        const int group = bits == 8 ? 0 : i / group_size;
+        y_data[i * n + j] = q[i * n + j] * scales[group * n + j];
+        if (bits == 8) {
+          y_quant[i * n + j] = static_cast<int8_t>(q[i * n + j]);
+        }
+      }
+      // Two columns in a byte, the even one in the low nibble.
+      for (int j = 0; bits == 4 && j < n; j += 2) {
+        const int low = q[i * n + j] + 8;
+        const int high = q[i * n + j + 1] + 8;
+        y_quant[i * (n / 2) + j / 2] = static_cast<int8_t>(low | high << 4);
+      }
+    }
+    out.Resize({m, n});
+
+    MulCompute<float> mul;
+    operators::MulParam param;
+    param.x = &x;
+    param.y = &y;
+    param.output = &out;
+    param.weight_quant_bits = bits;
+    param.weight_quant_group_size = bits == 8 ? k : group_size;
+    param.weight_quant_scale = scales;
+
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    mul.SetContext(std::move(ctx));
+    mul.SetParam(param);
+    mul.PrepareForRun();
+    mul.Run();
+
+    const float* out_data = out.data<float>();
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < n; j++) {
+        float ref = 0.f;
+        for (int l = 0; l < k; l++) {
+          ref += x_data[i * k + l] * y_data[l * n + j];
+        }
+        EXPECT_NEAR(out_data[i * n + j], ref, 1e-4) << "bits: " << bits;
+      }
+    }
+  }
+}
+
+TEST(mul_x86, run_sparse_weight) {
+  // The persistable y marked by sparse_conv_detect_pass is run in BCSR.
+  const int k = 9, n = 7;
+  for (int m : {1, 4}) {
+    lite::Tensor x, y, out;
+    x.Resize({m, k});
+    y.Resize({k, n});
+    out.Resize({m, n});
+    float* x_data = x.mutable_data<float>();
+    float* y_data = y.mutable_data<float>();
+    for (int i = 0; i < m * k; i++) {
+      x_data[i] = static_cast<float>(i % 7) - 3.f;
+    }
+    for (int i = 0; i < k * n; i++) {
+      y_data[i] = i % 4 == 0 ? static_cast<float>(i % 5) - 2.f : 0.f;
+    }
+    y.set_persistable(true);
+
+    MulCompute<float> mul;
+    operators::MulParam param;
+    param.x = &x;
+    param.y = &y;
+    param.output = &out;
+    param.sparse_weight = true;
+
+    std::unique_ptr<KernelContext> ctx(new KernelContext);
+    ctx->As<X86Context>();
+    mul.SetContext(std::move(ctx));
+    mul.SetParam(param);
+    mul.PrepareForRun();
+    mul.Run();
+
+    const float* out_data = out.data<float>();
+    for (int i = 0; i < m; i++) {
+      for (int j = 0; j < n; j++) {
+        float ref = 0.f;
+        for (int l = 0; l < k; l++) {
+          ref += x_data[i * k + l] * y_data[l * n + j];
+        }
+        EXPECT_NEAR(out_data[i * n + j], ref, 1e-4) << "m: " << m;
+      }
+    }
+  }
+}
+
+TEST(mul_x86, run_bf16) {
+  // The products of x and y rounded to bf16 summed in fp32, with y float or
+  // converted to bf16 by the predictor, persistable or not.
+  const int k = 37, n = 20;
+  auto round_bf16 = [](float v) { return static_cast<float>(bfloat16(v)); };
+  for (int m : {1, 5}) {
+    for (bool bf16_y : {false, true}) {
+      for (bool persistable : {false, true}) {
+        lite::Tensor x, y, out;
+        x.Resize({m, k});
+        y.Resize({k, n});
+        out.Resize({m, n});
+        std::vector<float> y_data(k * n);
+        fill_data_rand(x.mutable_data<float>(), -1.f, 1.f, m * k);
+        fill_data_rand(y_data.data(), -1.f, 1.f, k * n);
+        if (bf16_y) {
+          bfloat16* y_bf16 = y.mutable_data<bfloat16>();
+          for (int i = 0; i < k * n; i++) y_bf16[i] = bfloat16(y_data[i]);
+        } else {
+          std::copy(y_data.begin(), y_data.end(), y.mutable_data<float>());
+        }
+        y.set_persistable(persistable);
+
+        MulBf16Compute mul;
+        operators::MulParam param;
+        param.x = &x;
+        param.y = &y;
+        param.output = &out;
+        std::unique_ptr<KernelContext> ctx(new KernelContext);
+        ctx->As<X86Context>();
+        mul.SetContext(std::move(ctx));
+        mul.SetParam(param);
+        mul.PrepareForRun();
+        mul.Run();
+
+        const float* x_data = x.data<float>();
+        const float* out_data = out.data<float>();
+        for (int i = 0; i < m; i++) {
+          for (int j = 0; j < n; j++) {
+            float ref = 0.f;
+            for (int l = 0; l < k; l++) {
+              ref += round_bf16(x_data[i * k + l]) *
+                     round_bf16(y_data[l * n + j]);
+            }
+            EXPECT_NEAR(out_data[i * n + j], ref, 1e-4 * (std::fabs(ref) + 1))
+                << "m: " << m << ", bf16 y: " << bf16_y
+                << ", persistable: " << persistable;
+          }
+        }
+      }
+    }
+  }
+}
+
 }  // namespace x86
 }  // namespace kernels
 }  // namespace lite
 }  // namespace paddle
 
 USE_LITE_KERNEL(mul, kX86, kFloat, kNCHW, def);
+USE_LITE_KERNEL(mul, kX86, kBF16, kNCHW, def);
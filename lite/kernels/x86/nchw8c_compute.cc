@@ -0,0 +1,524 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/nchw8c_compute.h"
+#include <cmath>
+#include <cstring>
+#include "lite/backends/x86/math/conv_winograd_fp32.h"
+#include "lite/core/workspace.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+namespace math = lite::x86::math;
+
+namespace {
+
+// The c floats of src padded by zeros to nchw8c_channels(c) into dst.
+void PadChannels(const float* src, int c, Tensor* dst) {
+  dst->Resize({math::nchw8c_channels(c)});
+  float* data = dst->mutable_data<float>();
+  memset(data, 0, sizeof(float) * dst->numel());
+  memcpy(data, src, sizeof(float) * c);
+}
+
+float* MutableNchw8cData(Tensor* tensor) {
+  return tensor->mutable_data<float>(
+      TARGET(kX86), sizeof(float) * math::nchw8c_size(tensor->dims()));
+}
+
+operators::ActivationParam ElementwiseActivation(
+    const operators::ElementwiseParam& param) {
+  return operators::ActivationParam();
+}
+
+operators::ActivationParam ElementwiseActivation(
+    const operators::FusionElementwiseActivationParam& param) {
+  CHECK_EQ(param.act_type, "relu")
+      << "only relu is fused into the nChw8c elementwise";
+  operators::ActivationParam act_param;
+  act_param.has_active = true;
+  act_param.active_type = lite_api::ActivationType::kRelu;
+  return act_param;
+}
+
+}  // namespace
+
+void ConvNchw8cCompute::PrepareForRun() {
+  auto& param = this->Param<param_t>();
+  auto w_dims = param.filter->dims();
+  const int oc = w_dims[0];
+  const int ic = param.x->dims()[1];
+  const int kh = w_dims[2];
+  const int kw = w_dims[3];
+  auto& dilations = *param.dilations;
+  depthwise_ = param.groups > 1;
+  if (depthwise_) {
+    CHECK(param.groups == ic && ic == oc && w_dims[1] == 1)
+        << "only the depthwise conv2d of groups > 1 runs on nChw8c";
+  }
+
+  if (!depthwise_ && kh == 3 && kw == 3 && param.strides[0] == 1 &&
+      param.strides[1] == 1 && dilations[0] == 1 && dilations[1] == 1) {
+    auto o_dims = param.output->dims();
+    out_tile_ =
+        math::conv_winograd_fp32_out_tile(ic, oc, o_dims[2], o_dims[3]);
+  }
+  const float* weights = param.filter->data<float>();
+  if (out_tile_) {
+    weights_.Resize(
+        {math::conv_winograd_fp32_weights_size(out_tile_, ic, oc)});
+    math::conv_winograd_fp32_trans_weights(
+        weights, ic, oc, out_tile_, weights_.mutable_data<float>());
+  } else if (depthwise_) {
+    weights_.Resize({math::nchw8c_channels(oc) * kh * kw});
+    math::conv_depthwise_nchw8c_trans_weights(
+        weights, oc, kh, kw, weights_.mutable_data<float>());
+  } else {
+    weights_.Resize({math::conv_nchw8c_weights_size(oc, ic, kh, kw)});
+    math::conv_nchw8c_trans_weights(
+        weights, oc, ic, kh, kw, weights_.mutable_data<float>());
+  }
+  if (param.bias) {
+    PadChannels(param.bias->data<float>(), oc, &bias_);
+  }
+}
+
+void ConvNchw8cCompute::ReInitWhenNeeded() {
+  if (!out_tile_) return;
+  auto& param = this->Param<param_t>();
+  auto o_dims = param.output->dims();
+  // the transformed tiles, taken from the workspace in Run()
+  WorkSpace::Global_X86().Reserve(
+      math::conv_winograd_fp32_workspace_size(out_tile_,
+                                              param.x->dims()[1],
+                                              o_dims[1],
+                                              o_dims[2],
+                                              o_dims[3]));
+}
+
+void ConvNchw8cCompute::Run() {
+  auto& param = this->Param<param_t>();
+  auto x_dims = param.x->dims();
+  auto o_dims = param.output->dims();
+  auto w_dims = param.filter->dims();
+  auto& paddings = *param.paddings;
+  auto& dilations = *param.dilations;
+  const float* din = param.x->data<float>();
+  const float* bias = param.bias ? bias_.data<float>() : nullptr;
+  float* dout = MutableNchw8cData(param.output);
+
+  if (out_tile_) {
+    math::conv_winograd_fp32_nchw8c(din,
+                                    dout,
+                                    x_dims[0],
+                                    x_dims[1],
+                                    x_dims[2],
+                                    x_dims[3],
+                                    o_dims[1],
+                                    o_dims[2],
+                                    o_dims[3],
+                                    paddings[0],
+                                    paddings[2],
+                                    out_tile_,
+                                    weights_.data<float>(),
+                                    bias);
+    //! the bias is added by the output transform
+    if (param.activation_param.has_active) {
+      math::activation_nchw8c(dout,
+                              dout,
+                              math::nchw8c_size(o_dims),
+                              param.activation_param);
+    }
+  } else if (depthwise_) {
+    math::conv_depthwise_nchw8c(din,
+                                dout,
+                                x_dims[0],
+                                x_dims[1],
+                                x_dims[2],
+                                x_dims[3],
+                                o_dims[2],
+                                o_dims[3],
+                                w_dims[2],
+                                w_dims[3],
+                                param.strides[0],
+                                param.strides[1],
+                                paddings[0],
+                                paddings[2],
+                                dilations[0],
+                                dilations[1],
+                                weights_.data<float>(),
+                                bias,
+                                param.activation_param);
+  } else {
+    math::conv_nchw8c(din,
+                      dout,
+                      x_dims[0],
+                      x_dims[1],
+                      x_dims[2],
+                      x_dims[3],
+                      o_dims[1],
+                      o_dims[2],
+                      o_dims[3],
+                      w_dims[2],
+                      w_dims[3],
+                      param.strides[0],
+                      param.strides[1],
+                      paddings[0],
+                      paddings[2],
+                      dilations[0],
+                      dilations[1],
+                      weights_.data<float>(),
+                      bias,
+                      param.activation_param);
+  }
+}
+
+void PoolNchw8cCompute::Run() {
+  auto& param = this->Param<param_t>();
+  CHECK(!param.adaptive) << "the adaptive pool2d does not run on nChw8c";
+  auto x_dims = param.x->dims();
+  auto o_dims = param.output->dims();
+  if (param.global_pooling) {
+    for (size_t i = 0; i < param.ksize.size(); ++i) {
+      param.ksize[i] = static_cast<int>(x_dims[i + 2]);
+    }
+  }
+  auto& paddings = *param.paddings;
+  math::pool_nchw8c(param.x->data<float>(),
+                    MutableNchw8cData(param.output),
+                    x_dims[0],
+                    x_dims[1],
+                    x_dims[2],
+                    x_dims[3],
+                    o_dims[2],
+                    o_dims[3],
+                    param.ksize[0],
+                    param.ksize[1],
+                    param.strides[0],
+                    param.strides[1],
+                    paddings[0],
+                    paddings[2],
+                    param.pooling_type == "max",
+                    param.exclusive);
+}
+
+void BatchNormNchw8cCompute::PrepareForRun() {
+  auto& param = this->Param<param_t>();
+  const int c = param.scale->numel();
+  const float* scale = param.scale->data<float>();
+  const float* bias = param.bias->data<float>();
+  const float* mean = param.mean->data<float>();
+  const float* variance = param.variance->data<float>();
+  std::vector<float> new_scale(c);
+  std::vector<float> new_bias(c);
+  for (int i = 0; i < c; ++i) {
+    new_scale[i] = scale[i] / std::sqrt(variance[i] + param.epsilon);
+    new_bias[i] = bias[i] - mean[i] * new_scale[i];
+  }
+  PadChannels(new_scale.data(), c, &scale_);
+  PadChannels(new_bias.data(), c, &bias_);
+}
+
+void BatchNormNchw8cCompute::Run() {
+  auto& param = this->Param<param_t>();
+  auto x_dims = param.x->dims();
+  math::scale_bias_nchw8c(param.x->data<float>(),
+                          MutableNchw8cData(param.y),
+                          x_dims[0],
+                          x_dims[1],
+                          x_dims[2] * x_dims[3],
+                          scale_.data<float>(),
+                          bias_.data<float>(),
+                          operators::ActivationParam());
+  // The global statistics are left as they are, MeanOut and VarianceOut of
+  // the programs not marked is_test are them.
+  if (param.mean_out && param.mean_out != param.mean) {
+    param.mean_out->CopyDataFrom(*param.mean);
+  }
+  if (param.variance_out && param.variance_out != param.variance) {
+    param.variance_out->CopyDataFrom(*param.variance);
+  }
+}
+
+template <typename ParamT, math::ElementwiseNchw8cType Type>
+void ElementwiseNchw8cCompute<ParamT, Type>::Run() {
+  auto& param = this->template Param<param_t>();
+  auto x_dims = param.X->dims();
+  auto y_dims = param.Y->dims();
+  const bool y_broadcast = x_dims != y_dims;
+  if (y_broadcast) {
+    CHECK(y_dims.size() == 4 && y_dims[0] == x_dims[0] &&
+          y_dims[1] == x_dims[1] && y_dims[2] == 1 && y_dims[3] == 1)
+        << "the y of the nChw8c elementwise should be of the dims of x or of "
+           "num x c x 1 x 1, but received "
+        << y_dims;
+  }
+  math::elementwise_nchw8c(param.X->template data<float>(),
+                           param.Y->template data<float>(),
+                           MutableNchw8cData(param.Out),
+                           x_dims[0],
+                           x_dims[1],
+                           x_dims[2] * x_dims[3],
+                           y_broadcast,
+                           Type,
+                           ElementwiseActivation(param));
+}
+
+void ActivationNchw8cCompute::Run() {
+  auto& param = this->Param<param_t>();
+  operators::ActivationParam act_param = param;
+  act_param.has_active = true;
+  if (act_param.active_type == lite_api::ActivationType::kRelu6) {
+    act_param.Relu_clipped_coef = param.threshold;
+  }
+  math::activation_nchw8c(param.X->data<float>(),
+                          MutableNchw8cData(param.Out),
+                          math::nchw8c_size(param.X->dims()),
+                          act_param);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+using ConvNchw8c = paddle::lite::kernels::x86::ConvNchw8cCompute;
+using PoolNchw8c = paddle::lite::kernels::x86::PoolNchw8cCompute;
+using BatchNormNchw8c = paddle::lite::kernels::x86::BatchNormNchw8cCompute;
+using ActivationNchw8c = paddle::lite::kernels::x86::ActivationNchw8cCompute;
+using ElementwiseNchw8cType = paddle::lite::x86::math::ElementwiseNchw8cType;
+using ElementwiseParam = paddle::lite::operators::ElementwiseParam;
+using FusionParam = paddle::lite::operators::FusionElementwiseActivationParam;
+using AddNchw8c = paddle::lite::kernels::x86::
+    ElementwiseNchw8cCompute<ElementwiseParam, ElementwiseNchw8cType::kAdd>;
+using SubNchw8c = paddle::lite::kernels::x86::
+    ElementwiseNchw8cCompute<ElementwiseParam, ElementwiseNchw8cType::kSub>;
+using MulNchw8c = paddle::lite::kernels::x86::
+    ElementwiseNchw8cCompute<ElementwiseParam, ElementwiseNchw8cType::kMul>;
+using AddActNchw8c = paddle::lite::kernels::x86::
+    ElementwiseNchw8cCompute<FusionParam, ElementwiseNchw8cType::kAdd>;
+using SubActNchw8c = paddle::lite::kernels::x86::
+    ElementwiseNchw8cCompute<FusionParam, ElementwiseNchw8cType::kSub>;
+using MulActNchw8c = paddle::lite::kernels::x86::
+    ElementwiseNchw8cCompute<FusionParam, ElementwiseNchw8cType::kMul>;
+
+REGISTER_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW8c, ConvNchw8c, def)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Filter", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .BindPaddleOpVersion("conv2d", 1)
+    .Finalize();
+
+REGISTER_LITE_KERNEL(depthwise_conv2d, kX86, kFloat, kNCHW8c, ConvNchw8c, def)
+    .BindInput("Input",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Filter", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Output",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .BindPaddleOpVersion("depthwise_conv2d", 1)
+    .Finalize();
+
+REGISTER_LITE_KERNEL(pool2d, kX86, kFloat, kNCHW8c, PoolNchw8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(batch_norm, kX86, kFloat, kNCHW8c, BatchNormNchw8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Scale", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Mean", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Variance", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Y",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .BindOutput("MeanOut", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("VarianceOut", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("SavedMean", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("SavedVariance", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_add, kX86, kFloat, kNCHW8c, AddNchw8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_sub, kX86, kFloat, kNCHW8c, SubNchw8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(elementwise_mul, kX86, kFloat, kNCHW8c, MulNchw8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(fusion_elementwise_add_activation,
+                     kX86,
+                     kFloat,
+                     kNCHW8c,
+                     AddActNchw8c,
+                     def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(fusion_elementwise_sub_activation,
+                     kX86,
+                     kFloat,
+                     kNCHW8c,
+                     SubActNchw8c,
+                     def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(fusion_elementwise_mul_activation,
+                     kX86,
+                     kFloat,
+                     kNCHW8c,
+                     MulActNchw8c,
+                     def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindInput("Y",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(relu, kX86, kFloat, kNCHW8c, ActivationNchw8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(relu6, kX86, kFloat, kNCHW8c, ActivationNchw8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(leaky_relu, kX86, kFloat, kNCHW8c, ActivationNchw8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
+
+REGISTER_LITE_KERNEL(hard_swish, kX86, kFloat, kNCHW8c, ActivationNchw8c, def)
+    .BindInput("X",
+               {LiteType::GetTensorTy(TARGET(kX86),
+                                      PRECISION(kFloat),
+                                      DATALAYOUT(kNCHW8c))})
+    .BindOutput("Out",
+                {LiteType::GetTensorTy(TARGET(kX86),
+                                       PRECISION(kFloat),
+                                       DATALAYOUT(kNCHW8c))})
+    .Finalize();
@@ -0,0 +1,91 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "lite/backends/x86/math/avx/nchw8c.h"
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// The kernels on the nChw8c images, picked by x86_nchw8c_layout_pass for
+// the ops between a conv2d and the layout ops it inserts, see nchw8c.h.
+using Nchw8cKernel =
+    KernelLite<TARGET(kX86), PRECISION(kFloat), DATALAYOUT(kNCHW8c)>;
+
+// conv2d of one group and depthwise_conv2d, by Winograd for the 3x3 stride 1
+// ones conv_winograd_fp32_out_tile picks.
+class ConvNchw8cCompute : public Nchw8cKernel {
+ public:
+  using param_t = operators::ConvParam;
+  void PrepareForRun() override;
+  void ReInitWhenNeeded() override;
+  void Run() override;
+  virtual ~ConvNchw8cCompute() = default;
+
+ private:
+  bool depthwise_{false};
+  int out_tile_{0};
+  Tensor weights_;
+  Tensor bias_;
+};
+
+class PoolNchw8cCompute : public Nchw8cKernel {
+ public:
+  using param_t = operators::PoolParam;
+  void Run() override;
+  virtual ~PoolNchw8cCompute() = default;
+};
+
+// The inference batch_norm, y = x * scale + bias of the per channel scale
+// and bias folded in PrepareForRun. MeanOut and VarianceOut, if any, are
+// copies of Mean and Variance.
+class BatchNormNchw8cCompute : public Nchw8cKernel {
+ public:
+  using param_t = operators::BatchNormParam;
+  void PrepareForRun() override;
+  void Run() override;
+  virtual ~BatchNormNchw8cCompute() = default;
+
+ private:
+  Tensor scale_;
+  Tensor bias_;
+};
+
+// elementwise_add, sub and mul and their fusion_elementwise_*_activation of
+// relu, y being of the dims of x or of num x c x 1 x 1.
+template <typename ParamT, lite::x86::math::ElementwiseNchw8cType Type>
+class ElementwiseNchw8cCompute : public Nchw8cKernel {
+ public:
+  using param_t = ParamT;
+  void Run() override;
+  virtual ~ElementwiseNchw8cCompute() = default;
+};
+
+// relu, relu6, leaky_relu and hard_swish.
+class ActivationNchw8cCompute : public Nchw8cKernel {
+ public:
+  using param_t = operators::ActivationParam;
+  void Run() override;
+  virtual ~ActivationNchw8cCompute() = default;
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,381 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lite/core/op_registry.h"
+#include "lite/kernels/x86/layout_compute.h"
+#include "lite/kernels/x86/nchw8c_compute.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+template <typename KernelT, typename ParamT>
+static void RunKernel(KernelT* kernel, const ParamT& param) {
+  std::unique_ptr<KernelContext> ctx(new KernelContext);
+  ctx->As<X86Context>();
+  kernel->SetContext(std::move(ctx));
+  kernel->SetParam(param);
+  kernel->Launch();
+}
+
+static void Fill(lite::Tensor* tensor, int seed) {
+  float* data = tensor->mutable_data<float>();
+  for (int64_t i = 0; i < tensor->numel(); i++) {
+    data[i] = static_cast<float>((i * 7 + seed) % 19) / 9.f - 1.f;
+  }
+}
+
+static void ToNchw8c(const lite::Tensor& x, lite::Tensor* out) {
+  NCHWToNCHW8cCompute kernel;
+  operators::LayoutParam param;
+  param.x = &x;
+  param.y = out;
+  RunKernel(&kernel, param);
+}
+
+static void ToNchw(const lite::Tensor& x, lite::Tensor* out) {
+  NCHW8cToNCHWCompute kernel;
+  operators::LayoutParam param;
+  param.x = &x;
+  param.y = out;
+  RunKernel(&kernel, param);
+}
+
+static float Activate(float x, const operators::ActivationParam& act) {
+  if (!act.has_active) return x;
+  switch (act.active_type) {
+    case lite_api::ActivationType::kRelu:
+      return std::max(x, 0.f);
+    case lite_api::ActivationType::kRelu6:
+      return std::min(std::max(x, 0.f), act.Relu_clipped_coef);
+    case lite_api::ActivationType::kLeakyRelu:
+      return x > 0.f ? x : x * act.Leaky_relu_alpha;
+    case lite_api::ActivationType::kHardSwish:
+      return std::min(act.hard_swish_threshold,
+                      std::max(0.f, x + act.hard_swish_offset)) *
+             x / act.hard_swish_scale;
+    default:
+      return x;
+  }
+}
+
+static void ExpectNear(const lite::Tensor& out, const lite::Tensor& ref) {
+  ASSERT_EQ(out.dims(), ref.dims());
+  const float* out_data = out.data<float>();
+  const float* ref_data = ref.data<float>();
+  for (int64_t i = 0; i < out.numel(); i++) {
+    ASSERT_NEAR(out_data[i], ref_data[i], 1e-3 * (1 + fabs(ref_data[i])))
+        << "at " << i;
+  }
+}
+
+TEST(nchw8c_x86, layout) {
+  lite::Tensor x, blocked, out;
+  x.Resize({2, 13, 5, 7});
+  Fill(&x, 0);
+  ToNchw8c(x, &blocked);
+  const float* data = blocked.data<float>();
+  for (int n = 0; n < 2; n++) {
+    for (int c = 13; c < 16; c++) {
+      for (int i = 0; i < 35; i++) {
+        ASSERT_EQ(data[((n * 2 + c / 8) * 35 + i) * 8 + c % 8], 0.f);
+      }
+    }
+  }
+  ToNchw(blocked, &out);
+  ExpectNear(out, x);
+}
+
+TEST(nchw8c_x86, conv) {
+  // num, ic, oc, groups, ih, iw, kernel, stride, pad, dilation
+  const std::vector<std::vector<int>> shapes{
+      {1, 16, 16, 1, 8, 8, 3, 1, 1, 1},
+      {2, 13, 21, 1, 11, 9, 3, 2, 1, 1},
+      {1, 8, 24, 1, 12, 14, 5, 1, 2, 2},
+      {1, 19, 7, 1, 7, 30, 1, 1, 0, 1},
+      {1, 32, 40, 1, 40, 40, 3, 1, 1, 1},
+      {2, 20, 20, 20, 9, 13, 3, 1, 1, 1},
+      {1, 24, 24, 24, 15, 8, 3, 2, 1, 1},
+      {1, 16, 16, 16, 11, 11, 5, 1, 2, 1}};
+  const lite_api::ActivationType acts[] = {
+      lite_api::ActivationType::kIndentity,
+      lite_api::ActivationType::kRelu,
+      lite_api::ActivationType::kRelu6,
+      lite_api::ActivationType::kLeakyRelu,
+      lite_api::ActivationType::kHardSwish};
+  int seed = 0;
+  for (auto& shape : shapes) {
+    const int num = shape[0];
+    const int ic = shape[1];
+    const int oc = shape[2];
+    const int groups = shape[3];
+    const int ih = shape[4];
+    const int iw = shape[5];
+    const int k = shape[6];
+    const int stride = shape[7];
+    const int pad = shape[8];
+    const int dilation = shape[9];
+    const int oh = (ih + 2 * pad - dilation * (k - 1) - 1) / stride + 1;
+    const int ow = (iw + 2 * pad - dilation * (k - 1) - 1) / stride + 1;
+    const int icg = ic / groups;
+    const int ocg = oc / groups;
+    lite::Tensor x, filter, bias, ref;
+    x.Resize({num, ic, ih, iw});
+    filter.Resize({oc, icg, k, k});
+    bias.Resize({oc});
+    ref.Resize({num, oc, oh, ow});
+    Fill(&x, seed++);
+    Fill(&filter, seed++);
+    Fill(&bias, seed++);
+
+    operators::ActivationParam act;
+    act.has_active = acts[seed % 5] != lite_api::ActivationType::kIndentity;
+    act.active_type = acts[seed % 5];
+    act.Relu_clipped_coef = 1.f;
+    act.Leaky_relu_alpha = 0.1f;
+
+    const float* x_data = x.data<float>();
+    const float* w_data = filter.data<float>();
+    float* ref_data = ref.mutable_data<float>();
+    for (int n = 0; n < num; n++) {
+      for (int o = 0; o < oc; o++) {
+        const int g = o / ocg;
+        for (int oy = 0; oy < oh; oy++) {
+          for (int ox = 0; ox < ow; ox++) {
+            float sum = bias.data<float>()[o];
+            for (int i = 0; i < icg; i++) {
+              for (int ky = 0; ky < k; ky++) {
+                for (int kx = 0; kx < k; kx++) {
+                  const int iy = oy * stride - pad + ky * dilation;
+                  const int ix = ox * stride - pad + kx * dilation;
+                  if (iy < 0 || iy >= ih || ix < 0 || ix >= iw) continue;
+                  sum += x_data[((n * ic + g * icg + i) * ih + iy) * iw + ix] *
+                         w_data[((o * icg + i) * k + ky) * k + kx];
+                }
+              }
+            }
+            ref_data[((n * oc + o) * oh + oy) * ow + ox] = Activate(sum, act);
+          }
+        }
+      }
+    }
+
+    lite::Tensor x8c, out8c, out;
+    ToNchw8c(x, &x8c);
+    out8c.Resize({num, oc, oh, ow});
+    ConvNchw8cCompute conv;
+    operators::ConvParam param;
+    param.x = &x8c;
+    param.filter = &filter;
+    param.bias = &bias;
+    param.output = &out8c;
+    param.strides = {stride, stride};
+    param.groups = groups;
+    param.paddings =
+        std::make_shared<std::vector<int>>(std::vector<int>(4, pad));
+    param.dilations = std::make_shared<std::vector<int>>(
+        std::vector<int>({dilation, dilation}));
+    param.activation_param = act;
+    RunKernel(&conv, param);
+    ToNchw(out8c, &out);
+    ExpectNear(out, ref);
+  }
+}
+
+TEST(nchw8c_x86, pool) {
+  lite::Tensor x, x8c;
+  x.Resize({2, 11, 9, 10});
+  Fill(&x, 3);
+  ToNchw8c(x, &x8c);
+  // kernel, stride, pad, is_max, exclusive, global
+  const std::vector<std::vector<int>> configs{{2, 2, 0, 1, 1, 0},
+                                              {3, 2, 1, 1, 1, 0},
+                                              {3, 2, 1, 0, 1, 0},
+                                              {3, 2, 1, 0, 0, 0},
+                                              {1, 1, 0, 0, 1, 1}};
+  for (auto& config : configs) {
+    const bool global = config[5];
+    const int kh = global ? 9 : config[0];
+    const int kw = global ? 10 : config[0];
+    const int stride = config[1];
+    const int pad = config[2];
+    const int oh = (9 + 2 * pad - kh) / stride + 1;
+    const int ow = (10 + 2 * pad - kw) / stride + 1;
+    lite::Tensor ref, out8c, out;
+    ref.Resize({2, 11, oh, ow});
+    const float* x_data = x.data<float>();
+    float* ref_data = ref.mutable_data<float>();
+    for (int nc = 0; nc < 22; nc++) {
+      for (int oy = 0; oy < oh; oy++) {
+        for (int ox = 0; ox < ow; ox++) {
+          const int y0 = oy * stride - pad;
+          const int x0 = ox * stride - pad;
+          const int y1 = std::min(y0 + kh, 9 + pad);
+          const int x1 = std::min(x0 + kw, 10 + pad);
+          float v = config[3] ? -1e10f : 0.f;
+          int count = 0;
+          for (int y = std::max(y0, 0); y < std::min(y1, 9); y++) {
+            for (int x = std::max(x0, 0); x < std::min(x1, 10); x++) {
+              const float in = x_data[(nc * 9 + y) * 10 + x];
+              v = config[3] ? std::max(v, in) : v + in;
+              count++;
+            }
+          }
+          if (!config[3]) {
+            v /= config[4] ? count : (y1 - y0) * (x1 - x0);
+          }
+          ref_data[(nc * oh + oy) * ow + ox] = v;
+        }
+      }
+    }
+
+    out8c.Resize({2, 11, oh, ow});
+    PoolNchw8cCompute pool;
+    operators::PoolParam param;
+    param.x = &x8c;
+    param.output = &out8c;
+    param.pooling_type = config[3] ? "max" : "avg";
+    param.ksize = {kh, kw};
+    param.global_pooling = global;
+    param.strides = {stride, stride};
+    param.paddings =
+        std::make_shared<std::vector<int>>(std::vector<int>(4, pad));
+    param.exclusive = config[4];
+    RunKernel(&pool, param);
+    ToNchw(out8c, &out);
+    ExpectNear(out, ref);
+  }
+}
+
+TEST(nchw8c_x86, batch_norm) {
+  const int c = 12;
+  lite::Tensor x, scale, bias, mean, variance, x8c, out8c, out, ref;
+  lite::Tensor mean_out, variance_out;
+  x.Resize({2, c, 5, 6});
+  for (auto* t : {&scale, &bias, &mean, &variance}) {
+    t->Resize({c});
+  }
+  Fill(&x, 1);
+  Fill(&scale, 2);
+  Fill(&bias, 3);
+  Fill(&mean, 4);
+  float* var_data = variance.mutable_data<float>();
+  for (int i = 0; i < c; i++) {
+    var_data[i] = 0.5f + i * 0.1f;
+  }
+  ref.Resize(x.dims());
+  float* ref_data = ref.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    const int ch = (i / 30) % c;
+    ref_data[i] = (x.data<float>()[i] - mean.data<float>()[ch]) /
+                      std::sqrt(var_data[ch] + 1e-5f) *
+                      scale.data<float>()[ch] +
+                  bias.data<float>()[ch];
+  }
+
+  ToNchw8c(x, &x8c);
+  out8c.Resize(x.dims());
+  BatchNormNchw8cCompute bn;
+  operators::BatchNormParam param;
+  param.x = &x8c;
+  param.scale = &scale;
+  param.bias = &bias;
+  param.mean = &mean;
+  param.variance = &variance;
+  param.y = &out8c;
+  param.mean_out = &mean_out;
+  param.variance_out = &variance_out;
+  param.epsilon = 1e-5f;
+  RunKernel(&bn, param);
+  ToNchw(out8c, &out);
+  ExpectNear(out, ref);
+  ExpectNear(mean_out, mean);
+  ExpectNear(variance_out, variance);
+}
+
+TEST(nchw8c_x86, elementwise) {
+  lite::Tensor x, x8c;
+  x.Resize({2, 10, 4, 5});
+  Fill(&x, 5);
+  ToNchw8c(x, &x8c);
+  for (bool broadcast : {false, true}) {
+    lite::Tensor y, y8c, ref, out8c, out;
+    if (broadcast) {
+      y.Resize({2, 10, 1, 1});
+    } else {
+      y.Resize(x.dims());
+    }
+    Fill(&y, 6);
+    ToNchw8c(y, &y8c);
+    ref.Resize(x.dims());
+    float* ref_data = ref.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); i++) {
+      const float y_value = y.data<float>()[broadcast ? i / 20 : i];
+      ref_data[i] = std::max(x.data<float>()[i] - y_value, 0.f);
+    }
+
+    out8c.Resize(x.dims());
+    ElementwiseNchw8cCompute<operators::FusionElementwiseActivationParam,
+                             lite::x86::math::ElementwiseNchw8cType::kSub>
+        sub;
+    operators::FusionElementwiseActivationParam param;
+    param.X = &x8c;
+    param.Y = &y8c;
+    param.Out = &out8c;
+    param.act_type = "relu";
+    RunKernel(&sub, param);
+    ToNchw(out8c, &out);
+    ExpectNear(out, ref);
+  }
+}
+
+TEST(nchw8c_x86, activation) {
+  lite::Tensor x, x8c, ref, out8c, out;
+  x.Resize({1, 9, 7, 3});
+  Fill(&x, 7);
+  ToNchw8c(x, &x8c);
+  ref.Resize(x.dims());
+  float* ref_data = ref.mutable_data<float>();
+  for (int64_t i = 0; i < x.numel(); i++) {
+    ref_data[i] = std::min(std::max(x.data<float>()[i], 0.f), 0.5f);
+  }
+
+  out8c.Resize(x.dims());
+  ActivationNchw8cCompute relu6;
+  operators::ActivationParam param;
+  param.X = &x8c;
+  param.Out = &out8c;
+  param.active_type = lite_api::ActivationType::kRelu6;
+  param.threshold = 0.5f;
+  RunKernel(&relu6, param);
+  ToNchw(out8c, &out);
+  ExpectNear(out, ref);
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(conv2d, kX86, kFloat, kNCHW8c, def);
+USE_LITE_KERNEL(layout, kX86, kFloat, kNCHW, nchw2nchw8c);
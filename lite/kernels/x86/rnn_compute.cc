@@ -296,9 +296,11 @@ static void lstm_cell(X86Context* ctx,
   auto w_data = weight_hh->data<float>();
   auto h_data = init_h->data<float>();
 
-  Tensor tmp_gate;
-  tmp_gate.Resize(input->dims());
-  auto tmp_data = tmp_gate.mutable_data<float>();
+  // lstm_cell runs once per time step, the temporaries are taken from the
+  // workspace and given back on return.
+  auto& workspace = WorkSpace::Global_X86();
+  size_t workspace_mark = workspace.cursor();
+  auto tmp_data = workspace.Alloc<float>(input->dims().production());
 
   lite::x86::math::Blas<lite::TargetType::kX86> matmul(*ctx);
   matmul.GEMM<float>(
@@ -307,12 +309,9 @@ static void lstm_cell(X86Context* ctx,
     tmp_data[i] += i_data[i];
   }
 
-  Tensor tmp_init_c;
-  tmp_init_c.Resize(init_c->dims());
-  auto tmp_init_c_data = tmp_init_c.mutable_data<float>();
-  for (int i = 0; i < tmp_init_c.dims()[0] * tmp_init_c.dims()[1]; i++) {
-    tmp_init_c_data[i] = init_c->data<float>()[i];
-  }
+  int64_t init_c_size = init_c->dims()[0] * init_c->dims()[1];
+  auto tmp_init_c_data = workspace.Alloc<float>(init_c_size);
+  memcpy(tmp_init_c_data, init_c->data<float>(), init_c_size * sizeof(float));
 
   lite::x86::math::LstmMetaValue<float> lstm_value;
   lstm_value.check_ig = nullptr;
@@ -324,18 +323,13 @@ static void lstm_cell(X86Context* ctx,
 
   size_t frame_size = init_h->dims()[1];
   size_t batch_size = init_h->dims()[0];
-  Tensor cell_pre_act;
-  if (last_c_act == nullptr) {
-    cell_pre_act.Resize(init_h->dims());
-    cell_pre_act.mutable_data<float>();
-    last_c_act = &cell_pre_act;
-  }
-
   lstm_value.prev_state_value = tmp_init_c_data;
   lstm_value.gate_value = tmp_data;
   lstm_value.output_value = output->mutable_data<float>();
   lstm_value.state_value = last_c->mutable_data<float>();
-  lstm_value.state_active_value = last_c_act->mutable_data<float>();
+  lstm_value.state_active_value =
+      last_c_act ? last_c_act->mutable_data<float>()
+                 : workspace.Alloc<float>(init_h->dims().production());
   float cell_clip = 0.0;
   lite::x86::math::RnnLstmUnitFunctor<float>::compute(lstm_value,
                                                       frame_size,
@@ -345,6 +339,7 @@ static void lstm_cell(X86Context* ctx,
                                                       gate_act,
                                                       cell_act,
                                                       1);
+  workspace.Rewind(workspace_mark);
 }
 
 static void gru_cell(X86Context* ctx,
@@ -367,9 +362,9 @@ static void gru_cell(X86Context* ctx,
   auto w_gru = weight_hh_gru->data<float>();
   auto h_data = init_h->data<float>();
 
-  Tensor tmp_gate;
-  tmp_gate.Resize(input->dims());
-  auto tmp_data = tmp_gate.mutable_data<float>();
+  auto& workspace = WorkSpace::Global_X86();
+  size_t workspace_mark = workspace.cursor();
+  auto tmp_data = workspace.Alloc<float>(input->dims().production());
 
   lite::x86::math::Blas<lite::TargetType::kX86> matmul(*ctx);
   matmul.GEMM<float>(
@@ -397,6 +392,7 @@ static void gru_cell(X86Context* ctx,
 
   lite::x86::math::RnnGruUnitFunctorV2<float>::compute(
       ctx, gru_value, frame_size, batch_size, cand_act, gate_act);
+  workspace.Rewind(workspace_mark);
 }
 
 static void RunRnnLayer(X86Context* ctx,
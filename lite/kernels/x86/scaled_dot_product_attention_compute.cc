@@ -0,0 +1,123 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/scaled_dot_product_attention_compute.h"
+#include "lite/backends/x86/math/flash_attention.h"
+#include "lite/core/workspace.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void ScaledDotProductAttentionCompute::ReInitWhenNeeded() {
+  auto& param = this->Param<param_t>();
+  const auto& q_dims = param.Q->dims();
+  DDim mask_dims = param.Mask ? param.Mask->dims() : DDim();
+  if (last_q_dims_ == q_dims && last_mask_dims_ == mask_dims) return;
+  last_q_dims_ = q_dims;
+  last_mask_dims_ = mask_dims;
+
+  const int rank = q_dims.size();
+  const int S = q_dims[rank - 2];
+  const int D = q_dims[rank - 1];
+  const int batch = q_dims.count(0, rank - 2);
+  const auto& v_dims = param.V->dims();
+  const int Dv = v_dims[v_dims.size() - 1];
+  WorkSpace::Global_X86().Reserve(
+      lite::x86::math::attention_fp32_workspace_size(batch, S, D, Dv));
+
+  mask_offsets_.clear();
+  if (!param.Mask) return;
+  // The strides of the mask aligned to the scores, [q_dims[0 : rank - 1],
+  // Sk], 0 along the dimensions it is broadcast.
+  const int mask_rank = mask_dims.size();
+  const int axis = param.mask_axis == -1 ? rank - mask_rank : param.mask_axis;
+  std::vector<int64_t> strides(rank, 0);
+  int64_t stride = 1;
+  for (int i = mask_rank - 1; i >= 0; --i) {
+    if (mask_dims[i] != 1) strides[axis + i] = stride;
+    stride *= mask_dims[i];
+  }
+  mask_row_stride_ = strides[rank - 2];
+  mask_col_stride_ = strides[rank - 1];
+  mask_offsets_.resize(batch);
+  for (int b = 0; b < batch; ++b) {
+    int64_t offset = 0;
+    int index = b;
+    for (int i = rank - 3; i >= 0; --i) {
+      offset += (index % q_dims[i]) * strides[i];
+      index /= q_dims[i];
+    }
+    mask_offsets_[b] = offset;
+  }
+}
+
+void ScaledDotProductAttentionCompute::Run() {
+  auto& param = this->Param<param_t>();
+  const auto& q_dims = param.Q->dims();
+  const auto& k_dims = param.K->dims();
+  const auto& v_dims = param.V->dims();
+  const int rank = q_dims.size();
+  const int k_rank = k_dims.size();
+  const int v_rank = v_dims.size();
+  const int S = q_dims[rank - 2];
+  const int D = q_dims[rank - 1];
+  const int Sk = param.transpose_K ? k_dims[k_rank - 2] : k_dims[k_rank - 1];
+  const int Dv = v_dims[v_rank - 1];
+  const int batch = q_dims.count(0, rank - 2);
+
+  // K and V of rank 2 are shared by the whole batch.
+  lite::x86::math::AttentionMask mask;
+  if (param.Mask) {
+    mask.data = param.Mask->data<float>();
+    mask.offsets = mask_offsets_.data();
+    mask.row_stride = mask_row_stride_;
+    mask.col_stride = mask_col_stride_;
+  }
+  lite::x86::math::attention_fp32(
+      batch,
+      S,
+      Sk,
+      D,
+      Dv,
+      param.Q->data<float>(),
+      static_cast<int64_t>(S) * D,
+      param.K->data<float>(),
+      k_rank == rank ? static_cast<int64_t>(Sk) * D : 0,
+      param.transpose_K,
+      param.V->data<float>(),
+      v_rank == rank ? static_cast<int64_t>(Sk) * Dv : 0,
+      mask,
+      param.alpha,
+      param.out_scale,
+      param.Out->mutable_data<float>());
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+typedef paddle::lite::kernels::x86::ScaledDotProductAttentionCompute
+    SdpaCompute;
+
+REGISTER_LITE_KERNEL(
+    scaled_dot_product_attention, kX86, kFloat, kNCHW, SdpaCompute, def)
+    .BindInput("Q", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("K", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("V", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("Mask", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Out", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
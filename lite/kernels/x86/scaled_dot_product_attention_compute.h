@@ -0,0 +1,51 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <vector>
+#include "lite/core/kernel.h"
+#include "lite/core/op_registry.h"
+#include "lite/operators/op_params.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+class ScaledDotProductAttentionCompute
+    : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
+ public:
+  using param_t = operators::ScaledDotProductAttentionParam;
+
+  void ReInitWhenNeeded() override;
+
+  void Run() override;
+
+  virtual ~ScaledDotProductAttentionCompute() = default;
+
+ private:
+  DDim last_q_dims_;
+  DDim last_mask_dims_;
+  // Where the mask of every attention of the batch starts, and its strides
+  // along the rows and the columns of the scores.
+  std::vector<int64_t> mask_offsets_;
+  int64_t mask_row_stride_{0};
+  int64_t mask_col_stride_{0};
+};
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
@@ -0,0 +1,190 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/kernels/x86/scaled_dot_product_attention_compute.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// softmax(alpha * q * k^T + mask) * v * out_scale of the batch of `heads`,
+// k and v being shared by the batch when their rank is 2 and the mask
+// broadcast along its dims of 1.
+void attention_basic(const Tensor& q,
+                     const Tensor& k,
+                     const Tensor& v,
+                     const Tensor* mask,
+                     bool transpose_k,
+                     float alpha,
+                     float out_scale,
+                     Tensor* out) {
+  const auto& q_dims = q.dims();
+  const int rank = q_dims.size();
+  const int S = q_dims[rank - 2];
+  const int D = q_dims[rank - 1];
+  const int Sk = v.dims()[v.dims().size() - 2];
+  const int Dv = v.dims()[v.dims().size() - 1];
+  const int batch = q_dims.count(0, rank - 2);
+  const int k_batch = k.dims().size() == 2 ? 1 : batch;
+  const int v_batch = v.dims().size() == 2 ? 1 : batch;
+  auto mask_dims = mask ? mask->dims() : DDim();
+  const int mask_offset = rank - static_cast<int>(mask_dims.size());
+  std::vector<float> scores(Sk);
+  for (int b = 0; b < batch; ++b) {
+    const float* q_data = q.data<float>() + b * S * D;
+    const float* k_data = k.data<float>() + (b % k_batch) * Sk * D;
+    const float* v_data = v.data<float>() + (b % v_batch) * Sk * Dv;
+    float* out_data = out->mutable_data<float>() + b * S * Dv;
+    for (int i = 0; i < S; ++i) {
+      float max_score = -INFINITY;
+      for (int j = 0; j < Sk; ++j) {
+        float sum = 0.f;
+        for (int d = 0; d < D; ++d) {
+          sum += q_data[i * D + d] *
+                 (transpose_k ? k_data[j * D + d] : k_data[d * Sk + j]);
+        }
+        scores[j] = alpha * sum;
+        if (mask) {
+          // The index of the mask of [b..., i, j].
+          std::vector<int64_t> index(rank);
+          int rest = b;
+          for (int r = rank - 3; r >= 0; --r) {
+            index[r] = rest % q_dims[r];
+            rest /= q_dims[r];
+          }
+          index[rank - 2] = i;
+          index[rank - 1] = j;
+          int64_t offset = 0;
+          for (size_t r = 0; r < mask_dims.size(); ++r) {
+            int64_t idx = mask_dims[r] == 1 ? 0 : index[mask_offset + r];
+            offset = offset * mask_dims[r] + idx;
+          }
+          scores[j] += mask->data<float>()[offset];
+        }
+        max_score = std::max(max_score, scores[j]);
+      }
+      float sum = 0.f;
+      for (int j = 0; j < Sk; ++j) {
+        scores[j] = std::exp(scores[j] - max_score);
+        sum += scores[j];
+      }
+      for (int c = 0; c < Dv; ++c) {
+        float acc = 0.f;
+        for (int j = 0; j < Sk; ++j) {
+          acc += scores[j] * v_data[j * Dv + c];
+        }
+        out_data[i * Dv + c] = acc / sum * out_scale;
+      }
+    }
+  }
+}
+
+TEST(scaled_dot_product_attention_x86, retrive_op) {
+  auto kernel =
+      KernelRegistry::Global().Create("scaled_dot_product_attention");
+  ASSERT_FALSE(kernel.empty());
+  ASSERT_TRUE(kernel.front());
+}
+
+TEST(scaled_dot_product_attention_x86, init) {
+  ScaledDotProductAttentionCompute kernel;
+  ASSERT_EQ(kernel.precision(), PRECISION(kFloat));
+  ASSERT_EQ(kernel.target(), TARGET(kX86));
+}
+
+TEST(scaled_dot_product_attention_x86, run_test) {
+  const int batch = 2, heads = 3, D = 20, Dv = 24;
+  for (int S : {1, 9, 70}) {
+    for (int Sk : {1, 33, 130}) {
+      for (bool transpose_k : {true, false}) {
+        for (bool shared_kv : {false, true}) {
+          // No mask, the padding mask of BERT and a mask of the rows.
+          for (int mask_type : {0, 1, 2}) {
+            Tensor q, k, v, mask, out, out_ref;
+            q.Resize({batch, heads, S, D});
+            if (shared_kv) {
+              k.Resize(transpose_k ? DDim({Sk, D}) : DDim({D, Sk}));
+              v.Resize({Sk, Dv});
+            } else {
+              k.Resize(transpose_k ? DDim({batch, heads, Sk, D})
+                                   : DDim({batch, heads, D, Sk}));
+              v.Resize({batch, heads, Sk, Dv});
+            }
+            mask.Resize(mask_type == 1 ? DDim({batch, 1, 1, Sk})
+                                       : DDim({S, Sk}));
+            out.Resize({batch, heads, S, Dv});
+            out_ref.Resize({batch, heads, S, Dv});
+            for (auto* t : {&q, &k, &v}) {
+              fill_data_rand(
+                  t->mutable_data<float>(), -1.f, 1.f, t->numel());
+            }
+            fill_data_rand(
+                mask.mutable_data<float>(), -10.f, 0.f, mask.numel());
+
+            ScaledDotProductAttentionCompute kernel;
+            operators::ScaledDotProductAttentionParam param;
+            param.Q = &q;
+            param.K = &k;
+            param.V = &v;
+            param.Mask = mask_type ? &mask : nullptr;
+            param.Out = &out;
+            param.transpose_K = transpose_k;
+            param.alpha = 0.25f;
+            param.out_scale = 0.5f;
+            std::unique_ptr<KernelContext> ctx(new KernelContext);
+            ctx->As<X86Context>();
+            kernel.SetContext(std::move(ctx));
+            kernel.SetParam(param);
+            kernel.ReInitWhenNeeded();
+            kernel.Run();
+
+            attention_basic(q,
+                            k,
+                            v,
+                            param.Mask,
+                            transpose_k,
+                            param.alpha,
+                            param.out_scale,
+                            &out_ref);
+            const float* out_data = out.data<float>();
+            const float* ref_data = out_ref.data<float>();
+            for (int i = 0; i < out.numel(); ++i) {
+              ASSERT_NEAR(out_data[i], ref_data[i], 1e-4)
+                  << "S: " << S << ", Sk: " << Sk
+                  << ", transpose_k: " << transpose_k
+                  << ", shared_kv: " << shared_kv
+                  << ", mask_type: " << mask_type;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(scaled_dot_product_attention, kX86, kFloat, kNCHW, def);
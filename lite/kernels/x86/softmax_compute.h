@@ -14,7 +14,7 @@
 #pragma once
 
 #include <vector>
-#include "lite/backends/x86/math/softmax.h"
+#include "lite/backends/x86/math/softmax_fp32.h"
 #include "lite/core/kernel.h"
 #include "lite/core/op_registry.h"
 namespace paddle {
@@ -52,36 +52,23 @@ class SoftmaxCompute : public KernelLite<TARGET(kX86), PRECISION(kFloat)> {
 
   void Run() override {
     auto& param = *param_.get_mutable<operators::SoftmaxParam>();
-    auto& context = ctx_->As<X86Context>();
     CHECK(param.output);
     CHECK(param.x);
 
     auto* x = param.x;
     auto* output = param.output;
-    output->template mutable_data<T>();
 
+    // x is viewed as n x axis_dim x d, the axis needs no transpose.
     const int rank = x->dims().size();
     const int axis = CanonicalAxis(param.axis, rank);
-    int axis_dim = x->dims()[axis];
-    if (rank == 2 && axis == 1) {
-      lite::x86::math::SoftmaxFunctor<lite::TargetType::kX86, T, true>()(
-          context, axis_dim, x, output);
-    } else {
-      const int n = SizeToAxis(axis, x->dims());
-      const int d = SizeFromAxis(axis, x->dims());
-
-      DDim x_dims = x->dims();
-      DDim out_dims = output->dims();
-
-      DDim shape_2d(std::vector<DDim::value_type>{n, d});
-      x->Resize(shape_2d);
-      output->Resize(shape_2d);
-
-      lite::x86::math::SoftmaxFunctor<lite::TargetType::kX86, T, true>()(
-          context, axis_dim, x, output);
-      x->Resize(x_dims);
-      output->Resize(out_dims);
-    }
+    const int axis_dim = x->dims()[axis];
+    const int n = SizeToAxis(axis, x->dims());
+    const int d = SizeFromAxis(axis + 1, x->dims());
+    lite::x86::math::softmax_fp32(x->template data<T>(),
+                                  output->template mutable_data<T>(),
+                                  n,
+                                  axis_dim,
+                                  d);
   }
 
   virtual ~SoftmaxCompute() = default;
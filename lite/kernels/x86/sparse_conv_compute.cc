@@ -0,0 +1,89 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/kernels/x86/sparse_conv_compute.h"
+#include <algorithm>
+#include "lite/backends/x86/math/fill_bias_activate.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+void SparseConvCompute::PrepareForRun() {
+  auto& param = this->Param<param_t>();
+  CHECK_GT(param.block_rows, 0)
+      << "The weights of the x86 sparse_conv2d must be in BCSR, the model "
+         "should be optimized for x86";
+  const int oc = param.oc_nonzeros->numel();
+  const int R = param.block_rows;
+  // oc_nonzeros holds the blocks up to every output channel, a block row
+  // ends with its last channel.
+  const int32_t* oc_nonzeros = param.oc_nonzeros->data<int32_t>();
+  row_ptr_.assign(1, 0);
+  for (int i = 0; i < oc; i += R) {
+    row_ptr_.push_back(oc_nonzeros[std::min(oc, i + R) - 1]);
+  }
+  weight_.rows = oc;
+  weight_.block_rows = R;
+  weight_.values = param.nonzero_weights->data<float>();
+  weight_.row_ptr = row_ptr_.data();
+  weight_.col_idx = param.diffs->data<int32_t>();
+}
+
+void SparseConvCompute::Run() {
+  auto& param = this->Param<param_t>();
+  const auto& x_dims = param.x->dims();
+  const int batch = x_dims[0];
+  const int ic = x_dims[1];
+  const int hw = x_dims[2] * x_dims[3];
+  const int oc = weight_.rows;
+  weight_.cols = ic;
+  const float* din = param.x->data<float>();
+  const float* bias = param.bias ? param.bias->data<float>() : nullptr;
+  float* dout = param.output->mutable_data<float>();
+  for (int b = 0; b < batch; ++b) {
+    float* dout_batch = dout + static_cast<int64_t>(b) * oc * hw;
+    lite::x86::math::sparse_gemm_fp32(weight_,
+                                      hw,
+                                      din + static_cast<int64_t>(b) * ic * hw,
+                                      hw,
+                                      bias,
+                                      dout_batch,
+                                      hw);
+    //! activate, the bias is added by the gemm
+    lite::x86::math::fill_bias_act(
+        dout_batch, nullptr, oc, hw, false, &param.activation_param);
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_KERNEL(sparse_conv2d,
+                     kX86,
+                     kFloat,
+                     kNCHW,
+                     paddle::lite::kernels::x86::SparseConvCompute,
+                     def)
+    .BindInput("Input", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("NonZeroWeights", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindInput("OcNonZeros",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
+    .BindInput("Diffs",
+               {LiteType::GetTensorTy(TARGET(kX86), PRECISION(kInt32))})
+    .BindInput("Bias", {LiteType::GetTensorTy(TARGET(kX86))})
+    .BindOutput("Output", {LiteType::GetTensorTy(TARGET(kX86))})
+    .Finalize();
@@ -0,0 +1,145 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "lite/kernels/x86/sparse_conv_compute.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "lite/core/op_registry.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace paddle {
+namespace lite {
+namespace kernels {
+namespace x86 {
+
+// The inputs of sparse_conv2d of the oc x ic w as sparse_conv_detect_pass
+// builds them for x86.
+void pack_sparse_weight(const std::vector<float>& w,
+                        int oc,
+                        int ic,
+                        int block_rows,
+                        Tensor* nonzero_weights,
+                        Tensor* oc_nonzeros,
+                        Tensor* diffs) {
+  const int64_t blocks =
+      lite::x86::math::bcsr_blocks(w.data(), oc, ic, ic, block_rows);
+  std::vector<int32_t> row_ptr((oc + block_rows - 1) / block_rows + 1);
+  nonzero_weights->Resize({std::max<int64_t>(blocks, 1) * block_rows});
+  diffs->Resize({std::max<int64_t>(blocks, 1)});
+  oc_nonzeros->Resize({oc});
+  lite::x86::math::bcsr_pack(w.data(),
+                             oc,
+                             ic,
+                             ic,
+                             block_rows,
+                             nonzero_weights->mutable_data<float>(),
+                             row_ptr.data(),
+                             diffs->mutable_data<int32_t>());
+  for (int i = 0; i < oc; ++i) {
+    oc_nonzeros->mutable_data<int32_t>()[i] = row_ptr[i / block_rows + 1];
+  }
+}
+
+TEST(sparse_conv2d_x86, retrive_op) {
+  auto kernel = KernelRegistry::Global().Create("sparse_conv2d");
+  ASSERT_FALSE(kernel.empty());
+  ASSERT_TRUE(kernel.front());
+}
+
+TEST(sparse_conv2d_x86, init) {
+  SparseConvCompute kernel;
+  ASSERT_EQ(kernel.precision(), PRECISION(kFloat));
+  ASSERT_EQ(kernel.target(), TARGET(kX86));
+}
+
+TEST(sparse_conv2d_x86, run_test) {
+  const int batch = 2, h = 5;
+  for (int oc : {5, 16}) {
+    for (int ic : {7, 32}) {
+      for (int w_size : {1, 7}) {
+        for (int block_rows : {1, 4}) {
+          for (bool has_bias : {false, true}) {
+            Tensor x, bias, out, nonzero_weights, oc_nonzeros, diffs;
+            x.Resize({batch, ic, h, w_size});
+            bias.Resize({oc});
+            out.Resize({batch, oc, h, w_size});
+            fill_data_rand(x.mutable_data<float>(), -1.f, 1.f, x.numel());
+            fill_data_rand(bias.mutable_data<float>(), -1.f, 1.f, oc);
+            std::vector<float> w(oc * ic);
+            fill_data_rand(w.data(), -1.f, 1.f, w.size());
+            for (auto& v : w) {
+              if (std::fabs(v) < 0.7f) v = 0.f;
+            }
+            pack_sparse_weight(w,
+                               oc,
+                               ic,
+                               block_rows,
+                               &nonzero_weights,
+                               &oc_nonzeros,
+                               &diffs);
+
+            SparseConvCompute kernel;
+            operators::SparseConvParam param;
+            param.x = &x;
+            param.nonzero_weights = &nonzero_weights;
+            param.oc_nonzeros = &oc_nonzeros;
+            param.diffs = &diffs;
+            param.bias = has_bias ? &bias : nullptr;
+            param.output = &out;
+            param.block_rows = block_rows;
+            param.activation_param.has_active = true;
+            param.activation_param.active_type =
+                lite_api::ActivationType::kLeakyRelu;
+            param.activation_param.Leaky_relu_alpha = 0.1f;
+            std::unique_ptr<KernelContext> ctx(new KernelContext);
+            ctx->As<X86Context>();
+            kernel.SetContext(std::move(ctx));
+            kernel.SetParam(param);
+            kernel.PrepareForRun();
+            kernel.Run();
+
+            const int hw = h * w_size;
+            const float* x_data = x.data<float>();
+            const float* out_data = out.data<float>();
+            for (int b = 0; b < batch; ++b) {
+              for (int i = 0; i < oc; ++i) {
+                for (int j = 0; j < hw; ++j) {
+                  float sum = has_bias ? bias.data<float>()[i] : 0.f;
+                  for (int k = 0; k < ic; ++k) {
+                    sum += w[i * ic + k] * x_data[(b * ic + k) * hw + j];
+                  }
+                  sum = sum < 0.f ? sum * 0.1f : sum;
+                  ASSERT_NEAR(out_data[(b * oc + i) * hw + j], sum, 1e-4)
+                      << "oc: " << oc << ", ic: " << ic
+                      << ", block_rows: " << block_rows
+                      << ", has_bias: " << has_bias;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+}  // namespace x86
+}  // namespace kernels
+}  // namespace lite
+}  // namespace paddle
+
+USE_LITE_KERNEL(sparse_conv2d, kX86, kFloat, kNCHW, def);
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "lite/model_parser/flatbuffers/io.h"
+#include <cstdint>
 #include <cstring>
 #include <limits>
 #include <memory>
@@ -99,10 +100,19 @@ void ParamSerializer::ForwardWrite(const lite::Scope& scope,
 
     const size_t param_bytes = buf_->size();
     CHECK(param_bytes) << "The bytes size of param can not be zero";
-    constexpr uint32_t offset = sizeof(uint32_t);
+    // Pad the param to kParamDataAlignment in the file, which the readers
+    // skip by the offset.
+    const size_t param_begin = writer_->current() + 2 * sizeof(uint32_t);
+    const uint32_t padding_bytes =
+        (kParamDataAlignment - param_begin % kParamDataAlignment) %
+        kParamDataAlignment;
+    const uint32_t offset = sizeof(uint32_t) + padding_bytes;
     const uint32_t total_size = param_bytes + offset;
     writer_->Write<uint32_t>(total_size);
     writer_->Write<uint32_t>(offset);
+    for (uint32_t i = 0; i < padding_bytes; ++i) {
+      writer_->Write<uint8_t>(0U);
+    }
     writer_->Write(buf_->data(), param_bytes);
   }
 }
@@ -115,7 +125,31 @@ void ParamSerializer::WriteHeader() {
 }
 #endif
 
-void ParamDeserializer::ForwardRead(lite::Scope* scope) {
+#if !defined(_WIN32)
+namespace {
+// Point the tensor at the param data in the mapped file. The params of the
+// models saved before the data was aligned are copied.
+void MapTensor(lite::Tensor* tensor,
+               const ParamDescReadAPI& param,
+               const std::shared_ptr<model_parser::MappedFile>& file) {
+  const void* data = param.GetData();
+  if (param.byte_size() == 0 ||
+      reinterpret_cast<uintptr_t>(data) % kParamDataAlignment != 0) {
+    FillTensor(tensor, param);
+    return;
+  }
+  tensor->Resize(param.Dim());
+  tensor->set_precision(lite::ConvertPrecisionType(param.GetDataType()));
+  tensor->ResetBuffer(std::make_shared<model_parser::MappedBuffer>(
+                          data, param.byte_size(), file),
+                      param.byte_size());
+  tensor->set_persistable(true);
+}
+}  // namespace
+#endif
+
+void ParamDeserializer::ForwardRead(lite::Scope* scope,
+                                    LazyParams* lazy_params) {
   CHECK(scope) << "The pointer of scope is nullptr";
   uint16_t header_size = reader_->Read<uint16_t>();
   ReadBytesToBuffer(header_size);
@@ -124,18 +158,66 @@ void ParamDeserializer::ForwardRead(lite::Scope* scope) {
   uint32_t max_tensor_size =
       *reinterpret_cast<uint32_t const*>(data + sizeof(uint16_t));
 
-  buf_->ResetLazy(max_tensor_size);
+  auto mapped_file = reader_->mapped_file();
+  CHECK(mapped_file || !lazy_params)
+      << "The params are only loaded lazily from a mapped file";
+  if (!mapped_file) {
+    buf_->ResetLazy(max_tensor_size);
+  }
   for (size_t i = 0; i < params_size; ++i) {
     uint32_t total_size = reader_->Read<uint32_t>();
     uint32_t offset = reader_->Read<uint32_t>();
     uint32_t param_bytes = total_size - offset;
-    ReadBytesToBuffer(offset - sizeof(offset));
+    reader_->Skip(offset - sizeof(offset));
+    if (mapped_file) {
+      MapParam(mapped_file, param_bytes, scope, lazy_params);
+      continue;
+    }
     ReadBytesToBuffer(param_bytes);
     fbs::ParamDescView param(buf_.get());
     FillTensor(scope->Var(param.Name())->GetMutable<lite::Tensor>(), param);
   }
 }
 
+#if !defined(_WIN32)
+void ParamDeserializer::MapParam(
+    const std::shared_ptr<model_parser::MappedFile>& file,
+    size_t param_bytes,
+    lite::Scope* scope,
+    LazyParams* lazy_params) {
+  const char* param_data = file->data() + reader_->current();
+  reader_->Skip(param_bytes);
+  // Only the table and the vector sizes are read, not the param data.
+  flatbuffers::Verifier verifier(reinterpret_cast<const uint8_t*>(param_data),
+                                 param_bytes);
+  CHECK(verifier.VerifyBuffer<proto::ParamDesc>(nullptr))
+      << "Param verification failed.";
+  fbs::ParamDescView param(flatbuffers::GetRoot<proto::ParamDesc>(param_data));
+  auto* tensor = scope->Var(param.Name())->GetMutable<lite::Tensor>();
+  if (!lazy_params) {
+    MapTensor(tensor, param, file);
+    return;
+  }
+  tensor->Resize(param.Dim());
+  tensor->set_precision(lite::ConvertPrecisionType(param.GetDataType()));
+  tensor->set_persistable(true);
+  lazy_params->Add(
+      param.Name(), tensor, [file, param_data](lite::Tensor* tensor) {
+        fbs::ParamDescView param(
+            flatbuffers::GetRoot<proto::ParamDesc>(param_data));
+        MapTensor(tensor, param, file);
+      });
+}
+#else
+void ParamDeserializer::MapParam(
+    const std::shared_ptr<model_parser::MappedFile>& file,
+    size_t param_bytes,
+    lite::Scope* scope,
+    LazyParams* lazy_params) {
+  LOG(FATAL) << "Mapped files are not supported on Windows.";
+}
+#endif
+
 void ParamDeserializer::ReadHeader() {
   // 1. version id
   uint16_t version = reader_->Read<uint16_t>();
@@ -18,6 +18,7 @@
 #include <set>
 #include <string>
 #include <vector>
+#include "lite/core/lazy_params.h"
 #include "lite/core/scope.h"
 #include "lite/core/variable.h"
 #include "lite/model_parser/flatbuffers/param_desc.h"
@@ -62,7 +63,9 @@ class ParamDeserializer {
         << "A valid reader should be passed in the ctor of param deserializer.";
     ReadHeader();
   }
-  void ForwardRead(lite::Scope* scope);
+  // With `lazy_params`, the params of a mapped file are registered there
+  // with their dims and precision, and their data is read on first use.
+  void ForwardRead(lite::Scope* scope, LazyParams* lazy_params = nullptr);
 
  private:
   void ReadBytesToBuffer(size_t size) {
@@ -70,6 +73,11 @@ class ParamDeserializer {
     reader_->Read(buf_->data(), size);
   }
   void ReadHeader();
+  // Read the next param in place from the file mapped by the reader.
+  void MapParam(const std::shared_ptr<model_parser::MappedFile>& file,
+                size_t param_bytes,
+                lite::Scope* scope,
+                LazyParams* lazy_params);
   model_parser::ByteReader* reader_{nullptr};
   std::unique_ptr<model_parser::Buffer> buf_;
 };
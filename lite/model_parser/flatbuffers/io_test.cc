@@ -128,6 +128,61 @@ TEST(CombinedParamsDesc, Scope) {
     deserializer.ForwardRead(&scope_3);
     check_params(scope_3);
   }
+
+#if !defined(_WIN32)
+  {
+    Scope scope_4;
+    LOG(INFO) << "Load params from mapped file...";
+    model_parser::MappedFileReader reader(path);
+    fbs::ParamDeserializer deserializer(&reader);
+    deserializer.ForwardRead(&scope_4);
+    check_params(scope_4);
+    // The params alias the aligned data in the mapped file.
+    const char* file_data = reader.mapped_file()->data();
+    for (auto& name : param_names) {
+      auto* tensor = scope_4.FindVar(name)->GetMutable<Tensor>();
+      const char* data = static_cast<const char*>(tensor->raw_data());
+      EXPECT_GE(data, file_data);
+      EXPECT_LT(data, file_data + reader.length());
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % kParamDataAlignment, 0u);
+    }
+    // Writing a param makes a private copy of its page, and growing it moves
+    // it into memory of its own.
+    auto* tensor_l0 = scope_4.FindVar(param_names[0])->GetMutable<Tensor>();
+    tensor_l0->mutable_data<float>()[0] = 100.f;
+    auto* tensor_l1 = scope_4.FindVar(param_names[1])->GetMutable<Tensor>();
+    tensor_l1->Resize({100, 10});
+    const char* grown =
+        reinterpret_cast<const char*>(tensor_l1->mutable_data<int8_t>());
+    EXPECT_TRUE(grown < file_data || grown >= file_data + reader.length());
+    Scope scope_5;
+    model_parser::MappedFileReader reader_5(path);
+    fbs::ParamDeserializer deserializer_5(&reader_5);
+    deserializer_5.ForwardRead(&scope_5);
+    check_params(scope_5);
+  }
+
+  {
+    Scope scope_6;
+    LOG(INFO) << "Load params lazily from mapped file...";
+    LazyParams lazy_params;
+    model_parser::MappedFileReader reader(path);
+    fbs::ParamDeserializer deserializer(&reader);
+    deserializer.ForwardRead(&scope_6, &lazy_params);
+    EXPECT_EQ(lazy_params.size(), param_names.size());
+    EXPECT_EQ(lazy_params.loaded_num(), 0u);
+    // The dims and the precision are known before the data is read.
+    auto* tensor_l2 = scope_6.FindVar(param_names[2])->GetMutable<Tensor>();
+    EXPECT_EQ(tensor_l2->dims(), tensor_2->dims());
+    EXPECT_EQ(tensor_l2->precision(), tensor_2->precision());
+    EXPECT_FALSE(tensor_l2->IsInitialized());
+    lazy_params.Load({param_names[2]});
+    EXPECT_EQ(lazy_params.loaded_num(), 1u);
+    EXPECT_TRUE(TensorCompareWith(*tensor_2, *tensor_l2));
+    lazy_params.LoadAll();
+    check_params(scope_6);
+  }
+#endif
 }
 #endif  // LITE_WITH_FLATBUFFERS_DESC
 
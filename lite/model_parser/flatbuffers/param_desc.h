@@ -30,6 +30,11 @@ namespace paddle {
 namespace lite {
 namespace fbs {
 
+// The alignment of the param data from the start of a serialized ParamDesc,
+// which is placed at the same alignment in the model file, so that a mapped
+// model can be read in place by the widest SIMD loads.
+constexpr size_t kParamDataAlignment = 64;
+
 class ParamDescView : public ParamDescReadAPI {
  public:
   explicit ParamDescView(model_parser::Buffer* buf) {
@@ -176,10 +181,30 @@ class ParamDesc : public ParamDescAPI {
     model_parser::memcpy(buffer->data(), buf_.data(), buf_.size());
   }
 
+  // The same table as proto::ParamDesc::Pack(), with the data aligned to
+  // kParamDataAlignment.
   void SyncBuffer() {
     fbb_.Reset();
-    flatbuffers::Offset<proto::ParamDesc> desc =
-        proto::ParamDesc::Pack(fbb_, desc_);
+    const auto& data = lod_tensor_->data;
+    fbb_.ForceVectorAlignment(data.size(), sizeof(int8_t), kParamDataAlignment);
+    auto data_offset = fbb_.CreateVector(data);
+    auto lod_tensor = proto::ParamDesc_::CreateLoDTensorDesc(
+        fbb_,
+        lod_tensor_->lod_level,
+        fbb_.CreateVector(lod_tensor_->lod),
+        fbb_.CreateVector(lod_tensor_->dim),
+        lod_tensor_->data_type,
+        data_offset);
+    auto version =
+        desc_->version
+            ? proto::ParamDesc_::CreateVersionDesc(fbb_, desc_->version.get())
+            : 0;
+    flatbuffers::Offset<proto::ParamDesc> desc = proto::CreateParamDesc(
+        fbb_,
+        version,
+        fbb_.CreateString(desc_->name),
+        proto::ParamDesc_::VariableDesc_LoDTensorDesc,
+        lod_tensor.Union());
     fbb_.Finish(desc);
     buf_ = fbb_.Release();
   }
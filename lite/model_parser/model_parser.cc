@@ -16,6 +16,7 @@
 #include <algorithm>
 #include <fstream>
 #include <limits>
+#include <memory>
 #include <set>
 #include <utility>
 
@@ -774,17 +775,33 @@ void LoadModelNaiveFromMemory(const std::string &model_buffer,
 
 void LoadModelNaiveFromFile(const std::string &filename,
                             Scope *scope,
-                            cpp::ProgramDesc *cpp_prog) {
+                            cpp::ProgramDesc *cpp_prog,
+                            bool use_mmap,
+                            LazyParams *lazy_params) {
   CHECK(cpp_prog);
   CHECK(scope);
   // ModelFile
   const std::string prog_path = filename;
-  // Offset
-  model_parser::BinaryFileReader reader(filename, 0);
+  std::unique_ptr<model_parser::ByteReader> reader;
+#if !defined(_WIN32)
+  if (use_mmap || lazy_params) {
+    reader.reset(new model_parser::MappedFileReader(filename));
+  }
+#else
+  if (use_mmap || lazy_params) {
+    LOG(WARNING) << "Mapped model files are not supported on Windows, the "
+                    "model is read as usual.";
+    lazy_params = nullptr;
+  }
+#endif
+  if (!reader) {
+    // Offset
+    reader.reset(new model_parser::BinaryFileReader(filename, 0));
+  }
 
   // (1)get meta version
   uint16_t meta_version;
-  reader.Read(&meta_version, sizeof(uint16_t));
+  reader->Read(&meta_version, sizeof(uint16_t));
   VLOG(4) << "Meta_version:" << meta_version;
 
   switch (meta_version) {
@@ -798,10 +815,10 @@ void LoadModelNaiveFromFile(const std::string &filename,
 #endif
       break;
     case 1:
-      LoadModelFbsFromFile(&reader, scope, cpp_prog, 1);
+      LoadModelFbsFromFile(reader.get(), scope, cpp_prog, 1);
       break;
     case 2:
-      LoadModelFbsFromFile(&reader, scope, cpp_prog, 2);
+      LoadModelFbsFromFile(reader.get(), scope, cpp_prog, 2, lazy_params);
       break;
     default:
       LOG(FATAL) << "The model format cannot be recognized. Please make sure "
@@ -866,10 +883,11 @@ void LoadModelNaiveV0FromFile(const std::string &filename,
   VLOG(4) << "Load naive buffer model in '" << filename << "' successfully";
 }
 #endif  // LITE_ON_TINY_PUBLISH
-void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
+void LoadModelFbsFromFile(model_parser::ByteReader *reader,
                           Scope *scope,
                           cpp::ProgramDesc *cpp_prog,
-                          uint16_t meta_version) {
+                          uint16_t meta_version,
+                          LazyParams *lazy_params) {
   CHECK(cpp_prog);
   CHECK(scope);
   CHECK_EQ(cpp_prog->BlocksSize(), 0);
@@ -922,7 +940,7 @@ void LoadModelFbsFromFile(model_parser::BinaryFileReader *reader,
     case 2: {
       /* load scope from param.fbs with meta_version=2 */
       fbs::ParamDeserializer deserializer(reader);
-      deserializer.ForwardRead(scope);
+      deserializer.ForwardRead(scope, lazy_params);
       break;
     }
     default:
@@ -24,6 +24,7 @@
 #include "lite/model_parser/naive_buffer/proto/framework.nb.h"
 #endif
 #include "lite/api/paddle_api.h"
+#include "lite/core/lazy_params.h"
 #include "lite/core/model/base/io.h"
 #include "lite/core/scope.h"
 #include "lite/core/variable.h"
@@ -139,14 +140,21 @@ void LoadNonCombinedParamsPb(const std::string& model_dir,
                              const lite_api::CxxModelBuffer& model_buffer,
                              Scope* scope);
 #endif  // LITE_ON_TINY_PUBLISH
-void LoadModelFbsFromFile(model_parser::BinaryFileReader* reader,
+void LoadModelFbsFromFile(model_parser::ByteReader* reader,
                           Scope* scope,
                           cpp::ProgramDesc* cpp_prog,
-                          uint16_t meta_version);
+                          uint16_t meta_version,
+                          LazyParams* lazy_params = nullptr);
 
+// With `use_mmap`, the file is mapped into memory and the params of a model
+// saved by this version are aliased in place instead of copied. With
+// `lazy_params`, the file is mapped as well and the params are only read on
+// first use, see LazyParams.
 void LoadModelNaiveFromFile(const std::string& filename,
                             lite::Scope* scope,
-                            cpp::ProgramDesc* prog);
+                            cpp::ProgramDesc* prog,
+                            bool use_mmap = false,
+                            LazyParams* lazy_params = nullptr);
 
 void LoadModelNaiveFromMemory(const std::string& model_buffer,
                               lite::Scope* scope,
@@ -26,7 +26,8 @@ bool FcOpLite::CheckShape() const {
   // bias is optional.
 
   const auto input_dims = param_.input->dims();
-  const auto w_dims = param_.w->dims();
+  // The dims of a packed int4 w are fixed in AttachImpl.
+  const auto w_dims = param_.w_dims.empty() ? param_.w->dims() : param_.w_dims;
   CHECK_EQ_OR_FALSE(w_dims.size(), 2UL);
 
   int64_t w_dims_1 = param_.padding_weights ? w_dims[1] - 4 : w_dims[1];
@@ -102,11 +103,17 @@ bool FcOpLite::AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) {
   if (op_desc.HasAttr("activation_type")) {
     param_.activation_type = op_desc.GetAttr<std::string>("activation_type");
   }
+  if (op_desc.HasAttr("alpha")) {
+    param_.alpha = op_desc.GetAttr<float>("alpha");
+  }
   if (op_desc.HasAttr("padding_weights")) {
     param_.padding_weights = op_desc.GetAttr<bool>("padding_weights");
   } else {
     param_.padding_weights = false;
   }
+  if (op_desc.HasAttr("sparse_weight")) {
+    param_.sparse_weight = op_desc.GetAttr<bool>("sparse_weight");
+  }
 
   if (param_.activation_type == "prelu") {
     param_.Prelu_mode = op_desc.GetAttr<std::string>("prelu_mode");
@@ -131,6 +138,27 @@ bool FcOpLite::AttachImpl(const cpp::OpDesc& op_desc, lite::Scope* scope) {
       param_.output_scale = op_info->GetOutputScale(out_scale_name, true)[0];
   }
 
+  // The weight quantized by post_quant_dynamic_pass, which is still int8 if
+  // the predictor left it quantized for the kernel.
+  if (op_info != nullptr && op_info->HasAttr("quantize_weight_bits") &&
+      op_info->HasAttr(W + "_quant_scale")) {
+    param_.weight_quant_bits = op_info->GetAttr<int>("quantize_weight_bits");
+    param_.weight_quant_scale =
+        op_info->GetAttr<std::vector<float>>(W + "_quant_scale");
+    param_.weight_quant_group_size =
+        op_info->HasAttr("quantize_weight_group_size")
+            ? op_info->GetAttr<int>("quantize_weight_group_size")
+            : param_.w_dims[0];
+    if (param_.weight_quant_bits == 4 &&
+        param_.w->precision() == PRECISION(kInt8)) {
+      // Two columns of the int4 w are packed in a byte.
+      const int64_t groups =
+          (param_.w_dims[0] + param_.weight_quant_group_size - 1) /
+          param_.weight_quant_group_size;
+      param_.w_dims[1] = param_.weight_quant_scale.size() / groups;
+    }
+  }
+
 #ifdef LITE_WITH_FPGA
   if (op_info != nullptr && op_info->HasAttr("fpga_static_quant")) {
     param_.enable_int8 = op_info->GetAttr<bool>("fpga_static_quant");
@@ -0,0 +1,77 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/fusion_elementwise_chain_op.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/scope.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool FusionElementwiseChainOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.X);
+  CHECK_OR_FALSE(param_.Out);
+  CHECK_OR_FALSE(!param_.ops.empty());
+  CHECK_EQ_OR_FALSE(param_.axes.size(), param_.ops.size());
+  CHECK_EQ_OR_FALSE(param_.params.size(), 3 * param_.ops.size());
+
+  // Every Y broadcasts to X, which the chain keeps the shape of.
+  const auto &x_dims = param_.X->dims();
+  size_t binary_ops = 0;
+  for (size_t i = 0; i < param_.ops.size(); ++i) {
+    if (param_.ops[i].compare(0, 12, "elementwise_") != 0) continue;
+    CHECK_GT_OR_FALSE(param_.Y.size(), binary_ops);
+    const auto &y_dims = param_.Y[binary_ops++]->dims();
+    int axis = param_.axes[i] == -1
+                   ? static_cast<int>(x_dims.size() - y_dims.size())
+                   : param_.axes[i];
+    CHECK_OR_FALSE(axis >= 0 && axis + y_dims.size() <= x_dims.size());
+    for (size_t j = 0; j < y_dims.size(); ++j) {
+      CHECK_OR_FALSE(y_dims[j] == 1 || y_dims[j] == x_dims[axis + j]);
+    }
+  }
+  CHECK_EQ_OR_FALSE(binary_ops, param_.Y.size());
+  return true;
+}
+
+bool FusionElementwiseChainOp::InferShapeImpl() const {
+  param_.Out->Resize(param_.X->dims());
+  param_.Out->set_lod(param_.X->lod());
+  return true;
+}
+
+bool FusionElementwiseChainOp::AttachImpl(const cpp::OpDesc &op_desc,
+                                          lite::Scope *scope) {
+  param_.X = scope->FindTensor(op_desc.Input("X").front());
+  param_.Y.clear();
+  if (op_desc.HasInput("Y")) {
+    for (const auto &name : op_desc.Input("Y")) {
+      param_.Y.push_back(scope->FindTensor(name));
+    }
+  }
+  param_.Out = scope->FindMutableTensor(op_desc.Output("Out").front());
+
+  param_.ops = op_desc.GetAttr<std::vector<std::string>>("chain_ops");
+  param_.axes = op_desc.GetAttr<std::vector<int>>("chain_axes");
+  param_.params = op_desc.GetAttr<std::vector<float>>("chain_params");
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(fusion_elementwise_chain,
+                 paddle::lite::operators::FusionElementwiseChainOp);
@@ -0,0 +1,56 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <string>
+#include "lite/core/op_lite.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+// Out = ops[k](... ops[0](X) ...) of a chain of elementwise binary ops,
+// scale and activations fused by lite_elementwise_chain_fuse_pass.
+//
+// The attributes of the ops are packed three by three into chain_params:
+// (scale, bias, 0) of scale, with the bias already multiplied by scale if
+// !bias_after_scale, (threshold, 0, 0) of relu6, (alpha, 0, 0) of
+// leaky_relu, (beta, 0, 0) of swish and (threshold, scale, offset) of
+// hard_swish.
+class FusionElementwiseChainOp : public OpLite {
+ public:
+  FusionElementwiseChainOp() {}
+
+  explicit FusionElementwiseChainOp(const std::string &op_type)
+      : OpLite(op_type) {}
+
+  bool CheckShape() const override;
+
+  bool InferShapeImpl() const override;
+
+  bool AttachImpl(const cpp::OpDesc &opdesc, lite::Scope *scope) override;
+
+  void AttachKernel(KernelBase *kernel) override { kernel->SetParam(param_); }
+
+  std::string DebugString() const override {
+    return "fusion_elementwise_chain";
+  }
+
+ private:
+  mutable FusionElementwiseChainParam param_;
+};
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
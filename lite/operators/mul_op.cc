@@ -37,7 +37,14 @@ bool MulOpLite::CheckShape() const {
 
 bool MulOpLite::InferShapeImpl() const {
   const auto x_dims = param_.x->dims();
-  const auto y_dims = param_.y->dims();
+  auto y_dims = param_.y->dims();
+  if (param_.weight_quant_bits == 4 &&
+      param_.y->precision() == PRECISION(kInt8)) {
+    // Two columns of the int4 y are packed in a byte.
+    const int64_t groups = (y_dims[0] + param_.weight_quant_group_size - 1) /
+                           param_.weight_quant_group_size;
+    y_dims[1] = param_.weight_quant_scale.size() / groups;
+  }
 
   // Set output dims
   std::vector<int64_t> out_dims;
@@ -58,6 +58,9 @@ class MulOpLite : public OpLite {
     param_.output = var->GetMutable<Tensor>();
     param_.x_num_col_dims = op_desc.GetAttr<int>("x_num_col_dims");
     param_.y_num_col_dims = op_desc.GetAttr<int>("y_num_col_dims");
+    if (op_desc.HasAttr("sparse_weight")) {
+      param_.sparse_weight = op_desc.GetAttr<bool>("sparse_weight");
+    }
 
     const OpInfo *op_info = static_cast<const OpInfo *>(&op_desc);
     if (op_info != nullptr && op_info->HasAttr("enable_int8")) {
@@ -72,6 +75,18 @@ class MulOpLite : public OpLite {
       if (op_info->HasOutputScale(out_scale_name, true))
         param_.output_scale = op_info->GetOutputScale(out_scale_name, true)[0];
     }
+    // The y quantized by post_quant_dynamic_pass, which is still int8 if the
+    // predictor left it quantized for the kernel.
+    if (op_info != nullptr && op_info->HasAttr("quantize_weight_bits") &&
+        op_info->HasAttr(W + "_quant_scale")) {
+      param_.weight_quant_bits = op_info->GetAttr<int>("quantize_weight_bits");
+      param_.weight_quant_scale =
+          op_info->GetAttr<std::vector<float>>(W + "_quant_scale");
+      param_.weight_quant_group_size =
+          op_info->HasAttr("quantize_weight_group_size")
+              ? op_info->GetAttr<int>("quantize_weight_group_size")
+              : param_.y->dims()[0];
+    }
     input_tensor_ptrs_cache_.push_back(param_.x);
     input_tensor_ptrs_cache_.push_back(param_.y);
     output_tensor_ptrs_cache_.push_back(param_.output);
@@ -43,6 +43,14 @@ using param_t = Any;
   float output_scale{1.0f};          \
   int bit_length{8};
 
+// The weight quantized by post_quant_dynamic_pass, the x86 fc and mul keep it
+// int8/int4 and dequantize it inside the gemm. The scales are per column, or
+// [group][column] of the groups of weight_quant_group_size rows.
+#define WITH_WEIGHT_ONLY_QUANT_CONFIG \
+  int weight_quant_bits{0};           \
+  int weight_quant_group_size{0};     \
+  std::vector<float> weight_quant_scale{};
+
 /// ----------------------- Functional operators ------------------------------
 struct FeedParam : ParamBase {
   std::vector<lite::Tensor>* feed_list{};
@@ -102,11 +110,17 @@ struct FcParam : ParamBase {
   lite::DDim w_dims;
   int in_num_col_dims{1};
   std::string activation_type{""};
+  // the threshold of relu6
+  float alpha{6.f};
   bool padding_weights{false};
   std::string Prelu_mode{
       "channel"};  // prelu param, can be "all", "channel" or "element"
   // for int8
   WITH_INT8_CONFIG
+  // for the weight-only quantized w
+  WITH_WEIGHT_ONLY_QUANT_CONFIG
+  // w is pruned, see sparse_conv_detect_pass
+  bool sparse_weight{false};
 };
 
 struct SearchSeqFcParam : ParamBase {
@@ -146,6 +160,10 @@ struct MulParam : ParamBase {
   int y_num_col_dims{1};
   // for int8
   WITH_INT8_CONFIG
+  // for the weight-only quantized y
+  WITH_WEIGHT_ONLY_QUANT_CONFIG
+  // y is pruned, see sparse_conv_detect_pass
+  bool sparse_weight{false};
 };
 
 struct MulGradParam : ParamBase {
@@ -340,6 +358,12 @@ struct SparseConvParam : ParamBase {
   lite::Tensor* output{};
   int first_ic{0};
   int flag_semi{0};
+  /* The rows of the blocks of the x86 BCSR weight, 0 for the arm format.
+   * nonzero_weights holds block_rows floats per block, diffs the input
+   * channel of every block and oc_nonzeros the blocks up to the block row
+   * of every output channel.
+   */
+  int block_rows{0};
   std::vector<int> strides{1, 1};
   std::shared_ptr<std::vector<int>> paddings;
   int groups{1};
@@ -565,6 +589,18 @@ struct FusionElementwiseActivationGradParam : public ElementwiseGradParam {
   std::string act_type;
 };
 
+// A chain of elementwise, scale and activation ops run as one op, ops[i]
+// being the type of the i-th op and params[3 * i : 3 * i + 3] its
+// attributes. The i-th binary op reads the Y[i] broadcast by axes[i].
+struct FusionElementwiseChainParam : ParamBase {
+  const lite::Tensor* X{};
+  std::vector<const lite::Tensor*> Y{};
+  lite::Tensor* Out{};
+  std::vector<std::string> ops{};
+  std::vector<int> axes{};
+  std::vector<float> params{};
+};
+
 /// ----------------------- mean operators ----------------------
 struct MeanParam : ParamBase {
   const lite::Tensor* X{};
@@ -1071,6 +1107,17 @@ struct SequencePoolParam : ParamBase {
   float pad_value{0.0f};
 };
 
+// lookup_table followed by a sum or mean sequence_pool, fused by the
+// embedding_seq_pool_fuse_pass.
+struct FusedEmbeddingSeqPoolParam : ParamBase {
+  const lite::Tensor* W{nullptr};
+  const lite::Tensor* Ids{nullptr};
+  lite::Tensor* Out{nullptr};
+  int64_t padding_idx{-1};
+  std::string combiner{"sum"};
+  float pad_value{0.0f};
+};
+
 struct SequenceConvParam : ParamBase {
   const lite::Tensor* X{};
   // not const for python unit_test
@@ -1172,6 +1219,19 @@ struct AttentionPaddingMaskParam : ParamBase {
   lite::Tensor* pad_begin{};
 };
 
+// softmax(alpha * Q * K^T + Mask) * V * out_scale, the fused attention.
+struct ScaledDotProductAttentionParam : ParamBase {
+  const lite::Tensor* Q{};
+  const lite::Tensor* K{};
+  const lite::Tensor* V{};
+  const lite::Tensor* Mask{};
+  lite::Tensor* Out{};
+  bool transpose_K{true};
+  float alpha{1.f};
+  float out_scale{1.f};
+  int mask_axis{-1};
+};
+
 struct SequenceArithmeticParam : ParamBase {
   const lite::Tensor* X{};
   const lite::Tensor* Y{};
@@ -0,0 +1,99 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "lite/operators/scaled_dot_product_attention_op.h"
+#include "lite/core/op_registry.h"
+#include "lite/core/scope.h"
+
+namespace paddle {
+namespace lite {
+namespace operators {
+
+bool ScaledDotProductAttentionOp::CheckShape() const {
+  CHECK_OR_FALSE(param_.Q);
+  CHECK_OR_FALSE(param_.K);
+  CHECK_OR_FALSE(param_.V);
+  CHECK_OR_FALSE(param_.Out);
+
+  // K and V are either batched as Q or a single matrix shared by the batch.
+  const auto &q_dims = param_.Q->dims();
+  const auto &k_dims = param_.K->dims();
+  const auto &v_dims = param_.V->dims();
+  size_t rank = q_dims.size();
+  CHECK_GE_OR_FALSE(rank, 2UL);
+  for (const auto *dims : {&k_dims, &v_dims}) {
+    CHECK_OR_FALSE(dims->size() == rank || dims->size() == 2UL);
+    if (dims->size() == rank) {
+      for (size_t i = 0; i + 2 < rank; ++i) {
+        CHECK_EQ_OR_FALSE((*dims)[i], q_dims[i]);
+      }
+    }
+  }
+  size_t k_rank = k_dims.size();
+  int64_t D = param_.transpose_K ? k_dims[k_rank - 1] : k_dims[k_rank - 2];
+  int64_t Sk = param_.transpose_K ? k_dims[k_rank - 2] : k_dims[k_rank - 1];
+  CHECK_EQ_OR_FALSE(D, q_dims[rank - 1]);
+  CHECK_EQ_OR_FALSE(Sk, v_dims[v_dims.size() - 2]);
+
+  // The mask broadcasts to the scores, [q_dims[0 : rank - 1], Sk], as the Y
+  // of elementwise_add.
+  if (param_.Mask) {
+    const auto &mask_dims = param_.Mask->dims();
+    int axis = param_.mask_axis == -1
+                   ? static_cast<int>(rank - mask_dims.size())
+                   : param_.mask_axis;
+    CHECK_OR_FALSE(axis >= 0 && axis + mask_dims.size() <= rank);
+    for (size_t i = 0; i < mask_dims.size(); ++i) {
+      int64_t dim = axis + i == rank - 1 ? Sk : q_dims[axis + i];
+      CHECK_OR_FALSE(mask_dims[i] == 1 || mask_dims[i] == dim);
+    }
+  }
+  return true;
+}
+
+bool ScaledDotProductAttentionOp::InferShapeImpl() const {
+  auto out_dims = param_.Q->dims();
+  const auto &v_dims = param_.V->dims();
+  out_dims[out_dims.size() - 1] = v_dims[v_dims.size() - 1];
+  param_.Out->Resize(out_dims);
+  param_.Out->set_lod(param_.Q->lod());
+  return true;
+}
+
+bool ScaledDotProductAttentionOp::AttachImpl(const cpp::OpDesc &op_desc,
+                                             lite::Scope *scope) {
+  param_.Q = scope->FindTensor(op_desc.Input("Q").front());
+  param_.K = scope->FindTensor(op_desc.Input("K").front());
+  param_.V = scope->FindTensor(op_desc.Input("V").front());
+  param_.Mask = nullptr;
+  if (op_desc.HasInput("Mask") && !op_desc.Input("Mask").empty()) {
+    param_.Mask = scope->FindTensor(op_desc.Input("Mask").front());
+  }
+  param_.Out = scope->FindMutableTensor(op_desc.Output("Out").front());
+
+  param_.transpose_K = op_desc.GetAttr<bool>("transpose_K");
+  param_.alpha = op_desc.GetAttr<float>("alpha");
+  param_.out_scale = op_desc.GetAttr<float>("out_scale");
+  if (op_desc.HasAttr("mask_axis")) {
+    param_.mask_axis = op_desc.GetAttr<int>("mask_axis");
+  }
+  return true;
+}
+
+}  // namespace operators
+}  // namespace lite
+}  // namespace paddle
+
+REGISTER_LITE_OP(scaled_dot_product_attention,
+                 paddle::lite::operators::ScaledDotProductAttentionOp);
@@ -123,6 +123,9 @@ class SparseConvOp : public OpLite {
     if (op_desc.HasAttr("flag_semi")) {
       param_.flag_semi = op_desc.GetAttr<int>("flag_semi");
     }
+    if (op_desc.HasAttr("sparse_block_rows")) {
+      param_.block_rows = op_desc.GetAttr<int>("sparse_block_rows");
+    }
 
     // For Int8
     const OpInfo* op_info = static_cast<const OpInfo*>(&op_desc);
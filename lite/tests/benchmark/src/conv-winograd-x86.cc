@@ -0,0 +1,149 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lite/backends/x86/math/avx/conv_utils.h"
+#include "lite/backends/x86/math/blas.h"
+#include "lite/backends/x86/math/conv_winograd_fp32.h"
+#include "lite/core/context.h"
+#include "lite/core/tensor.h"
+#include "lite/kernels/x86/conv_winograd.h"
+
+// The 3x3 stride 1 convolutions of the layers of resnet, vgg and yolo, run
+// by the winograd kernel and by the im2col and gemm of Conv2dCompute, one
+// image and one thread. The FLOPS counter counts the direct multiply-adds
+// for both, so the rates compare directly.
+
+namespace {
+
+namespace lite = paddle::lite;
+namespace math = paddle::lite::x86::math;
+
+struct ConvData {
+  ConvData(int ic, int oc, int hw) {
+    x.Resize({1, ic, hw, hw});
+    filter.Resize({oc, ic, 3, 3});
+    out.Resize({1, oc, hw, hw});
+    float* x_data = x.mutable_data<float>();
+    float* filter_data = filter.mutable_data<float>();
+    for (int64_t i = 0; i < x.numel(); i++) {
+      x_data[i] = static_cast<float>(i % 13) / 13.f;
+    }
+    for (int64_t i = 0; i < filter.numel(); i++) {
+      filter_data[i] = static_cast<float>(i % 11) / 11.f - 0.5f;
+    }
+    out.mutable_data<float>();
+  }
+
+  lite::Tensor x;
+  lite::Tensor filter;
+  lite::Tensor out;
+};
+
+void SetFlops(benchmark::State& state,  // NOLINT
+              int ic,
+              int oc,
+              int hw) {
+  state.counters["FLOPS"] = benchmark::Counter(
+      static_cast<double>(state.iterations()) * 2 * 9 * ic * oc * hw * hw,
+      benchmark::Counter::kIsRate);
+}
+
+// args: {in channels, out channels, height = width}
+void BM_Conv3x3Winograd(benchmark::State& state) {  // NOLINT
+  const int ic = state.range(0);
+  const int oc = state.range(1);
+  const int hw = state.range(2);
+  const int out_tile = math::conv_winograd_fp32_out_tile(ic, oc, hw, hw);
+  if (!out_tile) {
+    state.SkipWithError("winograd is not supported on this cpu");
+    return;
+  }
+  ConvData data(ic, oc, hw);
+  lite::operators::ConvParam param;
+  param.x = &data.x;
+  param.filter = &data.filter;
+  param.output = &data.out;
+  param.strides = {1, 1};
+  param.groups = 1;
+  param.paddings =
+      std::make_shared<std::vector<int>>(std::vector<int>({1, 1, 1, 1}));
+  param.dilations =
+      std::make_shared<std::vector<int>>(std::vector<int>({1, 1}));
+  lite::kernels::x86::WinogradConv<PRECISION(kFloat), PRECISION(kFloat)> conv(
+      out_tile);
+  std::unique_ptr<lite::KernelContext> ctx(new lite::KernelContext);
+  ctx->As<lite::X86Context>();
+  conv.SetContext(std::move(ctx));
+  conv.SetParam(param);
+  // The first run transforms the filter.
+  conv.Launch();
+  for (auto _ : state) {
+    conv.Launch();
+  }
+  SetFlops(state, ic, oc, hw);
+}
+
+void BM_Conv3x3Im2colGemm(benchmark::State& state) {  // NOLINT
+  const int ic = state.range(0);
+  const int oc = state.range(1);
+  const int hw = state.range(2);
+  ConvData data(ic, oc, hw);
+  lite::X86Context x86_ctx;
+  math::Blas<lite::TargetType::kX86> matmul(x86_ctx);
+  std::vector<float> col(ic * 9 * hw * hw);
+  const float* x_data = data.x.data<float>();
+  const float* filter_data = data.filter.data<float>();
+  float* out_data = data.out.mutable_data<float>();
+  for (auto _ : state) {
+    math::im2col<float>(
+        x_data, ic, hw, hw, 3, 3, 1, 1, 1, 1, 1, 1, 1, 1, col.data());
+    matmul.GEMM<float>(false,
+                       false,
+                       oc,
+                       hw * hw,
+                       ic * 9,
+                       1.f,
+                       filter_data,
+                       ic * 9,
+                       col.data(),
+                       hw * hw,
+                       0.f,
+                       out_data,
+                       hw * hw);
+  }
+  SetFlops(state, ic, oc, hw);
+}
+
+void LayerArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"IC", "OC", "HW"});
+  b->Args({64, 64, 56});
+  b->Args({128, 128, 28});
+  b->Args({256, 256, 14});
+  b->Args({512, 512, 7});
+  b->Args({32, 64, 104});
+  b->Args({128, 256, 52});
+}
+
+}  // namespace
+
+BENCHMARK(BM_Conv3x3Winograd)->Apply(LayerArguments)->UseRealTime();
+BENCHMARK(BM_Conv3x3Im2colGemm)->Apply(LayerArguments)->UseRealTime();
+
+BENCHMARK_MAIN();
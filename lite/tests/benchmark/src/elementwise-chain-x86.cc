@@ -0,0 +1,123 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "lite/backends/x86/math/elementwise_chain.h"
+
+// The chains of the transformer blocks, add -> scale -> relu6 and
+// mul -> add -> sigmoid with a y of the whole size, run by the fused
+// interpreter and op by op, each op a chain of its own over the whole
+// tensor as the unfused ops run. The elements counter counts the elements
+// of x once for both, so the rates compare directly.
+
+namespace {
+
+namespace math = paddle::lite::x86::math;
+
+struct ChainData {
+  explicit ChainData(int64_t size) : x(size), y(size), z(size), out(size) {
+    for (int64_t i = 0; i < size; i++) {
+      x[i] = static_cast<float>(i % 13) / 13.f - 0.5f;
+      y[i] = static_cast<float>(i % 11) / 11.f;
+      z[i] = static_cast<float>(i % 7) / 7.f - 0.5f;
+    }
+  }
+
+  // chain: 0 add -> scale -> relu6, 1 mul -> add -> sigmoid.
+  std::vector<math::ChainOp> Ops(int chain) const {
+    int64_t size = static_cast<int64_t>(x.size());
+    math::ChainOp binary0;
+    binary0.type = chain ? math::ChainOpType::kMul : math::ChainOpType::kAdd;
+    binary0.y = y.data();
+    binary0.n = size;
+    math::ChainOp second;
+    math::ChainOp unary;
+    if (chain) {
+      second.type = math::ChainOpType::kAdd;
+      second.y = z.data();
+      second.n = size;
+      unary.type = math::ChainOpType::kSigmoid;
+    } else {
+      second.type = math::ChainOpType::kScale;
+      second.a = 0.5f;
+      second.b = 0.1f;
+      unary.type = math::ChainOpType::kRelu6;
+      unary.a = 6.f;
+    }
+    return {binary0, second, unary};
+  }
+
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> z;
+  std::vector<float> out;
+};
+
+void SetElements(benchmark::State& state, int64_t size) {  // NOLINT
+  state.counters["elements"] =
+      benchmark::Counter(static_cast<double>(state.iterations()) * size,
+                         benchmark::Counter::kIsRate);
+}
+
+// args: {chain, size}
+void BM_ElementwiseChainFused(benchmark::State& state) {  // NOLINT
+  const int64_t size = state.range(1);
+  ChainData data(size);
+  std::vector<math::ChainOp> ops = data.Ops(state.range(0));
+  for (auto _ : state) {
+    math::elementwise_chain_fp32(data.x.data(), ops, size, data.out.data());
+    benchmark::DoNotOptimize(data.out.data());
+  }
+  SetElements(state, size);
+}
+
+void BM_ElementwiseChainOpByOp(benchmark::State& state) {  // NOLINT
+  const int64_t size = state.range(1);
+  ChainData data(size);
+  std::vector<math::ChainOp> ops = data.Ops(state.range(0));
+  std::vector<float> tmp(size);
+  for (auto _ : state) {
+    const float* in = data.x.data();
+    for (size_t i = 0; i < ops.size(); i++) {
+      // Ping-pong between tmp and out as the unfused ops write their
+      // outputs, the last op ends in out.
+      float* op_out =
+          (ops.size() - 1 - i) % 2 == 0 ? data.out.data() : tmp.data();
+      math::elementwise_chain_fp32(in, {ops[i]}, size, op_out);
+      in = op_out;
+    }
+    benchmark::DoNotOptimize(data.out.data());
+  }
+  SetElements(state, size);
+}
+
+void ChainArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"chain", "size"});
+  for (int chain = 0; chain < 2; chain++) {
+    b->Args({chain, 4096});
+    b->Args({chain, 128 * 768});
+    b->Args({chain, 128 * 3072});
+    b->Args({chain, 512 * 3072});
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_ElementwiseChainFused)->Apply(ChainArguments)->UseRealTime();
+BENCHMARK(BM_ElementwiseChainOpByOp)->Apply(ChainArguments)->UseRealTime();
+
+BENCHMARK_MAIN();
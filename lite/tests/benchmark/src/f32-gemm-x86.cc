@@ -0,0 +1,202 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "lite/tests/benchmark/src/gemm_configs.h"
+
+#include "lite/backends/x86/math/gemm_fp32_compute.h"
+#include "lite/core/thread_pool.h"
+
+// The native sgemm of the builds without MKL on the gemms of the convolutions
+// of the mobile nets, one thread, and on the fc and the attention gemms of a
+// BERT-base encoder, with 1 and 4 threads. The FLOPS counter is the rate.
+
+namespace {
+
+std::vector<float> RandomData(size_t size) {
+  std::random_device random_device;
+  auto rng = std::mt19937(random_device());
+  auto f32rng =
+      std::bind(std::uniform_real_distribution<float>(-1.f, 1.f), rng);
+  std::vector<float> data(size);
+  std::generate(data.begin(), data.end(), std::ref(f32rng));
+  return data;
+}
+
+void SetFlops(benchmark::State& state, int64_t flops) {  // NOLINT
+  state.counters["FLOPS"] = benchmark::Counter(
+      static_cast<double>(state.iterations()) * flops,
+      benchmark::Counter::kIsRate);
+}
+
+bool SkipIfUnavailable(benchmark::State& state) {  // NOLINT
+  if (paddle::lite::x86::math::gemm_fp32_available()) return false;
+  state.SkipWithError("the cpu has no AVX2");
+  return true;
+}
+
+// Args: {M, N, K}.
+void paddle_f32_gemm(benchmark::State& state, const char* net) {  // NOLINT
+  if (SkipIfUnavailable(state)) return;
+  const int m = state.range(0);
+  const int n = state.range(1);
+  const int k = state.range(2);
+  auto a = RandomData(m * k);
+  auto b = RandomData(k * n);
+  std::vector<float> c(m * n);
+  for (auto _ : state) {
+    paddle::lite::x86::math::gemm_fp32(false,
+                                       false,
+                                       m,
+                                       n,
+                                       k,
+                                       1.f,
+                                       a.data(),
+                                       k,
+                                       b.data(),
+                                       n,
+                                       0.f,
+                                       c.data(),
+                                       n);
+  }
+  SetFlops(state, int64_t(2) * m * n * k);
+}
+
+// An fc, x * w, args: {M, N, K, threads}.
+void BM_FcGemm(benchmark::State& state) {  // NOLINT
+  if (SkipIfUnavailable(state)) return;
+  const int m = state.range(0);
+  const int n = state.range(1);
+  const int k = state.range(2);
+  auto pool = paddle::lite::ThreadPool::Create(state.range(3));
+  paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+  auto x = RandomData(m * k);
+  auto w = RandomData(k * n);
+  std::vector<float> out(m * n);
+  for (auto _ : state) {
+    paddle::lite::x86::math::gemm_fp32(false,
+                                       false,
+                                       m,
+                                       n,
+                                       k,
+                                       1.f,
+                                       x.data(),
+                                       k,
+                                       w.data(),
+                                       n,
+                                       0.f,
+                                       out.data(),
+                                       n);
+  }
+  SetFlops(state, int64_t(2) * m * n * k);
+}
+
+// The same fc with w packed once, as the fc kernel runs a persistable
+// weight, args: {M, N, K, threads}.
+void BM_FcPackedGemm(benchmark::State& state) {  // NOLINT
+  if (SkipIfUnavailable(state)) return;
+  const int m = state.range(0);
+  const int n = state.range(1);
+  const int k = state.range(2);
+  auto pool = paddle::lite::ThreadPool::Create(state.range(3));
+  paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+  auto x = RandomData(m * k);
+  auto w = RandomData(k * n);
+  std::vector<float> packed_w(
+      paddle::lite::x86::math::gemm_fp32_packed_B_size(n, k));
+  paddle::lite::x86::math::gemm_fp32_prepack_B(
+      false, n, k, w.data(), n, packed_w.data());
+  std::vector<float> out(m * n);
+  for (auto _ : state) {
+    paddle::lite::x86::math::gemm_fp32_prepacked(false,
+                                                 m,
+                                                 n,
+                                                 k,
+                                                 1.f,
+                                                 x.data(),
+                                                 k,
+                                                 packed_w.data(),
+                                                 0.f,
+                                                 out.data(),
+                                                 n);
+  }
+  SetFlops(state, int64_t(2) * m * n * k);
+}
+
+// The scores of the attention heads, q * k^T per head, args:
+// {sequence length, heads, threads}, the head size is 64.
+void BM_AttentionGemm(benchmark::State& state) {  // NOLINT
+  if (SkipIfUnavailable(state)) return;
+  const int seq_len = state.range(0);
+  const int heads = state.range(1);
+  const int head_size = 64;
+  auto pool = paddle::lite::ThreadPool::Create(state.range(2));
+  paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+  auto q = RandomData(heads * seq_len * head_size);
+  auto k = RandomData(heads * seq_len * head_size);
+  std::vector<float> scores(heads * seq_len * seq_len);
+  for (auto _ : state) {
+    paddle::lite::x86::math::gemm_fp32_batch(false,
+                                             true,
+                                             seq_len,
+                                             seq_len,
+                                             head_size,
+                                             0.125f,
+                                             q.data(),
+                                             head_size,
+                                             seq_len * head_size,
+                                             k.data(),
+                                             head_size,
+                                             seq_len * head_size,
+                                             0.f,
+                                             scores.data(),
+                                             seq_len,
+                                             seq_len * seq_len,
+                                             heads);
+  }
+  SetFlops(state, int64_t(2) * heads * seq_len * seq_len * head_size);
+}
+
+void FcArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N", "K", "threads"});
+  for (int threads : {1, 4}) {
+    for (int m : {1, 16, 128}) {
+      b->Args({m, 768, 768, threads});
+      b->Args({m, 3072, 768, threads});
+      b->Args({m, 768, 3072, threads});
+    }
+  }
+}
+
+void AttentionArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"seq_len", "heads", "threads"});
+  for (int threads : {1, 4}) {
+    for (int seq_len : {32, 128, 384}) b->Args({seq_len, 12, threads});
+  }
+}
+
+}  // namespace
+
+BENCHMARK_GEMM(paddle_f32_gemm)
+BENCHMARK(BM_FcGemm)->Apply(FcArguments)->UseRealTime();
+BENCHMARK(BM_FcPackedGemm)->Apply(FcArguments)->UseRealTime();
+BENCHMARK(BM_AttentionGemm)->Apply(AttentionArguments)->UseRealTime();
+
+BENCHMARK_MAIN();
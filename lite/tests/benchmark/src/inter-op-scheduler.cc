@@ -0,0 +1,144 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "lite/core/inter_op_scheduler.h"
+
+// Runs an Inception-style program, a chain of blocks made of four branches of
+// one, two, three and one ops joined by a concat, either one op after another
+// or with the independent ops at the same time. Every op is a parallel loop
+// over a small tensor, like the kernels of a small model at batch size 1,
+// which leaves most of the threads idle in the sequential order.
+// Args: {elements per op, threads}.
+
+namespace {
+
+const int kBlockNum = 8;
+const int kBranchDepths[] = {1, 2, 3, 1};
+
+class FakeOp : public paddle::lite::OpLite {
+ public:
+  explicit FakeOp(const std::string& type) : OpLite(type) {}
+  bool AttachImpl(const paddle::lite::cpp::OpDesc& opdesc,
+                  paddle::lite::Scope* scope) override {
+    return true;
+  }
+  void AttachKernel(paddle::lite::KernelBase* kernel) override {}
+  std::string DebugString() const override { return op_type_; }
+};
+
+class InceptionProgram {
+ public:
+  InceptionProgram() {
+    std::string in = "x";
+    for (int b = 0; b < kBlockNum; ++b) {
+      std::vector<std::string> tails;
+      for (int branch = 0; branch < 4; ++branch) {
+        std::string x = in;
+        for (int d = 0; d < kBranchDepths[branch]; ++d) {
+          std::string out = "b" + std::to_string(b) + "_" +
+                            std::to_string(branch) + "_" + std::to_string(d);
+          AddOp("conv2d", {x}, out);
+          x = out;
+        }
+        tails.push_back(x);
+      }
+      in = "concat" + std::to_string(b);
+      AddOp("concat", tails, in);
+    }
+    std::vector<const paddle::lite::OpLite*> ops;
+    for (auto& op : ops_) ops.push_back(op.get());
+    scheduler_.Init(ops);
+  }
+
+  size_t size() const { return ops_.size(); }
+  paddle::lite::InterOpScheduler* scheduler() { return &scheduler_; }
+
+ private:
+  void AddOp(const std::string& type,
+             const std::vector<std::string>& inputs,
+             const std::string& output) {
+    paddle::lite::cpp::OpDesc desc;
+    desc.SetType(type);
+    desc.SetInput("X", inputs);
+    desc.SetOutput("Out", {output});
+    std::unique_ptr<FakeOp> op(new FakeOp(type));
+    op->Attach(desc, &scope_);
+    ops_.push_back(std::move(op));
+  }
+
+  paddle::lite::Scope scope_;
+  std::vector<std::unique_ptr<paddle::lite::OpLite>> ops_;
+  paddle::lite::InterOpScheduler scheduler_;
+};
+
+// The kernel of every op, a parallel loop over rows of 64 elements.
+void RunKernel(std::vector<float>* data) {
+  const int rows = static_cast<int>(data->size()) / 64;
+  float* ptr = data->data();
+  paddle::lite::ThreadPool::Enqueue(std::make_pair(
+      std::function<void(int, int)>([=](int r, int) {
+        float* row = ptr + r * 64;
+        for (int k = 0; k < 64; ++k) {
+          row[k] = std::sqrt(row[k] * 1.0001f + 1.f);
+        }
+      }),
+      rows));
+}
+
+void BM_Sequential(benchmark::State& state) {  // NOLINT
+  InceptionProgram program;
+  auto pool = paddle::lite::ThreadPool::Create(state.range(1));
+  paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+  std::vector<std::vector<float>> data(
+      program.size(), std::vector<float>(state.range(0), 1.f));
+  for (auto _ : state) {
+    for (size_t i = 0; i < program.size(); ++i) {
+      RunKernel(&data[i]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * program.size());
+}
+
+void BM_InterOpParallel(benchmark::State& state) {  // NOLINT
+  InceptionProgram program;
+  auto pool = paddle::lite::ThreadPool::Create(state.range(1));
+  paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+  std::vector<std::vector<float>> data(
+      program.size(), std::vector<float>(state.range(0), 1.f));
+  for (auto _ : state) {
+    program.scheduler()->Run(pool.get(),
+                             [&](int i) { RunKernel(&data[i]); });
+  }
+  state.SetItemsProcessed(state.iterations() * program.size());
+}
+
+void Arguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"n", "threads"});
+  for (int threads : {2, 4, 8}) {
+    for (int n : {1024, 8192, 65536}) b->Args({n, threads});
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_Sequential)->Apply(Arguments)->UseRealTime();
+BENCHMARK(BM_InterOpParallel)->Apply(Arguments)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,229 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "lite/backends/x86/math/gemm_fp32_compute.h"
+#include "lite/backends/x86/math/sparse_gemm.h"
+#include "lite/core/thread_pool.h"
+
+// The pruned weights of the 1x1 convolutions of MobileNet v1 and of the fc
+// of a BERT-base encoder, run by sparse_gemm_fp32 against the dense
+// gemm_fp32 from 50% to 95% of zeros. The FLOPS counter counts the dense
+// multiply-adds for both, so the rates compare directly.
+
+namespace {
+
+namespace math = paddle::lite::x86::math;
+
+std::vector<float> RandomData(size_t size) {
+  std::random_device random_device;
+  auto rng = std::mt19937(random_device());
+  auto f32rng =
+      std::bind(std::uniform_real_distribution<float>(-1.f, 1.f), rng);
+  std::vector<float> data(size);
+  std::generate(data.begin(), data.end(), std::ref(f32rng));
+  return data;
+}
+
+// The rows x cols weight with `sparsity` percent of zeros, pruned by blocks
+// of block_rows rows.
+std::vector<float> PrunedWeight(int rows,
+                                int cols,
+                                int sparsity,
+                                int block_rows) {
+  auto w = RandomData(static_cast<size_t>(rows) * cols);
+  auto rng = std::mt19937(std::random_device()());
+  std::uniform_int_distribution<int> percent(0, 99);
+  for (int i = 0; i < rows; i += block_rows) {
+    for (int j = 0; j < cols; ++j) {
+      if (percent(rng) >= sparsity) continue;
+      for (int r = i; r < std::min(rows, i + block_rows); ++r) {
+        w[static_cast<size_t>(r) * cols + j] = 0.f;
+      }
+    }
+  }
+  return w;
+}
+
+void SetFlops(benchmark::State& state, int64_t flops) {  // NOLINT
+  state.counters["FLOPS"] = benchmark::Counter(
+      static_cast<double>(state.iterations()) * flops,
+      benchmark::Counter::kIsRate);
+}
+
+bool SkipIfUnavailable(benchmark::State& state) {  // NOLINT
+  if (math::gemm_fp32_available()) return false;
+  state.SkipWithError("the cpu has no AVX2");
+  return true;
+}
+
+// A 1x1 conv2d, w * x, args: {out channels, in channels, pixels, sparsity,
+// block_rows, threads}. The dense gemm runs the same pruned w.
+void BM_Conv1x1Dense(benchmark::State& state) {  // NOLINT
+  if (SkipIfUnavailable(state)) return;
+  const int oc = state.range(0);
+  const int ic = state.range(1);
+  const int hw = state.range(2);
+  auto pool = paddle::lite::ThreadPool::Create(state.range(5));
+  paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+  auto w = PrunedWeight(oc, ic, state.range(3), state.range(4));
+  auto x = RandomData(ic * hw);
+  std::vector<float> out(oc * hw);
+  for (auto _ : state) {
+    math::gemm_fp32(false,
+                    false,
+                    oc,
+                    hw,
+                    ic,
+                    1.f,
+                    w.data(),
+                    ic,
+                    x.data(),
+                    hw,
+                    0.f,
+                    out.data(),
+                    hw);
+  }
+  SetFlops(state, int64_t(2) * oc * hw * ic);
+}
+
+void BM_Conv1x1Sparse(benchmark::State& state) {  // NOLINT
+  if (SkipIfUnavailable(state)) return;
+  const int oc = state.range(0);
+  const int ic = state.range(1);
+  const int hw = state.range(2);
+  const int block_rows = state.range(4);
+  auto pool = paddle::lite::ThreadPool::Create(state.range(5));
+  paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+  auto w = PrunedWeight(oc, ic, state.range(3), block_rows);
+  const int64_t blocks = math::bcsr_blocks(w.data(), oc, ic, ic, block_rows);
+  std::vector<float> values(blocks * block_rows);
+  std::vector<int32_t> row_ptr((oc + block_rows - 1) / block_rows + 1);
+  std::vector<int32_t> col_idx(blocks);
+  math::bcsr_pack(w.data(),
+                  oc,
+                  ic,
+                  ic,
+                  block_rows,
+                  values.data(),
+                  row_ptr.data(),
+                  col_idx.data());
+  math::BcsrMatrix sparse_w;
+  sparse_w.rows = oc;
+  sparse_w.cols = ic;
+  sparse_w.block_rows = block_rows;
+  sparse_w.values = values.data();
+  sparse_w.row_ptr = row_ptr.data();
+  sparse_w.col_idx = col_idx.data();
+  auto x = RandomData(ic * hw);
+  std::vector<float> out(oc * hw);
+  for (auto _ : state) {
+    math::sparse_gemm_fp32(
+        sparse_w, hw, x.data(), hw, nullptr, out.data(), hw);
+  }
+  SetFlops(state, int64_t(2) * oc * hw * ic);
+}
+
+// An fc, x * w, of the prepacked dense w or of the BCSR of w pruned by
+// blocks of 4 output channels, args: {M, N, K, sparsity, threads}.
+void BM_FcDense(benchmark::State& state) {  // NOLINT
+  if (SkipIfUnavailable(state)) return;
+  const int m = state.range(0);
+  const int n = state.range(1);
+  const int k = state.range(2);
+  auto pool = paddle::lite::ThreadPool::Create(state.range(4));
+  paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+  auto x = RandomData(m * k);
+  auto w = PrunedWeight(k, n, state.range(3), 1);
+  std::vector<float> packed_w(math::gemm_fp32_packed_B_size(n, k));
+  math::gemm_fp32_prepack_B(false, n, k, w.data(), n, packed_w.data());
+  std::vector<float> out(m * n);
+  for (auto _ : state) {
+    math::gemm_fp32_prepacked(false,
+                              m,
+                              n,
+                              k,
+                              1.f,
+                              x.data(),
+                              k,
+                              packed_w.data(),
+                              0.f,
+                              out.data(),
+                              n);
+  }
+  SetFlops(state, int64_t(2) * m * n * k);
+}
+
+void BM_FcSparse(benchmark::State& state) {  // NOLINT
+  if (SkipIfUnavailable(state)) return;
+  const int m = state.range(0);
+  const int n = state.range(1);
+  const int k = state.range(2);
+  auto pool = paddle::lite::ThreadPool::Create(state.range(4));
+  paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+  auto x = RandomData(m * k);
+  // The output channels are the columns of w, the rows of w^T.
+  auto w_trans = PrunedWeight(n, k, state.range(3), 4);
+  std::vector<float> w(k * n);
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < k; ++j) w[j * n + i] = w_trans[i * k + j];
+  }
+  auto sparse_w = math::SparseGemmWeight::Create(w.data(), k, n, n);
+  std::vector<float> out(m * n);
+  for (auto _ : state) {
+    sparse_w->Compute(m, x.data(), k, nullptr, out.data(), n);
+  }
+  SetFlops(state, int64_t(2) * m * n * k);
+}
+
+void Conv1x1Arguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"OC", "IC", "HW", "sparsity", "block_rows", "threads"});
+  for (int threads : {1, 4}) {
+    for (int block_rows : {1, 4}) {
+      for (int sparsity : {50, 70, 80, 90, 95}) {
+        b->Args({128, 64, 56 * 56, sparsity, block_rows, threads});
+        b->Args({256, 256, 28 * 28, sparsity, block_rows, threads});
+        b->Args({512, 512, 14 * 14, sparsity, block_rows, threads});
+        b->Args({1024, 1024, 7 * 7, sparsity, block_rows, threads});
+      }
+    }
+  }
+}
+
+void FcArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"M", "N", "K", "sparsity", "threads"});
+  for (int threads : {1, 4}) {
+    for (int sparsity : {50, 70, 80, 90, 95}) {
+      for (int m : {1, 16, 128}) {
+        b->Args({m, 768, 768, sparsity, threads});
+        b->Args({m, 3072, 768, sparsity, threads});
+        b->Args({m, 768, 3072, sparsity, threads});
+      }
+    }
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_Conv1x1Dense)->Apply(Conv1x1Arguments)->UseRealTime();
+BENCHMARK(BM_Conv1x1Sparse)->Apply(Conv1x1Arguments)->UseRealTime();
+BENCHMARK(BM_FcDense)->Apply(FcArguments)->UseRealTime();
+BENCHMARK(BM_FcSparse)->Apply(FcArguments)->UseRealTime();
+
+BENCHMARK_MAIN();
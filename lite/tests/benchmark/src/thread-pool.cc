@@ -0,0 +1,206 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>  //NOLINT
+#include <mutex>               //NOLINT
+#include <thread>              //NOLINT
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "lite/core/thread_pool.h"
+
+// Compares the work-stealing ThreadPool with the condition-variable pool it
+// replaced and with OpenMP, on three kinds of loops:
+//   tiny:   few iterations of a few nanoseconds, measures the dispatch cost;
+//   skewed: the cost of iteration i grows linearly with i, measures balance;
+//   large:  many uniform iterations, measures the throughput.
+// Args: {loop size, threads}.
+
+namespace {
+
+// The pool before the work-stealing rewrite, kept here as the baseline.
+class LegacyThreadPool {
+ public:
+  explicit LegacyThreadPool(int number) : thread_num_(number) {
+    for (int i = 0; i < thread_num_; ++i) {
+      flags_.emplace_back(new std::atomic<bool>{false});
+    }
+    for (int thread_index = 1; thread_index < thread_num_; ++thread_index) {
+      workers_.emplace_back([this, thread_index]() {
+        while (!stop_) {
+          std::unique_lock<std::mutex> lck(mutex_);
+          cv_.wait(lck, [&]() {
+            return *flags_[thread_index] == true || stop_ == true;
+          });
+          lck.unlock();
+          if (stop_) break;
+          task_(thread_index, thread_index);
+          {
+            std::lock_guard<std::mutex> done_lck(mutex_);
+            *flags_[thread_index] = false;
+          }
+          done_cv_.notify_all();
+        }
+      });
+    }
+  }
+  ~LegacyThreadPool() {
+    {
+      std::lock_guard<std::mutex> lck(mutex_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) worker.join();
+    for (auto flag : flags_) delete flag;
+  }
+  void Enqueue(const std::function<void(int, int)>& fn, int work_size) {
+    int n = work_size;
+    if (n > thread_num_) {
+      task_ = [&, work_size](int index, int tid) {
+        for (int v = tid; v < work_size; v += thread_num_) fn(v, tid);
+      };
+      n = thread_num_;
+    } else {
+      task_ = fn;
+    }
+    for (int i = 1; i < n; ++i) {
+      std::unique_lock<std::mutex> lck(mutex_);
+      *flags_[i] = true;
+      cv_.notify_all();
+    }
+    task_(0, 0);
+    auto complete = [&]() {
+      for (int i = 1; i < n; ++i) {
+        if (*flags_[i]) return false;
+      }
+      return true;
+    };
+    // Yield for a while, then sleep until the workers are done, so that the
+    // issuer doesn't keep a core busy while it waits.
+    for (int i = 0; i < kYieldCount && !complete(); ++i) {
+      std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lck(mutex_);
+    done_cv_.wait(lck, complete);
+  }
+
+ private:
+  static const int kYieldCount = 256;
+
+  int thread_num_;
+  std::vector<std::thread> workers_;
+  std::vector<std::atomic<bool>*> flags_;
+  std::function<void(int, int)> task_;
+  std::atomic<bool> stop_{false};
+  std::condition_variable cv_;
+  // Signaled by the workers when they are done with their task.
+  std::condition_variable done_cv_;
+  std::mutex mutex_;
+};
+
+enum LoopKind { kTiny, kSkewed, kLarge };
+
+inline float Body(LoopKind kind, int i, int n) {
+  int rounds = kind == kTiny ? 1 : (kind == kSkewed ? 1 + 64 * i / n : 16);
+  float acc = static_cast<float>(i);
+  for (int r = 0; r < rounds; ++r) {
+    acc = std::sqrt(acc * 1.0001f + 1.f);
+  }
+  return acc;
+}
+
+template <LoopKind kind>
+void BM_LiteThreadPool(benchmark::State& state) {  // NOLINT
+  const int n = state.range(0);
+  const int threads = state.range(1);
+  std::vector<float> out(n);
+  paddle::lite::ThreadPool::Init(threads);
+  for (auto _ : state) {
+    paddle::lite::ThreadPool::Enqueue(std::make_pair(
+        std::function<void(int, int)>(
+            [&](int i, int tid) { out[i] = Body(kind, i, n); }),
+        n));
+    benchmark::DoNotOptimize(out.data());
+  }
+  paddle::lite::ThreadPool::Destroy();
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <LoopKind kind>
+void BM_LegacyThreadPool(benchmark::State& state) {  // NOLINT
+  const int n = state.range(0);
+  const int threads = state.range(1);
+  std::vector<float> out(n);
+  LegacyThreadPool pool(threads);
+  std::function<void(int, int)> fn = [&](int i, int tid) {
+    out[i] = Body(kind, i, n);
+  };
+  for (auto _ : state) {
+    pool.Enqueue(fn, n);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+
+#ifdef _OPENMP
+template <LoopKind kind>
+void BM_OpenMP(benchmark::State& state) {  // NOLINT
+  const int n = state.range(0);
+  const int threads = state.range(1);
+  std::vector<float> out(n);
+  omp_set_num_threads(threads);
+  for (auto _ : state) {
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; ++i) {
+      out[i] = Body(kind, i, n);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+#endif
+
+void TinyArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"n", "threads"});
+  for (int threads : {2, 4, 8, 16, 32}) {
+    for (int n : {4, 16, 64}) b->Args({n, threads});
+  }
+}
+
+void LargeArguments(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"n", "threads"});
+  for (int threads : {2, 4, 8, 16, 32}) {
+    for (int n : {4096, 65536, 1 << 20}) b->Args({n, threads});
+  }
+}
+
+}  // namespace
+
+#define BENCHMARK_POOL(fn)                                                  \
+  BENCHMARK_TEMPLATE(fn, kTiny)->Apply(TinyArguments)->UseRealTime();      \
+  BENCHMARK_TEMPLATE(fn, kSkewed)->Apply(LargeArguments)->UseRealTime();   \
+  BENCHMARK_TEMPLATE(fn, kLarge)->Apply(LargeArguments)->UseRealTime();
+
+BENCHMARK_POOL(BM_LiteThreadPool)
+BENCHMARK_POOL(BM_LegacyThreadPool)
+#ifdef _OPENMP
+BENCHMARK_POOL(BM_OpenMP)
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,142 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "lite/backends/host/math/nms.h"
+#include "lite/backends/host/math/nms_util.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace math = paddle::lite::host::math;
+
+// n boxes around a few centers so that many of them overlap, some empty or
+// inverted.
+std::vector<float> make_boxes(int n, float scale) {
+  std::vector<float> centers(8), boxes(n * 4), jitter(n * 4);
+  fill_data_rand(centers.data(), 0.f, scale, centers.size());
+  fill_data_rand(jitter.data(), -0.1f * scale, 0.1f * scale, jitter.size());
+  for (int i = 0; i < n; ++i) {
+    float cx = centers[(i % 4) * 2];
+    float cy = centers[(i % 4) * 2 + 1];
+    boxes[i * 4] = cx - 0.2f * scale + jitter[i * 4];
+    boxes[i * 4 + 1] = cy - 0.2f * scale + jitter[i * 4 + 1];
+    boxes[i * 4 + 2] = cx + 0.2f * scale + jitter[i * 4 + 2];
+    boxes[i * 4 + 3] = cy + 0.2f * scale + jitter[i * 4 + 3];
+  }
+  if (n > 3) {
+    std::swap(boxes[8], boxes[10]);
+    boxes[14] = boxes[12];
+    boxes[15] = boxes[13];
+  }
+  return boxes;
+}
+
+std::vector<int> nms_basic(const std::vector<float>& boxes,
+                           const std::vector<int>& order,
+                           float threshold,
+                           float eta,
+                           bool normalized) {
+  std::vector<int> keep;
+  for (int idx : order) {
+    bool flag = true;
+    for (size_t k = 0; k < keep.size() && flag; ++k) {
+      float overlap = math::JaccardOverlap<float>(
+          boxes.data() + idx * 4, boxes.data() + keep[k] * 4, normalized);
+      flag = overlap <= threshold;
+    }
+    if (flag) keep.push_back(idx);
+    if (flag && eta < 1 && threshold > 0.5) threshold *= eta;
+  }
+  return keep;
+}
+
+TEST(TestHostNms, nms_candidates) {
+  std::vector<float> scores(1001);
+  fill_data_rand(scores.data(), 0.f, 1.f, scores.size());
+  for (size_t i = 0; i < scores.size(); i += 5) scores[i] = 0.75f;
+  for (int top_k : {-1, 0, 1, 30, 2000}) {
+    std::vector<std::pair<float, int>> basic;
+    for (size_t i = 0; i < scores.size(); ++i) {
+      if (scores[i] > 0.5f) basic.push_back(std::make_pair(scores[i], i));
+    }
+    std::stable_sort(basic.begin(),
+                     basic.end(),
+                     math::SortScorePairDescend<int>);
+    if (top_k > -1 && top_k < static_cast<int>(basic.size())) {
+      basic.resize(top_k);
+    }
+    std::vector<int> order(scores.size());
+    int num = math::nms_candidates(
+        scores.data(), scores.size(), 0.5f, top_k, order.data());
+    ASSERT_EQ(num, static_cast<int>(basic.size())) << top_k;
+    for (int i = 0; i < num; ++i) {
+      EXPECT_EQ(order[i], basic[i].second) << top_k;
+    }
+  }
+}
+
+TEST(TestHostNms, nms_boxes) {
+  for (int n : {1, 5, 64, 333}) {
+    for (bool normalized : {true, false}) {
+      std::vector<float> boxes = make_boxes(n, normalized ? 1.f : 100.f);
+      std::vector<float> scores(n);
+      fill_data_rand(scores.data(), 0.f, 1.f, scores.size());
+      std::vector<int> order(n);
+      int num = math::nms_candidates(scores.data(), n, 0.f, -1, order.data());
+      order.resize(num);
+      for (float threshold : {0.f, 0.3f, 0.7f}) {
+        for (float eta : {1.f, 0.9f}) {
+          std::vector<int> basic =
+              nms_basic(boxes, order, threshold, eta, normalized);
+          std::vector<int> keep(order);
+          int kept = math::nms_boxes(boxes.data(),
+                                     4,
+                                     keep.data(),
+                                     num,
+                                     threshold,
+                                     eta,
+                                     normalized,
+                                     keep.data());
+          keep.resize(kept);
+          EXPECT_EQ(keep, basic) << "n: " << n << ", normalized: "
+                                 << normalized << ", threshold: " << threshold
+                                 << ", eta: " << eta;
+        }
+      }
+    }
+  }
+}
+
+TEST(TestHostNms, nms_iou_matrix) {
+  const int n = 70;
+  std::vector<float> boxes = make_boxes(n, 1.f);
+  std::vector<int> order(n);
+  for (int i = 0; i < n; ++i) order[i] = (i * 17) % n;
+  std::vector<float> iou(n * (n - 1) / 2), iou_max(n);
+  math::nms_iou_matrix(
+      boxes.data(), 4, order.data(), n, true, iou.data(), iou_max.data());
+  EXPECT_EQ(iou_max[0], 0.f);
+  for (int i = 1; i < n; ++i) {
+    float max_iou = 0.f;
+    for (int j = 0; j < i; ++j) {
+      float basic = math::JaccardOverlap<float>(
+          boxes.data() + order[i] * 4, boxes.data() + order[j] * 4, true);
+      EXPECT_EQ(iou[i * (i - 1) / 2 + j], basic) << i << ", " << j;
+      max_iou = std::max(max_iou, basic);
+    }
+    EXPECT_EQ(iou_max[i], max_iou) << i;
+  }
+}
@@ -0,0 +1,145 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+#include "lite/backends/host/math/topk.h"
+#include "lite/core/parallel_defines.h"
+#include "lite/tests/utils/fill_data.h"
+
+namespace math = paddle::lite::host::math;
+
+// The k best of every row by a stable sort, NaN being the largest value.
+template <typename T>
+void topk_basic(const std::vector<T>& x,
+                int outer,
+                int n,
+                int inner,
+                int k,
+                bool largest,
+                std::vector<T>* out_val,
+                std::vector<int64_t>* out_ind) {
+  auto greater = [](T a, T b) { return a > b || (a != a && b == b); };
+  for (int o = 0; o < outer; ++o) {
+    for (int i = 0; i < inner; ++i) {
+      std::vector<std::pair<T, int>> row(n);
+      for (int j = 0; j < n; ++j) {
+        row[j] = std::make_pair(x[(o * n + j) * inner + i], j);
+      }
+      std::stable_sort(row.begin(),
+                       row.end(),
+                       [&](const std::pair<T, int>& a,
+                           const std::pair<T, int>& b) {
+                         return largest ? greater(a.first, b.first)
+                                        : greater(b.first, a.first);
+                       });
+      for (int j = 0; j < k; ++j) {
+        (*out_val)[(o * k + j) * inner + i] = row[j].first;
+        (*out_ind)[(o * k + j) * inner + i] = row[j].second;
+      }
+    }
+  }
+}
+
+template <typename T>
+bool test_topk(const std::vector<T>& x,
+               int outer,
+               int n,
+               int inner,
+               int k,
+               bool largest) {
+  std::vector<T> val(outer * k * inner), val_basic(val.size());
+  std::vector<int64_t> ind(val.size()), ind_basic(val.size());
+  topk_basic(x, outer, n, inner, k, largest, &val_basic, &ind_basic);
+  math::topk_axis(
+      x.data(), outer, n, inner, k, largest, val.data(), ind.data());
+  return ind == ind_basic;
+}
+
+TEST(TestHostTopk, topk_axis_float) {
+  for (int outer : {1, 3, 40}) {
+    for (int n : {1, 7, 8, 100, 1000}) {
+      for (int inner : {1, 5}) {
+        std::vector<float> x(outer * n * inner);
+        fill_data_rand(x.data(), -1.f, 1.f, x.size());
+        // Ties and NaN.
+        for (size_t i = 0; i < x.size(); i += 7) x[i] = 0.5f;
+        if (x.size() > 20) x[20] = std::numeric_limits<float>::quiet_NaN();
+        for (int k : {1, 3, n / 8, n / 2, n}) {
+          if (k <= 0 || k > n) continue;
+          for (bool largest : {true, false}) {
+            EXPECT_TRUE(test_topk(x, outer, n, inner, k, largest))
+                << "outer: " << outer << ", n: " << n << ", inner: " << inner
+                << ", k: " << k << ", largest: " << largest;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(TestHostTopk, topk_axis_int) {
+  const int outer = 6, n = 300, inner = 2;
+  std::vector<int64_t> x(outer * n * inner);
+  fill_data_rand<int64_t>(x.data(), -20, 20, x.size());
+  std::vector<int32_t> x32(x.begin(), x.end());
+  for (int k : {1, 10, 200, n}) {
+    for (bool largest : {true, false}) {
+      EXPECT_TRUE(test_topk(x, outer, n, inner, k, largest)) << k;
+      EXPECT_TRUE(test_topk(x32, outer, n, inner, k, largest)) << k;
+    }
+  }
+}
+
+TEST(TestHostTopk, sort_topk_pairs) {
+  std::vector<float> scores(500);
+  fill_data_rand(scores.data(), 0.f, 1.f, scores.size());
+  for (size_t i = 0; i < scores.size(); i += 3) scores[i] = 0.25f;
+  for (int k : {0, 1, 50, 500, 600}) {
+    std::vector<std::pair<float, int>> pairs, pairs_basic;
+    for (size_t i = 0; i < scores.size(); ++i) {
+      pairs.push_back(std::make_pair(scores[i], static_cast<int>(i)));
+    }
+    pairs_basic = pairs;
+    std::stable_sort(
+        pairs_basic.begin(),
+        pairs_basic.end(),
+        [](const std::pair<float, int>& a, const std::pair<float, int>& b) {
+          return a.first > b.first;
+        });
+    math::sort_topk_pairs(pairs.data(), pairs.size(), k, true);
+    int size = std::min<int>(k, pairs.size());
+    EXPECT_TRUE(std::equal(
+        pairs.begin(), pairs.begin() + size, pairs_basic.begin()))
+        << k;
+  }
+}
+
+#ifdef LITE_USE_THREAD_POOL
+TEST(TestHostTopk, topk_axis_threads) {
+  const int outer = 64, n = 2000, inner = 3;
+  std::vector<float> x(outer * n * inner);
+  fill_data_rand(x.data(), -1.f, 1.f, x.size());
+  for (int threads : {1, 4}) {
+    auto pool = paddle::lite::ThreadPool::Create(threads);
+    paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+    EXPECT_TRUE(test_topk(x, outer, n, inner, 20, true)) << threads;
+    EXPECT_TRUE(test_topk(x, outer, n, inner, n, false)) << threads;
+  }
+}
+#endif
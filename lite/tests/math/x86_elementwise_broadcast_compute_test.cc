@@ -0,0 +1,181 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "lite/backends/x86/math/elementwise_broadcast.h"
+#include "lite/core/thread_pool.h"
+#include "lite/tests/utils/fill_data.h"
+#include "lite/utils/log/cp_logging.h"
+
+using paddle::lite::DDim;
+
+namespace math = paddle::lite::x86::math;
+
+// x and y padded by 1 to the rank of out, by the rule of the elementwise ops.
+void pad_dims(const DDim& x_dims,
+              const DDim& y_dims,
+              int axis,
+              std::vector<int64_t>* x_full,
+              std::vector<int64_t>* y_full) {
+  const int x_rank = x_dims.size();
+  const int y_rank = y_dims.size();
+  const int rank = std::max(x_rank, y_rank);
+  if (axis == -1) axis = std::abs(x_rank - y_rank);
+  x_full->assign(rank, 1);
+  y_full->assign(rank, 1);
+  for (int i = 0; i < x_rank; ++i) {
+    (*x_full)[(x_rank < y_rank ? axis : 0) + i] = x_dims[i];
+  }
+  for (int i = 0; i < y_rank; ++i) {
+    (*y_full)[(x_rank < y_rank ? 0 : axis) + i] = y_dims[i];
+  }
+}
+
+// out = op(x, y) of the broadcast x and y, by the index of every element.
+template <typename T, typename Op>
+std::vector<T> elementwise_basic(const std::vector<T>& x,
+                                 const DDim& x_dims,
+                                 const std::vector<T>& y,
+                                 const DDim& y_dims,
+                                 int axis,
+                                 Op op) {
+  std::vector<int64_t> x_full, y_full;
+  pad_dims(x_dims, y_dims, axis, &x_full, &y_full);
+  const int rank = x_full.size();
+  int64_t size = 1;
+  for (int i = 0; i < rank; ++i) {
+    const bool empty = x_full[i] == 0 || y_full[i] == 0;
+    size *= empty ? 0 : std::max(x_full[i], y_full[i]);
+  }
+  std::vector<T> out(size);
+  for (int64_t i = 0; i < size; ++i) {
+    int64_t rest = i, x_index = 0, y_index = 0, x_step = 1, y_step = 1;
+    for (int d = rank - 1; d >= 0; --d) {
+      const int64_t dim = std::max(x_full[d], y_full[d]);
+      const int64_t index = rest % dim;
+      rest /= dim;
+      if (x_full[d] != 1) x_index += index * x_step;
+      if (y_full[d] != 1) y_index += index * y_step;
+      x_step *= x_full[d];
+      y_step *= y_full[d];
+    }
+    out[i] = op(x[x_index], y[y_index]);
+  }
+  return out;
+}
+
+template <class Config, typename Op>
+void test_elementwise_broadcast(const DDim& x_dims,
+                                const DDim& y_dims,
+                                int axis,
+                                Op op) {
+  using T = typename Config::T;
+  std::vector<T> x(x_dims.production()), y(y_dims.production());
+  for (auto& v : x) v = static_cast<T>(std::rand() % 200 - 100) / 4;
+  for (auto& v : y) v = static_cast<T>(std::rand() % 100 + 1) / 4;
+  auto ref = elementwise_basic(x, x_dims, y, y_dims, axis, op);
+  for (int threads : {1, 4}) {
+    auto pool = paddle::lite::ThreadPool::Create(threads);
+    paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+    std::vector<T> out(ref.size());
+    auto plan = math::elementwise_broadcast_plan(x_dims, y_dims, axis);
+    math::elementwise_broadcast<Config>(x.data(), y.data(), out.data(), plan);
+    for (size_t i = 0; i < ref.size(); ++i) {
+      ASSERT_NEAR(out[i], ref[i], 1e-5 * (std::abs(ref[i]) + 1))
+          << "x: " << x_dims << ", y: " << y_dims << ", axis: " << axis
+          << ", threads: " << threads << ", i: " << i;
+    }
+  }
+}
+
+TEST(TestX86ElementwiseBroadcast, plan) {
+  // A channel, the same with trailing 1, a scalar and a mid-axis broadcast
+  // of both x and y.
+  auto plan = math::elementwise_broadcast_plan(
+      DDim({2, 3, 4, 5}), DDim({3}), 1);
+  EXPECT_EQ(plan.dims, std::vector<int64_t>({2, 3, 20}));
+  EXPECT_EQ(plan.x_strides, std::vector<int64_t>({60, 20, 1}));
+  EXPECT_EQ(plan.y_strides, std::vector<int64_t>({0, 1, 0}));
+  plan = math::elementwise_broadcast_plan(
+      DDim({2, 3, 4, 5}), DDim({1, 3, 1, 1}), -1);
+  EXPECT_EQ(plan.dims, std::vector<int64_t>({2, 3, 20}));
+  plan = math::elementwise_broadcast_plan(DDim({2, 3, 4, 5}), DDim({1}), -1);
+  EXPECT_EQ(plan.dims, std::vector<int64_t>({120}));
+  EXPECT_EQ(plan.y_strides, std::vector<int64_t>({0}));
+  plan = math::elementwise_broadcast_plan(
+      DDim({2, 1, 4, 5}), DDim({2, 3, 1, 1}), -1);
+  EXPECT_EQ(plan.dims, std::vector<int64_t>({2, 3, 20}));
+  EXPECT_EQ(plan.x_strides, std::vector<int64_t>({20, 0, 1}));
+  EXPECT_EQ(plan.y_strides, std::vector<int64_t>({3, 1, 0}));
+  // A dimension of 0 is not dropped like one of 1.
+  plan = math::elementwise_broadcast_plan(DDim({0, 3}), DDim({3}), -1);
+  EXPECT_EQ(plan.dims, std::vector<int64_t>({0}));
+  plan = math::elementwise_broadcast_plan(DDim({1, 3}), DDim({0, 1}), -1);
+  EXPECT_EQ(plan.dims, std::vector<int64_t>({0}));
+}
+
+TEST(TestX86ElementwiseBroadcast, compute) {
+  using AddConfig = math::MergeConfig<
+      math::AddConfig<float>,
+      math::ActiveConfig<math::ActiveType::NO_ACTIVE, float>>;
+  using SubReluConfig =
+      math::MergeConfig<math::SubConfig<float>,
+                        math::ActiveConfig<math::ActiveType::RELU, float>>;
+  using DivConfig = math::MergeConfig<
+      math::DivConfig<float>,
+      math::ActiveConfig<math::ActiveType::NO_ACTIVE, float>>;
+  using MulInt32Config = math::MergeConfig<
+      math::MulConfig<int32_t>,
+      math::ActiveConfig<math::ActiveType::NO_ACTIVE, int32_t>>;
+  struct Case {
+    DDim x_dims;
+    DDim y_dims;
+    int axis;
+  };
+  const std::vector<Case> cases{
+      {DDim({4, 16, 33, 35}), DDim({4, 16, 33, 35}), -1},
+      {DDim({4, 16, 33, 35}), DDim({1}), -1},
+      {DDim({4, 16, 33, 35}), DDim({16}), 1},
+      {DDim({4, 16, 33, 35}), DDim({35}), -1},
+      {DDim({4, 16, 33, 35}), DDim({4, 1, 33, 35}), -1},
+      {DDim({4, 16, 33, 35}), DDim({16, 33, 1}), 1},
+      {DDim({4, 1, 33, 1}), DDim({1, 16, 1, 35}), -1},
+      {DDim({16}), DDim({4, 16, 33, 35}), 1},
+      {DDim({33, 35}), DDim({4, 16, 33, 35}), -1},
+      {DDim({1, 70000}), DDim({3, 1}), -1},
+      {DDim({3}), DDim({3}), -1},
+      {DDim({0, 3}), DDim({3}), -1},
+      {DDim({0, 3}), DDim({1}), -1}};
+  for (auto& c : cases) {
+    test_elementwise_broadcast<AddConfig>(
+        c.x_dims, c.y_dims, c.axis, [](float a, float b) { return a + b; });
+    test_elementwise_broadcast<SubReluConfig>(
+        c.x_dims, c.y_dims, c.axis, [](float a, float b) {
+          return std::max(a - b, 0.f);
+        });
+    test_elementwise_broadcast<DivConfig>(
+        c.x_dims, c.y_dims, c.axis, [](float a, float b) { return a / b; });
+    test_elementwise_broadcast<MulInt32Config>(
+        c.x_dims, c.y_dims, c.axis, [](int32_t a, int32_t b) {
+          return a * b;
+        });
+  }
+}
+
+#endif  // LITE_WITH_X86
@@ -0,0 +1,218 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <string.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "lite/backends/x86/math/gemm_bf16.h"
+#include "lite/core/thread_pool.h"
+#include "lite/tests/utils/fill_data.h"
+#include "lite/tests/utils/naive_math_impl.h"
+#include "lite/utils/log/cp_logging.h"
+
+using paddle::lite::bfloat16;
+using paddle::lite::x86::math::GemmBf16Isa;
+using paddle::lite::x86::math::gemm_bf16_isa;
+
+namespace math = paddle::lite::x86::math;
+
+const char* isa_name(GemmBf16Isa isa) {
+  switch (isa) {
+    case GemmBf16Isa::kAmx:
+      return "amx";
+    case GemmBf16Isa::kAvx512Bf16:
+      return "avx512_bf16";
+    case GemmBf16Isa::kAvx512:
+      return "avx512";
+    default:
+      return "fp32";
+  }
+}
+
+// The kernels the cpu runs.
+std::vector<GemmBf16Isa> supported_isas() {
+  std::vector<GemmBf16Isa> isas;
+  for (GemmBf16Isa isa : {GemmBf16Isa::kFp32,
+                          GemmBf16Isa::kAvx512,
+                          GemmBf16Isa::kAvx512Bf16,
+                          GemmBf16Isa::kAmx}) {
+    if (isa <= gemm_bf16_isa()) isas.push_back(isa);
+  }
+  return isas;
+}
+
+std::vector<float> round_bf16(const std::vector<float>& x) {
+  std::vector<float> y(x.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    y[i] = static_cast<float>(bfloat16(x[i]));
+  }
+  return y;
+}
+
+// C = op(A) * op(B) of A and B rounded to bf16, op(A) packed from floats and
+// op(B) from bf16.
+bool test_gemm_bf16(
+    GemmBf16Isa isa, bool tra, bool trb, int m, int n, int k, int ldc_pad) {
+  int lda = tra ? m : k;
+  int ldb = trb ? k : n;
+  int ldc = n + ldc_pad;
+  std::vector<float> a(m * k), b(k * n), c(m * ldc), c_basic(m * ldc);
+  fill_data_rand(a.data(), -1.f, 1.f, a.size());
+  fill_data_rand(b.data(), -1.f, 1.f, b.size());
+  fill_data_rand(c.data(), -1.f, 1.f, c.size());
+  c_basic = c;
+  std::vector<float> a_bf16 = round_bf16(a), b_bf16 = round_bf16(b);
+  basic_gemm<float, float>(tra,
+                           trb,
+                           m,
+                           n,
+                           k,
+                           1.f,
+                           a_bf16.data(),
+                           lda,
+                           b_bf16.data(),
+                           ldb,
+                           0.f,
+                           c_basic.data(),
+                           ldc,
+                           nullptr);
+  std::vector<bfloat16> b_half(b.size());
+  math::fp32_to_bf16(b.data(), b_half.data(), b.size());
+  std::vector<bfloat16> packed_a(math::gemm_bf16_packed_A_size(m, k));
+  std::vector<bfloat16> packed_b(math::gemm_bf16_packed_B_size(k, n));
+  math::gemm_bf16_pack_A(tra, m, k, a.data(), lda, packed_a.data());
+  math::gemm_bf16_pack_B(trb, k, n, b_half.data(), ldb, packed_b.data());
+  math::gemm_bf16_packed(
+      m, n, k, packed_a.data(), packed_b.data(), c.data(), ldc, isa);
+  // The padding of the rows is left as is.
+  for (int i = 0; i < m; ++i) {
+    for (int j = n; j < ldc; ++j) {
+      if (c[i * ldc + j] != c_basic[i * ldc + j]) return false;
+    }
+  }
+  return max_rel_diff(c, c_basic) < 1e-4f;
+}
+
+TEST(TestX86GemmBf16, bf16_convert) {
+  // The ties go to the even mantissa.
+  EXPECT_EQ(bfloat16(1.f + 1.f / 256).x, bfloat16(1.f).x);
+  EXPECT_EQ(bfloat16(1.f + 3.f / 256).x, bfloat16(1.f + 1.f / 64).x);
+  EXPECT_EQ(static_cast<float>(bfloat16(-2.5f)), -2.5f);
+  EXPECT_TRUE(std::isnan(static_cast<float>(
+      bfloat16(std::numeric_limits<float>::quiet_NaN()))));
+  EXPECT_TRUE(std::isinf(static_cast<float>(bfloat16(3.4e38f))));
+
+  std::vector<float> x(1000), y(1000);
+  fill_data_rand(x.data(), -100.f, 100.f, x.size());
+  x[3] = std::numeric_limits<float>::quiet_NaN();
+  x[20] = 1.f + 1.f / 256;
+  std::vector<bfloat16> x_half(x.size());
+  math::fp32_to_bf16(x.data(), x_half.data(), x.size());
+  math::bf16_to_fp32(x_half.data(), y.data(), y.size());
+  for (size_t i = 0; i < x.size(); ++i) {
+    EXPECT_EQ(x_half[i].x, bfloat16(x[i]).x) << i;
+    if (i != 3) {
+      EXPECT_EQ(y[i], static_cast<float>(bfloat16(x[i]))) << i;
+    }
+  }
+  EXPECT_TRUE(std::isnan(y[3]));
+}
+
+TEST(TestX86GemmBf16, gemm_bf16_compute) {
+  for (GemmBf16Isa isa : supported_isas()) {
+    LOG(INFO) << "kernels: " << isa_name(isa);
+    for (int m : {1, 5, 16, 37, 100}) {
+      for (int n : {1, 15, 33, 260}) {
+        for (int k : {1, 31, 64, 300}) {
+          for (bool tra : {false, true}) {
+            for (bool trb : {false, true}) {
+              EXPECT_TRUE(test_gemm_bf16(isa, tra, trb, m, n, k, 0))
+                  << isa_name(isa) << ", m: " << m << ", n: " << n
+                  << ", k: " << k << ", tra: " << tra << ", trb: " << trb;
+            }
+          }
+        }
+      }
+    }
+    EXPECT_TRUE(test_gemm_bf16(isa, false, false, 48, 70, 530, 3));
+  }
+}
+
+TEST(TestX86GemmBf16, gemm_bf16_prepacked) {
+  // fc: C = A * W of the prepacked W, conv2d: C = W * col of the prepacked W.
+  const int m = 67, n = 150, k = 290;
+  std::vector<float> a(m * k), w(k * n), c(m * n), c_basic(m * n);
+  fill_data_rand(a.data(), -1.f, 1.f, a.size());
+  fill_data_rand(w.data(), -1.f, 1.f, w.size());
+  std::vector<float> a_bf16 = round_bf16(a), w_bf16 = round_bf16(w);
+  basic_gemm<float, float>(false,
+                           false,
+                           m,
+                           n,
+                           k,
+                           1.f,
+                           a_bf16.data(),
+                           k,
+                           w_bf16.data(),
+                           n,
+                           0.f,
+                           c_basic.data(),
+                           n,
+                           nullptr);
+  for (int threads : {1, 4}) {
+    auto pool = paddle::lite::ThreadPool::Create(threads);
+    paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+    std::vector<bfloat16> packed_w(math::gemm_bf16_packed_B_size(k, n));
+    math::gemm_bf16_pack_B(false, k, n, w.data(), n, packed_w.data());
+    std::fill(c.begin(), c.end(), 0.f);
+    math::gemm_bf16(false, m, n, k, a.data(), k, packed_w.data(), c.data(), n);
+    EXPECT_LT(max_rel_diff(c, c_basic), 1e-4f) << "threads: " << threads;
+
+    std::vector<bfloat16> packed_a(math::gemm_bf16_packed_A_size(m, k));
+    math::gemm_bf16_pack_A(false, m, k, a.data(), k, packed_a.data());
+    std::fill(c.begin(), c.end(), 0.f);
+    math::gemm_bf16_prepacked_A(
+        m, n, k, packed_a.data(), false, w.data(), n, c.data(), n);
+    EXPECT_LT(max_rel_diff(c, c_basic), 1e-4f) << "threads: " << threads;
+  }
+}
+
+TEST(TestX86GemmBf16, pack_persistable_B) {
+  const int k = 33, n = 20;
+  paddle::lite::Tensor w;
+  w.Resize({k, n});
+  fill_data_rand(w.mutable_data<float>(), -1.f, 1.f, w.numel());
+  EXPECT_EQ(math::gemm_bf16_pack_persistable_B(w, false, k, n, n), nullptr);
+
+  w.set_persistable(true);
+  auto packed = math::gemm_bf16_pack_persistable_B(w, false, k, n, n);
+  ASSERT_NE(packed, nullptr);
+  std::vector<bfloat16> packed_ref(math::gemm_bf16_packed_B_size(k, n));
+  math::gemm_bf16_pack_B(false, k, n, w.data<float>(), n, packed_ref.data());
+  ASSERT_EQ(packed->numel(), static_cast<int64_t>(packed_ref.size()));
+  EXPECT_EQ(memcmp(packed->data<bfloat16>(),
+                   packed_ref.data(),
+                   packed_ref.size() * sizeof(bfloat16)),
+            0);
+  // The kernels of the cloned predictors share the pack of a weight.
+  EXPECT_EQ(math::gemm_bf16_pack_persistable_B(w, false, k, n, n), packed);
+  EXPECT_NE(math::gemm_bf16_pack_persistable_B(w, true, n, k, k), packed);
+}
+
+#endif  // LITE_WITH_X86
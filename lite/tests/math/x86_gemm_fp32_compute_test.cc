@@ -0,0 +1,212 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "lite/backends/x86/math/gemm_fp32_compute.h"
+#include "lite/backends/x86/math/gemm_fp32_kernel.h"
+#include "lite/backends/x86/math/packed_weight.h"
+#include "lite/core/thread_pool.h"
+#include "lite/tests/utils/fill_data.h"
+#include "lite/tests/utils/naive_math_impl.h"
+#include "lite/utils/log/cp_logging.h"
+
+using paddle::lite::x86::math::gemm_fp32;
+using paddle::lite::x86::math::gemm_fp32_available;
+using paddle::lite::x86::math::gemm_fp32_batch;
+using paddle::lite::x86::math::PackedGemmWeight;
+
+bool test_gemm_fp32(bool tra,
+                    bool trb,
+                    int m,
+                    int n,
+                    int k,
+                    float alpha,
+                    float beta,
+                    int ldc_pad = 0) {
+  int lda = tra ? m : k;
+  int ldb = trb ? k : n;
+  int ldc = n + ldc_pad;
+  std::vector<float> a(m * k), b(k * n), c(m * ldc), c_basic;
+  fill_data_rand(a.data(), -1.f, 1.f, a.size());
+  fill_data_rand(b.data(), -1.f, 1.f, b.size());
+  fill_data_rand(c.data(), -1.f, 1.f, c.size());
+  c_basic = c;
+  basic_gemm<float, float>(tra,
+                           trb,
+                           m,
+                           n,
+                           k,
+                           alpha,
+                           a.data(),
+                           lda,
+                           b.data(),
+                           ldb,
+                           beta,
+                           c_basic.data(),
+                           ldc,
+                           nullptr);
+  gemm_fp32(tra,
+            trb,
+            m,
+            n,
+            k,
+            alpha,
+            a.data(),
+            lda,
+            b.data(),
+            ldb,
+            beta,
+            c.data(),
+            ldc);
+  // The padding of the rows is left as is.
+  for (int i = 0; i < m; ++i) {
+    for (int j = n; j < ldc; ++j) {
+      if (c[i * ldc + j] != c_basic[i * ldc + j]) return false;
+    }
+  }
+  return max_rel_diff(c, c_basic) < 1e-4f;
+}
+
+TEST(TestX86GemmFp32, gemm_fp32_compute) {
+  if (!gemm_fp32_available()) {
+    LOG(INFO) << "skip, the cpu has no AVX2";
+    return;
+  }
+  LOG(INFO) << "micro-kernel: "
+            << paddle::lite::x86::math::gemm_fp32_select_kernel()->name;
+  for (int m : {1, 2, 5, 12, 37, 150}) {
+    for (int n : {1, 15, 33, 47, 260}) {
+      for (int k : {1, 7, 64, 300}) {
+        for (bool tra : {false, true}) {
+          for (bool trb : {false, true}) {
+            EXPECT_TRUE(test_gemm_fp32(tra, trb, m, n, k, 1.f, 0.f))
+                << "m: " << m << ", n: " << n << ", k: " << k
+                << ", tra: " << tra << ", trb: " << trb;
+          }
+        }
+      }
+    }
+  }
+  EXPECT_TRUE(test_gemm_fp32(false, false, 67, 45, 530, 0.5f, 1.f));
+  EXPECT_TRUE(test_gemm_fp32(true, false, 29, 70, 257, 2.f, -0.5f, 3));
+  EXPECT_TRUE(test_gemm_fp32(false, true, 16, 16, 0, 1.f, 0.5f));
+}
+
+TEST(TestX86GemmFp32, gemm_fp32_threads) {
+  if (!gemm_fp32_available()) return;
+  auto pool = paddle::lite::ThreadPool::Create(4);
+  paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+  EXPECT_TRUE(test_gemm_fp32(false, false, 300, 500, 600, 1.f, 0.f));
+  EXPECT_TRUE(test_gemm_fp32(false, true, 49, 1024, 512, 1.f, 1.f));
+  EXPECT_TRUE(test_gemm_fp32(true, false, 7, 20, 33, 1.f, 0.f));
+  // One row, e.g. fc at batch size 1.
+  EXPECT_TRUE(test_gemm_fp32(false, false, 1, 1000, 1024, 1.f, 0.f));
+  EXPECT_TRUE(test_gemm_fp32(false, true, 1, 999, 300, 0.5f, 1.f));
+}
+
+TEST(TestX86GemmFp32, gemm_fp32_batch) {
+  if (!gemm_fp32_available()) return;
+  // The attention scores of 12 heads, q * k^T.
+  const int batch = 12, m = 50, n = 50, k = 64;
+  std::vector<float> q(batch * m * k), kt(batch * n * k);
+  std::vector<float> c(batch * m * n), c_basic(batch * m * n);
+  fill_data_rand(q.data(), -1.f, 1.f, q.size());
+  fill_data_rand(kt.data(), -1.f, 1.f, kt.size());
+  for (int i = 0; i < batch; ++i) {
+    basic_gemm<float, float>(false,
+                             true,
+                             m,
+                             n,
+                             k,
+                             0.125f,
+                             q.data() + i * m * k,
+                             k,
+                             kt.data() + i * n * k,
+                             k,
+                             0.f,
+                             c_basic.data() + i * m * n,
+                             n,
+                             nullptr);
+  }
+  for (int threads : {1, 4}) {
+    auto pool = paddle::lite::ThreadPool::Create(threads);
+    paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+    std::fill(c.begin(), c.end(), 0.f);
+    gemm_fp32_batch(false,
+                    true,
+                    m,
+                    n,
+                    k,
+                    0.125f,
+                    q.data(),
+                    k,
+                    m * k,
+                    kt.data(),
+                    k,
+                    n * k,
+                    0.f,
+                    c.data(),
+                    n,
+                    m * n,
+                    batch);
+    EXPECT_LT(max_rel_diff(c, c_basic), 1e-4f) << "threads: " << threads;
+  }
+}
+
+TEST(TestX86GemmFp32, packed_weight) {
+  if (!PackedGemmWeight::Available()) return;
+  // The weights of fc, the rows of W are padded as in fc_fuse_pass.
+  for (bool trw : {false, true}) {
+    for (int m : {1, 3, 40}) {
+      for (int k : {7, 300}) {
+        const int n = 70, ldw = (trw ? k : n) + 4;
+        const int lda = trw ? m : k;
+        std::vector<float> w((trw ? n : k) * ldw), a(m * k);
+        std::vector<float> c(m * n), c_basic(m * n);
+        fill_data_rand(w.data(), -1.f, 1.f, w.size());
+        fill_data_rand(a.data(), -1.f, 1.f, a.size());
+        fill_data_rand(c_basic.data(), -1.f, 1.f, c_basic.size());
+        c = c_basic;
+        basic_gemm<float, float>(trw,
+                                 trw,
+                                 m,
+                                 n,
+                                 k,
+                                 0.5f,
+                                 a.data(),
+                                 lda,
+                                 w.data(),
+                                 ldw,
+                                 1.f,
+                                 c_basic.data(),
+                                 n,
+                                 nullptr);
+        auto packed = PackedGemmWeight::Get(w.data(), trw, k, n, ldw, 0.5f, m);
+        // The kernels reading the same weight share its packed data.
+        EXPECT_EQ(packed,
+                  PackedGemmWeight::Get(w.data(), trw, k, n, ldw, 0.5f, 1));
+        packed->Compute(trw, m, a.data(), lda, 1.f, c.data(), n);
+        EXPECT_LT(max_rel_diff(c, c_basic), 1e-4f)
+            << "m: " << m << ", k: " << k << ", trw: " << trw;
+      }
+    }
+  }
+}
+
+#endif  // LITE_WITH_X86
@@ -24,6 +24,7 @@
 #include <gtest/gtest.h>
 #include <string.h>
 #include <algorithm>
+#include <vector>
 #include "lite/backends/x86/math/blas.h"
 #include "lite/backends/x86/math/gemm_s8u8_compute.h"
 #include "lite/core/context.h"
@@ -353,6 +354,198 @@ bool test_gemm_s8u8f32(
   return true;
 }
 
+// The per-channel scales and the bias of the columns of fc, with relu6 or
+// leaky relu, checked against the float gemm of the dequantized data.
+template <typename TYPE_C>
+bool test_gemm_s8u8_channel(
+    bool tra, bool trb, int m, int n, int k, int relu_type) {
+  // The VNNI kernels sum in int32, maddubs saturates int16 pairs.
+  bool vnni = paddle::lite::x86::math::gemm_s8u8_vnni_available();
+  int a_max = vnni ? 127 : 63;
+  std::vector<int8_t> a(m * k), b(k * n);
+  std::vector<float> a_f32(m * k), b_f32(k * n), c_basic(m * n);
+  std::vector<float> sa(m, 1 / 127.f), sb_n(n), bias_n(n);
+  std::vector<TYPE_C> c(m * n);
+  fill_data_rand(a.data(),
+                 static_cast<int8_t>(-a_max),
+                 static_cast<int8_t>(a_max),
+                 a.size());
+  fill_data_rand(b.data(),
+                 static_cast<int8_t>(-127),
+                 static_cast<int8_t>(127),
+                 b.size());
+  fill_data_rand(sb_n.data(), 0.5f, 2.f, n);
+  fill_data_rand(bias_n.data(), -1.f, 1.f, n);
+  const float Sb = 1 / 127.f;
+  const float Sc = std::is_same<TYPE_C, int8_t>::value ? 4 / 127.f : 1.f;
+  const float alpha = relu_type == 2 ? 1.5f : 0.1f;
+  int lda = tra ? m : k;
+  int ldb = trb ? k : n;
+  for (int i = 0; i < m * k; i++) a_f32[i] = a[i] / 127.f;
+  for (int i = 0; i < k * n; i++) {
+    int col = trb ? i / k : i % n;
+    b_f32[i] = b[i] * Sb * sb_n[col];
+  }
+  basic_gemm_fp32(tra,
+                  trb,
+                  m,
+                  n,
+                  k,
+                  a_f32.data(),
+                  lda,
+                  b_f32.data(),
+                  ldb,
+                  c_basic.data(),
+                  n);
+  paddle::lite::x86::math::generate_gemm_s8u8_x86_kern<TYPE_C> gemm(
+      tra,
+      trb,
+      m,
+      n,
+      k,
+      a.data(),
+      n,
+      sa.data(),
+      Sb,
+      Sc,
+      nullptr,
+      relu_type,
+      relu_type == 2 ? alpha / Sc : alpha,
+      sb_n.data(),
+      bias_n.data());
+  gemm.compute(a.data(), b.data(), c.data());
+  for (int i = 0; i < m * n; i++) {
+    float ref = c_basic[i] + bias_n[i % n];
+    if (relu_type == 2) {
+      ref = std::min(std::max(ref, 0.f), alpha);
+    } else if (relu_type == 3) {
+      ref = ref > 0.f ? ref : ref * alpha;
+    }
+    ref /= Sc;
+    if (std::is_same<TYPE_C, int8_t>::value) {
+      ref = std::min(std::max(std::round(ref), -127.f), 127.f);
+      if (std::fabs(c[i] - ref) > 1.f) return false;
+    } else if (std::fabs(c[i] - ref) > 1e-3f * (std::fabs(ref) + 1.f)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// gemm_s8u8_quantized with relu6 of a float threshold, B being packed on
+// every call and packed once, which give the same C.
+template <typename TYPE_C>
+bool test_gemm_s8u8_quantized(bool tra, bool trb, int m, int n, int k) {
+  bool vnni = paddle::lite::x86::math::gemm_s8u8_vnni_available();
+  int a_max = vnni ? 127 : 63;
+  std::vector<int8_t> a(m * k), b(k * n);
+  std::vector<float> c_basic(m * n), sb(n), bias_n(n);
+  std::vector<TYPE_C> c(m * n), c_packed(m * n);
+  fill_data_rand(a.data(),
+                 static_cast<int8_t>(-a_max),
+                 static_cast<int8_t>(a_max),
+                 a.size());
+  fill_data_rand(b.data(),
+                 static_cast<int8_t>(-127),
+                 static_cast<int8_t>(127),
+                 b.size());
+  fill_data_rand(sb.data(), 0.5f / 127, 2.f / 127, n);
+  fill_data_rand(bias_n.data(), -1.f, 1.f, n);
+  const float Sa = 1 / 127.f;
+  const float Sc = std::is_same<TYPE_C, int8_t>::value ? 4 / 127.f : 1.f;
+  const float threshold = 1.5f;
+  std::vector<float> a_f32(m * k), b_f32(k * n);
+  for (int i = 0; i < m * k; i++) a_f32[i] = a[i] * Sa;
+  for (int i = 0; i < k * n; i++) b_f32[i] = b[i] * sb[trb ? i / k : i % n];
+  basic_gemm_fp32(tra,
+                  trb,
+                  m,
+                  n,
+                  k,
+                  a_f32.data(),
+                  tra ? m : k,
+                  b_f32.data(),
+                  trb ? k : n,
+                  c_basic.data(),
+                  n);
+  std::vector<uint8_t> packed_b(
+      paddle::lite::x86::math::gemm_s8u8_packed_B_size(n, k));
+  paddle::lite::x86::math::gemm_s8u8_pack_B(
+      trb, n, k, b.data(), packed_b.data());
+  for (auto *out : {&c, &c_packed}) {
+    paddle::lite::x86::math::gemm_s8u8_quantized(
+        tra,
+        trb,
+        m,
+        n,
+        k,
+        1.f,
+        a.data(),
+        Sa,
+        b.data(),
+        sb,
+        Sc,
+        bias_n.data(),
+        2,
+        threshold,
+        out->data(),
+        n,
+        out == &c_packed ? packed_b.data() : nullptr);
+  }
+  for (int i = 0; i < m * n; i++) {
+    if (c[i] != c_packed[i]) return false;
+    float ref = c_basic[i] + bias_n[i % n];
+    ref = std::min(std::max(ref, 0.f), threshold) / Sc;
+    if (std::is_same<TYPE_C, int8_t>::value) {
+      ref = std::min(std::max(std::round(ref), -127.f), 127.f);
+      if (std::fabs(c[i] - ref) > 1.f) return false;
+    } else if (std::fabs(c[i] - ref) > 1e-3f * (std::fabs(ref) + 1.f)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+TEST(TestX86LiteGemmInt8, gemm_s8u8_quantized) {
+  for (int m : {1, 5, 400}) {
+    for (int n : {7, 75, 300}) {
+      for (int k : {33, 301}) {
+        for (bool tra : {false, true}) {
+          for (bool trb : {false, true}) {
+            EXPECT_TRUE(test_gemm_s8u8_quantized<int8_t>(tra, trb, m, n, k))
+                << "int8 m: " << m << ", n: " << n << ", k: " << k;
+            EXPECT_TRUE(test_gemm_s8u8_quantized<float>(tra, trb, m, n, k))
+                << "float m: " << m << ", n: " << n << ", k: " << k;
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(TestX86LiteGemmInt8, gemm_s8u8_channel) {
+  LOG(INFO) << "vnni: "
+            << paddle::lite::x86::math::gemm_s8u8_vnni_available();
+  for (int m : {1, 2, 3, 5, 16}) {
+    for (int n : {1, 7, 31, 64, 75}) {
+      for (int k : {4, 33, 301}) {
+        for (bool tra : {false, true}) {
+          for (bool trb : {false, true}) {
+            for (int relu_type : {0, 2, 3}) {
+              EXPECT_TRUE(test_gemm_s8u8_channel<int8_t>(
+                  tra, trb, m, n, k, relu_type))
+                  << "int8 m: " << m << ", n: " << n << ", k: " << k;
+              EXPECT_TRUE(test_gemm_s8u8_channel<float>(
+                  tra, trb, m, n, k, relu_type))
+                  << "float m: " << m << ", n: " << n << ", k: " << k;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
 TEST(TestX86LiteGemmInt8, gemm_s8u8_compute) {
 #ifdef GEMM_PROFILE
   pthread_t tid = {0};
@@ -0,0 +1,156 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "lite/backends/x86/math/gemm_weight_only.h"
+#include "lite/core/thread_pool.h"
+#include "lite/tests/utils/fill_data.h"
+#include "lite/tests/utils/naive_math_impl.h"
+
+namespace math = paddle::lite::x86::math;
+
+// Quantize the k x n w by groups of group_size rows into the layout of
+// QuantizedGemmWeight, w is replaced by its dequantized values.
+void quantize_weight(int k,
+                     int n,
+                     int bits,
+                     int group_size,
+                     std::vector<float>* w,
+                     std::vector<int8_t>* q,
+                     std::vector<float>* scales) {
+  const int groups = (k + group_size - 1) / group_size;
+  const float range = bits == 8 ? 127.f : 7.f;
+  const int ldb = bits == 8 ? n : (n + 1) / 2;
+  scales->assign(groups * n, 0.f);
+  q->assign(k * ldb, bits == 8 ? 0 : static_cast<int8_t>(0x88));
+  for (int g = 0; g < groups; ++g) {
+    for (int j = 0; j < n; ++j) {
+      float abs_max = 0.f;
+      for (int i = g * group_size; i < std::min(k, (g + 1) * group_size);
+           ++i) {
+        abs_max = std::max(abs_max, std::fabs((*w)[i * n + j]));
+      }
+      (*scales)[g * n + j] = abs_max / range;
+    }
+  }
+  for (int i = 0; i < k; ++i) {
+    for (int j = 0; j < n; ++j) {
+      const float scale = (*scales)[i / group_size * n + j];
+      const int v =
+          scale > 0.f ? static_cast<int>(std::round((*w)[i * n + j] / scale))
+                      : 0;
+      (*w)[i * n + j] = v * scale;
+      if (bits == 8) {
+        (*q)[i * ldb + j] = static_cast<int8_t>(v);
+      } else {
+        uint8_t* byte = reinterpret_cast<uint8_t*>(q->data() + i * ldb + j / 2);
+        const int shift = (j & 1) ? 4 : 0;
+        *byte = static_cast<uint8_t>((*byte & ~(0x0F << shift)) |
+                                     ((v + 8) << shift));
+      }
+    }
+  }
+}
+
+bool test_gemm_weight_only(
+    int m, int n, int k, int bits, int group_size, int ldc_pad) {
+  if (group_size <= 0) group_size = k;
+  const int ldc = n + ldc_pad;
+  std::vector<float> a(m * k), w(k * n), c(m * ldc), c_basic(m * ldc);
+  fill_data_rand(a.data(), -1.f, 1.f, a.size());
+  fill_data_rand(w.data(), -1.f, 1.f, w.size());
+  fill_data_rand(c.data(), -1.f, 1.f, c.size());
+  c_basic = c;
+  std::vector<int8_t> q;
+  std::vector<float> scales;
+  quantize_weight(k, n, bits, group_size, &w, &q, &scales);
+  basic_gemm<float, float>(false,
+                           false,
+                           m,
+                           n,
+                           k,
+                           1.f,
+                           a.data(),
+                           k,
+                           w.data(),
+                           n,
+                           0.f,
+                           c_basic.data(),
+                           ldc,
+                           nullptr);
+  math::QuantizedGemmWeight b;
+  b.data = q.data();
+  b.ldb = bits == 8 ? n : (n + 1) / 2;
+  b.bits = bits;
+  b.group_size = group_size;
+  b.scales = scales.data();
+  math::gemm_weight_only(m, n, k, a.data(), k, b, c.data(), ldc);
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < ldc; ++j) {
+      const float ref = c_basic[i * ldc + j];
+      const float diff = std::fabs(c[i * ldc + j] - ref);
+      // The padding of the rows is left as is.
+      if (j >= n ? diff != 0.f : diff > 1e-4f * (std::fabs(ref) + 1.f)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+TEST(TestX86GemmWeightOnly, gemm_weight_only_int8) {
+  for (int m : {1, 3, 4, 9, 64}) {
+    for (int n : {1, 15, 16, 37, 200}) {
+      for (int k : {1, 7, 256, 300}) {
+        EXPECT_TRUE(test_gemm_weight_only(m, n, k, 8, 0, 0))
+            << "m: " << m << ", n: " << n << ", k: " << k;
+      }
+    }
+  }
+  EXPECT_TRUE(test_gemm_weight_only(7, 50, 600, 8, 64, 5));
+}
+
+TEST(TestX86GemmWeightOnly, gemm_weight_only_int4) {
+  for (int m : {1, 3, 4, 9, 64}) {
+    for (int n : {1, 15, 16, 37, 200}) {
+      for (int k : {1, 7, 256, 300}) {
+        for (int group_size : {32, 128, 0}) {
+          EXPECT_TRUE(test_gemm_weight_only(m, n, k, 4, group_size, 0))
+              << "m: " << m << ", n: " << n << ", k: " << k
+              << ", group_size: " << group_size;
+        }
+      }
+    }
+  }
+  EXPECT_TRUE(test_gemm_weight_only(7, 51, 600, 4, 64, 3));
+}
+
+TEST(TestX86GemmWeightOnly, gemm_weight_only_threads) {
+  for (int threads : {1, 4}) {
+    auto pool = paddle::lite::ThreadPool::Create(threads);
+    paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+    for (int m : {1, 30, 128}) {
+      EXPECT_TRUE(test_gemm_weight_only(m, 40, 1024, 4, 128, 0))
+          << "threads: " << threads << ", m: " << m;
+      EXPECT_TRUE(test_gemm_weight_only(m, 520, 700, 8, 0, 0))
+          << "threads: " << threads << ", m: " << m;
+    }
+  }
+}
+
+#endif  // LITE_WITH_X86
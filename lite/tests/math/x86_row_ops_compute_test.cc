@@ -0,0 +1,160 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "lite/backends/x86/math/gelu_fp32.h"
+#include "lite/backends/x86/math/layer_norm_fp32.h"
+#include "lite/backends/x86/math/softmax_fp32.h"
+#include "lite/core/thread_pool.h"
+#include "lite/tests/utils/fill_data.h"
+#include "lite/utils/log/cp_logging.h"
+
+namespace math = paddle::lite::x86::math;
+
+// The softmax along the axis of outer x axis_size x inner, in double.
+void softmax_basic(const std::vector<float>& x,
+                   std::vector<float>* y,
+                   int outer,
+                   int axis_size,
+                   int inner) {
+  for (int o = 0; o < outer; ++o) {
+    for (int c = 0; c < inner; ++c) {
+      const float* xc = x.data() + o * axis_size * inner + c;
+      float* yc = y->data() + o * axis_size * inner + c;
+      double max = -std::numeric_limits<double>::infinity();
+      for (int k = 0; k < axis_size; ++k) {
+        max = std::max(max, static_cast<double>(xc[k * inner]));
+      }
+      double sum = 0.0;
+      for (int k = 0; k < axis_size; ++k) sum += std::exp(xc[k * inner] - max);
+      for (int k = 0; k < axis_size; ++k) {
+        yc[k * inner] = std::exp(xc[k * inner] - max) / sum;
+      }
+    }
+  }
+}
+
+float max_abs_diff(const std::vector<float>& a, const std::vector<float>& b) {
+  float max_diff = 0.f;
+  for (size_t i = 0; i < a.size(); ++i) {
+    max_diff = std::max(max_diff, std::fabs(a[i] - b[i]));
+  }
+  return max_diff;
+}
+
+TEST(TestX86RowOps, softmax) {
+  for (int threads : {1, 4}) {
+    auto pool = paddle::lite::ThreadPool::Create(threads);
+    paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+    // The short rows, the long rows of the online softmax and the softmax
+    // along an outer axis.
+    for (int outer : {1, 3, 67}) {
+      for (int axis_size : {1, 7, 128, 3001}) {
+        for (int inner : {1, 5, 64, 83}) {
+          if (inner > 1 && axis_size > 128) continue;
+          const int size = outer * axis_size * inner;
+          std::vector<float> x(size), y(size), y_basic(size);
+          fill_data_rand(x.data(), -20.f, 20.f, size);
+          // A masked score.
+          x[size / 2] = -std::numeric_limits<float>::infinity();
+          math::softmax_fp32(x.data(), y.data(), outer, axis_size, inner);
+          softmax_basic(x, &y_basic, outer, axis_size, inner);
+          EXPECT_LT(max_abs_diff(y, y_basic), 1e-6f)
+              << "threads: " << threads << ", outer: " << outer
+              << ", axis_size: " << axis_size << ", inner: " << inner;
+        }
+      }
+    }
+  }
+}
+
+TEST(TestX86RowOps, layer_norm) {
+  for (int threads : {1, 4}) {
+    auto pool = paddle::lite::ThreadPool::Create(threads);
+    paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+    for (int rows : {1, 5, 128}) {
+      for (int cols : {1, 7, 24, 768, 1001}) {
+        for (bool affine : {true, false}) {
+          std::vector<float> x(rows * cols), scale(cols), bias(cols);
+          // Far from 0, the variance cancels out if taken about 0.
+          fill_data_rand(x.data(), 999.f, 1001.f, x.size());
+          fill_data_rand(scale.data(), -1.f, 1.f, cols);
+          fill_data_rand(bias.data(), -1.f, 1.f, cols);
+          std::vector<float> y(x.size()), mean(rows), var(rows);
+          math::layer_norm_fp32(x.data(),
+                                affine ? scale.data() : nullptr,
+                                affine ? bias.data() : nullptr,
+                                rows,
+                                cols,
+                                1e-5f,
+                                y.data(),
+                                mean.data(),
+                                var.data());
+          for (int r = 0; r < rows; ++r) {
+            const float* xr = x.data() + r * cols;
+            double m = 0.0;
+            double v = 0.0;
+            for (int c = 0; c < cols; ++c) m += xr[c];
+            m /= cols;
+            for (int c = 0; c < cols; ++c) v += (xr[c] - m) * (xr[c] - m);
+            v /= cols;
+            EXPECT_NEAR(mean[r], m, 1e-3);
+            EXPECT_NEAR(var[r], v, 1e-3);
+            for (int c = 0; c < cols; ++c) {
+              double y_basic = (xr[c] - m) / std::sqrt(v + 1e-5);
+              if (affine) y_basic = y_basic * scale[c] + bias[c];
+              ASSERT_NEAR(y[r * cols + c], y_basic, 2e-3)
+                  << "threads: " << threads << ", rows: " << rows
+                  << ", cols: " << cols << ", affine: " << affine;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(TestX86RowOps, gelu) {
+  for (int threads : {1, 4}) {
+    auto pool = paddle::lite::ThreadPool::Create(threads);
+    paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+    for (int size : {1, 13, 1000, 100003}) {
+      std::vector<float> x(size), y(size);
+      fill_data_rand(x.data(), -10.f, 10.f, size);
+      for (bool approximate : {false, true}) {
+        math::gelu_fp32(x.data(), y.data(), size, approximate);
+        for (int i = 0; i < size; ++i) {
+          double v = x[i];
+          double y_basic =
+              approximate
+                  ? 0.5 * v *
+                        (1.0 + std::tanh(0.7978845608028654 *
+                                         (v + 0.044715 * v * v * v)))
+                  : 0.5 * v * (1.0 + std::erf(v * 0.7071067811865476));
+          ASSERT_NEAR(y[i], y_basic, 1e-5 * (1.0 + std::fabs(y_basic)))
+              << "threads: " << threads << ", x: " << v
+              << ", approximate: " << approximate;
+        }
+      }
+    }
+  }
+}
+
+#endif  // LITE_WITH_X86
@@ -0,0 +1,171 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifdef LITE_WITH_X86
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "lite/backends/x86/math/sparse_gemm.h"
+#include "lite/core/thread_pool.h"
+#include "lite/tests/utils/fill_data.h"
+#include "lite/tests/utils/naive_math_impl.h"
+
+namespace math = paddle::lite::x86::math;
+
+// C = A * B + bias of the A with about `sparsity` of zeros, packed into
+// blocks of block_rows rows.
+bool test_sparse_gemm(
+    int m, int n, int k, int block_rows, float sparsity, bool has_bias) {
+  const int ldb = n + 3;
+  const int ldc = n + 5;
+  std::vector<float> a(m * k), b(k * ldb), bias(m), c(m * ldc);
+  fill_data_rand(a.data(), -1.f, 1.f, a.size());
+  fill_data_rand(b.data(), -1.f, 1.f, b.size());
+  fill_data_rand(bias.data(), -1.f, 1.f, bias.size());
+  fill_data_rand(c.data(), -1.f, 1.f, c.size());
+  for (auto& v : a) {
+    if (std::fabs(v) < sparsity) v = 0.f;
+  }
+  std::vector<float> c_basic = c;
+  basic_gemm<float, float>(false,
+                           false,
+                           m,
+                           n,
+                           k,
+                           1.f,
+                           a.data(),
+                           k,
+                           b.data(),
+                           ldb,
+                           0.f,
+                           c_basic.data(),
+                           ldc,
+                           bias.data(),
+                           has_bias);
+
+  int64_t blocks = math::bcsr_blocks(a.data(), m, k, k, block_rows);
+  std::vector<float> values(blocks * block_rows);
+  std::vector<int32_t> row_ptr((m + block_rows - 1) / block_rows + 1);
+  std::vector<int32_t> col_idx(blocks);
+  math::bcsr_pack(a.data(),
+                  m,
+                  k,
+                  k,
+                  block_rows,
+                  values.data(),
+                  row_ptr.data(),
+                  col_idx.data());
+  math::BcsrMatrix sparse_a;
+  sparse_a.rows = m;
+  sparse_a.cols = k;
+  sparse_a.block_rows = block_rows;
+  sparse_a.values = values.data();
+  sparse_a.row_ptr = row_ptr.data();
+  sparse_a.col_idx = col_idx.data();
+  math::sparse_gemm_fp32(sparse_a,
+                         n,
+                         b.data(),
+                         ldb,
+                         has_bias ? bias.data() : nullptr,
+                         c.data(),
+                         ldc);
+  for (int i = 0; i < m; ++i) {
+    for (int j = 0; j < ldc; ++j) {
+      float expect = c_basic[i * ldc + j];
+      float diff = std::fabs(c[i * ldc + j] - expect);
+      // The padding of the rows is left as is.
+      if (j >= n ? diff != 0.f : diff > 1e-4f * (std::fabs(expect) + 1.f)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+TEST(TestX86SparseGemm, bcsr_pack) {
+  // 0 1 0 2
+  // 0 0 0 3
+  // 4 0 0 0
+  const float a[12] = {0, 1, 0, 2, 0, 0, 0, 3, 4, 0, 0, 0};
+  std::vector<float> values(12);
+  std::vector<int32_t> row_ptr(2), col_idx(3);
+  EXPECT_EQ(math::bcsr_blocks(a, 3, 4, 4, 4), 3);
+  math::bcsr_pack(
+      a, 3, 4, 4, 4, values.data(), row_ptr.data(), col_idx.data());
+  EXPECT_EQ(row_ptr, std::vector<int32_t>({0, 3}));
+  EXPECT_EQ(col_idx, std::vector<int32_t>({0, 1, 3}));
+  EXPECT_EQ(values[0 * 4 + 2], 4.f);
+  EXPECT_EQ(values[1 * 4 + 0], 1.f);
+  EXPECT_EQ(values[2 * 4 + 1], 3.f);
+  EXPECT_EQ(values[2 * 4 + 3], 0.f);
+  EXPECT_EQ(math::bcsr_blocks(a, 3, 4, 4, 1), 4);
+}
+
+TEST(TestX86SparseGemm, sparse_gemm_compute) {
+  for (int threads : {1, 4}) {
+    auto pool = paddle::lite::ThreadPool::Create(threads);
+    paddle::lite::ThreadPool::ScopedBind bind(pool.get());
+    for (int block_rows : {1, 4}) {
+      for (int m : {1, 6, 33}) {
+        for (int n : {1, 7, 16, 45, 300}) {
+          for (int k : {1, 19, 130}) {
+            for (float sparsity : {0.5f, 0.9f, 1.f}) {
+              EXPECT_TRUE(test_sparse_gemm(
+                  m, n, k, block_rows, sparsity, block_rows == 4))
+                  << "threads: " << threads << ", block_rows: " << block_rows
+                  << ", m: " << m << ", n: " << n << ", k: " << k
+                  << ", sparsity: " << sparsity;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(TestX86SparseGemm, sparse_gemm_weight) {
+  // fc: C = A * W + bias of the pruned W, bias being added to the columns.
+  for (int m : {1, 3, 40}) {
+    for (int k : {5, 64}) {
+      for (int n : {1, 9, 70}) {
+        std::vector<float> a(m * k), w(k * n), bias(n), c(m * n);
+        std::vector<float> c_basic(m * n);
+        fill_data_rand(a.data(), -1.f, 1.f, a.size());
+        fill_data_rand(w.data(), -1.f, 1.f, w.size());
+        fill_data_rand(bias.data(), -1.f, 1.f, bias.size());
+        for (auto& v : w) {
+          if (std::fabs(v) < 0.8f) v = 0.f;
+        }
+        for (int i = 0; i < m; ++i) {
+          for (int j = 0; j < n; ++j) {
+            float sum = bias[j];
+            for (int l = 0; l < k; ++l) sum += a[i * k + l] * w[l * n + j];
+            c_basic[i * n + j] = sum;
+          }
+        }
+        auto weight = math::SparseGemmWeight::Create(w.data(), k, n, n);
+        EXPECT_EQ(weight->K(), k);
+        EXPECT_EQ(weight->N(), n);
+        weight->Compute(m, a.data(), k, bias.data(), c.data(), n);
+        for (int i = 0; i < m * n; ++i) {
+          EXPECT_NEAR(c[i], c_basic[i], 1e-4f) << "m: " << m << ", k: " << k
+                                               << ", n: " << n << ", i: " << i;
+        }
+      }
+    }
+  }
+}
+
+#endif  // LITE_WITH_X86
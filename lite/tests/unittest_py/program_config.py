@@ -310,6 +310,7 @@ class PrecisionType(Enum):
     INT16 = 8
     UINT8 = 9
     FP64 = 10
+    BF16 = 11
 
 
 class DataLayoutType(Enum):
@@ -322,6 +323,7 @@ class DataLayoutType(Enum):
     ImageNW = 6
     MetalTexture2DArray = 7
     MetalTexture2D = 8
+    NCHW8c = 9
 
 
 def Place(target_type: TargetType,
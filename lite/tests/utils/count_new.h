@@ -0,0 +1,48 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// Replaces the global operator new and delete, so it must be included by one
+// source file of a test binary only.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+// Count the calls of the global operator new while `g_count_new` is set.
+static std::atomic<bool> g_count_new{false};
+static std::atomic<int64_t> g_new_count{0};
+
+void* operator new(size_t size) {
+  if (g_count_new) ++g_new_count;
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+void operator delete(void* p) noexcept { free(p); }
+
+// Counts the calls of the global operator new of all the threads during its
+// life.
+class NewCounter {
+ public:
+  NewCounter() {
+    g_new_count = 0;
+    g_count_new = true;
+  }
+  ~NewCounter() { g_count_new = false; }
+
+  int64_t count() const { return g_new_count; }
+};
@@ -14,7 +14,10 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
 #include <random>
+#include <vector>
 template <typename Dtype>
 inline void fill_data_const(Dtype* dio, Dtype value, size_t size) {
   for (size_t i = 0; i < size; ++i) {
@@ -32,6 +35,17 @@ inline void fill_data_rand(Dtype* dio, Dtype vstart, Dtype vend, size_t size) {
   }
 }
 
+// The largest |a - b| / (|b| + 1) of the elements of a and of the reference b.
+inline float max_rel_diff(const std::vector<float>& a,
+                          const std::vector<float>& b) {
+  float max_diff = 0.f;
+  for (size_t i = 0; i < a.size(); ++i) {
+    float diff = std::fabs(a[i] - b[i]) / (std::fabs(b[i]) + 1.f);
+    max_diff = std::max(max_diff, diff);
+  }
+  return max_diff;
+}
+
 #ifdef ENABLE_ARM_FP16
 typedef __fp16 float16_t;
 
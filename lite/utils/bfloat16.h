@@ -0,0 +1,69 @@
+// Copyright (c) 2021 PaddlePaddle Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "lite/api/paddle_place.h"
+
+namespace paddle {
+namespace lite {
+
+// bfloat16 keeps the upper 16 bits of a float: the sign, the 8 bits of the
+// exponent and 7 bits of the mantissa. It has the range of float, so the
+// weights convert without scales, and converts back by a shift.
+struct bfloat16 {
+ public:
+  uint16_t x;
+
+  // The defaulted members keep bfloat16 trivial, as float16.
+  bfloat16() = default;
+  bfloat16(const bfloat16& o) = default;
+  bfloat16& operator=(const bfloat16& o) = default;
+  ~bfloat16() = default;
+
+  // Round to the nearest, ties to even, NaNs stay quiet NaNs.
+  inline explicit bfloat16(float val) {
+    uint32_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+      x = static_cast<uint16_t>((bits >> 16) | 0x40u);
+    } else {
+      bits += 0x7fffu + ((bits >> 16) & 1u);
+      x = static_cast<uint16_t>(bits >> 16);
+    }
+  }
+
+  inline explicit operator float() const {
+    uint32_t bits = static_cast<uint32_t>(x) << 16;
+    float val;
+    memcpy(&val, &bits, sizeof(val));
+    return val;
+  }
+};
+
+static_assert(sizeof(bfloat16) == 2, "bfloat16 must be 2 bytes");
+
+}  // namespace lite
+
+namespace lite_api {
+
+template <>
+struct PrecisionTypeTrait<lite::bfloat16> {
+  constexpr static PrecisionType Type() { return PrecisionType::kBF16; }
+};
+
+}  // namespace lite_api
+}  // namespace paddle